@@ -47,6 +47,10 @@ author: Su Zhenyu
 //Define target machine general register byte size.
 #define GENERAL_REGISTER_SIZE BYTE_PER_POINTER
 
+//Define target machine vector register byte size.
+//It is the default value of g_vect_reg_byte_size.
+#define VECTOR_REGISTER_BYTE_SIZE 16
+
 //Size of the stack slot reserved for callee-saved registers, in bytes.
 //it is same as pointer size.
 #define CALLEE_SAVE_STACK_SLOT_SIZE BYTE_PER_POINTER
@@ -0,0 +1,107 @@
+/*@
+Copyright (c) 2013-2021, Su Zhenyu steven.known@gmail.com
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Su Zhenyu nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+@*/
+#include "stdio.h"
+#include "time.h"
+#include "../xcominc.h"
+
+using namespace xcom;
+
+//Number of bits in each bitset, 512 is the segment size of SBitSet.
+#define BIT_SIZE_NUM 3
+static UINT const g_bit_size[BIT_SIZE_NUM] = { 512, 4096, 65536 };
+#define NUM_OF_SET 16
+#define NUM_OF_OP 4000000
+
+static UINT g_seed = 1;
+
+static UINT genRand()
+{
+    g_seed = g_seed * 1103515245 + 12345;
+    return (g_seed >> 16) & 0x7FFF;
+}
+
+
+static void initSet(BitSet * sets, UINT bit_size)
+{
+    g_seed = 1;
+    for (UINT i = 0; i < NUM_OF_SET; i++) {
+        sets[i].clean();
+        //Make the sets sparse to model the dataflow sets.
+        for (UINT j = 0; j < bit_size / 8; j++) {
+            sets[i].bunion((BSIdx)(genRand() % bit_size));
+        }
+        sets[i].bunion((BSIdx)(bit_size - 1));
+    }
+}
+
+
+//Return the checksum that used to compare the result of different kernels.
+static UINT run(BitSet * sets, UINT bit_size)
+{
+    UINT sum = 0;
+    UINT num = NUM_OF_OP / (bit_size / 512);
+    BitSet tmp;
+    for (UINT i = 0; i < num; i++) {
+        BitSet const& s1 = sets[i % NUM_OF_SET];
+        BitSet const& s2 = sets[(i + 7) % NUM_OF_SET];
+        tmp.copy(s1);
+        tmp.bunion(s2);
+        tmp.intersect(sets[(i + 3) % NUM_OF_SET]);
+        tmp.diff(sets[(i + 5) % NUM_OF_SET]);
+        sum += tmp.get_elem_count();
+        sum += s1.is_intersect(s2) ? 1 : 0;
+    }
+    return sum;
+}
+
+
+int main()
+{
+    BYTEOP_KERNEL kernels[] = { BYTEOP_KERNEL_BYTE, BYTEOP_KERNEL_WORD,
+        BYTEOP_KERNEL_SSE2, BYTEOP_KERNEL_AVX2 };
+    BitSet sets[NUM_OF_SET];
+    for (UINT k = 0; k < BIT_SIZE_NUM; k++) {
+        initSet(sets, g_bit_size[k]);
+        for (UINT i = 0; i < sizeof(kernels) / sizeof(kernels[0]); i++) {
+            BYTEOP_KERNEL used = ByteOp::selectKernel(kernels[i]);
+            if (used != kernels[i]) {
+                printf("\nbits:%u kernel:%s is not supported by host",
+                       g_bit_size[k], ByteOp::getKernelName(kernels[i]));
+                continue;
+            }
+            clock_t start = clock();
+            UINT sum = run(sets, g_bit_size[k]);
+            double t = (double)(clock() - start) / CLOCKS_PER_SEC;
+            printf("\nbits:%u kernel:%s time:%.3fs checksum:%u",
+                   g_bit_size[k], ByteOp::getKernelName(used), t, sum);
+        }
+    }
+    printf("\n");
+    return 0;
+}
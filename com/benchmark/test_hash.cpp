@@ -0,0 +1,99 @@
+/*@
+Copyright (c) 2013-2021, Su Zhenyu steven.known@gmail.com
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Su Zhenyu nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+@*/
+#include "stdio.h"
+#include "time.h"
+#include "../xcominc.h"
+
+using namespace xcom;
+
+#define NUM 1000000
+
+//Generate scattered keys to model pointers and ids.
+static UINT genKey(UINT i) { return i * 2654435761u | 1; }
+
+static double getTime(clock_t start)
+{
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+
+int main()
+{
+#ifdef RUN_CHAINED_HASH
+    //Chained hash does not grow automatically, give it enough buckets.
+    HMap<UINT, UINT, HashFuncBase2<UINT> > map(getNearestPowerOf2((UINT)NUM));
+    CHAR const* name = "HMap";
+#else
+    OAHashMap<UINT, UINT> map;
+    CHAR const* name = "OAHashMap";
+#endif
+    clock_t start = clock();
+    for (UINT i = 1; i <= NUM; i++) {
+        map.set(genKey(i), i);
+    }
+    double t_insert = getTime(start);
+
+    start = clock();
+    UINT sum = 0;
+    for (UINT j = 0; j < 4; j++) {
+        for (UINT i = 1; i <= NUM; i++) {
+            sum += map.get(genKey(i)); //hit
+            sum += map.get(genKey(i) + 1); //miss
+        }
+    }
+    double t_find = getTime(start);
+
+    start = clock();
+    for (UINT i = 1; i <= NUM; i += 2) {
+        map.remove(genKey(i));
+    }
+    for (UINT i = 1; i <= NUM; i += 2) {
+        map.set(genKey(i), i);
+    }
+    double t_remove = getTime(start);
+    for (UINT i = 1; i <= NUM; i++) {
+        sum += map.get(genKey(i));
+    }
+
+    //NOTE: HMap::remove() does not clear the mapped element, thus the
+    //iteration is not accounted in checksum.
+    start = clock();
+    VecIdx it;
+    UINT iter_num = 0;
+    for (UINT v = map.get_first_elem(it); it != VEC_UNDEF;
+         v = map.get_next_elem(it)) {
+        DUMMYUSE(v);
+        iter_num++;
+    }
+    double t_iter = getTime(start);
+    printf("\n%s: insert:%.3fs find:%.3fs remove&reinsert:%.3fs "
+           "iterate:%.3fs elem:%u checksum:%u\n",
+           name, t_insert, t_find, t_remove, t_iter, iter_num, sum);
+    return 0;
+}
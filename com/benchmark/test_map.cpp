@@ -58,6 +58,80 @@ int main()
     return 0;
 }
 
+#elif defined(RUN_BTREE_CMP)
+
+//Compare RBT based TMap and BTreeMap with different number of keys.
+#include "time.h"
+#include "../xcominc.h"
+
+using namespace xcom;
+
+//Generate scattered keys to model pointers and ids.
+static UINT genKey(UINT i) { return i * 2654435761u | 1; }
+
+static UINT lookupOrder(UINT i, UINT num)
+{
+    return (UINT)(((ULONGLONG)i * 7919) % num) + 1;
+}
+
+
+static double getTime(clock_t start)
+{
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+
+template <class MapType, class IterType>
+static void runMap(CHAR const* name, UINT num)
+{
+    MapType * map = new MapType();
+    clock_t start = clock();
+    for (UINT i = 1; i <= num; i++) {
+        map->set(genKey(i), i);
+    }
+    double t_insert = getTime(start);
+
+    start = clock();
+    UINT sum = 0;
+    for (UINT i = 1; i <= num; i++) {
+        //Lookup in an order different from insertion.
+        UINT k = genKey(lookupOrder(i, num));
+        sum += map->get(k); //hit
+        sum += map->get(k + 1); //miss
+    }
+    double t_find = getTime(start);
+
+    start = clock();
+    IterType iter;
+    UINT tgt;
+    for (UINT src = map->get_first(iter, &tgt);
+         src != 0; src = map->get_next(iter, &tgt)) {
+        sum += tgt;
+    }
+    double t_iter = getTime(start);
+
+    start = clock();
+    for (UINT i = 1; i <= num; i++) {
+        map->remove(genKey(i));
+    }
+    double t_remove = getTime(start);
+    printf("\n%s(%u): insert:%.3fs find:%.3fs iterate:%.3fs remove:%.3fs "
+           "checksum:%u", name, num, t_insert, t_find, t_iter, t_remove, sum);
+    delete map;
+}
+
+
+int main()
+{
+    for (UINT num = 1000; num <= 10000000; num *= 10) {
+        runMap<TMap<UINT, UINT>, TMapIter<UINT, UINT> >("TMap", num);
+        runMap<BTreeMap<UINT, UINT>, BTreeMapIter<UINT, UINT> >(
+            "BTreeMap", num);
+    }
+    printf("\n");
+    return 0;
+}
+
 #else  //RUN XCOM
 
 #include "../xcominc.h"
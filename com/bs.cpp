@@ -40,20 +40,59 @@ namespace xcom {
 //
 //START BitSet
 //
+//The header that prefixes the buffer of BitSet. It records the memory
+//account that the buffer attributed to, thus the buffer can be freed by
+//any thread. The union keeps the buffer aligned.
+typedef union {
+    MemAccount * account;
+    LONGLONG align;
+} BSBufHeader;
+
+BYTE * BitSet::allocBuf(size_t size)
+{
+    ASSERT0(size > 0);
+    BSBufHeader * h = (BSBufHeader*)::malloc(sizeof(BSBufHeader) + size);
+    ASSERT0(h);
+    MemAccount * account = smpoolGetThreadMemAccount();
+    h->account = account;
+    if (account != nullptr) {
+        account->hold();
+        account->addSize((LONGLONG)size);
+    } else {
+        smpoolAddThreadMemSize((LONGLONG)size);
+    }
+    BYTE * buf = (BYTE*)(h + 1);
+    ::memset((void*)buf, 0, size);
+    return buf;
+}
+
+
+void BitSet::freeBuf(BYTE * buf, size_t size)
+{
+    if (buf == nullptr) { return; }
+    BSBufHeader * h = ((BSBufHeader*)buf) - 1;
+    MemAccount * account = h->account;
+    if (account != nullptr) {
+        account->addSize(-(LONGLONG)size);
+        account->release();
+    } else {
+        smpoolAddThreadMemSize(-(LONGLONG)size);
+    }
+    ::free(h);
+}
+
+
 void * BitSet::realloc(IN void * src, size_t orgsize, size_t newsize)
 {
     if (orgsize >= newsize) {
         clean();
         return src;
     }
-    void * p = ::malloc(newsize);
+    BYTE * p = allocBuf(newsize);
     if (src != nullptr) {
         ASSERT0(orgsize > 0);
         ::memcpy(p, src, orgsize);
-        ::free(src);
-        ::memset((void*)(((BYTE*)p) + orgsize), 0, newsize - orgsize);
-    } else {
-        ::memset((void*)p, 0, newsize);
+        freeBuf((BYTE*)src, orgsize);
     }
     return p;
 }
@@ -62,14 +101,9 @@ void * BitSet::realloc(IN void * src, size_t orgsize, size_t newsize)
 //Allocate bytes
 void BitSet::alloc(UINT size)
 {
+    freeBuf(m_ptr, m_size);
     m_size = size;
-    if (m_ptr != nullptr) { ::free(m_ptr); }
-    if (size != 0) {
-        m_ptr = (BYTE*)::malloc(size);
-        ::memset((void*)m_ptr, 0, m_size);
-    } else {
-        m_ptr = nullptr;
-    }
+    m_ptr = size != 0 ? allocBuf(size) : nullptr;
 }
 
 
@@ -90,16 +124,8 @@ void BitSet::bunion(BitSet const& bs)
             m_size = cp_sz;
         }
     }
-    UINT const num_of_unit = cp_sz / BYTES_PER_UNIT; //floor-div.
     ASSERTN(m_ptr, ("not yet init"));
-    BSUNIT * uint_ptr_this = (BSUNIT*)m_ptr;
-    BSUNIT * uint_ptr_bs = (BSUNIT*)bs.m_ptr;
-    for (UINT i = 0; i < num_of_unit; i++) {
-        uint_ptr_this[i] |= uint_ptr_bs[i];
-    }
-    for (UINT i = num_of_unit * BYTES_PER_UNIT; i < cp_sz; i++) {
-        m_ptr[i] |= bs.m_ptr[i];
-    }
+    ByteOp::bunion(m_ptr, bs.m_ptr, cp_sz);
 }
 
 
@@ -140,28 +166,9 @@ void BitSet::diff(BitSet const& bs)
 {
     ASSERT0(this != &bs);
     if (m_size == 0 || bs.m_size == 0) { return; }
-    UINT minsize = MIN(m_size, bs.m_size);
-    //Common part: copy the inverse bits.
-    //for (UINT i = 0; i < minsize; i++) {
-    //    m_ptr[i] &= ~bs.m_ptr[i];
-    //}
-    UINT num_of_unit = minsize / BYTES_PER_UNIT;
-    BSUNIT * uint_ptr_this = (BSUNIT*)m_ptr;
-    BSUNIT * uint_ptr_bs = (BSUNIT*)bs.m_ptr;
-    for (UINT i = 0; i < num_of_unit; i++) {
-        UINT d = uint_ptr_bs[i];
-        if (d != 0) {
-            uint_ptr_this[i] &= ~d;
-        }
-    }
-
     ASSERTN(m_ptr != nullptr, ("not yet init"));
-    for (UINT i = num_of_unit * BYTES_PER_UNIT; i < minsize; i++) {
-        BYTE d = bs.m_ptr[i];
-        if (d != 0) {
-            m_ptr[i] = (BYTE)(m_ptr[i] & ~d);
-        }
-    }
+    //Common part: clear the bits that set in 'bs'.
+    ByteOp::diff(m_ptr, bs.m_ptr, MIN(m_size, bs.m_size));
 }
 
 
@@ -171,14 +178,10 @@ void BitSet::intersect(BitSet const& bs)
     ASSERT0(this != &bs);
     if (m_ptr == nullptr) { return; }
     if (m_size > bs.m_size) {
-        for (UINT i = 0; i < bs.m_size; i++) {
-            m_ptr[i] &= bs.m_ptr[i];
-        }
+        ByteOp::intersect(m_ptr, bs.m_ptr, bs.m_size);
         ::memset((void*)(m_ptr + bs.m_size), 0, m_size - bs.m_size);
     } else {
-        for (UINT i = 0; i < m_size; i++) {
-            m_ptr[i] &= bs.m_ptr[i];
-        }
+        ByteOp::intersect(m_ptr, bs.m_ptr, m_size);
     }
 }
 
@@ -223,31 +226,13 @@ void BitSet::complement(BitSet const& univers)
 }
 
 
-//Return the element count in 'set'
-//Add up the population count of each byte in the set.  We get the
-//population counts from the table above.  Great for a machine with
-//effecient loadbyte instructions.
+//Return the element count in 'set'.
+//The population count is computed by ByteOp, which uses hardware popcount
+//instruction if host CPU supports it.
 UINT BitSet::get_elem_count() const
 {
     if (m_ptr == nullptr) { return 0; }
-    UINT count = 0;
-//#define HAMMING_WEIGHT_METHOD
-#ifdef HAMMING_WEIGHT_METHOD
-    ASSERT0(BYTES_PER_UNIT == 4);
-    UINT const m = m_size / BYTES_PER_UNIT;
-    for (UINT i = 0; i < m; i++) {
-        BSUNIT v = ((BSUNIT*)(m_ptr))[i];
-        v = v - ((v >> 1) & 0x55555555);
-        v = (v & 0x33333333) + ((v >> 2) & 0x33333333);
-        count += (((v + (v >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24;
-    }
-    for (UINT i = m * BYTES_PER_UNIT; i < m_size; i++) {
-        count += g_bit_count[m_ptr[i]];
-    }
-#else
-    count = ByteOp::get_elem_count(m_ptr, m_size);
-#endif
-    return count;
+    return ByteOp::get_elem_count(m_ptr, m_size);
 }
 
 
@@ -397,26 +382,10 @@ bool BitSet::is_empty() const
 bool BitSet::is_intersect(BitSet const& bs) const
 {
     ASSERT0(this != &bs);
-    BSIdx const first_bit = get_first();
-    if (first_bit == BS_UNDEF) {
-        return false;
-    }
-    BSIdx const bs_first_bit = bs.get_first();
-    if (bs_first_bit == BS_UNDEF) { //Empty set
-        return false;
-    }
-
-    BSIdx const start_bit = MAX(first_bit, bs_first_bit);
-    BSIdx const end_bit = MIN(get_last(), bs.get_last());
-    UINT const start_byte = DIVBPB(start_bit);
-    UINT const end_byte = DIVBPB(end_bit);
-
-    for (UINT i = start_byte; i <= end_byte; i++) {
-        if ((m_ptr[i] & bs.m_ptr[i]) != (BYTE)0) {
-            return true;
-        }
-    }
-    return false;
+    if (m_ptr == nullptr || bs.m_ptr == nullptr) { return false; }
+    //Scan the common part directly, it is cheaper than computing the
+    //first and last element of both sets.
+    return ByteOp::is_intersect(m_ptr, bs.m_ptr, MIN(m_size, bs.m_size));
 }
 
 
@@ -767,8 +736,8 @@ void BitSet::copy(BitSet const& src)
 
         cp_sz = (UINT)(l / BITS_PER_BYTE) + 1;
         if (m_size < cp_sz) {
-            ::free(m_ptr);
-            m_ptr = (BYTE*)::malloc(cp_sz);
+            freeBuf(m_ptr, m_size);
+            m_ptr = allocBuf(cp_sz);
             m_size = cp_sz;
         } else if (m_size > cp_sz) {
             ::memset((void*)(m_ptr + cp_sz), 0, m_size - cp_sz);
@@ -62,6 +62,14 @@ protected:
     UINT m_size;
     BYTE * m_ptr;
 protected:
+    //Allocate a zeroed buffer of 'size' bytes. The buffer is attributed to
+    //the memory account of current thread, see smpoolGetThreadMemAccount().
+    static BYTE * allocBuf(size_t size);
+
+    //Free the buffer that allocated by allocBuf(), the bytes are subtracted
+    //from the account that the buffer attributed to.
+    static void freeBuf(BYTE * buf, size_t size);
+
     void * realloc(IN void * src, size_t orgsize, size_t newsize);
 public:
     BitSet(UINT init_pool_size = 1)
@@ -83,8 +91,7 @@ public:
         if (m_ptr != nullptr) { return; }
         m_size = init_pool_size;
         if (init_pool_size == 0) { return; }
-        m_ptr = (BYTE*)::malloc(init_pool_size);
-        ::memset((void*)m_ptr, 0, m_size);
+        m_ptr = allocBuf(init_pool_size);
     }
 
     //Destroy bit buffer memory.
@@ -92,7 +99,7 @@ public:
     {
         if (m_ptr == nullptr) { return; }
         ASSERTN(m_size > 0, ("bitset is invalid"));
-        ::free(m_ptr);
+        freeBuf(m_ptr, m_size);
         m_ptr = nullptr;
         m_size = 0;
     }
@@ -144,10 +151,7 @@ public:
     void dump(FILE * h) const
     { dump(h, UFlag(BS_DUMP_BITSET|BS_DUMP_POS), BS_UNDEF); }
 
-    //Return the element count in 'set'
-    //Add up the population count of each byte in the set.  We get the
-    //population counts from the table above.  Great for a machine with
-    //effecient loadbyte instructions.
+    //Return the element count in 'set'.
     UINT get_elem_count() const;
 
     //Return position of first element, start from '0'.
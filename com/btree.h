@@ -0,0 +1,762 @@
+/*@
+Copyright (c) 2013-2021, Su Zhenyu steven.known@gmail.com
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Su Zhenyu nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+@*/
+#ifndef __BTREE_H__
+#define __BTREE_H__
+
+namespace xcom {
+
+//B+ Tree
+//
+//The B+ tree is an alternative backend of TMap and TTab. Each node holds
+//a sorted key array that spans a few cache lines, thus lookup touches far
+//fewer cache lines than RBT, which allocates one node per key. All
+//key-value pairs are stored in leaves, and leaves are linked in key order,
+//thus iterating elements is a sequential scan of leaves.
+//
+//NOTE:
+//    1.Tsrc(0) is defined as default nullptr in BTreeMap, do NOT use T(0)
+//      as element.
+//    2.Keep the key *UNIQUE*.
+//    3.Overload operator == and operator < if Tsrc is neither basic type
+//      nor pointer type.
+//    4.Keys and mapped elements are moved by assignment when node is split
+//      or merged, thus do not record the address of them.
+
+//The byte size of key array in each node, two cache lines by default.
+#define BTREE_KEY_ARRAY_BYTE_SIZE 128
+
+//The minimum number of keys in a node that B+ tree needs.
+#define BTREE_MIN_KEY_NUM 5
+
+//Compute the default number of keys in a node for type T.
+#define BTREE_DEF_KEY_NUM(T) \
+    (sizeof(T) * BTREE_MIN_KEY_NUM > BTREE_KEY_ARRAY_BYTE_SIZE ? \
+     BTREE_MIN_KEY_NUM : BTREE_KEY_ARRAY_BYTE_SIZE / sizeof(T))
+
+template <class Tsrc, UINT MaxKeyNum>
+class BTreeNode {
+public:
+    UINT num; //the number of keys in node.
+    bool is_leaf;
+    Tsrc key[MaxKeyNum];
+};
+
+
+//Inner node.
+//All keys in child[i] are not less than key[i-1], and less than key[i].
+template <class Tsrc, UINT MaxKeyNum>
+class BTreeInner : public BTreeNode<Tsrc, MaxKeyNum> {
+public:
+    BTreeNode<Tsrc, MaxKeyNum> * child[MaxKeyNum + 1];
+};
+
+
+//Leaf node.
+template <class Tsrc, class Ttgt, UINT MaxKeyNum>
+class BTreeLeaf : public BTreeNode<Tsrc, MaxKeyNum> {
+public:
+    BTreeLeaf * prev;
+    BTreeLeaf * next;
+    Ttgt mapped[MaxKeyNum];
+};
+
+
+//The class is used to iterate elements in BTreeMap.
+//You should call clean() to initialize the iterator.
+template <class Tsrc, class Ttgt,
+          UINT MaxKeyNum = BTREE_DEF_KEY_NUM(Tsrc)>
+class BTreeMapIter {
+    COPY_CONSTRUCTOR(BTreeMapIter);
+public:
+    BTreeLeaf<Tsrc, Ttgt, MaxKeyNum> const* leaf;
+    UINT idx;
+public:
+    BTreeMapIter() { clean(); }
+
+    void clean() { leaf = nullptr; idx = 0; }
+
+    //Return true if the iteration is at the end.
+    bool end() const { return leaf == nullptr; }
+};
+
+
+//BTreeMap
+//
+//Make a map between Tsrc and Ttgt, the interface is same as TMap.
+//
+//Tsrc: the type of keys maintained by this map.
+//Ttgt: the type of mapped values.
+//MaxKeyNum: the maximum number of keys in a node.
+//
+//USAGE: Make a mapping from SRC* to TGT*.
+//    class SRC2TGT_MAP : public BTreeMap<SRC*, TGT*> {
+//    public:
+//    };
+template <class Tsrc, class Ttgt, class CompareKey = CompareKeyBase<Tsrc>,
+          class GenMapped = GenMappedBase<Tsrc, Ttgt>,
+          UINT MaxKeyNum = BTREE_DEF_KEY_NUM(Tsrc)>
+class BTreeMap {
+    COPY_CONSTRUCTOR(BTreeMap);
+public:
+    typedef BTreeMapIter<Tsrc, Ttgt, MaxKeyNum> Iter;
+    typedef BTreeNode<Tsrc, MaxKeyNum> NodeType;
+    typedef BTreeInner<Tsrc, MaxKeyNum> InnerType;
+    typedef BTreeLeaf<Tsrc, Ttgt, MaxKeyNum> LeafType;
+protected:
+    //The minimum number of keys of non-root node.
+    //Inner node needs 'MIN_KEY_NUM * 2 + 1 <= MaxKeyNum' to merge two
+    //siblings with the separator in parent.
+    static UINT const MIN_KEY_NUM = (MaxKeyNum - 1) / 2;
+
+    UINT m_elem_count;
+    NodeType * m_root;
+    SMemPool * m_inner_pool;
+    SMemPool * m_leaf_pool;
+    InnerType * m_free_inner; //linked by child[0].
+    LeafType * m_free_leaf; //linked by next.
+    CompareKey m_ck;
+    GenMapped m_gm;
+protected:
+    //Return the first index that key[idx] is not less than 't'.
+    //The search is written in branch-free form to let compiler generate
+    //conditional move instead of unpredictable branch.
+    UINT lowerBound(NodeType const* node, Tsrc t) const
+    {
+        UINT base = 0;
+        UINT len = node->num;
+        if (len == 0) { return 0; }
+        while (len > 1) {
+            UINT half = len / 2;
+            base = m_ck.is_less(node->key[base + half - 1], t) ?
+                   base + half : base;
+            len -= half;
+        }
+        return base + (m_ck.is_less(node->key[base], t) ? 1 : 0);
+    }
+
+    //Return the first index that key[idx] is greater than 't', which is
+    //also the index of child that may contain 't'.
+    UINT upperBound(NodeType const* node, Tsrc t) const
+    {
+        UINT base = 0;
+        UINT len = node->num;
+        if (len == 0) { return 0; }
+        while (len > 1) {
+            UINT half = len / 2;
+            base = m_ck.is_less(t, node->key[base + half - 1]) ?
+                   base : base + half;
+            len -= half;
+        }
+        return base + (m_ck.is_less(t, node->key[base]) ? 0 : 1);
+    }
+
+    //Return the leaf and the index of 't' in leaf.
+    LeafType * findLeaf(Tsrc t, OUT UINT & idx) const
+    {
+        NodeType * x = m_root;
+        if (x == nullptr) { return nullptr; }
+        while (!x->is_leaf) {
+            x = ((InnerType*)x)->child[upperBound(x, t)];
+        }
+        idx = lowerBound(x, t);
+        if (idx < x->num && m_ck.is_equ(x->key[idx], t)) {
+            return (LeafType*)x;
+        }
+        return nullptr;
+    }
+
+    LeafType * getFirstLeaf() const
+    {
+        NodeType * x = m_root;
+        if (x == nullptr) { return nullptr; }
+        while (!x->is_leaf) {
+            x = ((InnerType*)x)->child[0];
+        }
+        return (LeafType*)x;
+    }
+
+    InnerType * newInner()
+    {
+        InnerType * x = m_free_inner;
+        if (x != nullptr) {
+            m_free_inner = (InnerType*)x->child[0];
+        } else {
+            x = (InnerType*)smpoolMallocConstSize(sizeof(InnerType),
+                                                  m_inner_pool);
+            ASSERT0(x);
+        }
+        ::memset((void*)x, 0, sizeof(InnerType));
+        x->is_leaf = false;
+        return x;
+    }
+
+    LeafType * newLeaf()
+    {
+        LeafType * x = m_free_leaf;
+        if (x != nullptr) {
+            m_free_leaf = x->next;
+        } else {
+            x = (LeafType*)smpoolMallocConstSize(sizeof(LeafType),
+                                                 m_leaf_pool);
+            ASSERT0(x);
+        }
+        ::memset((void*)x, 0, sizeof(LeafType));
+        x->is_leaf = true;
+        return x;
+    }
+
+    void freeNode(NodeType * x)
+    {
+        if (x->is_leaf) {
+            ((LeafType*)x)->next = m_free_leaf;
+            m_free_leaf = (LeafType*)x;
+            return;
+        }
+        ((InnerType*)x)->child[0] = m_free_inner;
+        m_free_inner = (InnerType*)x;
+    }
+
+    //Insert key and child at 'idx' of inner node.
+    void insertInnerAt(InnerType * x, UINT idx, Tsrc k, NodeType * c)
+    {
+        ASSERT0(x->num < MaxKeyNum);
+        for (UINT i = x->num; i > idx; i--) {
+            x->key[i] = x->key[i - 1];
+            x->child[i + 1] = x->child[i];
+        }
+        x->key[idx] = k;
+        x->child[idx + 1] = c;
+        x->num++;
+    }
+
+    //Remove key[idx] and child[idx + 1] of inner node.
+    void removeInnerAt(InnerType * x, UINT idx)
+    {
+        ASSERT0(idx < x->num);
+        for (UINT i = idx; i + 1 < x->num; i++) {
+            x->key[i] = x->key[i + 1];
+            x->child[i + 1] = x->child[i + 2];
+        }
+        x->num--;
+    }
+
+    void insertLeafAt(LeafType * x, UINT idx, Tsrc k, Ttgt m)
+    {
+        ASSERT0(x->num < MaxKeyNum);
+        for (UINT i = x->num; i > idx; i--) {
+            x->key[i] = x->key[i - 1];
+            x->mapped[i] = x->mapped[i - 1];
+        }
+        x->key[idx] = k;
+        x->mapped[idx] = m;
+        x->num++;
+    }
+
+    void removeLeafAt(LeafType * x, UINT idx)
+    {
+        ASSERT0(idx < x->num);
+        for (UINT i = idx; i + 1 < x->num; i++) {
+            x->key[i] = x->key[i + 1];
+            x->mapped[i] = x->mapped[i + 1];
+        }
+        x->num--;
+    }
+
+    //Split the full child at 'idx' of 'parent' into two nodes.
+    void splitChild(InnerType * parent, UINT idx)
+    {
+        NodeType * c = parent->child[idx];
+        ASSERT0(c->num == MaxKeyNum);
+        if (c->is_leaf) {
+            LeafType * l = (LeafType*)c;
+            LeafType * r = newLeaf();
+            UINT const half = MaxKeyNum / 2;
+            for (UINT i = half; i < MaxKeyNum; i++) {
+                r->key[i - half] = l->key[i];
+                r->mapped[i - half] = l->mapped[i];
+            }
+            r->num = MaxKeyNum - half;
+            l->num = half;
+            r->next = l->next;
+            if (r->next != nullptr) { r->next->prev = r; }
+            r->prev = l;
+            l->next = r;
+            insertInnerAt(parent, idx, r->key[0], r);
+            return;
+        }
+        InnerType * l = (InnerType*)c;
+        InnerType * r = newInner();
+        UINT const mid = MaxKeyNum / 2;
+        for (UINT i = mid + 1; i < MaxKeyNum; i++) {
+            r->key[i - mid - 1] = l->key[i];
+        }
+        for (UINT i = mid + 1; i <= MaxKeyNum; i++) {
+            r->child[i - mid - 1] = l->child[i];
+        }
+        r->num = MaxKeyNum - mid - 1;
+        l->num = mid;
+        insertInnerAt(parent, idx, l->key[mid], r);
+    }
+
+    //Merge child[idx + 1] into child[idx] of 'parent'.
+    void mergeChild(InnerType * parent, UINT idx)
+    {
+        NodeType * l = parent->child[idx];
+        NodeType * r = parent->child[idx + 1];
+        if (l->is_leaf) {
+            LeafType * ll = (LeafType*)l;
+            LeafType * rl = (LeafType*)r;
+            ASSERT0(ll->num + rl->num <= MaxKeyNum);
+            for (UINT i = 0; i < rl->num; i++) {
+                ll->key[ll->num + i] = rl->key[i];
+                ll->mapped[ll->num + i] = rl->mapped[i];
+            }
+            ll->num += rl->num;
+            ll->next = rl->next;
+            if (ll->next != nullptr) { ll->next->prev = ll; }
+        } else {
+            InnerType * li = (InnerType*)l;
+            InnerType * ri = (InnerType*)r;
+            ASSERT0(li->num + ri->num + 1 <= MaxKeyNum);
+            li->key[li->num] = parent->key[idx];
+            for (UINT i = 0; i < ri->num; i++) {
+                li->key[li->num + 1 + i] = ri->key[i];
+            }
+            for (UINT i = 0; i <= ri->num; i++) {
+                li->child[li->num + 1 + i] = ri->child[i];
+            }
+            li->num += ri->num + 1;
+        }
+        removeInnerAt(parent, idx);
+        freeNode(r);
+    }
+
+    //Move one key from left sibling to child[idx].
+    void borrowFromLeft(InnerType * parent, UINT idx)
+    {
+        NodeType * c = parent->child[idx];
+        NodeType * l = parent->child[idx - 1];
+        if (c->is_leaf) {
+            LeafType * cl = (LeafType*)c;
+            LeafType * ll = (LeafType*)l;
+            insertLeafAt(cl, 0, ll->key[ll->num - 1],
+                         ll->mapped[ll->num - 1]);
+            ll->num--;
+            parent->key[idx - 1] = cl->key[0];
+            return;
+        }
+        InnerType * ci = (InnerType*)c;
+        InnerType * li = (InnerType*)l;
+        for (UINT i = ci->num; i > 0; i--) {
+            ci->key[i] = ci->key[i - 1];
+        }
+        for (UINT i = ci->num + 1; i > 0; i--) {
+            ci->child[i] = ci->child[i - 1];
+        }
+        ci->key[0] = parent->key[idx - 1];
+        ci->child[0] = li->child[li->num];
+        ci->num++;
+        parent->key[idx - 1] = li->key[li->num - 1];
+        li->num--;
+    }
+
+    //Move one key from right sibling to child[idx].
+    void borrowFromRight(InnerType * parent, UINT idx)
+    {
+        NodeType * c = parent->child[idx];
+        NodeType * r = parent->child[idx + 1];
+        if (c->is_leaf) {
+            LeafType * cl = (LeafType*)c;
+            LeafType * rl = (LeafType*)r;
+            cl->key[cl->num] = rl->key[0];
+            cl->mapped[cl->num] = rl->mapped[0];
+            cl->num++;
+            removeLeafAt(rl, 0);
+            parent->key[idx] = rl->key[0];
+            return;
+        }
+        InnerType * ci = (InnerType*)c;
+        InnerType * ri = (InnerType*)r;
+        ci->key[ci->num] = parent->key[idx];
+        ci->child[ci->num + 1] = ri->child[0];
+        ci->num++;
+        parent->key[idx] = ri->key[0];
+        for (UINT i = 0; i + 1 < ri->num; i++) {
+            ri->key[i] = ri->key[i + 1];
+        }
+        for (UINT i = 0; i < ri->num; i++) {
+            ri->child[i] = ri->child[i + 1];
+        }
+        ri->num--;
+    }
+
+    //Make sure child[idx] has more than MIN_KEY_NUM keys before
+    //descending into it to remove key.
+    //Return the index of child that should be descended.
+    UINT fixChild(InnerType * parent, UINT idx)
+    {
+        if (idx > 0 && parent->child[idx - 1]->num > MIN_KEY_NUM) {
+            borrowFromLeft(parent, idx);
+            return idx;
+        }
+        if (idx < parent->num &&
+            parent->child[idx + 1]->num > MIN_KEY_NUM) {
+            borrowFromRight(parent, idx);
+            return idx;
+        }
+        if (idx > 0) {
+            mergeChild(parent, idx - 1);
+            return idx - 1;
+        }
+        mergeChild(parent, idx);
+        return idx;
+    }
+
+    //Insert 't' into tree.
+    //Return the leaf and the index of 't' in leaf.
+    LeafType * insert(Tsrc t, OUT UINT & idx, OUT bool & find)
+    {
+        if (m_root == nullptr) {
+            m_root = newLeaf();
+        } else if (m_root->num == MaxKeyNum) {
+            InnerType * newroot = newInner();
+            newroot->child[0] = m_root;
+            m_root = newroot;
+            splitChild(newroot, 0);
+        }
+        NodeType * x = m_root;
+        while (!x->is_leaf) {
+            InnerType * in = (InnerType*)x;
+            UINT i = upperBound(in, t);
+            if (in->child[i]->num == MaxKeyNum) {
+                //Split the full child in advance, thus the parent always
+                //has room for the separator.
+                splitChild(in, i);
+                if (!m_ck.is_less(t, in->key[i])) { i++; }
+            }
+            x = in->child[i];
+        }
+        LeafType * leaf = (LeafType*)x;
+        idx = lowerBound(leaf, t);
+        if (idx < leaf->num && m_ck.is_equ(leaf->key[idx], t)) {
+            find = true;
+            return leaf;
+        }
+        find = false;
+        insertLeafAt(leaf, idx, m_ck.createKey(t), Ttgt(0));
+        m_elem_count++;
+        return leaf;
+    }
+
+    void freeTree(NodeType * x)
+    {
+        if (!x->is_leaf) {
+            InnerType * in = (InnerType*)x;
+            for (UINT i = 0; i <= in->num; i++) {
+                freeTree(in->child[i]);
+            }
+        }
+        freeNode(x);
+    }
+public:
+    BTreeMap()
+    {
+        m_inner_pool = nullptr;
+        m_leaf_pool = nullptr;
+        init();
+    }
+    ~BTreeMap() { destroy(); }
+
+    //Append <key, mapped> pair of 'src' to current object.
+    void append(BTreeMap const& src)
+    {
+        ASSERT0(this != &src);
+        Iter iter;
+        Ttgt val;
+        for (Tsrc key = src.get_first(iter, &val);
+             !iter.end(); key = src.get_next(iter, &val)) {
+            set(key, val);
+        }
+    }
+
+    void copy(BTreeMap const& src)
+    {
+        ASSERT0(this != &src);
+        clean();
+        append(src);
+    }
+
+    //Count memory usage for current object.
+    size_t count_mem() const
+    {
+        size_t c = sizeof(*this);
+        c += smpoolGetPoolSize(m_inner_pool);
+        c += smpoolGetPoolSize(m_leaf_pool);
+        return c;
+    }
+
+    //Remove all elements, the memory of nodes will be reused.
+    void clean()
+    {
+        if (m_root != nullptr) {
+            freeTree(m_root);
+            m_root = nullptr;
+        }
+        m_elem_count = 0;
+    }
+
+    //The function should be invoked if BTreeMap is destroyed manually.
+    void destroy()
+    {
+        if (!is_init()) { return; }
+        smpoolDelete(m_inner_pool);
+        smpoolDelete(m_leaf_pool);
+        m_inner_pool = nullptr;
+        m_leaf_pool = nullptr;
+        m_root = nullptr;
+        m_free_inner = nullptr;
+        m_free_leaf = nullptr;
+        m_elem_count = 0;
+    }
+
+    bool find(Tsrc t) const
+    {
+        UINT idx;
+        return findLeaf(t, idx) != nullptr;
+    }
+
+    //Get mapped element of 't'. Set find to true if t is already be mapped.
+    Ttgt get(Tsrc t, bool * f = nullptr) const
+    {
+        UINT idx;
+        LeafType const* leaf = findLeaf(t, idx);
+        if (f != nullptr) { *f = leaf != nullptr; }
+        return leaf != nullptr ? leaf->mapped[idx] : Ttgt(0);
+    }
+
+    //Get mapped element of 't'. If there isn't 't' in map, 't' and
+    //it's mapped element will be created. 'f' will be set according
+    //to the results of found 't'.
+    Ttgt getAndGen(Tsrc t, bool * f = nullptr)
+    {
+        UINT idx;
+        bool find = false;
+        LeafType * leaf = insert(t, idx, find);
+        if (f != nullptr) { *f = find; }
+        if (!find) {
+            leaf->mapped[idx] = m_gm.createMapped(t);
+        }
+        return leaf->mapped[idx];
+    }
+
+    UINT get_elem_count() const { return m_elem_count; }
+
+    //Get the first key-value in key order.
+    //iter should be clean by caller.
+    Tsrc get_first(Iter & iter, Ttgt * mapped = nullptr) const
+    {
+        iter.leaf = getFirstLeaf();
+        iter.idx = 0;
+        if (iter.leaf == nullptr || iter.leaf->num == 0) {
+            iter.leaf = nullptr;
+            if (mapped != nullptr) { *mapped = Ttgt(0); }
+            return Tsrc(0);
+        }
+        if (mapped != nullptr) { *mapped = iter.leaf->mapped[0]; }
+        return iter.leaf->key[0];
+    }
+
+    //The function only get the first key-value and mapped object.
+    Tsrc get_first(Ttgt * mapped = nullptr) const
+    {
+        Iter iter;
+        return get_first(iter, mapped);
+    }
+
+    //Get the next key-value in key order.
+    Tsrc get_next(Iter & iter, Ttgt * mapped = nullptr) const
+    {
+        if (iter.leaf == nullptr) {
+            if (mapped != nullptr) { *mapped = Ttgt(0); }
+            return Tsrc(0);
+        }
+        iter.idx++;
+        if (iter.idx >= iter.leaf->num) {
+            iter.leaf = iter.leaf->next;
+            iter.idx = 0;
+            if (iter.leaf == nullptr) {
+                if (mapped != nullptr) { *mapped = Ttgt(0); }
+                return Tsrc(0);
+            }
+        }
+        if (mapped != nullptr) { *mapped = iter.leaf->mapped[iter.idx]; }
+        return iter.leaf->key[iter.idx];
+    }
+
+    CompareKey * getCompareKeyObject() { return &m_ck; }
+
+    //The function should be invoked if BTreeMap is initialized manually.
+    void init()
+    {
+        if (is_init()) { return; }
+        m_inner_pool = smpoolCreate(sizeof(InnerType) * 4, MEM_CONST_SIZE);
+        m_leaf_pool = smpoolCreate(sizeof(LeafType) * 4, MEM_CONST_SIZE);
+        m_root = nullptr;
+        m_free_inner = nullptr;
+        m_free_leaf = nullptr;
+        m_elem_count = 0;
+    }
+
+    bool is_empty() const { return m_elem_count == 0; }
+    bool is_init() const { return m_leaf_pool != nullptr; }
+
+    void reinit() { destroy(); init(); }
+
+    //Remove 't' and return the mapped element of 't'.
+    Ttgt remove(Tsrc t)
+    {
+        if (m_root == nullptr) { return Ttgt(0); }
+        NodeType * x = m_root;
+        while (!x->is_leaf) {
+            InnerType * in = (InnerType*)x;
+            UINT i = upperBound(in, t);
+            if (in->child[i]->num <= MIN_KEY_NUM) {
+                i = fixChild(in, i);
+            }
+            x = in->child[i];
+        }
+        Ttgt mapped = Ttgt(0);
+        LeafType * leaf = (LeafType*)x;
+        UINT idx = lowerBound(leaf, t);
+        if (idx < leaf->num && m_ck.is_equ(leaf->key[idx], t)) {
+            mapped = leaf->mapped[idx];
+            removeLeafAt(leaf, idx);
+            m_elem_count--;
+        }
+        if (!m_root->is_leaf && m_root->num == 0) {
+            //Tree height decreased.
+            NodeType * oldroot = m_root;
+            m_root = ((InnerType*)oldroot)->child[0];
+            freeNode(oldroot);
+        } else if (m_root->is_leaf && m_root->num == 0) {
+            freeNode(m_root);
+            m_root = nullptr;
+        }
+        return mapped;
+    }
+
+    //Always set new object to 't'.
+    //The function will enforce mapping between t and mapped object even if
+    //'t' has been mapped.
+    Tsrc setAlways(Tsrc t, Ttgt mapped)
+    {
+        UINT idx;
+        bool find = false;
+        LeafType * leaf = insert(t, idx, find);
+        leaf->mapped[idx] = mapped;
+        return leaf->key[idx]; //key may be different with 't'.
+    }
+
+    //Always set new object to 't' if 't' has been inserted into the mapping
+    //table.
+    Tsrc setIfFind(Tsrc t, Ttgt mapped)
+    {
+        UINT idx;
+        LeafType * leaf = findLeaf(t, idx);
+        if (leaf == nullptr) { return Tsrc(0); }
+        leaf->mapped[idx] = mapped;
+        return leaf->key[idx]; //key may be different with 't'.
+    }
+
+    //Establishing mapping in between 't' and 'mapped'.
+    //Note The function will check whether 't' has been mapped.
+    Tsrc set(Tsrc t, Ttgt mapped)
+    {
+        UINT idx;
+        bool find = false;
+        LeafType * leaf = insert(t, idx, find);
+        ASSERTN(!find, ("already mapped"));
+        leaf->mapped[idx] = mapped;
+        return leaf->key[idx]; //key may be different with 't'.
+    }
+};
+//END BTreeMap
+
+
+//BTreeTab
+//
+//Make a table of T, the interface is same as TTab.
+template <class T, class CompareKey = CompareKeyBase<T> >
+class BTreeTab : public BTreeMap<T, T, CompareKey> {
+    COPY_CONSTRUCTOR(BTreeTab);
+public:
+    typedef BTreeMap<T, T, CompareKey> BaseTMap;
+    typedef typename BaseTMap::Iter Iter;
+public:
+    BTreeTab() {}
+
+    //Add element into table.
+    //Note: the element in the table must be unqiue.
+    T append(T t)
+    {
+        ASSERT0(t != T(0));
+        return BaseTMap::setAlways(t, t);
+    }
+
+    //Add element into table, if it is exist, return the exist one.
+    T append_and_retrieve(T t)
+    {
+        ASSERT0(t != T(0));
+        bool find = false;
+        T mapped = BaseTMap::get(t, &find);
+        if (find) {
+            return mapped;
+        }
+        return BaseTMap::setAlways(t, t);
+    }
+
+    T remove(T t)
+    {
+        ASSERT0(t != T(0));
+        return BaseTMap::remove(t);
+    }
+
+    bool find(T t) const { return BaseTMap::find(t); }
+
+    //iter should be clean by caller.
+    T get_first(Iter & iter) const { return BaseTMap::get_first(iter, nullptr); }
+
+    //The function only get the first element.
+    T get_first() const { return BaseTMap::get_first((T*)nullptr); }
+
+    T get_next(Iter & iter) const { return BaseTMap::get_next(iter, nullptr); }
+};
+//END BTreeTab
+
+} //namespace xcom
+#endif //END __BTREE_H__
@@ -25,6 +25,12 @@ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
 OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
 USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 @*/
+//NOTE: Intrinsic header has to be included before xcominc.h, because
+//xcom may redefine some C++11 keywords.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BYTEOP_X86_KERNEL
+#include <immintrin.h>
+#endif
 #include "xcominc.h"
 
 namespace xcom {
@@ -811,6 +817,386 @@ BYTE const g_last_one[256] = {
 };
 
 
+//
+//START ByteOpKernel
+//
+//The kernel describes a group of functions that implement the buffer
+//operations with specific instructions.
+class ByteOpKernel {
+public:
+    BYTEOP_KERNEL kind;
+    void (*bunion)(BYTE * tgt, BYTE const* src, UINT bytesize);
+    void (*intersect)(BYTE * tgt, BYTE const* src, UINT bytesize);
+    void (*diff)(BYTE * tgt, BYTE const* src, UINT bytesize);
+    bool (*is_intersect)(BYTE const* ptr1, BYTE const* ptr2, UINT bytesize);
+    UINT (*get_elem_count)(BYTE const* ptr, UINT bytesize);
+};
+
+
+#define WORD_BYTE_SIZE sizeof(UINT64)
+
+//Buffer of bitset is not guaranteed to be aligned in word, use memcpy to
+//access word to avoid unaligned access, compiler will generate a plain
+//load/store instruction for it.
+static inline UINT64 loadWord(BYTE const* p)
+{
+    UINT64 v;
+    ::memcpy((void*)&v, (void const*)p, WORD_BYTE_SIZE);
+    return v;
+}
+
+
+static inline void storeWord(BYTE * p, UINT64 v)
+{
+    ::memcpy((void*)p, (void const*)&v, WORD_BYTE_SIZE);
+}
+
+
+//Hamming weight of 64bit word.
+static inline UINT countWord(UINT64 v)
+{
+    v = v - ((v >> 1) & 0x5555555555555555ULL);
+    v = (v & 0x3333333333333333ULL) + ((v >> 2) & 0x3333333333333333ULL);
+    v = (v + (v >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (UINT)((v * 0x0101010101010101ULL) >> 56);
+}
+
+
+//Byte kernel.
+static void bunionByte(BYTE * tgt, BYTE const* src, UINT bytesize)
+{
+    for (UINT i = 0; i < bytesize; i++) {
+        tgt[i] |= src[i];
+    }
+}
+
+
+static void intersectByte(BYTE * tgt, BYTE const* src, UINT bytesize)
+{
+    for (UINT i = 0; i < bytesize; i++) {
+        tgt[i] &= src[i];
+    }
+}
+
+
+static void diffByte(BYTE * tgt, BYTE const* src, UINT bytesize)
+{
+    for (UINT i = 0; i < bytesize; i++) {
+        tgt[i] = (BYTE)(tgt[i] & ~src[i]);
+    }
+}
+
+
+static bool isIntersectByte(BYTE const* ptr1, BYTE const* ptr2,
+                            UINT bytesize)
+{
+    for (UINT i = 0; i < bytesize; i++) {
+        if ((ptr1[i] & ptr2[i]) != 0) { return true; }
+    }
+    return false;
+}
+
+
+//Add up the population count of each byte in the buffer. We get the
+//population counts from the table above.
+static UINT countByte(BYTE const* ptr, UINT bytesize)
+{
+    UINT count = 0;
+    for (UINT i = 0; i < bytesize; i++) {
+        count += g_bit_count[ptr[i]];
+    }
+    return count;
+}
+
+
+//Word kernel.
+//The functions begin with the byte at 'start', which is used by vector
+//kernels to handle the remaining bytes that less than a vector.
+static void bunionWord(BYTE * tgt, BYTE const* src, UINT bytesize,
+                       UINT start)
+{
+    UINT i = start;
+    for (; i + WORD_BYTE_SIZE <= bytesize; i += WORD_BYTE_SIZE) {
+        storeWord(tgt + i, loadWord(tgt + i) | loadWord(src + i));
+    }
+    bunionByte(tgt + i, src + i, bytesize - i);
+}
+
+
+static void intersectWord(BYTE * tgt, BYTE const* src, UINT bytesize,
+                          UINT start)
+{
+    UINT i = start;
+    for (; i + WORD_BYTE_SIZE <= bytesize; i += WORD_BYTE_SIZE) {
+        storeWord(tgt + i, loadWord(tgt + i) & loadWord(src + i));
+    }
+    intersectByte(tgt + i, src + i, bytesize - i);
+}
+
+
+static void diffWord(BYTE * tgt, BYTE const* src, UINT bytesize, UINT start)
+{
+    UINT i = start;
+    for (; i + WORD_BYTE_SIZE <= bytesize; i += WORD_BYTE_SIZE) {
+        UINT64 d = loadWord(src + i);
+        if (d != 0) {
+            storeWord(tgt + i, loadWord(tgt + i) & ~d);
+        }
+    }
+    diffByte(tgt + i, src + i, bytesize - i);
+}
+
+
+static bool isIntersectWord(BYTE const* ptr1, BYTE const* ptr2,
+                            UINT bytesize, UINT start)
+{
+    UINT i = start;
+    for (; i + WORD_BYTE_SIZE <= bytesize; i += WORD_BYTE_SIZE) {
+        if ((loadWord(ptr1 + i) & loadWord(ptr2 + i)) != 0) { return true; }
+    }
+    return isIntersectByte(ptr1 + i, ptr2 + i, bytesize - i);
+}
+
+
+static UINT countWord(BYTE const* ptr, UINT bytesize, UINT start)
+{
+    UINT count = 0;
+    UINT i = start;
+    for (; i + WORD_BYTE_SIZE <= bytesize; i += WORD_BYTE_SIZE) {
+        count += countWord(loadWord(ptr + i));
+    }
+    return count + countByte(ptr + i, bytesize - i);
+}
+
+
+static void bunionWord(BYTE * tgt, BYTE const* src, UINT bytesize)
+{
+    bunionWord(tgt, src, bytesize, 0);
+}
+
+
+static void intersectWord(BYTE * tgt, BYTE const* src, UINT bytesize)
+{
+    intersectWord(tgt, src, bytesize, 0);
+}
+
+
+static void diffWord(BYTE * tgt, BYTE const* src, UINT bytesize)
+{
+    diffWord(tgt, src, bytesize, 0);
+}
+
+
+static bool isIntersectWord(BYTE const* ptr1, BYTE const* ptr2,
+                            UINT bytesize)
+{
+    return isIntersectWord(ptr1, ptr2, bytesize, 0);
+}
+
+
+static UINT countWord(BYTE const* ptr, UINT bytesize)
+{
+    return countWord(ptr, bytesize, 0);
+}
+
+
+#ifdef BYTEOP_X86_KERNEL
+#define SSE2_BYTE_SIZE sizeof(__m128i)
+#define AVX2_BYTE_SIZE sizeof(__m256i)
+
+//SSE2 kernel.
+__attribute__((target("sse2")))
+static void bunionSSE2(BYTE * tgt, BYTE const* src, UINT bytesize)
+{
+    UINT i = 0;
+    for (; i + SSE2_BYTE_SIZE <= bytesize; i += SSE2_BYTE_SIZE) {
+        __m128i a = _mm_loadu_si128((__m128i const*)(tgt + i));
+        __m128i b = _mm_loadu_si128((__m128i const*)(src + i));
+        _mm_storeu_si128((__m128i*)(tgt + i), _mm_or_si128(a, b));
+    }
+    bunionWord(tgt, src, bytesize, i);
+}
+
+
+__attribute__((target("sse2")))
+static void intersectSSE2(BYTE * tgt, BYTE const* src, UINT bytesize)
+{
+    UINT i = 0;
+    for (; i + SSE2_BYTE_SIZE <= bytesize; i += SSE2_BYTE_SIZE) {
+        __m128i a = _mm_loadu_si128((__m128i const*)(tgt + i));
+        __m128i b = _mm_loadu_si128((__m128i const*)(src + i));
+        _mm_storeu_si128((__m128i*)(tgt + i), _mm_and_si128(a, b));
+    }
+    intersectWord(tgt, src, bytesize, i);
+}
+
+
+__attribute__((target("sse2")))
+static void diffSSE2(BYTE * tgt, BYTE const* src, UINT bytesize)
+{
+    UINT i = 0;
+    for (; i + SSE2_BYTE_SIZE <= bytesize; i += SSE2_BYTE_SIZE) {
+        __m128i a = _mm_loadu_si128((__m128i const*)(tgt + i));
+        __m128i b = _mm_loadu_si128((__m128i const*)(src + i));
+        //_mm_andnot_si128 computes ~b & a.
+        _mm_storeu_si128((__m128i*)(tgt + i), _mm_andnot_si128(b, a));
+    }
+    diffWord(tgt, src, bytesize, i);
+}
+
+
+__attribute__((target("sse2")))
+static bool isIntersectSSE2(BYTE const* ptr1, BYTE const* ptr2,
+                            UINT bytesize)
+{
+    UINT i = 0;
+    __m128i const zero = _mm_setzero_si128();
+    for (; i + SSE2_BYTE_SIZE <= bytesize; i += SSE2_BYTE_SIZE) {
+        __m128i a = _mm_loadu_si128((__m128i const*)(ptr1 + i));
+        __m128i b = _mm_loadu_si128((__m128i const*)(ptr2 + i));
+        __m128i eq = _mm_cmpeq_epi8(_mm_and_si128(a, b), zero);
+        if (_mm_movemask_epi8(eq) != 0xFFFF) { return true; }
+    }
+    return isIntersectWord(ptr1, ptr2, bytesize, i);
+}
+
+
+//AVX2 kernel.
+__attribute__((target("avx2")))
+static void bunionAVX2(BYTE * tgt, BYTE const* src, UINT bytesize)
+{
+    UINT i = 0;
+    for (; i + AVX2_BYTE_SIZE <= bytesize; i += AVX2_BYTE_SIZE) {
+        __m256i a = _mm256_loadu_si256((__m256i const*)(tgt + i));
+        __m256i b = _mm256_loadu_si256((__m256i const*)(src + i));
+        _mm256_storeu_si256((__m256i*)(tgt + i), _mm256_or_si256(a, b));
+    }
+    bunionWord(tgt, src, bytesize, i);
+}
+
+
+__attribute__((target("avx2")))
+static void intersectAVX2(BYTE * tgt, BYTE const* src, UINT bytesize)
+{
+    UINT i = 0;
+    for (; i + AVX2_BYTE_SIZE <= bytesize; i += AVX2_BYTE_SIZE) {
+        __m256i a = _mm256_loadu_si256((__m256i const*)(tgt + i));
+        __m256i b = _mm256_loadu_si256((__m256i const*)(src + i));
+        _mm256_storeu_si256((__m256i*)(tgt + i), _mm256_and_si256(a, b));
+    }
+    intersectWord(tgt, src, bytesize, i);
+}
+
+
+__attribute__((target("avx2")))
+static void diffAVX2(BYTE * tgt, BYTE const* src, UINT bytesize)
+{
+    UINT i = 0;
+    for (; i + AVX2_BYTE_SIZE <= bytesize; i += AVX2_BYTE_SIZE) {
+        __m256i a = _mm256_loadu_si256((__m256i const*)(tgt + i));
+        __m256i b = _mm256_loadu_si256((__m256i const*)(src + i));
+        //_mm256_andnot_si256 computes ~b & a.
+        _mm256_storeu_si256((__m256i*)(tgt + i), _mm256_andnot_si256(b, a));
+    }
+    diffWord(tgt, src, bytesize, i);
+}
+
+
+__attribute__((target("avx2")))
+static bool isIntersectAVX2(BYTE const* ptr1, BYTE const* ptr2,
+                            UINT bytesize)
+{
+    UINT i = 0;
+    for (; i + AVX2_BYTE_SIZE <= bytesize; i += AVX2_BYTE_SIZE) {
+        __m256i a = _mm256_loadu_si256((__m256i const*)(ptr1 + i));
+        __m256i b = _mm256_loadu_si256((__m256i const*)(ptr2 + i));
+        if (!_mm256_testz_si256(a, b)) { return true; }
+    }
+    return isIntersectWord(ptr1, ptr2, bytesize, i);
+}
+
+
+//Hardware population count.
+__attribute__((target("popcnt")))
+static UINT countPOPCNT(BYTE const* ptr, UINT bytesize)
+{
+    //Use several accumulators to break the dependence between adjacent
+    //popcnt instructions.
+    UINT64 c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+    UINT i = 0;
+    for (; i + 4 * WORD_BYTE_SIZE <= bytesize; i += 4 * WORD_BYTE_SIZE) {
+        c0 += __builtin_popcountll(loadWord(ptr + i));
+        c1 += __builtin_popcountll(loadWord(ptr + i + WORD_BYTE_SIZE));
+        c2 += __builtin_popcountll(loadWord(ptr + i + 2 * WORD_BYTE_SIZE));
+        c3 += __builtin_popcountll(loadWord(ptr + i + 3 * WORD_BYTE_SIZE));
+    }
+    for (; i + WORD_BYTE_SIZE <= bytesize; i += WORD_BYTE_SIZE) {
+        c0 += __builtin_popcountll(loadWord(ptr + i));
+    }
+    return (UINT)(c0 + c1 + c2 + c3) + countByte(ptr + i, bytesize - i);
+}
+#endif //END BYTEOP_X86_KERNEL
+
+
+static ByteOpKernel const g_byte_kernel = {
+    BYTEOP_KERNEL_BYTE, bunionByte, intersectByte, diffByte,
+    isIntersectByte, countByte
+};
+
+static ByteOpKernel const g_word_kernel = {
+    BYTEOP_KERNEL_WORD, bunionWord, intersectWord, diffWord,
+    isIntersectWord, countWord
+};
+
+#ifdef BYTEOP_X86_KERNEL
+static ByteOpKernel const g_sse2_kernel = {
+    BYTEOP_KERNEL_SSE2, bunionSSE2, intersectSSE2, diffSSE2,
+    isIntersectSSE2, countWord
+};
+
+static ByteOpKernel const g_sse2_popcnt_kernel = {
+    BYTEOP_KERNEL_SSE2, bunionSSE2, intersectSSE2, diffSSE2,
+    isIntersectSSE2, countPOPCNT
+};
+
+static ByteOpKernel const g_avx2_kernel = {
+    BYTEOP_KERNEL_AVX2, bunionAVX2, intersectAVX2, diffAVX2,
+    isIntersectAVX2, countPOPCNT
+};
+#endif
+
+
+//Return the kernel that not higher than 'kernel' and supported by host.
+static ByteOpKernel const* pickKernel(BYTEOP_KERNEL kernel)
+{
+    if (kernel == BYTEOP_KERNEL_BYTE) { return &g_byte_kernel; }
+    if (kernel == BYTEOP_KERNEL_UNDEF) { kernel = BYTEOP_KERNEL_AVX2; }
+#ifdef BYTEOP_X86_KERNEL
+    __builtin_cpu_init();
+    bool has_popcnt = __builtin_cpu_supports("popcnt");
+    if (kernel >= BYTEOP_KERNEL_AVX2 && __builtin_cpu_supports("avx2") &&
+        has_popcnt) {
+        return &g_avx2_kernel;
+    }
+    if (kernel >= BYTEOP_KERNEL_SSE2 && __builtin_cpu_supports("sse2")) {
+        return has_popcnt ? &g_sse2_popcnt_kernel : &g_sse2_kernel;
+    }
+#endif
+    return &g_word_kernel;
+}
+
+
+//The kernel is selected at the first time it is used. C++ guarantees the
+//initialization of local static variable is thread safe.
+static ByteOpKernel const*& getKernelRef()
+{
+    static ByteOpKernel const* kernel = pickKernel(BYTEOP_KERNEL_UNDEF);
+    return kernel;
+}
+
+//END ByteOpKernel
+
+
 BSIdx ByteOp::get_first_idx(BYTE const* ptr, UINT bytesize)
 {
     for (UINT i = 0; i < bytesize; i++) {
@@ -854,11 +1240,57 @@ BSIdx ByteOp::get_next_idx(BYTE const* ptr, UINT bytesize, BSIdx idx)
 
 UINT ByteOp::get_elem_count(BYTE const* ptr, UINT bytesize)
 {
-    UINT count = 0;
-    for (UINT i = 0; i < bytesize; i++) {
-        count += g_bit_count[ptr[i]];
+    return getKernelRef()->get_elem_count(ptr, bytesize);
+}
+
+
+void ByteOp::bunion(BYTE * tgt, BYTE const* src, UINT bytesize)
+{
+    getKernelRef()->bunion(tgt, src, bytesize);
+}
+
+
+void ByteOp::intersect(BYTE * tgt, BYTE const* src, UINT bytesize)
+{
+    getKernelRef()->intersect(tgt, src, bytesize);
+}
+
+
+void ByteOp::diff(BYTE * tgt, BYTE const* src, UINT bytesize)
+{
+    getKernelRef()->diff(tgt, src, bytesize);
+}
+
+
+bool ByteOp::is_intersect(BYTE const* ptr1, BYTE const* ptr2, UINT bytesize)
+{
+    return getKernelRef()->is_intersect(ptr1, ptr2, bytesize);
+}
+
+
+BYTEOP_KERNEL ByteOp::getKernel()
+{
+    return getKernelRef()->kind;
+}
+
+
+CHAR const* ByteOp::getKernelName(BYTEOP_KERNEL kernel)
+{
+    switch (kernel) {
+    case BYTEOP_KERNEL_BYTE: return "byte";
+    case BYTEOP_KERNEL_WORD: return "word";
+    case BYTEOP_KERNEL_SSE2: return "sse2";
+    case BYTEOP_KERNEL_AVX2: return "avx2";
+    default: return "undef";
     }
-    return count;
+}
+
+
+BYTEOP_KERNEL ByteOp::selectKernel(BYTEOP_KERNEL kernel)
+{
+    ByteOpKernel const* k = pickKernel(kernel);
+    getKernelRef() = k;
+    return k->kind;
 }
 
 } //namespace xcom
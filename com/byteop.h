@@ -49,8 +49,46 @@ extern BYTE const g_first_one[256];
 //Mapping from 8 bit unsigned integers to the index of the last one bit.
 extern BYTE const g_last_one[256];
 
+//The implementation level of operations that work on byte buffer.
+typedef enum {
+    BYTEOP_KERNEL_UNDEF = 0,
+    BYTEOP_KERNEL_BYTE, //Operate byte by byte, the most portable one.
+    BYTEOP_KERNEL_WORD, //Operate on 64bit word.
+    BYTEOP_KERNEL_SSE2, //Operate on 128bit vector via SSE2.
+    BYTEOP_KERNEL_AVX2, //Operate on 256bit vector via AVX2.
+} BYTEOP_KERNEL;
+
 class ByteOp {
 public:
+    //Select the implementation of buffer operations.
+    //Return the kernel actually be used, which might be lower than
+    //'kernel' if host CPU does not support it.
+    //If 'kernel' is BYTEOP_KERNEL_UNDEF, the best kernel that host CPU
+    //supported will be selected, that is also the default behavior.
+    //NOTE: the function is not thread safe, call it before bit buffer
+    //operations are performed concurrently.
+    static BYTEOP_KERNEL selectKernel(BYTEOP_KERNEL kernel);
+
+    //Return the kernel that is used by buffer operations.
+    static BYTEOP_KERNEL getKernel();
+
+    //Return the name of given kernel.
+    static CHAR const* getKernelName(BYTEOP_KERNEL kernel);
+
+    //Perform tgt = tgt | src.
+    static void bunion(BYTE * tgt, BYTE const* src, UINT bytesize);
+
+    //Perform tgt = tgt & src.
+    static void intersect(BYTE * tgt, BYTE const* src, UINT bytesize);
+
+    //Perform tgt = tgt & ~src.
+    static void diff(BYTE * tgt, BYTE const* src, UINT bytesize);
+
+    //Return true if there is at least one '1' at same position in both
+    //'ptr1' and 'ptr2'.
+    static bool is_intersect(BYTE const* ptr1, BYTE const* ptr2,
+                             UINT bytesize);
+
     //Return the bit index of first '1', start from '0'.
     //Return BS_UNDEF if there is no '1' in given byte buffer.
     static BSIdx get_first_idx(BYTE const* ptr, UINT bytesize);
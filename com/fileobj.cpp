@@ -25,6 +25,10 @@ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
 OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
 USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 @*/
+#ifndef _ON_WINDOWS_
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 #include "xcominc.h"
 
 namespace xcom {
@@ -52,6 +56,8 @@ FileObj::FileObj()
     m_is_readonly = false;
     m_file_name = nullptr;
     m_file_handler = nullptr;
+    m_map_addr = nullptr;
+    m_map_size = 0;
 }
 
 
@@ -119,11 +125,14 @@ FileObj::FileObj(FILE * h)
     ASSERT0(h);
     m_file_handler = h;
     m_is_opened = false;
+    m_is_readonly = false;
     m_file_name = nullptr;
+    m_map_addr = nullptr;
+    m_map_size = 0;
 }
 
 
-void FileObj::destroy()
+void FileObj::closeHandler()
 {
     if (m_file_handler == nullptr) { return; }
     if (isIOStream()) {
@@ -135,6 +144,45 @@ void FileObj::destroy()
 }
 
 
+void FileObj::destroy()
+{
+    closeHandler();
+    unmap();
+}
+
+
+BYTE * FileObj::map()
+{
+    if (m_map_addr != nullptr) { return m_map_addr; }
+    #ifdef _ON_WINDOWS_
+    return nullptr;
+    #else
+    if (m_file_handler == nullptr || isIOStream()) { return nullptr; }
+    size_t size = getFileSize();
+    if (size == 0) { return nullptr; }
+    //Flush buffered data to make it visible to the mapping.
+    ::fflush(m_file_handler);
+    void * addr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                         ::fileno(m_file_handler), 0);
+    if (addr == MAP_FAILED) { return nullptr; }
+    m_map_addr = (BYTE*)addr;
+    m_map_size = size;
+    return m_map_addr;
+    #endif
+}
+
+
+void FileObj::unmap()
+{
+    if (m_map_addr == nullptr) { return; }
+    #ifndef _ON_WINDOWS_
+    ::munmap((void*)m_map_addr, m_map_size);
+    #endif
+    m_map_addr = nullptr;
+    m_map_size = 0;
+}
+
+
 bool FileObj::isFileExist(CHAR const* filename)
 {
     ASSERT0(filename);
@@ -173,11 +221,42 @@ size_t FileObj::getFileSize() const
 }
 
 
+bool FileObj::getFileStat(OUT FileStat & st) const
+{
+    ASSERT0(m_file_handler);
+    ::memset((void*)&st, 0, sizeof(FileStat));
+    #ifdef _ON_WINDOWS_
+    return false;
+    #else
+    struct stat s;
+    if (::fstat(::fileno(m_file_handler), &s) != 0) { return false; }
+    st.size = (UINT64)s.st_size;
+    st.dev = (UINT64)s.st_dev;
+    st.ino = (UINT64)s.st_ino;
+    st.mtime_sec = (UINT64)s.st_mtim.tv_sec;
+    st.mtime_nsec = (UINT64)s.st_mtim.tv_nsec;
+    st.ctime_sec = (UINT64)s.st_ctim.tv_sec;
+    st.ctime_nsec = (UINT64)s.st_ctim.tv_nsec;
+    return true;
+    #endif
+}
+
+
 FO_STATUS FileObj::read(OUT BYTE * buf, size_t offset, size_t size,
                         OUT size_t * rd)
 {
     ASSERT0(buf);
     if (size == 0) { return FO_SUCC; }
+    if (m_map_addr != nullptr) {
+        //Serve the request from the mapping without system call.
+        size_t actual_rd = offset < m_map_size ?
+            MIN(size, m_map_size - offset) : 0;
+        if (actual_rd != 0) {
+            ::memcpy(buf, m_map_addr + offset, actual_rd);
+        }
+        if (rd != nullptr) { *rd = actual_rd; }
+        return FO_SUCC;
+    }
     ASSERT0(m_file_handler);
     ::fseek(m_file_handler, (LONG)offset, SEEK_SET);
     //actual_rd is the acutal byte size that read.
@@ -191,6 +270,7 @@ FO_STATUS FileObj::append(BYTE const* buf, size_t size, OUT size_t * wr)
 {
     ASSERT0(buf);
     if (size == 0) { return FO_SUCC; }
+    ASSERTN(!isMapped(), ("mapped file is not writable"));
     ASSERT0(m_file_handler);
     ::fseek(m_file_handler, (LONG)0, SEEK_END);
     //actual_wr is the acutal byte size that wrote.
@@ -205,6 +285,7 @@ FO_STATUS FileObj::write(BYTE const* buf, size_t offset, size_t size,
 {
     ASSERT0(buf);
     if (size == 0) { return FO_SUCC; }
+    ASSERTN(!isMapped(), ("mapped file is not writable"));
     if (offset > getFileSize()) { return FO_EXCEDE_FILE_END; }
     ASSERT0(m_file_handler);
     ::fseek(m_file_handler, (LONG)offset, SEEK_SET);
@@ -39,6 +39,23 @@ typedef enum {
     FO_CAN_NOT_CREATE_NEW_FILE,
 } FO_STATUS;
 
+//The identity of a file on host file system. Two states of a file with the
+//same identity are regarded as the same content.
+class FileStat {
+public:
+    UINT64 size;
+    UINT64 dev;
+    UINT64 ino;
+
+    //The last modification time and status change time since the Epoch.
+    //The status change time can not be set by user, it guards the file
+    //against the tool that restores the modification time.
+    UINT64 mtime_sec;
+    UINT64 mtime_nsec;
+    UINT64 ctime_sec;
+    UINT64 ctime_nsec;
+};
+
 class FileObj {
     COPY_CONSTRUCTOR(FileObj);
 protected:
@@ -48,6 +65,10 @@ public:
     bool m_is_readonly;
     FILE * m_file_handler;
     CHAR const* m_file_name;
+
+    //Record the private mapping of file content that established by map().
+    BYTE * m_map_addr;
+    size_t m_map_size;
 public:
     //is_del: true to delete the file with same name.
     FileObj(CHAR const* filename, bool is_del = false,
@@ -56,6 +77,8 @@ public:
         m_file_handler = nullptr;
         m_is_opened = false;
         m_file_name = nullptr;
+        m_map_addr = nullptr;
+        m_map_size = 0;
         init(filename, is_del, is_readonly, st);
     }
     FileObj(FILE * h);
@@ -76,20 +99,62 @@ public:
     void init(CHAR const* filename, bool is_del,
               bool is_readonly, OUT FO_STATUS * st);
 
-    //Close and free file resource.
+    //Close the file handler. The mapping established by map() is still
+    //accessible after the handler closed until unmap() is invoked.
+    void closeHandler();
+
+    //Close and free file resource, include the file mapping.
     void destroy();
 
     FILE * getFileHandler() const { return m_file_handler; }
+
+    //Return the start address of file mapping, or nullptr if the file
+    //has not been mapped.
+    BYTE * getMapAddr() const { return m_map_addr; }
+    size_t getMapSize() const { return m_map_size; }
+
+    //Return the address of the byte at 'offset' in the file mapping if
+    //the range [offset, offset + size) is entirely inside the mapping,
+    //otherwise return nullptr.
+    BYTE * getMapAddr(size_t offset, size_t size) const
+    {
+        if (m_map_addr == nullptr || offset > m_map_size ||
+            size > m_map_size - offset) {
+            return nullptr;
+        }
+        return m_map_addr + offset;
+    }
+
     size_t getFileSize() const;
+
+    //Fill 'st' with the identity of the file on host file system.
+    //Return false if the identity is unavailable on the host.
+    bool getFileStat(OUT FileStat & st) const;
     CHAR const* getFileName() const { return m_file_name; }
     static CHAR const* getFileStatusName(FO_STATUS st);
 
     //Return true if current file object is IO stream, e.g: stdout.
     bool isIOStream() const;
 
+    //Return true if the file content has been mapped into memory.
+    bool isMapped() const { return m_map_addr != nullptr; }
+
     //Return true if 'filename' exist.
     static bool isFileExist(CHAR const* filename);
 
+    //Map the whole file content into memory, and return the start address
+    //of mapping. Return nullptr if the mapping is unavailable, e.g: the
+    //file is empty, or the host does not support file mapping. Caller
+    //should fall back to read() in that case.
+    //The mapping is private to current process: the content is read on
+    //demand by page, and any write to the mapping is copied on write, it
+    //never reaches the file. read() will serve from the mapping without
+    //system call once the file mapped.
+    BYTE * map();
+
+    //Release the mapping established by map().
+    void unmap();
+
     void prt(CHAR const* format, ...);
 
     FO_STATUS openWithReadOnly(CHAR const* filename);
@@ -1470,6 +1470,7 @@ DGraph::DGraph(UINT vex_hash_size) : Graph(vex_hash_size)
 {
     set_dense(true);
     m_bs_mgr = nullptr;
+    m_is_dom_set_lazy = false;
 }
 
 
@@ -1477,6 +1478,7 @@ DGraph::DGraph(DGraph const& g) : Graph(g)
 {
     ASSERTN(g.is_dense(), ("Dominate Graph have to be dense graph"));
     m_bs_mgr = g.m_bs_mgr;
+    m_is_dom_set_lazy = false;
     if (m_bs_mgr != nullptr) {
         cloneDomAndPdom(g);
     }
@@ -1514,6 +1516,8 @@ size_t DGraph::count_mem() const
     size_t count = m_dom_set.count_mem();
     count += m_pdom_set.count_mem(); //record post-dominator-set of each vertex.
     count += m_idom_set.count_mem(); //immediate dominator.
+    count += m_dom_pre.count_mem();
+    count += m_dom_post.count_mem();
     count += m_ipdom_set.count_mem(); //immediate post dominator.
     count += sizeof(m_bs_mgr); //Do NOT count up the bitset in BS_MGR.
     return count;
@@ -2010,6 +2014,7 @@ static bool computeIdomForVertexInSubGraph(
 void DGraph::computeIdomForSubGraph(Vertex const* entry,
                                     List<Vertex const*> const& vlst)
 {
+    materializeDomSet();
     TTab<VexIdx> vextab;
     //Initialize idom-set for vertex in 'vlst' before recompute their idom.
     List<Vertex const*>::Iter ct;
@@ -2125,6 +2130,7 @@ void DGraph::computeEntryList(OUT List<Vertex const*> & lst) const
 
 bool DGraph::computeIdom2(List<Vertex const*> const& vlst)
 {
+    materializeDomSet();
     //Initialize idom-set.
     m_idom_set.clean();
     bool changed = true;
@@ -2142,6 +2148,315 @@ bool DGraph::computeIdom2(List<Vertex const*> const& vlst)
 }
 
 
+//
+//START SemiNCA
+//
+//The class computes immediate dominator by Semi-NCA algorithm.
+//The algorithm numbers vertex in DFS preorder, computes semi-dominator in
+//reverse preorder through a path-compressed forest, then derives idom by
+//walking the DFS tree from each vertex's parent up to its semi-dominator.
+//A virtual root numbered 0 connects all graph entries, thus the vertex
+//whose idom is the virtual root does not have an idom.
+//Ref: L.Georgiadis, Linear-Time Algorithms for Dominators and Related
+//Problems, 2005.
+#define SNCA_UNDEF ((UINT)-1)
+class SemiNCA {
+    COPY_CONSTRUCTOR(SemiNCA);
+    //Record the info of vertex that indexed by DFS preorder number.
+    class Node {
+    public:
+        UINT parent; //parent on DFS tree.
+        UINT semi; //semi-dominator.
+        UINT label; //the vertex with minimal semi on forest path.
+        UINT ancestor; //ancestor in path-compressed forest.
+        UINT idom;
+        Vertex const* vex;
+    };
+    UINT m_num; //the number of numbered vertex, include the virtual root.
+    UINT m_cap; //the capacity of m_node.
+    Node * m_node;
+    Vector<UINT> m_dfn; //map vertex id to DFS preorder number.
+    Vector<UINT> m_stk; //a buffer to avoid recursion.
+private:
+    void compress(UINT v);
+    void dfs(Vertex const* root);
+    UINT eval(UINT v);
+    void number(Vertex const* v, UINT parent);
+public:
+    SemiNCA(UINT vexnum) : m_num(1), m_cap(vexnum + 1)
+    {
+        m_node = (Node*)::malloc(sizeof(Node) * m_cap);
+        ASSERT0(m_node);
+        m_dfn.grow(m_cap);
+        //Number 0 is the virtual root.
+        m_node[0].parent = SNCA_UNDEF;
+        m_node[0].semi = 0;
+        m_node[0].label = 0;
+        m_node[0].ancestor = SNCA_UNDEF;
+        m_node[0].idom = 0;
+        m_node[0].vex = nullptr;
+    }
+    ~SemiNCA() { ::free(m_node); }
+
+    //Compute idom for vertices that reachable from given entries.
+    //entries: the vertices that are connected to virtual root.
+    void compute(List<Vertex const*> const& entries);
+
+    //Return the idom of 'v', or VERTEX_UNDEF if 'v' does not have idom or
+    //not reachable from entries.
+    VexIdx getIdom(Vertex const* v) const
+    {
+        UINT n = m_dfn.get(v->id());
+        if (n == 0) { return VERTEX_UNDEF; }
+        UINT i = m_node[n].idom;
+        return i == 0 ? VERTEX_UNDEF : m_node[i].vex->id();
+    }
+
+    //Return true if 'v' is reachable from entries.
+    bool isReached(Vertex const* v) const { return m_dfn.get(v->id()) != 0; }
+};
+
+
+void SemiNCA::number(Vertex const* v, UINT parent)
+{
+    UINT n = m_num++;
+    ASSERTN(n < m_cap, ("vertex number is out of date"));
+    m_dfn.set(v->id(), n);
+    Node & node = m_node[n];
+    node.parent = parent;
+    node.semi = n;
+    node.label = n;
+    node.ancestor = SNCA_UNDEF;
+    node.idom = 0;
+    node.vex = v;
+}
+
+
+void SemiNCA::dfs(Vertex const* root)
+{
+    if (m_dfn.get(root->id()) != 0) { return; }
+    //Record the out-edge of vertex on DFS path that will be visited next.
+    Vector<EdgeC const*> estk;
+    INT top = 0;
+    number(root, 0);
+    m_stk.set(0, m_num - 1);
+    estk.set(0, root->getOutList());
+    while (top >= 0) {
+        EdgeC const* ec = estk.get(top);
+        if (ec == nullptr) {
+            top--;
+            continue;
+        }
+        estk.set(top, ec->get_next());
+        Vertex const* succ = ec->getTo();
+        if (m_dfn.get(succ->id()) != 0) { continue; }
+        number(succ, m_stk.get(top));
+        top++;
+        m_stk.set(top, m_num - 1);
+        estk.set(top, succ->getOutList());
+    }
+}
+
+
+//The function compresses forest path from 'v' to the root of the tree that
+//'v' belongs to.
+void SemiNCA::compress(UINT v)
+{
+    INT top = -1;
+    for (UINT u = v; m_node[m_node[u].ancestor].ancestor != SNCA_UNDEF;
+         u = m_node[u].ancestor) {
+        m_stk.set(++top, u);
+    }
+    //Propagate label and ancestor from the vertex nearest to root.
+    for (; top >= 0; top--) {
+        Node & u = m_node[m_stk.get(top)];
+        Node const& a = m_node[u.ancestor];
+        if (m_node[a.label].semi < m_node[u.label].semi) {
+            u.label = a.label;
+        }
+        u.ancestor = a.ancestor;
+    }
+}
+
+
+UINT SemiNCA::eval(UINT v)
+{
+    if (m_node[v].ancestor == SNCA_UNDEF) { return v; }
+    compress(v);
+    return m_node[v].label;
+}
+
+
+void SemiNCA::compute(List<Vertex const*> const& entries)
+{
+    List<Vertex const*>::Iter it;
+    for (Vertex const* v = entries.get_head(&it);
+         v != nullptr; v = entries.get_next(&it)) {
+        dfs(v);
+    }
+    //Compute semi-dominator in reverse preorder.
+    for (UINT w = m_num - 1; w >= 1; w--) {
+        Node & wn = m_node[w];
+        if (wn.parent == 0) {
+            //Entry is the successor of virtual root.
+            wn.semi = 0;
+        }
+        AdjVertexIter ait;
+        for (Vertex const* in = Graph::get_first_in_vertex(wn.vex, ait);
+             in != nullptr; in = Graph::get_next_in_vertex(ait)) {
+            UINT v = m_dfn.get(in->id());
+            if (v == 0) {
+                //Predecessor is unreachable from entries.
+                continue;
+            }
+            UINT u = eval(v);
+            if (m_node[u].semi < wn.semi) {
+                wn.semi = m_node[u].semi;
+            }
+        }
+        //Link w to its DFS parent in the forest.
+        wn.ancestor = wn.parent;
+    }
+    //Compute idom through nearest common ancestor of DFS tree.
+    for (UINT w = 1; w < m_num; w++) {
+        UINT i = m_node[w].parent;
+        while (i > m_node[w].semi) { i = m_node[i].idom; }
+        m_node[w].idom = i;
+    }
+}
+//END SemiNCA
+
+
+void DGraph::computeDomInterval(List<Vertex const*> const& roots)
+{
+    m_dom_pre.clean();
+    m_dom_post.clean();
+
+    //Build the children list of dominator tree.
+    UINT vexnum = getVertexNum() + 1;
+    Vector<VexIdx> first_child(vexnum);
+    Vector<VexIdx> next_sibling(vexnum);
+    VertexIter c = VERTEX_UNDEF;
+    for (Vertex const* v = get_first_vertex(c);
+         v != nullptr; v = get_next_vertex(c)) {
+        VexIdx idom = get_idom(v->id());
+        if (idom == VERTEX_UNDEF) { continue; }
+        next_sibling.set(v->id(), first_child.get(idom));
+        first_child.set(idom, v->id());
+    }
+
+    //Number vertex in preorder and postorder of dominator tree. The number
+    //starts at 1, 0 means the vertex does not have DomInfo.
+    UINT count = 1;
+    Vector<VexIdx> stk; //record the path from root to current vertex.
+    Vector<VexIdx> next; //record the child that will be visited next.
+    List<Vertex const*>::Iter it;
+    for (Vertex const* r = roots.get_head(&it);
+         r != nullptr; r = roots.get_next(&it)) {
+        if (m_dom_pre.get(r->id()) != 0) { continue; }
+        INT top = 0;
+        stk.set(0, r->id());
+        next.set(0, first_child.get(r->id()));
+        m_dom_pre.set(r->id(), count++);
+        while (top >= 0) {
+            VexIdx child = next.get(top);
+            if (child == VERTEX_UNDEF) {
+                m_dom_post.set(stk.get(top), count++);
+                top--;
+                continue;
+            }
+            next.set(top, next_sibling.get(child));
+            m_dom_pre.set(child, count++);
+            top++;
+            stk.set(top, child);
+            next.set(top, first_child.get(child));
+        }
+    }
+}
+
+
+bool DGraph::computeIdomBySemiNCA(List<Vertex const*> const& vlst)
+{
+    //The head of 'vlst' is the root, other graph entries are also the
+    //successors of virtual root.
+    List<Vertex const*> entries;
+    List<Vertex const*>::Iter it;
+    for (Vertex const* v = vlst.get_head(&it);
+         v != nullptr; v = vlst.get_next(&it)) {
+        if (entries.get_elem_count() == 0 || is_graph_entry(v)) {
+            entries.append_tail(v);
+        }
+    }
+    SemiNCA snca(getVertexNum());
+    snca.compute(entries);
+
+    //Dominator-set will be generated on demand. The allocated set is
+    //reused when it is regenerated.
+    m_dom_set_done.clean();
+    m_idom_set.clean();
+    List<Vertex const*> roots;
+    VertexIter c = VERTEX_UNDEF;
+    for (Vertex const* v = get_first_vertex(c);
+         v != nullptr; v = get_next_vertex(c)) {
+        if (!snca.isReached(v)) { continue; }
+        VexIdx idom = snca.getIdom(v);
+        m_idom_set.set(v->id(), idom);
+        if (idom == VERTEX_UNDEF) { roots.append_tail(v); }
+    }
+    //The vertex in 'vlst' that unreachable from entries does not have
+    //idom, its dominator-set is empty.
+    for (Vertex const* v = vlst.get_head(&it);
+         v != nullptr; v = vlst.get_next(&it)) {
+        if (!snca.isReached(v)) { roots.append_tail(v); }
+    }
+    computeDomInterval(roots);
+    m_is_dom_set_lazy = true;
+    return true;
+}
+
+
+DomSet * DGraph::genDomSetByIdom(VexIdx id) const
+{
+    DomSet * set = m_dom_set.get((VecIdx)id);
+    if (m_dom_pre.get((VecIdx)id) == 0 ||
+        m_dom_set_done.is_contain((BSIdx)id)) {
+        return set;
+    }
+    if (set == nullptr) {
+        ASSERTN(m_bs_mgr, ("miss BitSetMgr"));
+        set = m_bs_mgr->create();
+        m_dom_set.set((VecIdx)id, set);
+    } else {
+        set->clean();
+    }
+    m_dom_set_done.bunion((BSIdx)id);
+    for (VexIdx idom = get_idom(id);
+         idom != VERTEX_UNDEF; idom = get_idom(idom)) {
+        set->bunion((BSIdx)idom);
+        if (m_dom_set_done.is_contain((BSIdx)idom)) {
+            set->bunion(*m_dom_set.get((VecIdx)idom));
+            break;
+        }
+    }
+    return set;
+}
+
+
+void DGraph::materializeDomSet()
+{
+    if (!m_is_dom_set_lazy) { return; }
+    VertexIter c = VERTEX_UNDEF;
+    for (Vertex const* v = get_first_vertex(c);
+         v != nullptr; v = get_next_vertex(c)) {
+        genDomSetByIdom(v->id());
+    }
+    m_is_dom_set_lazy = false;
+    m_dom_pre.clean();
+    m_dom_post.clean();
+    m_dom_set_done.clean();
+}
+
+
 bool DGraph::verifyPdom(DGraph & g, RPOVexList const& rpovlst) const
 {
     RPOVexList vlst;
@@ -2249,6 +2564,7 @@ bool DGraph::verifyDomAndPdom() const
 //NOTE: Entry does not have idom.
 bool DGraph::computeIdom()
 {
+    materializeDomSet();
     //Initialize idom-set.
     m_idom_set.clean();
 
@@ -2569,10 +2885,10 @@ CHAR const* DGraph::dumpDom(OUT StrBuf & buf) const
     for (Vertex * v = get_first_vertex(c);
          v != nullptr; v = get_next_vertex(c)) {
         VexIdx vid = VERTEX_id(v);
-        BitSet * bs;
+        BitSet const* bs;
         buf.strcat("\nVERTEX(%d)", vid);
         buf.strcat("\n  domset:");
-        if ((bs = m_dom_set.get(vid)) != nullptr) {
+        if ((bs = get_dom_set(vid)) != nullptr) {
             for (BSIdx id = bs->get_first();
                  id != BS_UNDEF ; id = bs->get_next((VexIdx)id)) {
                 if ((VexIdx)id != vid) {
@@ -2753,6 +3069,7 @@ void DGraph::freePdomSet(VexIdx vid)
 
 void DGraph::freeDomSet(VexIdx vid)
 {
+    materializeDomSet();
     DomSet * domset = m_dom_set.get(vid);
     if (domset != nullptr) {
         m_bs_mgr->free(domset);
@@ -800,11 +800,24 @@ typedef BitSet DomSet;
 //
 class DGraph : public Graph {
 protected:
+    //True if dominator-set has not been materialized. Dominance query is
+    //answered by the interval numbers of dominator tree, and dominator-set
+    //is generated on demand from idom.
+    bool m_is_dom_set_lazy;
     BitSetMgr * m_bs_mgr;
-    Vector<BitSet*> m_dom_set; //record dominator-set of each vertex.
+    mutable Vector<BitSet*> m_dom_set; //record dominator-set of each vertex.
     Vector<BitSet*> m_pdom_set; //record post-dominator-set of each vertex.
     Vector<VexIdx> m_idom_set; //immediate dominator.
     Vector<VexIdx> m_ipdom_set; //immediate post dominator.
+
+    //Record the preorder and postorder number of vertex on dominator tree.
+    //They are only available if m_is_dom_set_lazy is true.
+    //Number 0 means the vertex does not have DomInfo.
+    Vector<UINT> m_dom_pre;
+    Vector<UINT> m_dom_post;
+
+    //Record the vertex whose dominator-set has been generated in lazy mode.
+    mutable BitSet m_dom_set_done;
     RPOMgr m_rpomgr;
 protected:
     //The function will compute idom for subgraph that rooted by 'entry'.
@@ -818,6 +831,13 @@ protected:
     bool computeIdomForFullGraph(List<Vertex const*> const& vlst);
     void freeDomSet(VexIdx vid);
     void freePdomSet(VexIdx vid);
+
+    //Number vertex in preorder and postorder of dominator tree.
+    //roots: the vertices that do not have idom.
+    void computeDomInterval(List<Vertex const*> const& roots);
+
+    //Generate dominator-set of vertex 'id' by walking its idom chain.
+    DomSet * genDomSetByIdom(VexIdx id) const;
     void removeUnreachNodeRecur(VexIdx id, BitSet & visited);
     bool verifyPdom(DGraph & g, RPOVexList const& rpovlst) const;
     bool verifyDom(DGraph & g, RPOVexList const& rpovlst) const;
@@ -924,6 +944,15 @@ public:
     //Compute immediate dominate vertex.
     bool computeIdom();
 
+    //Compute immediate dominate vertex by Semi-NCA algorithm.
+    //The function does not compute dominator-set, the dominance query is
+    //answered in O(1) by interval numbers of dominator tree, and the
+    //dominator-set is materialized on demand.
+    //vlst: a list of vertex which sort in rpo order, the head of 'vlst'
+    //      is the root of graph.
+    //NOTE: Entry vertex does not have idom.
+    bool computeIdomBySemiNCA(List<Vertex const*> const& vlst);
+
     //Compute immediate dominate vertex.
     //Vertices should have been sorted in rpo.
     //vlst: a list of vertex which sort in rpo order.
@@ -985,7 +1014,10 @@ public:
     void genPDomTree(OUT DomTree & pdt) const;
 
     DomSet const* get_dom_set(VexIdx id) const
-    { return m_dom_set.get((VecIdx)id); }
+    {
+        if (m_is_dom_set_lazy) { return genDomSetByIdom(id); }
+        return m_dom_set.get((VecIdx)id);
+    }
 
     RPOMgr & getRPOMgr() { return m_rpomgr; }
 
@@ -994,6 +1026,7 @@ public:
     inline DomSet * gen_dom_set(VexIdx id)
     {
         ASSERT0(m_bs_mgr != nullptr);
+        materializeDomSet();
         DomSet * set = m_dom_set.get((VecIdx)id);
         if (set == nullptr) {
             set = m_bs_mgr->create();
@@ -1034,9 +1067,20 @@ public:
         return gen_pdom_set(VERTEX_id(v));
     }
 
+    //Return true if dominator-set has not been materialized.
+    bool isDomSetLazy() const { return m_is_dom_set_lazy; }
+
     //Return true if 'v1' dominate 'v2'.
     bool is_dom(VexIdx v1, VexIdx v2) const
     {
+        if (m_is_dom_set_lazy) {
+            //v1 strictly dominates v2 if the interval of v2 is nested in
+            //the interval of v1.
+            UINT pre2 = m_dom_pre.get((VecIdx)v2);
+            ASSERTN(pre2 != 0, ("no DOM info about vertex%d", v2));
+            return v1 != v2 && m_dom_pre.get((VecIdx)v1) < pre2 &&
+                   m_dom_post.get((VecIdx)v2) < m_dom_post.get((VecIdx)v1);
+        }
         ASSERTN(get_dom_set(v2), ("no DOM info about vertex%d", v2));
         return get_dom_set(v2)->is_contain((BSIdx)v1);
     }
@@ -1062,7 +1106,10 @@ public:
     void sortPred(MOD Vertex * vex, Vector<VexIdx> const& order);
     void setBitSetMgr(BitSetMgr * bs_mgr) { m_bs_mgr = bs_mgr; }
     void set_idom(VexIdx vid, VexIdx idom)
-    { m_idom_set.set((VecIdx)vid, idom); }
+    {
+        materializeDomSet();
+        m_idom_set.set((VecIdx)vid, idom);
+    }
     void set_ipdom(VexIdx vid, VexIdx ipdom)
     { m_ipdom_set.set((VecIdx)vid, ipdom); }
 
@@ -1099,6 +1146,12 @@ public:
     void removeDomInfo(VexIdx vex, bool iter_pred_succ, OUT UINT & iter_time)
     { removeDomInfo(getVertex(vex), iter_pred_succ, iter_time); }
 
+    //Generate dominator-set for all vertices if they have not been
+    //materialized. The function has to be invoked before DomInfo is
+    //updated incrementally, because the interval numbers can not be
+    //maintained after that.
+    void materializeDomSet();
+
     bool verifyDom() const;
     bool verifyPdom() const;
     bool verifyDomAndPdom() const;
@@ -68,9 +68,273 @@ static bool g_is_pool_init = false;
 static bool g_is_pool_hashed = true;
 ULONGLONG g_stat_mem_size = 0;
 
+//The range of chunk byte size that cached in magazine, chunk is rounded up
+//to power of 2 of size class.
+#define MAGAZINE_MIN_SHIFT 8
+#define MAGAZINE_MAX_SHIFT 16
+#define MAGAZINE_CLASS_NUM (MAGAZINE_MAX_SHIFT - MAGAZINE_MIN_SHIFT + 1)
+
+//The maximum number of chunks cached in each class.
+#define MAGAZINE_DEPTH 16
+
+//Magazine caches the chunks freed by current thread, and serves chunk
+//allocation of pools in the same thread without querying system
+//allocator. Each thread has its own magazine, thus there is no lock.
+class Magazine {
+    COPY_CONSTRUCTOR(Magazine);
+    bool m_is_destroyed;
+    UINT m_num[MAGAZINE_CLASS_NUM];
+    void * m_chunk[MAGAZINE_CLASS_NUM][MAGAZINE_DEPTH];
+public:
+    Magazine()
+    {
+        m_is_destroyed = false;
+        ::memset((void*)m_num, 0, sizeof(m_num));
+    }
+    ~Magazine()
+    {
+        for (UINT i = 0; i < MAGAZINE_CLASS_NUM; i++) {
+            for (UINT j = 0; j < m_num[i]; j++) {
+                ::free(m_chunk[i][j]);
+            }
+            m_num[i] = 0;
+        }
+        //Chunks freed after magazine destroyed, e.g: pools in global
+        //objects, will be returned to system directly.
+        m_is_destroyed = true;
+    }
+
+    //Return the class of chunk, 0 means the chunk is too large to cache.
+    static UINT computeClass(size_t chunk_size)
+    {
+        UINT shift = MAGAZINE_MIN_SHIFT;
+        for (; shift <= MAGAZINE_MAX_SHIFT; shift++) {
+            if (chunk_size <= (((size_t)1) << shift)) {
+                return shift - MAGAZINE_MIN_SHIFT + 1;
+            }
+        }
+        return 0;
+    }
+
+    static size_t getClassByteSize(UINT cls)
+    {
+        ASSERT0(cls > 0 && cls <= MAGAZINE_CLASS_NUM);
+        return ((size_t)1) << (cls - 1 + MAGAZINE_MIN_SHIFT);
+    }
+
+    //Return a cached chunk of given class, or nullptr if there is not.
+    void * get(UINT cls)
+    {
+        ASSERT0(cls > 0 && cls <= MAGAZINE_CLASS_NUM);
+        if (m_is_destroyed || m_num[cls - 1] == 0) { return nullptr; }
+        m_num[cls - 1]--;
+        return m_chunk[cls - 1][m_num[cls - 1]];
+    }
+
+    //Return true if chunk is cached.
+    bool put(UINT cls, void * chunk)
+    {
+        ASSERT0(cls > 0 && cls <= MAGAZINE_CLASS_NUM);
+        if (m_is_destroyed || m_num[cls - 1] >= MAGAZINE_DEPTH) {
+            return false;
+        }
+        m_chunk[cls - 1][m_num[cls - 1]] = chunk;
+        m_num[cls - 1]++;
+        return true;
+    }
+};
+
+static thread_local Magazine g_magazine;
+
+//Record the byte size and the peak of chunks held by pools of current
+//thread. Chunk freed by other thread is subtracted from that thread.
+static thread_local LONGLONG g_thread_mem_size = 0;
+static thread_local LONGLONG g_thread_mem_peak = 0;
+
+//Record the byte size and the peak of chunks held by pools of all threads.
+//The counters are updated atomically, and only if the total accounting is
+//enabled, because the atomic updating is contended by all threads.
+static LONGLONG g_total_mem_size = 0;
+static LONGLONG g_total_mem_peak = 0;
+static bool g_is_total_mem_accounting = false;
+
+
+static void addTotalMemSize(LONGLONG size)
+{
+    if (!g_is_total_mem_accounting) { return; }
+    #ifdef __GNUC__
+    LONGLONG cur = __atomic_add_fetch(&g_total_mem_size, size,
+                                      __ATOMIC_RELAXED);
+    if (size <= 0) { return; }
+    LONGLONG peak = __atomic_load_n(&g_total_mem_peak, __ATOMIC_RELAXED);
+    while (cur > peak &&
+           !__atomic_compare_exchange_n(&g_total_mem_peak, &peak, cur, true,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        //peak has been updated by the failed exchange.
+    }
+    #else
+    g_total_mem_size += size;
+    g_total_mem_peak = MAX(g_total_mem_peak, g_total_mem_size);
+    #endif
+}
+
+
+void smpoolEnableTotalMemAccounting(bool enable)
+{
+    g_is_total_mem_accounting = enable;
+}
+
+
+bool smpoolIsTotalMemAccounting()
+{
+    return g_is_total_mem_accounting;
+}
+
+
+LONGLONG smpoolGetTotalMemSize()
+{
+    return g_total_mem_size;
+}
+
+
+LONGLONG smpoolGetTotalMemPeak()
+{
+    return g_total_mem_peak;
+}
+
+
+void smpoolResetTotalMemPeak()
+{
+    g_total_mem_peak = g_total_mem_size;
+}
+
+
+LONGLONG smpoolGetThreadMemSize()
+{
+    return g_thread_mem_size;
+}
+
+
+void smpoolAddThreadMemSize(LONGLONG size)
+{
+    addTotalMemSize(size);
+    g_thread_mem_size += size;
+    if (size > 0) {
+        g_thread_mem_peak = MAX(g_thread_mem_peak, g_thread_mem_size);
+    }
+}
+
+
+LONGLONG smpoolGetThreadMemPeak()
+{
+    return g_thread_mem_peak;
+}
+
+
+void smpoolSetThreadMemPeak(LONGLONG peak)
+{
+    g_thread_mem_peak = peak;
+}
+
+
+//Record the account that out-of-pool memory of current thread is
+//attributed to.
+static thread_local MemAccount * g_thread_mem_account = nullptr;
+
+void smpoolSetThreadMemAccount(MemAccount * account)
+{
+    g_thread_mem_account = account;
+}
+
+
+MemAccount * smpoolGetThreadMemAccount()
+{
+    return g_thread_mem_account;
+}
+
+
+//
+//START MemAccount
+//
+void MemAccount::addSize(LONGLONG size)
+{
+    addTotalMemSize(size);
+    #ifdef __GNUC__
+    __atomic_add_fetch(&m_size, size, __ATOMIC_RELAXED);
+    #else
+    m_size += size;
+    #endif
+}
+
+
+LONGLONG MemAccount::getSize() const
+{
+    #ifdef __GNUC__
+    return __atomic_load_n(&m_size, __ATOMIC_RELAXED);
+    #else
+    return m_size;
+    #endif
+}
+
+
+void MemAccount::hold()
+{
+    #ifdef __GNUC__
+    __atomic_add_fetch(&m_refcnt, 1, __ATOMIC_RELAXED);
+    #else
+    m_refcnt++;
+    #endif
+}
+
+
+void MemAccount::release()
+{
+    ASSERT0(m_refcnt > 0);
+    #ifdef __GNUC__
+    if (__atomic_sub_fetch(&m_refcnt, 1, __ATOMIC_ACQ_REL) != 0) { return; }
+    #else
+    if (--m_refcnt != 0) { return; }
+    #endif
+    delete this;
+}
+//END MemAccount
+
+
+static inline void addStatMemSize(size_t size)
+{
+    #ifdef __GNUC__
+    __atomic_fetch_add(&g_stat_mem_size, (ULONGLONG)size, __ATOMIC_RELAXED);
+    #else
+    g_stat_mem_size += size;
+    #endif
+}
+
+
+void smpoolGetStat(SMemPool const* handler, OUT SMemPoolStat & stat)
+{
+    ::memset((void*)&stat, 0, sizeof(SMemPoolStat));
+    if (handler == nullptr) { return; }
+    stat.alloc_size = MEMPOOL_alloc_size(handler);
+    stat.reuse_size = MEMPOOL_reuse_size(handler);
+    stat.free_size = MEMPOOL_free_size(handler);
+    for (SMemPool const* p = handler; p != nullptr; p = MEMPOOL_next(p)) {
+        stat.chunk_num++;
+        stat.pool_size += MEMPOOL_pool_size(p);
+        stat.used_size += MEMPOOL_start_pos(p);
+    }
+}
+
+
 void dumpPool(SMemPool * handler, FILE * h)
 {
     if (h == nullptr) { return; }
+    SMemPoolStat stat;
+    smpoolGetStat(handler, stat);
+    fprintf(h, "\nMEMPOOL STAT:CHUNK:%u,USED:%lu(BYTE),ALLOC:%lu(BYTE),"
+            "REUSE:%lu(BYTE),FREE:%lu(BYTE),SYSTEM TOTAL:%llu(BYTE)",
+            (UINT)stat.chunk_num, (ULONG)stat.used_size,
+            (ULONG)stat.alloc_size, (ULONG)stat.reuse_size,
+            (ULONG)stat.free_size, (ULONGLONG)g_stat_mem_size);
     fprintf(h, "\nMEMPOOL TOTAL SIZE:%u(BYTE) ",
             (UINT)smpoolGetPoolSize(handler));
     while (handler != nullptr) {
@@ -94,25 +358,92 @@ static SMemPool * new_mem_pool(size_t size, MEMPOOLTYPE mpt)
         size_mp = (sizeof(SMemPool) / WORD_ALIGN + 1 ) * WORD_ALIGN;
     }
 
-    SMemPool * mp = (SMemPool*)malloc(size_mp + size + END_BOUND_BYTE);
-    ASSERTN(mp, ("create mem pool failed, no enough memory"));
+    size_t chunk_size = size_mp + size + END_BOUND_BYTE;
+    size_t grow_size = size;
+    UINT cls = Magazine::computeClass(chunk_size);
+    SMemPool * mp = nullptr;
+    if (cls != 0) {
+        chunk_size = Magazine::getClassByteSize(cls);
+        mp = (SMemPool*)g_magazine.get(cls);
+        if (mpt == MEM_COMM) {
+            //Common pool can make use of the rest space of chunk.
+            size = chunk_size - size_mp - END_BOUND_BYTE;
+        }
+    }
+    if (mp == nullptr) {
+        mp = (SMemPool*)malloc(chunk_size);
+        ASSERTN(mp, ("create mem pool failed, no enough memory"));
+        addStatMemSize(chunk_size); //Only for statistic purpose
+    }
+    g_thread_mem_size += chunk_size;
+    g_thread_mem_peak = MAX(g_thread_mem_peak, g_thread_mem_size);
+    addTotalMemSize((LONGLONG)chunk_size);
     ::memset((void*)mp, 0, size_mp);
     ::memset((void*)(((BYTE*)mp) + size_mp + size),
              BOUNDARY_NUM, END_BOUND_BYTE);
 
     MEMPOOL_type(mp) = mpt;
+    MEMPOOL_chunk_class(mp) = cls;
     #ifdef _DEBUG_
-    g_stat_mem_size += size_mp + size; //Only for statistic purpose
     MEMPOOL_chunk_id(mp) = ++g_mem_pool_chunk_count;
     #endif
     MEMPOOL_pool_ptr(mp) = ((BYTE*)mp) + size_mp;
     MEMPOOL_pool_size(mp) = size;
     MEMPOOL_start_pos(mp) = 0;
-    MEMPOOL_grow_size(mp) = size;
+    MEMPOOL_grow_size(mp) = grow_size;
     return mp;
 }
 
 
+//Return the byte size of memory that chunk occupied.
+static size_t get_chunk_byte_size(SMemPool const* mp)
+{
+    UINT cls = MEMPOOL_chunk_class(mp);
+    if (cls != 0) { return Magazine::getClassByteSize(cls); }
+    return (BYTE*)MEMPOOL_pool_ptr(mp) - (BYTE*)mp +
+           MEMPOOL_pool_size(mp) + END_BOUND_BYTE;
+}
+
+
+//Return chunk to magazine of current thread or system.
+static void free_chunk(SMemPool * mp)
+{
+    ASSERT0(mp);
+    if (MEMPOOL_free_list(mp) != nullptr) {
+        ::free(MEMPOOL_free_list(mp));
+        MEMPOOL_free_list(mp) = nullptr;
+    }
+    UINT cls = MEMPOOL_chunk_class(mp);
+    size_t chunk_size = get_chunk_byte_size(mp);
+    g_thread_mem_size -= chunk_size;
+    addTotalMemSize(-(LONGLONG)chunk_size);
+    if (cls != 0 && g_magazine.put(cls, (void*)mp)) {
+        return;
+    }
+    ::free(mp);
+}
+
+
+//Pick up a block from free list of size class.
+//Return nullptr if there is no available block.
+static inline void * pop_free_block(SMemPool * handler, size_t size)
+{
+    ASSERT0(MEMPOOL_free_list(handler));
+    size_t c = (size + SMP_SIZE_CLASS_ALIGN - 1) / SMP_SIZE_CLASS_ALIGN;
+    if (c == 0 || c > SMP_SIZE_CLASS_NUM) { return nullptr; }
+    void ** head = &MEMPOOL_free_list(handler)[c - 1];
+    void * addr = *head;
+    if (addr == nullptr) { return nullptr; }
+    //Block may not be aligned, the link is read byte by byte.
+    ::memcpy((void*)head, addr, sizeof(void*));
+    size_t bytesize = c * SMP_SIZE_CLASS_ALIGN;
+    MEMPOOL_reuse_size(handler) += bytesize;
+    ASSERT0(MEMPOOL_free_size(handler) >= bytesize);
+    MEMPOOL_free_size(handler) -= bytesize;
+    return addr;
+}
+
+
 inline static void remove_smp(SMemPool * t)
 {
     if (t == nullptr) return;
@@ -292,7 +623,7 @@ INT smpoolDelete(SMemPool * handler)
     while (tmp != nullptr) {
         SMemPool * d_tmp = tmp;
         tmp = MEMPOOL_next(tmp);
-        free(d_tmp);
+        free_chunk(d_tmp);
     }
     return ST_SUCC;
 }
@@ -373,6 +704,12 @@ void * smpoolMallocConstSize(size_t elem_size, IN SMemPool * handler)
             (MEMPOOL_pool_size(handler) % elem_size) == 0,
             ("pool size must be multiples of element size."));
 
+    MEMPOOL_alloc_size(handler) += elem_size;
+    if (MEMPOOL_free_list(handler) != nullptr) {
+        void * addr = pop_free_block(handler, elem_size);
+        if (addr != nullptr) { return addr; }
+    }
+
     //Search free block in the pool.
     ASSERTN(MEMPOOL_pool_size(handler) >= MEMPOOL_start_pos(handler),
             ("start_pos overflow the pool size"));
@@ -434,6 +771,12 @@ void * smpoolMalloc(size_t size, IN SMemPool * handler, size_t grow_size)
         size = (size / WORD_ALIGN + 1) * WORD_ALIGN;
     }
 
+    MEMPOOL_alloc_size(handler) += size;
+    if (MEMPOOL_free_list(handler) != nullptr) {
+        void * addr = pop_free_block(handler, size);
+        if (addr != nullptr) { return addr; }
+    }
+
     //Search free block in the pool.
     void * addr = nullptr;
     SMemPool * tmp_rest = handler, * last = nullptr;
@@ -491,6 +834,88 @@ FIN:
 }
 
 
+//Return memory block to pool to be reused by smpoolMalloc().
+//The block is linked into the free list of the greatest size class that
+//the block can hold. Blocks that can not hold a link are discarded.
+void smpoolFree(void * addr, size_t size, IN SMemPool * handler)
+{
+    ASSERTN(handler, ("mempool handler is null"));
+    if (addr == nullptr) { return; }
+    size_t c = size / SMP_SIZE_CLASS_ALIGN;
+    if (c == 0 || size < sizeof(void*)) { return; }
+    c = MIN(c, SMP_SIZE_CLASS_NUM);
+    if (MEMPOOL_free_list(handler) == nullptr) {
+        size_t bytesize = sizeof(void*) * SMP_SIZE_CLASS_NUM;
+        MEMPOOL_free_list(handler) = (void**)::malloc(bytesize);
+        ASSERTN(MEMPOOL_free_list(handler), ("no enough memory"));
+        ::memset((void*)MEMPOOL_free_list(handler), 0, bytesize);
+    }
+    void ** head = &MEMPOOL_free_list(handler)[c - 1];
+    //Block may not be aligned, the link is written byte by byte.
+    ::memcpy(addr, (void const*)head, sizeof(void*));
+    *head = addr;
+    MEMPOOL_free_size(handler) += c * SMP_SIZE_CLASS_ALIGN;
+}
+
+
+//Record current allocation position of pool, and return the checkpoint.
+SMemPoolMark const* smpoolMark(IN SMemPool * handler)
+{
+    ASSERTN(handler, ("mempool handler is null"));
+    ASSERTN(MEMPOOL_type(handler) == MEM_COMM, ("need common pool"));
+    size_t n = 0;
+    for (SMemPool * p = handler; p != nullptr; p = MEMPOOL_next(p)) {
+        n++;
+    }
+    //Allocating checkpoint may create a new chunk.
+    n++;
+    SMemPoolMark * mark = (SMemPoolMark*)smpoolMalloc(
+        sizeof(SMemPoolMark) + sizeof(SMemPoolMarkElem) * (n - 1), handler);
+    ASSERT0(mark);
+    size_t i = 0;
+    for (SMemPool * p = handler; p != nullptr; p = MEMPOOL_next(p), i++) {
+        ASSERT0(i < n);
+        mark->elem[i].chunk = p;
+        mark->elem[i].start_pos = MEMPOOL_start_pos(p);
+    }
+    mark->chunk_num = i;
+    mark->grow_size = MEMPOOL_grow_size(handler);
+    return mark;
+}
+
+
+//Discard all memory allocated after checkpoint 'mark'.
+void smpoolRelease(IN SMemPool * handler, SMemPoolMark const* mark)
+{
+    ASSERTN(handler && mark, ("mempool handler is null"));
+    ASSERTN(MEMPOOL_type(handler) == MEM_COMM, ("need common pool"));
+    SMemPool * next = nullptr;
+    for (SMemPool * p = handler; p != nullptr; p = next) {
+        next = MEMPOOL_next(p);
+        size_t i = 0;
+        for (; i < mark->chunk_num && mark->elem[i].chunk != p; i++) {}
+        if (i < mark->chunk_num) {
+            ASSERTN(MEMPOOL_start_pos(p) >= mark->elem[i].start_pos,
+                    ("checkpoint has been released"));
+            MEMPOOL_start_pos(p) = mark->elem[i].start_pos;
+            continue;
+        }
+        //The chunk is created after checkpoint.
+        ASSERTN(p != handler, ("checkpoint does not belong to the pool"));
+        remove_smp(p);
+        free_chunk(p);
+    }
+    MEMPOOL_grow_size(handler) = mark->grow_size;
+
+    //Blocks in free list may be allocated after checkpoint.
+    if (MEMPOOL_free_list(handler) != nullptr) {
+        ::memset((void*)MEMPOOL_free_list(handler), 0,
+                 sizeof(void*) * SMP_SIZE_CLASS_NUM);
+    }
+    MEMPOOL_free_size(handler) = 0;
+}
+
+
 //Quering memory space from pool via pool index.
 void * smpoolMallocViaPoolIndex(size_t size, MEMPOOLIDX mpt_idx,
                                 size_t grow_size)
@@ -63,10 +63,21 @@ typedef enum {
 #define MEMPOOL_start_pos(p) ((p)->start_pos)
 #define MEMPOOL_pool_size(p) ((p)->mem_pool_size)
 #define MEMPOOL_pool_ptr(p) ((p)->ppool)
+#define MEMPOOL_chunk_class(p) ((p)->chunk_class)
+#define MEMPOOL_free_list(p) ((p)->free_list)
+#define MEMPOOL_alloc_size(p) ((p)->alloc_size)
+#define MEMPOOL_reuse_size(p) ((p)->reuse_size)
+#define MEMPOOL_free_size(p) ((p)->free_size)
 #ifdef _DEBUG_
 #define MEMPOOL_chunk_id(p) ((p)->chunk_id)
 #endif
 
+//The granularity and the number of size classes.
+//Blocks returned by smpoolFree() are linked into free list of its size
+//class, and reused by smpoolMalloc() with the same size class.
+#define SMP_SIZE_CLASS_ALIGN 8
+#define SMP_SIZE_CLASS_NUM 32
+
 typedef struct _MemPool {
     MEMPOOLTYPE pool_type;
     struct _MemPool * next;
@@ -77,11 +88,44 @@ typedef struct _MemPool {
     size_t grow_size;
     void * ppool; //start address of mem pool
 
+    //Record the class of chunk in per-thread magazine, 0 means the chunk
+    //is allocated from system directly.
+    UINT chunk_class;
+
+    //The following fields are only available in the first chunk.
+    void ** free_list; //free lists of size classes, allocated on demand.
+    size_t alloc_size; //the accumulated byte size requested by user.
+    size_t reuse_size; //the accumulated byte size served by free list.
+    size_t free_size; //the byte size of blocks in free list.
+
     #ifdef _DEBUG_
     ULONG chunk_id;
     #endif
 } SMemPool;
 
+//Statistics of memory pool.
+typedef struct _MemPoolStat {
+    size_t chunk_num; //the number of chunks.
+    size_t pool_size; //the byte size of all chunks.
+    size_t used_size; //the byte size has been allocated in chunks.
+    size_t alloc_size; //the accumulated byte size requested by user.
+    size_t reuse_size; //the accumulated byte size served by free list.
+    size_t free_size; //the byte size of blocks in free list.
+} SMemPoolStat;
+
+typedef struct _MemPoolMarkElem {
+    SMemPool * chunk;
+    size_t start_pos;
+} SMemPoolMarkElem;
+
+//Checkpoint of memory pool, it records the allocation position of each
+//chunk. The checkpoint itself is allocated in the pool.
+typedef struct _MemPoolMark {
+    size_t grow_size;
+    size_t chunk_num;
+    SMemPoolMarkElem elem[1]; //there are 'chunk_num' elements.
+} SMemPoolMark;
+
 //Create memory pool
 //size: the initial byte size of pool. For MEM_CONST_SIZE, 'size'
 //      must be integer multiples of element byte size.
@@ -99,6 +143,100 @@ void * smpoolMallocViaPoolIndex(size_t size, MEMPOOLIDX mpt_idx,
 void * smpoolMalloc(size_t size, SMemPool * handle, size_t grow_size = 0);
 void * smpoolMallocConstSize(size_t elem_size, IN SMemPool * handler);
 
+//Return memory block to pool to be reused by smpoolMalloc().
+//The block must be allocated from 'handler' by smpoolMalloc(), and 'size'
+//must not be greater than the size of block.
+void smpoolFree(void * addr, size_t size, IN SMemPool * handler);
+
+//Record current allocation position of pool, and return the checkpoint.
+//Only MEM_COMM pool supports checkpoint.
+SMemPoolMark const* smpoolMark(IN SMemPool * handler);
+
+//Discard all memory allocated after checkpoint 'mark', chunks created
+//after the checkpoint are returned to system.
+//Note the free lists of size classes are cleaned.
+void smpoolRelease(IN SMemPool * handler, SMemPoolMark const* mark);
+
+//Compute statistics of given pool.
+void smpoolGetStat(SMemPool const* handler, OUT SMemPoolStat & stat);
+
+//Return the byte size of chunks that are held by pools and allocated in
+//current thread. Memory that is allocated out of pools, e.g: IR arena
+//chunk, is included if it is accounted by smpoolAddThreadMemSize().
+LONGLONG smpoolGetThreadMemSize();
+
+//Account 'size' bytes of memory that is allocated out of pools into the
+//thread memory size. 'size' is negative if memory is freed.
+void smpoolAddThreadMemSize(LONGLONG size);
+
+//Return the peak of smpoolGetThreadMemSize() in current thread.
+LONGLONG smpoolGetThreadMemPeak();
+
+//The class records the byte size of memory that is allocated out of pools
+//on behalf of an owner, e.g: the buffers of BitSet that are allocated while
+//a region is being processed.
+//The account is referenced by the owner and by each buffer attributed to
+//it. Thus a buffer can be freed by any thread and still be subtracted from
+//its owner, and the account lives until the last reference is dropped.
+class MemAccount {
+    COPY_CONSTRUCTOR(MemAccount);
+    LONGLONG m_size;
+    UINT m_refcnt;
+protected:
+    MemAccount() : m_size(0), m_refcnt(1) {}
+    ~MemAccount() {}
+public:
+    //Create an account that is referenced by the caller.
+    static MemAccount * create() { return new MemAccount(); }
+
+    //Add 'size' bytes to the account, 'size' is negative if memory is freed.
+    //The counter is updated atomically.
+    void addSize(LONGLONG size);
+
+    LONGLONG getSize() const;
+
+    //Add a reference to the account.
+    void hold();
+
+    //Drop a reference, the account is deleted if no one references it.
+    void release();
+};
+
+//Set the account that out-of-pool memory allocated by current thread is
+//attributed to, e.g: buffer of BitSet. nullptr means the memory is
+//accounted into the thread memory size.
+void smpoolSetThreadMemAccount(MemAccount * account);
+
+//Return the account that set by smpoolSetThreadMemAccount().
+MemAccount * smpoolGetThreadMemAccount();
+
+//Set the peak of thread memory size, the function is used to measure the
+//high-water mark of a period, e.g: a pass.
+void smpoolSetThreadMemPeak(LONGLONG peak);
+
+//Enable or disable the accounting of total memory size of all threads.
+//The accounting is disabled by default since the counters are shared by all
+//threads. Note the total size only covers the memory that allocated and
+//freed while the accounting is enabled, thus enable it before the period
+//to be measured, and measure the difference of the size.
+void smpoolEnableTotalMemAccounting(bool enable);
+
+//Return true if the accounting of total memory size is enabled.
+bool smpoolIsTotalMemAccounting();
+
+//Return the byte size of chunks that are held by pools of all threads,
+//the accounted memory out of pools is included as well.
+//The size is updated only if smpoolEnableTotalMemAccounting(true).
+LONGLONG smpoolGetTotalMemSize();
+
+//Return the peak of smpoolGetTotalMemSize().
+LONGLONG smpoolGetTotalMemPeak();
+
+//Reset the peak of total memory size to current size, the function is
+//used to measure the high-water mark of a period, e.g: processing of
+//program region by multiple threads.
+void smpoolResetTotalMemPeak();
+
 //Get whole pool size with byte
 size_t smpoolGetPoolSizeViaIndex(MEMPOOLIDX mpt_idx);
 size_t smpoolGetPoolSize(SMemPool const* handle);
@@ -119,8 +257,26 @@ void smpoolFiniPool(); //Finializing pool
 
 void dumpPool(SMemPool * handler, FILE * h);
 
+//Record the byte size of memory that all pools requested from system.
+//The counter is updated atomically.
 extern ULONGLONG g_stat_mem_size;
 
+
+//The class discards all memory allocated in pool during the lifetime of
+//object, e.g: a pass can discard all its temporaries at once.
+class SMemPoolScope {
+    COPY_CONSTRUCTOR(SMemPoolScope);
+    SMemPool * m_pool;
+    SMemPoolMark const* m_mark;
+public:
+    SMemPoolScope(SMemPool * pool)
+    {
+        m_pool = pool;
+        m_mark = smpoolMark(pool);
+    }
+    ~SMemPoolScope() { smpoolRelease(m_pool, m_mark); }
+};
+
 } //namespace xcom
 
 #endif
@@ -5289,6 +5289,512 @@ public:
 };
 //END MAP
 
+//
+//START OAHash
+//
+//Open Addressing Hash
+//
+//The hash table resolves collision by Robin Hood hashing with linear
+//probing. Elements are stored in a dense array in the order of insertion,
+//and each probe slot only records the position of element in the array and
+//the hash value of element. Thus probing walks through small contiguous
+//slots rather than chained containers, and iterating elements is as fast as
+//iterating an array.
+//The table grows automatically when the load factor exceeds
+//OAHASH_MAX_LOAD_FACTOR, and removing element shifts the following slots
+//backward, thus there is no tombstone.
+//
+//NOTE:
+//    1.T(0) is defined as default nullptr in OAHash, so do not use T(0)
+//      as element.
+//    2.The hash function class is compatible with Hash, but the bucket size
+//      passed to get_hash_value() is always power of 2, e.g: HashFuncBase2.
+//        * Return hash-key deduced from 't'.
+//            UINT get_hash_value(T t, UINT bucket_size) const
+//        * Compare t1, t2.
+//            bool compare(T t1, T t2) const
+//    3.Elements are copied by memory copy, do not use the type that has
+//      non-trivial copy constructor as element.
+//    4.Removing element moves the last element into the position of the
+//      removed one, thus the iterating order may differ from the order of
+//      insertion after removing.
+#define OAHASH_MIN_BUCKET 8
+
+//The table grows when the number of element exceeds 3/4 of bucket size.
+#define OAHASH_MAX_LOAD_FACTOR(bucket_size) ((bucket_size) / 4 * 3)
+
+//'pos' records the position of element in dense array, start from 1,
+//0 indicates an empty slot.
+//'home' records the hash value of element.
+class OAHashSlot {
+public:
+    UINT pos;
+    UINT home;
+};
+
+
+template <class T, class HF = HashFuncBase2<T> > class OAHash {
+    COPY_CONSTRUCTOR(OAHash);
+protected:
+    UINT m_elem_count;
+    UINT m_bucket_size; //always be power of 2.
+    UINT m_elem_capacity;
+    OAHashSlot * m_slot;
+    T * m_elem; //dense array of elements.
+    HF m_hf;
+protected:
+    //Return the probe distance of 'slot' that placed at 'idx'.
+    UINT getDist(UINT idx, OAHashSlot const& slot) const
+    { return (idx - slot.home) & (m_bucket_size - 1); }
+
+    UINT getHome(T t) const
+    {
+        UINT home = m_hf.get_hash_value(t, m_bucket_size);
+        ASSERTN(home < m_bucket_size,
+                ("hash value must less than bucket size"));
+        return home;
+    }
+
+    //Return the slot index of 't', or m_bucket_size if not found.
+    UINT findSlot(T t) const
+    {
+        if (m_elem_count == 0) { return m_bucket_size; }
+        UINT const mask = m_bucket_size - 1;
+        UINT const home = getHome(t);
+        for (UINT i = home, dist = 0;; i = (i + 1) & mask, dist++) {
+            OAHashSlot const& s = m_slot[i];
+            if (s.pos == 0 || getDist(i, s) < dist) {
+                //Robin Hood invariant: 't' should have been placed before
+                //the slot that is closer to its home.
+                return m_bucket_size;
+            }
+            if (s.home == home && m_hf.compare(m_elem[s.pos - 1], t)) {
+                return i;
+            }
+        }
+        UNREACHABLE();
+        return m_bucket_size;
+    }
+
+    //Return the slot index that refers to element at 'pos'.
+    UINT findSlotByPos(UINT pos) const
+    {
+        UINT const mask = m_bucket_size - 1;
+        for (UINT i = getHome(m_elem[pos]);; i = (i + 1) & mask) {
+            if (m_slot[i].pos == pos + 1) { return i; }
+            ASSERTN(m_slot[i].pos != 0, ("element is not in table"));
+        }
+        UNREACHABLE();
+        return m_bucket_size;
+    }
+
+    //Place slot into table, the element must not be in table.
+    void insertSlot(OAHashSlot slot)
+    {
+        UINT const mask = m_bucket_size - 1;
+        for (UINT i = slot.home, dist = 0;; i = (i + 1) & mask, dist++) {
+            OAHashSlot & s = m_slot[i];
+            if (s.pos == 0) {
+                s = slot;
+                return;
+            }
+            UINT sdist = getDist(i, s);
+            if (sdist < dist) {
+                //Rob the slot from the richer one, and continue to place
+                //the poorer one.
+                OAHashSlot tmp = s;
+                s = slot;
+                slot = tmp;
+                dist = sdist;
+            }
+        }
+    }
+
+    //Remove the slot at 'idx' by shifting the following slots backward.
+    void removeSlot(UINT idx)
+    {
+        UINT const mask = m_bucket_size - 1;
+        for (;;) {
+            UINT next = (idx + 1) & mask;
+            OAHashSlot const& s = m_slot[next];
+            if (s.pos == 0 || getDist(next, s) == 0) {
+                m_slot[idx].pos = 0;
+                return;
+            }
+            m_slot[idx] = s;
+            idx = next;
+        }
+    }
+
+    void rehash(UINT bsize)
+    {
+        ASSERT0(isPowerOf2(bsize) && bsize >= OAHASH_MIN_BUCKET);
+        if (m_slot != nullptr) { ::free(m_slot); }
+        m_bucket_size = bsize;
+        m_slot = (OAHashSlot*)::malloc(sizeof(OAHashSlot) * bsize);
+        ::memset((void*)m_slot, 0, sizeof(OAHashSlot) * bsize);
+        for (UINT i = 0; i < m_elem_count; i++) {
+            OAHashSlot slot;
+            slot.pos = i + 1;
+            slot.home = getHome(m_elem[i]);
+            insertSlot(slot);
+        }
+    }
+
+    //Enlarge the capacity of dense array to 'cap'.
+    virtual void reserveElem(UINT cap)
+    {
+        ASSERT0(cap > m_elem_capacity);
+        m_elem = (T*)::realloc((void*)m_elem, sizeof(T) * cap);
+        m_elem_capacity = cap;
+    }
+
+    //Move the element at 'from' to 'to' in dense array.
+    virtual void moveElem(UINT from, UINT to) { m_elem[to] = m_elem[from]; }
+
+    //Append 't' into table.
+    //Return the position of element in dense array.
+    //find: set to true if 't' already exist.
+    UINT appendImpl(T t, OUT bool & find)
+    {
+        ASSERTN(t != T(0), ("Do NOT append 0 to table"));
+        UINT idx = findSlot(t);
+        if (idx != m_bucket_size) {
+            find = true;
+            return m_slot[idx].pos - 1;
+        }
+        find = false;
+        if (m_elem_count + 1 > OAHASH_MAX_LOAD_FACTOR(m_bucket_size)) {
+            rehash(m_bucket_size == 0 ?
+                   OAHASH_MIN_BUCKET : m_bucket_size * 2);
+        }
+        if (m_elem_count == m_elem_capacity) {
+            reserveElem(m_elem_capacity == 0 ? 4 : m_elem_capacity * 2);
+        }
+        UINT pos = m_elem_count++;
+        m_elem[pos] = t;
+        OAHashSlot slot;
+        slot.pos = pos + 1;
+        slot.home = getHome(t);
+        insertSlot(slot);
+        return pos;
+    }
+
+    //Remove 't' from table.
+    //Return the position of removed element in dense array, or
+    //m_elem_count if 't' is not in table.
+    UINT removeImpl(T t, OUT T * removed)
+    {
+        UINT idx = findSlot(t);
+        if (idx == m_bucket_size) { return m_elem_count; }
+        UINT pos = m_slot[idx].pos - 1;
+        if (removed != nullptr) { *removed = m_elem[pos]; }
+        removeSlot(idx);
+        UINT last = m_elem_count - 1;
+        if (pos != last) {
+            //Fill the hole with the last element to keep array dense.
+            m_slot[findSlotByPos(last)].pos = pos + 1;
+            moveElem(last, pos);
+        }
+        m_elem_count--;
+        return pos;
+    }
+public:
+    OAHash(UINT bsize = 0)
+    {
+        m_elem_count = 0;
+        m_bucket_size = 0;
+        m_elem_capacity = 0;
+        m_slot = nullptr;
+        m_elem = nullptr;
+        init(bsize);
+    }
+    virtual ~OAHash() { destroy(); }
+
+    //Append 't' into hash table.
+    //If 't' already exists, return the element in table immediately.
+    //find: set to true if 't' already exist.
+    //NOTE: Do NOT append 0 to table.
+    T append(T t, bool * find = nullptr)
+    {
+        bool f = false;
+        UINT pos = appendImpl(t, f);
+        if (find != nullptr) { *find = f; }
+        return m_elem[pos];
+    }
+
+    //Count up the memory which hash table occupied.
+    size_t count_mem() const
+    {
+        return sizeof(*this) + sizeof(OAHashSlot) * m_bucket_size +
+               sizeof(T) * m_elem_capacity;
+    }
+
+    //Clean the data structure but not destroy.
+    void clean()
+    {
+        if (m_elem_count == 0) { return; }
+        ::memset((void*)m_slot, 0, sizeof(OAHashSlot) * m_bucket_size);
+        m_elem_count = 0;
+    }
+
+    //Free all memory objects.
+    void destroy()
+    {
+        if (m_slot != nullptr) {
+            ::free(m_slot);
+            m_slot = nullptr;
+        }
+        if (m_elem != nullptr) {
+            ::free(m_elem);
+            m_elem = nullptr;
+        }
+        m_elem_count = 0;
+        m_bucket_size = 0;
+        m_elem_capacity = 0;
+    }
+
+    //Return true if 't' is in table.
+    bool find(T t) const
+    {
+        if (t == T(0)) { return false; }
+        return findSlot(t) != m_bucket_size;
+    }
+
+    //Find 't' and output the element recorded in table.
+    //Note t may be different with the return one.
+    //ot: output the element if found it.
+    bool find(T t, OUT T * ot) const
+    {
+        if (t == T(0)) { return false; }
+        UINT idx = findSlot(t);
+        if (idx == m_bucket_size) { return false; }
+        ASSERT0(ot);
+        *ot = m_elem[m_slot[idx].pos - 1];
+        return true;
+    }
+
+    //Get the hash bucket size.
+    UINT get_bucket_size() const { return m_bucket_size; }
+
+    //Get the number of element in hash table.
+    UINT get_elem_count() const { return m_elem_count; }
+
+    //The function return the first element if it exists, and initialize
+    //the iterator, otherwise return T(0).
+    T get_first(VecIdx & iter) const
+    {
+        if (m_elem_count == 0) {
+            iter = VEC_UNDEF;
+            return T(0);
+        }
+        iter = 0;
+        return m_elem[0];
+    }
+
+    //The function return the next element of given iterator.
+    //If it exists, record its index at 'iter' and return the element,
+    //otherwise set 'iter' to VEC_UNDEF, and return T(0).
+    T get_next(VecIdx & iter) const
+    {
+        ASSERT0(iter != VEC_UNDEF);
+        if ((UINT)(iter + 1) >= m_elem_count) {
+            iter = VEC_UNDEF;
+            return T(0);
+        }
+        iter++;
+        return m_elem[iter];
+    }
+
+    //Initialize the table with expected bucket size.
+    //The table is also able to be initialized lazily at the first insertion.
+    void init(UINT bsize)
+    {
+        if (bsize == 0 || m_bucket_size != 0) { return; }
+        rehash(MAX(OAHASH_MIN_BUCKET, getNearestPowerOf2(bsize)));
+    }
+
+    //Return true if current hash initialized.
+    //The table is always able to be used.
+    bool is_init() const { return true; }
+
+    //The function remove one element, and return the removed one.
+    //Note that 't' may be different with the return one according to
+    //the behavior of user's defined HF class.
+    T remove(T t)
+    {
+        if (t == T(0)) { return T(0); }
+        T removed = T(0);
+        removeImpl(t, &removed);
+        return removed;
+    }
+};
+//END OAHash
+
+
+//
+//START OAHashMap
+//
+//Unidirectional Hashed Map based on OAHash.
+//
+//Tsrc: the type of keys maintained by this map.
+//Ttgt: the type of mapped values.
+//
+//NOTE:
+//    1.Tsrc(0) is defined as default nullptr in OAHashMap, so do
+//      not use T(0) as key.
+//    2.The map is an alternative of HMap, it grows automatically and
+//      provides compatible interfaces of the frequently used functions.
+template <class Tsrc, class Ttgt, class HF = HashFuncBase2<Tsrc> >
+class OAHashMap : public OAHash<Tsrc, HF> {
+    COPY_CONSTRUCTOR(OAHashMap);
+protected:
+    //Mapped values, it is parallel to the dense array of keys.
+    Ttgt * m_mapped;
+protected:
+    virtual void reserveElem(UINT cap)
+    {
+        m_mapped = (Ttgt*)::realloc((void*)m_mapped, sizeof(Ttgt) * cap);
+        OAHash<Tsrc, HF>::reserveElem(cap);
+    }
+
+    virtual void moveElem(UINT from, UINT to)
+    {
+        OAHash<Tsrc, HF>::moveElem(from, to);
+        m_mapped[to] = m_mapped[from];
+    }
+
+    //Return the position of 't' in dense array, or the number of
+    //elements if not found.
+    UINT findPos(Tsrc t) const
+    {
+        if (t == Tsrc(0)) { return OAHash<Tsrc, HF>::m_elem_count; }
+        UINT idx = OAHash<Tsrc, HF>::findSlot(t);
+        if (idx == OAHash<Tsrc, HF>::m_bucket_size) {
+            return OAHash<Tsrc, HF>::m_elem_count;
+        }
+        return OAHash<Tsrc, HF>::m_slot[idx].pos - 1;
+    }
+public:
+    OAHashMap(UINT bsize = 0) : OAHash<Tsrc, HF>(bsize) { m_mapped = nullptr; }
+    virtual ~OAHashMap() { destroy(); }
+
+    //Count memory usage for current object.
+    size_t count_mem() const
+    {
+        return OAHash<Tsrc, HF>::count_mem() +
+               sizeof(Ttgt) * OAHash<Tsrc, HF>::m_elem_capacity;
+    }
+
+    void destroy()
+    {
+        OAHash<Tsrc, HF>::destroy();
+        if (m_mapped != nullptr) {
+            ::free(m_mapped);
+            m_mapped = nullptr;
+        }
+    }
+
+    //Get mapped element of 't'.
+    //find: set to true if 't' is in the map.
+    Ttgt get(Tsrc t, bool * find = nullptr) const
+    {
+        UINT pos = findPos(t);
+        if (pos == OAHash<Tsrc, HF>::m_elem_count) {
+            if (find != nullptr) { *find = false; }
+            return Ttgt(0);
+        }
+        if (find != nullptr) { *find = true; }
+        return m_mapped[pos];
+    }
+
+    //The function iterate key and mapped element.
+    //Return the first key, and output the mapped element if 'mapped' is
+    //not nullptr.
+    Tsrc get_first(VecIdx & iter, Ttgt * mapped = nullptr) const
+    {
+        Tsrc t = OAHash<Tsrc, HF>::get_first(iter);
+        if (iter != VEC_UNDEF && mapped != nullptr) {
+            *mapped = m_mapped[iter];
+        }
+        return t;
+    }
+
+    //The function iterate key and mapped element.
+    //Return the next key, and output the mapped element if 'mapped' is
+    //not nullptr.
+    Tsrc get_next(VecIdx & iter, Ttgt * mapped = nullptr) const
+    {
+        Tsrc t = OAHash<Tsrc, HF>::get_next(iter);
+        if (iter != VEC_UNDEF && mapped != nullptr) {
+            *mapped = m_mapped[iter];
+        }
+        return t;
+    }
+
+    //The function iterate mapped elements.
+    //Note Ttgt(0) will be served as default nullptr.
+    Ttgt get_first_elem(VecIdx & pos) const
+    {
+        for (UINT i = 0; i < OAHash<Tsrc, HF>::m_elem_count; i++) {
+            if (m_mapped[i] != Ttgt(0)) {
+                pos = (VecIdx)i;
+                return m_mapped[i];
+            }
+        }
+        pos = VEC_UNDEF;
+        return Ttgt(0);
+    }
+
+    //The function iterate mapped elements.
+    //Note Ttgt(0) will be served as default nullptr.
+    Ttgt get_next_elem(VecIdx & pos) const
+    {
+        ASSERT0(pos != VEC_UNDEF);
+        for (UINT i = (UINT)pos + 1; i < OAHash<Tsrc, HF>::m_elem_count; i++) {
+            if (m_mapped[i] != Ttgt(0)) {
+                pos = (VecIdx)i;
+                return m_mapped[i];
+            }
+        }
+        pos = VEC_UNDEF;
+        return Ttgt(0);
+    }
+
+    void reinit() { destroy(); }
+
+    //Remove 't' and its mapped element.
+    //Return the mapped element of 't'.
+    Ttgt remove(Tsrc t)
+    {
+        UINT pos = findPos(t);
+        if (pos == OAHash<Tsrc, HF>::m_elem_count) { return Ttgt(0); }
+        Ttgt mapped = m_mapped[pos];
+        OAHash<Tsrc, HF>::removeImpl(t, nullptr);
+        return mapped;
+    }
+
+    //Establishing mapping in between 't' and 'mapped'.
+    void set(Tsrc t, Ttgt mapped)
+    {
+        if (t == Tsrc(0)) { return; }
+        bool find = false;
+        UINT pos = OAHash<Tsrc, HF>::appendImpl(t, find);
+        ASSERTN(!find || m_mapped[pos] == Ttgt(0), ("Already be mapped"));
+        m_mapped[pos] = mapped;
+    }
+
+    //Alway set new mapping even if it has done.
+    void setAlways(Tsrc t, Ttgt mapped)
+    {
+        if (t == Tsrc(0)) { return; }
+        bool find = false;
+        UINT pos = OAHash<Tsrc, HF>::appendImpl(t, find);
+        m_mapped[pos] = mapped;
+    }
+};
+//END OAHashMap
+
 
 //TMap Iterator based on Double Linked List.
 //The class is used to iterate elements in TMap.
@@ -17,6 +17,7 @@ using namespace xcom;
 #include "allocator.h"
 #include "comf.h" //used by sstl.h
 #include "sstl.h"
+#include "btree.h"
 #include "strbuf.h"
 #include "bs.h"
 #include "sbs.h"
@@ -48,5 +49,6 @@ using namespace xcom;
 #include "assemblebin.h"
 #include "log.h"
 #include "int_hash.h"
+#include "xthread.h"
 #endif
 
@@ -0,0 +1,231 @@
+/*@
+Copyright (c) 2013-2021, Su Zhenyu steven.known@gmail.com
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Su Zhenyu nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+@*/
+//NOTE: Host thread library has to be included before xcominc.h, because
+//xcom may redefine some C++11 keywords.
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include "xcominc.h"
+
+namespace xcom {
+
+//
+//START Mutex
+//
+Mutex::Mutex()
+{
+    m_is_enable = false;
+    m_impl = (void*)new std::recursive_mutex();
+}
+
+
+Mutex::~Mutex()
+{
+    delete (std::recursive_mutex*)m_impl;
+    m_impl = nullptr;
+}
+
+
+void Mutex::lockImpl()
+{
+    ASSERT0(m_impl);
+    ((std::recursive_mutex*)m_impl)->lock();
+}
+
+
+void Mutex::unlockImpl()
+{
+    ASSERT0(m_impl);
+    ((std::recursive_mutex*)m_impl)->unlock();
+}
+//END Mutex
+
+
+//
+//START RWLock
+//
+class RWLockImpl {
+public:
+    //The number of readers if it is not less than 0, or -1 if the lock is
+    //held by a writer.
+    std::atomic<INT> state;
+
+    //Record the thread that holds the write lock.
+    std::atomic<std::thread::id> owner;
+
+    //The number of times that the owner acquired the write lock.
+    UINT depth;
+public:
+    RWLockImpl() : state(0), owner(std::thread::id()), depth(0) {}
+    bool isOwnedByMe() const
+    { return owner.load() == std::this_thread::get_id(); }
+};
+
+
+RWLock::RWLock()
+{
+    m_is_enable = false;
+    m_impl = (void*)new RWLockImpl();
+}
+
+
+RWLock::~RWLock()
+{
+    delete (RWLockImpl*)m_impl;
+    m_impl = nullptr;
+}
+
+
+void RWLock::lockReadImpl()
+{
+    RWLockImpl * l = (RWLockImpl*)m_impl;
+    ASSERT0(l);
+    if (l->isOwnedByMe()) {
+        //The writer reads the data it is guarding.
+        return;
+    }
+    for (;;) {
+        INT s = l->state.load();
+        if (s >= 0 && l->state.compare_exchange_weak(s, s + 1)) { return; }
+        std::this_thread::yield();
+    }
+}
+
+
+void RWLock::unlockReadImpl()
+{
+    RWLockImpl * l = (RWLockImpl*)m_impl;
+    ASSERT0(l);
+    if (l->isOwnedByMe()) { return; }
+    ASSERT0(l->state.load() > 0);
+    l->state.fetch_sub(1);
+}
+
+
+void RWLock::lockWriteImpl()
+{
+    RWLockImpl * l = (RWLockImpl*)m_impl;
+    ASSERT0(l);
+    if (l->isOwnedByMe()) {
+        l->depth++;
+        return;
+    }
+    for (;;) {
+        INT s = 0;
+        if (l->state.compare_exchange_weak(s, -1)) { break; }
+        std::this_thread::yield();
+    }
+    l->owner.store(std::this_thread::get_id());
+    l->depth = 1;
+}
+
+
+void RWLock::unlockWriteImpl()
+{
+    RWLockImpl * l = (RWLockImpl*)m_impl;
+    ASSERT0(l && l->isOwnedByMe() && l->depth > 0);
+    l->depth--;
+    if (l->depth != 0) { return; }
+    l->owner.store(std::thread::id());
+    l->state.store(0);
+}
+//END RWLock
+
+
+//Record the index of worker thread.
+static thread_local UINT g_thread_idx = 0;
+
+UINT getThreadIdx()
+{
+    return g_thread_idx;
+}
+
+
+UINT getHostThreadNum()
+{
+    UINT n = (UINT)std::thread::hardware_concurrency();
+    return n == 0 ? 1 : n;
+}
+
+
+class WorkerCtx {
+public:
+    std::atomic<UINT> next_task;
+    std::atomic<bool> is_succ;
+    UINT task_num;
+    ParallelJob * job;
+};
+
+
+static void runWorker(WorkerCtx * ctx, UINT thread_idx)
+{
+    g_thread_idx = thread_idx;
+    while (ctx->is_succ.load()) {
+        UINT task_idx = ctx->next_task.fetch_add(1);
+        if (task_idx >= ctx->task_num) { return; }
+        if (!ctx->job->runTask(task_idx, thread_idx)) {
+            ctx->is_succ.store(false);
+            return;
+        }
+    }
+}
+
+
+bool runParallelJob(UINT thread_num, UINT task_num, ParallelJob & job)
+{
+    if (thread_num > task_num) { thread_num = task_num; }
+    if (thread_num <= 1) {
+        for (UINT i = 0; i < task_num; i++) {
+            if (!job.runTask(i, 0)) { return false; }
+        }
+        return true;
+    }
+    WorkerCtx ctx;
+    ctx.next_task.store(0);
+    ctx.is_succ.store(true);
+    ctx.task_num = task_num;
+    ctx.job = &job;
+
+    //Current thread also acts as a worker, thus only 'thread_num - 1'
+    //threads need to be created.
+    std::thread ** workers = new std::thread*[thread_num - 1];
+    for (UINT i = 0; i < thread_num - 1; i++) {
+        workers[i] = new std::thread(runWorker, &ctx, i + 1);
+    }
+    UINT org_idx = g_thread_idx;
+    runWorker(&ctx, 0);
+    g_thread_idx = org_idx;
+    for (UINT i = 0; i < thread_num - 1; i++) {
+        workers[i]->join();
+        delete workers[i];
+    }
+    delete [] workers;
+    return ctx.is_succ.load();
+}
+
+} //namespace xcom
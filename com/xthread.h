@@ -0,0 +1,164 @@
+/*@
+Copyright (c) 2013-2021, Su Zhenyu steven.known@gmail.com
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Su Zhenyu nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+@*/
+#ifndef _XTHREAD_H_
+#define _XTHREAD_H_
+
+namespace xcom {
+
+//The class represents a recursive mutual exclusion lock.
+//The lock is disabled by default, and lock()/unlock() do nothing until
+//user enables it. This avoids the synchronization cost when there is only
+//one thread operating the protected data.
+//NOTE: user has to guarantee that the lock is enabled or disabled while
+//no thread is holding it.
+class Mutex {
+    COPY_CONSTRUCTOR(Mutex);
+    bool m_is_enable;
+    void * m_impl; //record the host mutex object.
+protected:
+    void lockImpl();
+    void unlockImpl();
+public:
+    Mutex();
+    ~Mutex();
+
+    //Enable or disable the lock.
+    void enable(bool doit) { m_is_enable = doit; }
+
+    bool is_enable() const { return m_is_enable; }
+
+    void lock() { if (m_is_enable) { lockImpl(); } }
+    void unlock() { if (m_is_enable) { unlockImpl(); } }
+};
+
+
+//The class locks the given Mutex when it is constructed, and unlocks the
+//Mutex when it is destructed.
+class AutoLock {
+    COPY_CONSTRUCTOR(AutoLock);
+    Mutex * m_mutex;
+public:
+    //mutex: the lock to be held, it can be NULL.
+    AutoLock(Mutex * mutex) : m_mutex(mutex)
+    { if (m_mutex != nullptr) { m_mutex->lock(); } }
+    ~AutoLock() { if (m_mutex != nullptr) { m_mutex->unlock(); } }
+};
+
+
+//The class represents a read-write lock that permits multiple readers or
+//one writer to hold it.
+//The lock is disabled by default, the same as Mutex.
+//The lock prefers readers, thus a thread holding the read lock can acquire
+//it again. A thread holding the write lock can acquire both the write lock
+//and the read lock again. However, a thread holding the read lock must not
+//acquire the write lock, otherwise it will be deadlocked.
+//NOTE: user has to guarantee that the lock is enabled or disabled while
+//no thread is holding it.
+class RWLock {
+    COPY_CONSTRUCTOR(RWLock);
+    bool m_is_enable;
+    void * m_impl; //record the host lock object.
+protected:
+    void lockReadImpl();
+    void unlockReadImpl();
+    void lockWriteImpl();
+    void unlockWriteImpl();
+public:
+    RWLock();
+    ~RWLock();
+
+    //Enable or disable the lock.
+    void enable(bool doit) { m_is_enable = doit; }
+
+    bool is_enable() const { return m_is_enable; }
+
+    void lockRead() { if (m_is_enable) { lockReadImpl(); } }
+    void unlockRead() { if (m_is_enable) { unlockReadImpl(); } }
+    void lockWrite() { if (m_is_enable) { lockWriteImpl(); } }
+    void unlockWrite() { if (m_is_enable) { unlockWriteImpl(); } }
+};
+
+
+//The class holds the read lock of given RWLock in its lifetime.
+class AutoReadLock {
+    COPY_CONSTRUCTOR(AutoReadLock);
+    RWLock * m_lock;
+public:
+    //lock: the lock to be held, it can be NULL.
+    AutoReadLock(RWLock * lock) : m_lock(lock)
+    { if (m_lock != nullptr) { m_lock->lockRead(); } }
+    ~AutoReadLock() { if (m_lock != nullptr) { m_lock->unlockRead(); } }
+};
+
+
+//The class holds the write lock of given RWLock in its lifetime.
+class AutoWriteLock {
+    COPY_CONSTRUCTOR(AutoWriteLock);
+    RWLock * m_lock;
+public:
+    //lock: the lock to be held, it can be NULL.
+    AutoWriteLock(RWLock * lock) : m_lock(lock)
+    { if (m_lock != nullptr) { m_lock->lockWrite(); } }
+    ~AutoWriteLock() { if (m_lock != nullptr) { m_lock->unlockWrite(); } }
+};
+
+
+//The class represents a job that is composed of a number of independent
+//tasks. Each task is identified by an index in [0, task_num).
+class ParallelJob {
+public:
+    virtual ~ParallelJob() {}
+
+    //The function will be invoked for each task.
+    //Return false to stop issuing the remaining tasks.
+    //task_idx: the index of task.
+    //thread_idx: the index of worker thread that is executing the task.
+    virtual bool runTask(UINT task_idx, UINT thread_idx) = 0;
+};
+
+
+//Return the index of worker thread that is executing current code.
+//The index is in [0, thread_num) inside the task of runParallelJob(), and
+//it is 0 for the thread that is not a worker.
+UINT getThreadIdx();
+
+//Return the number of concurrent threads supported by host machine.
+//Return 1 if the number can not be determined.
+UINT getHostThreadNum();
+
+//The function dispatches tasks of 'job' to 'thread_num' worker threads.
+//Each worker fetches the next unhandled task until all tasks are
+//finished. The function returns after all workers exit.
+//Return true if all tasks finished normally, otherwise return false.
+//thread_num: the number of worker threads. If it is 0 or 1, all tasks
+//            will be executed in current thread.
+//task_num: the number of tasks.
+bool runParallelJob(UINT thread_num, UINT task_num, ParallelJob & job);
+
+} //namespace xcom
+#endif
@@ -25,6 +25,11 @@ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
 OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
 USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 @*/
+#ifdef _ON_WINDOWS_
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
 #include "elfinc.h"
 #define STR_UNDEF "" //Common used empty string.
 #define PHASE(a)
@@ -37,6 +42,8 @@ namespace elf {
 //   other device file.
 // -elf-fatbin option: Output fatbin file that directly executes on device.
 //  It will call ld linked multi-file and other external .so file.
+// -elf-arindex-dir option: The directory to cache the symbol index of AR
+//  files.
 ELFOpt g_elf_opt;
 
 typedef struct {
@@ -539,6 +546,7 @@ void SectionInfoMgr::initSectionInfo(MOD SectionInfo * si,
 ELFMgr::ELFMgr() : m_symbol_info(&m_sym_mgr)
 {
     m_file = nullptr;
+    m_mapped_file = nullptr;
     m_dump = nullptr;
     m_ti = nullptr;
     m_pool = nullptr;
@@ -571,6 +579,10 @@ ELFMgr::ELFMgr() : m_symbol_info(&m_sym_mgr)
 ELFMgr::~ELFMgr()
 {
     if (m_file != nullptr) { delete m_file; m_file = nullptr; }
+    if (m_mapped_file != nullptr) {
+        delete m_mapped_file;
+        m_mapped_file = nullptr;
+    }
     if (m_dump != nullptr) { delete m_dump; m_dump = nullptr; }
     if (m_ti != nullptr) { delete m_ti; m_ti = nullptr; }
     if (m_sect_mgr != nullptr) { delete m_sect_mgr; m_sect_mgr = nullptr; }
@@ -678,6 +690,15 @@ EM_STATUS ELFMgr::closeDump()
 
 EM_STATUS ELFMgr::closeELF()
 {
+    if (m_file != nullptr && m_file->isMapped()) {
+        //Section contents may be views into the mapping. Release the file
+        //handler but keep the mapping alive until the next mapped file
+        //closed or ELFMgr destructed.
+        if (m_mapped_file != nullptr) { delete m_mapped_file; }
+        m_mapped_file = m_file;
+        m_mapped_file->closeHandler();
+        m_file = nullptr;
+    }
     if (m_file != nullptr) {
         delete m_file;
         m_file = nullptr;
@@ -1086,6 +1107,19 @@ EM_STATUS ELFMgr::readSectContent(size_t idx)
     }
     if (m_elf_sectheader[idx].s_size == 0) { return EM_SUCC; }
 
+    //Expose the section content as a view into the file mapping instead
+    //of reading a copy. The mapping is private, the system copies the
+    //page on write and the file keeps unchanged.
+    if (nullptr == m_elf_sectheader[idx].s_content &&
+        m_elf_sectheader[idx].s_type != S_NOBITS && m_file->isMapped()) {
+        BYTE * view = m_file->getMapAddr(
+            (size_t)(getELFFileOffset() + m_elf_sectheader[idx].s_offset),
+            (size_t)m_elf_sectheader[idx].s_size);
+        if (view == nullptr) { return EM_RD_ERR; }
+        m_elf_sectheader[idx].s_content = view;
+        return EM_SUCC;
+    }
+
     //Read the section content if it still not yet loaded.
     if (nullptr == m_elf_sectheader[idx].s_content) {
         //ASSERTN(!isSectionAllocable(idx),
@@ -1692,6 +1726,12 @@ EM_STATUS ELFMgr::readAllSectContent()
 EM_STATUS ELFMgr::readELF(CHAR const* filename, bool read_all_content)
 {
     EM_STATUS st = open(filename);
+    if (st != EM_SUCC) { return st; }
+    if (g_elf_opt.isMmapInput()) {
+        //Mapping failure is not an error, the reading falls back to
+        //buffered IO.
+        m_file->map();
+    }
     //Read the elf header.
     clean();
     readELFContent(read_all_content);
@@ -5065,6 +5105,11 @@ EM_STATUS ELFAR::open(CHAR const* filename, MOD ELFARMgr * elfar_mgr)
         m_file = nullptr;
         return EM_OPEN_ERR;
     }
+    if (g_elf_opt.isMmapInput()) {
+        //The mapping is shared by all ELF members of the AR file, thus
+        //member's section contents are views into the same mapping.
+        m_file->map();
+    }
     return EM_SUCC;
 }
 
@@ -5154,11 +5199,15 @@ EM_STATUS ELFAR::readSymbolIndex()
 
     //Read 'index_array' content.
     UINT64 index_array_size = m_index_num * index_elem_size;
-    BYTE * index_buf = (BYTE*)ALLOCA(index_array_size);
-    ASSERT0(index_buf);
-
-    if (EM_SUCC != read(index_buf, m_file_pos, index_array_size)) {
-        return EM_RD_ERR;
+    BYTE const* index_buf = m_file->getMapAddr(
+        (size_t)m_file_pos, (size_t)index_array_size);
+    if (index_buf == nullptr) {
+        BYTE * buf = (BYTE*)ALLOCA(index_array_size);
+        ASSERT0(buf);
+        if (EM_SUCC != read(buf, m_file_pos, index_array_size)) {
+            return EM_RD_ERR;
+        }
+        index_buf = buf;
     }
     m_file_pos += (index_array_size);
 
@@ -5179,6 +5228,12 @@ EM_STATUS ELFAR::readSymbolIndex()
     m_sym_tab_size = (hdr_size + ARHDR_add_size(hdr_size)) -
         index_elem_size - index_array_size;
 
+    //The global symbol table is a view into the mapping if AR file has
+    //been mapped.
+    m_sym_tab = (CHAR*)m_file->getMapAddr(
+        (size_t)m_file_pos, (size_t)m_sym_tab_size);
+    if (m_sym_tab != nullptr) { return EM_SUCC; }
+
     //Read 'm_sym_tab' content.
     m_sym_tab = (CHAR*)::malloc(m_sym_tab_size);
     ASSERT0(m_sym_tab);
@@ -5214,10 +5269,346 @@ EM_STATUS ELFAR::readARFile(MOD ELFARMgr * elfar_mgr)
 
     if ((st = readARHeader()) != EM_SUCC) { return st; }
 
+    //The global symbol table need not be parsed if the symbol index
+    //is up to date.
+    if (m_sym_index.load(this)) { return EM_SUCC; }
+
     if ((st = readSymbolIndex()) != EM_SUCC) { return st; }
+
+    m_sym_index.build(this);
+    m_sym_index.save(this);
     return st;
 }
 
+
+void ELFAR::getIndexDir(OUT xcom::StrBuf & buf)
+{
+    CHAR const* dir = g_elf_opt.getARIndexDir();
+    if (dir != nullptr && dir[0] != 0) {
+        buf.sprint("%s", dir);
+        return;
+    }
+    dir = ::getenv("XDG_CACHE_HOME");
+    if (dir != nullptr && dir[0] != 0) {
+        buf.sprint("%s/xoc", dir);
+        return;
+    }
+    #ifdef _ON_WINDOWS_
+    dir = ::getenv("LOCALAPPDATA");
+    #else
+    dir = ::getenv("HOME");
+    #endif
+    if (dir != nullptr && dir[0] != 0) {
+        buf.sprint("%s/.cache/xoc", dir);
+        return;
+    }
+    #ifdef _ON_WINDOWS_
+    dir = ::getenv("TEMP");
+    buf.sprint("%s", dir != nullptr ? dir : ".");
+    #else
+    dir = ::getenv("TMPDIR");
+    buf.sprint("%s", dir != nullptr && dir[0] != 0 ? dir : "/tmp");
+    #endif
+}
+
+
+void ELFAR::getIndexFileName(OUT xcom::StrBuf & buf) const
+{
+    ASSERT0(m_file_name);
+    //Key the index file by absolute path of AR file.
+    CHAR const* path = m_file_name;
+    #ifdef _ON_WINDOWS_
+    CHAR * abspath = ::_fullpath(nullptr, m_file_name, 0);
+    #else
+    CHAR * abspath = ::realpath(m_file_name, nullptr);
+    #endif
+    if (abspath != nullptr) { path = abspath; }
+
+    //FNV-1a hash.
+    UINT64 h = 14695981039346656037ULL;
+    for (CHAR const* p = path; *p != 0; p++) {
+        h ^= (UINT64)(UCHAR)*p;
+        h *= 1099511628211ULL;
+    }
+
+    //Keep the base name to make the cache directory readable.
+    CHAR const* base = path;
+    for (CHAR const* p = path; *p != 0; p++) {
+        if (*p == '/' || *p == '\\') { base = p + 1; }
+    }
+    xcom::StrBuf dir(64);
+    getIndexDir(dir);
+    buf.sprint("%s/%s-%016llx%s", dir.getBuf(), base, (unsigned long long)h,
+               ELFAR_INDEX_FILE_SUFFIX);
+    if (abspath != nullptr) { ::free(abspath); }
+}
+
+
+//
+// =========================== ELFARIndex Start ========================
+//
+UINT32 ELFARIndex::hashName(CHAR const* name, size_t len)
+{
+    ASSERT0(name);
+    //FNV-1a hash.
+    UINT32 h = 2166136261U;
+    for (size_t i = 0; i < len; i++) {
+        h ^= (UINT32)(UCHAR)name[i];
+        h *= 16777619U;
+    }
+    return h;
+}
+
+
+void ELFARIndex::setContent(BYTE const* buf)
+{
+    ASSERT0(buf);
+    m_hdr = (ELFARIndexHdr const*)buf;
+    m_slot = (ELFARIndexSlot const*)(buf + sizeof(ELFARIndexHdr));
+    m_str_tab = (CHAR const*)(m_slot + m_hdr->slot_num);
+}
+
+
+void ELFARIndex::destroy()
+{
+    if (m_file != nullptr) { delete m_file; m_file = nullptr; }
+    if (m_buf != nullptr) { ::free(m_buf); m_buf = nullptr; }
+    m_hdr = nullptr;
+    m_slot = nullptr;
+    m_str_tab = nullptr;
+}
+
+
+bool ELFARIndex::isSameFileStat(FileStat const& st1, FileStat const& st2)
+{
+    return st1.size == st2.size && st1.dev == st2.dev &&
+           st1.ino == st2.ino && st1.mtime_sec == st2.mtime_sec &&
+           st1.mtime_nsec == st2.mtime_nsec &&
+           st1.ctime_sec == st2.ctime_sec &&
+           st1.ctime_nsec == st2.ctime_nsec;
+}
+
+
+bool ELFARIndex::verify(BYTE const* buf, size_t size,
+                        FileStat const& ar_stat)
+{
+    ASSERT0(buf);
+    if (size < sizeof(ELFARIndexHdr)) { return false; }
+    ELFARIndexHdr const* hdr = (ELFARIndexHdr const*)buf;
+    if (::memcmp(hdr->magic, ELFAR_INDEX_MAGIC, ELFAR_INDEX_MAGIC_LEN) != 0 ||
+        hdr->version != ELFAR_INDEX_VERSION ||
+        !isSameFileStat(hdr->ar_stat, ar_stat)) {
+        return false;
+    }
+    //The number of slot must be power of 2.
+    if (hdr->slot_num == 0 || (hdr->slot_num & (hdr->slot_num - 1)) != 0) {
+        return false;
+    }
+    UINT64 slot_size = (UINT64)hdr->slot_num * sizeof(ELFARIndexSlot);
+    if ((UINT64)size != sizeof(ELFARIndexHdr) + slot_size +
+        hdr->str_tab_size) {
+        return false;
+    }
+    //The last name in string table must be terminated.
+    if (hdr->str_tab_size != 0 && buf[size - 1] != 0) { return false; }
+
+    //Each ELF member must begin with an AR header inside AR file.
+    ELFARIndexSlot const* slot = (ELFARIndexSlot const*)(buf +
+        sizeof(ELFARIndexHdr));
+    for (UINT i = 0; i < hdr->slot_num; i++) {
+        if (slot[i].pos == 0) { continue; }
+        if (slot[i].pos > hdr->sym_num ||
+            slot[i].name_ofst >= hdr->str_tab_size ||
+            slot[i].member_ofst >= ar_stat.size ||
+            ar_stat.size - slot[i].member_ofst < sizeof(ARHdr)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+void ELFARIndex::build(ELFAR const* ar)
+{
+    ASSERT0(ar && ar->m_file);
+    destroy();
+
+    UINT sym_num = (UINT)ELFAR_index_num(ar);
+    //Keep the load factor of hash table no more than 1/2.
+    UINT slot_num = 1;
+    while (slot_num < sym_num * 2) { slot_num <<= 1; }
+
+    //The string table is no larger than the global symbol table, since
+    //the names with same name are dropped.
+    size_t slot_size = slot_num * sizeof(ELFARIndexSlot);
+    size_t size = sizeof(ELFARIndexHdr) + slot_size +
+        (size_t)ELFAR_sym_tab_size(ar) + 1;
+    m_buf = (BYTE*)::malloc(size);
+    ASSERT0(m_buf);
+    ::memset((void*)m_buf, 0, sizeof(ELFARIndexHdr) + slot_size);
+
+    ELFARIndexHdr * hdr = (ELFARIndexHdr*)m_buf;
+    ::memcpy(hdr->magic, ELFAR_INDEX_MAGIC, ELFAR_INDEX_MAGIC_LEN);
+    hdr->version = ELFAR_INDEX_VERSION;
+    ar->m_file->getFileStat(hdr->ar_stat);
+    hdr->sym_num = sym_num;
+    hdr->slot_num = slot_num;
+    ELFARIndexSlot * slot = (ELFARIndexSlot*)(m_buf + sizeof(ELFARIndexHdr));
+    CHAR * str_tab = (CHAR*)(slot + slot_num);
+
+    UINT64 len = 0;
+    UINT64 str_tab_size = 0;
+    UINT mask = slot_num - 1;
+    for (UINT i = 0; i < sym_num && len < ELFAR_sym_tab_size(ar); i++) {
+        CHAR const* name = ELFAR_sym_tab(ar) + len;
+        size_t name_len = ::strnlen(name,
+            (size_t)(ELFAR_sym_tab_size(ar) - len));
+        len += ELF_INCREASE_VALUE(name_len);
+
+        UINT32 h = hashName(name, name_len);
+        UINT s = h & mask;
+        for (; slot[s].pos != 0; s = (s + 1) & mask) {
+            CHAR const* p = str_tab + slot[s].name_ofst;
+            if (slot[s].hash == h && ::strncmp(p, name, name_len) == 0 &&
+                p[name_len] == 0) {
+                break;
+            }
+        }
+        //The first element with the name wins.
+        if (slot[s].pos != 0) { continue; }
+
+        slot[s].hash = h;
+        slot[s].pos = ELF_INCREASE_VALUE(i);
+        slot[s].name_ofst = (UINT32)str_tab_size;
+        slot[s].member_ofst = ELFAR_idx_array(ar)[i];
+        ::memcpy(str_tab + str_tab_size, name, name_len);
+        str_tab[str_tab_size + name_len] = 0;
+        str_tab_size += ELF_INCREASE_VALUE(name_len);
+    }
+    hdr->str_tab_size = str_tab_size;
+    setContent(m_buf);
+}
+
+
+bool ELFARIndex::find(CHAR const* name, OUT UINT64 * member_ofst,
+                      OUT UINT * pos) const
+{
+    ASSERT0(name && member_ofst && pos);
+    if (m_hdr == nullptr) { return false; }
+
+    UINT32 h = hashName(name, ::strlen(name));
+    UINT mask = m_hdr->slot_num - 1;
+    for (UINT s = h & mask, n = 0; n < m_hdr->slot_num;
+         s = (s + 1) & mask, n++) {
+        ELFARIndexSlot const& slot = m_slot[s];
+        if (slot.pos == 0) { return false; }
+        //The slot has been checked by verify() or built from AR file.
+        ASSERT0(slot.pos <= m_hdr->sym_num &&
+                slot.name_ofst < m_hdr->str_tab_size);
+        if (slot.hash != h) { continue; }
+        if (::strcmp(m_str_tab + slot.name_ofst, name) != 0) { continue; }
+        *member_ofst = slot.member_ofst;
+        *pos = slot.pos - 1;
+        return true;
+    }
+    return false;
+}
+
+
+bool ELFARIndex::load(ELFAR const* ar)
+{
+    ASSERT0(ar && ar->m_file);
+    destroy();
+
+    //The index can not be verified without the identity of AR file.
+    FileStat ar_stat;
+    if (!ar->m_file->getFileStat(ar_stat)) { return false; }
+
+    xcom::StrBuf name(64);
+    ar->getIndexFileName(name);
+    if (!FileObj::isFileExist(name.getBuf())) { return false; }
+
+    FO_STATUS st;
+    FileObj * fo = new FileObj(name.getBuf(), false, true, &st);
+    ASSERT0(fo);
+    if (st != xcom::FO_SUCC) { delete fo; return false; }
+
+    BYTE const* buf = fo->map();
+    size_t size = fo->getMapSize();
+    if (buf == nullptr) {
+        //Read the index into memory if the mapping is unavailable.
+        size = fo->getFileSize();
+        m_buf = (BYTE*)::malloc(size == 0 ? 1 : size);
+        ASSERT0(m_buf);
+        size_t rd = 0;
+        if (fo->read(m_buf, 0, size, &rd) != xcom::FO_SUCC || rd != size) {
+            delete fo;
+            destroy();
+            return false;
+        }
+        buf = m_buf;
+    }
+    //The mapping is still accessible after the handler closed.
+    fo->closeHandler();
+    if (!verify(buf, size, ar_stat)) {
+        delete fo;
+        destroy();
+        return false;
+    }
+    if (m_buf == nullptr) {
+        m_file = fo;
+    } else {
+        delete fo;
+    }
+    setContent(buf);
+    return true;
+}
+
+
+void ELFARIndex::save(ELFAR const* ar) const
+{
+    ASSERT0(ar && m_hdr);
+    //The index can not be verified without the identity of AR file.
+    if (m_hdr->ar_stat.ino == 0) { return; }
+
+    //Create the cache directory and its parent directory, the failure is
+    //detected when creating the index file.
+    xcom::StrBuf dir(64);
+    ELFAR::getIndexDir(dir);
+    xcom::StrBuf prefix(64);
+    for (CHAR const* p = dir.getBuf() + 1; ; p++) {
+        if (*p != '/' && *p != '\\' && *p != 0) { continue; }
+        prefix.sprint("%.*s", (INT)(p - dir.getBuf()), dir.getBuf());
+        #ifdef _ON_WINDOWS_
+        ::_mkdir(prefix.getBuf());
+        #else
+        ::mkdir(prefix.getBuf(), 0755);
+        #endif
+        if (*p == 0) { break; }
+    }
+
+    xcom::StrBuf name(64);
+    ar->getIndexFileName(name);
+    xcom::StrBuf tmpname(64);
+    tmpname.sprint("%s.tmp", name.getBuf());
+
+    //Write to a temporary file and rename it to make the update atomic to
+    //other linker process.
+    FO_STATUS st;
+    FileObj fo(tmpname.getBuf(), true, false, &st);
+    if (st != xcom::FO_SUCC) { return; }
+    size_t size = sizeof(ELFARIndexHdr) +
+        m_hdr->slot_num * sizeof(ELFARIndexSlot) +
+        (size_t)m_hdr->str_tab_size;
+    size_t wr = 0;
+    bool succ = fo.write((BYTE const*)m_hdr, 0, size, &wr) ==
+        xcom::FO_SUCC && wr == size;
+    fo.destroy();
+    if (!succ || ::rename(tmpname.getBuf(), name.getBuf()) != 0) {
+        UNLINK(tmpname.getBuf());
+    }
+}
+
 //
 // =========================== ELFARMgr Start ========================
 //
@@ -5377,6 +5768,30 @@ void ELFARMgr::saveARInfo(MOD ELFAR * ar, MOD ELFMgr * elf_mgr, UINT64 idx)
 }
 
 
+bool ELFARMgr::findFromSymbolARInfoMap(Sym const* symbol_name)
+{
+    ASSERT0(symbol_name);
+    if (m_symbol_ar_info_map.find(symbol_name)) { return true; }
+
+    //Probe AR files in the order in which they were read, the first
+    //definition wins. Only the symbols ahead of the resolving position
+    //are visible.
+    xcom::C<ELFAR*> * ct = nullptr;
+    for (ELFAR * ar = m_ar_list.get_head(&ct);
+         ar != nullptr; ar = m_ar_list.get_next(&ct)) {
+        UINT64 idx = 0;
+        UINT pos = 0;
+        if (!ar->findSymbol(symbol_name->getStr(), &idx, &pos) ||
+            pos >= ELFAR_resolve_pos(ar)) {
+            continue;
+        }
+        saveSymbolARInfo(ar, symbol_name, idx);
+        return true;
+    }
+    return false;
+}
+
+
 void ELFARMgr::saveSymbolARInfo(
     MOD ELFAR * ar, Sym const* symbol_name, UINT64 idx)
 {
@@ -5449,6 +5864,7 @@ LinkerMgr::LinkerMgr()
     m_output_file_name = nullptr;
     m_dump = nullptr;
     m_output_elf_mgr = nullptr;
+    m_resolving_ar = nullptr;
 
     if (g_elf_opt.isDumpLink()) {
         initDumpFile(LINKERMGR_DUMP_LOG_FILE_NAME);
@@ -5536,6 +5952,7 @@ void LinkerMgr::allocUnresolvedRelocSymbol(
 
     vec->append(idx);
     m_unresolved_reloc_idx_map.set(RELOCINFO_name(reloc_info), vec);
+    addARResolveCand(RELOCINFO_name(reloc_info));
 }
 
 
@@ -5849,60 +6266,85 @@ void LinkerMgr::resolveRelocInfoViaARFile()
     //from AR file. AR file is packaged with numerous ELF. If target symbol has
     //been found, a new ELFMgr will be created according to the ELF info to
     //which this target symbol belong.
-    //1.Enter 'while' statement until all unresolved RelocInfo are resovlved or
-    //  all AR file have been found. In 'while' statement, AR file is popped
-    //  from 'm_ar_file_stack' and a 'for' statement is used to iterate over
-    //  global symtab in this AR file.
-    //2.'symbol' getting from global symtab will be used to find unresolved
-    //  RelocInfo from 'm_unresolved_reloc_idx_map'.
-    //3.Skipped if RelocInfo with the same name as 'symbol' has been resolved.
-    //  Thus if there are more than one target 'symbol' with the same name as
-    //  RelocInfo, only the first target 'symbol' will be used to resolve.
-    //4.If there isn't unresolved RelocInfo with the same name as 'symbol' in
-    //  'm_unresolved_reloc_idx_map', the 'symbol' still needs to be recorded.
-    //  Since RelocInfo in 'm_reloc_sym_vec' is constantly updated according to
-    //  the situation, there may be RelocInfo updated later needs this 'symbol'
-    //  to resolve. Thus ELFARInfo is used to record the relationship between
-    //  the name and index of 'symbol' and AR file, and the ELFARInfo object
-    //  will be recorded into 'm_symbol_ar_info_map'.
-    //5.If there is unresolved RelocInfo with the same name as 'symbol' in
-    //  'm_unresolved_reloc_idx_map', ELFMgr to which 'symbol' belong will be
-    //  got by 'findELFMgr' function or generated from AR file according to
-    //  ELFARInfo. If a new ELFMgr is generated, SymbolInfo and RelocInfo which
-    //  are belong to this ELFMgr need to be recorded into the LinkerMgr.
-    //6.RelocInfo will be resolved by this target 'symbol'.
     while (hasUnResolvedRelocSymbol(false)) {
         //Get AR file utill all AR file have been used.
         ELFAR * ar = m_armgr.processARFile();
         if (ar == nullptr) { break; }
+        resolveRelocInfoViaARIndex(ar);
+    }
+}
 
-        UINT len = 0;
-        for (UINT i = 0; i < ELFAR_index_num(ar); i++) {
-            CHAR * sym_str = ELFAR_sym_tab(ar) + len;
-            ASSERT0(sym_str);
-            Sym const* global_sym = m_output_elf_mgr->addToSymTab(sym_str);
-            ASSERT0(global_sym);
-
-            UINT64 index = ELFAR_idx_array(ar)[i];
-            len += ELF_INCREASE_VALUE((UINT)::strnlen(
-                ELFAR_sym_tab(ar) + len, ELFAR_sym_tab_size(ar) - len));
-
-            if (checkHasBeenResolvedReloc(global_sym)) { continue; }
-            //Now no RelocInfo needs to be resolved by global_sym. But it may
-            //be needed by other RelocInfo that occurs in the funture.
-            if (!m_unresolved_reloc_idx_map.find(global_sym)) {
-                m_armgr.saveSymbolARInfo(ar, global_sym, index);
-                continue;
-            }
-            //There is unresolved RelocInfo that needs to be resolved
-            //by SymbolInfo with the name of 'global_sym'. And the
-            //'elf_mgr' to which 'global_sym' belong has been recorded.
-            ELFMgr * elf_mgr = getELFMgrWhichSymbolBelongTo(ar, index);
-            ASSERT0(elf_mgr);
 
-            resolveRelocInfoWithELFMgr(elf_mgr, global_sym);
-        }
+void LinkerMgr::addARResolveCand(Sym const* sym_name)
+{
+    ASSERT0(sym_name);
+    if (m_resolving_ar == nullptr) { return; }
+
+    UINT64 index = 0;
+    UINT pos = 0;
+    if (!m_resolving_ar->findSymbol(sym_name->getStr(), &index, &pos)) {
+        return;
     }
+    //The symbol ahead of resolving position is found by
+    //'findFromSymbolARInfoMap' function.
+    if (pos < ELFAR_resolve_pos(m_resolving_ar)) { return; }
+    m_ar_resolve_cand.bunion((BSIdx)pos);
+    m_ar_resolve_cand_map.set(pos, sym_name);
+}
+
+
+void LinkerMgr::resolveRelocInfoViaARIndex(MOD ELFAR * ar)
+{
+    ASSERT0(ar && m_resolving_ar == nullptr);
+    m_resolving_ar = ar;
+    ELFAR_resolve_pos(ar) = 0;
+    m_ar_resolve_cand.clean();
+    m_ar_resolve_cand_map.clean();
+
+    //Probe the name of unresolved RelocInfo. The RelocInfo resolved by
+    //SymbolInfo with STT_NOTYPE is probed too, since it may be replaced.
+    RelocSymbolIdxMapIter it;
+    Vector<UINT> * vec = nullptr;
+    for (Sym const* sym = m_unresolved_reloc_idx_map.get_first(it, &vec);
+         sym != nullptr; sym = m_unresolved_reloc_idx_map.get_next(it, &vec)) {
+        addARResolveCand(sym);
+    }
+    it.clean();
+    for (Sym const* sym = m_resolved_reloc_idx_map.get_first(it, &vec);
+         sym != nullptr; sym = m_resolved_reloc_idx_map.get_next(it, &vec)) {
+        ASSERT0(vec && vec->get_elem_count() > 0);
+        RelocInfo const* reloc_info = m_reloc_symbol_vec[vec->get(0)];
+        ASSERT0(reloc_info);
+        if (RELOCINFO_resolved_notype(reloc_info)) { addARResolveCand(sym); }
+    }
+
+    //New candidates behind current position may be added during the
+    //iteration.
+    for (BSIdx i = m_ar_resolve_cand.get_first();
+         i != BS_UNDEF; i = m_ar_resolve_cand.get_next(i)) {
+        ELFAR_resolve_pos(ar) = (UINT)i;
+        Sym const* global_sym = m_ar_resolve_cand_map.get((UINT)i);
+        ASSERT0(global_sym);
+        if (checkHasBeenResolvedReloc(global_sym)) { continue; }
+        if (!m_unresolved_reloc_idx_map.find(global_sym)) { continue; }
+
+        UINT64 index = 0;
+        UINT pos = 0;
+        bool find = ar->findSymbol(global_sym->getStr(), &index, &pos);
+        ASSERT0_DUMMYUSE(find);
+        ASSERT0(pos == (UINT)i);
+
+        //There is unresolved RelocInfo that needs to be resolved
+        //by SymbolInfo with the name of 'global_sym'.
+        ELFMgr * elf_mgr = getELFMgrWhichSymbolBelongTo(ar, index);
+        ASSERT0(elf_mgr);
+
+        resolveRelocInfoWithELFMgr(elf_mgr, global_sym);
+    }
+
+    //All symbols of 'ar' are visible to the AR files that follow.
+    ELFAR_resolve_pos(ar) = ELFAR_sym_index(ar).getSymNum();
+    m_resolving_ar = nullptr;
 }
 
 
@@ -6023,6 +6465,10 @@ void LinkerMgr::resolveRelocInfo(Sym const* sym_name,
     m_unresolved_reloc_idx_map.remove(sym_name);
     ASSERT0(!m_resolved_reloc_idx_map.find(sym_name));
     m_resolved_reloc_idx_map.set(sym_name, reloc_idx_vec);
+
+    //The SymbolInfo with 'STT_NOTYPE' attribute may be replaced by the
+    //symbol in AR file.
+    if (is_notype) { addARResolveCand(sym_name); }
 }
 
 
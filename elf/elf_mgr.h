@@ -1351,6 +1351,11 @@ protected:
     typedef TTabIter<ELFSHdr*> StrTabTabIter;
 
     FileObj * m_file; //ELF file
+
+    //Record the closed ELF file whose mapping is still referenced by
+    //section contents. The section contents read in mmap mode are views
+    //into the file mapping, thus the mapping has to outlive the file.
+    FileObj * m_mapped_file;
     FileObj * m_dump; //Dump file
     ELFTargInfo * m_ti; //target dependent info.
     ELFHdr m_elf_hdr; //ELF header
@@ -3010,6 +3015,15 @@ public:
     bool m_is_fatbin_elf;
     //-elf-dumplink option: Dump info during link process.
     bool m_is_dump_link_info;
+    //Read input ELF and AR files through a private file mapping. Section
+    //contents, string tables and AR symbol table are views into the
+    //mapping rather than copies, the system copies a page only when it
+    //is written. The mode falls back to buffered reading if the file
+    //can not be mapped.
+    bool m_is_mmap_input;
+    //-elf-arindex-dir option: The directory to cache the symbol index of
+    //AR files. The default directory is decided by ELFAR::getIndexDir().
+    CHAR const* m_ar_index_dir;
 public:
     ELFOpt()
     {
@@ -3018,6 +3032,8 @@ public:
         m_is_device_elf = true;
         m_is_fatbin_elf = false;
         m_is_dump_link_info = false;
+        m_is_mmap_input = true;
+        m_ar_index_dir = nullptr;
     }
 
     bool isDeviceELF() const { return m_is_device_elf; }
@@ -3026,11 +3042,146 @@ public:
     //The default log file is 'dump.log'.
     //e.g.: pcxac.exe xxx.pcx -O0 -elf-fatbin -elf-dumplink
     bool isDumpLink() const { return m_is_dump_link_info; }
+    bool isMmapInput() const { return m_is_mmap_input; }
+    CHAR const* getARIndexDir() const { return m_ar_index_dir; }
 };
 
 extern ELFOpt g_elf_opt;
 
 
+//
+//Start ELFARIndex.
+//
+class ELFAR;
+
+#define ELFAR_INDEX_MAGIC "XOCARIDX"
+#define ELFAR_INDEX_MAGIC_LEN 8
+#define ELFAR_INDEX_FILE_SUFFIX ".xidx"
+
+//Increase the version whenever the layout of index file changed.
+#define ELFAR_INDEX_VERSION 2
+
+//The header of AR symbol index file.
+class ELFARIndexHdr {
+public:
+    CHAR magic[ELFAR_INDEX_MAGIC_LEN];
+
+    //The format version of index file, it is ELFAR_INDEX_VERSION.
+    UINT32 version;
+    UINT32 reserved;
+
+    //The identity of AR file when the index was built. The index is stale
+    //if any field changed.
+    FileStat ar_stat;
+
+    //The number of element in the global symbol table of AR file.
+    UINT32 sym_num;
+
+    //The number of slot in hash table, it is power of 2.
+    UINT32 slot_num;
+
+    //The byte size of string table.
+    UINT64 str_tab_size;
+};
+
+
+//The slot of open addressing hash table in AR symbol index file.
+class ELFARIndexSlot {
+public:
+    //Hash value of symbol name.
+    UINT32 hash;
+
+    //The position of the first element with the name in the global symbol
+    //table of AR file plus one. 0 indicates an empty slot.
+    UINT32 pos;
+
+    //The byte offset of symbol name in string table.
+    UINT32 name_ofst;
+    UINT32 reserved;
+
+    //The offset of ELF member in AR file to which the symbol belong.
+    UINT64 member_ofst;
+};
+
+
+//The class maps symbol name to the ELF member of AR file by hash table.
+//The index is persisted in the index cache directory, see
+//ELFAR::getIndexDir(), and is keyed by the size, inode and modification
+//time of AR file. The linker maps the index file if it is up to date,
+//otherwise the index is built from the global symbol table of AR file and
+//written back. The format of index file is:
+// ----------------
+//  ELFARIndexHdr
+// ----------------
+//  slot table
+//                  ELFARIndexHdr::slot_num ELFARIndexSlot elements.
+// ----------------
+//  string table
+//                  Record all distinct symbol names: str1\0str2\0...
+// ----------------
+class ELFARIndex {
+    COPY_CONSTRUCTOR(ELFARIndex);
+
+    //Record the index file if the index is mapped from file.
+    FileObj * m_file;
+
+    //Record the buffer if the index is built or read into memory.
+    BYTE * m_buf;
+    ELFARIndexHdr const* m_hdr;
+    ELFARIndexSlot const* m_slot;
+    CHAR const* m_str_tab;
+protected:
+    static UINT32 hashName(CHAR const* name, size_t len);
+
+    void setContent(BYTE const* buf);
+
+    //Return true if 'buf' is a valid index of the AR file with 'ar_stat'.
+    //Every slot is checked so that the index can not lead the linker out of
+    //the AR file.
+    static bool verify(BYTE const* buf, size_t size, FileStat const& ar_stat);
+
+    //Return true if 'st1' and 'st2' describe the same content of file.
+    static bool isSameFileStat(FileStat const& st1, FileStat const& st2);
+public:
+    ELFARIndex()
+    {
+        m_file = nullptr;
+        m_buf = nullptr;
+        m_hdr = nullptr;
+        m_slot = nullptr;
+        m_str_tab = nullptr;
+    }
+    ~ELFARIndex() { destroy(); }
+
+    //Build the index from the global symbol table of 'ar'. The first
+    //element wins if there are elements with the same name.
+    void build(ELFAR const* ar);
+
+    void destroy();
+
+    //Find the ELF member of AR file that defines 'name'.
+    //member_ofst: record the offset of ELF member in AR file.
+    //pos: record the position of the first element with 'name' in global
+    //     symbol table of AR file.
+    //Return true if 'name' is found.
+    bool find(CHAR const* name, OUT UINT64 * member_ofst,
+              OUT UINT * pos) const;
+
+    //Return the number of element in the global symbol table of AR file.
+    UINT getSymNum() const { return m_hdr == nullptr ? 0 : m_hdr->sym_num; }
+
+    bool isValid() const { return m_hdr != nullptr; }
+
+    //Map the index file of 'ar'. Return false if the file does not exist
+    //or is stale.
+    bool load(ELFAR const* ar);
+
+    //Write the index to the index file of 'ar'. The writing is skipped
+    //silently if the file can not be created.
+    void save(ELFAR const* ar) const;
+};
+
+
 //
 //Start ELFAR.
 //
@@ -3038,6 +3189,8 @@ extern ELFOpt g_elf_opt;
 #define ELFAR_sym_tab(e)      ((e)->m_sym_tab)
 #define ELFAR_sym_tab_size(e) ((e)->m_sym_tab_size)
 #define ELFAR_idx_array(e)    ((e)->m_index_array)
+#define ELFAR_sym_index(e)    ((e)->m_sym_index)
+#define ELFAR_resolve_pos(e)  ((e)->m_resolve_pos)
 //Manage the AR file. It can parse the AR file format, extract valid info.
 //The AR file format is referenced from 'ar_header.h'.
 class ELFAR {
@@ -3067,6 +3220,14 @@ public:
 
     //Record ARHdr.
     ARHdr m_ar_hdr;
+
+    //Record the hashed index of global symbol table.
+    ELFARIndex m_sym_index;
+
+    //Record the position in global symbol table that the linker is
+    //resolving. Only the symbols ahead of the position can be used to
+    //resolve the RelocInfo that occurs afterwards.
+    UINT m_resolve_pos;
 public:
     ELFAR(CHAR const* name)
     {
@@ -3077,14 +3238,33 @@ public:
         m_file = nullptr;
         m_sym_tab = nullptr;
         m_file_name = name;
+        m_resolve_pos = 0;
     }
 
     ~ELFAR() {}
 
+    //Find the ELF member that defines 'name' via symbol index.
+    //member_ofst: record the offset of ELF member in AR file.
+    //pos: record the position of 'name' in global symbol table.
+    bool findSymbol(CHAR const* name, OUT UINT64 * member_ofst,
+                    OUT UINT * pos) const
+    { return m_sym_index.find(name, member_ofst, pos); }
+
     //Get ELF info from opened ARFile via 'offset'.
     //'elf_mgr': corresponded ELFMgr of ELF.
     EM_STATUS getArchiveELF(MOD ELFMgr * elf_mgr, UINT64 offset) const;
 
+    //Return the directory of symbol index files. It is the directory given
+    //by option, or $XDG_CACHE_HOME/xoc, or $HOME/.cache/xoc, or the system
+    //temporary directory in turn. The AR file may be located in read-only
+    //directory, thus the index is never written beside it.
+    static void getIndexDir(OUT xcom::StrBuf & buf);
+
+    //Return the file name of symbol index of AR file. The name is derived
+    //from the absolute path of AR file to avoid the conflict between AR
+    //files with the same base name.
+    void getIndexFileName(OUT xcom::StrBuf & buf) const;
+
     //Open ARFile via 'filename'.
     //'elfar_mgr': ELFARMgr object. Mange the resource of opened ARFile.
     EM_STATUS open(CHAR const* filename, MOD ELFARMgr * elfar_mgr);
@@ -3200,11 +3380,10 @@ public:
     void genVectorELFARInfo(ELFAR const* ar, MOD ELFARInfo * ar_info);
 
     //Find SymbolInfo from 'm_symbol_ar_info_map' according to 'symbol_name'.
-    bool findFromSymbolARInfoMap(Sym const* symbol_name) const
-    {
-        ASSERT0(symbol_name);
-        return m_symbol_ar_info_map.find(symbol_name);
-    }
+    //If it is not recorded, the symbol index of AR files that have been
+    //read will be probed in the order they were read, and the first found
+    //one will be recorded into 'm_symbol_ar_info_map'.
+    bool findFromSymbolARInfoMap(Sym const* symbol_name);
 
     //Find ELFAR from 'm_ar_info_map' according to 'ar'.
     bool findFromARInfoMap(ELFAR const* ar) const
@@ -3459,6 +3638,7 @@ public:
 
 typedef xcom::TMap<Sym const*, Vector<UINT>*> RelocSymbolIdxMap;
 typedef xcom::TMapIter<Sym const*, Vector<UINT>*> RelocSymbolIdxMapIter;
+typedef xcom::TMap<UINT, Sym const*> ARResolveCandMap;
 
 typedef xcom::TMap<Sym const*, UINT, CompareKeyBase<Sym const*>,
     GenMappedOfSameNameNumMap> SameNameNumMap;
@@ -3519,6 +3699,17 @@ protected:
     //Manage ELFARMgr object.
     ELFARMgr m_armgr;
 
+    //Record the AR file that is being resolved.
+    ELFAR * m_resolving_ar;
+
+    //Record the position in global symbol table of 'm_resolving_ar' of
+    //symbols that are needed to resolve RelocInfo. The positions are
+    //visited in ascending order.
+    xcom::BitSet m_ar_resolve_cand;
+
+    //Record 'position' <-> 'symbol name' of 'm_ar_resolve_cand'.
+    ARResolveCandMap m_ar_resolve_cand_map;
+
     //Manage Linker info object.
     LinkerInfoMgr m_infomgr;
 
@@ -3537,6 +3728,10 @@ public:
     virtual ELFMgr * allocOutputELFMgr()
     { ASSERTN(0, ("Target Dependent Code")); return nullptr; }
 
+    //Record 'sym_name' as candidate of 'm_resolving_ar' if it is defined
+    //in the AR file at or behind the resolving position.
+    void addARResolveCand(Sym const* sym_name);
+
     //Allocate vector to record the unresolved RelocInfo.
     //'reloc_info': unresolved RelocInfo.
     //'idx': the index of 'reloc_info' in 'm_reloc_sym_vec'.
@@ -3868,29 +4063,26 @@ public:
     //from AR file. AR file is packaged with numerous ELF. If target symbol has
     //been found, a new ELFMgr will be created according to the ELF info to
     //which this target symbol belong.
-    //1.Enter 'while' statement until all unresolved RelocInfo are resovlved or
-    //  all AR file have been found. In 'while' statement, AR file is popped
-    //  from 'm_ar_file_stack' and a 'for' statement is used to iterate over
-    //  global symtab in the AR file.
-    //2.'symbol' getting from global symtab will be used to find unresolved
-    //  RelocInfo from 'm_unresolved_reloc_idx_map'.
-    //3.Skipped if RelocInfo with the same name as 'symbol' has been resolved.
+    //Enter 'while' statement until all unresolved RelocInfo are resovlved
+    //or all AR file have been found. In 'while' statement, AR file is popped
+    //from 'm_ar_file_stack' and resolved by resolveRelocInfoViaARIndex().
+    void resolveRelocInfoViaARFile();
+
+    //Resolve RelocInfo with the symbol index of 'ar'.
+    //1.The name of each unresolved RelocInfo is probed in the symbol index,
+    //  the position in global symtab of found 'symbol' is recorded into
+    //  'm_ar_resolve_cand'. The positions are visited in ascending order.
+    //2.Skipped if RelocInfo with the same name as 'symbol' has been resolved.
     //  Thus if there are more than one target 'symbol' with the same name as
     //  RelocInfo, only the first target 'symbol' will be used to resolve.
-    //4.If there isn't unresolved RelocInfo with the same name as 'symbol' in
-    //  'm_unresolved_reloc_idx_map', the 'symbol' still needs to be recorded.
-    //  Since RelocInfo in 'm_reloc_sym_vec' is constantly updated according to
-    //  the situation, there may be RelocInfo updated later needs this 'symbol'
-    //  to resolve. Thus ELFARInfo is used to record the relationship between
-    //  the name and index of 'symbol' and AR file, and this ELFARInfo object
-    //  will be recorded into 'm_symbol_ar_info_map'.
-    //5.If there is unresolved RelocInfo with the same name as 'symbol' in
-    //  'm_unresolved_reloc_idx_map', ELFMgr to which 'symbol' belong will be
-    //  got by 'findELFMgr' function or generated from AR file according to
-    //  ELFARInfo. If a new ELFMgr is generated, SymbolInfo and RelocInfo which
-    //  are belong to this ELFMgr need to be recorded into the Linkermgr.
-    //6.RelocInfo will be resolved by this tharget 'symbol'.
-    void resolveRelocInfoViaARFile();
+    //3.ELFMgr to which 'symbol' belong will be got by 'findELFMgr' function
+    //  or generated from AR file. If a new ELFMgr is generated, SymbolInfo
+    //  and RelocInfo which are belong to this ELFMgr need to be recorded into
+    //  the Linkermgr. The new unresolved RelocInfo is probed too, and it is
+    //  a new candidate if the 'symbol' is behind current position. Otherwise
+    //  the 'symbol' is found by 'findFromSymbolARInfoMap' function.
+    //4.RelocInfo will be resolved by this target 'symbol'.
+    void resolveRelocInfoViaARIndex(MOD ELFAR * ar);
 
     //Resolve RelocInfo. 'is_notype' dedicated whether 'symbol_info' is
     //with 'STT_NOTYPE' attribute. Since the 'STT_NOTYPE' symbol can be
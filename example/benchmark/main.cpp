@@ -0,0 +1,1078 @@
+/*@
+XOC Release License
+
+Copyright (c) 2013-2014, Alibaba Group, All rights reserved.
+
+compiler@aliexpress.com
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+* Neither the name of the Su Zhenyu nor the names of its contributors
+may be used to endorse or promote products derived from this software
+without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+author: Su Zhenyu
+@*/
+#include <time.h>
+#include "../../opt/cominc.h"
+#include "../../opt/comopt.h"
+#include "../../reader/grreader.h"
+
+//Benchmark of the whole optimization pipeline.
+//The benchmark feeds synthetic and user given GR files through
+//readGRAndConstructRegion() and Region::process() of program region at
+//each optimization level, then reports wall time, memory peak, IR count
+//and the time of each pass. Results can be stored as baseline, and later runs are compared
+//with the baseline to detect regressions.
+
+#define BENCH_MAX_LEVEL OPT_LEVEL3
+#define BENCH_DEF_THRESHOLD 10 //percent
+#define BENCH_MIN_NOISE_MS 2.0 //ignore time difference less than it.
+#define BENCH_MAX_NAME_LEN 127
+#define BENCH_MIN_IPA_LEVEL OPT_LEVEL2 //inlining and IPA start from it.
+
+//Describe the shape of synthetic GR file.
+typedef struct {
+    CHAR const* name;
+    UINT func_num; //the number of function regions.
+    UINT nest_num; //the number of sequential loop nests in each function.
+    UINT depth; //the depth of each loop nest.
+    UINT stmt_num; //the number of stmts in each loop level.
+} SynthCase;
+
+static SynthCase const g_synth_case[] = {
+    { "synth_small", 8, 1, 1, 4 },
+    { "synth_medium", 32, 4, 2, 8 },
+    { "synth_deep_loop", 4, 2, 10, 4 },
+    { "synth_wide_func", 2, 64, 2, 16 },
+    //More than 100k IR in one function.
+    { "synth_huge_func", 1, 480, 3, 8 },
+};
+
+class BenchResult {
+public:
+    CHAR name[BENCH_MAX_NAME_LEN + 1];
+    INT level;
+    double wall_ms;
+    double peak_kb;
+    ULONGLONG sys_kb;
+    UINT ir_num;
+    UINT input_ir_num; //the number of IR before processing.
+    UINT input_max_func_ir_num; //input IR of the largest function.
+    bool succ;
+};
+
+class BenchOption {
+public:
+    bool use_synth;
+    bool enable_all_pass;
+    bool enable_ipa;
+    bool enable_prof;
+    bool update_baseline;
+    bool mdssa_on_demand; //build MDSSA on demand.
+    bool cmp_mdssa; //compare on-demand MDSSA with full MDSSA.
+    bool cmp_dom; //compare Semi-NCA dominator with iterative dominator.
+    bool cmp_solver; //compare worklist DU solver with iterative solver.
+    bool level[BENCH_MAX_LEVEL + 1];
+    UINT repeat;
+    UINT thread_num;
+    double threshold;
+    CHAR const* synth_dir;
+    CHAR const* baseline;
+    CHAR const* report;
+    CHAR const* trace_dir;
+    xcom::Vector<CHAR const*> files;
+public:
+    BenchOption()
+    {
+        use_synth = true;
+        enable_all_pass = false;
+        enable_ipa = true;
+        enable_prof = true;
+        update_baseline = false;
+        mdssa_on_demand = false;
+        cmp_mdssa = false;
+        cmp_dom = false;
+        cmp_solver = false;
+        for (INT i = 0; i <= BENCH_MAX_LEVEL; i++) { level[i] = false; }
+        repeat = 1;
+        thread_num = 1;
+        threshold = BENCH_DEF_THRESHOLD;
+        synth_dir = ".";
+        baseline = nullptr;
+        report = "bench_report.txt";
+        trace_dir = nullptr;
+    }
+};
+
+
+static void genStmt(FILE * h, UINT indent, UINT idx)
+{
+    switch (idx % 4) {
+    case 0:
+        fprintf(h, "%*sst:i32 s = add:i32 (ld:i32 s), "
+                "(mul:i32 (ld:i32 t), (ld:i32 n));\n", indent, "");
+        break;
+    case 1:
+        fprintf(h, "%*sst:i32 g = add:i32 (mul:i32 (ld:i32 t), (ld:i32 n)), "
+                "(ld:i32 s);\n", indent, "");
+        break;
+    case 2:
+        fprintf(h, "%*sif (gt:bool (ld:i32 s), %u:i32) { "
+                "st:i32 t = add:i32 (ld:i32 t), 1:i32; } else { "
+                "st:i32 t = sub:i32 (ld:i32 t), (ld:i32 g); };\n",
+                indent, "", idx);
+        break;
+    default:
+        fprintf(h, "%*sist:i32 = (ld:*<4> p), "
+                "(add:i32 (ld:i32 s), (ld:i32 t));\n", indent, "");
+    }
+}
+
+
+static void genLoopNest(FILE * h, SynthCase const& sc, UINT indent,
+                        UINT level)
+{
+    fprintf(h, "%*sst:i32 i%u = 0:i32;\n", indent, "", level);
+    fprintf(h, "%*swhile (lt:bool (ld:i32 i%u), (ld:i32 n)) {\n",
+            indent, "", level);
+    for (UINT i = 0; i < sc.stmt_num; i++) {
+        genStmt(h, indent + 4, i + level);
+    }
+    if (level + 1 < sc.depth) {
+        genLoopNest(h, sc, indent + 4, level + 1);
+    }
+    fprintf(h, "%*sst:i32 i%u = add:i32 (ld:i32 i%u), 1:i32;\n",
+            indent + 4, "", level, level);
+    fprintf(h, "%*s};\n", indent, "");
+}
+
+
+//Generate a call to leaf function after loop nest 'nest', the call is
+//the candidate of inlining.
+static void genCall(FILE * h, UINT indent, UINT nest)
+{
+    fprintf(h, "%*scall $r%u:i32 = leaf(ld:i32 s);\n", indent, "", nest + 1);
+    fprintf(h, "%*sst:i32 s = add:i32 (ld:i32 s), $r%u:i32;\n",
+            indent, "", nest + 1);
+}
+
+
+//Generate GR file according to the shape of 'sc'.
+static bool genSynthGR(SynthCase const& sc, CHAR const* filename)
+{
+    FILE * h = ::fopen(filename, "w");
+    if (h == nullptr) { return false; }
+    fprintf(h, "region program \"program\" () {\n");
+    fprintf(h, "    var g:i32:(align(4));\n");
+    fprintf(h, "    var leaf:any:(func, align(4));\n");
+    fprintf(h, "    region func leaf (var a:i32:(align(4))) {\n");
+    fprintf(h, "        var r:i32:(align(4));\n");
+    fprintf(h, "        st:i32 r = add:i32 (ld:i32 a), (ld:i32 g);\n");
+    fprintf(h, "        return (ld:i32 r);\n");
+    fprintf(h, "    };\n");
+    for (UINT f = 0; f < sc.func_num; f++) {
+        fprintf(h, "    region func f%u (var n:i32:(align(4)), "
+                "var p:*<4>:(align(4))) {\n", f);
+        for (UINT d = 0; d < sc.depth; d++) {
+            fprintf(h, "        var i%u:i32:(align(4));\n", d);
+        }
+        fprintf(h, "        var s:i32:(align(4));\n");
+        fprintf(h, "        var t:i32:(align(4));\n");
+        fprintf(h, "        st:i32 s = 0:i32;\n");
+        fprintf(h, "        st:i32 t = %u:i32;\n", f);
+        for (UINT k = 0; k < sc.nest_num; k++) {
+            genLoopNest(h, sc, 8, 0);
+            genCall(h, 8, k);
+        }
+        fprintf(h, "        return (ld:i32 s);\n");
+        fprintf(h, "    };\n");
+    }
+    fprintf(h, "}\n");
+    ::fclose(h);
+    return true;
+}
+
+
+static UINT countIRTree(IR const* ir)
+{
+    UINT n = 0;
+    for (; ir != nullptr; ir = ir->get_next()) {
+        n++;
+        for (UINT i = 0; i < IR_MAX_KID_NUM(ir); i++) {
+            n += countIRTree(ir->getKid(i));
+        }
+    }
+    return n;
+}
+
+
+//Count the number of IR in 'rg'.
+static UINT countRegionIR(Region * rg)
+{
+    if (rg->getIRList() != nullptr) {
+        return countIRTree(rg->getIRList());
+    }
+    BBList * bbl = rg->getBBList();
+    if (bbl == nullptr) { return 0; }
+    UINT n = 0;
+    BBListIter bbit;
+    for (IRBB * bb = bbl->get_head(&bbit);
+         bb != nullptr; bb = bbl->get_next(&bbit)) {
+        BBIRListIter irit;
+        for (IR * ir = bb->getIRList().get_head(&irit);
+             ir != nullptr; ir = bb->getIRList().get_next(&irit)) {
+            //Count stmt and its kids, but not the sibling stmts.
+            n += 1;
+            for (UINT k = 0; k < IR_MAX_KID_NUM(ir); k++) {
+                n += countIRTree(ir->getKid(k));
+            }
+        }
+    }
+    return n;
+}
+
+
+//Count the number of IR in all function regions.
+//maxfunc: record the number of IR in the largest function region.
+static UINT countIR(RegionMgr * rm, OUT UINT & maxfunc)
+{
+    UINT n = 0;
+    maxfunc = 0;
+    for (UINT i = 0; i < rm->getNumOfRegion(); i++) {
+        Region * rg = rm->getRegion(i);
+        if (rg == nullptr || !rg->is_function() || !rg->hasAnaInstrument()) {
+            continue;
+        }
+        UINT cur = countRegionIR(rg);
+        maxfunc = MAX(maxfunc, cur);
+        n += cur;
+    }
+    return n;
+}
+
+
+static double getWallMS()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+
+static void setOptLevel(INT level, BenchOption const& opt)
+{
+    g_opt_level = level;
+    bool do_ipa = opt.enable_ipa && level >= BENCH_MIN_IPA_LEVEL;
+    g_do_inline = do_ipa;
+    g_do_ipa = do_ipa;
+    g_do_ipa_modref = do_ipa;
+    if (!opt.enable_all_pass) { return; }
+    g_do_prssa = true;
+    g_do_mdssa = true;
+    g_do_cp = true;
+    g_do_dce = true;
+    g_do_rce = true;
+    g_do_licm = true;
+    g_do_rp = true;
+    g_do_gcse = true;
+    g_do_pre = true;
+    g_do_gvn = true;
+    g_do_lcse = true;
+    g_do_ivr = true;
+}
+
+
+//Dump GR of program region and its inner regions into 'dumpfile'.
+static void dumpProgramGR(RegionMgr * rm, Region const* program,
+                          CHAR const* dumpfile)
+{
+    FILE * h = ::fopen(dumpfile, "w");
+    if (h == nullptr) { return; }
+    LogMgr * lm = rm->getLogMgr();
+    lm->push(h, dumpfile);
+    program->dumpGR(true);
+    lm->pop();
+    ::fclose(h);
+}
+
+
+//The checker inspects each function region after the pipeline, the
+//pass manager of region is retained for it.
+class RegionChecker {
+public:
+    virtual ~RegionChecker() {}
+
+    //Return false if the check of 'rg' failed.
+    virtual bool check(Region * rg) = 0;
+};
+
+
+//Apply 'checker' to function regions.
+//Return false if any check failed.
+static bool checkFuncRegion(RegionMgr * rm, RegionChecker & checker)
+{
+    bool succ = true;
+    for (UINT i = 0; i < rm->getNumOfRegion(); i++) {
+        Region * rg = rm->getRegion(i);
+        if (rg == nullptr || !rg->is_function() ||
+            rg->getPassMgr() == nullptr || rg->getCFG() == nullptr) {
+            continue;
+        }
+        succ &= checker.check(rg);
+    }
+    return succ;
+}
+
+
+//Run the whole pipeline once.
+//dumpfile: if it is not NULL, dump GR of program region into the file after
+//          optimization, the dumping is not measured.
+//checker: if it is not NULL, apply it to function regions after
+//         optimization, the checking is not measured.
+static bool runOnce(CHAR const* grfile, CHAR const* name, INT level,
+                    BenchOption const& opt, FILE * report,
+                    OUT BenchResult & res, CHAR const* dumpfile = nullptr,
+                    RegionChecker * checker = nullptr)
+{
+    setOptLevel(level, opt);
+    g_thread_num = opt.thread_num;
+    g_process_func_region_in_program = true;
+    if (checker != nullptr) { g_retain_pass_mgr_for_region = true; }
+    g_do_prof = opt.enable_prof;
+    StrBuf trace(64);
+    g_prof_trace_file = nullptr;
+    if (opt.enable_prof && opt.trace_dir != nullptr) {
+        trace.sprint("%s/%s.O%d.json", opt.trace_dir, name, level);
+        g_prof_trace_file = trace.buf;
+    }
+    Profiler::clean();
+
+    //Function regions may be processed by worker threads, thus the peak
+    //is measured over memory of all threads.
+    ULONGLONG sys = g_stat_mem_size;
+    xcom::smpoolResetTotalMemPeak();
+    LONGLONG mem = xcom::smpoolGetTotalMemSize();
+    double start = getWallMS();
+
+    RegionMgr * rm = new RegionMgr();
+    rm->initVarMgr();
+    rm->initIRDescFlagSet();
+    bool succ = readGRAndConstructRegion(rm, grfile);
+    Region * program = nullptr;
+    for (UINT i = 0; succ && i < rm->getNumOfRegion(); i++) {
+        Region * rg = rm->getRegion(i);
+        if (rg != nullptr && rg->is_program()) { program = rg; break; }
+    }
+    //Counting input IR is excluded from the wall time.
+    double count_start = getWallMS();
+    res.input_max_func_ir_num = 0;
+    res.input_ir_num = succ ? countIR(rm, res.input_max_func_ir_num) : 0;
+    start += getWallMS() - count_start;
+    if (program != nullptr) {
+        //Pipeline may report false if some pass bails out, the result is
+        //still measured.
+        rm->processProgramRegion(program, rm->getAndGenOptCtx(program));
+    } else {
+        succ = false;
+    }
+
+    res.wall_ms = getWallMS() - start;
+    res.peak_kb = (double)(xcom::smpoolGetTotalMemPeak() - mem) / 1024.0;
+    res.sys_kb = (g_stat_mem_size - sys) / 1024;
+    UINT maxfunc = 0;
+    res.ir_num = succ ? countIR(rm, maxfunc) : 0;
+    res.succ = succ;
+    if (succ && dumpfile != nullptr) { dumpProgramGR(rm, program, dumpfile); }
+    if (succ && checker != nullptr) {
+        succ = checkFuncRegion(rm, *checker);
+        res.succ = succ;
+    }
+    res.level = level;
+    ::snprintf(res.name, BENCH_MAX_NAME_LEN, "%s", name);
+    if (report != nullptr && opt.enable_prof) {
+        fprintf(report, "\n==---- CASE %s -O%d: %.3fms ----==", name, level,
+                res.wall_ms);
+        fprintf(report, "\ninput IR:%u, input IR of largest function:%u, "
+                "IR after processing:%u", res.input_ir_num,
+                res.input_max_func_ir_num, res.ir_num);
+        Profiler::dumpTable(report);
+    }
+    if (g_prof_trace_file != nullptr) {
+        Profiler::dumpChromeTrace(g_prof_trace_file);
+    }
+    Profiler::clean();
+    delete rm;
+    g_prof_trace_file = nullptr;
+    return succ;
+}
+
+
+static bool runCase(CHAR const* grfile, CHAR const* name,
+                    BenchOption const& opt, FILE * report,
+                    MOD xcom::Vector<BenchResult*> & results)
+{
+    bool succ = true;
+    for (INT level = OPT_LEVEL0; level <= BENCH_MAX_LEVEL; level++) {
+        if (!opt.level[level]) { continue; }
+        BenchResult * best = new BenchResult();
+        for (UINT r = 0; r < opt.repeat; r++) {
+            BenchResult cur;
+            //Only the report of first run is recorded.
+            succ &= runOnce(grfile, name, level, opt,
+                            r == 0 ? report : nullptr, cur);
+            if (r == 0 || cur.wall_ms < best->wall_ms) { *best = cur; }
+        }
+        results.append(best);
+        printf("\n%-24s -O%d %10.3fms peak:%10.1fKB sys:%8lluKB IR:%8u%s",
+               name, level, best->wall_ms, best->peak_kb, best->sys_kb,
+               best->ir_num, best->succ ? "" : " (FAILED)");
+        fflush(stdout);
+    }
+    return succ;
+}
+
+
+static INT cmpLine(void const* a, void const* b)
+{
+    return ::strcmp(*(CHAR const**)a, *(CHAR const**)b);
+}
+
+
+//Read lines of GR file into 'lines' and replace PR number with '$'.
+//Return the number of lines, or -1 if the file can not be opened.
+static INT readNormalizedGR(CHAR const* filename,
+                            OUT xcom::Vector<CHAR*> & lines)
+{
+    FILE * h = ::fopen(filename, "r");
+    if (h == nullptr) { return -1; }
+    CHAR buf[1024];
+    INT n = 0;
+    while (::fgets(buf, sizeof(buf), h) != nullptr) {
+        CHAR * line = (CHAR*)::malloc(::strlen(buf) + 1);
+        ASSERT0(line);
+        CHAR * q = line;
+        for (CHAR const* p = buf; *p != 0; p++) {
+            *q++ = *p;
+            if (*p != '$') { continue; }
+            while (p[1] >= '0' && p[1] <= '9') { p++; }
+        }
+        *q = 0;
+        lines.set((VecIdx)n, line);
+        n++;
+    }
+    ::fclose(h);
+    return n;
+}
+
+
+//Return true if the two GR files describe the same optimization result.
+//Stmts are compared regardless of their order and the number of PRs,
+//because the order that passes visit the DU chain may be different
+//between the two modes, e.g:LICM may hoist invariants in different order.
+static bool isSameGR(CHAR const* f1, CHAR const* f2)
+{
+    xcom::Vector<CHAR*> l1;
+    xcom::Vector<CHAR*> l2;
+    INT n1 = readNormalizedGR(f1, l1);
+    INT n2 = readNormalizedGR(f2, l2);
+    bool same = n1 >= 0 && n1 == n2;
+    if (same && n1 > 0) {
+        ::qsort(l1.get_vec(), (size_t)n1, sizeof(CHAR*), cmpLine);
+        ::qsort(l2.get_vec(), (size_t)n2, sizeof(CHAR*), cmpLine);
+    }
+    for (INT i = 0; same && i < n1; i++) {
+        same = ::strcmp(l1.get((VecIdx)i), l2.get((VecIdx)i)) == 0;
+    }
+    for (INT i = 0; i < n1; i++) { ::free(l1.get((VecIdx)i)); }
+    for (INT i = 0; i < n2; i++) { ::free(l2.get((VecIdx)i)); }
+    return same;
+}
+
+
+//Run the case with full MDSSA and on-demand MDSSA, then check whether
+//the optimized GR of the two modes are identical, and report the time and
+//memory of both modes.
+static bool cmpMDSSACase(CHAR const* grfile, CHAR const* name,
+                         BenchOption const& opt)
+{
+    bool succ = true;
+    for (INT level = OPT_LEVEL0; level <= BENCH_MAX_LEVEL; level++) {
+        if (!opt.level[level]) { continue; }
+        StrBuf full_file(64);
+        StrBuf od_file(64);
+        full_file.sprint("%s/%s.O%d.full.gr", opt.synth_dir, name, level);
+        od_file.sprint("%s/%s.O%d.ondemand.gr", opt.synth_dir, name, level);
+        BenchResult full;
+        BenchResult od;
+        g_mdssa_build_on_demand = false;
+        bool s = runOnce(grfile, name, level, opt, nullptr, full,
+                         full_file.buf);
+        g_mdssa_build_on_demand = true;
+        s &= runOnce(grfile, name, level, opt, nullptr, od, od_file.buf);
+        g_mdssa_build_on_demand = opt.mdssa_on_demand;
+        bool same = s && isSameGR(full_file.buf, od_file.buf);
+        printf("\n%-24s -O%d full:%10.3fms peak:%10.1fKB "
+               "on-demand:%10.3fms peak:%10.1fKB %s",
+               name, level, full.wall_ms, full.peak_kb, od.wall_ms,
+               od.peak_kb, same ? "SAME" : "MISMATCH");
+        if (!same) {
+            printf("\n  see %s and %s", full_file.buf, od_file.buf);
+        } else {
+            UNLINK(full_file.buf);
+            UNLINK(od_file.buf);
+        }
+        fflush(stdout);
+        succ &= same;
+    }
+    return succ;
+}
+
+
+//The checker computes the dominators of each function region that has at
+//least g_semi_nca_min_bb_num BBs twice, once iteratively and once by
+//Semi-NCA, then checks that the idom, the dominator-set and the answer of
+//is_dom() of every pair of BBs are identical.
+class DomChecker : public RegionChecker {
+    COPY_CONSTRUCTOR(DomChecker);
+public:
+    UINT func_num; //the number of compared function regions.
+    UINT max_bb_num; //the max number of BB in function regions.
+    UINT mismatch_num; //the number of BBs that have different DOM info.
+    double iter_ms; //time of iterative algorithm.
+    double semi_ms; //time of Semi-NCA algorithm.
+protected:
+    //Recompute DOM info of 'rg' by given algorithm, return the time.
+    double computeDom(Region * rg, bool by_semi_nca)
+    {
+        g_compute_dom_by_semi_nca = by_semi_nca;
+        OptCtx * oc = rg->getRegionMgr()->getAndGenOptCtx(rg);
+        oc->setInvalidPass(PASS_DOM);
+        double start = getWallMS();
+        rg->getPassMgr()->checkValidAndRecompute(oc, PASS_CFG, PASS_RPO,
+                                                 PASS_DOM, PASS_UNDEF);
+        return getWallMS() - start;
+    }
+public:
+    DomChecker()
+    {
+        func_num = 0;
+        max_bb_num = 0;
+        mismatch_num = 0;
+        iter_ms = 0;
+        semi_ms = 0;
+    }
+
+    virtual bool check(Region * rg)
+    {
+        //Query DOM info by vertex id.
+        xcom::DGraph const* cfg = rg->getCFG();
+        UINT bbnum = rg->getBBList()->get_elem_count();
+        max_bb_num = MAX(max_bb_num, bbnum);
+        if (bbnum < g_semi_nca_min_bb_num) { return true; }
+        func_num++;
+        bool org_semi_nca = g_compute_dom_by_semi_nca;
+        xcom::Vector<VexIdx> bbid;
+        BBListIter it;
+        for (IRBB const* bb = rg->getBBList()->get_head(&it);
+             bb != nullptr; bb = rg->getBBList()->get_next(&it)) {
+            bbid.append(bb->id());
+        }
+
+        //Record the result of iterative algorithm.
+        iter_ms += computeDom(rg, false);
+        ASSERT0(!cfg->isDomSetLazy());
+        xcom::BitSetMgr bsmgr;
+        xcom::Vector<VexIdx> idom;
+        xcom::Vector<xcom::BitSet*> domset;
+        for (VecIdx i = 0; i <= bbid.get_last_idx(); i++) {
+            VexIdx v = bbid.get(i);
+            idom.set(v, cfg->get_idom(v));
+            xcom::BitSet * set = bsmgr.create();
+            if (cfg->get_dom_set(v) != nullptr) {
+                set->copy(*cfg->get_dom_set(v));
+            }
+            domset.set(v, set);
+        }
+
+        //Dominance query is answered by interval numbers before the
+        //dominator-set is materialized.
+        semi_ms += computeDom(rg, true);
+        g_compute_dom_by_semi_nca = org_semi_nca;
+        ASSERT0(cfg->isDomSetLazy());
+        UINT mismatch = 0;
+        for (VecIdx i = 0; i <= bbid.get_last_idx(); i++) {
+            VexIdx v = bbid.get(i);
+            bool same = cfg->get_idom(v) == idom.get(v);
+            for (VecIdx j = 0; same && j <= bbid.get_last_idx(); j++) {
+                VexIdx u = bbid.get(j);
+                same = cfg->is_dom(u, v) == domset.get(v)->is_contain(u);
+            }
+            if (!same) { mismatch++; }
+        }
+        for (VecIdx i = 0; i <= bbid.get_last_idx(); i++) {
+            VexIdx v = bbid.get(i);
+            xcom::BitSet const* set = cfg->get_dom_set(v);
+            if (set == nullptr ? !domset.get(v)->is_empty() :
+                !set->is_equal(*domset.get(v))) {
+                mismatch++;
+            }
+        }
+        mismatch_num += mismatch;
+        return mismatch == 0;
+    }
+};
+
+
+//Run the case and check that Semi-NCA computes the same dominators as
+//the iterative algorithm on large CFGs, and report the time of both.
+static bool cmpDomCase(CHAR const* grfile, CHAR const* name,
+                       BenchOption const& opt)
+{
+    bool succ = true;
+    for (INT level = OPT_LEVEL0; level <= BENCH_MAX_LEVEL; level++) {
+        if (!opt.level[level]) { continue; }
+        BenchResult res;
+        DomChecker checker;
+        bool s = runOnce(grfile, name, level, opt, nullptr, res, nullptr,
+                         &checker);
+        printf("\n%-24s -O%d func:%u max BB:%u iterative:%10.3fms "
+               "semi-nca:%10.3fms mismatch:%u %s", name, level,
+               checker.func_num, checker.max_bb_num, checker.iter_ms,
+               checker.semi_ms, checker.mismatch_num,
+               s ? "SAME" : "MISMATCH");
+        fflush(stdout);
+        succ &= s;
+    }
+    return succ;
+}
+
+
+//The kind of IN/OUT set that is compared between DU solvers.
+typedef enum {
+    SOL_REACH_DEF_IN = 0,
+    SOL_REACH_DEF_OUT,
+    SOL_AVAIL_REACH_DEF_IN,
+    SOL_AVAIL_REACH_DEF_OUT,
+    SOL_AVAIL_EXPR_IN,
+    SOL_AVAIL_EXPR_OUT,
+    SOL_NUM,
+} SOL_KIND;
+
+class SolverChecker : public RegionChecker {
+    COPY_CONSTRUCTOR(SolverChecker);
+public:
+    UINT func_num; //the number of solved function regions.
+    UINT set_num; //the number of compared non-empty IN/OUT sets.
+    UINT mismatch_num; //the number of IN/OUT sets that are different.
+    UINT rpo_visit; //transfer functions evaluated by iterative solver.
+    UINT wl_visit; //transfer functions evaluated by worklist solver.
+    double rpo_ms; //time of iterative solver.
+    double wl_ms; //time of worklist solver.
+protected:
+    static SolveSet * getSet(SolveSetMgr const* mgr, UINT kind, UINT bbid)
+    {
+        switch (kind) {
+        case SOL_REACH_DEF_IN: return mgr->getReachDefIn(bbid);
+        case SOL_REACH_DEF_OUT: return mgr->getReachDefOut(bbid);
+        case SOL_AVAIL_REACH_DEF_IN: return mgr->getAvailReachDefIn(bbid);
+        case SOL_AVAIL_REACH_DEF_OUT: return mgr->getAvailReachDefOut(bbid);
+        case SOL_AVAIL_EXPR_IN: return mgr->getAvailExprIn(bbid);
+        case SOL_AVAIL_EXPR_OUT: return mgr->getAvailExprOut(bbid);
+        default: UNREACHABLE();
+        }
+        return nullptr;
+    }
+
+    //Keep all compared sets as GlobalSet, or restore them to LocalSet
+    //except ReachDefIn which is always kept for DU chain.
+    static void setKeepAll(SolveSetMgr * mgr, bool keep)
+    {
+        if (!keep) {
+            mgr->resetReachDefOutIfGlobal();
+            mgr->resetAvailReachDefInIfGlobal();
+            mgr->resetAvailReachDefOutIfGlobal();
+            mgr->resetAvailExprInIfGlobal();
+            mgr->resetAvailExprOutIfGlobal();
+        }
+        mgr->setKeepReachDefOut(keep);
+        mgr->setKeepAvailReachDefIn(keep);
+        mgr->setKeepAvailReachDefOut(keep);
+        mgr->setKeepAvailExprIn(keep);
+        mgr->setKeepAvailExprOut(keep);
+    }
+
+    //Solve IN/OUT sets of 'rg' by given solver, return the time.
+    //Return a negative value if DUMgr did not solve the region.
+    double solve(Region * rg, OptCtx * oc, bool by_worklist,
+                 OUT UINT & visit)
+    {
+        DUMgr * dumgr = rg->getDUMgr();
+        SolveSetMgr * mgr = dumgr->getSolveSetMgr();
+        mgr->resetGlobalSet();
+        g_solve_du_set_by_worklist = by_worklist;
+        double start = getWallMS();
+        bool solved = dumgr->perform(*oc, DUOptFlag(DUOPT_SOL_REACH_DEF|
+            DUOPT_SOL_AVAIL_REACH_DEF|DUOPT_SOL_AVAIL_EXPR));
+        double t = getWallMS() - start;
+        visit += mgr->getStat().visit_num;
+        return solved ? t : -1.0;
+    }
+public:
+    SolverChecker()
+    {
+        func_num = 0;
+        set_num = 0;
+        mismatch_num = 0;
+        rpo_visit = 0;
+        wl_visit = 0;
+        rpo_ms = 0;
+        wl_ms = 0;
+    }
+
+    virtual bool check(Region * rg)
+    {
+        //The solver needs MD reference of each IR, whereas all flags
+        //have been invalidated after the region processed.
+        OptCtx * oc = rg->getRegionMgr()->getAndGenOptCtx(rg);
+        rg->getPassMgr()->checkValidAndRecompute(oc, PASS_CFG, PASS_RPO,
+                                                 PASS_UNDEF);
+        if (!rg->doAA(*oc)) { return true; }
+        rg->getPassMgr()->checkValidAndRecompute(oc, PASS_MD_REF,
+                                                 PASS_UNDEF);
+        DUMgr * dumgr = rg->getDUMgr();
+        if (dumgr == nullptr || !oc->is_ref_valid()) { return true; }
+        SolveSetMgr * mgr = dumgr->getSolveSetMgr();
+        bool org_worklist = g_solve_du_set_by_worklist;
+        setKeepAll(mgr, true);
+
+        //Record the result of iterative solver.
+        double t = solve(rg, oc, false, rpo_visit);
+        if (t < 0) {
+            g_solve_du_set_by_worklist = org_worklist;
+            setKeepAll(mgr, false);
+            return true;
+        }
+        func_num++;
+        rpo_ms += t;
+        xcom::DefMiscBitSetMgr bsmgr;
+        xcom::Vector<DefDBitSetCore*> rpo_set;
+        BBList * bbl = rg->getBBList();
+        BBListIter it;
+        for (IRBB const* bb = bbl->get_head(&it);
+             bb != nullptr; bb = bbl->get_next(&it)) {
+            for (UINT k = SOL_REACH_DEF_IN; k < SOL_NUM; k++) {
+                SolveSet const* set = getSet(mgr, k, bb->id());
+                if (set == nullptr) { continue; }
+                DefDBitSetCore * cp = bsmgr.allocDBitSetCore();
+                cp->copy(*set, bsmgr);
+                rpo_set.set(bb->id() * SOL_NUM + k, cp);
+            }
+        }
+
+        //Compare with the result of worklist solver.
+        wl_ms += MAX(0.0, solve(rg, oc, true, wl_visit));
+        g_solve_du_set_by_worklist = org_worklist;
+        UINT mismatch = 0;
+        for (IRBB const* bb = bbl->get_head(&it);
+             bb != nullptr; bb = bbl->get_next(&it)) {
+            for (UINT k = SOL_REACH_DEF_IN; k < SOL_NUM; k++) {
+                SolveSet const* set = getSet(mgr, k, bb->id());
+                DefDBitSetCore const* cp = rpo_set.get(bb->id() * SOL_NUM + k);
+                bool set_empty = set == nullptr || set->is_empty();
+                bool cp_empty = cp == nullptr || cp->is_empty();
+                if (set_empty && cp_empty) { continue; }
+                set_num++;
+                if (set_empty || cp_empty || !set->is_equal(*cp)) {
+                    mismatch++;
+                }
+            }
+        }
+        for (VecIdx i = 0; i <= rpo_set.get_last_idx(); i++) {
+            DefDBitSetCore * cp = rpo_set.get(i);
+            if (cp == nullptr) { continue; }
+            cp->clean(bsmgr);
+            bsmgr.freeDBitSetCore(cp);
+        }
+        setKeepAll(mgr, false);
+        mismatch_num += mismatch;
+        return mismatch == 0;
+    }
+};
+
+
+//Run the case and check that the worklist solver computes the same IN/OUT
+//sets of DU analysis as the iterative solver, and report both.
+static bool cmpSolverCase(CHAR const* grfile, CHAR const* name,
+                          BenchOption const& opt)
+{
+    bool succ = true;
+    for (INT level = OPT_LEVEL0; level <= BENCH_MAX_LEVEL; level++) {
+        if (!opt.level[level]) { continue; }
+        BenchResult res;
+        SolverChecker checker;
+        bool s = runOnce(grfile, name, level, opt, nullptr, res, nullptr,
+                         &checker);
+        printf("\n%-24s -O%d func:%u set:%u iterative:%10.3fms visit:%u "
+               "worklist:%10.3fms visit:%u mismatch:%u %s", name, level,
+               checker.func_num, checker.set_num, checker.rpo_ms,
+               checker.rpo_visit, checker.wl_ms, checker.wl_visit,
+               checker.mismatch_num, s ? "SAME" : "MISMATCH");
+        fflush(stdout);
+        succ &= s;
+    }
+    return succ;
+}
+
+
+//Run the case in the mode that is selected by 'opt'.
+static bool runCaseByMode(CHAR const* grfile, CHAR const* name,
+                          BenchOption const& opt, FILE * report,
+                          MOD xcom::Vector<BenchResult*> & results)
+{
+    if (opt.cmp_mdssa) { return cmpMDSSACase(grfile, name, opt); }
+    if (opt.cmp_dom) { return cmpDomCase(grfile, name, opt); }
+    if (opt.cmp_solver) { return cmpSolverCase(grfile, name, opt); }
+    return runCase(grfile, name, opt, report, results);
+}
+
+
+static BenchResult const* findResult(
+    xcom::Vector<BenchResult*> const& results, CHAR const* name, INT level)
+{
+    for (VecIdx i = 0; i <= results.get_last_idx(); i++) {
+        BenchResult const* r = results.get(i);
+        if (r->level == level && ::strcmp(r->name, name) == 0) { return r; }
+    }
+    return nullptr;
+}
+
+
+static bool writeBaseline(CHAR const* filename,
+                          xcom::Vector<BenchResult*> const& results)
+{
+    FILE * h = ::fopen(filename, "w");
+    if (h == nullptr) { return false; }
+    fprintf(h, "#name level wall_ms peak_kb ir_num\n");
+    for (VecIdx i = 0; i <= results.get_last_idx(); i++) {
+        BenchResult const* r = results.get(i);
+        fprintf(h, "%s %d %.3f %.1f %u\n", r->name, r->level, r->wall_ms,
+                r->peak_kb, r->ir_num);
+    }
+    ::fclose(h);
+    return true;
+}
+
+
+//Return the number of regressions.
+static UINT compareBaseline(CHAR const* filename, double threshold,
+                            xcom::Vector<BenchResult*> const& results)
+{
+    FILE * h = ::fopen(filename, "r");
+    if (h == nullptr) {
+        printf("\ncan not open baseline %s", filename);
+        return 0;
+    }
+    UINT regress = 0;
+    CHAR line[256];
+    double ratio = 1.0 + threshold / 100.0;
+    printf("\n\n==---- COMPARE WITH BASELINE %s ----==", filename);
+    while (::fgets(line, sizeof(line), h) != nullptr) {
+        if (line[0] == '#') { continue; }
+        CHAR name[BENCH_MAX_NAME_LEN + 1];
+        INT level;
+        double wall_ms;
+        double peak_kb;
+        UINT ir_num;
+        if (::sscanf(line, "%127s %d %lf %lf %u", name, &level, &wall_ms,
+                     &peak_kb, &ir_num) != 5) {
+            continue;
+        }
+        BenchResult const* r = findResult(results, name, level);
+        if (r == nullptr) { continue; }
+        if (r->wall_ms > wall_ms * ratio &&
+            r->wall_ms - wall_ms > BENCH_MIN_NOISE_MS) {
+            printf("\nREGRESSION: %s -O%d time %.3fms -> %.3fms",
+                   name, level, wall_ms, r->wall_ms);
+            regress++;
+        }
+        if (r->peak_kb > peak_kb * ratio) {
+            printf("\nREGRESSION: %s -O%d memory peak %.1fKB -> %.1fKB",
+                   name, level, peak_kb, r->peak_kb);
+            regress++;
+        }
+        if (r->ir_num != ir_num) {
+            //The change of IR count is not regarded as regression, it
+            //reflects the change of optimization result.
+            printf("\nCHANGED: %s -O%d IR count %u -> %u",
+                   name, level, ir_num, r->ir_num);
+        }
+    }
+    ::fclose(h);
+    printf("\n%u regression(s) found", regress);
+    return regress;
+}
+
+
+static void usage()
+{
+    printf("\nBenchmark of the whole optimization pipeline over GR files."
+           "\nbenchmark.exe [options] [gr-file ...]"
+           "\n  -O<n>              run opt level n, can be repeated, "
+           "default is all levels"
+           "\n  -all               enable all scalar optimizations"
+           "\n  -noipa             do not run inlining and IPA at O2 and above"
+           "\n  -nosynth           do not run synthetic corpus"
+           "\n  -synthdir <dir>    directory to generate synthetic corpus"
+           "\n  -repeat <n>        run each case n times, keep the fastest"
+           "\n  -thread <n>        the number of threads to process regions"
+           "\n  -noprof            do not record per-pass profile"
+           "\n  -mdssa_ondemand    build the MDSSA of alias class on demand"
+           "\n  -cmpmdssa          check that on-demand MDSSA produces the "
+           "same GR as\n                     full MDSSA, and report both"
+           "\n  -cmpdom            check that Semi-NCA computes the same "
+           "dominators\n                     as the iterative algorithm on "
+           "function with at\n                     least "
+           "g_semi_nca_min_bb_num BBs"
+           "\n  -cmpsolver         check that worklist DU solver computes the "
+           "same\n                     IN/OUT sets as the iterative solver"
+           "\n  -report <file>     file of per-pass profile tables"
+           "\n  -tracedir <dir>    emit Chrome trace of each case into dir"
+           "\n  -baseline <file>   compare results with baseline file"
+           "\n  -update            write results into baseline file"
+           "\n  -threshold <pct>   tolerance of regression, default %d"
+           "\n", BENCH_DEF_THRESHOLD);
+}
+
+
+static bool parseOption(INT argc, CHAR * argv[], OUT BenchOption & opt)
+{
+    bool has_level = false;
+    for (INT i = 1; i < argc; i++) {
+        CHAR const* a = argv[i];
+        bool has_next = i + 1 < argc;
+        if (a[0] == '-' && a[1] == 'O' && a[2] >= '0' &&
+            a[2] <= '0' + BENCH_MAX_LEVEL && a[3] == 0) {
+            opt.level[a[2] - '0'] = true;
+            has_level = true;
+        } else if (::strcmp(a, "-all") == 0) {
+            opt.enable_all_pass = true;
+        } else if (::strcmp(a, "-noipa") == 0) {
+            opt.enable_ipa = false;
+        } else if (::strcmp(a, "-nosynth") == 0) {
+            opt.use_synth = false;
+        } else if (::strcmp(a, "-noprof") == 0) {
+            opt.enable_prof = false;
+        } else if (::strcmp(a, "-mdssa_ondemand") == 0) {
+            opt.mdssa_on_demand = true;
+        } else if (::strcmp(a, "-cmpmdssa") == 0) {
+            opt.cmp_mdssa = true;
+        } else if (::strcmp(a, "-cmpdom") == 0) {
+            opt.cmp_dom = true;
+        } else if (::strcmp(a, "-cmpsolver") == 0) {
+            opt.cmp_solver = true;
+        } else if (::strcmp(a, "-update") == 0) {
+            opt.update_baseline = true;
+        } else if (::strcmp(a, "-synthdir") == 0 && has_next) {
+            opt.synth_dir = argv[++i];
+        } else if (::strcmp(a, "-repeat") == 0 && has_next) {
+            INT n = ::atoi(argv[++i]);
+            opt.repeat = MAX(1, n);
+        } else if (::strcmp(a, "-thread") == 0 && has_next) {
+            INT n = ::atoi(argv[++i]);
+            opt.thread_num = MAX(1, n);
+        } else if (::strcmp(a, "-report") == 0 && has_next) {
+            opt.report = argv[++i];
+        } else if (::strcmp(a, "-tracedir") == 0 && has_next) {
+            opt.trace_dir = argv[++i];
+        } else if (::strcmp(a, "-baseline") == 0 && has_next) {
+            opt.baseline = argv[++i];
+        } else if (::strcmp(a, "-threshold") == 0 && has_next) {
+            opt.threshold = ::atof(argv[++i]);
+        } else if (a[0] == '-') {
+            return false;
+        } else {
+            opt.files.append(a);
+        }
+    }
+    if (!has_level) {
+        for (INT i = 0; i <= BENCH_MAX_LEVEL; i++) { opt.level[i] = true; }
+    }
+    if (opt.update_baseline && opt.baseline == nullptr) { return false; }
+    return opt.use_synth || opt.files.get_elem_count() != 0;
+}
+
+
+int main(int argc, char * argv[])
+{
+    BenchOption opt;
+    if (!parseOption(argc, argv, opt)) {
+        usage();
+        return 1;
+    }
+    g_mdssa_build_on_demand = opt.mdssa_on_demand;
+    //Peak memory of all threads is reported for each case.
+    xcom::smpoolEnableTotalMemAccounting(true);
+    FILE * report = nullptr;
+    if (opt.enable_prof && opt.report != nullptr) {
+        report = ::fopen(opt.report, "w");
+    }
+    xcom::Vector<BenchResult*> results;
+    bool succ = true;
+    if (opt.use_synth) {
+        for (UINT i = 0; i < sizeof(g_synth_case) / sizeof(g_synth_case[0]);
+             i++) {
+            SynthCase const& sc = g_synth_case[i];
+            StrBuf f(64);
+            f.sprint("%s/%s.gr", opt.synth_dir, sc.name);
+            if (!genSynthGR(sc, f.buf)) {
+                printf("\ncan not generate %s", f.buf);
+                succ = false;
+                continue;
+            }
+            succ &= runCaseByMode(f.buf, sc.name, opt, report, results);
+        }
+    }
+    for (VecIdx i = 0; i <= opt.files.get_last_idx(); i++) {
+        CHAR const* f = opt.files.get(i);
+        //Use the base name of file as case name.
+        CHAR const* name = ::strrchr(f, '/');
+        name = name == nullptr ? f : name + 1;
+        succ &= runCaseByMode(f, name, opt, report, results);
+    }
+    if (report != nullptr) { ::fclose(report); }
+
+    UINT regress = 0;
+    if (opt.update_baseline) {
+        if (!writeBaseline(opt.baseline, results)) {
+            printf("\ncan not write baseline %s", opt.baseline);
+            succ = false;
+        }
+    } else if (opt.baseline != nullptr) {
+        regress = compareBaseline(opt.baseline, opt.threshold, results);
+    }
+    for (VecIdx i = 0; i <= results.get_last_idx(); i++) {
+        delete results.get(i);
+    }
+    printf("\n");
+    if (!succ) { return 2; }
+    return regress == 0 ? 0 : 3;
+}
@@ -34,13 +34,192 @@ author: Su Zhenyu
 #include "../../opt/cominc.h"
 #include "../../opt/comopt.h"
 #include "../../reader/grreader.h"
+#include "../../reader/grbin.h"
 
-static bool readGR(CHAR * gr_file_name)
+//The number of bytes that are corrupted in the binary GR file one by one.
+#define CORRUPT_BYTE_NUM 256
+
+static xoc::RegionMgr * createRegionMgr()
 {
-    ASSERT0(gr_file_name);
     xoc::RegionMgr * rm = new xoc::RegionMgr();
     rm->initVarMgr();
     rm->initIRDescFlagSet();
+    return rm;
+}
+
+
+static xoc::Region * findProgramRegion(xoc::RegionMgr * rm)
+{
+    for (UINT i = 0; i < rm->getNumOfRegion(); i++) {
+        xoc::Region * rg = rm->getRegion(i);
+        if (rg != NULL && rg->is_program()) { return rg; }
+    }
+    return NULL;
+}
+
+
+static void dumpGRFile(xoc::Region * rg, CHAR const* filename)
+{
+    xoc::LogMgr * lm = rg->getLogMgr();
+    UNLINK(filename);
+    FILE * gr = ::fopen(filename, "w");
+    ASSERT0(gr);
+    lm->push(gr, filename);
+    rg->dumpGR(true);
+    lm->pop();
+    ::fclose(gr);
+}
+
+
+//Read whole content of 'filename' into 'buf'.
+//Return false if the file can not be read.
+static bool readFile(CHAR const* filename, OUT xcom::Vector<BYTE> & buf)
+{
+    FILE * h = ::fopen(filename, "rb");
+    if (h == NULL) { return false; }
+    buf.clean();
+    INT c;
+    VecIdx i = 0;
+    while ((c = ::fgetc(h)) != EOF) {
+        buf.set(i, (BYTE)c);
+        i++;
+    }
+    ::fclose(h);
+    return true;
+}
+
+
+static void writeFile(CHAR const* filename, xcom::Vector<BYTE> const& buf,
+                      UINT size)
+{
+    UNLINK(filename);
+    FILE * h = ::fopen(filename, "wb");
+    ASSERT0(h);
+    for (UINT i = 0; i < size; i++) {
+        ::fputc(buf.get(i), h);
+    }
+    ::fclose(h);
+}
+
+
+//Return true if the content of 'file1' is same as 'file2'.
+static bool isSameFile(CHAR const* file1, CHAR const* file2)
+{
+    xcom::Vector<BYTE> buf1;
+    xcom::Vector<BYTE> buf2;
+    if (!readFile(file1, buf1) || !readFile(file2, buf2)) { return false; }
+    UINT size = buf1.get_elem_count();
+    if (size != buf2.get_elem_count()) {
+        xoc::prt2C("\n%s has %u bytes, but %s has %u bytes", file1, size,
+                   file2, buf2.get_elem_count());
+        return false;
+    }
+    UINT line = 1;
+    for (UINT i = 0; i < size; i++) {
+        if (buf1.get(i) != buf2.get(i)) {
+            xoc::prt2C("\n%s and %s differ at line %u", file1, file2, line);
+            return false;
+        }
+        if (buf1.get(i) == '\n') { line++; }
+    }
+    return true;
+}
+
+
+//Return true if 'grbinfile' is accepted by the reader.
+static bool readGRBin(CHAR const* grbinfile)
+{
+    xoc::RegionMgr * rm = createRegionMgr();
+    bool succ = xoc::readGRBinAndConstructRegion(rm, grbinfile);
+    delete rm;
+    return succ;
+}
+
+
+//Truncate 'grbinfile' and corrupt it byte by byte, the reader must reject
+//the truncated file, and must not crash on the corrupted file.
+static bool checkBrokenGRBin(CHAR const* grbinfile)
+{
+    xcom::Vector<BYTE> buf;
+    if (!readFile(grbinfile, buf)) { return false; }
+    UINT size = buf.get_elem_count();
+    xcom::StrBuf bad(64);
+    bad.strcat(grbinfile);
+    bad.strcat(".bad");
+    bool succ = true;
+    UINT const trunc[] = { 0, 1, sizeof(xoc::GRBinHdr) - 1,
+        sizeof(xoc::GRBinHdr), size / 4, size / 2, size - 8, size - 1 };
+    for (UINT i = 0; i < sizeof(trunc) / sizeof(trunc[0]); i++) {
+        if (trunc[i] >= size) { continue; }
+        writeFile(bad.buf, buf, trunc[i]);
+        if (readGRBin(bad.buf)) {
+            xoc::prt2C("\nfile truncated to %u bytes is accepted", trunc[i]);
+            succ = false;
+        }
+    }
+    UINT rejected = 0;
+    UINT tried = 0;
+    UINT step = MAX(size / CORRUPT_BYTE_NUM, 1);
+    for (UINT pos = 0; pos < size; pos += step, tried++) {
+        BYTE org = buf.get(pos);
+        buf.set(pos, (BYTE)(org ^ 0xFF));
+        writeFile(bad.buf, buf, size);
+        buf.set(pos, org);
+        //The corrupted byte may still form a well-formed file, e.g: the
+        //byte of constant value, thus only a crash is a failure.
+        if (!readGRBin(bad.buf)) { rejected++; }
+    }
+    UNLINK(bad.buf);
+    xoc::prt2C("\ncorrupted %u bytes of %s, %u are rejected", tried,
+               grbinfile, rejected);
+    return succ;
+}
+
+
+//Write the program region into binary GR file, read it back and dump
+//it into text GR file, which must be same as 'textfile' that dumped from
+//the program region directly.
+static bool checkGRBin(xoc::Region * program, CHAR const* gr_file_name,
+                       CHAR const* textfile)
+{
+    xcom::StrBuf bin(64);
+    bin.strcat(gr_file_name);
+    bin.strcat(".grbin");
+    if (!xoc::writeGRBin(program, bin.buf)) {
+        xoc::prt2C("\nwrite binary gr file %s failed\n", bin.buf);
+        return false;
+    }
+    xoc::RegionMgr * rm = createRegionMgr();
+    if (!xoc::readGRBinAndConstructRegion(rm, bin.buf)) {
+        xoc::prt2C("\nread binary gr file %s failed\n", bin.buf);
+        delete rm;
+        return false;
+    }
+    xoc::Region * rg = findProgramRegion(rm);
+    ASSERT0(rg);
+    xcom::StrBuf b(64);
+    b.strcat(gr_file_name);
+    b.strcat(".bin.gr");
+    dumpGRFile(rg, b.buf);
+    delete rm;
+    if (!isSameFile(textfile, b.buf)) {
+        xoc::prt2C("\nround trip of binary gr file %s failed\n", bin.buf);
+        return false;
+    }
+    xoc::prt2C("\nround trip of binary gr file %s passed", bin.buf);
+    if (!checkBrokenGRBin(bin.buf)) {
+        xoc::prt2C("\nbroken binary gr file %s is accepted\n", bin.buf);
+        return false;
+    }
+    xoc::prt2C("\n");
+    return true;
+}
+
+
+static bool readGR(CHAR * gr_file_name, bool check_bin)
+{
+    ASSERT0(gr_file_name);
+    xoc::RegionMgr * rm = createRegionMgr();
     rm->getLogMgr()->init("tmp.log", true);
     bool succ = xoc::readGRAndConstructRegion(rm, gr_file_name);
     if (!succ) {
@@ -48,7 +227,6 @@ static bool readGR(CHAR * gr_file_name)
         return false;
     }
 
-    xoc::LogMgr * lm = rm->getLogMgr();
     //Normalizing and dump new GR file.
     for (UINT i = 0; i < rm->getNumOfRegion(); i++) {
         xoc::Region * rg = rm->getRegion(i);
@@ -58,13 +236,11 @@ static bool readGR(CHAR * gr_file_name)
             xcom::StrBuf b(64);
             b.strcat(gr_file_name);
             b.strcat(".gr");
-            UNLINK(b.buf);
-            FILE * gr = ::fopen(b.buf, "w");
-            lm->push(gr, b.buf);
-            rg->dumpGR(true);
-            lm->pop();
-            ::fclose(gr);
+            dumpGRFile(rg, b.buf);
             xoc::prt2C("\noutput is %s\n", b.buf);
+            if (check_bin) {
+                succ = checkGRBin(rg, gr_file_name, b.buf);
+            }
         }
         if (rg->getPassMgr() != NULL) {
             xoc::PRSSAMgr * ssamgr = (PRSSAMgr*)rg->getPassMgr()->queryPass(
@@ -77,27 +253,35 @@ static bool readGR(CHAR * gr_file_name)
     }
 
     delete rm;
-    return true;
+    return succ;
 }
 
 
 void usage()
 {
     printf("\nInput a GR file, output a new GR file with normalized format.");
-    printf("\nreader <input-grfile-name>");
+    printf("\nreader [-bin] <input-grfile-name>");
+    printf("\n  -bin  write the binary GR file, check that it is read back "
+           "to the same GR, and that truncated or corrupted binary GR "
+           "file does not crash the reader");
     printf("\n");
 }
 
 
 int main(int argc, char * argv[])
 {
-    if (argc != 2) {
+    bool check_bin = false;
+    INT i = 1;
+    if (argc == 3 && ::strcmp(argv[1], "-bin") == 0) {
+        check_bin = true;
+        i++;
+    }
+    if (i != argc - 1) {
         usage();
         return 1;
     }
-    if (!readGR(argv[1])) {
+    if (!readGR(argv[i], check_bin)) {
         return 2;
     }
     return 0;
 }
-
@@ -0,0 +1,693 @@
+/*@
+XOC Release License
+
+Copyright (c) 2013-2014, Alibaba Group, All rights reserved.
+
+compiler@aliexpress.com
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+* Neither the name of the Su Zhenyu nor the names of its contributors
+may be used to endorse or promote products derived from this software
+without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+author: Su Zhenyu
+@*/
+#include "../../opt/cominc.h"
+#include "../../opt/comopt.h"
+#include "../../reader/grreader.h"
+
+//Checker of PRE.
+//The checker processes each GR file twice with the same pipeline, once
+//without PRE and once with PRE, and counts the evaluations of unary and
+//binary operations in function regions. The evaluations in a BB are
+//weighted by the estimated frequency of the BB, which approximates the
+//dynamic count of evaluations: the frequency of the entry is 1, a
+//branch divides the frequency evenly among its successors, and a loop
+//is assumed to iterate PRECHK_LOOP_WEIGHT times.
+//LICM, GCSE, GVN and LCSE are disabled in both runs, because they would
+//remove the same redundancies before PRE.
+//The checker fails if PRE increases the count of any case, or does not
+//decrease the count of the case that is expected to be improved.
+//In addition, each function region is interpreted on PRECHK_TRIAL_NUM
+//inputs after both runs, and the return values and the content of memory
+//have to be identical, namely PRE has to preserve the result. The built-in
+//cases have to be interpretable, whereas a user given GR file that uses
+//unsupported operations is only checked by the count.
+//
+//The vectorization case is processed once with Vectorization enabled, and
+//the checker inspects the generated vector IR: the loop has to be widened
+//into vector memory operations and vector arithmetic, every vector type has
+//to fit the vector register, and the scalar memory operations have to be
+//kept for the remaining iterations.
+
+#define PRECHK_LOOP_WEIGHT 10.0
+
+//Byte size of vector register that the vectorization case is checked with.
+#define PRECHK_VECT_BYTE_SIZE 16
+
+//The number of inputs that each function region is interpreted with.
+#define PRECHK_TRIAL_NUM 4
+
+//Pointer parameters point to a memory block that starts at PRECHK_MEM_ADDR.
+#define PRECHK_MEM_ADDR 0x1000
+#define PRECHK_MEM_BYTE_SIZE 64
+
+//The max number of stmts that interpreter executes in one trial.
+#define PRECHK_MAX_STEP 100000
+
+typedef enum {
+    PRECHK_NOT_WORSE = 0, //PRE should not increase the count.
+    PRECHK_LESS, //PRE should decrease the count.
+    PRECHK_VECT, //Vectorization should widen the loop.
+} PRECHK_EXPECT;
+
+//Record the vector IR in function regions.
+typedef struct {
+    UINT vec_mem_num; //the number of vector ild and ist.
+    UINT vec_op_num; //the number of vector unary and binary operations.
+    UINT scalar_mem_num; //the number of scalar ild and ist.
+    UINT bad_vec_num; //the number of vectors that do not fit register.
+} VectStat;
+
+typedef struct {
+    CHAR const* name;
+    PRECHK_EXPECT expect;
+} PreCase;
+
+static PreCase const g_pre_case[] = {
+    { "loop_diamond.gr", PRECHK_LESS },
+    { "loop_nest.gr", PRECHK_LESS },
+    { "loop_full.gr", PRECHK_LESS },
+    { "loop_none.gr", PRECHK_NOT_WORSE },
+    { "vect_add.gr", PRECHK_VECT },
+};
+
+
+static void setPipeline(bool do_pre, bool do_vect)
+{
+    g_opt_level = OPT_LEVEL3;
+    g_do_prssa = true;
+    g_do_mdssa = true;
+    g_do_cp = true;
+    g_do_dce = true;
+    g_do_rp = true;
+    g_do_licm = false;
+    g_do_gcse = false;
+    g_do_gvn = false;
+    g_do_lcse = false;
+    g_do_pre = do_pre;
+    //Vectorization relies on IVR to confirm the induction variable.
+    g_do_ivr = do_vect;
+    g_do_vect = do_vect;
+    g_vect_reg_byte_size = PRECHK_VECT_BYTE_SIZE;
+    //Loop info has to be computed after processing.
+    g_retain_pass_mgr_for_region = true;
+    //Function regions have to be processed by the program region to build
+    //their CFG.
+    g_process_func_region_in_program = true;
+}
+
+
+static void computeLoopDepth(LI<IRBB> const* li, UINT depth,
+                             MOD Vector<UINT> & bb2depth)
+{
+    for (; li != nullptr; li = LI_next(li)) {
+        xcom::BitSet const* body = li->getBodyBBSet();
+        ASSERT0(body);
+        for (BSIdx i = body->get_first(); i != BS_UNDEF;
+             i = body->get_next((UINT)i)) {
+            bb2depth.set((VecIdx)i, MAX(bb2depth.get((VecIdx)i), depth));
+        }
+        computeLoopDepth(LI_inner_list(li), depth + 1, bb2depth);
+    }
+}
+
+
+static double powLoopWeight(UINT depth)
+{
+    double w = 1.0;
+    for (UINT i = 0; i < depth; i++) { w *= PRECHK_LOOP_WEIGHT; }
+    return w;
+}
+
+
+//Estimate the frequency of each BB in RPO. The back edge is ignored, the
+//frequency of loop head is multiplied by PRECHK_LOOP_WEIGHT, and the
+//frequency that flows out of loops is divided by the weight of the loops.
+static void computeFreq(IRCFG * cfg, Vector<UINT> const& bb2depth,
+                        OUT Vector<double> & bb2freq)
+{
+    RPOVexList const* vlst = cfg->getRPOVexList();
+    ASSERT0(vlst);
+    RPOVexListIter it;
+    for (Vertex const* v = vlst->get_head(&it);
+         v != nullptr; v = vlst->get_next(&it)) {
+        double freq = 0;
+        bool is_loop_head = false;
+        xcom::EdgeC const* ec = v->getInList();
+        if (ec == nullptr) { freq = 1.0; }
+        for (; ec != nullptr; ec = ec->get_next()) {
+            VexIdx pred = ec->getFromId();
+            if (cfg->is_dom(v->id(), pred)) {
+                //Back edge.
+                is_loop_head = true;
+                continue;
+            }
+            double share = bb2freq.get(pred) /
+                           (double)cfg->getVertex(pred)->getOutDegree();
+            UINT pd = bb2depth.get(pred);
+            UINT vd = bb2depth.get(v->id());
+            if (pd > vd) { share /= powLoopWeight(pd - vd); }
+            freq += share;
+        }
+        if (is_loop_head) { freq *= PRECHK_LOOP_WEIGHT; }
+        bb2freq.set(v->id(), freq);
+    }
+}
+
+
+//Return the number of unary and binary operations in stmt 'ir'.
+static ULONGLONG countOp(IR const* ir)
+{
+    ULONGLONG n = 0;
+    ConstIRIter it;
+    for (IR const* x = xoc::iterInitC(ir, it, false);
+         x != nullptr; x = xoc::iterNextC(it, true)) {
+        if (x->isBinaryOp() || x->isUnaryOp()) { n++; }
+    }
+    return n;
+}
+
+
+//Return the estimated count of evaluations in 'rg'.
+static double countEvaluation(Region * rg)
+{
+    ASSERT0(rg->getPassMgr());
+    OptCtx * oc = rg->getRegionMgr()->getAndGenOptCtx(rg);
+    rg->getPassMgr()->checkValidAndRecompute(oc, PASS_CFG, PASS_DOM,
+                                             PASS_RPO, PASS_LOOP_INFO,
+                                             PASS_UNDEF);
+    Vector<UINT> bb2depth;
+    computeLoopDepth(rg->getCFG()->getLoopInfo(), 1, bb2depth);
+    Vector<double> bb2freq;
+    computeFreq(rg->getCFG(), bb2depth, bb2freq);
+    double count = 0;
+    BBListIter bbit;
+    for (IRBB * bb = rg->getBBList()->get_head(&bbit);
+         bb != nullptr; bb = rg->getBBList()->get_next(&bbit)) {
+        double freq = bb2freq.get(bb->id());
+        BBIRListIter irit;
+        for (IR * ir = bb->getIRList().get_head(&irit);
+             ir != nullptr; ir = bb->getIRList().get_next(&irit)) {
+            count += countOp(ir) * freq;
+        }
+    }
+    return count;
+}
+
+
+static void countVectIR(Region * rg, MOD VectStat & stat)
+{
+    BBListIter bbit;
+    for (IRBB * bb = rg->getBBList()->get_head(&bbit);
+         bb != nullptr; bb = rg->getBBList()->get_next(&bbit)) {
+        BBIRListIter irit;
+        for (IR * ir = bb->getIRList().get_head(&irit);
+             ir != nullptr; ir = bb->getIRList().get_next(&irit)) {
+            ConstIRIter it;
+            for (IR const* x = xoc::iterInitC(ir, it, false);
+                 x != nullptr; x = xoc::iterNextC(it, true)) {
+                bool is_mem = x->is_ild() || x->is_ist();
+                if (!x->is_vec()) {
+                    if (is_mem) { stat.scalar_mem_num++; }
+                    continue;
+                }
+                if (rg->getTypeMgr()->getByteSize(x->getType()) !=
+                    PRECHK_VECT_BYTE_SIZE) {
+                    stat.bad_vec_num++;
+                }
+                if (is_mem) { stat.vec_mem_num++; }
+                if (x->isBinaryOp() || x->isUnaryOp()) { stat.vec_op_num++; }
+            }
+        }
+    }
+}
+
+
+//The interpreter executes function region to check that PRE preserves
+//the result. Integer parameters are assigned by the number of trial, and
+//pointer parameters point to the memory block at PRECHK_MEM_ADDR. Local
+//variables and PRs are 0 at the beginning.
+//Only scalar integer operations, branches and PHI are supported.
+class Interp {
+    COPY_CONSTRUCTOR(Interp);
+    bool m_succ; //false if region can not be interpreted.
+    UINT m_step;
+    Region * m_rg;
+    TypeMgr * m_tm;
+    xcom::TMap<Var const*, HOST_INT> m_var2val;
+    xcom::Vector<HOST_INT> m_pr2val;
+    xcom::Vector<IRBB*> m_bb2next; //map BB id to the fallthrough BB.
+    BYTE m_mem[PRECHK_MEM_BYTE_SIZE];
+protected:
+    HOST_INT eval(IR const* x);
+    HOST_INT evalBin(IR const* x);
+    HOST_INT evalUna(IR const* x);
+    void execPhi(IRBB const* pred, IRBB const* bb);
+
+    //Return the target BB of branch 'br'.
+    IRBB * getTarget(IR const* br) const;
+    BYTE * getMem(HOST_INT addr, UINT size);
+    void init(UINT trial);
+
+    //Wrap 'v' into the value range of 'ty'.
+    HOST_INT norm(HOST_INT v, Type const* ty) const;
+public:
+    Interp(Region * rg) : m_rg(rg), m_tm(rg->getTypeMgr()) {}
+
+    //Interpret region with the No.'trial' input, append the return value
+    //and the content of memory to 'value'.
+    //Return false if region can not be interpreted.
+    bool run(UINT trial, MOD xcom::Vector<HOST_INT> & value);
+};
+
+
+HOST_INT Interp::norm(HOST_INT v, Type const* ty) const
+{
+    if (ty->is_bool()) { return v != 0 ? 1 : 0; }
+    UINT bitsize = m_tm->getByteSize(ty) * BIT_PER_BYTE;
+    if (bitsize == 0 || bitsize >= sizeof(HOST_INT) * BIT_PER_BYTE) {
+        return v;
+    }
+    HOST_UINT mask = (((HOST_UINT)1) << bitsize) - 1;
+    HOST_UINT u = ((HOST_UINT)v) & mask;
+    if (ty->is_signed() && (u >> (bitsize - 1)) != 0) { u |= ~mask; }
+    return (HOST_INT)u;
+}
+
+
+BYTE * Interp::getMem(HOST_INT addr, UINT size)
+{
+    if (addr < PRECHK_MEM_ADDR || size == 0 || size > sizeof(HOST_INT) ||
+        addr + size > PRECHK_MEM_ADDR + PRECHK_MEM_BYTE_SIZE) {
+        m_succ = false;
+        return nullptr;
+    }
+    return &m_mem[addr - PRECHK_MEM_ADDR];
+}
+
+
+HOST_INT Interp::evalUna(IR const* x)
+{
+    HOST_INT a = eval(UNA_opnd(x));
+    switch (x->getCode()) {
+    case IR_NEG: return -a;
+    case IR_BNOT: return ~a;
+    case IR_LNOT: return a == 0;
+    case IR_CVT: return a;
+    default: m_succ = false;
+    }
+    return 0;
+}
+
+
+HOST_INT Interp::evalBin(IR const* x)
+{
+    IR const* op0 = BIN_opnd0(x);
+    HOST_INT a = eval(op0);
+    HOST_INT b = eval(BIN_opnd1(x));
+    bool is_signed = op0->getType()->is_signed();
+    switch (x->getCode()) {
+    case IR_ADD: return (HOST_INT)((HOST_UINT)a + (HOST_UINT)b);
+    case IR_SUB: return (HOST_INT)((HOST_UINT)a - (HOST_UINT)b);
+    case IR_MUL: return (HOST_INT)((HOST_UINT)a * (HOST_UINT)b);
+    case IR_DIV:
+    case IR_REM:
+    case IR_MOD:
+        if (b == 0 || (b == -1 && is_signed)) { break; }
+        if (x->is_div()) {
+            return is_signed ? a / b : (HOST_INT)((HOST_UINT)a / (HOST_UINT)b);
+        }
+        return is_signed ? a % b : (HOST_INT)((HOST_UINT)a % (HOST_UINT)b);
+    case IR_BAND: return a & b;
+    case IR_BOR: return a | b;
+    case IR_XOR: return a ^ b;
+    case IR_LAND: return a != 0 && b != 0;
+    case IR_LOR: return a != 0 || b != 0;
+    case IR_LSL:
+        return (HOST_INT)((HOST_UINT)a << (b & (sizeof(HOST_INT) * 8 - 1)));
+    case IR_LSR:
+        return (HOST_INT)((HOST_UINT)a >> (b & (sizeof(HOST_INT) * 8 - 1)));
+    case IR_ASR: return a >> (b & (sizeof(HOST_INT) * 8 - 1));
+    case IR_LT: return is_signed ? a < b : (HOST_UINT)a < (HOST_UINT)b;
+    case IR_LE: return is_signed ? a <= b : (HOST_UINT)a <= (HOST_UINT)b;
+    case IR_GT: return is_signed ? a > b : (HOST_UINT)a > (HOST_UINT)b;
+    case IR_GE: return is_signed ? a >= b : (HOST_UINT)a >= (HOST_UINT)b;
+    case IR_EQ: return a == b;
+    case IR_NE: return a != b;
+    default:;
+    }
+    m_succ = false;
+    return 0;
+}
+
+
+HOST_INT Interp::eval(IR const* x)
+{
+    if (!m_succ) { return 0; }
+    if (x->is_vec() || x->is_fp()) {
+        m_succ = false;
+        return 0;
+    }
+    HOST_INT v = 0;
+    switch (x->getCode()) {
+    case IR_CONST: v = CONST_int_val(x); break;
+    case IR_PR: v = m_pr2val.get(PR_no(x)); break;
+    case IR_LD:
+        if (LD_ofst(x) != 0) { m_succ = false; return 0; }
+        v = m_var2val.get(x->getIdinfo());
+        break;
+    case IR_ILD: {
+        HOST_INT addr = eval(ILD_base(x)) + ILD_ofst(x);
+        UINT size = m_tm->getByteSize(x->getType());
+        BYTE const* p = getMem(addr, size);
+        if (p == nullptr) { return 0; }
+        //Memory is little endian.
+        for (UINT i = size; i > 0; i--) { v = (v << BIT_PER_BYTE) | p[i - 1]; }
+        break;
+    }
+    case IR_SELECT:
+        v = eval(SELECT_det(x)) != 0 ? eval(SELECT_trueexp(x)) :
+                                       eval(SELECT_falseexp(x));
+        break;
+    default:
+        if (x->isBinaryOp()) { v = evalBin(x); break; }
+        if (x->isUnaryOp()) { v = evalUna(x); break; }
+        m_succ = false;
+        return 0;
+    }
+    return norm(v, x->getType());
+}
+
+
+void Interp::execPhi(IRBB const* pred, IRBB const* bb)
+{
+    bool is_pred = false;
+    UINT pos = m_rg->getCFG()->WhichPred(pred, bb, is_pred);
+    ASSERT0(is_pred);
+
+    //PHIs are evaluated simultaneously at the entry of BB.
+    xcom::Vector<HOST_INT> val;
+    UINT n = 0;
+    BBIRListIter it;
+    IR * ir;
+    for (ir = const_cast<IRBB*>(bb)->getIRList().get_head(&it);
+         ir != nullptr && ir->is_phi();
+         ir = const_cast<IRBB*>(bb)->getIRList().get_next(&it)) {
+        IR const* opnd = ((CPhi*)ir)->getOpnd(pos);
+        if (opnd == nullptr) { m_succ = false; return; }
+        val.set(n++, eval(opnd));
+    }
+    n = 0;
+    for (ir = const_cast<IRBB*>(bb)->getIRList().get_head(&it);
+         ir != nullptr && ir->is_phi();
+         ir = const_cast<IRBB*>(bb)->getIRList().get_next(&it)) {
+        m_pr2val.set(PHI_prno(ir), val.get(n++));
+    }
+}
+
+
+IRBB * Interp::getTarget(IR const* br) const
+{
+    IRBB * tgt = m_rg->getCFG()->findBBbyLabel(br->getLabel());
+    ASSERT0(tgt);
+    return tgt;
+}
+
+
+void Interp::init(UINT trial)
+{
+    //The values that integer parameters are assigned with.
+    static HOST_INT const param_val[] = { 0, 1, 5, 12 };
+    m_succ = true;
+    m_step = 0;
+    m_var2val.clean();
+    m_pr2val.clean();
+    for (UINT i = 0; i < PRECHK_MEM_BYTE_SIZE; i++) {
+        m_mem[i] = (BYTE)(i * 13 + trial * 7 + 1);
+    }
+    List<Var const*> params;
+    m_rg->findFormalParam(params, true);
+    UINT pos = 0;
+    for (Var const* v = params.get_head(); v != nullptr;
+         v = params.get_next(), pos++) {
+        if (v->is_pointer()) {
+            m_var2val.set(v, PRECHK_MEM_ADDR);
+            continue;
+        }
+        UINT n = sizeof(param_val) / sizeof(param_val[0]);
+        m_var2val.set(v, param_val[(trial + pos) % n]);
+    }
+    m_bb2next.clean();
+    IRBB * prev = nullptr;
+    BBListIter bbit;
+    for (IRBB * bb = m_rg->getBBList()->get_head(&bbit);
+         bb != nullptr; bb = m_rg->getBBList()->get_next(&bbit)) {
+        if (prev != nullptr) { m_bb2next.set(prev->id(), bb); }
+        prev = bb;
+    }
+}
+
+
+bool Interp::run(UINT trial, MOD xcom::Vector<HOST_INT> & value)
+{
+    init(trial);
+    IRBB * pred = nullptr;
+    IRBB * bb = m_rg->getCFG()->getEntry();
+    HOST_INT retv = 0;
+    while (m_succ && bb != nullptr) {
+        if (pred != nullptr) { execPhi(pred, bb); }
+        IRBB * next = m_bb2next.get(bb->id());
+        BBIRListIter it;
+        for (IR * ir = bb->getIRList().get_head(&it);
+             m_succ && ir != nullptr; ir = bb->getIRList().get_next(&it)) {
+            if (++m_step > PRECHK_MAX_STEP) { m_succ = false; break; }
+            switch (ir->getCode()) {
+            case IR_PHI: break;
+            case IR_STPR:
+                m_pr2val.set(STPR_no(ir), eval(STPR_rhs(ir)));
+                break;
+            case IR_ST:
+                if (ST_ofst(ir) != 0) { m_succ = false; break; }
+                m_var2val.setAlways(ir->getIdinfo(), eval(ST_rhs(ir)));
+                break;
+            case IR_IST: {
+                HOST_INT v = eval(IST_rhs(ir));
+                UINT size = m_tm->getByteSize(ir->getType());
+                BYTE * p = getMem(eval(IST_base(ir)) + IST_ofst(ir), size);
+                if (p == nullptr) { break; }
+                for (UINT i = 0; i < size; i++, v >>= BIT_PER_BYTE) {
+                    p[i] = (BYTE)v;
+                }
+                break;
+            }
+            case IR_GOTO:
+                next = getTarget(ir);
+                break;
+            case IR_TRUEBR:
+            case IR_FALSEBR:
+                if ((eval(BR_det(ir)) != 0) == ir->is_truebr()) {
+                    next = getTarget(ir);
+                }
+                break;
+            case IR_RETURN:
+                if (RET_exp(ir) != nullptr) { retv = eval(RET_exp(ir)); }
+                next = nullptr;
+                break;
+            default: m_succ = false;
+            }
+        }
+        pred = bb;
+        bb = next;
+    }
+    if (!m_succ) { return false; }
+    value.append(retv);
+    for (UINT i = 0; i < PRECHK_MEM_BYTE_SIZE; i++) {
+        value.append((HOST_INT)m_mem[i]);
+    }
+    return true;
+}
+
+
+//Process 'grfile' and compute the estimated count of evaluations of all
+//function regions, and record the vector IR in 'stat'.
+//The result of interpreting function regions is appended to 'value'.
+//'is_interp' is set to false if any function region can not be interpreted.
+//Return false if the file can not be processed.
+static bool runOnce(CHAR const* grfile, bool do_pre, bool do_vect,
+                    OUT double & count, OUT VectStat & stat,
+                    OUT xcom::Vector<HOST_INT> & value, OUT bool & is_interp)
+{
+    setPipeline(do_pre, do_vect);
+    RegionMgr * rm = new RegionMgr();
+    rm->initVarMgr();
+    rm->initIRDescFlagSet();
+    count = 0;
+    ::memset((void*)&stat, 0, sizeof(stat));
+    value.clean();
+    is_interp = true;
+    bool succ = readGRAndConstructRegion(rm, grfile);
+    Region * program = nullptr;
+    for (UINT i = 0; succ && i < rm->getNumOfRegion(); i++) {
+        Region * rg = rm->getRegion(i);
+        if (rg != nullptr && rg->is_program()) { program = rg; break; }
+    }
+    if (program == nullptr) {
+        delete rm;
+        return false;
+    }
+    //Pipeline may report false if some pass bails out, the result is
+    //still counted.
+    rm->processProgramRegion(program, rm->getAndGenOptCtx(program));
+    for (UINT i = 0; i < rm->getNumOfRegion(); i++) {
+        Region * rg = rm->getRegion(i);
+        if (rg == nullptr || !rg->is_function() || rg->getPassMgr() == nullptr) {
+            continue;
+        }
+        count += countEvaluation(rg);
+        countVectIR(rg, stat);
+        Interp interp(rg);
+        for (UINT t = 0; is_interp && t < PRECHK_TRIAL_NUM; t++) {
+            is_interp = interp.run(t, value);
+        }
+    }
+    delete rm;
+    return true;
+}
+
+
+//Return true if the vector IR of 'grfile' is generated as expected.
+static bool checkVectCase(CHAR const* grfile)
+{
+    double count = 0;
+    VectStat stat;
+    xcom::Vector<HOST_INT> value;
+    bool is_interp = false;
+    if (!runOnce(grfile, false, true, count, stat, value, is_interp)) {
+        printf("\n%-40s FAILED: can not process", grfile);
+        return false;
+    }
+    bool succ = stat.vec_mem_num != 0 && stat.vec_op_num != 0 &&
+                stat.scalar_mem_num != 0 && stat.bad_vec_num == 0;
+    printf("\n%-40s vector mem:%u op:%u scalar mem:%u misfit:%u %s",
+           grfile, stat.vec_mem_num, stat.vec_op_num, stat.scalar_mem_num,
+           stat.bad_vec_num, succ ? "PASS" : "FAILED");
+    return succ;
+}
+
+
+//Return true if the results of interpreting 'v1' and 'v2' are identical.
+static bool isSameValue(xcom::Vector<HOST_INT> const& v1,
+                        xcom::Vector<HOST_INT> const& v2)
+{
+    if (v1.get_last_idx() != v2.get_last_idx()) { return false; }
+    for (VecIdx i = 0; i <= v1.get_last_idx(); i++) {
+        if (v1.get(i) != v2.get(i)) { return false; }
+    }
+    return true;
+}
+
+
+//Return true if the result of 'grfile' meets 'expect'.
+//'must_interp' is true if the function regions have to be interpretable.
+static bool checkCase(CHAR const* grfile, PRECHK_EXPECT expect,
+                      bool must_interp)
+{
+    if (expect == PRECHK_VECT) { return checkVectCase(grfile); }
+    double before = 0;
+    double after = 0;
+    VectStat stat;
+    xcom::Vector<HOST_INT> before_val;
+    xcom::Vector<HOST_INT> after_val;
+    bool before_interp = false;
+    bool after_interp = false;
+    if (!runOnce(grfile, false, false, before, stat, before_val,
+                 before_interp) ||
+        !runOnce(grfile, true, false, after, stat, after_val,
+                 after_interp)) {
+        printf("\n%-40s FAILED: can not process", grfile);
+        return false;
+    }
+    //Tolerate the rounding error of frequency.
+    double eps = before * 1e-9;
+    bool succ = expect == PRECHK_LESS ? after < before - eps :
+                                        after <= before + eps;
+    CHAR const* equ = "equal";
+    if (!before_interp || !after_interp) {
+        equ = "not interpreted";
+        if (must_interp) { succ = false; }
+    } else if (!isSameValue(before_val, after_val)) {
+        equ = "NOT equal";
+        succ = false;
+    }
+    printf("\n%-40s before:%12.2f after:%12.2f result:%s %s", grfile,
+           before, after, equ, succ ? "PASS" : "FAILED");
+    return succ;
+}
+
+
+static void usage()
+{
+    printf("\nCheck the evaluations of expression before and after PRE."
+           "\nprecheck.exe [-casedir <dir>] [gr-file ...]"
+           "\n  -casedir <dir>   directory of built-in cases, default is cases"
+           "\n  gr-file          PRE should not increase evaluations of it"
+           "\n");
+}
+
+
+int main(int argc, char * argv[])
+{
+    CHAR const* casedir = "cases";
+    xcom::Vector<CHAR const*> files;
+    for (INT i = 1; i < argc; i++) {
+        if (::strcmp(argv[i], "-casedir") == 0 && i + 1 < argc) {
+            casedir = argv[++i];
+        } else if (argv[i][0] == '-') {
+            usage();
+            return 1;
+        } else {
+            files.append(argv[i]);
+        }
+    }
+    UINT fail = 0;
+    for (UINT i = 0; i < sizeof(g_pre_case) / sizeof(g_pre_case[0]); i++) {
+        StrBuf f(64);
+        f.sprint("%s/%s", casedir, g_pre_case[i].name);
+        if (!checkCase(f.buf, g_pre_case[i].expect, true)) { fail++; }
+    }
+    for (VecIdx i = 0; i <= files.get_last_idx(); i++) {
+        if (!checkCase(files.get(i), PRECHK_NOT_WORSE, false)) { fail++; }
+    }
+    printf("\n%u case(s) failed\n", fail);
+    return fail == 0 ? 0 : 2;
+}
@@ -34,7 +34,8 @@ namespace xoc {
 #ifdef _DEBUG_
 //NOTE: the variable is only used in DEBUG mode to facilitate user
 //to debug and trace all reported actions.
-//The variable is NOT thread-safe.
+//The variable is shared by all regions, it is guarded by the shared lock
+//of RegionMgr.
 static UINT g_global_cnt = ACT_HANDLER_ID_UNDEF + 1;
 #endif
 
@@ -69,6 +70,9 @@ void ActMgr::clean()
 ActHandler ActMgr::dump_args(CHAR const* format, va_list args)
 {
     if (!m_rg->isLogMgrInit()) { return ActHandler(); }
+    #ifdef _DEBUG_
+    xcom::AutoLock lock(m_rg->getRegionMgr()->getLock());
+    #endif
     xcom::StrBuf * buf = allocStrBuf();
 
     //Dump action id.
@@ -98,6 +98,9 @@ AnalysisInstrument::AnalysisInstrument(Region * rg) :
     m_ir_mgr = nullptr;
     m_ir_bb_mgr = nullptr;
     m_dbx_mgr = nullptr;
+    m_is_mem_budget_exceeded = false;
+    m_mem_base = xcom::smpoolGetThreadMemSize();
+    m_mem_account = xcom::MemAccount::create();
     //Counter of IR_PR, and do not use '0' as prno.
     m_pr_count = PRNO_UNDEF + 1;
     m_du_pool = smpoolCreate(sizeof(DU) * 4, MEM_CONST_SIZE);
@@ -188,6 +191,10 @@ AnalysisInstrument::~AnalysisInstrument()
     m_ir_list = nullptr;
     m_ir_mgr = nullptr;
     m_ir_bb_mgr = nullptr;
+
+    //The account is kept alive by the BitSets that still attributed to it.
+    m_mem_account->release();
+    m_mem_account = nullptr;
 }
 
 
@@ -52,6 +52,15 @@ namespace xoc {
 #define ANA_INS_ir_bb_mgr(a) ((a)->m_ir_bb_mgr)
 #define ANA_INS_ir_bb_list(a) ((a)->m_ir_bb_list)
 
+//Record the thread memory size when region began to be processed.
+#define ANA_INS_mem_base(a) ((a)->m_mem_base)
+
+//Set to true if the memory of region has exceeded the budget.
+#define ANA_INS_is_mem_budget_exceeded(a) ((a)->m_is_mem_budget_exceeded)
+
+//Record the byte size of BitSets that allocated while region is processed.
+#define ANA_INS_mem_account(a) ((a)->m_mem_account)
+
 //Record Data structure for IR analysis and transformation.
 #define ANA_INS_pass_mgr(a) ((a)->m_pass_mgr)
 #define ANA_INS_ai_mgr(a) ((a)->m_attachinfo_mgr)
@@ -64,6 +73,9 @@ class AnalysisInstrument {
     COPY_CONSTRUCTOR(AnalysisInstrument);
 protected:
     UINT m_pr_count; //counter of IR_PR.
+    bool m_is_mem_budget_exceeded;
+    LONGLONG m_mem_base;
+    xcom::MemAccount * m_mem_account;
     Region * m_rg;
     xcom::SMemPool * m_du_pool;
     xcom::SMemPool * m_sc_labelinfo_pool;
@@ -210,17 +210,26 @@ public:
     VarMgr * getVarMgr() const { return m_vm; }
 
     //Get the target(callee) Region for given call/icall stmt.
+    //The target of icall is known only if the callee expression is the
+    //address of function, e.g: icall (lda func), otherwise return nullptr.
     //rg: the region that 'ir' resident in.
     Region * getCalleeRegion(IR const* ir, Region const* rg) const
     {
+        Var const* callee = nullptr;
         if (ir->is_call()) {
-            CallNode * cn = findCallNode(CALL_idinfo(ir)->get_name(),
-                const_cast<Region*>(rg));
-            if (cn != nullptr) { return CN_ru(cn); }
-            return nullptr;
+            callee = CALL_idinfo(ir);
+        } else {
+            ASSERT0(ir->is_icall());
+            IR const* target = ICALL_callee(ir);
+            if (!target->is_lda() || !LDA_idinfo(target)->is_func()) {
+                return nullptr;
+            }
+            callee = LDA_idinfo(target);
         }
-        ASSERTN(ir->is_icall(), ("TODO"));
-        return nullptr; //TODO: implement icall analysis.
+        CallNode * cn = findCallNode(callee->get_name(),
+                                     const_cast<Region*>(rg));
+        if (cn != nullptr) { return CN_ru(cn); }
+        return nullptr;
     }
 
     //Map vertex on call-graph to corresponding CallNode.
@@ -47,5 +47,6 @@ author: Su Zhenyu
 #include "logmgr.h"
 #include "util.h"
 #include "label.h"
+#include "profiler.h"
 #include "timer.h"
 #endif
@@ -53,12 +53,16 @@ author: Su Zhenyu
 #include "ir_ivr.h"
 #include "ir_lcse.h"
 #include "ir_gcse.h"
+#include "ir_pre.h"
 #include "ir_dce.h"
 #include "lftr.h"
 #include "ir_rce.h"
 #include "insert_guard_helper.h"
 #include "cfg_lifting.h"
 #include "loop_dep_ana.h"
+#include "ir_vect.h"
+#include "ir_vrp.h"
+#include "ir_dse.h"
 #include "multi_res_convert.h"
 #include "targinfo_handler.h"
 
@@ -87,14 +91,10 @@ author: Su Zhenyu
 #endif
 
 #ifdef FOR_IP
-#include "ir_vect.h"
 #include "derivative.h"
-#include "ir_dse.h"
 #include "scop.h"
 #include "ir_poly.h"
-#include "ir_vrp.h"
 #include "ir_ccp.h"
-#include "ir_pre.h"
 #include "workaround.h"
 #endif
 
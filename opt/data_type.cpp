@@ -243,6 +243,7 @@ DATA_TYPE TypeMgr::hoistBSdtype(UINT bit_size, bool is_signed) const
 //Register a pointer data type.
 TypeContainer const* TypeMgr::registerPointer(Type const* type)
 {
+    xcom::AutoWriteLock lock(&m_lock);
     ASSERT0(type && type->is_pointer());
     //Insertion Sort by ptr-base-size in incrmental order.
     //e.g: Given PTR, base_size=32,
@@ -275,6 +276,7 @@ TypeContainer const* TypeMgr::registerPointer(Type const* type)
 //e.g: vector<I8,I8,I8,I8> type, which mc_size is 32 byte, vec-type is D_I8.
 TypeContainer const* TypeMgr::registerVector(Type const* type)
 {
+    xcom::AutoWriteLock lock(&m_lock);
     ASSERT0(type->is_vector() && TY_vec_ety(type) != D_UNDEF);
     ASSERT0(TY_vec_size(type) >= getDTypeByteSize(TY_vec_ety(type)) &&
             TY_vec_size(type) % getDTypeByteSize(TY_vec_ety(type)) == 0);
@@ -318,6 +320,7 @@ TypeContainer const* TypeMgr::registerVector(Type const* type)
 //e.g: stream<I8> type, which stream-element-type is D_I8.
 TypeContainer const* TypeMgr::registerStream(Type const* type)
 {
+    xcom::AutoWriteLock lock(&m_lock);
     ASSERT0(type->is_stream() && TY_stream_ety(type) != D_UNDEF);
     TypeContainer const* entry = m_stream_type_tab.get(type);
     if (entry != nullptr) {
@@ -346,6 +349,7 @@ TypeContainer const* TypeMgr::registerStream(Type const* type)
 //'type': it must be D_TENSOR type, and the tensor-element-type can not D_UNDEF,
 TypeContainer const* TypeMgr::registerTensor(Type const* type)
 {
+    xcom::AutoWriteLock lock(&m_lock);
     ASSERT0(type->is_tensor() && TY_tensor_ety(type) != D_UNDEF);
     ASSERT0(((TensorType const*)type)->getByteSize(this) >=
             getDTypeByteSize(TY_tensor_ety(type)));
@@ -414,6 +418,7 @@ Type const* TypeMgr::getTensorType(DATA_TYPE elem_ty, UINT dim, ...)
 
 TypeContainer const* TypeMgr::registerMC(Type const* type)
 {
+    xcom::AutoWriteLock lock(&m_lock);
     ASSERT0(type);
     //Insertion Sort by mc-size in incrmental order.
     //e.g:Given MC, mc_size=32
@@ -446,6 +451,7 @@ TypeContainer const* TypeMgr::registerMC(Type const* type)
 //Register simplex type, e.g:INT, UINT, FP, bool.
 TypeContainer const* TypeMgr::registerSimplex(Type const* type)
 {
+    xcom::AutoWriteLock lock(&m_lock);
     ASSERT0(type);
     TypeContainer ** head = &m_simplex_type[TY_dtype(type)];
     if (*head == nullptr) {
@@ -708,6 +708,11 @@ class TypeMgr {
     friend class TensorType;
 protected:
     RegionMgr * m_rm;
+
+    //The lock guards the type tables when regions are processed
+    //concurrently. 'm_type_tab' may be reallocated when a type is registered
+    //by other thread, thus reading it takes the read lock.
+    mutable xcom::RWLock m_lock;
     xcom::Vector<Type*> m_type_tab;
     SMemPool * m_pool;
     PointerTab m_pointer_type_tab;
@@ -788,6 +793,9 @@ public:
 
     RegionMgr * getRegionMgr() const { return m_rm; }
 
+    //Return the lock that guards the type tables.
+    xcom::RWLock * getLock() { return &m_lock; }
+
     //Return DATA_TYPE which 'bitsize' corresponding to.
     //is_bf: set to true if current type is bfloat.
     DATA_TYPE getFPDType(UINT bitsize, bool is_bf) const
@@ -926,8 +934,10 @@ public:
     Type const* getType(UINT tyid) const
     {
         ASSERT0(tyid != 0);
-        ASSERT0(m_type_tab.get(tyid));
-        return m_type_tab.get(tyid);
+        xcom::AutoReadLock lock(&m_lock);
+        Type const* ty = m_type_tab.get(tyid);
+        ASSERT0(ty);
+        return ty;
     }
 
     Type const* getBool() const { return m_b; }
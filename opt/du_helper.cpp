@@ -469,8 +469,10 @@ void removeStmt(IR * stmt, Region * rg, OptCtx const& oc)
         prssa_changed = true;
     }
     MDSSAMgr * mdssamgr = rg->getMDSSAMgr();
-    if (mdssamgr != nullptr && mdssamgr->is_valid()) {
+    if (mdssamgr != nullptr && mdssamgr->isValidOnDemand()) {
         //Remove stmt and its RHS.
+        //Note the IR that belongs to unbuilt alias class does not have
+        //MDSSAInfo, thus there is no need to build the class.
         MDSSAUpdateCtx ctx(oc);
         if (!oc.is_dom_valid()) {
             //Info MDSSAMgr does not need to maintain DU chain.
@@ -39,16 +39,6 @@ namespace xoc {
 //
 //START Inliner
 //
-bool Inliner::is_call_site(IR * call, Region * rg)
-{
-    ASSERT0(call->isCallStmt());
-    CallNode const* cn1 =
-        m_call_graph->findCallNode(CALL_idinfo(call)->get_name(), rg);
-    CallNode const* cn2 = m_call_graph->mapRegion2CallNode(rg);
-    return cn1 == cn2;
-}
-
-
 //'caller': caller's region.
 //'caller_call': call site in caller.
 //'new_irs': indicate the duplicated IR list in caller. Note that
@@ -204,87 +194,516 @@ IR * Inliner::replaceReturn(
 }
 
 
-bool Inliner::doInlineImpl(Region * caller, Region * callee)
+UINT Inliner::computeSize(Region const* rg)
 {
-    IR * caller_irs = caller->getIRList();
-    IR * callee_irs = callee->getIRList();
-    if (caller_irs == nullptr || callee_irs == nullptr) { return false; }
-    IR * next = nullptr;
-    bool change = false;
-    IR * head = caller_irs;
-    for (; caller_irs != nullptr; caller_irs = next) {
-        next = caller_irs->get_next();
-        if (caller_irs->is_call() && is_call_site(caller_irs, callee)) {
-            IR * new_irs_in_caller = caller->dupIRTreeList(callee_irs);
-            InlineInfo * ii = mapRegion2InlineInfo(callee, false);
-            if (ii == nullptr) {
-                bool need_el;
-                bool has_ret;
-                checkRegion(callee, need_el, has_ret);
-                ii = mapRegion2InlineInfo(callee, true);
-                INLINFO_has_ret(ii) = has_ret;
-                INLINFO_need_el(ii) = need_el;
+    UINT size = 0;
+    ConstIRIter it;
+    for (IR const* x = iterInitC(rg->getIRList(), it);
+         x != nullptr; x = iterNextC(it)) {
+        size++;
+    }
+    return size;
+}
+
+
+//Evaluate whether rg can be inlining candidate.
+bool Inliner::can_be_cand(Region * rg)
+{
+    if (!rg->is_function() || rg->getIRList() == nullptr) { return false; }
+    VarTab * vt = rg->getVarTab();
+    ConstIRIter it;
+    for (IR const* x = iterInitC(rg->getIRList(), it);
+         x != nullptr; x = iterNextC(it)) {
+        if (x->is_region() || x->is_icall()) {
+            //Inner region can not be duplicated, and the indirect call
+            //may refer to the address of local label.
+            return false;
+        }
+        if (!x->hasIdinfo()) { continue; }
+        Var const* v = x->getIdinfo();
+        if (v->is_local() && v->hasInitVal() &&
+            vt->find(const_cast<Var*>(v))) {
+            //The initial value of local variable can not be duplicated.
+            return false;
+        }
+    }
+    return true;
+}
+
+
+InlineInfo * Inliner::computeInlineInfo(Region * callee)
+{
+    ASSERT0(!m_ru2inl.find(callee));
+    InlineInfo * ii = (InlineInfo*)xmalloc(sizeof(InlineInfo));
+    m_ru2inl.set(callee, ii);
+    if (!can_be_cand(callee)) { return ii; }
+    INLINFO_is_inlinable(ii) = true;
+    bool need_el;
+    bool has_ret;
+    checkRegion(callee, need_el, has_ret);
+    INLINFO_has_ret(ii) = has_ret;
+    INLINFO_need_el(ii) = need_el;
+    INLINFO_size(ii) = computeSize(callee);
+
+    List<Var const*> params;
+    callee->findFormalParam(params, true);
+    UINT num = params.get_elem_count();
+    INLINFO_param_num(ii) = num;
+    if (num == 0) { return ii; }
+    INLINFO_param(ii) = (Var const**)xmalloc(sizeof(Var const*) * num);
+    INLINFO_param_bonus(ii) = (UINT*)xmalloc(sizeof(UINT) * num);
+    UINT i = 0;
+    for (Var const* p = params.get_head();
+         p != nullptr; p = params.get_next(), i++) {
+        INLINFO_param(ii)[i] = p;
+    }
+
+    //Estimate the IR size that saved if formal parameter is constant.
+    ConstIRIter it;
+    for (IR const* x = iterInitC(callee->getIRList(), it);
+         x != nullptr; x = iterNextC(it)) {
+        bool in_det = false;
+        if (x->is_ld()) {
+            in_det = false;
+        } else if (x->is_stmt() && x->hasJudgeDet()) {
+            in_det = true;
+        } else if (x->is_switch()) {
+            in_det = true;
+        } else {
+            continue;
+        }
+        ConstIRIter it2;
+        IR const* root = x->is_ld() ? x :
+            (x->is_switch() ? SWITCH_vexp(x) : x->getJudgeDet());
+        for (IR const* k = iterInitC(root, it2, false);
+             k != nullptr; k = iterNextC(it2, true)) {
+            if (!k->is_ld()) { continue; }
+            for (UINT j = 0; j < num; j++) {
+                if (LD_idinfo(k) != INLINFO_param(ii)[j]) { continue; }
+                INLINFO_param_bonus(ii)[j] += in_det ?
+                    INLINE_CONST_DET_BONUS : INLINE_CONST_USE_BONUS;
+                break;
             }
-            new_irs_in_caller = replaceReturn(caller, caller_irs,
-                                              new_irs_in_caller, ii);
-            xcom::insertafter(&caller_irs, new_irs_in_caller);
-            xcom::remove(&head, caller_irs);
-            change = true;
+            if (x->is_ld()) { break; }
         }
     }
-    caller->setIRList(head);
-    return change;
+    return ii;
 }
 
 
-//'cand': candidate that expected to be inlined.
-void Inliner::doInline(Region * cand)
+bool Inliner::isRecursive(Region const* caller, Region const* callee,
+                          xcom::SCC const& scc) const
 {
-    CallNode * cn = m_call_graph->mapRegion2CallNode(cand);
-    ASSERT0(cn);
-    xcom::Vertex * v = m_call_graph->getVertex(CN_id(cn));
-    ASSERT0(v);
-    AdjVertexIter it;
-    for (Vertex const* in = Graph::get_first_in_vertex(v, it);
-         in != nullptr; in = Graph::get_next_in_vertex(it)) {
-        Region * caller = m_call_graph->mapVertex2CallNode(in)->region();
-        if (caller != nullptr) {
-            doInlineImpl(caller, cand);
+    if (caller == callee) { return true; }
+    CallNode const* cn1 = m_call_graph->mapRegion2CallNode(caller);
+    CallNode const* cn2 = m_call_graph->mapRegion2CallNode(callee);
+    if (cn1 == nullptr || cn2 == nullptr) { return true; }
+    xcom::SCC::VertexSet * set = nullptr;
+    if (!scc.isInSCC((BSIdx)cn1->id(), &set)) { return false; }
+    ASSERT0(set);
+    return set->is_contain((BSIdx)cn2->id());
+}
+
+
+//Compute the frequency of the branch of 'ifstmt'.
+//is_true: true to compute the frequency of true-body.
+//freq: the frequency of 'ifstmt'.
+static UINT computeBranchFreq(IR const* ifstmt, bool is_true, UINT freq)
+{
+    AIContainer const* ai = ifstmt->getAI();
+    ProfileAttachInfo const* prof = ai == nullptr ? nullptr :
+        (ProfileAttachInfo const*)ai->get(AI_PROF);
+    if (prof != nullptr && prof->data != nullptr &&
+        prof->data[0] >= 0 && prof->data[1] >= 0 &&
+        prof->data[0] + prof->data[1] > 0) {
+        //Distribute the frequency according to the profile.
+        UINT64 taken = (UINT64)(is_true ? prof->data[0] : prof->data[1]);
+        return (UINT)(freq * taken / (UINT64)(prof->data[0] + prof->data[1]));
+    }
+    //Both branches are assumed to be taken evenly without profile.
+    return MAX(freq / 2, 1);
+}
+
+
+InlineCallSite * Inliner::evaluateCallSite(Region * caller, IR * call,
+                                           IR * parent, UINT kidx, UINT freq,
+                                           xcom::SCC const& scc)
+{
+    ASSERT0(call->is_call());
+    if (CALL_is_intrinsic(call)) { return nullptr; }
+    Region * callee = m_call_graph->getCalleeRegion(call, caller);
+    if (callee == nullptr || isRecursive(caller, callee, scc)) {
+        return nullptr;
+    }
+    InlineInfo * ii = getInlineInfo(callee);
+    if (!INLINFO_is_inlinable(ii)) { return nullptr; }
+    UINT argnum = xcom::cnt_list(CALL_arg_list(call));
+    if (argnum != INLINFO_param_num(ii)) {
+        //Variadic function or mismatched prototype.
+        return nullptr;
+    }
+    INT bonus = INLINE_CALL_COST + (INT)argnum;
+    UINT i = 0;
+    for (IR const* arg = CALL_arg_list(call);
+         arg != nullptr; arg = arg->get_next(), i++) {
+        if (arg->isConstExp() || arg->is_lda()) {
+            bonus += (INT)INLINFO_param_bonus(ii)[i];
         }
     }
+    INT growth = (INT)INLINFO_size(ii) - bonus;
+    bool is_hint = REGION_is_expect_inline(callee) &&
+        xcom::cnt_list(callee->getIRList()) < g_inline_threshold;
+    if (!is_hint && growth > 0 &&
+        (UINT64)growth * INLINE_FREQ_ONE >
+        (UINT64)g_inline_size_threshold * freq) {
+        //The call site is not executed frequently enough to pay
+        //for the growth.
+        return nullptr;
+    }
+    InlineCallSite * site = (InlineCallSite*)xmalloc(sizeof(InlineCallSite));
+    INLCS_call(site) = call;
+    INLCS_parent(site) = parent;
+    INLCS_kidx(site) = kidx;
+    INLCS_callee(site) = callee;
+    INLCS_caller(site) = caller;
+    INLCS_growth(site) = growth;
+    INLCS_freq(site) = freq;
+    INLCS_is_hint(site) = is_hint;
+    return site;
 }
 
 
-//Evaluate whether rg can be inlining candidate.
-bool Inliner::can_be_cand(Region * rg)
+//Return true if 'a' has higher priority than 'b'.
+static bool isHigherPriority(InlineCallSite const* a, InlineCallSite const* b)
+{
+    if (INLCS_is_hint(a) != INLCS_is_hint(b)) { return INLCS_is_hint(a); }
+    //Compare the benefit density: freq / growth.
+    INT ga = MAX(INLCS_growth(a), 1);
+    INT gb = MAX(INLCS_growth(b), 1);
+    return (UINT64)INLCS_freq(a) * (UINT64)gb >
+           (UINT64)INLCS_freq(b) * (UINT64)ga;
+}
+
+
+void Inliner::collectCallSite(Region * caller, IR * stmtlst, IR * parent,
+                              UINT kidx, UINT loop_depth, UINT freq,
+                              xcom::SCC const& scc,
+                              OUT List<InlineCallSite*> & sites)
+{
+    for (IR * x = stmtlst; x != nullptr; x = x->get_next()) {
+        if (x->is_call()) {
+            InlineCallSite * site = evaluateCallSite(
+                caller, x, parent, kidx, freq, scc);
+            if (site == nullptr) { continue; }
+            //Keep the list in descending order of priority, the site
+            //in front wins if priorities are equal.
+            xcom::C<InlineCallSite*> * ct;
+            bool inserted = false;
+            for (InlineCallSite * s = sites.get_head(&ct);
+                 s != nullptr; s = sites.get_next(&ct)) {
+                if (isHigherPriority(site, s)) {
+                    sites.insert_before(site, ct);
+                    inserted = true;
+                    break;
+                }
+            }
+            if (!inserted) { sites.append_tail(site); }
+            continue;
+        }
+        if (!x->isCFS()) { continue; }
+        bool is_loop = x->is_dowhile() || x->is_whiledo() || x->is_doloop();
+        for (UINT i = 0; i < IR_MAX_KID_NUM(x); i++) {
+            IR * k = x->getKid(i);
+            if (k == nullptr || !k->is_stmt()) { continue; }
+            UINT kfreq = freq;
+            UINT kdepth = loop_depth;
+            if (is_loop) {
+                kdepth++;
+                if (kdepth <= INLINE_MAX_LOOP_DEPTH) {
+                    kfreq *= INLINE_LOOP_FREQ_FACTOR;
+                }
+            } else if (x->is_if()) {
+                kfreq = computeBranchFreq(x, k == IF_truebody(x), freq);
+            }
+            collectCallSite(caller, k, x, i, kdepth, kfreq, scc, sites);
+        }
+    }
+}
+
+
+void Inliner::renameLabel(Region * caller, IR * irs)
 {
-    IR * ru_irs = rg->getIRList();
-    if (REGION_is_expect_inline(rg) &&
-        xcom::cnt_list(ru_irs) < g_inline_threshold) {
+    TMap<LabelInfo const*, LabelInfo const*> lab2lab;
+    IRIter it;
+    for (IR * x = iterInit(irs, it); x != nullptr; x = iterNext(it)) {
+        if (x->is_label()) {
+            lab2lab.set(LAB_lab(x), caller->genILabel());
+        }
+    }
+    if (lab2lab.get_elem_count() == 0) { return; }
+    it.clean();
+    for (IR * x = iterInit(irs, it); x != nullptr; x = iterNext(it)) {
+        LabelInfo const* li = x->getLabel();
+        if (li == nullptr) { continue; }
+        LabelInfo const* newli = lab2lab.get(li);
+        if (newli != nullptr) { x->setLabel(newli); }
+    }
+}
+
+
+void Inliner::renamePR(Region * caller, IR * irs)
+{
+    TMap<PRNO, PRNO> pr2pr;
+    IRIter it;
+    for (IR * x = iterInit(irs, it); x != nullptr; x = iterNext(it)) {
+        if (!x->isPROp()) { continue; }
+        PRNO prno = x->getPrno();
+        PRNO newprno = pr2pr.get(prno);
+        if (newprno == PRNO_UNDEF) {
+            newprno = caller->getIRMgr()->buildPrno(x->getType());
+            pr2pr.set(prno, newprno);
+        }
+        x->setPrno(newprno);
+    }
+}
+
+
+void Inliner::renameLocalVar(Region * caller, Region * callee, IR * irs,
+                             OUT TMap<Var const*, Var*> & var2var)
+{
+    VarTab * vt = callee->getVarTab();
+    VarMgr * vm = m_rumgr->getVarMgr();
+    xcom::StrBuf name(64);
+    IRIter it;
+    for (IR * x = iterInit(irs, it); x != nullptr; x = iterNext(it)) {
+        if (!x->hasIdinfo()) { continue; }
+        Var * v = x->getIdinfo();
+        if (!v->is_local() || !vt->find(v)) { continue; }
+        Var * newv = var2var.get(v);
+        if (newv == nullptr) {
+            //Each inlined call site owns its local variables.
+            VarFlag flag(v->getFlag());
+            flag.remove(VAR_IS_FORMAL_PARAM);
+            name.sprint("%s_inl_%s_%u", callee->getRegionName(),
+                        v->get_name()->getStr(), caller->getVarTab()->
+                        get_elem_count());
+            newv = vm->registerVar(name.getBuf(), v->getType(),
+                                   v->get_align(), flag);
+            caller->addToVarTab(newv);
+            var2var.set(v, newv);
+        }
+        x->setIdinfo(newv);
+    }
+}
+
+
+IR * Inliner::bindParam(Region * caller, IR * call, InlineInfo const* ii,
+                        TMap<Var const*, Var*> const& var2var)
+{
+    IR * args = CALL_arg_list(call);
+    CALL_arg_list(call) = nullptr;
+    IR * bind = nullptr;
+    IR * last = nullptr;
+    xcom::StrBuf name(64);
+    for (UINT i = 0; i < INLINFO_param_num(ii); i++) {
+        IR * arg = xcom::removehead(&args);
+        ASSERT0(arg);
+        Var * p = var2var.get(INLINFO_param(ii)[i]);
+        if (p == nullptr) {
+            //The parameter is not used in callee, however the argument
+            //may have side effect.
+            if (!arg->hasSideEffect(true)) {
+                caller->freeIRTree(arg);
+                continue;
+            }
+            //Each inlined call site owns its temporary variables.
+            name.sprint("%s_inl_unused_param%u_%u",
+                        CALL_idinfo(call)->get_name()->getStr(), i,
+                        caller->getVarTab()->get_elem_count());
+            p = m_rumgr->getVarMgr()->registerVar(
+                name.getBuf(), arg->getType(), 1, VAR_LOCAL);
+            caller->addToVarTab(p);
+        }
+        xcom::add_next(&bind, &last,
+                       caller->getIRMgr()->buildStore(p, arg));
+    }
+    ASSERT0(args == nullptr);
+    return bind;
+}
+
+
+void Inliner::addCallGraphEdge(Region * caller, IR const* irs)
+{
+    CallNode const* caller_cn = m_call_graph->mapRegion2CallNode(caller);
+    ASSERT0(caller_cn);
+    ConstIRIter it;
+    for (IR const* x = iterInitC(irs, it); x != nullptr; x = iterNextC(it)) {
+        if (!x->is_call()) { continue; }
+        CallNode const* cn = m_call_graph->findCallNode(
+            CALL_idinfo(x)->get_name(), caller);
+        if (cn == nullptr || cn->region() == nullptr) { continue; }
+        if (m_call_graph->getEdge(caller_cn->id(), cn->id()) == nullptr) {
+            m_call_graph->addEdge(caller_cn->id(), cn->id());
+        }
+    }
+}
+
+
+bool Inliner::doInlineCallSite(InlineCallSite const* site)
+{
+    Region * caller = INLCS_caller(site);
+    Region * callee = INLCS_callee(site);
+    IR * call = INLCS_call(site);
+    IR * parent = INLCS_parent(site);
+    InlineInfo * ii = getInlineInfo(callee);
+    ASSERT0(INLINFO_is_inlinable(ii));
+
+    IR * new_irs = caller->dupIRTreeList(callee->getIRList());
+    TMap<Var const*, Var*> var2var;
+    renameLocalVar(caller, callee, new_irs, var2var);
+    renamePR(caller, new_irs);
+    renameLabel(caller, new_irs);
+    addCallGraphEdge(caller, new_irs);
+    IR * bind = bindParam(caller, call, ii, var2var);
+    new_irs = replaceReturn(caller, call, new_irs, ii);
+    xcom::add_next(&bind, new_irs);
+
+    IR * head = parent == nullptr ?
+        caller->getIRList() : parent->getKid(INLCS_kidx(site));
+    IR * marker = call;
+    xcom::insertafter(&marker, bind);
+    xcom::remove(&head, call);
+    if (parent == nullptr) {
+        caller->setIRList(head);
+    } else {
+        parent->setKid(INLCS_kidx(site), head);
+    }
+    caller->freeIRTree(call);
+    return true;
+}
+
+
+void Inliner::inlineCaller(Region * caller, xcom::SCC const& scc)
+{
+    if (caller->getIRList() == nullptr) { return; }
+    List<InlineCallSite*> sites;
+    collectCallSite(caller, caller->getIRList(), nullptr, 0, 0,
+                    INLINE_FREQ_ONE, scc, sites);
+    if (sites.get_elem_count() == 0) { return; }
+    UINT size = computeSize(caller);
+    UINT limit = size + MAX(size * g_inline_caller_growth / 100,
+                            g_inline_size_threshold);
+    for (InlineCallSite * s = sites.get_head();
+         s != nullptr; s = sites.get_next()) {
+        INT growth = INLCS_growth(s);
+        if (growth > 0 && (size + (UINT)growth > limit ||
+            m_program_size + (UINT)growth > m_program_limit)) {
+            //Exceed the growth budget.
+            continue;
+        }
+        if (!doInlineCallSite(s)) { continue; }
+        size = (UINT)MAX((INT)size + growth, 0);
+        m_program_size = (UINT)MAX((INT)m_program_size + growth, 0);
+        m_inlined_num++;
+        m_inlined_list.append_tail(s);
+    }
+}
+
+
+void Inliner::computeBottomUpOrder(OUT Vector<Region*> & order) const
+{
+    //Post-order of call graph places callee ahead of caller. The vertex
+    //that is visited again via back-edge is in the same SCC with its
+    //caller, and it will not be inlined.
+    xcom::BitSet visited;
+    xcom::Stack<Vertex const*> vstk;
+    xcom::Stack<xcom::EdgeC const*> estk;
+    for (IR const* x = m_program->getIRList(); x != nullptr;
+         x = x->get_next()) {
+        if (!x->is_region()) { continue; }
+        CallNode const* cn = m_call_graph->mapRegion2CallNode(REGION_ru(x));
+        if (cn == nullptr) { continue; }
+        Vertex const* root = m_call_graph->getVertex(cn->id());
+        if (root == nullptr || visited.is_contain((BSIdx)root->id())) {
+            continue;
+        }
+        visited.bunion((BSIdx)root->id());
+        vstk.push(root);
+        estk.push(root->getOutList());
+        while (vstk.get_elem_count() != 0) {
+            xcom::EdgeC const* ec = estk.pop();
+            if (ec == nullptr) {
+                Vertex const* v = vstk.pop();
+                Region * rg = m_call_graph->mapVertex2CallNode(v)->region();
+                if (rg != nullptr && rg->is_function()) { order.append(rg); }
+                continue;
+            }
+            estk.push(EC_next(ec));
+            Vertex const* to = ec->getTo();
+            if (visited.is_contain((BSIdx)to->id())) { continue; }
+            visited.bunion((BSIdx)to->id());
+            vstk.push(to);
+            estk.push(to->getOutList());
+        }
+    }
+}
+
+
+bool Inliner::dump() const
+{
+    if (!getRegion()->isLogMgrInit() || !g_dump_opt.isDumpInliner()) {
         return true;
     }
-    return false;
+    note(getRegion(), "\n==---- DUMP %s '%s' ----==",
+         getPassName(), m_rg->getRegionName());
+    getRegion()->getLogMgr()->incIndent(2);
+    note(getRegion(), "\nINLINED:%u PROGRAM_SIZE:%u->%u LIMIT:%u",
+         m_inlined_num, m_init_program_size, m_program_size,
+         m_program_limit);
+    xcom::C<InlineCallSite*> * ct;
+    for (InlineCallSite const* s = m_inlined_list.get_head(&ct);
+         s != nullptr; s = m_inlined_list.get_next(&ct)) {
+        note(getRegion(), "\n%s -> %s: GROWTH:%d FREQ:%u%s",
+             INLCS_caller(s)->getRegionName(),
+             INLCS_callee(s)->getRegionName(), INLCS_growth(s),
+             INLCS_freq(s), INLCS_is_hint(s) ? " (expect-inline)" : "");
+    }
+    bool succ = Pass::dump();
+    getRegion()->getLogMgr()->decIndent(2);
+    return succ;
 }
 
 
 bool Inliner::perform(OptCtx & oc)
 {
     START_TIMER(t, getPassName());
-    DUMMYUSE(oc);
     ASSERT0(oc.is_callgraph_valid());
     ASSERT0(m_program && m_program->is_program());
-    IR * irs = m_program->getIRList();
-    while (irs != nullptr) {
-        if (irs->is_region()) {
-            Region * rg = REGION_ru(irs);
-            if (can_be_cand(rg)) {
-                doInline(rg);
-            }
+    m_inlined_num = 0;
+    m_program_size = 0;
+    for (IR const* x = m_program->getIRList(); x != nullptr;
+         x = x->get_next()) {
+        if (x->is_region() && REGION_ru(x)->is_function()) {
+            m_program_size += computeSize(REGION_ru(x));
         }
-        irs = irs->get_next();
+    }
+    m_init_program_size = m_program_size;
+    m_program_limit = m_program_size +
+        m_program_size * g_inline_program_growth / 100;
+
+    xcom::SCC scc(m_call_graph);
+    scc.findSCC();
+    Vector<Region*> order;
+    computeBottomUpOrder(order);
+    for (VecIdx i = 0; i < (VecIdx)order.get_elem_count(); i++) {
+        inlineCaller(order.get(i), scc);
+    }
+    if (g_dump_opt.isDumpAfterPass() && g_dump_opt.isDumpInliner()) {
+        dump();
     }
     END_TIMER(t, getPassName());
-    return false;
+    DUMMYUSE(oc);
+    return m_inlined_num != 0;
 }
 //END Inliner
 
@@ -36,8 +36,36 @@ author: Su Zhenyu
 
 namespace xoc {
 
+//The estimated frequency of call site is represented in fixed-point number,
+//INLINE_FREQ_ONE means the call site executes once per invocation of caller.
+#define INLINE_FREQ_ONE 16
+
+//The frequency factor of each loop level that call site resident in.
+#define INLINE_LOOP_FREQ_FACTOR 8
+
+//The max loop depth that contributes to the frequency of call site.
+#define INLINE_MAX_LOOP_DEPTH 3
+
+//The IR size of calling sequence that saved by inlining, excluding the
+//arguments.
+#define INLINE_CALL_COST 4
+
+//The IR size that saved by each use of the formal parameter that bound to
+//a constant argument.
+#define INLINE_CONST_USE_BONUS 1
+
+//The IR size that saved by each use of the formal parameter that bound to
+//a constant argument in the determinate-expression of branch, since the
+//branch and one of its targets are likely to be folded.
+#define INLINE_CONST_DET_BONUS 8
+
 #define INLINFO_need_el(i)        ((i)->need_el)
 #define INLINFO_has_ret(i)        ((i)->has_ret)
+#define INLINFO_is_inlinable(i)   ((i)->is_inlinable)
+#define INLINFO_size(i)           ((i)->size)
+#define INLINFO_param_num(i)      ((i)->param_num)
+#define INLINFO_param(i)          ((i)->param)
+#define INLINFO_param_bonus(i)    ((i)->param_bonus)
 class InlineInfo {
     COPY_CONSTRUCTOR(InlineInfo);
 public:
@@ -45,23 +73,131 @@ public:
 
     BYTE need_el:1;
     BYTE has_ret:1;
+    BYTE is_inlinable:1;
+
+    //The number of IR in callee.
+    UINT size;
+
+    //The number of formal parameter of callee.
+    UINT param_num;
+
+    //Record formal parameters in declaration order.
+    Var const** param;
+
+    //Record the IR size that saved if the formal parameter is bound to a
+    //constant argument.
+    UINT * param_bonus;
+};
+
+
+#define INLCS_call(s)     ((s)->call)
+#define INLCS_parent(s)   ((s)->parent)
+#define INLCS_kidx(s)     ((s)->kidx)
+#define INLCS_callee(s)   ((s)->callee)
+#define INLCS_growth(s)   ((s)->growth)
+#define INLCS_freq(s)     ((s)->freq)
+#define INLCS_is_hint(s)  ((s)->is_hint)
+#define INLCS_caller(s)   ((s)->caller)
+//The class records a call site that is expected to be inlined.
+class InlineCallSite {
+    COPY_CONSTRUCTOR(InlineCallSite);
+public:
+    InlineCallSite() {}
+
+    //True if the callee is marked as expect-inline.
+    BYTE is_hint:1;
+
+    //The kid index of 'parent' that 'call' resident in.
+    UINT kidx;
+
+    //The estimated frequency of call site, in unit of INLINE_FREQ_ONE.
+    UINT freq;
+
+    //The estimated IR growth of caller after inlining.
+    INT growth;
+
+    //The call stmt.
+    IR * call;
+
+    //The stmt whose kid is the stmt list that 'call' resident in.
+    //It is nullptr if 'call' resident in the IR list of caller.
+    IR * parent;
+
+    Region * callee;
+    Region * caller;
 };
 
 
+//The class performs function inlining in bottom-up order of call graph.
+//Each call site is scored by the estimated IR growth of callee, the constant
+//arguments, the loop depth and the branch frequency of profile, and it is
+//inlined if the growth is worth to its frequency. The inlining is limited
+//by the growth budgets of caller and whole program.
 class Inliner : public Pass {
     COPY_CONSTRUCTOR(Inliner);
 protected:
+    UINT m_inlined_num;
+    UINT m_program_size; //The size of all function regions.
+    UINT m_program_limit; //The size limit of all function regions.
+    UINT m_init_program_size;
     RegionMgr * m_rumgr;
     SMemPool * m_pool;
     CallGraph * m_call_graph;
     Region * m_program;
     TMap<Region*, InlineInfo*> m_ru2inl;
+    List<InlineCallSite*> m_inlined_list;
 protected:
-    bool doInlineImpl(Region * caller, Region * callee);
-protected:
+    //Add call graph edges from 'caller' to the callee regions of the calls
+    //in 'irs'.
+    void addCallGraphEdge(Region * caller, IR const* irs);
+
+    //Bind the arguments of 'call' to the new formal parameters, and return
+    //the IR list of binding.
+    IR * bindParam(Region * caller, IR * call, InlineInfo const* ii,
+                   TMap<Var const*, Var*> const& var2var);
+
     void checkRegion(IN Region * rg, OUT bool & need_el,
                      OUT bool & has_ret) const;
 
+    //Collect call sites in 'stmtlst' and evaluate them.
+    //parent: the stmt whose kid is 'stmtlst'.
+    //kidx: the kid index of 'parent'.
+    //loop_depth: the loop depth of 'stmtlst'.
+    //freq: the estimated frequency of 'stmtlst'.
+    void collectCallSite(Region * caller, IR * stmtlst, IR * parent,
+                         UINT kidx, UINT loop_depth, UINT freq,
+                         xcom::SCC const& scc,
+                         OUT List<InlineCallSite*> & sites);
+
+    //Compute the order of regions that callee is ahead of caller.
+    void computeBottomUpOrder(OUT Vector<Region*> & order) const;
+    InlineInfo * computeInlineInfo(Region * callee);
+
+    //Return the number of IR in the IR list of 'rg'.
+    static UINT computeSize(Region const* rg);
+
+    bool doInlineCallSite(InlineCallSite const* site);
+
+    //Evaluate whether the call site is worth to be inlined.
+    InlineCallSite * evaluateCallSite(Region * caller, IR * call,
+                                      IR * parent, UINT kidx, UINT freq,
+                                      xcom::SCC const& scc);
+
+    InlineInfo * getInlineInfo(Region * rg)
+    {
+        InlineInfo * ii = m_ru2inl.get(rg);
+        if (ii == nullptr) { ii = computeInlineInfo(rg); }
+        return ii;
+    }
+
+    //Inline call sites of 'caller' in descending order of priority.
+    void inlineCaller(Region * caller, xcom::SCC const& scc);
+
+    //Return true if 'caller' and 'callee' are in the same SCC of
+    //call graph, namely, they are mutual recursive.
+    bool isRecursive(Region const* caller, Region const* callee,
+                     xcom::SCC const& scc) const;
+
     void * xmalloc(UINT size)
     {
         void * p = smpoolMalloc(size, m_pool);
@@ -70,20 +206,17 @@ protected:
         return p;
     }
 
-    InlineInfo * mapRegion2InlineInfo(Region * rg, bool alloc)
-    {
-        InlineInfo * ii = m_ru2inl.get(rg);
-        if (ii == nullptr && alloc) {
-            ii = (InlineInfo*)xmalloc(sizeof(InlineInfo));
-            m_ru2inl.set(rg, ii);
-        }
-        return ii;
-    }
+    //Rename labels, PRs and local variables in 'irs' that duplicated from
+    //'callee' to avoid conflicting with the ones of 'caller'.
+    void renameLabel(Region * caller, IR * irs);
+    void renameLocalVar(Region * caller, Region * callee, IR * irs,
+                        OUT TMap<Var const*, Var*> & var2var);
+    void renamePR(Region * caller, IR * irs);
 
     IR * replaceReturnImpl(Region * caller, IR * caller_call, IR * new_irs,
                            LabelInfo * el);
 public:
-    Inliner(Region * program)
+    Inliner(Region * program) : Pass(program)
     {
         ASSERT0(program && program->is_program());
         m_rumgr = program->getRegionMgr();
@@ -92,13 +225,16 @@ public:
         m_call_graph = m_program->getCallGraph();
         ASSERTN(m_call_graph, ("Inliner need callgraph"));
         m_pool = smpoolCreate(16, MEM_COMM);
+        m_inlined_num = 0;
+        m_program_size = 0;
+        m_program_limit = 0;
+        m_init_program_size = 0;
     }
     virtual ~Inliner() { smpoolDelete(m_pool); }
 
+    //Return true if 'rg' can be inlined structurally.
     bool can_be_cand(Region * rg);
 
-    void doInline(Region * cand);
-
     //The function dump pass relative information before performing the pass.
     //The dump information is always used to detect what the pass did.
     //Return true if dump successed, otherwise false.
@@ -107,9 +243,7 @@ public:
     //The function dump pass relative information.
     //The dump information is always used to detect what the pass did.
     //Return true if dump successed, otherwise false.
-    virtual bool dump() const { return Pass::dump(); }
-
-    inline bool is_call_site(IR * call, Region * rg);
+    virtual bool dump() const;
 
     virtual PASS_TYPE getPassType() const { return PASS_INLINER; }
     virtual CHAR const* getPassName() const { return "Inliner"; }
@@ -204,6 +204,7 @@ void IPA::recomputeDUChain(Region * rg, OptCtx & oc)
         }
         DUMgr * dumgr = (DUMgr*)rg->getPassMgr()->registerPass(PASS_DU_MGR);
         ASSERT0(dumgr);
+        ProfScope prof(dumgr->getPassName(), PROF_PASS, rg);
         dumgr->perform(oc, DUOptFlag(DUOPT_SOL_REACH_DEF|DUOPT_COMPUTE_PR_DU));
         dumgr->computeMDDUChain(oc, false, DUOptFlag(DUOPT_COMPUTE_PR_DU));
         bool rmprdu = false;
@@ -247,6 +248,454 @@ void IPA::recomputeDUChain(Region * rg, OptCtx & oc)
 }
 
 
+ModRefSummary const* getCalleeModRefSummary(IR const* call,
+                                            Region const* caller)
+{
+    ASSERT0(call->isCallStmt());
+    //The icall is resolved only if its target is known, see
+    //CallGraph::getCalleeRegion(). The caller has to be conservative to
+    //the icall with unknown target since the summary is unavailable.
+    CallGraph * cg = caller->getCallGraphPreferProgramRegion();
+    if (cg == nullptr) { return nullptr; }
+    Region const* callee = cg->getCalleeRegion(call, caller);
+    if (callee == nullptr) { return nullptr; }
+    ModRefSummary const* s = callee->getModRefSummary();
+    if (s == nullptr || !s->isUsable()) { return nullptr; }
+    return s;
+}
+
+
+//
+//START ModRefComputer
+//
+//The class scans the IR of function region to compute the MOD/REF
+//summary of the region. The memory that accessed through pointer formal
+//parameter is summarized as argument memory, which will be mapped to the
+//point-to set of actual argument at call site.
+class ModRefComputer {
+    COPY_CONSTRUCTOR(ModRefComputer);
+    Region * m_rg;
+    CallGraph const* m_cg;
+    MDSystem * m_mdsys;
+    ModRefSummary * m_sum;
+    xcom::DefMiscBitSetMgr * m_sbsmgr;
+    Vector<IR const*> m_stmts;
+
+    //Record formal parameters that have been modified or taken address.
+    TTab<Var const*> m_unclean_param;
+
+    //Record whether PR only holds the value that derived from pointer
+    //formal parameter. 1 means yes, 2 means no.
+    TMap<PRNO, UINT> m_pr2arg;
+protected:
+    void addArg(IR const* arg, bool is_mod, bool is_ref);
+    void addIndirect(IR const* base, bool is_def);
+    void addVar(Var * v, bool is_def);
+    void collectStmt();
+    void collectUncleanParam();
+    void collectArgPR();
+    bool isArgBase(IR const* e, bool use_pr) const;
+    void processCall(IR const* ir);
+    void processIR(IR const* ir);
+    void setWorst(bool is_mod, bool is_ref)
+    {
+        if (is_mod) { MODREF_is_mod_worst(m_sum) = true; }
+        if (is_ref) { MODREF_is_ref_worst(m_sum) = true; }
+    }
+public:
+    ModRefComputer(Region * rg, CallGraph const* cg) : m_rg(rg), m_cg(cg)
+    {
+        m_mdsys = rg->getMDSystem();
+        m_sum = rg->genModRefSummary();
+        m_sbsmgr = rg->getMiscBitSetMgr();
+    }
+
+    //Return true if summary changed.
+    bool compute();
+};
+
+
+void ModRefComputer::collectStmt()
+{
+    if (m_rg->getIRList() != nullptr) {
+        for (IR const* x = m_rg->getIRList(); x != nullptr; x = x->get_next()) {
+            m_stmts.append(x);
+        }
+        return;
+    }
+    BBList * bbl = m_rg->getBBList();
+    if (bbl == nullptr) { return; }
+    for (IRBB * bb = bbl->get_head(); bb != nullptr; bb = bbl->get_next()) {
+        BBIRListIter it;
+        for (IR const* x = bb->getIRList().get_head(&it);
+             x != nullptr; x = bb->getIRList().get_next(&it)) {
+            m_stmts.append(x);
+        }
+    }
+}
+
+
+void ModRefComputer::collectUncleanParam()
+{
+    VarTab * vt = m_rg->getVarTab();
+    ConstIRIter it;
+    for (VecIdx i = 0; i < (VecIdx)m_stmts.get_elem_count(); i++) {
+        it.clean();
+        for (IR const* x = iterInitC(m_stmts.get(i), it, false);
+             x != nullptr; x = iterNextC(it)) {
+            if (!(x->is_st() || x->is_lda())) { continue; }
+            Var * v = x->getIdinfo();
+            if (v->is_formal_param() && vt->find(v)) {
+                m_unclean_param.append(v);
+            }
+        }
+    }
+}
+
+
+void ModRefComputer::collectArgPR()
+{
+    ConstIRIter it;
+    for (VecIdx i = 0; i < (VecIdx)m_stmts.get_elem_count(); i++) {
+        it.clean();
+        for (IR const* x = iterInitC(m_stmts.get(i), it, false);
+             x != nullptr; x = iterNextC(it)) {
+            if (!x->is_stmt()) { continue; }
+            if (!x->isWritePR() &&
+                !(x->isCallStmt() && x->hasReturnValue())) {
+                continue;
+            }
+            PRNO prno = x->getPrno();
+            if (x->is_stpr() && isArgBase(STPR_rhs(x), false) &&
+                m_pr2arg.get(prno) != 2) {
+                m_pr2arg.setAlways(prno, 1);
+                continue;
+            }
+            m_pr2arg.setAlways(prno, 2);
+        }
+    }
+}
+
+
+//Return true if 'e' computes an address that derived from pointer formal
+//parameter.
+bool ModRefComputer::isArgBase(IR const* e, bool use_pr) const
+{
+    switch (e->getCode()) {
+    case IR_LD: {
+        Var * v = LD_idinfo(e);
+        return e->isPtr() && v->is_formal_param() &&
+               m_rg->getVarTab()->find(v) &&
+               !m_unclean_param.find(v);
+    }
+    case IR_PR:
+        return use_pr && m_pr2arg.get(PR_no(e)) == 1;
+    case IR_CVT:
+        return isArgBase(CVT_exp(e), use_pr);
+    case IR_ADD:
+        return (isArgBase(BIN_opnd0(e), use_pr) && !BIN_opnd1(e)->isPtr()) ||
+               (isArgBase(BIN_opnd1(e), use_pr) && !BIN_opnd0(e)->isPtr());
+    case IR_SUB:
+        return isArgBase(BIN_opnd0(e), use_pr) && !BIN_opnd1(e)->isPtr();
+    default:;
+    }
+    return false;
+}
+
+
+void ModRefComputer::addVar(Var * v, bool is_def)
+{
+    if (m_rg->getVarTab()->find(v)) {
+        //Local variable is invisible to caller.
+        return;
+    }
+    MD const* md = m_mdsys->registerUnboundMD(v, 0);
+    ASSERT0(md);
+    if (is_def) {
+        MODREF_mod(m_sum)->bunion(md, *m_sbsmgr);
+        return;
+    }
+    MODREF_ref(m_sum)->bunion(md, *m_sbsmgr);
+}
+
+
+void ModRefComputer::addIndirect(IR const* base, bool is_def)
+{
+    if (base->is_lda()) {
+        addVar(LDA_idinfo(base), is_def);
+        return;
+    }
+    if (isArgBase(base, true)) {
+        if (is_def) { MODREF_is_mod_arg(m_sum) = true; }
+        else { MODREF_is_ref_arg(m_sum) = true; }
+        return;
+    }
+    setWorst(is_def, !is_def);
+}
+
+
+//Map the argument memory of callee to the memory of current region.
+void ModRefComputer::addArg(IR const* arg, bool is_mod, bool is_ref)
+{
+    if (arg->is_lda()) {
+        if (is_mod) { addVar(LDA_idinfo(arg), true); }
+        if (is_ref) { addVar(LDA_idinfo(arg), false); }
+        return;
+    }
+    if (arg->isConstExp()) {
+        //e.g: foo(NULL);
+        return;
+    }
+    if (isArgBase(arg, true)) {
+        if (is_mod) { MODREF_is_mod_arg(m_sum) = true; }
+        if (is_ref) { MODREF_is_ref_arg(m_sum) = true; }
+        return;
+    }
+    setWorst(is_mod, is_ref);
+}
+
+
+void ModRefComputer::processCall(IR const* ir)
+{
+    ASSERT0(ir->isCallStmt());
+    if (ir->is_icall()) {
+        //CallGraph does not have the edge to the known target of icall,
+        //the summary of target may not be computed before current region
+        //in bottom-up order.
+        setWorst(!ir->isReadOnly(), true);
+        return;
+    }
+    if (CALL_is_alloc_heap(ir)) {
+        //Allocation function does not modify the memory in XOC scope.
+        return;
+    }
+    Region * callee = m_cg->getCalleeRegion(ir, m_rg);
+    ModRefSummary const* cs = callee == nullptr ?
+        nullptr : callee->getModRefSummary();
+    if (cs == nullptr) {
+        setWorst(!ir->isReadOnly(), true);
+        return;
+    }
+    setWorst(MODREF_is_mod_worst(cs), MODREF_is_ref_worst(cs));
+    if (cs != m_sum) {
+        MODREF_mod(m_sum)->bunion(*MODREF_mod(cs), *m_sbsmgr);
+        MODREF_ref(m_sum)->bunion(*MODREF_ref(cs), *m_sbsmgr);
+    }
+    if (!MODREF_is_mod_arg(cs) && !MODREF_is_ref_arg(cs)) { return; }
+    for (IR const* p = CALL_arg_list(ir); p != nullptr; p = p->get_next()) {
+        addArg(p, MODREF_is_mod_arg(cs), MODREF_is_ref_arg(cs));
+    }
+}
+
+
+void ModRefComputer::processIR(IR const* ir)
+{
+    if (ir->is_region()) {
+        setWorst(true, true);
+        return;
+    }
+    if (ir->isCallStmt()) {
+        processCall(ir);
+        return;
+    }
+    if (!ir->isMemRefNonPR()) { return; }
+    bool is_def = ir->is_stmt();
+    if (ir->isArrayOp()) {
+        addIndirect(ARR_base(ir), is_def);
+        return;
+    }
+    if (ir->isIndirectMemOp()) {
+        addIndirect(ir->getBase(), is_def);
+        return;
+    }
+    ASSERT0(ir->hasIdinfo());
+    addVar(ir->getIdinfo(), is_def);
+}
+
+
+bool ModRefComputer::compute()
+{
+    UINT modnum = MODREF_mod(m_sum)->get_elem_count();
+    UINT refnum = MODREF_ref(m_sum)->get_elem_count();
+    BYTE flag = (BYTE)(MODREF_is_mod_worst(m_sum) |
+        (MODREF_is_ref_worst(m_sum) << 1) | (MODREF_is_mod_arg(m_sum) << 2) |
+        (MODREF_is_ref_arg(m_sum) << 3));
+    if (m_rg->is_blackbox()) {
+        setWorst(true, true);
+        return flag != 0x3;
+    }
+    collectStmt();
+    collectUncleanParam();
+    collectArgPR();
+    ConstIRIter it;
+    for (VecIdx i = 0; i < (VecIdx)m_stmts.get_elem_count(); i++) {
+        it.clean();
+        for (IR const* x = iterInitC(m_stmts.get(i), it, false);
+             x != nullptr; x = iterNextC(it)) {
+            processIR(x);
+        }
+    }
+    BYTE newflag = (BYTE)(MODREF_is_mod_worst(m_sum) |
+        (MODREF_is_ref_worst(m_sum) << 1) | (MODREF_is_mod_arg(m_sum) << 2) |
+        (MODREF_is_ref_arg(m_sum) << 3));
+    return modnum != MODREF_mod(m_sum)->get_elem_count() ||
+           refnum != MODREF_ref(m_sum)->get_elem_count() || flag != newflag;
+}
+//END ModRefComputer
+
+
+//Return true if the summary of 'rg' changed.
+bool IPA::computeModRef(Region * rg, CallGraph const* cg)
+{
+    ModRefComputer mrc(rg, cg);
+    return mrc.compute();
+}
+
+
+//Compute the post-order of CallGraph, callee is placed ahead of caller.
+//Note all members of a SCC are placed ahead of the caller that out of SCC.
+void IPA::computeBottomUpOrder(CallGraph const* cg,
+                               OUT Vector<Region*> & order) const
+{
+    xcom::BitSet visited;
+    xcom::Stack<Vertex const*> vstk;
+    xcom::Stack<xcom::EdgeC const*> estk;
+    for (IR const* x = m_program->getIRList(); x != nullptr;
+         x = x->get_next()) {
+        if (!x->is_region()) { continue; }
+        CallNode const* cn = cg->mapRegion2CallNode(REGION_ru(x));
+        if (cn == nullptr) { continue; }
+        Vertex const* root = cg->getVertex(cn->id());
+        if (root == nullptr || visited.is_contain((BSIdx)root->id())) {
+            continue;
+        }
+        visited.bunion((BSIdx)root->id());
+        vstk.push(root);
+        estk.push(root->getOutList());
+        while (vstk.get_elem_count() != 0) {
+            xcom::EdgeC const* ec = estk.pop();
+            if (ec == nullptr) {
+                Vertex const* v = vstk.pop();
+                Region * rg = cg->mapVertex2CallNode(v)->region();
+                if (rg != nullptr && rg->is_function()) { order.append(rg); }
+                continue;
+            }
+            estk.push(EC_next(ec));
+            Vertex const* to = ec->getTo();
+            if (visited.is_contain((BSIdx)to->id())) { continue; }
+            visited.bunion((BSIdx)to->id());
+            vstk.push(to);
+            estk.push(to->getOutList());
+        }
+    }
+}
+
+
+void IPA::computeModRefForSCC(xcom::SCC::VertexSet const* set,
+                              CallGraph const* cg)
+{
+    bool change = true;
+    UINT count = 0;
+    while (change) {
+        ASSERT0(count++ < 1000);
+        change = false;
+        DefSBitSetIter it = nullptr;
+        for (BSIdx i = set->get_first(&it);
+             i != BS_UNDEF; i = set->get_next(i, &it)) {
+            CallNode const* cn = cg->getCallNode((UINT)i);
+            if (cn == nullptr || cn->region() == nullptr ||
+                !cn->region()->is_function()) {
+                continue;
+            }
+            change |= computeModRef(cn->region(), cg);
+        }
+    }
+    DUMMYUSE(count);
+}
+
+
+void IPA::computeModRefSummary(OptCtx & oc)
+{
+    START_TIMER(t, "Compute ModRef Summary");
+    ASSERT0(oc.is_callgraph_valid());
+    DUMMYUSE(oc);
+    CallGraph const* cg = m_program->getCallGraph();
+    ASSERTN(cg, ("IPA need call-graph"));
+    xcom::SCC scc(const_cast<CallGraph*>(cg));
+    scc.findSCC();
+    Vector<Region*> order;
+    computeBottomUpOrder(cg, order);
+
+    //Record the position of region in bottom-up order.
+    TMap<UINT, UINT> vid2pos;
+    for (VecIdx i = 0; i < (VecIdx)order.get_elem_count(); i++) {
+        Region * rg = order.get(i);
+        rg->genModRefSummary();
+        vid2pos.set(cg->mapRegion2CallNode(rg)->id(), (UINT)i + 1);
+    }
+    for (VecIdx i = 0; i < (VecIdx)order.get_elem_count(); i++) {
+        Region * rg = order.get(i);
+        UINT vid = cg->mapRegion2CallNode(rg)->id();
+        xcom::SCC::VertexSet * set = nullptr;
+        if (!scc.isInSCC((BSIdx)vid, &set)) {
+            //Iterate for self-recursive region.
+            while (computeModRef(rg, cg)) {}
+            continue;
+        }
+        ASSERT0(set);
+        //Solve the SCC once all members have been reached, because the
+        //callee of the member that out of SCC is placed ahead of the last
+        //member in bottom-up order.
+        bool all_reached = true;
+        DefSBitSetIter it = nullptr;
+        for (BSIdx j = set->get_first(&it);
+             j != BS_UNDEF; j = set->get_next(j, &it)) {
+            UINT pos = vid2pos.get((UINT)j);
+            if (pos > (UINT)i + 1) { all_reached = false; break; }
+        }
+        if (all_reached) {
+            computeModRefForSCC(set, cg);
+        }
+    }
+    //Function that neither modifies nor references any memory visible to
+    //caller is readonly, the call to it can be hoisted or removed if the
+    //arguments permit.
+    for (VecIdx i = 0; i < (VecIdx)order.get_elem_count(); i++) {
+        Region * rg = order.get(i);
+        if (rg->getModRefSummary()->isNoMemEffect() &&
+            rg->getRegionVar() != nullptr) {
+            rg->getRegionVar()->setFlag(VAR_READONLY);
+            REGION_is_readonly(rg) = true;
+        }
+    }
+    END_TIMER(t, "Compute ModRef Summary");
+    if (g_dump_opt.isDumpAfterPass() && g_dump_opt.isDumpIPA()) {
+        dumpModRefSummary();
+    }
+}
+
+
+void IPA::dumpModRefSummary() const
+{
+    if (!m_program->isLogMgrInit()) { return; }
+    note(m_program, "\n==---- DUMP %s MODREF SUMMARY '%s' ----==",
+         getPassName(), m_program->getRegionName());
+    m_program->getLogMgr()->incIndent(2);
+    for (IR const* x = m_program->getIRList(); x != nullptr;
+         x = x->get_next()) {
+        if (!x->is_region()) { continue; }
+        Region const* rg = REGION_ru(x);
+        ModRefSummary const* s = rg->getModRefSummary();
+        if (s == nullptr) { continue; }
+        note(m_program, "\n-- %s --", rg->getRegionName());
+        m_program->getLogMgr()->incIndent(2);
+        s->dump(m_program);
+        m_program->getLogMgr()->decIndent(2);
+    }
+    m_program->getLogMgr()->decIndent(2);
+}
+
+
 //NOTE: IPA should be performed on program region.
 //IPA will create dummy use for each region, and recompute the
 //DU chain if any required.
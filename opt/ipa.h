@@ -36,6 +36,12 @@ author: Su Zhenyu
 
 namespace xoc {
 
+//Return the usable MOD/REF summary of the callee of 'call', or nullptr if
+//the summary is not available.
+//caller: the region that 'call' resident in.
+ModRefSummary const* getCalleeModRefSummary(IR const* call,
+                                            Region const* caller);
+
 class IPA : public Pass {
     COPY_CONSTRUCTOR(IPA);
 protected:
@@ -64,6 +70,12 @@ protected:
 
     Region * findRegion(IR * call, Region * callru);
 
+    void computeBottomUpOrder(CallGraph const* cg,
+                              OUT Vector<Region*> & order) const;
+    bool computeModRef(Region * rg, CallGraph const* cg);
+    void computeModRefForSCC(xcom::SCC::VertexSet const* set,
+                             CallGraph const* cg);
+
 public:
     IPA(Region * program)
     {
@@ -81,6 +93,14 @@ public:
 
     void computeCallRefForAllRegion();
 
+    //Compute MOD/REF summary for each function region bottom-up on
+    //CallGraph. Regions in same SCC are iterated until the summaries
+    //reach a fixed point. The summary will be used at call site to
+    //substitute the worst case side effect of call.
+    void computeModRefSummary(OptCtx & oc);
+
+    void dumpModRefSummary() const;
+
     void setKeepDUMgr(bool keep) { m_is_keep_dumgr = keep; }
     void setKeepReachdef(bool keep) { m_is_keep_reachdef = keep; }
     void setRecomputeDURef(bool doit) { m_is_recompute_du_ref = doit; }
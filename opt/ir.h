@@ -139,7 +139,11 @@ public:
 #define IR_prev(ir) ((ir)->prev)
 
 //Record attached info container.
+#ifdef COMPACT_IR_LAYOUT
+#define IR_ai(ir) (*xoc::IRArena::getAIAddr(ir))
+#else
 #define IR_ai(ir) ((ir)->attach_info_container)
+#endif
 
 //This flag describes concurrency semantics.
 //It is true if current operation is atomic.
@@ -226,7 +230,7 @@ public:
 class IR {
     COPY_CONSTRUCTOR(IR);
 public:
-    #ifdef LIMITED_MEMORY_SPACE
+    #if defined(LIMITED_MEMORY_SPACE) || defined(COMPACT_IR_LAYOUT)
     USHORT code:IR_CODE_BIT_SIZE;
 
     //True if IR may throw excetion.
@@ -279,6 +283,17 @@ public:
     //The type of IR can be ANY that depend on the dynamic behavior of program.
     Type const* result_data_type;
 
+    #ifdef COMPACT_IR_LAYOUT
+    //Both of 'next' and 'prev' used by the processing of
+    //complicated tree level IR construction.
+    IRRef next;
+    IRRef prev;
+
+    //Used in all processing at all level IR.
+    //This field should be nullptr if IR is the top level of stmt.
+    //NOTE: attach-info container is recorded in the side table of IRMgr.
+    IRRef parent;
+    #else
     //Both of 'next' and 'prev' used by the processing of
     //complicated tree level IR construction.
     IR * next;
@@ -290,6 +305,7 @@ public:
 
     //IR may have an unique attach-info container.
     AIContainer * attach_info_container;
+    #endif
 public:
     //Calculate the accumulated offset value from the base of array.
     //e.g: For given array long long p[10][20],
@@ -535,11 +535,7 @@ MDSet const* AliasAnalysis::computeMayPointToViaTBAA(IR const* pointer,
     //TBAA tell us where pointer pointed to.
     if (typed_md != nullptr) {
         //Try to resolve POINT-TO MD through TBAA.
-        MDSet tmp;
-        tmp.bunion(typed_md, *getSBSMgr());
-        MDSet const* p = m_mds_hash->append(tmp);
-        tmp.clean(*getSBSMgr());
-        return p;
+        return m_mds_hash->append(typed_md);
     }
     return point_to_set;
 }
@@ -2566,6 +2562,26 @@ void AliasAnalysis::processCallSideeffect(MOD MD2MDSet & mx,
 }
 
 
+//Set the point-to of pointers that may be modified by callee to be the
+//worst case according to the MOD/REF summary of callee.
+//by_addr_mds: the MDSet that pointed to by arguments.
+void AliasAnalysis::processCallSideeffectViaModRef(
+    MOD MD2MDSet & mx, ModRefSummary const* modref, MDSet const& by_addr_mds)
+{
+    ASSERT0(modref && modref->isUsable());
+    MDId2MD const* id2md = m_md_sys->getID2MDMap();
+    for (VecIdx j = MD_FIRST; j <= id2md->get_last_idx(); j++) {
+        MD const* t = id2md->get((UINT)j);
+        if (t == nullptr || !t->get_base()->isPointer()) { continue; }
+        if (MODREF_mod(modref)->is_overlap_ex(t, m_rg, m_md_sys) ||
+            (MODREF_is_mod_arg(modref) &&
+             by_addr_mds.is_overlap_ex(t, m_rg, m_md_sys))) {
+            setPointTo((UINT)j, mx, getWorstCase());
+        }
+    }
+}
+
+
 MD const* AliasAnalysis::allocHeapobj(IR * ir)
 {
     MD const* heap_obj = m_ir2heapobj.get(ir);
@@ -2650,6 +2666,30 @@ static void setMayDefSetForCall(IR * ir, AliasAnalysis * aa)
 }
 
 
+//Regard the MDSet that recorded in MOD/REF summary of callee and the
+//MDSet that arguments pointed-to as the MDSet that referrenced by call.
+//by_addr_mds: the MDSet that pointed to by arguments.
+static void setMayRefForCallViaModRef(IR * ir, ModRefSummary const* modref,
+                                      MDSet const& by_addr_mds,
+                                      MDSetHash * mdshash,
+                                      AliasAnalysis * aa)
+{
+    DefMiscBitSetMgr * sbsmgr = aa->getSBSMgr();
+    MDSet mayref;
+    mayref.bunion(*MODREF_mod(modref), *sbsmgr);
+    mayref.bunion(*MODREF_ref(modref), *sbsmgr);
+    if (MODREF_is_mod_arg(modref) || MODREF_is_ref_arg(modref)) {
+        mayref.bunion(by_addr_mds, *sbsmgr);
+    }
+    if (mayref.is_empty()) {
+        ir->cleanMayRef();
+        return;
+    }
+    ir->setMayRef(mdshash->append(mayref), aa->getRegion());
+    mayref.clean(*sbsmgr);
+}
+
+
 //Compute the point-to set modification when we meet call.
 void AliasAnalysis::processCall(MOD IR * ir, IN MD2MDSet * mx)
 {
@@ -2665,6 +2705,12 @@ void AliasAnalysis::processCall(MOD IR * ir, IN MD2MDSet * mx)
         inferExp(ICALL_callee(ir), tmp, &tic, mx);
     }
 
+    //The summary is only usable if the point-to of each pointer argument
+    //is available, because callee may access the memory through them.
+    ModRefSummary const* modref = getCalleeModRefSummary(ir, m_rg);
+    bool need_arg_pts = modref != nullptr &&
+        (MODREF_is_mod_arg(modref) || MODREF_is_ref_arg(modref));
+
     //Analyze the point-to of each arguments.
     MDSet by_addr_mds;
     for (IR * p = CALL_arg_list(ir); p != nullptr; p = p->get_next()) {
@@ -2674,7 +2720,7 @@ void AliasAnalysis::processCall(MOD IR * ir, IN MD2MDSet * mx)
         }
         inferExp(p, tmp, &tic, mx);
 
-        if (ir->isReadOnly()) { continue; }
+        if (ir->isReadOnly() && !need_arg_pts) { continue; }
         if (!tic.is_comp_pts() && !tic.is_taken_addr()) { continue; }
         if (!tmp.is_empty()) {
             by_addr_mds.bunion(tmp, *getSBSMgr());
@@ -2683,6 +2729,11 @@ void AliasAnalysis::processCall(MOD IR * ir, IN MD2MDSet * mx)
         if (tic.get_hashed() != nullptr &&
             !by_addr_mds.is_equal(*tic.get_hashed())) {
             by_addr_mds.bunion(*tic.get_hashed(), *getSBSMgr());
+            continue;
+        }
+        if (need_arg_pts && !p->isConstExp()) {
+            //Point-to of argument is unknown.
+            modref = nullptr;
         }
     }
 
@@ -2692,7 +2743,11 @@ void AliasAnalysis::processCall(MOD IR * ir, IN MD2MDSet * mx)
         inferExp(p, tmp, &tic, mx);
     }
 
-    setMayDefSetForCall(ir, this);
+    if (modref != nullptr) {
+        setMayRefForCallViaModRef(ir, modref, by_addr_mds, m_mds_hash, this);
+    } else {
+        setMayDefSetForCall(ir, this);
+    }
 
     if (CALL_is_alloc_heap(ir)) {
         if (ir->hasReturnValue()) {
@@ -2727,14 +2782,18 @@ void AliasAnalysis::processCall(MOD IR * ir, IN MD2MDSet * mx)
             cleanPointTo(t->id(), *mx);
         }
     }
-    if (ir->isReadOnly()) {
+    if (ir->isReadOnly() || (modref != nullptr && modref->isModNothing())) {
         //Readonly call does not modify any point-to informations.
         tmp.clean(*getSBSMgr());
-        ASSERT0(by_addr_mds.is_empty());
+        ASSERT0(by_addr_mds.is_empty() || need_arg_pts);
         by_addr_mds.clean(*getSBSMgr());
         return;
     }
-    processCallSideeffect(*mx, by_addr_mds);
+    if (modref != nullptr) {
+        processCallSideeffectViaModRef(*mx, modref, by_addr_mds);
+    } else {
+        processCallSideeffect(*mx, by_addr_mds);
+    }
     tmp.clean(*getSBSMgr());
     by_addr_mds.clean(*getSBSMgr());
 }
@@ -3488,7 +3547,8 @@ bool AliasAnalysis::convertMD2MDSet2PT(OUT PtPairSet * pps,
                                        IN MD2MDSet * mx)
 {
     //Grow pps before hand with the maximum length needed.
-    if (mx->computePtPairNum(*m_md_sys) > g_thres_ptpair_num) {
+    if (mx->computePtPairNum(*m_md_sys) > g_thres_ptpair_num ||
+        m_rg->isMemBudgetExceeded()) {
         return false;
     }
     MD2MDSetIter mxiter;
@@ -478,6 +478,9 @@ protected:
                            MDSet & phi_pts, MOD MD2MDSet * mx);
     void processPhi(IR const* ir, MOD MD2MDSet * mx);
     void processCallSideeffect(MOD MD2MDSet & mx, MDSet const& by_addr_mds);
+    void processCallSideeffectViaModRef(MOD MD2MDSet & mx,
+                                        ModRefSummary const* modref,
+                                        MDSet const& by_addr_mds);
     void processCall(MOD IR * ir, MOD MD2MDSet * mx);
     void processReturn(IR const* ir, MOD MD2MDSet * mx);
     void processRegionSideeffect(MOD MD2MDSet & mx);
@@ -652,11 +655,7 @@ public:
                                    MD const* target)
     {
         ASSERT0(target);
-        MDSet tmp;
-        tmp.bunion(target, *getSBSMgr());
-        MDSet const* hashed = m_mds_hash->append(tmp);
-        setPointTo(pointer_mdid, ctx, hashed);
-        tmp.clean(*getSBSMgr());
+        setPointTo(pointer_mdid, ctx, m_mds_hash->append(target));
     }
 
     //Set pointer points to 'target_set' in the context.
@@ -674,20 +673,15 @@ public:
     inline void setPointToMDSetByAddMD(MDIdx pointer_mdid, MD2MDSet & ctx,
                                        MD const* newmd)
     {
-        MDSet tmp;
         MDSet const* pts = getPointTo(pointer_mdid, ctx);
         if (pts != nullptr) {
             if (pts->is_contain(newmd, m_rg) || isWorstCase(pts)) {
                 ASSERT0(m_mds_hash->find(*pts));
                 return;
             }
-            tmp.bunion(*pts, *getSBSMgr());
         }
-
-        tmp.bunion(newmd, *getSBSMgr());
-        MDSet const* hashed = m_mds_hash->append(tmp);
-        setPointTo(pointer_mdid, ctx, hashed);
-        tmp.clean(*getSBSMgr());
+        //The union of hashed sets is memoized by MDSetHash.
+        setPointTo(pointer_mdid, ctx, m_mds_hash->bunion(pts, newmd));
     }
 
     //Set pointer points to MD set by appending a MDSet.
@@ -707,13 +701,9 @@ public:
             return;
         }
 
-        //Generate new POINT-TO set and set.
-        MDSet tmp;
-        tmp.copy(*pts, *getSBSMgr());
-        tmp.bunion(pt_set, *getSBSMgr());
-        MDSet const* hashed = m_mds_hash->append(tmp);
-        setPointTo(pointer_mdid, ctx, hashed);
-        tmp.clean(*getSBSMgr());
+        //Generate new POINT-TO set and set. The union of hashed sets is
+        //memoized by MDSetHash.
+        setPointTo(pointer_mdid, ctx, m_mds_hash->bunion(pts, &pt_set));
     }
 
     void set_flow_sensitive(bool is_sensitive)
@@ -0,0 +1,103 @@
+/*@
+XOC Release License
+
+Copyright (c) 2013-2014, Alibaba Group, All rights reserved.
+
+    compiler@aliexpress.com
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Su Zhenyu nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+author: Su Zhenyu
+@*/
+#include "cominc.h"
+
+#ifdef COMPACT_IR_LAYOUT
+namespace xoc {
+
+BYTE * IRArena::s_chunk_tab[IR_ARENA_MAX_CHUNK_NUM];
+
+//The lock protects chunk table and the free chunk ids, because regions
+//may be compiled in multiple threads.
+static xcom::Mutex g_arena_lock;
+
+//Record the chunk ids that have been returned to arena.
+static xcom::Vector<UINT> g_free_chunk_id;
+static UINT g_free_chunk_num = 0;
+
+//The next chunk id that has not been used. Chunk id 0 is reserved.
+static UINT g_next_chunk_id = 1;
+
+IRArenaChunk * IRArena::allocChunk(IRMgr * owner)
+{
+    //Allocate twice the chunk size to make sure there is an aligned chunk
+    //inside the memory. The tail pages that are never touched will not be
+    //committed by host that supports demand paging.
+    void * raw = ::malloc(IR_ARENA_CHUNK_SIZE * 2);
+    ASSERTN(raw, ("out of memory"));
+    IRArenaChunk * c = (IRArenaChunk*)((((size_t)raw) +
+        IR_ARENA_CHUNK_SIZE - 1) & ~(IR_ARENA_CHUNK_SIZE - (size_t)1));
+    ::memset((void*)c, 0, sizeof(IRArenaChunk));
+    IRAC_owner(c) = owner;
+    IRAC_raw(c) = raw;
+    IRAC_used(c) = (UINT)xcom::ceil_align(sizeof(IRArenaChunk),
+                                          1 << IR_ARENA_GRANULE_BIT);
+    xcom::AutoLock lock(&g_arena_lock);
+    if (g_free_chunk_num > 0) {
+        g_free_chunk_num--;
+        IRAC_id(c) = g_free_chunk_id.get(g_free_chunk_num);
+    } else {
+        ASSERTN(g_next_chunk_id < IR_ARENA_MAX_CHUNK_NUM,
+                ("IR arena exhausted"));
+        IRAC_id(c) = g_next_chunk_id;
+        g_next_chunk_id++;
+    }
+    s_chunk_tab[IRAC_id(c)] = (BYTE*)c;
+    xcom::smpoolAddThreadMemSize(IR_ARENA_CHUNK_SIZE);
+    return c;
+}
+
+
+void IRArena::freeChunk(IRArenaChunk * c)
+{
+    ASSERT0(c && s_chunk_tab[IRAC_id(c)] == (BYTE*)c);
+    xcom::AutoLock lock(&g_arena_lock);
+    s_chunk_tab[IRAC_id(c)] = nullptr;
+    g_free_chunk_id.set(g_free_chunk_num, IRAC_id(c));
+    g_free_chunk_num++;
+    ::free(IRAC_raw(c));
+    xcom::smpoolAddThreadMemSize(-(LONGLONG)IR_ARENA_CHUNK_SIZE);
+}
+
+
+AIContainer ** IRArena::getAIAddr(IR const* ir)
+{
+    ASSERT0(ir);
+    IRMgr const* mgr = IRAC_owner(getChunk(ir));
+    ASSERT0(mgr);
+    return mgr->getAIAddr(ir->id());
+}
+
+} //namespace xoc
+#endif
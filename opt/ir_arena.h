@@ -0,0 +1,152 @@
+/*@
+XOC Release License
+
+Copyright (c) 2013-2014, Alibaba Group, All rights reserved.
+
+    compiler@aliexpress.com
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Su Zhenyu nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+author: Su Zhenyu
+@*/
+#ifndef _IR_ARENA_H_
+#define _IR_ARENA_H_
+
+//Define the macro to build IR in compact layout. In the layout, IR refers
+//to its next, prev and parent IR via 32-bit indices into the process-wide
+//IR arena instead of host pointers, and the attach-info container is kept
+//in a side table of IRMgr. The header of IR shrinks from 56 bytes to 32
+//bytes on 64-bit host. By default, it is disabled.
+//#define COMPACT_IR_LAYOUT
+
+#ifdef COMPACT_IR_LAYOUT
+namespace xoc {
+
+class IR;
+class IRMgr;
+class AIContainer;
+
+//The chunk of arena is aligned to its byte size, thus the chunk header can
+//be found by masking the address of any IR inside the chunk.
+#define IR_ARENA_CHUNK_BIT 18
+#define IR_ARENA_CHUNK_SIZE (((size_t)1) << IR_ARENA_CHUNK_BIT)
+
+//IR is allocated in arena at the granularity of 8 bytes.
+#define IR_ARENA_GRANULE_BIT 3
+#define IR_ARENA_SLOT_BIT (IR_ARENA_CHUNK_BIT - IR_ARENA_GRANULE_BIT)
+#define IR_ARENA_SLOT_MASK ((((UINT)1) << IR_ARENA_SLOT_BIT) - 1)
+
+//The maximum number of chunks that can be addressed by 32-bit index.
+//Note chunk id 0 is reserved, thus index 0 always denotes nullptr.
+#define IR_ARENA_MAX_CHUNK_NUM (((UINT)1) << (32 - IR_ARENA_SLOT_BIT))
+
+#define IRAC_id(c) ((c)->id)
+#define IRAC_owner(c) ((c)->owner)
+#define IRAC_next(c) ((c)->next)
+#define IRAC_used(c) ((c)->used)
+#define IRAC_raw(c) ((c)->raw)
+
+//The class represents the header of arena chunk. IRs are placed after the
+//header in the same chunk.
+class IRArenaChunk {
+public:
+    UINT id; //the index of chunk in the arena.
+    UINT used; //the byte size that has been allocated in chunk.
+    IRMgr * owner; //the IRMgr that allocated the chunk.
+    IRArenaChunk * next; //the next chunk that belongs to same owner.
+    void * raw; //the address returned by host allocator.
+};
+
+
+//The class represents the process-wide IR arena. The arena maps the 32-bit
+//index of IR to its address, and vice versa. Each IRMgr allocates chunks
+//from the arena, and returns them when it is destroyed.
+//The high bits of the index are chunk id, and the low bits are the
+//granule offset of IR inside the chunk.
+class IRArena {
+    static BYTE * s_chunk_tab[IR_ARENA_MAX_CHUNK_NUM];
+public:
+    //Allocate a chunk for 'owner'.
+    static IRArenaChunk * allocChunk(IRMgr * owner);
+
+    //Return chunk 'c' to arena. The IRs inside the chunk are not
+    //accessible any more.
+    static void freeChunk(IRArenaChunk * c);
+
+    //Return the address of the attach-info container of 'ir'.
+    //The container is recorded in the side table of IRMgr that owns 'ir'.
+    static AIContainer ** getAIAddr(IR const* ir);
+
+    //Return the chunk that 'ir' is placed in.
+    static IRArenaChunk * getChunk(IR const* ir)
+    {
+        return (IRArenaChunk*)(((size_t)ir) &
+                               ~(IR_ARENA_CHUNK_SIZE - (size_t)1));
+    }
+
+    //Return the 32-bit index of 'ir'.
+    static UINT toIdx(IR const* ir)
+    {
+        if (ir == nullptr) { return 0; }
+        IRArenaChunk const* c = getChunk(ir);
+        ASSERTN(s_chunk_tab[IRAC_id(c)] == (BYTE const*)c,
+                ("IR is not allocated in arena"));
+        return (IRAC_id(c) << IR_ARENA_SLOT_BIT) |
+               (UINT)((((BYTE const*)ir) - ((BYTE const*)c)) >>
+                      IR_ARENA_GRANULE_BIT);
+    }
+
+    //Return the IR that 'idx' indicated.
+    //Note the entry of chunk 0 is always nullptr, and so is index 0.
+    static IR * toIR(UINT idx)
+    {
+        BYTE * c = s_chunk_tab[idx >> IR_ARENA_SLOT_BIT];
+        if (c == nullptr) { return nullptr; }
+        return (IR*)(c + ((idx & IR_ARENA_SLOT_MASK) <<
+                          IR_ARENA_GRANULE_BIT));
+    }
+};
+
+
+//The class represents a reference to IR via its 32-bit index in arena.
+//It behaves like IR pointer, so that the accessing macros of IR, such as
+//IR_next, IR_prev and IR_parent, can be used as before.
+//Note the class should NOT have constructor, because IR is allocated and
+//zero-cleared by IRMgr, and index 0 denotes nullptr.
+class IRRef {
+    UINT m_idx;
+public:
+    IRRef & operator = (IR * ir)
+    {
+        m_idx = IRArena::toIdx(ir);
+        return *this;
+    }
+    IR * operator -> () const { return IRArena::toIR(m_idx); }
+    operator IR * () const { return IRArena::toIR(m_idx); }
+};
+
+} //namespace xoc
+#endif
+#endif
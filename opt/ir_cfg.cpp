@@ -2938,16 +2938,25 @@ void IRCFG::computeDomAndIdom(MOD OptCtx & oc, xcom::BitSet const* uni)
     ASSERT0(vlst);
     ASSERT0(vlst->get_elem_count() == getBBList()->get_elem_count());
 
-    //TBD:Try different methods.
-    //xcom::DGraph::computeDom(&vlst, uni);
-    //xcom::DGraph::computeIdom();
-    bool f = xcom::DGraph::computeIdom2(*vlst);
-    DUMMYUSE(f);
-    ASSERT0(f);
+    bool f = false;
+    if (g_compute_dom_by_semi_nca &&
+        getBBList()->get_elem_count() >= g_semi_nca_min_bb_num) {
+        //Dominator-set is materialized on demand.
+        f = xcom::DGraph::computeIdomBySemiNCA(*vlst);
+        DUMMYUSE(f);
+        ASSERT0(f);
+    } else {
+        //TBD:Try different methods.
+        //xcom::DGraph::computeDom(&vlst, uni);
+        //xcom::DGraph::computeIdom();
+        f = xcom::DGraph::computeIdom2(*vlst);
+        DUMMYUSE(f);
+        ASSERT0(f);
 
-    f = xcom::DGraph::computeDom2(*vlst);
-    DUMMYUSE(f);
-    ASSERT0(f);
+        f = xcom::DGraph::computeDom2(*vlst);
+        DUMMYUSE(f);
+        ASSERT0(f);
+    }
 
     oc.setValidPass(PASS_DOM);
     END_TIMER(t, "Compute Dom, IDom");
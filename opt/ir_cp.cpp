@@ -108,7 +108,11 @@ public:
     {}
     bool visitWhenFirstMeet(Vertex const* v, Stack<Vertex const*> &)
     {
-        m_is_changed |= m_cp->doPropBB(m_cfg->getBB(v->id()), m_useset);
+        IRBB * bb = m_cfg->getBB(v->id());
+        if (m_cp->doPropBB(bb, m_useset)) {
+            m_cp->getOptCtx()->addChangedBB(bb);
+            m_is_changed = true;
+        }
         return true;
     }
 };
@@ -1011,7 +1015,7 @@ bool CopyProp::perform(OptCtx & oc)
     if (m_gvn != nullptr && !m_gvn->is_valid()) {
         if (allowInexactMD()) {
             //Aggressive CP need GVN.
-            m_gvn->perform(oc);
+            m_rg->getPassMgr()->performPass(m_gvn, oc);
         } else {
             return false;
         }
@@ -895,8 +895,11 @@ bool DeadCodeElim::removeIneffectIR(
     bool change = false;
     for (IRBB * bb = bbl->get_head(&bbit);
          bb != nullptr; bb = bbl->get_next(&bbit)) {
-        change |= removeIneffectIRImpl(
-            this, dcectx, bb, bbit, remove_branch_stmt);
+        if (removeIneffectIRImpl(this, dcectx, bb, bbit,
+                                 remove_branch_stmt)) {
+            dcectx.getOptCtx()->addChangedBB(bb);
+            change = true;
+        }
         if (!useMDSSADU() || !dcectx.getOptCtx()->is_dom_valid()) {
             //Optimize MDSSA operations, such as PHI, need valid DomInfo.
             continue;
@@ -916,7 +919,10 @@ bool DeadCodeElim::removeIneffectIR(
             // md1v3<-...  md1v4<-...
             continue;
         }
-        change |= m_mdssamgr->removeRedundantPhi(bb, *dcectx.getOptCtx());
+        if (m_mdssamgr->removeRedundantPhi(bb, *dcectx.getOptCtx())) {
+            dcectx.getOptCtx()->addChangedBB(bb);
+            change = true;
+        }
     }
     return change;
 }
@@ -986,6 +992,10 @@ bool DeadCodeElim::removeRedundantPhi(MOD OptCtx & oc)
     if (useMDSSADU()) {
         change |= m_mdssamgr->removeRedundantPhi(oc);
     }
+    if (change) {
+        //PHIs in any BB might be removed.
+        oc.addChangeKind(OC_CHANGE_STMT|OC_CHANGE_LOOP);
+    }
     return change;
 }
 
@@ -1036,6 +1046,7 @@ bool DeadCodeElim::iterCollectAndElim(
         //optimization opportunities.
         //TODO: DO not recompute whole SSA/MDSSA. Instead, update
         //SSA|MDSSA info especially PHI operands incrementally.
+        oc->addChangeKind(OC_CHANGE_CFG);
         removed = true;
     }
     if (!oc->is_dom_valid()) {
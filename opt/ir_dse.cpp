@@ -0,0 +1,331 @@
+/*@
+XOC Release License
+
+Copyright (c) 2013-2014, Alibaba Group, All rights reserved.
+
+    compiler@aliexpress.com
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Su Zhenyu nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+author: Su Zhenyu
+@*/
+#include "cominc.h"
+#include "comopt.h"
+
+namespace xoc {
+
+DSE::DSE(Region * rg) : Pass(rg), m_am(rg)
+{
+    ASSERT0(rg);
+    m_cfg = rg->getCFG();
+    m_mdsys = rg->getMDSystem();
+    m_mdssamgr = nullptr;
+    m_oc = nullptr;
+    m_removed_num = 0;
+}
+
+
+bool DSE::isCandidate(IR const* ir) const
+{
+    if (!ir->is_st() && !ir->is_ist() && !ir->is_starray()) { return false; }
+    if (ir->hasSideEffect(true) || ir->is_volatile()) { return false; }
+    MD const* md = ir->getMustRef();
+    if (md == nullptr || !md->is_exact() || !md->is_effect() ||
+        md->is_volatile()) {
+        return false;
+    }
+    return true;
+}
+
+
+bool DSE::isKill(IR const* stmt, MD const* md) const
+{
+    ASSERT0(stmt->is_stmt());
+    if (!stmt->is_st() && !stmt->is_ist() && !stmt->is_starray()) {
+        return false;
+    }
+    MD const* mustref = stmt->getMustRef();
+    if (mustref == nullptr) { return false; }
+    return mustref == md || mustref->is_exact_cover(md);
+}
+
+
+bool DSE::isLiveOut(IR const* ir) const
+{
+    //The variable of current region is dead after region exit. Note the
+    //local variable of outer region is still alive.
+    return !m_rg->isRegionVAR(ir->getMustRef()->get_base());
+}
+
+
+bool DSE::isIndependentUse(IR const* use, MD const* md) const
+{
+    //CALL and the stmt that reads memory are regarded as dependent.
+    if (!use->is_exp()) { return false; }
+    MD const* mustuse = use->getMustRef();
+    if (mustuse == nullptr || !mustuse->is_exact()) { return false; }
+
+    //e.g:arr[1] = 10;
+    //    return arr[2];
+    //The USE does not read the memory that written by the store.
+    return mustuse != md && !md->is_overlap(mustuse);
+}
+
+
+void DSE::pushDef(MDDef const* def)
+{
+    if (m_visited.is_contain(def->id())) { return; }
+    m_visited.bunion(def->id());
+    m_wl.append_tail(def);
+}
+
+
+bool DSE::walkDefChain(IR const* ir)
+{
+    m_visited.clean();
+    m_wl.clean();
+    m_kills.clean();
+    MD const* md = ir->getMustRef();
+    MDSSAInfo const* info = MDSSAMgr::getMDSSAInfoIfAny(ir);
+    ASSERT0(info);
+    VOpndSetIter it = nullptr;
+    for (BSIdx i = info->readVOpndSet().get_first(&it);
+         i != BS_UNDEF; i = info->readVOpndSet().get_next(i, &it)) {
+        VMD const* vmd = (VMD const*)m_mdssamgr->getVOpnd(i);
+        ASSERT0(vmd && vmd->is_md());
+        if (vmd->getDef() != nullptr) { pushDef(vmd->getDef()); }
+    }
+    UseDefMgr * udmgr = m_mdssamgr->getUseDefMgr();
+    while (m_wl.get_elem_count() != 0) {
+        MDDef const* def = m_wl.remove_head();
+        VMD * res = def->getResult();
+        VMD::UseSetIter vit;
+        for (UINT u = res->getUseSet()->get_first(vit);
+             !vit.end(); u = res->getUseSet()->get_next(vit)) {
+            IR const* use = m_rg->getIR(u);
+            ASSERT0(use);
+            if (!use->is_id()) {
+                if (isIndependentUse(use, md)) { continue; }
+                //The value may be read by 'use'.
+                return false;
+            }
+            //The value flows into MDPhi.
+            MDPhi const* phi = ((CId const*)use)->getMDPhi();
+            ASSERT0(phi);
+            pushDef(phi);
+        }
+        MDDefSet const* nextset = def->getNextSet();
+        if (nextset == nullptr) { continue; }
+        MDDefSetIter nit = nullptr;
+        for (BSIdx w = nextset->get_first(&nit);
+             w != BS_UNDEF; w = nextset->get_next(w, &nit)) {
+            MDDef const* next = udmgr->getMDDef(w);
+            ASSERT0(next);
+            if (!next->is_phi() && isKill(next->getOcc(), md)) {
+                //The memory is overwritten, no need to walk through the
+                //following DEFs.
+                m_kills.append_tail(next->getOcc());
+                continue;
+            }
+            //The next DEF may partially overwrite the memory, the value of
+            //'ir' is still alive.
+            pushDef(next);
+        }
+    }
+    return true;
+}
+
+
+bool DSE::hasPostDomKill(IR const* ir) const
+{
+    IRBB * bb = ir->getBB();
+    ASSERT0(bb);
+    ConstIRListIter it;
+    for (IR const* kill = m_kills.get_head(&it);
+         kill != nullptr; kill = m_kills.get_next(&it)) {
+        IRBB * killbb = kill->getBB();
+        ASSERT0(killbb);
+        if (killbb != bb) {
+            if (m_cfg->is_pdom(killbb->id(), bb->id())) { return true; }
+            continue;
+        }
+        //Check whether 'kill' is placed after 'ir' in the same BB.
+        BBIRListIter irit;
+        bool find_ir = false;
+        for (IR const* x = bb->getIRList().get_head(&irit);
+             x != nullptr; x = bb->getIRList().get_next(&irit)) {
+            if (x == ir) { find_ir = true; continue; }
+            if (x == kill && find_ir) { return true; }
+        }
+    }
+    return hasKillInPostDomBB(ir);
+}
+
+
+bool DSE::hasKillInPostDomBB(IR const* ir) const
+{
+    MD const* md = ir->getMustRef();
+    IRBB * bb = ir->getBB();
+    ASSERT0(bb);
+    BBIRListIter it;
+    bool find_ir = false;
+    for (IR const* x = bb->getIRList().get_head(&it);
+         x != nullptr; x = bb->getIRList().get_next(&it)) {
+        if (x == ir) { find_ir = true; continue; }
+        if (find_ir && isKill(x, md)) { return true; }
+    }
+    for (IRBB * pbb = m_cfg->get_ipdom(bb);
+         pbb != nullptr; pbb = m_cfg->get_ipdom(pbb)) {
+        for (IR const* x = pbb->getIRList().get_head(&it);
+             x != nullptr; x = pbb->getIRList().get_next(&it)) {
+            if (isKill(x, md)) { return true; }
+        }
+    }
+    return false;
+}
+
+
+bool DSE::isDeadStore(IR const* ir)
+{
+    ASSERT0(isCandidate(ir));
+    MDSSAInfo const* info = MDSSAMgr::getMDSSAInfoIfAny(ir);
+    if (info == nullptr || info->isEmptyVOpndSet()) { return false; }
+    if (!walkDefChain(ir)) { return false; }
+    if (!isLiveOut(ir)) { return true; }
+
+    //Since there is no USE at region exit, the value should be
+    //overwritten in all paths from 'ir' to exit.
+    return hasPostDomKill(ir);
+}
+
+
+void DSE::buildMDSSAOnDemand()
+{
+    if (!m_mdssamgr->hasUnbuiltClass()) { return; }
+
+    //Only the alias classes of candidates are needed, collect them and
+    //build by one construction.
+    xcom::BitSet roots;
+    BBListIter bbit;
+    BBList * bbl = m_rg->getBBList();
+    for (IRBB * bb = bbl->get_head(&bbit);
+         bb != nullptr; bb = bbl->get_next(&bbit)) {
+        BBIRListIter it;
+        for (IR const* ir = bb->getIRList().get_head(&it);
+             ir != nullptr; ir = bb->getIRList().get_next(&it)) {
+            if (!isCandidate(ir)) { continue; }
+            m_mdssamgr->collectUnbuiltClass(ir, roots);
+        }
+    }
+    m_mdssamgr->buildOnDemandForClassSet(roots, *m_oc);
+}
+
+
+bool DSE::elimInBB(IRBB * bb)
+{
+    bool change = false;
+    BBIRListIter it;
+    BBIRListIter next;
+    for (bb->getIRList().get_head(&it), next = it;
+         it != nullptr; it = next) {
+        IR * ir = it->val();
+        bb->getIRList().get_next(&next);
+        if (!isCandidate(ir)) { continue; }
+
+        //The alias class of candidate has been built by
+        //buildMDSSAOnDemand(), the invocation here only builds the class
+        //that reclassified after removing stmt.
+        m_mdssamgr->buildOnDemand(ir, *m_oc);
+        if (!isDeadStore(ir)) { continue; }
+        m_am.dump("remove dead store %s to MD%u(%s) in BB%u",
+                  DumpIRName().dump(ir), ir->getMustRef()->id(),
+                  ir->getMustRef()->get_base()->get_name()->getStr(),
+                  bb->id());
+        xoc::removeStmt(ir, m_rg, *m_oc);
+        bb->getIRList().EList<IR*, IR2Holder>::remove(it);
+        m_rg->freeIRTree(ir);
+        m_removed_num++;
+        change = true;
+    }
+    return change;
+}
+
+
+bool DSE::dump() const
+{
+    if (!getRegion()->isLogMgrInit() || !g_dump_opt.isDumpDSE()) {
+        return true;
+    }
+    note(getRegion(), "\n==---- DUMP %s '%s' ----==",
+         getPassName(), m_rg->getRegionName());
+    getRegion()->getLogMgr()->incIndent(2);
+    note(getRegion(), "\nREMOVED:%u", m_removed_num);
+    m_am.dump();
+    bool succ = Pass::dump();
+    getRegion()->getLogMgr()->decIndent(2);
+    return succ;
+}
+
+
+bool DSE::perform(OptCtx & oc)
+{
+    BBList * bbl = m_rg->getBBList();
+    if (bbl == nullptr || bbl->get_elem_count() == 0) { return false; }
+    if (!oc.is_ref_valid()) { return false; }
+    m_mdssamgr = m_rg->getMDSSAMgr();
+    if (m_mdssamgr == nullptr || !m_mdssamgr->isValidOnDemand()) {
+        //The pass relies on the DefDef chain of MDSSA.
+        return false;
+    }
+    m_oc = &oc;
+    START_TIMER(t, getPassName());
+    m_rg->getPassMgr()->checkValidAndRecompute(
+        &oc, PASS_DOM, PASS_PDOM, PASS_UNDEF);
+    m_am.clean();
+    m_removed_num = 0;
+    bool change = false;
+
+    //DSE does not change CFG, the on-demand constructions share the CFG
+    //info during the pass.
+    m_mdssamgr->initOnDemandCFGInfo(oc);
+    buildMDSSAOnDemand();
+    BBListIter bbit;
+    for (IRBB * bb = bbl->get_head(&bbit);
+         bb != nullptr; bb = bbl->get_next(&bbit)) {
+        change |= elimInBB(bb);
+    }
+    m_mdssamgr->finiOnDemandCFGInfo();
+    END_TIMER(t, getPassName());
+    dump();
+    if (!change) { return false; }
+    oc.setInvalidIfDUMgrLiveChanged();
+    ASSERT0(m_rg->getDUMgr() == nullptr ||
+            m_rg->getDUMgr()->verifyMDRef());
+    ASSERT0(verifyMDDUChain(m_rg, oc));
+    ASSERT0(MDSSAMgr::verifyMDSSAInfo(m_rg, oc));
+    return true;
+}
+
+} //namespace xoc
@@ -0,0 +1,127 @@
+/*@
+XOC Release License
+
+Copyright (c) 2013-2014, Alibaba Group, All rights reserved.
+
+    compiler@aliexpress.com
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Su Zhenyu nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+author: Su Zhenyu
+@*/
+#ifndef _IR_DSE_H_
+#define _IR_DSE_H_
+
+namespace xoc {
+
+//The class performs Dead Store Elimination on MDSSA.
+//A store is dead if the memory it writes is overwritten before any use.
+//The candidate is IR_ST, IR_IST, or IR_STARRAY that has an exact MustRef.
+//The pass walks through the MDSSA DefDef chain and USE set of each VMD
+//defined by the candidate. The walk stops at the next DEF that must
+//overwrite the candidate, namely the MustRef of the next DEF exactly covers
+//the MustRef of candidate according to MD offset and size, e.g:
+//  st:i32 g = 1;        #S1, dead, the writing is killed by S3.
+//  call foo();          #foo does not reference g.
+//  st:i64 g:ofst(0) = 2; #S3, overwrites S1 completely.
+//If the walk reached an USE, including the operand of CALL and the USE via
+//MDPhi, the candidate is live.
+//Since the SSA does not have an USE at region exit, the candidate that
+//writes to memory outside the region is dead only if a killing DEF
+//post-dominates the candidate, whereas the value of region local variable
+//will not be used after region exit. The killing DEF is not always on the
+//DefDef chain, e.g:
+//  if (c) { g = 2; } #S1
+//  g = 3;            #S2
+//g is not live at the joint point, thus pruned MDSSA does not place MDPhi
+//there, and S2 is not the next DEF of S1. Therefore the BBs along the
+//post-dominator tree are scanned for the killing DEF as well.
+//NOTE: the pass does not remove the candidate that only has MayRef, because
+//AliasAnalysis can not prove the overwriting of memory.
+class DSE : public Pass {
+    COPY_CONSTRUCTOR(DSE);
+    UINT m_removed_num; //the number of eliminated stores.
+    IRCFG * m_cfg;
+    MDSystem * m_mdsys;
+    MDSSAMgr * m_mdssamgr;
+    OptCtx * m_oc;
+    ActMgr m_am;
+    xcom::BitSet m_visited; //record the visited MDDef.
+    List<MDDef const*> m_wl; //worklist of MDDef.
+    List<IR const*> m_kills; //record the stmts that overwrite candidate.
+protected:
+    //Build the alias classes of all candidates in demand-driven mode.
+    void buildMDSSAOnDemand();
+    bool elimInBB(IRBB * bb);
+
+    //Return true if there is a killing stmt post-dominates 'ir'.
+    bool hasPostDomKill(IR const* ir) const;
+
+    //Return true if a stmt that follows 'ir' in its BB or in the BBs that
+    //post-dominate the BB of 'ir' overwrites the MustRef of 'ir'.
+    bool hasKillInPostDomBB(IR const* ir) const;
+
+    //Return true if 'ir' is candidate of the pass.
+    bool isCandidate(IR const* ir) const;
+
+    //Return true if 'use' does not read any byte of 'md', although it is
+    //an USE of the VMD that defined by candidate. Note the VMD may describe
+    //MD that is larger than 'md', e.g: the MayRef of candidate.
+    bool isIndependentUse(IR const* use, MD const* md) const;
+
+    //Return true if the store 'ir' is dead.
+    bool isDeadStore(IR const* ir);
+
+    //Return true if 'stmt' must overwrite whole memory that described
+    //by 'md'.
+    bool isKill(IR const* stmt, MD const* md) const;
+
+    //Return true if the value of stmt may be used after region exit.
+    bool isLiveOut(IR const* ir) const;
+
+    void pushDef(MDDef const* def);
+
+    //Walk through the DefDef chain and USE set start from 'ir'.
+    //Return false if there is an USE of value of 'ir'.
+    bool walkDefChain(IR const* ir);
+public:
+    explicit DSE(Region * rg);
+    virtual ~DSE() {}
+
+    virtual bool dump() const;
+
+    virtual CHAR const* getPassName() const
+    { return "Dead Store Elimination"; }
+    PASS_TYPE getPassType() const { return PASS_DSE; }
+    ActMgr & getActMgr() { return m_am; }
+
+    //DSE only builds the alias classes of candidate stores.
+    virtual bool isMDSSAOnDemandClient() const { return true; }
+
+    virtual bool perform(OptCtx & oc);
+};
+
+} //namespace xoc
+#endif
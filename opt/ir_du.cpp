@@ -1144,6 +1144,8 @@ bool DUMgr::dump() const
     m_rg->dumpRef();
     if (g_dump_opt.isDumpAll()) {
         m_solve_set_mgr.dump(true);
+    } else {
+        m_solve_set_mgr.dumpStat();
     }
     m_rg->getLogMgr()->decIndent(2);
     Pass::dump();
@@ -1792,6 +1794,20 @@ bool DUMgr::inferCallStmtForNonPRViaCallGraph(IR const* ir,
 }
 
 
+bool DUMgr::inferCallStmtForNonPRViaModRef(IR const* ir,
+                                           OUT MDSet & maydefuse)
+{
+    //The MOD/REF summary of callee is computed by IPA before current
+    //region processed. The memory that accessed through arguments has
+    //been merged into the MayRef of call by AliasAnalysis.
+    ModRefSummary const* modref = getCalleeModRefSummary(ir, m_rg);
+    if (modref == nullptr) { return false; }
+    maydefuse.bunion(*MODREF_mod(modref), *getSBSMgr());
+    maydefuse.bunion(*MODREF_ref(modref), *getSBSMgr());
+    return true;
+}
+
+
 //Set given set to be more conservative MD reference set.
 //worst: true to set result to the worst case.
 void DUMgr::setToWorstCase(IR * ir)
@@ -1905,7 +1921,9 @@ void DUMgr::inferCallStmtForNonPR(IR * ir, DUOptFlag duflag)
             maydefuse.bunion_pure(*d->getRefMDSet(), *getSBSMgr());
         }
     }
-    if (ir->isReadOnly() || inferCallStmtForNonPRViaCallGraph(ir, maydefuse)) {
+    if ((worst == nullptr && inferCallStmtForNonPRViaModRef(ir, maydefuse)) ||
+        ir->isReadOnly() ||
+        inferCallStmtForNonPRViaCallGraph(ir, maydefuse)) {
         //Regard both USE and DEF as ir's MayRef.
         //TODO:differetiate the USE set and DEF set of CallStmt
         //to get more precise DefUse chain precision.
@@ -3651,11 +3669,14 @@ void DUMgr::computeMDDUChain(MOD OptCtx & oc, bool retain_reach_def,
 
     START_TIMER(t, "Build Classic DU chain");
     ASSERT0(oc.is_cfg_valid());
-    ASSERT0(oc.is_ref_valid() && oc.is_reach_def_valid());
+    ASSERT0(oc.is_ref_valid());
+    ASSERT0(oc.is_reach_def_valid() || m_rg->isMemBudgetExceeded());
     m_oc = &oc; //used for tmp, and should be initialized before any use.
     BBList * bbl = m_rg->getBBList();
-    if (bbl->get_elem_count() > g_thres_opt_bb_num) {
-        //There are too many BB. Leave it here.
+    if (bbl->get_elem_count() > g_thres_opt_bb_num ||
+        !oc.is_reach_def_valid()) {
+        //There are too many BB, or REACH_DEF is not solved because of
+        //memory budget. Leave it here.
         END_TIMER(t, "Build Classic DU chain");
         //Only reach-def-in is useful for computing DU chain.
         m_solve_set_mgr.resetGlobalSet();
@@ -3909,7 +3930,7 @@ bool DUMgr::checkAndComputeClassicDUChain(MOD OptCtx & oc)
         //Note the computation of REACH_DEF is memory and time costly.
         changed = perform(oc, f);
         ASSERT0_DUMMYUSE(changed);
-        ASSERT0(oc.is_reach_def_valid());
+        ASSERT0(oc.is_reach_def_valid() || m_rg->isMemBudgetExceeded());
         computeMDDUChain(oc, false, f);
         changed = true;
     }
@@ -3956,6 +3977,15 @@ bool DUMgr::perform(MOD OptCtx & oc, DUOptFlag flag)
         ASSERT0(!g_compute_pr_du_chain_by_prssa);
     }
 
+    if ((flag.have(DUOPT_SOL_REACH_DEF) ||
+         flag.have(DUOPT_SOL_AVAIL_REACH_DEF)) &&
+        m_rg->isMemBudgetExceeded()) {
+        //REACH_DEF is memory costly, region that exceeded memory budget
+        //does not compute it, and the classic DU chain will not be built.
+        flag.remove(DUOPT_SOL_REACH_DEF);
+        flag.remove(DUOPT_SOL_AVAIL_REACH_DEF);
+    }
+
     //Initialize local used resource.
     if (flag.have(DUOPT_SOL_AVAIL_REACH_DEF) ||
         flag.have(DUOPT_SOL_REACH_DEF) ||
@@ -314,6 +314,9 @@ protected:
     //Return true if the output result has unify call's MayDef.
     bool inferCallStmtForNonPRViaCallGraph(IR const* ir,
                                            OUT MDSet & maydefuse);
+
+    //Return true if the output result has unify MOD/REF summary of callee.
+    bool inferCallStmtForNonPRViaModRef(IR const* ir, OUT MDSet & maydefuse);
     void inferCallStmt(IR * ir, DUOptFlag duflag);
 
     //Return true if stmt dominate use's stmt, otherwise return false.
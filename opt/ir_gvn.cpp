@@ -203,6 +203,102 @@ void IRCAndVNHash::dump(Region const* rg, UINT indent) const
 //END IRCAndVNHash
 
 
+//
+//START VNExpTab
+//
+UINT VNExpTab::computeHash(UINT code, UINT const* opnd)
+{
+    UINT h = code;
+    for (UINT i = 0; i < VNEXP_MAX_OPND_NUM; i++) {
+        h = (h ^ opnd[i]) * 0x9E3779B1u;
+    }
+    return h ^ (h >> 16);
+}
+
+
+VNExpEntry * VNExpTab::findEntry(UINT code, UINT const* opnd) const
+{
+    ASSERT0(m_capacity > 0 && isPowerOf2(m_capacity));
+    UINT const mask = m_capacity - 1;
+    for (UINT i = computeHash(code, opnd) & mask;; i = (i + 1) & mask) {
+        VNExpEntry * e = &m_entry[i];
+        if (e->vn == nullptr) {
+            //The first empty entry in probe sequence.
+            return e;
+        }
+        if (e->code == code && e->opnd[0] == opnd[0] &&
+            e->opnd[1] == opnd[1] && e->opnd[2] == opnd[2] &&
+            e->opnd[3] == opnd[3]) {
+            return e;
+        }
+    }
+    UNREACHABLE();
+    return nullptr;
+}
+
+
+void VNExpTab::grow()
+{
+    UINT const oldcap = m_capacity;
+    VNExpEntry * oldentry = m_entry;
+    m_capacity = oldcap == 0 ? 64 : oldcap * 2;
+    size_t const sz = sizeof(VNExpEntry) * m_capacity;
+    m_entry = (VNExpEntry*)::malloc(sz);
+    ::memset((void*)m_entry, 0, sz);
+    for (UINT i = 0; i < oldcap; i++) {
+        VNExpEntry const* e = &oldentry[i];
+        if (e->vn == nullptr) { continue; }
+        *findEntry(e->code, e->opnd) = *e;
+    }
+    if (oldentry != nullptr) {
+        ::free(oldentry);
+    }
+}
+
+
+void VNExpTab::clean()
+{
+    if (m_num == 0) { return; }
+    ::memset((void*)m_entry, 0, sizeof(VNExpEntry) * m_capacity);
+    m_num = 0;
+}
+
+
+void VNExpTab::destroy()
+{
+    if (m_entry != nullptr) {
+        ::free(m_entry);
+        m_entry = nullptr;
+    }
+    m_capacity = 0;
+    m_num = 0;
+}
+
+
+VN * VNExpTab::get(IR_CODE code, UINT const* opnd) const
+{
+    if (m_num == 0) { return nullptr; }
+    return findEntry((UINT)code, opnd)->vn;
+}
+
+
+void VNExpTab::set(IR_CODE code, UINT const* opnd, VN * vn)
+{
+    ASSERT0(vn);
+    //Keep the load factor less than 1/2 to make probe sequence short.
+    if ((m_num + 1) * 2 > m_capacity) {
+        grow();
+    }
+    VNExpEntry * e = findEntry((UINT)code, opnd);
+    ASSERTN(e->vn == nullptr, ("operation has been registered"));
+    e->vn = vn;
+    e->code = (UINT)code;
+    ::memcpy((void*)e->opnd, (void const*)opnd, sizeof(e->opnd));
+    m_num++;
+}
+//END VNExpTab
+
+
 //
 //START InferEVN
 //
@@ -904,6 +1000,7 @@ GVN::GVN(Region * rg) : Pass(rg)
     m_is_comp_lda_string = !m_rg->getRegionMgr()->isRegardAllStringAsSameMD();
     m_is_alloc_livein_vn = false;
     m_pool = nullptr;
+    m_vne_pool = nullptr;
     m_vn_vec = nullptr;
     m_refine = nullptr;
     init();
@@ -973,6 +1070,7 @@ void GVN::init()
     }
     m_stmt2domdef.init(MAX(4, xcom::getNearestPowerOf2(n/2)));
     m_pool = smpoolCreate(sizeof(VN) * 4, MEM_COMM);
+    m_vne_pool = smpoolCreate(sizeof(VNE_ARR) * 16, MEM_COMM);
     if (g_dump_opt.isDumpGVN()) {
         m_vn_vec = new xcom::Vector<VN const*>(32);
     } else {
@@ -986,7 +1084,9 @@ void GVN::destroy()
     if (m_pool == nullptr) { return; }
     destroyLocalUsed();
     smpoolDelete(m_pool);
+    smpoolDelete(m_vne_pool);
     m_pool = nullptr;
+    m_vne_pool = nullptr;
     if (m_vn_vec != nullptr) {
         delete m_vn_vec;
         m_vn_vec = nullptr;
@@ -1014,15 +1114,9 @@ void GVN::destroyLocalUsed()
     m_stmt2domdef.destroy();
     m_stmt2domdef.init(bucket_size);
 
-    for (Tab1 * v = m_tab_lst.get_head();
-         v != nullptr; v = m_tab_lst.get_next()) {
-        delete v;
-    }
-    m_tab_lst.destroy();
-    m_tab_lst.init();
-
-    m_irc_vec.destroy();
-    m_irc_vec.init();
+    //Keep the buffer of table to reduce the allocation when GVN is
+    //recomputed.
+    m_exp_tab.clean();
 }
 
 
@@ -1285,27 +1379,29 @@ VN * GVN::registerVNviaFP(double v)
 }
 
 
-VN * GVN::registerUnaVN(IR_CODE irt, VN const* v0)
+VN * GVN::registerOpVN(IR_CODE irt, UINT const* opnd)
 {
-    ASSERT0(isUnary(irt));
-    Tab1 * tab1 = (Tab1*)m_irc_vec.get(irt);
-    if (tab1 == nullptr) {
-        tab1 = new Tab1();
-        m_tab_lst.append_tail(tab1);
-        m_irc_vec.set(irt, (void*)tab1);
-    }
-
-    VN * res = tab1->get(VN_id(v0));
+    VN * res = m_exp_tab.get(irt, opnd);
     if (res == nullptr) {
         res = allocVN();
         VN_type(res) = VN_OP;
         VN_op(res) = irt;
-        tab1->set(VN_id(v0), res);
+        m_exp_tab.set(irt, opnd, res);
     }
     return res;
 }
 
 
+VN * GVN::registerUnaVN(IR_CODE irt, VN const* v0)
+{
+    ASSERT0(v0);
+    ASSERT0(isUnary(irt));
+    UINT opnd[VNEXP_MAX_OPND_NUM] = { VN_id(v0), VNID_UNDEF, VNID_UNDEF,
+                                      VNID_UNDEF };
+    return registerOpVN(irt, opnd);
+}
+
+
 VN * GVN::registerBinVN(IR_CODE irt, VN const* v0, VN const* v1)
 {
     ASSERT0(v0 && v1);
@@ -1319,29 +1415,9 @@ VN * GVN::registerBinVN(IR_CODE irt, VN const* v0, VN const* v1)
     if (irt == IR_GE) {
         return registerBinVN(IR_LE, v1, v0);
     }
-
-    Tab2 * tab2 = (Tab2*)m_irc_vec.get(irt);
-    if (tab2 == nullptr) {
-        tab2 = new Tab2();
-        m_tab_lst.append_tail((Tab1*)tab2);
-        m_irc_vec.set(irt, (void*)tab2);
-    }
-
-    Tab1 * tab1 = tab2->get(VN_id(v0));
-    if (tab1 == nullptr) {
-        tab1 = new Tab1();
-        m_tab_lst.append_tail((Tab1*)tab1);
-        tab2->set(VN_id(v0), tab1);
-    }
-
-    VN * res = tab1->get(VN_id(v1));
-    if (res == nullptr) {
-        res = allocVN();
-        VN_type(res) = VN_OP;
-        VN_op(res) = irt;
-        tab1->set(VN_id(v1), res);
-    }
-    return res;
+    UINT opnd[VNEXP_MAX_OPND_NUM] = { VN_id(v0), VN_id(v1), VNID_UNDEF,
+                                      VNID_UNDEF };
+    return registerOpVN(irt, opnd);
 }
 
 
@@ -1350,35 +1426,9 @@ VN * GVN::registerTripleVN(IR_CODE irt, VN const* v0, VN const* v1,
 {
     ASSERT0(v0 && v1 && v2);
     ASSERT0(isTriple(irt));
-    Tab3 * tab3 = (Tab3*)m_irc_vec.get(irt);
-    if (tab3 == nullptr) {
-        tab3 = new Tab3();
-        m_tab_lst.append_tail((Tab1*)tab3);
-        m_irc_vec.set(irt, (void*)tab3);
-    }
-
-    Tab2 * tab2 = tab3->get(VN_id(v0));
-    if (tab2 == nullptr) {
-        tab2 = new Tab2();
-        m_tab_lst.append_tail((Tab1*)tab2);
-        tab3->set(VN_id(v0), tab2);
-    }
-
-    Tab1 * tab1 = tab2->get(VN_id(v1));
-    if (tab1 == nullptr) {
-        tab1 = new Tab1();
-        m_tab_lst.append_tail((Tab1*)tab1);
-        tab2->set(VN_id(v1), tab1);
-    }
-
-    VN * res = tab1->get(VN_id(v2));
-    if (res == nullptr) {
-        res = allocVN();
-        VN_type(res) = VN_OP;
-        VN_op(res) = irt;
-        tab1->set(VN_id(v2), res);
-    }
-    return res;
+    UINT opnd[VNEXP_MAX_OPND_NUM] = { VN_id(v0), VN_id(v1), VN_id(v2),
+                                      VNID_UNDEF };
+    return registerOpVN(irt, opnd);
 }
 
 
@@ -1387,42 +1437,9 @@ VN * GVN::registerQuadVN(IR_CODE irt, VN const* v0, VN const* v1,
 {
     ASSERT0(v0 && v1 && v2 && v3);
     ASSERT0(isQuad(irt));
-    Tab4 * tab4 = (Tab4*)m_irc_vec.get(irt);
-    if (tab4 == nullptr) {
-        tab4 = new Tab4();
-        m_tab_lst.append_tail((Tab1*)tab4);
-        m_irc_vec.set(irt, (void*)tab4);
-    }
-
-    Tab3 * tab3 = tab4->get(VN_id(v0));
-    if (tab3 == nullptr) {
-        tab3 = new Tab3();
-        m_tab_lst.append_tail((Tab1*)tab3);
-        tab4->set(VN_id(v0), tab3);
-    }
-
-    Tab2 * tab2 = tab3->get(VN_id(v1));
-    if (tab2 == nullptr) {
-        tab2 = new Tab2();
-        m_tab_lst.append_tail((Tab1*)tab2);
-        tab3->set(VN_id(v1), tab2);
-    }
-
-    Tab1 * tab1 = tab2->get(VN_id(v2));
-    if (tab1 == nullptr) {
-        tab1 = new Tab1();
-        m_tab_lst.append_tail(tab1);
-        tab2->set(VN_id(v2), tab1);
-    }
-
-    VN * res = tab1->get(VN_id(v3));
-    if (res == nullptr) {
-        res = allocVN();
-        VN_type(res) = VN_OP;
-        VN_op(res) = irt;
-        tab1->set(VN_id(v3), res);
-    }
-    return res;
+    UINT opnd[VNEXP_MAX_OPND_NUM] = { VN_id(v0), VN_id(v1), VN_id(v2),
+                                      VN_id(v3) };
+    return registerOpVN(irt, opnd);
 }
 
 
@@ -1677,7 +1694,7 @@ VN const* GVN::computeILoadByAnonDomDef(IR const* ild, VN const* mlvn,
     //    ild(v1); //s2
     //    vn of s1 should not same as s2.
     if (vnexp_map == nullptr) {
-        vnexp_map = new ILD_VNE2VN(m_pool, 16); //bsize to be evaluate.
+        vnexp_map = new ILD_VNE2VN(m_vne_pool, 16); //bsize to be evaluate.
         m_def2ildtab.set(domdef, vnexp_map);
     }
 
@@ -1792,7 +1809,7 @@ VN const* GVN::computeArrayByAnonDomDef(IR const* arr, VN const* basevn,
     // array(v1); //s2
     // vn of s1 should not same as s2.
     if (vnexp_map == nullptr) {
-        vnexp_map = new ARR_VNE2VN(m_pool, 16); //bsize to be evaluated.
+        vnexp_map = new ARR_VNE2VN(m_vne_pool, 16); //bsize to be evaluated.
         m_def2arrtab.set(domdef, vnexp_map);
     }
     VN * vn = vnexp_map->get(&vexp);
@@ -1910,7 +1927,7 @@ VN const* GVN::computeScalarByAnonDomDef(IR const* exp, IR const* domdef,
     //    v1; //s2
     //    vn of s1 should not same as s2.
     if (vnexp_map == nullptr) {
-        vnexp_map = new SCVNE2VN(m_pool, 16); //bsize to be evaluate.
+        vnexp_map = new SCVNE2VN(m_vne_pool, 16); //bsize to be evaluate.
         m_def2sctab.set(domdef, vnexp_map);
     }
     VN * vn = vnexp_map->get(&vexp);
@@ -2730,6 +2747,12 @@ void GVN::processBBListInRPO()
     RPOVexList * vlst = m_cfg->getRPOVexList();
     ASSERT0(vlst);
     ASSERT0(vlst->get_elem_count() == m_rg->getBBList()->get_elem_count());
+    if (useMDSSADU() && m_mdssamgr->hasUnbuiltClass()) {
+        //GVN numbers every stmt of region, thus all the alias classes are
+        //needed. Build them by one construction before numbering rather
+        //than building classes BB by BB.
+        m_mdssamgr->buildAllOnDemand(*m_oc);
+    }
     UINT count = 0;
     bool change = true;
     while (change && count < 100) {
@@ -3126,6 +3149,10 @@ bool GVN::perform(OptCtx & oc)
         return false;
     }
     START_TIMER(t, getPassName());
+
+    //VN expressions are destroyed before leaving the function, discard
+    //their memory at once.
+    xcom::SMemPoolScope vne_scope(m_vne_pool);
     reset();
     m_rg->getPassMgr()->checkValidAndRecompute(
         &oc, PASS_RPO, PASS_DOM, PASS_UNDEF);
@@ -39,26 +39,6 @@ author: Su Zhenyu
 namespace xoc {
 class VN;
 
-//Note the key-value pair type of Tab1, Tab2, ... TabN must be <UINT, pointer>.
-typedef xcom::TMapIter<UINT, VN*> Tab1Iter;
-class Tab1 : public xcom::TMap<UINT, VN*> {
-};
-
-//Note the key-value pair type of Tab1, Tab2, ... TabN must be <UINT, pointer>.
-typedef xcom::TMapIter<UINT, Tab1*> Tab2Iter;
-class Tab2 : public xcom::TMap<UINT, Tab1*> {
-};
-
-//Note the key-value pair type of Tab1, Tab2, ... TabN must be <UINT, pointer>.
-typedef xcom::TMapIter<UINT, Tab2*> Tab3Iter;
-class Tab3 : public xcom::TMap<UINT, Tab2*> {
-};
-
-//Note the key-value pair type of Tab1, Tab2, ... TabN must be <UINT, pointer>.
-typedef xcom::TMapIter<UINT, Tab3*> Tab4Iter;
-class Tab4 : public xcom::TMap<UINT, Tab3*> {
-};
-
 typedef enum _VN_TYPE {
     VN_UNKNOWN = 0,
     VN_OP, //The numbered value reasoned from IR stmt or expression.
@@ -153,6 +133,57 @@ public:
 };
 
 
+//The maximum number of operand VN of an operation.
+#define VNEXP_MAX_OPND_NUM 4
+
+//The entry records an operation and the VN of its operands.
+//The unused operand slot is VNID_UNDEF.
+class VNExpEntry {
+public:
+    VN * vn; //nullptr indicates the entry is empty.
+    UINT code; //IR_CODE of the operation.
+    UINT opnd[VNEXP_MAX_OPND_NUM];
+};
+
+
+//The class maps an operation, which is composed by IR_CODE and the VN id of
+//its operands, to the VN of the operation.
+//The table uses open addressing with linear probing, and all the entries are
+//stored in one contiguous buffer, thus a lookup does not need to walk
+//through any tree or chain.
+class VNExpTab {
+    COPY_CONSTRUCTOR(VNExpTab);
+protected:
+    UINT m_capacity; //always be power of 2.
+    UINT m_num; //the number of occupied entries.
+    VNExpEntry * m_entry;
+protected:
+    static UINT computeHash(UINT code, UINT const* opnd);
+    VNExpEntry * findEntry(UINT code, UINT const* opnd) const;
+    void grow();
+public:
+    VNExpTab() { m_capacity = 0; m_num = 0; m_entry = nullptr; }
+    ~VNExpTab() { destroy(); }
+
+    //Remove all entries but keep the buffer for later use.
+    void clean();
+
+    void destroy();
+
+    //Return the VN that mapped to operation, or nullptr if not found.
+    //opnd: VN id of operands, the unused slot should be VNID_UNDEF.
+    VN * get(IR_CODE code, UINT const* opnd) const;
+
+    //Return the number of operations in table.
+    UINT get_elem_count() const { return m_num; }
+
+    //Map the operation to 'vn'.
+    //opnd: VN id of operands, the unused slot should be VNID_UNDEF.
+    //NOTE: the operation must not be in the table.
+    void set(IR_CODE code, UINT const* opnd, VN * vn);
+};
+
+
 class DoubleHashFunc : public HashFuncBase<double> {
     COPY_CONSTRUCTOR(DoubleHashFunc);
 public:
@@ -168,21 +199,23 @@ public:
 typedef xcom::VecIdx FP2VNIter;
 typedef xcom::HMap<double, VN*, DoubleHashFunc> FP2VN;
 
+//The following maps are frequently accessed and the number of element
+//is unpredictable, use open addressing hash that grows automatically.
 typedef VecIdx Longlong2VNIter;
-typedef xcom::HMap<LONGLONG, VN*> Longlong2VN;
+typedef xcom::OAHashMap<LONGLONG, VN*> Longlong2VN;
 
 typedef VecIdx LonglongMC2VNIter;
-typedef xcom::HMap<LONGLONG, VN*> LonglongMC2VN;
+typedef xcom::OAHashMap<LONGLONG, VN*> LonglongMC2VN;
 
 typedef VecIdx MD2VNIter;
-typedef xcom::HMap<MD const*, VN*> MD2VN;
+typedef xcom::OAHashMap<MD const*, VN*> MD2VN;
 
 //Note: SymbolHashFunc request bucket size must be the power of 2.
 typedef VecIdx Sym2VNIter;
-class Sym2VN : public xcom::HMap<Sym const*, VN*, SymbolHashFunc> {
+class Sym2VN : public xcom::OAHashMap<Sym const*, VN*, SymbolHashFunc> {
     COPY_CONSTRUCTOR(Sym2VN);
 public:
-    Sym2VN() : HMap<Sym const*, VN*, SymbolHashFunc>(0) {}
+    Sym2VN() : OAHashMap<Sym const*, VN*, SymbolHashFunc>(0) {}
 };
 
 typedef TMapIter<UINT, VN const*> IR2VNIter;
@@ -317,7 +350,6 @@ class SCVNE2VN : public HMap<VNE_SC*, VN*, VNE_SC_HF> {
     COPY_CONSTRUCTOR(SCVNE2VN);
 protected:
     SMemPool * m_pool;
-    List<VNE_SC*> m_free_lst;
 public:
     SCVNE2VN(SMemPool * pool, UINT bsize) :
         HMap<VNE_SC*, VN*, VNE_SC_HF>(bsize)
@@ -325,14 +357,15 @@ public:
         ASSERT0(pool);
         m_pool = pool;
     }
-    virtual ~SCVNE2VN() {}
+    virtual ~SCVNE2VN()
+    {
+        //Return elements to the external mempool to be reused.
+        clean();
+    }
 
     virtual VNE_SC * create(OBJTY v)
     {
-        VNE_SC * ve = m_free_lst.remove_head();
-        if (ve == nullptr) {
-            ve = (VNE_SC*)smpoolMalloc(sizeof(VNE_SC), m_pool);
-        }
+        VNE_SC * ve = (VNE_SC*)smpoolMalloc(sizeof(VNE_SC), m_pool);
         ve->copy(*(VNE_SC*)v);
         return ve;
     }
@@ -342,7 +375,7 @@ public:
         VecIdx c;
         for (VNE_SC * ve = get_first(c); ve != nullptr; ve = get_next(c)) {
             ve->clean();
-            m_free_lst.append_head(ve);
+            smpoolFree(ve, sizeof(VNE_SC), m_pool);
         }
         HMap<VNE_SC*, VN*, VNE_SC_HF>::clean();
     }
@@ -377,7 +410,6 @@ class ILD_VNE2VN : public HMap<VNE_ILD*, VN*, VNE_ILD_HF> {
     COPY_CONSTRUCTOR(ILD_VNE2VN);
 protected:
     SMemPool * m_pool;
-    List<VNE_ILD*> m_free_lst;
 public:
     ILD_VNE2VN(SMemPool * pool, UINT bsize) :
         HMap<VNE_ILD*, VN*, VNE_ILD_HF>(bsize)
@@ -387,15 +419,13 @@ public:
     }
     virtual ~ILD_VNE2VN()
     {
-        //All elements are allocated in external mempool. Nothing to do.
+        //Return elements to the external mempool to be reused.
+        clean();
     }
 
     virtual VNE_ILD * create(OBJTY v)
     {
-        VNE_ILD * ve = m_free_lst.remove_head();
-        if (ve == nullptr) {
-            ve = (VNE_ILD*)smpoolMalloc(sizeof(VNE_ILD), m_pool);
-        }
+        VNE_ILD * ve = (VNE_ILD*)smpoolMalloc(sizeof(VNE_ILD), m_pool);
         ve->copy(*(VNE_ILD*)v);
         return ve;
     }
@@ -405,7 +435,7 @@ public:
         VecIdx c;
         for (VNE_ILD * ve = get_first(c); ve != nullptr; ve = get_next(c)) {
             ve->clean();
-            m_free_lst.append_head(ve);
+            smpoolFree(ve, sizeof(VNE_ILD), m_pool);
         }
         HMap<VNE_ILD*, VN*, VNE_ILD_HF>::clean();
     }
@@ -504,7 +534,6 @@ class ARR_VNE2VN : public HMap<VNE_ARR*, VN*, VNE_ARR_HF> {
     COPY_CONSTRUCTOR(ARR_VNE2VN);
 protected:
     SMemPool * m_pool;
-    List<VNE_ARR*> m_free_lst;
 public:
     ARR_VNE2VN(SMemPool * pool, UINT bsize) :
         HMap<VNE_ARR*, VN*, VNE_ARR_HF>(bsize)
@@ -512,14 +541,15 @@ public:
         ASSERT0(pool);
         m_pool = pool;
     }
-    virtual ~ARR_VNE2VN() {}
+    virtual ~ARR_VNE2VN()
+    {
+        //Return elements to the external mempool to be reused.
+        clean();
+    }
 
     VNE_ARR * create(OBJTY v)
     {
-        VNE_ARR * ve = m_free_lst.remove_head();
-        if (ve == nullptr) {
-            ve = (VNE_ARR*)smpoolMalloc(sizeof(VNE_ARR), m_pool);
-        }
+        VNE_ARR * ve = (VNE_ARR*)smpoolMalloc(sizeof(VNE_ARR), m_pool);
         ve->copy(*(VNE_ARR*)v);
         return ve;
     }
@@ -529,7 +559,7 @@ public:
         VecIdx c;
         for (VNE_ARR * ve = get_first(c); ve != nullptr; ve = get_next(c)) {
             ve->clean();
-            m_free_lst.append_head(ve);
+            smpoolFree(ve, sizeof(VNE_ARR), m_pool);
         }
         HMap<VNE_ARR*, VN*, VNE_ARR_HF>::clean();
     }
@@ -555,10 +585,10 @@ public:
 };
 
 
-class IR2IR : public HMap<IR const*, IR const*, HashFuncBase2<IR const*> > {
+class IR2IR : public OAHashMap<IR const*, IR const*> {
     COPY_CONSTRUCTOR(IR2IR);
 public:
-    IR2IR() : HMap<IR const*, IR const*, HashFuncBase2<IR const*> >(0) {}
+    IR2IR() : OAHashMap<IR const*, IR const*>(0) {}
 };
 
 
@@ -763,7 +793,7 @@ protected:
     }
 
     bool useMDSSADU() const
-    { return m_mdssamgr != nullptr && m_mdssamgr->is_valid(); }
+    { return m_mdssamgr != nullptr && m_mdssamgr->isValidOnDemand(); }
     bool usePRSSADU() const
     { return m_prssamgr != nullptr && m_prssamgr->is_valid(); }
 public:
@@ -819,6 +849,7 @@ protected:
     VN * m_zero_vn;
     VN * m_mc_zero_vn;
     xcom::SMemPool * m_pool;
+    xcom::SMemPool * m_vne_pool; //VN expressions are local used in perform().
     xcom::Vector<VN const*> * m_vn_vec; //optional, usually used to dump.
     OptCtx * m_oc;
     UINT m_vn_count;
@@ -830,8 +861,7 @@ protected:
     Sym2VN m_str2vn;
     MD2VN m_md2vn;
     xcom::List<VN*> m_free_lst;
-    xcom::List<Tab1*> m_tab_lst;
-    xcom::Vector<void*> m_irc_vec;
+    VNExpTab m_exp_tab;
     IR2ILDVNE m_def2ildtab;
     IR2ARRVNE m_def2arrtab;
     IR2SCVNE m_def2sctab;
@@ -927,6 +957,9 @@ protected:
                           VN const* v2);
     VN * registerBinVN(IR_CODE irt, VN const* v0, VN const* v1);
     VN * registerUnaVN(IR_CODE irt, VN const* v0);
+
+    //Register VN for operation 'irt' with the VN id of its operands.
+    VN * registerOpVN(IR_CODE irt, UINT const* opnd);
     VN * registerVNviaMD(MD const* md);
     VN * registerVNviaMC(LONGLONG v);
     VN * registerVNviaINT(LONGLONG v);
@@ -954,7 +987,7 @@ protected:
     bool useClassicNonPRDU() const
     { return getOptCtx()->is_nonpr_du_chain_valid(); }
     bool useMDSSADU() const
-    { return m_mdssamgr != nullptr && m_mdssamgr->is_valid(); }
+    { return m_mdssamgr != nullptr && m_mdssamgr->isValidOnDemand(); }
     bool usePRSSADU() const
     { return m_prssamgr != nullptr && m_prssamgr->is_valid(); }
 
@@ -1007,6 +1040,9 @@ public:
     virtual CHAR const* getPassName() const { return "Global Value Numbering"; }
     PASS_TYPE getPassType() const { return PASS_GVN; }
 
+    //GVN builds the alias classes of BB before numbering its IRs.
+    virtual bool isMDSSAOnDemandClient() const { return true; }
+
     //Return true if the value of ir1 and ir2 are definitely same, otherwise
     //return false to indicate unknown.
     //The function will retrieve dependence through SSA, thus MDSSA and PRSSA
@@ -79,7 +79,7 @@ void Region::HighProcessImpl(OptCtx & oc)
     }
 
     if (g_infer_type) {
-        getPassMgr()->registerPass(PASS_INFER_TYPE)->perform(oc);
+        getPassMgr()->performPass(PASS_INFER_TYPE, oc);
     }
 
     doBasicAnalysis(oc);
@@ -176,7 +176,7 @@ protected:
     }
 
     bool useMDSSADU() const
-    { return m_mdssamgr != nullptr && m_mdssamgr->is_valid(); }
+    { return m_mdssamgr != nullptr && m_mdssamgr->isValidOnDemand(); }
     bool usePRSSADU() const
     { return m_prssamgr != nullptr && m_prssamgr->is_valid(); }
 public:
@@ -496,7 +496,7 @@ private:
     //The funtion should be invoked after phi modified.
     void updateMDSSADUForLoopHeadPhi(HoistCtx const& ctx);
     bool useMDSSADU() const
-    { return m_mdssamgr != nullptr && m_mdssamgr->is_valid(); }
+    { return m_mdssamgr != nullptr && m_mdssamgr->isValidOnDemand(); }
     void updateDomTree(DomTree & domtree);
 public:
     InsertPreheaderMgr(Region * rg, OptCtx * oc, LICM * licm, RCE const* rce,
@@ -941,8 +941,12 @@ bool LICM::scanBB(IRBB * bb, bool * islegal, OUT LICMAnaCtx & anactx)
     for (IR * ir = bb->getIRList().get_head(&it);
          ir != nullptr; ir = bb->getIRList().get_next(&it)) {
         if (!isWorthHoist(ir)) { continue; }
-        if ((ir->isCallStmt() && !ir->isReadOnly()) || ir->is_region()) {
+        if ((ir->isCallStmt() && !ir->isReadOnly() &&
+             getCalleeModRefSummary(ir, m_rg) == nullptr) ||
+            ir->is_region()) {
             //TODO: support call/region.
+            //The MayRef of call is precise if the MOD/REF summary of
+            //callee is available.
             //Note PHI has been handled in isLoopInvariantInPRSSA().
             *islegal = false; //prevent loop hoisting.
             return false;
@@ -2255,6 +2259,19 @@ bool LICM::processLoop(LI<IRBB> * li, HoistCtx & ctx)
 }
 
 
+void LICM::buildMDSSAOnDemand(LI<IRBB> const* li, HoistCtx const& ctx)
+{
+    if (!ctx.useMDSSADU() || !ctx.mdssamgr->hasUnbuiltClass()) { return; }
+    //Only the alias classes that referenced in loop body are needed, build
+    //them before any IR changed.
+    xcom::BitSet bbset;
+    for (LI<IRBB> const* tli = li; tli != nullptr; tli = LI_next(tli)) {
+        bbset.bunion(*tli->getBodyBBSet());
+    }
+    ctx.mdssamgr->buildOnDemandForBBSet(bbset, *ctx.oc);
+}
+
+
 bool LICM::doLoopTree(LI<IRBB> * li, HoistCtx & ctx)
 {
     if (li == nullptr) { return false; }
@@ -2299,6 +2316,10 @@ void LICM::postProcessIfChanged(HoistCtx const& ctx, OptCtx & oc)
     }
     ASSERT0(m_cfg->verifyLoopInfo(oc));
     oc.setInvalidPass(PASS_EXPR_TAB);
+
+    //The hoisted stmt is no longer guarded by the conditions in loop, thus
+    //the value range of PR has to be recomputed.
+    oc.setInvalidPass(PASS_VRP);
     if (ctx.duset_changed) {
         oc.setInvalidPass(PASS_LIVE_EXPR);
         oc.setInvalidPass(PASS_AVAIL_REACH_DEF);
@@ -2373,7 +2394,7 @@ bool LICM::initDepPass(MOD HoistCtx & ctx)
     if (m_rce != nullptr && m_rce->is_use_gvn()) {
         GVN * gvn = (GVN*)m_rg->getPassMgr()->queryPass(PASS_GVN);
         if (!gvn->is_valid()) {
-            gvn->perform(*ctx.oc);
+            m_rg->getPassMgr()->performPass(gvn, *ctx.oc);
         }
     }
     return true;
@@ -2394,6 +2415,7 @@ bool LICM::perform(OptCtx & oc)
     HoistCtx ctx(&oc, &domtree, m_cfg);
     if (!initDepPass(ctx)) { END_TIMER(t, getPassName()); return false; }
     ctx.buildDomTree(m_cfg);
+    buildMDSSAOnDemand(m_cfg->getLoopInfo(), ctx);
     bool change = doLoopTree(m_cfg->getLoopInfo(), ctx);
     postProcess(ctx, change, oc);
     clean();
@@ -102,7 +102,7 @@ public:
         stmt_changed |= src.stmt_changed;
     }
     bool useMDSSADU() const
-    { return mdssamgr != nullptr && mdssamgr->is_valid(); }
+    { return mdssamgr != nullptr && mdssamgr->isValidOnDemand(); }
     bool usePRSSADU() const
     { return prssamgr != nullptr && prssamgr->is_valid(); }
 
@@ -300,6 +300,10 @@ protected:
     bool canBeRegardAsInvExp(IR const* ir, LICMAnaCtx const& anactx) const;
     bool canBeRegardAsInvExpList(IR const* ir, LICMAnaCtx const& anactx) const;
 
+    //Build the MDSSA of alias classes that referenced in loop tree 'li' in
+    //demand-driven mode.
+    void buildMDSSAOnDemand(LI<IRBB> const* li, HoistCtx const& ctx);
+
     //Return true if code motion happened.
     //The funtion will maintain LoopInfo.
     bool doLoopTree(LI<IRBB> * li, OUT HoistCtx & ctx);
@@ -497,6 +501,9 @@ public:
     { return "Loop Invariant Code Motion"; }
     PASS_TYPE getPassType() const { return PASS_LICM; }
 
+    //LICM only builds the alias classes of loop bodies.
+    virtual bool isMDSSAOnDemandClient() const { return true; }
+
     virtual bool perform(OptCtx & oc);
 };
 
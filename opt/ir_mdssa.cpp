@@ -33,6 +33,19 @@ author: Su Zhenyu
 
 namespace xoc {
 
+//Return the first non-PR MD that 'ir' referenced, or MD_UNDEF if there is not.
+static MDIdx getFirstRefMD(IR const* ir)
+{
+    MD const* ref = ir->getMustRef();
+    if (ref != nullptr && !ref->is_pr()) { return ref->id(); }
+    MDSet const* refset = ir->getMayRef();
+    if (refset == nullptr) { return MD_UNDEF; }
+    MDSetIter iter;
+    BSIdx i = refset->get_first(&iter);
+    return i == BS_UNDEF ? MD_UNDEF : (MDIdx)i;
+}
+
+
 typedef xcom::TTab<MDPhi const*> PhiTab;
 
 static CHAR const* g_parting_line_char = "----------------";
@@ -1605,6 +1618,9 @@ size_t MDSSAMgr::count_mem() const
     size_t count = m_map_md2stack.count_mem();
     count += m_max_version.count_mem();
     count += m_usedef_mgr.count_mem();
+    count += m_md2class.count_mem();
+    count += m_built_md.count_mem();
+    count += m_unbuilt_md.count_mem();
     count += sizeof(*this);
     return count;
 }
@@ -1641,6 +1657,7 @@ void MDSSAMgr::destroy()
     //         "SSA before destroy"));
 
     freePhiList();
+    finiOnDemandCFGInfo();
     delete m_am;
     m_am = nullptr;
 }
@@ -2234,17 +2251,17 @@ bool MDSSAMgr::isRegionLiveIn(IR const* ir) const
         if (mddef->is_phi()) {
             //CASE: Determine whether exist MayDef by crossing MDPhi.
             //e.g: t1 is region live-in.
-            //  BB1:
-            //  st d = ld t2; //d's MD ref is {MD11V1:MD2V1}
-            //  falsebr L1 ld i, 0;
-            //   |   |
-            //   |   V
-            //   |  BB2:
+            //  BB1:
+            //  st d = ld t2; //d's MD ref is {MD11V1:MD2V1}
+            //  falsebr L1 ld i, 0;
+            //   |   |
+            //   |   V
+            //   |  BB2:
             //   |  st e = #20; //e's MD ref is {MD12V1:MD2V2}
             //   |  |
             //   V  V
-            //  BB3:
-            //  L1:
+            //  BB3:
+            //  L1:
             //  MDPhi: MD2V3 <- (MD2V1 BB1), (MD2V2 BB2)
             //  return ld t1; //t1's MD ref is {MD7V0:MD2V3}
             if (!isRegionLiveInByMDPhi(
@@ -2779,8 +2796,8 @@ bool MDSSAMgr::isDom(MDDef const* def1, MDDef const* def2) const
 void MDSSAMgr::initVMD(IN IR * ir, OUT DefMDSet & maydef)
 {
     ASSERT0(ir->is_stmt());
-    if (ir->isMemRefNonPR() ||
-        (ir->isCallStmt() && !ir->isReadOnly())) {
+    if ((ir->isMemRefNonPR() ||
+         (ir->isCallStmt() && !ir->isReadOnly())) && isInBuildFilter(ir)) {
         MD const* ref = ir->getMustRef();
         if (ref != nullptr &&
            !ref->is_pr()) { //MustRef of CallStmt may be PR.
@@ -2796,7 +2813,7 @@ void MDSSAMgr::initVMD(IN IR * ir, OUT DefMDSet & maydef)
     for (IR * t = xoc::iterExpInit(ir, m_iter);
          t != nullptr; t = xoc::iterExpNext(m_iter)) {
         ASSERT0(t->is_exp());
-        if (t->isMemRefNonPR()) {
+        if (t->isMemRefNonPR() && isInBuildFilter(t)) {
             genMDSSAInfoAndVOpnd(t, MDSSA_INIT_VERSION);
         }
     }
@@ -3053,6 +3070,7 @@ void MDSSAMgr::recordEffectMD(IRBB const* bb, OUT DefMDSet & effect_md)
     LiveInMDTabIter iter;
     for (UINT mdid = livein_md.get_first(iter);
          mdid != MD_UNDEF; mdid = livein_md.get_next(iter)) {
+        if (!isInBuildFilter((MDIdx)mdid)) { continue; }
         effect_md.bunion(mdid);
     }
 }
@@ -3413,6 +3431,7 @@ void MDSSAMgr::renamePhiResult(IN IRBB * bb, MD2VMDStack & md2vmdstk)
         //Rename phi result.
         VMD * vopnd = phi->getResult();
         ASSERT0(vopnd && vopnd->is_md());
+        if (!isInBuildFilter(vopnd->mdid())) { continue; }
 
         //Update versioned MD.
         VMD * newv = genNewVersionVMD(vopnd->mdid());
@@ -3438,7 +3457,8 @@ void MDSSAMgr::renameBB(IN IRBB * bb, MD2VMDStack & md2vmdstk)
         m_iter.clean();
         for (IR * opnd = xoc::iterInit(ir, m_iter);
              opnd != nullptr; opnd = xoc::iterNext(m_iter)) {
-            if (!opnd->isMemOpnd() || opnd->isReadPR()) {
+            if (!opnd->isMemOpnd() || opnd->isReadPR() ||
+                !isInBuildFilter(opnd)) {
                 continue;
             }
 
@@ -3453,7 +3473,9 @@ void MDSSAMgr::renameBB(IN IRBB * bb, MD2VMDStack & md2vmdstk)
             renameUse(opnd, md2vmdstk);
         }
 
-        if (!ir->isMemRef() || ir->isWritePR()) { continue; }
+        if (!ir->isMemRef() || ir->isWritePR() || !isInBuildFilter(ir)) {
+            continue;
+        }
 
         //Rename result.
         renameDef(ir, bb, md2vmdstk);
@@ -3496,6 +3518,7 @@ void MDSSAMgr::handlePhiInSuccBB(IRBB * succ, UINT opnd_idx,
         IR * opnd = phi->getOpnd(opnd_idx);
         ASSERT0(opnd && opnd->is_id());
         ASSERT0(opnd->getMustRef());
+        if (!isInBuildFilter(opnd->getMustRef()->id())) { continue; }
 
         VMD * topv = md2vmdstk.get_top(opnd->getMustRef()->id());
         ASSERTN(topv, ("miss def-stmt to operand of phi"));
@@ -4459,6 +4482,10 @@ void MDSSAMgr::changeDef(IR * olddef, IR * newdef)
     ASSERT0(olddef && newdef && olddef->is_stmt() && newdef->is_stmt());
     ASSERT0(olddef != newdef);
     ASSERT0(olddef->isMemRefNonPR() && newdef->isMemRefNonPR());
+    if (m_is_on_demand && mergeClassOnDemand(olddef, newdef)) {
+        //The DU chain will be built when the class is queried.
+        return;
+    }
     MDSSAInfo * oldmdssainfo = getMDSSAInfoIfAny(olddef);
     ASSERT0(oldmdssainfo);
     VOpndSetIter it = nullptr;
@@ -4573,6 +4600,10 @@ void MDSSAMgr::findAndSetLiveInDef(
     ASSERT0(startir == nullptr ||
             (startir->is_stmt() && startir->getBB() == startbb));
     ASSERT0(exp && exp->is_exp() && exp->isMemRefNonPR());
+    if (!isBuiltOnDemand(getFirstRefMD(exp))) {
+        //The exp will be renamed when its alias class is built.
+        return;
+    }
     MDSSAInfo * info = genMDSSAInfo(exp);
     ASSERT0(info);
     List<VMD*> newvmds;
@@ -4831,7 +4862,9 @@ void MDSSAMgr::addMDSSAOccForTree(IR * ir, IR const* ref)
         if (mdssainfo != nullptr) {
             copyAndAddMDSSAOcc(ir, mdssainfo);
         } else {
-            ASSERT0(!hasMDSSAInfo(ref));
+            //The IR of unbuilt alias class does not have MDSSAInfo.
+            ASSERT0(!hasMDSSAInfo(ref) ||
+                    !isBuiltOnDemand(getFirstRefMD(ref)));
         }
     }
     for (UINT i = 0; i < IR_MAX_KID_NUM(ir); i++) {
@@ -5617,6 +5650,10 @@ void MDSSAMgr::reinit()
     m_max_version.destroy();
     m_max_version.init();
     m_usedef_mgr.reinit();
+    m_md2class.clean();
+    m_built_md.clean();
+    m_unbuilt_md.clean();
+    m_is_on_demand = false;
     init();
 }
 
@@ -5653,7 +5690,12 @@ bool MDSSAMgr::verifyMDSSAInfo(Region const* rg, OptCtx const& oc)
 {
     MDSSAMgr * ssamgr = (MDSSAMgr*)(rg->getPassMgr()->
         queryPass(PASS_MDSSA_MGR));
-    if (ssamgr == nullptr || !ssamgr->is_valid()) { return true; }
+    if (ssamgr == nullptr || !ssamgr->isValidOnDemand()) { return true; }
+    if (ssamgr->hasUnbuiltClass()) {
+        //The verification walks through all IRs, it is only applicable to
+        //the complete MDSSA.
+        return true;
+    }
     ASSERT0(ssamgr->verify());
     ASSERT0(ssamgr->verifyPhi());
     if (oc.is_dom_valid()) {
@@ -5903,6 +5945,14 @@ void MDSSAMgr::construction(OptCtx & oc)
     ASSERT0(oc.is_ref_valid());
     ASSERT0(oc.is_dom_valid());
     reinit();
+    if (m_rg->isMemBudgetExceeded()) {
+        //Region that exceeded memory budget does not build MDSSA, the
+        //passes that rely on non-PR DU chain will be skipped conservatively
+        //as if MDSSA is unavailable.
+        END_TIMER(t0, "MDSSA: Construction");
+        return;
+    }
+    m_is_on_demand = g_mdssa_build_on_demand;
     //Extract dominate tree of CFG.
     START_TIMER(t1, "MDSSA: Extract Dom Tree");
     DomTree domtree;
@@ -5926,6 +5976,12 @@ bool MDSSAMgr::construction(DomTree & domtree, OptCtx & oc)
     if (dfm.hasHighDFDensityVertex((xcom::DGraph&)*m_cfg)) {
         return false;
     }
+    if (m_is_on_demand) {
+        //The SSA form of each alias class will be built at the first query.
+        computeMDClass();
+        m_is_valid = true;
+        return true;
+    }
 
     List<IRBB*> wl;
     DefMiscBitSetMgr bs_mgr;
@@ -5950,6 +6006,360 @@ bool MDSSAMgr::construction(DomTree & domtree, OptCtx & oc)
     ASSERT0(verifyPhi() && verifyAllVMD() && verifyVersion(oc));
     return true;
 }
+
+
+bool MDSSAMgr::isRefInMDSet(IR const* ir, DefMDSet const& mds) const
+{
+    MDIdx mdid = getFirstRefMD(ir);
+    //IR without memory reference does not belong to any alias class,
+    //its MDSSAInfo is generated by computeMDClass() and always empty.
+    return mdid != MD_UNDEF && mds.is_contain(mdid);
+}
+
+
+MDIdx MDSSAMgr::findMDClass(MDIdx mdid)
+{
+    MDIdx root = mdid;
+    for (MDIdx p = m_md2class.get(root); p != MD_UNDEF;
+         p = m_md2class.get(root)) {
+        root = p;
+    }
+    //Compress the path to root.
+    for (MDIdx p = mdid; p != root;) {
+        MDIdx next = m_md2class.get(p);
+        m_md2class.set(p, root);
+        p = next;
+    }
+    return root;
+}
+
+
+void MDSSAMgr::unionMDClass(MDIdx md1, MDIdx md2)
+{
+    MDIdx root1 = findMDClass(md1);
+    MDIdx root2 = findMDClass(md2);
+    if (root1 == root2) { return; }
+    m_md2class.set(root2, root1);
+}
+
+
+void MDSSAMgr::unionMDClassForIR(IR const* ir)
+{
+    MDIdx first = MD_UNDEF;
+    MD const* ref = ir->getMustRef();
+    if (ref != nullptr && !ref->is_pr()) {
+        first = ref->id();
+        if (!m_built_md.is_contain(first)) { m_unbuilt_md.bunion(first); }
+    }
+    MDSet const* refset = ir->getMayRef();
+    if (refset == nullptr) { return; }
+    MDSetIter iter;
+    for (BSIdx i = refset->get_first(&iter);
+         i != BS_UNDEF; i = refset->get_next((UINT)i, &iter)) {
+        if (!m_built_md.is_contain(i)) { m_unbuilt_md.bunion(i); }
+        if (first == MD_UNDEF) {
+            first = (MDIdx)i;
+            continue;
+        }
+        unionMDClass(first, (MDIdx)i);
+    }
+}
+
+
+void MDSSAMgr::computeMDClass()
+{
+    START_TIMER(t, "MDSSA: Compute MD Class");
+    m_md2class.clean();
+    m_unbuilt_md.clean();
+    BBList * bbl = m_rg->getBBList();
+    BBListIter bbit;
+    IRIter irit;
+    for (IRBB * bb = bbl->get_head(&bbit);
+         bb != nullptr; bb = bbl->get_next(&bbit)) {
+        BBIRListIter it;
+        for (IR * ir = bb->getIRList().get_head(&it);
+             ir != nullptr; ir = bb->getIRList().get_next(&it)) {
+            irit.clean();
+            for (IR * x = xoc::iterInit(ir, irit);
+                 x != nullptr; x = xoc::iterNext(irit)) {
+                if (!hasMDSSAInfo(x)) { continue; }
+                if (getFirstRefMD(x) == MD_UNDEF) {
+                    //IR that does not reference non-PR memory does not
+                    //belong to any class, e.g:readonly call that returns
+                    //PR. Its MDSSAInfo is always empty.
+                    genMDSSAInfo(x);
+                    continue;
+                }
+                unionMDClassForIR(x);
+            }
+        }
+    }
+    END_TIMER(t, "MDSSA: Compute MD Class");
+}
+
+
+void MDSSAMgr::collectClassMD(xcom::BitSet const& roots,
+                              xcom::BitSet const& cands, OUT DefMDSet & mds)
+{
+    for (BSIdx i = cands.get_first(); i != BS_UNDEF; i = cands.get_next(i)) {
+        if (roots.is_contain(findMDClass((MDIdx)i))) { mds.bunion(i); }
+    }
+}
+
+
+void MDSSAMgr::constructionOnDemand(DefMDSet const& mds, OptCtx & oc)
+{
+    ASSERT0(m_is_on_demand && m_is_valid);
+    START_TIMER(t, "MDSSA: Construction On Demand");
+    bool has_cached_info = m_od_dfm != nullptr;
+    if (!has_cached_info) { initOnDemandCFGInfo(oc); }
+    ASSERT0(m_od_domtree && m_od_dfm);
+    DomTree & domtree = *m_od_domtree;
+    DfMgr & dfm = *m_od_dfm;
+
+    //Restrict the placing of PHI and renaming to the given MDs, the SSA form
+    //of other MDs will not be touched.
+    m_build_filter = &mds;
+    List<IRBB*> wl;
+    DefMiscBitSetMgr bs_mgr;
+    DefMDSet effect_mds(bs_mgr.getSegMgr());
+    BB2DefMDSet defed_mds;
+    placePhi(dfm, effect_mds, bs_mgr, defed_mds, wl);
+    MD2VMDStack md2vmdstk;
+    rename(effect_mds, defed_mds, domtree, md2vmdstk);
+    m_build_filter = nullptr;
+    if (!has_cached_info) { finiOnDemandCFGInfo(); }
+    ASSERT0(verifyPhi());
+    prunePhi(wl, oc);
+
+    DefMDSetIter it = nullptr;
+    for (BSIdx i = mds.get_first(&it); i != BS_UNDEF;
+         i = mds.get_next(i, &it)) {
+        m_built_md.bunion(i);
+        m_unbuilt_md.diff(i);
+    }
+    END_TIMER(t, "MDSSA: Construction On Demand");
+    if (!hasUnbuiltClass()) {
+        ASSERT0(verify());
+        ASSERT0(verifyPhi() && verifyAllVMD() && verifyVersion(oc));
+    }
+}
+
+
+void MDSSAMgr::initOnDemandCFGInfo(OptCtx & oc)
+{
+    if (!m_is_on_demand || m_od_dfm != nullptr) { return; }
+    m_rg->getPassMgr()->checkValidAndRecompute(&oc, PASS_DOM, PASS_UNDEF);
+    m_od_domtree = new DomTree();
+    m_cfg->genDomTree(*m_od_domtree);
+    m_od_dfm = new DfMgr();
+    m_od_dfm->build((xcom::DGraph&)*m_cfg);
+}
+
+
+void MDSSAMgr::finiOnDemandCFGInfo()
+{
+    if (m_od_domtree != nullptr) {
+        delete m_od_domtree;
+        m_od_domtree = nullptr;
+    }
+    if (m_od_dfm != nullptr) {
+        delete m_od_dfm;
+        m_od_dfm = nullptr;
+    }
+}
+
+
+bool MDSSAMgr::buildOnDemandForClassSet(xcom::BitSet const& roots,
+                                        OptCtx & oc)
+{
+    if (!hasUnbuiltClass() || roots.is_empty()) { return false; }
+    DefMiscBitSetMgr bs_mgr;
+    DefMDSet mds(bs_mgr.getSegMgr());
+    collectClassMD(roots, m_unbuilt_md, mds);
+    if (mds.is_empty()) { return false; }
+    constructionOnDemand(mds, oc);
+    return true;
+}
+
+
+void MDSSAMgr::collectUnbuiltClass(IR const* ir, MOD xcom::BitSet & roots)
+{
+    ConstIRIter it;
+    for (IR const* x = xoc::iterInitC(ir, it);
+         x != nullptr; x = xoc::iterNextC(it)) {
+        if (!hasMDSSAInfo(x)) { continue; }
+        MDIdx mdid = getFirstRefMD(x);
+        if (mdid == MD_UNDEF || !m_unbuilt_md.is_contain(mdid)) { continue; }
+        roots.bunion(findMDClass(mdid));
+    }
+}
+
+
+void MDSSAMgr::buildOnDemand(IR const* ir, OptCtx & oc)
+{
+    if (!hasUnbuiltClass()) { return; }
+    xcom::BitSet roots;
+    collectUnbuiltClass(ir, roots);
+    buildOnDemandForClassSet(roots, oc);
+}
+
+
+void MDSSAMgr::buildOnDemand(MDIdx mdid, OptCtx & oc)
+{
+    if (!hasUnbuiltClass() || !m_unbuilt_md.is_contain(mdid)) { return; }
+    xcom::BitSet roots;
+    roots.bunion(findMDClass(mdid));
+    buildOnDemandForClassSet(roots, oc);
+}
+
+
+bool MDSSAMgr::buildOnDemandForBBSet(xcom::BitSet const& bbset, OptCtx & oc)
+{
+    if (!hasUnbuiltClass()) { return false; }
+    xcom::BitSet roots;
+    for (BSIdx i = bbset.get_first(); i != BS_UNDEF; i = bbset.get_next(i)) {
+        IRBB * bb = m_cfg->getBB(i);
+        ASSERT0(bb);
+        BBIRListIter it;
+        for (IR const* ir = bb->getIRList().get_head(&it);
+             ir != nullptr; ir = bb->getIRList().get_next(&it)) {
+            collectUnbuiltClass(ir, roots);
+        }
+    }
+    return buildOnDemandForClassSet(roots, oc);
+}
+
+
+void MDSSAMgr::buildAllOnDemand(OptCtx & oc)
+{
+    if (!hasUnbuiltClass()) { return; }
+    DefMiscBitSetMgr bs_mgr;
+    DefMDSet mds(bs_mgr.getSegMgr());
+    for (BSIdx i = m_unbuilt_md.get_first(); i != BS_UNDEF;
+         i = m_unbuilt_md.get_next(i)) {
+        mds.bunion(i);
+    }
+    constructionOnDemand(mds, oc);
+}
+
+
+void MDSSAMgr::destructOnDemand(DefMDSet const& mds)
+{
+    START_TIMER(t, "MDSSA: Destruction On Demand");
+    BBList * bbl = m_rg->getBBList();
+    for (IRBB * bb = bbl->get_head(); bb != nullptr; bb = bbl->get_next()) {
+        MDPhiList * philist = getPhiList(bb);
+        if (philist != nullptr) {
+            MDPhiListIter prev = nullptr;
+            MDPhiListIter next = nullptr;
+            for (MDPhiListIter it = philist->get_head();
+                 it != philist->end(); it = next) {
+                next = philist->get_next(it);
+                MDPhi * phi = it->val();
+                ASSERT0(phi && phi->is_phi());
+                if (!mds.is_contain(phi->getResult()->mdid())) {
+                    prev = it;
+                    continue;
+                }
+                m_rg->freeIRTreeList(phi->getOpndList());
+                MDPHI_opnd_list(phi) = nullptr;
+                philist->remove(prev, it);
+            }
+        }
+        BBIRListIter irit;
+        for (IR * ir = bb->getIRList().get_head(&irit);
+             ir != nullptr; ir = bb->getIRList().get_next(&irit)) {
+            m_iter.clean();
+            for (IR * x = xoc::iterInit(ir, m_iter);
+                 x != nullptr; x = xoc::iterNext(m_iter)) {
+                if (hasMDSSAInfo(x) && isRefInMDSet(x, mds)) {
+                    cleanMDSSAInfo(x);
+                }
+            }
+        }
+    }
+
+    //Remove all versions of MD, include the initial version because its
+    //UseSet is out of date. Note the max version of MD is kept unchanged.
+    DefMDSetIter it = nullptr;
+    for (BSIdx i = mds.get_first(&it); i != BS_UNDEF;
+         i = mds.get_next(i, &it)) {
+        VMDVec * vec = getUseDefMgr()->getVMDVec((MDIdx)i);
+        if (vec != nullptr) {
+            for (VecIdx v = 0; v <= vec->get_last_idx(); v++) {
+                VMD * vmd = vec->get(v);
+                if (vmd == nullptr) { continue; }
+                MDDef * def = vmd->getDef();
+                if (def != nullptr) {
+                    if (def->getNextSet() != nullptr) {
+                        def->getNextSet()->clean(*getSBSMgr());
+                    }
+                    getUseDefMgr()->removeMDDef(def);
+                }
+                removeVMD(vmd);
+            }
+        }
+        m_built_md.diff(i);
+        m_unbuilt_md.bunion(i);
+    }
+    END_TIMER(t, "MDSSA: Destruction On Demand");
+}
+
+
+void MDSSAMgr::invalidOnDemand(MDIdx mdid)
+{
+    if (!m_is_on_demand || !m_built_md.is_contain(mdid)) { return; }
+    xcom::BitSet roots;
+    roots.bunion(findMDClass(mdid));
+    DefMiscBitSetMgr bs_mgr;
+    DefMDSet mds(bs_mgr.getSegMgr());
+    collectClassMD(roots, m_built_md, mds);
+    destructOnDemand(mds);
+}
+
+
+bool MDSSAMgr::mergeClassOnDemand(IR const* ir1, IR const* ir2)
+{
+    ASSERT0(m_is_on_demand);
+    MDIdx md1 = getFirstRefMD(ir1);
+    MDIdx md2 = getFirstRefMD(ir2);
+    unionMDClassForIR(ir1);
+    unionMDClassForIR(ir2);
+    if (md1 == MD_UNDEF) { md1 = md2; }
+    if (md1 == MD_UNDEF) { return false; }
+    if (md2 != MD_UNDEF) { unionMDClass(md1, md2); }
+    MDIdx root = findMDClass(md1);
+    for (BSIdx i = m_unbuilt_md.get_first(); i != BS_UNDEF;
+         i = m_unbuilt_md.get_next(i)) {
+        if (findMDClass((MDIdx)i) != root) { continue; }
+        //The class is incomplete, drop the built part and leave the whole
+        //class to be built by the next query.
+        invalidOnDemand(md1);
+        return true;
+    }
+    return false;
+}
+
+
+void MDSSAMgr::reclassifyOnDemand()
+{
+    if (!m_is_on_demand || !m_is_valid) { return; }
+    computeMDClass();
+
+    //A built MD that is merged into the class of unbuilt MD has to be
+    //rebuilt together with the class.
+    xcom::BitSet roots;
+    for (BSIdx i = m_unbuilt_md.get_first(); i != BS_UNDEF;
+         i = m_unbuilt_md.get_next(i)) {
+        roots.bunion(findMDClass((MDIdx)i));
+    }
+    DefMiscBitSetMgr bs_mgr;
+    DefMDSet mds(bs_mgr.getSegMgr());
+    collectClassMD(roots, m_built_md, mds);
+    if (mds.is_empty()) { return; }
+    destructOnDemand(mds);
+}
 //END MDSSAMgr
 
 } //namespace xoc
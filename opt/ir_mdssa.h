@@ -714,6 +714,9 @@ class MDSSAMgr : public Pass {
     COPY_CONSTRUCTOR(MDSSAMgr);
 protected:
     BYTE m_is_semi_pruned:1;
+
+    //True if MDSSA of each alias class is built on demand.
+    BYTE m_is_on_demand:1;
     MDSystem * m_md_sys;
     TypeMgr * m_tm;
     IRCFG * m_cfg;
@@ -730,6 +733,24 @@ protected:
 
     UseDefMgr m_usedef_mgr;
     ActMgr * m_am;
+
+    //Record the parent of each MD in the union-find tree, the root MD
+    //represents the alias class. The map is only used in demand-driven mode.
+    xcom::Vector<MDIdx> m_md2class;
+
+    //Record MDs that their SSA form have been built, and MDs that are waiting
+    //for the first query.
+    xcom::BitSet m_built_md;
+    xcom::BitSet m_unbuilt_md;
+
+    //If it is not NULL, construction only handles the MDs in the set.
+    DefMDSet const* m_build_filter;
+
+    //Record the dominator tree and dominance frontier that shared by the
+    //on-demand constructions during a pass. They are NULL if the CFG info
+    //is not cached, see initOnDemandCFGInfo().
+    DomTree * m_od_domtree;
+    DfMgr * m_od_dfm;
 protected:
     //Add an USE to given mdssainfo.
     //use: occurence to be added.
@@ -745,6 +766,10 @@ protected:
     {
         m_is_valid = false;
         m_is_semi_pruned = true;
+        m_is_on_demand = false;
+        m_build_filter = nullptr;
+        m_od_domtree = nullptr;
+        m_od_dfm = nullptr;
     }
     void cleanIRSSAInfo(IRBB * bb);
     void cleanMDSSAInfoAI();
@@ -753,6 +778,10 @@ protected:
     //The function destroy data structures that allocated during SSA
     //construction, and these data structures are only useful in construction.
     void cleanLocalUsedData();
+    //Collect MDs in 'cands' that belong to the classes in 'roots'.
+    void collectClassMD(xcom::BitSet const& roots, xcom::BitSet const& cands,
+                        OUT DefMDSet & mds);
+
     void collectDefinedMD(IRBB const* bb, OUT DefMDSet & maydef) const;
     void collectDefinedMDAndInitVMD(IN IRBB * bb, OUT DefMDSet & maydef);
     void collectUseMD(IR const* ir, OUT LiveInMDTab & livein_md);
@@ -767,6 +796,11 @@ protected:
     //of current BB's predessor.
     void destruction(DomTree & domtree);
     void destructBBSSAInfo(IRBB * bb);
+
+    //The function drops the SSA form of MDs in 'mds', these MDs will be
+    //rebuilt when client queries them again.
+    //Note 'mds' must be composed of complete alias classes.
+    void destructOnDemand(DefMDSet const& mds);
     void destructionInDomTreeOrder(IRBB * root, DomTree & domtree);
     //The function dump all possible DEF of 'vopnd' by walking through the
     //Def Chain.
@@ -823,6 +857,17 @@ protected:
     }
     void initVMD(IN IR * ir, OUT DefMDSet & maydef);
 
+    //Return true if the construction should handle 'ir' or 'mdid'.
+    bool isInBuildFilter(IR const* ir) const
+    { return m_build_filter == nullptr || isRefInMDSet(ir, *m_build_filter); }
+    bool isInBuildFilter(MDIdx mdid) const
+    { return m_build_filter == nullptr || m_build_filter->is_contain(mdid); }
+
+    //Return true if MDs that 'ir' referenced are in 'mds'.
+    //Note the alias class guarantees that all referenced MDs of an IR belong
+    //to one class, thus checking any of them is enough.
+    bool isRefInMDSet(IR const* ir, DefMDSet const& mds) const;
+
     //Insert a new PHI into bb according to given MDIdx.
     //Note the operand of PHI will be initialized in initial-version.
     MDPhi * insertPhi(UINT mdid, IN IRBB * bb)
@@ -922,6 +967,16 @@ protected:
 
     //Union successors in NextSet from 'from' to 'to'.
     void unionSuccessors(MDDef const* from, MDDef const* to);
+    //Return the root MD that represents the alias class of 'mdid'.
+    MDIdx findMDClass(MDIdx mdid);
+    void unionMDClass(MDIdx md1, MDIdx md2);
+    void unionMDClassForIR(IR const* ir);
+
+    //Merge the alias classes of 'ir1' and 'ir2' in demand-driven mode, and
+    //drop the SSA form of the merged class if part of it has not been built.
+    //Return true if the merged class is not built, thus the DU chain of
+    //'ir1' and 'ir2' need not to be maintained.
+    bool mergeClassOnDemand(IR const* ir1, IR const* ir2);
 
     bool verifyDUChainAndOccForPhi(MDPhi const* phi) const;
     bool verifyPhiOpndList(MDPhi const* phi, UINT prednum) const;
@@ -970,6 +1025,51 @@ public:
 
     //Construction of MDSSA form.
     bool construction(DomTree & domtree, OptCtx & oc);
+
+    //Build the SSA form for MDs in 'mds', and the VMDs, MDPhis and MDSSAInfos
+    //of other MDs will be kept unchanged.
+    //Note 'mds' must be composed of complete alias classes.
+    void constructionOnDemand(DefMDSet const& mds, OptCtx & oc);
+
+    //Build the SSA form of the alias classes that IR tree 'ir' referenced.
+    //Client in demand-driven mode should invoke the function before
+    //querying the MDSSAInfo of IR.
+    void buildOnDemand(IR const* ir, OptCtx & oc);
+
+    //Build the SSA form of the alias class of 'mdid'.
+    void buildOnDemand(MDIdx mdid, OptCtx & oc);
+
+    //Build the SSA form of the alias classes that IRs in BBs of 'bbset'
+    //referenced, e.g:the classes of loop body.
+    //Return true if there is class built.
+    bool buildOnDemandForBBSet(xcom::BitSet const& bbset, OptCtx & oc);
+
+    //Build the SSA form of all alias classes that are not built.
+    void buildAllOnDemand(OptCtx & oc);
+
+    //Build the SSA form of the alias classes in 'roots' by one construction.
+    //Client should collect the classes it needed via collectUnbuiltClass()
+    //to avoid building classes one by one.
+    //Return true if there is class built.
+    bool buildOnDemandForClassSet(xcom::BitSet const& roots, OptCtx & oc);
+
+    //Collect the root of unbuilt alias classes that IR tree 'ir' referenced.
+    void collectUnbuiltClass(IR const* ir, MOD xcom::BitSet & roots);
+
+    //Compute and cache the dominator tree and dominance frontier, all
+    //on-demand constructions before finiOnDemandCFGInfo() will share them.
+    //The function does nothing if MDSSA is not in demand-driven mode.
+    //Client should call the function at the beginning of pass, and must not
+    //change CFG until finiOnDemandCFGInfo() is invoked.
+    void initOnDemandCFGInfo(OptCtx & oc);
+
+    //Drop the cached CFG info.
+    void finiOnDemandCFGInfo();
+
+    //Compute the alias classes of MDs. An alias class is a set of MDs that
+    //referenced by an IR at the same time, thus the MDSSA of a class can be
+    //built independently.
+    void computeMDClass();
     size_t count_mem() const;
 
     //DU chain operation.
@@ -1225,6 +1325,9 @@ public:
     virtual CHAR const* getPassName() const { return "MDSSA Manager"; }
     PASS_TYPE getPassType() const { return PASS_MDSSA_MGR; }
 
+    //The pass itself builds MDSSA.
+    virtual bool isMDSSAOnDemandClient() const { return true; }
+
     //Get the BB for given expression.
     static IRBB * getExpBB(IR const* ir)
     { return ir->is_id() ? ID_phi(ir)->getBB() : ir->getStmt()->getBB(); }
@@ -1312,6 +1415,10 @@ public:
     //ir: must be exp.
     bool hasDef(IR const* ir) const;
 
+    //Return true if there are alias classes that have not been built.
+    bool hasUnbuiltClass() const
+    { return m_is_on_demand && !m_unbuilt_md.is_empty(); }
+
     //Return true if bb has PHI.
     bool hasPhi(UINT bbid) const
     {
@@ -1390,6 +1497,30 @@ public:
     //     the function will return false because #S1 may define MD2.
     bool isRegionLiveIn(IR const* ir) const;
 
+    //Return true if the SSA form of 'mdid' is available.
+    bool isBuiltOnDemand(MDIdx mdid) const
+    { return !m_is_on_demand || !m_unbuilt_md.is_contain(mdid); }
+
+    //Return true if MDSSA is valid, whereas some alias classes may have not
+    //been built. Client that uses buildOnDemand() should check validity via
+    //the function to make the intention explicit.
+    //Note PassMgr::performPass() builds the unbuilt classes before running
+    //the pass that is not demand-driven client, see
+    //Pass::isMDSSAOnDemandClient().
+    bool isValidOnDemand() const { return is_valid(); }
+
+    //Invalidation hook of demand-driven mode.
+    //The function drops the SSA form of the alias class of 'mdid', the class
+    //will be rebuilt by the next query. Client should call it if the MD
+    //reference of IR in the class changed.
+    void invalidOnDemand(MDIdx mdid);
+
+    //Invalidation hook of demand-driven mode.
+    //The function recomputes alias classes, and drops the SSA form of the
+    //built MDs that merged with unbuilt MDs. Client should call it if the
+    //MD reference of IRs in region changed, e.g:after alias analysis.
+    void reclassifyOnDemand();
+
     //Move PHI from 'from' to 'to'.
     //The function often used in updating PHI when adding new dominater
     //BB to 'to'.
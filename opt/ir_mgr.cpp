@@ -148,11 +148,22 @@ IRMgr::IRMgr(Region * rg) : Pass(rg)
     m_rm = rg->getRegionMgr();
     m_vm = rg->getVarMgr();
     m_init_placeholder_var = nullptr;
+    #ifdef COMPACT_IR_LAYOUT
+    m_arena_chunk = nullptr;
+    #endif
 }
 
 
 IRMgr::~IRMgr()
 {
+    #ifdef COMPACT_IR_LAYOUT
+    for (IRArenaChunk * c = m_arena_chunk; c != nullptr;) {
+        IRArenaChunk * next = IRAC_next(c);
+        IRArena::freeChunk(c);
+        c = next;
+    }
+    m_arena_chunk = nullptr;
+    #endif
     xcom::smpoolDelete(m_ir_pool);
     m_ir_pool = nullptr;
 }
@@ -319,8 +330,21 @@ bool IRMgr::isIRIsomorphic(IR const* ir, IR const* src,
 
 IR * IRMgr::xmalloc(UINT size)
 {
+    #ifdef COMPACT_IR_LAYOUT
+    UINT sz = (UINT)xcom::ceil_align(size, 1 << IR_ARENA_GRANULE_BIT);
+    ASSERT0(sz < IR_ARENA_CHUNK_SIZE - sizeof(IRArenaChunk));
+    if (m_arena_chunk == nullptr ||
+        IRAC_used(m_arena_chunk) + sz > IR_ARENA_CHUNK_SIZE) {
+        IRArenaChunk * c = IRArena::allocChunk(this);
+        IRAC_next(c) = m_arena_chunk;
+        m_arena_chunk = c;
+    }
+    IR * p = (IR*)(((BYTE*)m_arena_chunk) + IRAC_used(m_arena_chunk));
+    IRAC_used(m_arena_chunk) += sz;
+    #else
     ASSERTN(m_ir_pool, ("pool does not initialized"));
     IR * p = (IR*)xcom::smpoolMalloc(size, m_ir_pool);
+    #endif
     ASSERT0(p != nullptr);
     ::memset((void*)p, 0, size);
     return p;
@@ -334,6 +358,13 @@ size_t IRMgr::count_mem() const
     size_t count = sizeof(IRMgr);
     ASSERT0(m_ir_pool);
     count += xcom::smpoolGetPoolSize(m_ir_pool);
+    #ifdef COMPACT_IR_LAYOUT
+    for (IRArenaChunk const* c = m_arena_chunk; c != nullptr;
+         c = IRAC_next(c)) {
+        count += IRAC_used(c);
+    }
+    count += m_ai_tab.count_mem();
+    #endif
     return count;
 }
 
@@ -422,6 +453,11 @@ void IRMgr::freeIR(IR * ir)
     m_has_been_freed_irs.bunion(ir->id());
     #endif
 
+    #ifdef COMPACT_IR_LAYOUT
+    //Attach-info container is not placed in IR.
+    IR_ai(ir) = nullptr;
+    #endif
+
     //Zero clearing all data fields, except the IRID and CodeSize.
     UINT res_id = ir->id();
     UINT res_irc_sz = IR::getIRCodeSize(ir);
@@ -464,6 +500,9 @@ IR * IRMgr::allocIR(IR_CODE irc, bool lookup)
         IR_id(ir) = m_ir_count;
         m_ir_count++;
         getIRVec().set(ir->id(), ir);
+        #ifdef COMPACT_IR_LAYOUT
+        m_ai_tab.set(ir->id(), nullptr);
+        #endif
         IR::setIRCodeSize(ir, IRCSIZE(irc));
     } else {
         ASSERT0(ir->get_prev() == nullptr);
@@ -58,6 +58,15 @@ protected:
     Vector<IR*> m_ir_vec; //record IR which have allocated. ir id is dense
     IR * m_free_tab[MAX_OFFSET_AT_FREE_TABLE + 1];
     Var * m_init_placeholder_var;
+    #ifdef COMPACT_IR_LAYOUT
+    //Record the arena chunks that IR allocated in. The head of the list is
+    //the chunk in use.
+    IRArenaChunk * m_arena_chunk;
+
+    //The side table records attach-info container of IR, the table
+    //is indexed by IR id.
+    Vector<AIContainer*> m_ai_tab;
+    #endif
     #ifdef _DEBUG_
     xcom::BitSet m_has_been_freed_irs;
     #endif
@@ -75,6 +84,12 @@ public:
     IR * allocIR(IR_CODE irc);
     IR * allocIR(IR_CODE irc, bool lookup);
 
+    #ifdef COMPACT_IR_LAYOUT
+    //Return the address of the attach-info container of IR with given id.
+    AIContainer ** getAIAddr(UINT id) const
+    { return m_ai_tab.get_elem_addr((VecIdx)id); }
+    #endif
+
     //Build alloca ir.
     //Allocate stack space based on the size.
     IR * buildAlloca(IR * size);
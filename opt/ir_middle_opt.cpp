@@ -89,7 +89,8 @@ void Region::postSimplify(MOD SimpCtx & simp, MOD OptCtx & oc)
     bool need_rebuild_prssa = false;
     MDSSAMgr * mdssamgr = (MDSSAMgr*)getPassMgr()->queryPass(
         PASS_MDSSA_MGR);
-    if (mdssamgr != nullptr && mdssamgr->is_valid()) {
+    if (mdssamgr != nullptr && mdssamgr->isValidOnDemand()) {
+        //No need to build unbuilt alias classes before destruction.
         need_rebuild_mdssa = true;
         mdssamgr->destruction(oc);
     }
@@ -128,7 +129,7 @@ void Region::postSimplify(MOD SimpCtx & simp, MOD OptCtx & oc)
         SIMP_need_rebuild_pr_du_chain(&simp) = false;
     }
     if (g_invert_branch_target) {
-        getPassMgr()->registerPass(PASS_INVERT_BRTGT)->perform(oc);
+        getPassMgr()->performPass(PASS_INVERT_BRTGT, oc);
     }
     getCFG()->performMiscOpt(oc);
 }
@@ -146,6 +147,12 @@ bool Region::performSimplifyImpl(MOD SimpCtx & simp, OptCtx & oc)
         //O0 does not build DU ref.
         ASSERT0(getDUMgr() && getDUMgr()->verifyMDRef());
     }
+    MDSSAMgr * mdssamgr = getMDSSAMgr();
+    if (mdssamgr != nullptr && mdssamgr->hasUnbuiltClass()) {
+        //IRSimp maintains MDSSA while transforming IR, thus the whole MDSSA
+        //has to be built before any IR is changed.
+        mdssamgr->buildAllOnDemand(oc);
+    }
     getIRSimp()->simplifyBBlist(getBBList(), &simp);
     postSimplify(simp, oc);
     if (simp.needRebuildDUChain()) {
@@ -262,7 +269,7 @@ bool Region::doMDSSA(OptCtx & oc)
     MDSSAMgr * mdssamgr = (MDSSAMgr*)rg->getPassMgr()->registerPass(
         PASS_MDSSA_MGR);
     ASSERT0(mdssamgr);
-    if (!mdssamgr->is_valid()) {
+    if (!mdssamgr->isValidOnDemand()) {
         mdssamgr->construction(oc);
         oc.setInvalidIfMDSSAReconstructed();
     }
@@ -287,9 +294,9 @@ bool Region::doRefineDU(OptCtx & oc)
     if (g_compute_pr_du_chain && g_compute_nonpr_du_chain) {
         refinedu->setUseGvn(true);
         GVN * gvn = (GVN*)rg->getPassMgr()->registerPass(PASS_GVN);
-        gvn->perform(oc);
+        rg->getPassMgr()->performPass(gvn, oc);
     }
-    return refinedu->perform(oc);
+    return rg->getPassMgr()->performPass(refinedu, oc);
 }
 
 
@@ -334,6 +341,7 @@ bool Region::doDURefAndClassicDU(OptCtx & oc)
         //Compute REACH_DEF for NonPR.
         f.set(DUOPT_SOL_REACH_DEF | DUOPT_COMPUTE_NONPR_DU);
     }
+    ProfScope prof(dumgr->getPassName(), PROF_PASS, rg);
     bool changed = dumgr->perform(oc, f);
     ASSERT0(oc.is_ref_valid());
     ASSERT0(changed);
@@ -405,9 +413,9 @@ bool Region::MiddleProcess(OptCtx & oc)
         performSimplifyArrayIngredient(oc);
     }
     if (g_opt_level > OPT_LEVEL0) {
-        getPassMgr()->registerPass(PASS_SCALAR_OPT)->perform(oc);
+        getPassMgr()->performPass(PASS_SCALAR_OPT, oc);
         if (g_invert_branch_target) {
-            getPassMgr()->registerPass(PASS_INVERT_BRTGT)->perform(oc);
+            getPassMgr()->performPass(PASS_INVERT_BRTGT, oc);
         }
     }
 dump(false);//hack
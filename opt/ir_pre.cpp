@@ -0,0 +1,678 @@
+/*@
+XOC Release License
+
+Copyright (c) 2013-2014, Alibaba Group, All rights reserved.
+
+    compiler@aliexpress.com
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Su Zhenyu nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+author: Su Zhenyu
+@*/
+#include "cominc.h"
+#include "comopt.h"
+
+namespace xoc {
+
+//
+//START PRE
+//
+PRE::PRE(Region * rg) : Pass(rg), m_am(rg)
+{
+    ASSERT0(rg);
+    m_cfg = rg->getCFG();
+    m_prssamgr = nullptr;
+    m_expr_tab = nullptr;
+    m_oc = nullptr;
+    m_inserted_num = 0;
+    m_deleted_num = 0;
+    m_pool = smpoolCreate(sizeof(xcom::SC<UINT>) * 16, MEM_COMM);
+}
+
+
+void PRE::destroy()
+{
+    //The containers are allocated in m_pool, and will be discarded by
+    //the end of perform().
+    m_prno2idx.clean();
+}
+
+
+void PRE::reset()
+{
+    destroy();
+    m_bs_mgr.destroy();
+    m_bs_mgr.init();
+    m_ue.clean();
+    m_de.clean();
+    m_kill.clean();
+    m_avail_out.clean();
+    m_ant_in.clean();
+    m_ant_out.clean();
+    m_later_in.clean();
+    m_universe.clean();
+    m_transformed.clean();
+    m_idx2exp.clean();
+    m_exp2idx.clean();
+    m_idx2occ.clean();
+    m_idx2tmp.clean();
+    m_tmp_irs.clean();
+    m_inserted.clean();
+    m_am.clean();
+    m_inserted_num = 0;
+    m_deleted_num = 0;
+}
+
+
+xcom::BitSet * PRE::genSet(Vector<xcom::BitSet*> & vec, UINT bbid)
+{
+    xcom::BitSet * bs = vec.get(bbid);
+    if (bs == nullptr) {
+        bs = m_bs_mgr.create();
+        vec.set(bbid, bs);
+    }
+    return bs;
+}
+
+
+bool PRE::isCand(IR const* ir) const
+{
+    switch (ir->getCode()) {
+    SWITCH_CASE_BIN:
+    SWITCH_CASE_LOGIC_UNA:
+    SWITCH_CASE_BITWISE_UNA:
+    case IR_NEG:
+    case IR_CVT:
+        break;
+    default: return false;
+    }
+    if (ir->is_any() || ir->isMayThrow(true) || ir->hasSideEffect(true) ||
+        ir->isNoMove(true)) {
+        return false;
+    }
+    bool has_pr = false;
+    for (UINT i = 0; i < ir->getKidNum(); i++) {
+        IR const* kid = ir->getKid(i);
+        if (kid == nullptr) { continue; }
+        if (kid->get_next() != nullptr) { return false; }
+        if (kid->is_pr()) {
+            has_pr = true;
+            continue;
+        }
+        if (!kid->is_const()) { return false; }
+    }
+    return has_pr;
+}
+
+
+IR * PRE::getCand(IR const* stmt) const
+{
+    if (!stmt->is_stpr() && !stmt->is_st()) { return nullptr; }
+    IR * rhs = stmt->getRHS();
+    if (rhs == nullptr || !isCand(rhs)) { return nullptr; }
+    return rhs;
+}
+
+
+UINT PRE::getCandIdx(IR const* ir) const
+{
+    ExprRep const* rep = m_expr_tab->mapIR2ExprRep(ir);
+    if (rep == nullptr) { return 0; }
+    return m_exp2idx.get(rep->id);
+}
+
+
+xcom::SC<UINT> const* PRE::getKilledCand(IR * stmt) const
+{
+    IR const* res = stmt->getResultPR();
+    if (res == nullptr) { return nullptr; }
+    return m_prno2idx.get(res->getPrno());
+}
+
+
+void PRE::collectCand()
+{
+    BBList * bbl = m_rg->getBBList();
+    BBListIter bbit;
+    for (IRBB * bb = bbl->get_head(&bbit);
+         bb != nullptr; bb = bbl->get_next(&bbit)) {
+        BBIRList & irlst = bb->getIRList();
+        BBIRListIter irit;
+        for (IR * ir = irlst.get_head(&irit);
+             ir != nullptr; ir = irlst.get_next(&irit)) {
+            IR * occ = getCand(ir);
+            if (occ == nullptr) { continue; }
+            ExprRep * rep = m_expr_tab->mapIR2ExprRep(occ);
+            if (rep == nullptr || m_exp2idx.get(rep->id) != 0) { continue; }
+            UINT idx = m_idx2exp.get_elem_count();
+            m_idx2exp.set(idx, rep);
+            m_idx2occ.set(idx, occ);
+            m_exp2idx.set(rep->id, idx + 1);
+            m_universe.bunion(idx);
+            for (UINT i = 0; i < occ->getKidNum(); i++) {
+                IR const* kid = occ->getKid(i);
+                if (kid == nullptr || !kid->is_pr()) { continue; }
+                xcom::SC<UINT> * head = m_prno2idx.get(kid->getPrno());
+                if (head != nullptr && head->val() == idx) { continue; }
+                xcom::SC<UINT> * sc = (xcom::SC<UINT>*)xmalloc(
+                    sizeof(xcom::SC<UINT>));
+                sc->value = idx;
+                sc->next = head;
+                m_prno2idx.set(kid->getPrno(), sc);
+            }
+        }
+    }
+}
+
+
+void PRE::computeLocalForBB(IRBB const* bb)
+{
+    xcom::BitSet * ue = genSet(m_ue, bb->id());
+    xcom::BitSet * de = genSet(m_de, bb->id());
+    xcom::BitSet * kill = genSet(m_kill, bb->id());
+    BBIRList & irlst = const_cast<IRBB*>(bb)->getIRList();
+    BBIRListIter irit;
+    for (IR * ir = irlst.get_head(&irit);
+         ir != nullptr; ir = irlst.get_next(&irit)) {
+        IR const* occ = getCand(ir);
+        if (occ != nullptr) {
+            UINT idx = getCandIdx(occ);
+            ASSERT0(idx != 0);
+            idx--;
+            if (!kill->is_contain(idx)) { ue->bunion(idx); }
+            de->bunion(idx);
+        }
+        for (xcom::SC<UINT> const* k = getKilledCand(ir);
+             k != nullptr; k = k->get_next()) {
+            kill->bunion(k->value);
+            de->diff(k->value);
+        }
+    }
+}
+
+
+void PRE::computeLocal()
+{
+    BBList * bbl = m_rg->getBBList();
+    BBListIter bbit;
+    for (IRBB const* bb = bbl->get_head(&bbit);
+         bb != nullptr; bb = bbl->get_next(&bbit)) {
+        computeLocalForBB(bb);
+    }
+}
+
+
+bool PRE::isEHEdge(IRBB const* from, IRBB const* to) const
+{
+    xcom::Edge const* e = m_cfg->getEdge(from->id(), to->id());
+    ASSERT0(e);
+    return EDGE_info(e) != nullptr &&
+           CFGEI_is_eh((CFGEdgeInfo const*)EDGE_info(e));
+}
+
+
+void PRE::computeAvail(RPOVexList const& vlst)
+{
+    RPOVexListIter it;
+    for (Vertex const* v = vlst.get_head(&it);
+         v != nullptr; v = vlst.get_next(&it)) {
+        genSet(m_avail_out, v->id())->copy(m_universe);
+    }
+    xcom::BitSet in;
+    bool change = true;
+    while (change) {
+        change = false;
+        for (Vertex const* v = vlst.get_head(&it);
+             v != nullptr; v = vlst.get_next(&it)) {
+            in.clean();
+            IRBB const* to = m_cfg->getBB(v->id());
+            xcom::EdgeC const* ec = v->getInList();
+            if (ec != nullptr) {
+                in.copy(*getSet(m_avail_out, ec->getFromId()));
+                for (; ec != nullptr; ec = ec->get_next()) {
+                    if (isEHEdge(m_cfg->getBB(ec->getFromId()), to)) {
+                        //Exception may be raised before any computation
+                        //of predecessor.
+                        in.clean();
+                        break;
+                    }
+                    in.intersect(*getSet(m_avail_out, ec->getFromId()));
+                }
+            }
+            //AvailOut = DE | (AvailIn - Kill)
+            in.diff(*getSet(m_kill, v->id()));
+            in.bunion(*getSet(m_de, v->id()));
+            xcom::BitSet * out = getSet(m_avail_out, v->id());
+            if (!out->is_equal(in)) {
+                out->copy(in);
+                change = true;
+            }
+        }
+    }
+}
+
+
+void PRE::computeAnt(RPOVexList const& vlst)
+{
+    RPOVexListIter it;
+    for (Vertex const* v = vlst.get_head(&it);
+         v != nullptr; v = vlst.get_next(&it)) {
+        genSet(m_ant_in, v->id())->copy(m_universe);
+        genSet(m_ant_out, v->id());
+    }
+    xcom::BitSet in;
+    bool change = true;
+    while (change) {
+        change = false;
+        for (Vertex const* v = vlst.get_tail(&it);
+             v != nullptr; v = vlst.get_prev(&it)) {
+            xcom::BitSet * out = getSet(m_ant_out, v->id());
+            out->clean();
+            xcom::EdgeC const* ec = v->getOutList();
+            if (ec != nullptr) {
+                out->copy(*getSet(m_ant_in, ec->getToId()));
+                for (ec = ec->get_next(); ec != nullptr; ec = ec->get_next()) {
+                    out->intersect(*getSet(m_ant_in, ec->getToId()));
+                }
+            }
+            //AntIn = UE | (AntOut - Kill)
+            in.copy(*out);
+            in.diff(*getSet(m_kill, v->id()));
+            in.bunion(*getSet(m_ue, v->id()));
+            xcom::BitSet * antin = getSet(m_ant_in, v->id());
+            if (!antin->is_equal(in)) {
+                antin->copy(in);
+                change = true;
+            }
+        }
+    }
+}
+
+
+//Earliest(i,j) = AntIn(j) & ~AvailOut(i) & (Kill(i) | ~AntOut(i)).
+//If 'from' does not have predecessor, the last term is omitted.
+//Nothing is available along exception-handling edge, thus the
+//Earliest of the edge is AntIn(j).
+void PRE::computeEarliest(IRBB const* from, IRBB const* to,
+                          OUT xcom::BitSet & earliest)
+{
+    earliest.copy(*getSet(m_ant_in, to->id()));
+    if (isEHEdge(from, to)) { return; }
+    earliest.diff(*getSet(m_avail_out, from->id()));
+    if (from->getVex()->getInList() == nullptr) { return; }
+    xcom::BitSet tmp(m_universe);
+    tmp.diff(*getSet(m_ant_out, from->id()));
+    tmp.bunion(*getSet(m_kill, from->id()));
+    earliest.intersect(tmp);
+}
+
+
+//Later(i,j) = Earliest(i,j) | (LaterIn(i) & ~UE(i)).
+void PRE::computeLaterOnEdge(IRBB const* from, IRBB const* to,
+                             OUT xcom::BitSet & later)
+{
+    computeEarliest(from, to, later);
+    xcom::BitSet tmp(*getSet(m_later_in, from->id()));
+    tmp.diff(*getSet(m_ue, from->id()));
+    later.bunion(tmp);
+}
+
+
+void PRE::computeLater(RPOVexList const& vlst)
+{
+    RPOVexListIter it;
+    for (Vertex const* v = vlst.get_head(&it);
+         v != nullptr; v = vlst.get_next(&it)) {
+        xcom::BitSet * laterin = genSet(m_later_in, v->id());
+        if (v->getInList() != nullptr) {
+            laterin->copy(m_universe);
+        }
+    }
+    xcom::BitSet in;
+    xcom::BitSet later;
+    bool change = true;
+    while (change) {
+        change = false;
+        for (Vertex const* v = vlst.get_head(&it);
+             v != nullptr; v = vlst.get_next(&it)) {
+            xcom::EdgeC const* ec = v->getInList();
+            if (ec == nullptr) { continue; }
+            IRBB const* to = m_cfg->getBB(v->id());
+            //LaterIn(j) = Intersect of Later(i,j) for all predecessors i.
+            computeLaterOnEdge(m_cfg->getBB(ec->getFromId()), to, in);
+            for (ec = ec->get_next(); ec != nullptr; ec = ec->get_next()) {
+                computeLaterOnEdge(m_cfg->getBB(ec->getFromId()), to, later);
+                in.intersect(later);
+            }
+            xcom::BitSet * laterin = getSet(m_later_in, v->id());
+            if (!laterin->is_equal(in)) {
+                laterin->copy(in);
+                change = true;
+            }
+        }
+    }
+}
+
+
+//Insert(i,j) = Later(i,j) & ~LaterIn(j).
+void PRE::computeInsert(IRBB const* from, IRBB const* to,
+                        OUT xcom::BitSet & insert)
+{
+    computeLaterOnEdge(from, to, insert);
+    insert.diff(*getSet(m_later_in, to->id()));
+}
+
+
+//Delete(k) = UE(k) & ~LaterIn(k), where k is not entry.
+void PRE::computeDelete(IRBB const* bb, OUT xcom::BitSet & del)
+{
+    del.clean();
+    if (bb->getVex()->getInList() == nullptr) { return; }
+    del.copy(*getSet(m_ue, bb->id()));
+    del.diff(*getSet(m_later_in, bb->id()));
+}
+
+
+//Return true if the computation of candidate 'idx' can be appended at the
+//tail of 'bb'.
+bool PRE::canInsertAtTail(IRBB * bb, UINT idx) const
+{
+    if (bb->getVex()->getOutDegree() != 1) {
+        //Critical edge.
+        return false;
+    }
+    IR * last = bb->getLastIR();
+    if (last == nullptr || !IRBB::isLowerBoundary(last)) { return true; }
+    //The computation will be placed before the boundary stmt, thus the stmt
+    //should not define any operand of candidate.
+    for (xcom::SC<UINT> const* k = getKilledCand(last);
+         k != nullptr; k = k->get_next()) {
+        if (k->value == idx) { return false; }
+    }
+    return true;
+}
+
+
+void PRE::pickTransformed()
+{
+    xcom::BitSet blocked;
+    xcom::BitSet set;
+    BBList * bbl = m_rg->getBBList();
+    BBListIter bbit;
+    for (IRBB * bb = bbl->get_head(&bbit);
+         bb != nullptr; bb = bbl->get_next(&bbit)) {
+        for (xcom::EdgeC const* ec = bb->getVex()->getInList();
+             ec != nullptr; ec = ec->get_next()) {
+            IRBB * from = m_cfg->getBB(ec->getFromId());
+            computeInsert(from, bb, set);
+            if (isEHEdge(from, bb)) {
+                //Refuse to insert computation on exception-handling edge.
+                blocked.bunion(set);
+                continue;
+            }
+            for (BSIdx i = set.get_first(); i != BS_UNDEF;
+                 i = set.get_next(i)) {
+                if (canInsertAtTail(from, (UINT)i)) {
+                    m_transformed.bunion(i);
+                } else {
+                    blocked.bunion(i);
+                }
+            }
+        }
+        computeDelete(bb, set);
+        m_transformed.bunion(set);
+    }
+    m_transformed.diff(blocked);
+}
+
+
+PRNO PRE::genTmpPR(UINT idx, Type const* ty)
+{
+    PRNO prno = m_idx2tmp.get(idx);
+    if (prno != PRNO_UNDEF) { return prno; }
+    prno = m_rg->getIRMgr()->buildPrno(ty);
+    m_idx2tmp.set(idx, prno);
+    return prno;
+}
+
+
+void PRE::dumpAct(UINT idx, CHAR const* act, IRBB const* bb)
+{
+    if (!getRegion()->isLogMgrInit() || !g_dump_opt.isDumpPRE()) { return; }
+    m_am.dump("%s computation of %s into $%u in BB%u", act,
+              DumpIRName().dump(m_idx2occ.get(idx)), m_idx2tmp.get(idx),
+              bb->id());
+}
+
+
+void PRE::insertAtEdge(IRBB * from, xcom::BitSet const& insert)
+{
+    for (BSIdx i = insert.get_first(); i != BS_UNDEF;
+         i = insert.get_next(i)) {
+        if (!m_transformed.is_contain(i)) { continue; }
+        IR const* occ = m_idx2occ.get(i);
+        ASSERT0(occ);
+        PRNO prno = genTmpPR((UINT)i, occ->getType());
+        IR * exp = m_rg->dupIRTree(occ);
+        exp->copyRefForTree(occ, m_rg);
+        xoc::addUseForTree(exp, occ, m_rg);
+        IR * stpr = m_rg->getIRMgr()->buildStorePR(prno, occ->getType(), exp);
+        m_rg->getMDMgr()->allocMDForPROp(stpr);
+        copyDbx(stpr, occ->getStmt(), m_rg);
+        from->getIRList().append_tail_ex(stpr);
+        m_inserted.append(stpr);
+        addOccForRename(stpr);
+        m_inserted_num++;
+        dumpAct((UINT)i, "insert", from);
+    }
+}
+
+
+void PRE::replaceOcc(UINT idx, IR * occ, IR * stmt)
+{
+    PRNO prno = m_idx2tmp.get(idx);
+    ASSERT0(prno != PRNO_UNDEF);
+    IR * pr = m_rg->getIRMgr()->buildPRdedicated(prno, occ->getType());
+    m_rg->getMDMgr()->allocMDForPROp(pr);
+    bool f = stmt->replaceKid(occ, pr, true);
+    ASSERT0_DUMMYUSE(f);
+    addOccForRename(pr);
+    dumpAct(idx, "delete", stmt->getBB());
+    xoc::removeUseForTree(occ, m_rg, *m_oc);
+    m_rg->freeIRTree(occ);
+    m_deleted_num++;
+}
+
+
+void PRE::splitOcc(UINT idx, IR * occ, IR * stmt, IRBB * bb)
+{
+    PRNO prno = genTmpPR(idx, occ->getType());
+    IR * pr = m_rg->getIRMgr()->buildPRdedicated(prno, occ->getType());
+    m_rg->getMDMgr()->allocMDForPROp(pr);
+    bool f = stmt->replaceKid(occ, pr, false);
+    ASSERT0_DUMMYUSE(f);
+    IR * stpr = m_rg->getIRMgr()->buildStorePR(prno, occ->getType(), occ);
+    m_rg->getMDMgr()->allocMDForPROp(stpr);
+    copyDbx(stpr, stmt, m_rg);
+    IRListIter holder = nullptr;
+    f = bb->getIRList().find(stmt, &holder);
+    ASSERT0(f && holder);
+    bb->getIRList().insert_before(stpr, holder);
+    stpr->setBB(bb);
+    addOccForRename(stpr);
+    addOccForRename(pr);
+}
+
+
+void PRE::transformBB(IRBB * bb)
+{
+    xcom::BitSet del;
+    computeDelete(bb, del);
+    //Record the candidates that hold by temporary PR.
+    xcom::BitSet valid;
+    //Record the candidates that have been computed or killed in BB.
+    xcom::BitSet not_ue;
+    BBIRList & irlst = bb->getIRList();
+    BBIRListIter irit;
+    for (IR * ir = irlst.get_head(&irit);
+         ir != nullptr; ir = irlst.get_next(&irit)) {
+        if (m_inserted.find(ir)) { continue; }
+        IR * occ = getCand(ir);
+        UINT idx = occ != nullptr ? getCandIdx(occ) : 0;
+        if (idx != 0 && m_transformed.is_contain(--idx)) {
+            if (valid.is_contain(idx) ||
+                (!not_ue.is_contain(idx) && del.is_contain(idx))) {
+                replaceOcc(idx, occ, ir);
+            } else {
+                splitOcc(idx, occ, ir, bb);
+            }
+            valid.bunion(idx);
+            not_ue.bunion(idx);
+        }
+        for (xcom::SC<UINT> const* k = getKilledCand(ir);
+             k != nullptr; k = k->get_next()) {
+            valid.diff(k->value);
+            not_ue.bunion(k->value);
+        }
+    }
+}
+
+
+void PRE::transform()
+{
+    BBList * bbl = m_rg->getBBList();
+    BBListIter bbit;
+    xcom::BitSet insert;
+    for (IRBB * bb = bbl->get_head(&bbit);
+         bb != nullptr; bb = bbl->get_next(&bbit)) {
+        for (xcom::EdgeC const* ec = bb->getVex()->getInList();
+             ec != nullptr; ec = ec->get_next()) {
+            IRBB * from = m_cfg->getBB(ec->getFromId());
+            computeInsert(from, bb, insert);
+            insertAtEdge(from, insert);
+        }
+    }
+    for (IRBB * bb = bbl->get_head(&bbit);
+         bb != nullptr; bb = bbl->get_next(&bbit)) {
+        transformBB(bb);
+    }
+}
+
+
+void PRE::renameTmpPR()
+{
+    xcom::DomTree domtree;
+    m_cfg->genDomTree(domtree);
+    SSARegion ssarg(&m_sbs_mgr, domtree, m_rg, m_oc, &m_am);
+    ssarg.setRootBB(m_cfg->getEntry());
+    ssarg.addAllBBUnderRoot();
+    List<IR*>::Iter it;
+    for (IR * ir = m_tmp_irs.get_head(&it);
+         ir != nullptr; ir = m_tmp_irs.get_next(&it)) {
+        ssarg.add(ir);
+    }
+    //Infer and add those BBs that should be also handled in PRSSA construction.
+    ssarg.inferAndAddRelatedBB();
+    m_oc->setInvalidLiveness();
+    m_prssamgr->constructDesignatedRegion(ssarg);
+    m_oc->setInvalidPRDU();
+}
+
+
+bool PRE::dump() const
+{
+    if (!getRegion()->isLogMgrInit() || !g_dump_opt.isDumpPRE()) {
+        return true;
+    }
+    if (!g_dump_opt.isDumpAfterPass()) { return true; }
+    note(getRegion(), "\n==---- DUMP %s '%s' ----==",
+         getPassName(), m_rg->getRegionName());
+    getRegion()->getLogMgr()->incIndent(2);
+    note(getRegion(), "\nCANDIDATE:%u, INSERTED:%u, DELETED:%u",
+         m_idx2exp.get_elem_count(), m_inserted_num, m_deleted_num);
+    m_am.dump();
+    bool succ = Pass::dump();
+    getRegion()->getLogMgr()->decIndent(2);
+    return succ;
+}
+
+
+bool PRE::perform(OptCtx & oc)
+{
+    BBList * bbl = m_rg->getBBList();
+    if (bbl == nullptr || bbl->get_elem_count() == 0) { return false; }
+    if (!oc.is_ref_valid()) { return false; }
+    m_prssamgr = m_rg->getPRSSAMgr();
+    if (m_prssamgr == nullptr || !m_prssamgr->is_valid()) {
+        //The pass relies on SSA form to identify the value of candidate.
+        return false;
+    }
+    m_oc = &oc;
+    START_TIMER(t, getPassName());
+    oc.setInvalidPass(PASS_EXPR_TAB);
+    m_rg->getPassMgr()->checkValidAndRecompute(
+        &oc, PASS_DOM, PASS_RPO, PASS_EXPR_TAB, PASS_UNDEF);
+    m_expr_tab = (ExprTab*)m_rg->getPassMgr()->queryPass(PASS_EXPR_TAB);
+    ASSERT0(m_expr_tab && m_expr_tab->is_valid());
+    reset();
+
+    //Discard all temporaries of the pass at once when leaving the function.
+    xcom::SMemPoolScope scope(m_pool);
+    collectCand();
+    if (m_idx2exp.get_elem_count() == 0) {
+        destroy();
+        END_TIMER(t, getPassName());
+        return false;
+    }
+    RPOVexList const* vlst = m_cfg->getRPOVexList();
+    ASSERT0(vlst);
+    computeLocal();
+    computeAvail(*vlst);
+    computeAnt(*vlst);
+    computeLater(*vlst);
+    pickTransformed();
+    bool change = false;
+    if (!m_transformed.is_empty()) {
+        transform();
+        renameTmpPR();
+        change = true;
+    }
+    destroy();
+    END_TIMER(t, getPassName());
+    dump();
+    if (change) {
+        oc.setInvalidIfDUMgrLiveChanged();
+        oc.setInvalidPass(PASS_EXPR_TAB);
+        oc.setInvalidPass(PASS_GVN);
+        ASSERT0(m_rg->getDUMgr()->verifyMDRef());
+        ASSERT0(verifyMDDUChain(m_rg, oc));
+        ASSERT0(PRSSAMgr::verifyPRSSAInfo(m_rg, oc));
+    }
+    ASSERT0(verifyIRandBB(m_rg->getBBList(), m_rg));
+    return change;
+}
+//END PRE
+
+} //namespace xoc
@@ -0,0 +1,179 @@
+/*@
+XOC Release License
+
+Copyright (c) 2013-2014, Alibaba Group, All rights reserved.
+
+    compiler@aliexpress.com
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Su Zhenyu nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+author: Su Zhenyu
+@*/
+#ifndef _IR_PRE_H_
+#define _IR_PRE_H_
+
+namespace xoc {
+
+//The class performs Partial Redundancy Elimination by Lazy Code Motion.
+//The candidate is the entire RHS of assignment that is unary or binary
+//operation, and each operand is either PR or constant, e.g:
+//  stpr $3 = add $1, $2;
+//The candidate is lexically identified by ExprTab. Since PR is in SSA form,
+//lexically identical expressions compute the same value, and an operand can
+//only be killed by its unique definition.
+//The pass computes availability and anticipatability of candidates, then
+//derives the latest insertion point on CFG edges, inserts the computation
+//into a new PR, and replaces the redundant computations with the PR.
+//The new PR is renamed into SSA form by reconstructing PRSSA.
+//e.g: given partially redundant computation,
+//  BB1: if (...)           BB1: if (...)
+//  BB2:   $3 = $1 + $2     BB2:   $9 = $1 + $2; $3 = $9;
+//  BB3: else ...           BB3: else ...; $9 = $1 + $2;
+//  BB4: $4 = $1 + $2       BB4: $4 = $9
+//Ref: J.Knoop, O.Ruthing, B.Steffen, Lazy Code Motion, PLDI 1992.
+//     K.Drechsler, M.Stadel, A Variation of Knoop, Ruthing and Steffen's
+//     Lazy Code Motion, SIGPLAN Notices 1993.
+//NOTE: the insertion on critical edge and exception-handling edge is not
+//supported. The candidate that has to be inserted on such edge will not be
+//transformed, and the candidate is not available through the
+//exception-handling edge.
+class PRE : public Pass {
+    COPY_CONSTRUCTOR(PRE);
+    UINT m_inserted_num; //the number of inserted computations.
+    UINT m_deleted_num; //the number of eliminated computations.
+    IRCFG * m_cfg;
+    PRSSAMgr * m_prssamgr;
+    ExprTab * m_expr_tab;
+    OptCtx * m_oc;
+    xcom::SMemPool * m_pool; //hold temporaries that live in one perform().
+    xcom::BitSetMgr m_bs_mgr;
+    xcom::DefMiscBitSetMgr m_sbs_mgr;
+    ActMgr m_am;
+    xcom::BitSet m_universe; //the set of all candidates.
+    xcom::BitSet m_transformed; //the candidates that should be transformed.
+    Vector<ExprRep*> m_idx2exp; //map candidate index to ExprRep.
+    Vector<IR const*> m_idx2occ; //map candidate index to an occurrence.
+    Vector<UINT> m_exp2idx; //map ExprRep id to candidate index plus 1.
+    Vector<PRNO> m_idx2tmp; //map candidate index to the PR that holds it.
+    Vector<xcom::SC<UINT>*> m_prno2idx; //map PRNO to candidates that use it.
+    List<IR*> m_tmp_irs; //record PR operations that need to be renamed.
+    xcom::TTab<IR const*> m_inserted; //record inserted stmts.
+
+    //Local properties of BB, indexed by BB id.
+    Vector<xcom::BitSet*> m_ue; //upward exposed candidates.
+    Vector<xcom::BitSet*> m_de; //downward exposed candidates.
+    Vector<xcom::BitSet*> m_kill; //candidates whose operand defined in BB.
+
+    //Global properties of BB, indexed by BB id.
+    Vector<xcom::BitSet*> m_avail_out;
+    Vector<xcom::BitSet*> m_ant_in;
+    Vector<xcom::BitSet*> m_ant_out;
+    Vector<xcom::BitSet*> m_later_in;
+protected:
+    void addOccForRename(IR * ir) { m_tmp_irs.append_tail(ir); }
+
+    void collectCand();
+    void computeLocal();
+    void computeLocalForBB(IRBB const* bb);
+    void computeAvail(RPOVexList const& vlst);
+    void computeAnt(RPOVexList const& vlst);
+    void computeLater(RPOVexList const& vlst);
+    void computeEarliest(IRBB const* from, IRBB const* to,
+                         OUT xcom::BitSet & earliest);
+    void computeLaterOnEdge(IRBB const* from, IRBB const* to,
+                            OUT xcom::BitSet & later);
+    void computeInsert(IRBB const* from, IRBB const* to,
+                       OUT xcom::BitSet & insert);
+    void computeDelete(IRBB const* bb, OUT xcom::BitSet & del);
+    bool canInsertAtTail(IRBB * bb, UINT idx) const;
+
+    //Return true if the edge from 'from' to 'to' is exception-handling
+    //edge. Computations at the tail of 'from' are not available along the
+    //edge, and nothing can be inserted on it.
+    bool isEHEdge(IRBB const* from, IRBB const* to) const;
+
+    void destroy();
+    void dumpAct(UINT idx, CHAR const* act, IRBB const* bb);
+
+    //Return the candidate index of 'ir' plus 1, or 0 if ir is not candidate.
+    UINT getCandIdx(IR const* ir) const;
+    IR * getCand(IR const* stmt) const;
+    xcom::BitSet * genSet(Vector<xcom::BitSet*> & vec, UINT bbid);
+    xcom::BitSet * getSet(Vector<xcom::BitSet*> const& vec, UINT bbid) const
+    { return vec.get(bbid); }
+    PRNO genTmpPR(UINT idx, Type const* ty);
+
+    //Return the candidates whose operand is defined by 'stmt'.
+    xcom::SC<UINT> const* getKilledCand(IR * stmt) const;
+
+    //Insert the computation of candidates in 'insert' at the tail of 'from'.
+    void insertAtEdge(IRBB * from, xcom::BitSet const& insert);
+    bool isCand(IR const* ir) const;
+
+    //Pick out the candidates that should be transformed.
+    void pickTransformed();
+    void renameTmpPR();
+
+    //Replace the candidate with the PR that holds its value.
+    void replaceOcc(UINT idx, IR * occ, IR * stmt);
+    void reset();
+
+    //Compute candidate into the PR that holds its value, and replace the
+    //candidate with the PR.
+    void splitOcc(UINT idx, IR * occ, IR * stmt, IRBB * bb);
+    void transform();
+    void transformBB(IRBB * bb);
+
+    void * xmalloc(UINT size)
+    {
+        ASSERT0(m_pool);
+        void * p = smpoolMalloc(size, m_pool);
+        ASSERT0(p);
+        ::memset((void*)p, 0, size);
+        return p;
+    }
+public:
+    explicit PRE(Region * rg);
+    virtual ~PRE()
+    {
+        destroy();
+        smpoolDelete(m_pool);
+    }
+
+    //The function dump pass relative information.
+    //The dump information is always used to detect what the pass did.
+    //Return true if dump successed, otherwise false.
+    virtual bool dump() const;
+
+    virtual CHAR const* getPassName() const
+    { return "Partial Redundancy Elimination"; }
+    PASS_TYPE getPassType() const { return PASS_PRE; }
+    ActMgr const& getActMgr() const { return m_am; }
+
+    virtual bool perform(OptCtx & oc);
+};
+
+} //namespace xoc
+#endif
@@ -318,10 +318,11 @@ bool RCE::calcCondMustVal(IR const* ir, OUT bool & must_true,
             }
             return true;
         }
-        if (m_gvn != nullptr && m_gvn->is_valid()) {
-            return m_gvn->calcCondMustVal(ir, must_true, must_false);
+        if (m_gvn != nullptr && m_gvn->is_valid() &&
+            m_gvn->calcCondMustVal(ir, must_true, must_false)) {
+            return true;
         }
-        break;
+        return calcCondMustValByVRP(ir, must_true, must_false, oc);
     }
     default: UNREACHABLE();
     }
@@ -329,6 +330,23 @@ bool RCE::calcCondMustVal(IR const* ir, OUT bool & must_true,
 }
 
 
+bool RCE::calcCondMustValByVRP(IR const* ir, OUT bool & must_true,
+                               OUT bool & must_false, OptCtx const& oc) const
+{
+    must_true = false;
+    must_false = false;
+    VRP const* vrp = (VRP const*)m_rg->getPassMgr()->queryPass(PASS_VRP);
+    if (vrp == nullptr || !vrp->isAvail()) { return false; }
+
+    //The condition can be narrowed by the dominating branches of the BB
+    //that 'ir' placed.
+    IR const* stmt = ir->getParent();
+    IRBB const* bb = stmt != nullptr && stmt->is_stmt() ?
+        stmt->getBB() : nullptr;
+    return vrp->calcCondMustVal(ir, bb, must_true, must_false, oc);
+}
+
+
 static bool regardAsMustTrue(IR const* ir)
 {
     ASSERT0(ir->is_const());
@@ -382,15 +400,18 @@ IR * RCE::calcCondMustVal(
             }
             return ir;
         }
-        if (m_gvn == nullptr || !m_gvn->is_valid()) {
-            //GVN is inavailable.
-            return ir;
+        bool succ = false;
+        if (m_gvn != nullptr && m_gvn->is_valid()) {
+            if (changed) {
+                bool vn_changed = false;
+                m_gvn->computeVN(ir, vn_changed);
+            }
+            succ = m_gvn->calcCondMustVal(ir, must_true, must_false);
         }
-        if (changed) {
-            bool vn_changed = false;
-            m_gvn->computeVN(ir, vn_changed);
+        if (!succ) {
+            //GVN is inavailable or unable to determine the condition.
+            succ = calcCondMustValByVRP(ir, must_true, must_false, oc);
         }
-        bool succ = m_gvn->calcCondMustVal(ir, must_true, must_false);
         if (!succ) { return ir; }
         changed = true;
         if (must_true) {
@@ -98,6 +98,12 @@ public:
     bool calcCondMustVal(IR const* ir, OUT bool & must_true,
                          OUT bool & must_false, OptCtx const& oc) const;
 
+    //Determine the value of condition 'ir' by the value range of PR that
+    //computed by VRP.
+    //Return true if the result of 'ir' is determined.
+    bool calcCondMustValByVRP(IR const* ir, OUT bool & must_true,
+                              OUT bool & must_false, OptCtx const& oc) const;
+
     //If 'ir' is always true, set 'must_true', or if it is
     //always false, set 'must_false'.
     //Return the changed ir.
@@ -2342,6 +2342,9 @@ IR * Refine::refineCompare(IR * ir, bool & change, RefineCtx & rc)
     if (!ir->is_const()) {
         ir = refineDetViaSSADU(ir, lchange2, rc);
     }
+    if (!ir->is_const()) {
+        ir = refineDetViaVRP(ir, lchange2, rc);
+    }
     change |= lchange2;
     return ir;
 }
@@ -2676,6 +2679,31 @@ IR * Refine::refineDetViaSSADU(IR * ir, bool & change, RefineCtx const& rc)
 }
 
 
+//Determine the result of comparison by the value range of operands.
+//e.g: given $1 in [0,9], LT($1, 10) will be refined to 1.
+IR * Refine::refineDetViaVRP(IR * ir, bool & change, RefineCtx const& rc)
+{
+    if (!rc.usePRSSADU() || m_rg->getPassMgr() == nullptr) { return ir; }
+    ASSERT0(ir->is_judge());
+    VRP const* vrp = (VRP const*)m_rg->getPassMgr()->queryPass(PASS_VRP);
+    if (vrp == nullptr || !vrp->isAvail()) { return ir; }
+
+    //The parent of 'ir' may be stale during refinement, thus the conditions
+    //of dominating branches are not utilized.
+    bool must_true, must_false;
+    if (!vrp->calcCondMustVal(ir, nullptr, must_true, must_false,
+                              *rc.getOptCtx())) {
+        return ir;
+    }
+    ASSERT0(must_true ^ must_false);
+    Type const* ty = ir->getType();
+    xoc::removeUseForTree(ir, m_rg, *rc.getOptCtx());
+    m_rg->freeIRTree(ir);
+    change = true;
+    return m_irmgr->buildImmInt(must_true ? 1 : 0, ty);
+}
+
+
 IR * Refine::refineIRUntilUnchange(IR * ir, bool & change, RefineCtx & rc)
 {
     bool lchange = true;
@@ -2923,7 +2951,10 @@ bool Refine::refineBBlist(MOD BBList * ir_bb_list, MOD RefineCtx & rc)
     BBListIter ct;
     for (ir_bb_list->get_head(&ct);
          ct != ir_bb_list->end(); ct = ir_bb_list->get_next(ct)) {
-        change |= refineStmtList(BB_irlist(ct->val()), rc);
+        if (refineStmtList(BB_irlist(ct->val()), rc)) {
+            rc.getOptCtx()->addChangedBB(ct->val());
+            change = true;
+        }
     }
     END_TIMER(t, "Refine IRBB list");
     if (!change) { return false; }
@@ -230,6 +230,7 @@ protected:
     IR * refineILoad3(IR * ir, bool & change, RefineCtx & rc);
     IR * refineILoad(IR * ir, bool & change, RefineCtx & rc);
     IR * refineDetViaSSADU(IR * ir, bool & change, RefineCtx const& rc);
+    IR * refineDetViaVRP(IR * ir, bool & change, RefineCtx const& rc);
     IR * refineDet(IR * ir_list, bool & change, RefineCtx & rc);
     IR * refineDirectStore(IR * ir, bool & change, RefineCtx & rc);
     IR * refineStoreArray(IR * ir, bool & change, RefineCtx & rc);
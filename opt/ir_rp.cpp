@@ -574,6 +574,22 @@ public:
 //
 //START DelegateMgr
 //
+DelegateMgr::DelegateMgr(RegPromot * rp, Region * rg, GVN * gvn)
+{
+    m_is_restore_duchain_built = false;
+    m_rp = rp;
+    m_rg = rg;
+    m_gvn = gvn;
+
+    //Loops are promoted one by one, reuse the pool of RegPromot rather than
+    //creating a pool for each loop.
+    m_pool = rp->get_pool();
+    m_pool_mark = smpoolMark(m_pool);
+    m_mdssamgr = (MDSSAMgr*)(m_rg->getPassMgr()->queryPass(
+        PASS_MDSSA_MGR));
+}
+
+
 void DelegateMgr::collectOutsideLoopUse(IR const* dele, IRSet const& set,
                                         LI<IRBB> const* li)
 {
@@ -747,8 +763,9 @@ void DelegateMgr::clean()
         //m_rg->freeIRTree(x);
     }
     m_dele2init.clean();
-    smpoolDelete(m_pool);
+    smpoolRelease(m_pool, m_pool_mark);
     m_pool = nullptr;
+    m_pool_mark = nullptr;
 }
 
 
@@ -2862,7 +2879,7 @@ bool RegPromot::initLoopDepAna(OptCtx & oc)
     ASSERT0(m_loop_dep_ana);
     if (!m_loop_dep_ana->is_valid()) {
         m_rg->getLogMgr()->tryIncIndent(2);
-        m_loop_dep_ana->perform(oc);
+        m_rg->getPassMgr()->performPass(m_loop_dep_ana, oc);
         m_rg->getLogMgr()->tryDecIndent(2);
     }
     return true;
@@ -2877,7 +2894,7 @@ bool RegPromot::initGVN(OptCtx & oc)
         goto BAILOUT;
     }
     if (!m_gvn->is_valid()) {
-        m_gvn->perform(oc);
+        m_rg->getPassMgr()->performPass(m_gvn, oc);
     }
     if (!m_gvn->is_valid()) { goto BAILOUT; }
     return true;
@@ -191,7 +191,8 @@ protected:
 public:
     Region * m_rg;
     MDSSAMgr * m_mdssamgr;
-    SMemPool * m_pool;
+    SMemPool * m_pool; //borrowed from RegPromot.
+    SMemPoolMark const* m_pool_mark; //checkpoint of m_pool.
     GVN * m_gvn;
     xcom::DefMiscBitSetMgr m_sbs_mgr;
 
@@ -203,16 +204,9 @@ public:
     //The field records outside loop DEF for 'delegate' if delegate is exp.
     xcom::TMap<IR const*, DUSet*> m_dele2outsidedefset;
 public:
-    DelegateMgr(RegPromot * rp, Region * rg, GVN * gvn)
-    {
-        m_is_restore_duchain_built = false;
-        m_rp = rp;
-        m_rg = rg;
-        m_gvn = gvn;
-        m_pool = smpoolCreate(4 * sizeof(xcom::SC<IR*>), MEM_COMM);
-        m_mdssamgr = (MDSSAMgr*)(m_rg->getPassMgr()->queryPass(
-            PASS_MDSSA_MGR));
-    }
+    //The manager lives in the promotion of one loop, and all memory it
+    //allocated in the pool of 'rp' is discarded when it is destructed.
+    DelegateMgr(RegPromot * rp, Region * rg, GVN * gvn);
     ~DelegateMgr() { clean(); }
 
     void addToOutsideUseSet(IR const* dele, IR * ir);
@@ -853,6 +847,7 @@ public:
 
     virtual CHAR const* getPassName() const { return "Register Promotion"; }
     PASS_TYPE getPassType() const { return PASS_RP; }
+    SMemPool * get_pool() const { return m_pool; }
 
     virtual bool perform(OptCtx & oc);
 
@@ -1625,6 +1625,7 @@ IR * IRSimp::simplifyRelationInDet(IR * ir, SimpCtx * ctx)
             ir->setKid(i, simplifyExpression(kid, ctx));
         }
     }
+    ir = foldRelationByVRP(ir, ctx);
     if (SIMP_to_lowest_height(ctx) && !isLowest(ir)) {
         ir = simplifyToPR(ir, ctx);
     }
@@ -1632,6 +1633,25 @@ IR * IRSimp::simplifyRelationInDet(IR * ir, SimpCtx * ctx)
 }
 
 
+IR * IRSimp::foldRelationByVRP(IR * ir, SimpCtx const* ctx)
+{
+    ASSERT0(ir->is_relation());
+    OptCtx const* oc = ctx->getOptCtx();
+    if (oc == nullptr || m_rg->getPassMgr() == nullptr) { return ir; }
+    VRP const* vrp = (VRP const*)m_rg->getPassMgr()->queryPass(PASS_VRP);
+    if (vrp == nullptr || !vrp->isAvail()) { return ir; }
+    bool must_true, must_false;
+    if (!vrp->calcCondMustVal(ir, nullptr, must_true, must_false, *oc)) {
+        return ir;
+    }
+    ASSERT0(must_true ^ must_false);
+    Type const* ty = ir->getType();
+    xoc::removeUseForTree(ir, m_rg, *oc);
+    m_rg->freeIRTree(ir);
+    return m_irmgr->buildJudge(m_irmgr->buildImmInt(must_true ? 1 : 0, ty));
+}
+
+
 //Return new generated expression's value.
 IR * IRSimp::simplifyJudgeDet(IR * ir, SimpCtx * ctx)
 {
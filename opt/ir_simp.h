@@ -548,6 +548,10 @@ public:
     IR * simplifyLogicalAndOrInDet(IN IR * ir, SimpCtx * ctx);
     IR * simplifyLogicalNotInDet(IN IR * ir, SimpCtx * ctx);
     IR * simplifyRelationInDet(IN IR * ir, SimpCtx * ctx);
+
+    //Fold relation operation to judgement of constant if the value range of
+    //operands is able to determine the result.
+    IR * foldRelationByVRP(IR * ir, SimpCtx const* ctx);
     virtual IR * simplifyLogicalDet(IR * ir, SimpCtx * ctx);
 
     //Simplify ir to PR mode.
@@ -3773,7 +3773,7 @@ bool PRSSAMgr::constructVPRAndPhi(xcom::DomTree & domtree, OptCtx & oc)
     if (m_is_pruned) {
         m_livemgr = (LivenessMgr*)m_rg->getPassMgr()->
             registerPass(PASS_LIVENESS_MGR);
-        m_livemgr->perform(oc);
+        m_rg->getPassMgr()->performPass(m_livemgr, oc);
         ASSERT0(m_livemgr->is_valid());
     } else {
         m_livemgr = nullptr;
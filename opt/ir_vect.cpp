@@ -0,0 +1,1349 @@
+/*@
+XOC Release License
+
+Copyright (c) 2013-2014, Alibaba Group, All rights reserved.
+
+    compiler@aliexpress.com
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Su Zhenyu nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+author: Su Zhenyu
+@*/
+#include "cominc.h"
+#include "comopt.h"
+
+namespace xoc {
+
+//The maximum number of memory operation pairs that are checked at runtime.
+#define VECT_MAX_RUNTIME_CHECK 8
+
+//
+//START VectLoopInfo
+//
+IR * VectLoopInfo::getRedStmt(IR const* phi) const
+{
+    xcom::List<IR*>::Iter it;
+    xcom::List<IR*>::Iter it2;
+    IR * stmt = red_stmt_list.get_head(&it2);
+    for (IR * p = red_phi_list.get_head(&it);
+         p != nullptr; p = red_phi_list.get_next(&it),
+         stmt = red_stmt_list.get_next(&it2)) {
+        if (p == phi) { return stmt; }
+    }
+    return nullptr;
+}
+
+
+void VectLoopInfo::dump(Region const* rg) const
+{
+    note(rg, "\nLOOP%u HEAD:BB%u BODY:BB%u PREHEADER:BB%u VF:%u ELEMSIZE:%u",
+         li->id(), head->id(), body->id(), preheader->id(), vf, elem_size);
+    rg->getLogMgr()->incIndent(2);
+    note(rg, "\nBIV:$%u", PHI_prno(biv_phi));
+    xcom::List<IR*>::Iter it;
+    for (IR * p = red_phi_list.get_head(&it);
+         p != nullptr; p = red_phi_list.get_next(&it)) {
+        note(rg, "\nREDUCTION:$%u", PHI_prno(p));
+    }
+    for (IR * p = check_list.get_head(&it);
+         p != nullptr; p = check_list.get_next(&it)) {
+        IR * q = check_list.get_next(&it);
+        ASSERT0(q);
+        note(rg, "\nRUNTIME CHECK:%s VS. %s", DumpIRName().dump(p),
+             DumpIRName().dump(q));
+    }
+    rg->getLogMgr()->decIndent(2);
+}
+//END VectLoopInfo
+
+
+//
+//START Vectorization
+//
+Vectorization::Vectorization(Region * rg) : Pass(rg), m_am(rg)
+{
+    ASSERT0(rg);
+    m_is_aggressive = false;
+    m_vect_loop_num = 0;
+    m_cfg = rg->getCFG();
+    m_tm = rg->getTypeMgr();
+    m_irmgr = rg->getIRMgr();
+    m_prssamgr = nullptr;
+    m_mdssamgr = nullptr;
+    m_ivr = nullptr;
+    m_lda = nullptr;
+    m_oc = nullptr;
+}
+
+
+UINT Vectorization::getVectorByteSize() const
+{
+    return g_vect_reg_byte_size;
+}
+
+
+HOST_INT Vectorization::getRedIdentity(IR_CODE code) const
+{
+    switch (code) {
+    case IR_ADD:
+    case IR_BOR:
+    case IR_XOR:
+        return 0;
+    case IR_MUL:
+        return 1;
+    case IR_BAND:
+        return -1;
+    default: UNREACHABLE();
+    }
+    return 0;
+}
+
+
+Type const* Vectorization::getVecType(
+    VectLoopInfo const& vli, Type const* ety) const
+{
+    ASSERT0(vli.vf > 1 && !ety->is_vector());
+    return m_tm->getVectorType(vli.vf, ety->getDType());
+}
+
+
+bool Vectorization::isVectorizableType(
+    Type const* ty, MOD VectLoopInfo & vli) const
+{
+    if (ty->is_vector() || ty->is_bool() || (!ty->is_int() && !ty->is_fp())) {
+        return false;
+    }
+    UINT sz = m_tm->getByteSize(ty);
+    if (sz == 0 || getVectorByteSize() % sz != 0) { return false; }
+    if (vli.elem_size == 0) {
+        vli.elem_size = sz;
+        return true;
+    }
+    //All widened values have to share the same vectorization factor.
+    return vli.elem_size == sz;
+}
+
+
+bool Vectorization::isVectorizableOp(IR const* exp) const
+{
+    switch (exp->getCode()) {
+    case IR_ADD:
+    case IR_SUB:
+    case IR_MUL:
+    case IR_NEG:
+        return exp->is_int() || exp->is_fp();
+    case IR_DIV:
+        return exp->is_fp();
+    case IR_BAND:
+    case IR_BOR:
+    case IR_XOR:
+    case IR_BNOT:
+        return exp->is_int();
+    default:;
+    }
+    return false;
+}
+
+
+bool Vectorization::isContainVectorOp(LI<IRBB> const* li) const
+{
+    for (BSIdx i = li->getBodyBBSet()->get_first();
+         i != BS_UNDEF; i = li->getBodyBBSet()->get_next(i)) {
+        IRBB * bb = m_cfg->getBB(i);
+        ASSERT0(bb);
+        BBIRListIter it;
+        for (IR * ir = bb->getIRList().get_head(&it);
+             ir != nullptr; ir = bb->getIRList().get_next(&it)) {
+            ConstIRIter irit;
+            for (IR const* x = xoc::iterInitC(ir, irit, false);
+                 x != nullptr; x = xoc::iterNextC(irit, true)) {
+                if (x->getType()->is_vector()) { return true; }
+            }
+        }
+    }
+    return false;
+}
+
+
+//Return true if all USEs of the result of 'def' are in stmt 'user'.
+bool Vectorization::isUsedOnlyBy(IR const* def, IR const* user) const
+{
+    SSAInfo const* ssainfo = def->getSSAInfo();
+    if (ssainfo == nullptr || ssainfo->getUses().is_empty()) { return false; }
+    SSAUseIter it;
+    for (BSIdx u = ssainfo->getUses().get_first(&it);
+         u != BS_UNDEF; u = ssainfo->getUses().get_next(u, &it)) {
+        IR const* use = m_rg->getIR(u);
+        ASSERT0(use);
+        if (use->getStmt() != user) { return false; }
+    }
+    return true;
+}
+
+
+//Return true if the result of 'def' is used only once inside loop 'li',
+//and the USE is in stmt 'user'.
+bool Vectorization::isUsedOnceInLoop(
+    IR const* def, IR const* user, LI<IRBB> const* li) const
+{
+    SSAInfo const* ssainfo = def->getSSAInfo();
+    if (ssainfo == nullptr) { return false; }
+    UINT cnt = 0;
+    SSAUseIter it;
+    for (BSIdx u = ssainfo->getUses().get_first(&it);
+         u != BS_UNDEF; u = ssainfo->getUses().get_next(u, &it)) {
+        IR const* use = m_rg->getIR(u);
+        ASSERT0(use);
+        IR const* stmt = use->getStmt();
+        if (!li->isInsideLoop(stmt->getBB()->id())) { continue; }
+        if (stmt != user) { return false; }
+        cnt++;
+    }
+    return cnt == 1;
+}
+
+
+//Return true if 'stmt' is in the form of: $inext = add $i, 1, where $i is
+//the result of 'phi'.
+bool Vectorization::isBIVStep(IR const* stmt, IR const* phi) const
+{
+    if (!stmt->is_stpr() || !stmt->is_int() || stmt->is_bool()) {
+        return false;
+    }
+    IR const* rhs = STPR_rhs(stmt);
+    if (!rhs->is_add()) { return false; }
+    IR const* op0 = BIN_opnd0(rhs);
+    IR const* op1 = BIN_opnd1(rhs);
+    if (op0->is_const()) { xcom::swap(op0, op1); }
+    if (!op0->is_pr() || !op1->is_const() || !op1->is_int() ||
+        CONST_int_val(op1) != 1) {
+        return false;
+    }
+    if (op0->getSSAInfo() == nullptr || op0->getSSAInfo()->getDef() != phi) {
+        return false;
+    }
+    return isUsedOnlyBy(stmt, phi);
+}
+
+
+VECT_KIND Vectorization::inferPRKind(
+    IR const* exp, VectLoopInfo const& vli, OUT HOST_INT & coef) const
+{
+    ASSERT0(exp->is_pr());
+    IR const* def = exp->getSSAInfo() != nullptr ?
+        exp->getSSAInfo()->getDef() : nullptr;
+    if (def == nullptr || !vli.li->isInsideLoop(def->getBB()->id())) {
+        coef = 0;
+        return VECT_KIND_INV;
+    }
+    if (def == vli.biv_phi) {
+        coef = 1;
+        return VECT_KIND_AFF;
+    }
+    if (def->getBB() != vli.body || !def->is_stpr()) {
+        //CASE:The value of reduction or the next value of BIV can not be
+        //used by other computations.
+        return VECT_KIND_UNDEF;
+    }
+    VECT_KIND k = vli.prno2kind.get(exp->getPrno());
+    if (k == VECT_KIND_AFF) {
+        coef = vli.prno2coef.get(exp->getPrno());
+    }
+    return k;
+}
+
+
+VECT_KIND Vectorization::inferBinKind(
+    IR const* exp, VectLoopInfo const& vli, OUT HOST_INT & coef) const
+{
+    ASSERT0(exp->isBinaryOp());
+    HOST_INT c0 = 0;
+    HOST_INT c1 = 0;
+    VECT_KIND k0 = inferKind(BIN_opnd0(exp), vli, c0);
+    VECT_KIND k1 = inferKind(BIN_opnd1(exp), vli, c1);
+    if (k0 == VECT_KIND_UNDEF || k1 == VECT_KIND_UNDEF) {
+        return VECT_KIND_UNDEF;
+    }
+    if (k0 == VECT_KIND_VEC || k1 == VECT_KIND_VEC) {
+        //Invariant operand will be splatted.
+        if ((k0 != VECT_KIND_VEC && k0 != VECT_KIND_INV) ||
+            (k1 != VECT_KIND_VEC && k1 != VECT_KIND_INV)) {
+            return VECT_KIND_UNDEF;
+        }
+        if (!isVectorizableOp(exp) ||
+            m_tm->getByteSize(exp->getType()) != vli.elem_size) {
+            return VECT_KIND_UNDEF;
+        }
+        return VECT_KIND_VEC;
+    }
+    if (k0 == VECT_KIND_INV && k1 == VECT_KIND_INV) {
+        coef = 0;
+        return VECT_KIND_INV;
+    }
+    if (k0 == VECT_KIND_SCALAR || k1 == VECT_KIND_SCALAR ||
+        exp->is_bool() || (!exp->is_int() && !exp->is_ptr())) {
+        return VECT_KIND_SCALAR;
+    }
+    switch (exp->getCode()) {
+    case IR_ADD:
+        coef = c0 + c1;
+        return VECT_KIND_AFF;
+    case IR_SUB:
+        coef = c0 - c1;
+        return VECT_KIND_AFF;
+    case IR_MUL:
+        if (k1 == VECT_KIND_INV && BIN_opnd1(exp)->is_const() &&
+            BIN_opnd1(exp)->is_int()) {
+            coef = c0 * CONST_int_val(BIN_opnd1(exp));
+            return VECT_KIND_AFF;
+        }
+        if (k0 == VECT_KIND_INV && BIN_opnd0(exp)->is_const() &&
+            BIN_opnd0(exp)->is_int()) {
+            coef = c1 * CONST_int_val(BIN_opnd0(exp));
+            return VECT_KIND_AFF;
+        }
+        break;
+    case IR_LSL:
+        if (k0 == VECT_KIND_AFF && BIN_opnd1(exp)->is_const() &&
+            BIN_opnd1(exp)->is_int() && CONST_int_val(BIN_opnd1(exp)) >= 0 &&
+            CONST_int_val(BIN_opnd1(exp)) < 32) {
+            coef = c0 << CONST_int_val(BIN_opnd1(exp));
+            return VECT_KIND_AFF;
+        }
+        break;
+    default:;
+    }
+    return VECT_KIND_SCALAR;
+}
+
+
+//The function infers the kind of value of 'exp' that computed in loop body.
+//coef: record the coefficient of BIV if 'exp' is affine.
+VECT_KIND Vectorization::inferKind(
+    IR const* exp, VectLoopInfo const& vli, OUT HOST_INT & coef) const
+{
+    coef = 0;
+    switch (exp->getCode()) {
+    case IR_CONST:
+    case IR_LDA:
+        return VECT_KIND_INV;
+    case IR_PR:
+        return inferPRKind(exp, vli, coef);
+    case IR_ILD: {
+        //Only unit-stride access can be widened.
+        HOST_INT c = 0;
+        VECT_KIND k = inferKind(ILD_base(exp), vli, c);
+        if (k != VECT_KIND_AFF ||
+            c != (HOST_INT)m_tm->getByteSize(exp->getType()) ||
+            m_tm->getByteSize(exp->getType()) != vli.elem_size) {
+            return VECT_KIND_UNDEF;
+        }
+        return VECT_KIND_VEC;
+    }
+    case IR_CVT: {
+        HOST_INT c = 0;
+        IR const* kid = CVT_exp(exp);
+        VECT_KIND k = inferKind(kid, vli, c);
+        if (k == VECT_KIND_INV || k == VECT_KIND_SCALAR) { return k; }
+        if (k == VECT_KIND_AFF && exp->is_int() && kid->is_int() &&
+            m_tm->getByteSize(exp->getType()) >=
+            m_tm->getByteSize(kid->getType())) {
+            //Widening conversion keeps the affine form.
+            coef = c;
+            return VECT_KIND_AFF;
+        }
+        return k == VECT_KIND_AFF ? VECT_KIND_SCALAR : VECT_KIND_UNDEF;
+    }
+    case IR_NEG:
+    case IR_BNOT: {
+        HOST_INT c = 0;
+        VECT_KIND k = inferKind(UNA_opnd(exp), vli, c);
+        switch (k) {
+        case VECT_KIND_INV:
+        case VECT_KIND_SCALAR:
+            return k;
+        case VECT_KIND_AFF:
+            if (exp->is_neg()) {
+                coef = -c;
+                return VECT_KIND_AFF;
+            }
+            return VECT_KIND_SCALAR;
+        case VECT_KIND_VEC:
+            if (isVectorizableOp(exp) &&
+                m_tm->getByteSize(exp->getType()) == vli.elem_size) {
+                return VECT_KIND_VEC;
+            }
+            return VECT_KIND_UNDEF;
+        default:;
+        }
+        return VECT_KIND_UNDEF;
+    }
+    default:
+        if (exp->isBinaryOp()) { return inferBinKind(exp, vli, coef); }
+    }
+    return VECT_KIND_UNDEF;
+}
+
+
+bool Vectorization::analyzeRed(IR * phi, MOD VectLoopInfo & vli)
+{
+    if (!phi->is_int() || phi->is_bool()) { return false; }
+    bool is_pred = false;
+    UINT pos = m_cfg->WhichPred(vli.body, vli.head, is_pred);
+    ASSERT0(is_pred);
+    IR const* opnd = ((CPhi*)phi)->getOpnd(pos);
+    if (opnd == nullptr || !opnd->is_pr() || opnd->getSSAInfo() == nullptr) {
+        return false;
+    }
+    IR * stmt = opnd->getSSAInfo()->getDef();
+    if (stmt == nullptr || !stmt->is_stpr() || stmt->getBB() != vli.body ||
+        stmt->getType() != phi->getType()) {
+        return false;
+    }
+    IR * rhs = STPR_rhs(stmt);
+    switch (rhs->getCode()) {
+    case IR_ADD:
+    case IR_MUL:
+    case IR_BAND:
+    case IR_BOR:
+    case IR_XOR:
+        break;
+    default: return false;
+    }
+    IR * use = BIN_opnd0(rhs);
+    if (!use->is_pr() || use->getSSAInfo() == nullptr ||
+        use->getSSAInfo()->getDef() != phi) {
+        use = BIN_opnd1(rhs);
+    }
+    if (!use->is_pr() || use->getSSAInfo() == nullptr ||
+        use->getSSAInfo()->getDef() != phi) {
+        return false;
+    }
+    if (!isUsedOnlyBy(stmt, phi) || !isUsedOnceInLoop(phi, stmt, vli.li)) {
+        return false;
+    }
+    if (m_lda != nullptr) {
+        //Ask LoopDepAna to confirm the reduction.
+        LoopDepInfoSet set;
+        LDACtx ctx(vli.li);
+        xcom::List<IR*> empty;
+        m_lda->analyzeDep(use, empty, set, ctx);
+        if (!m_lda->containLoopRedDep(set)) { return false; }
+    }
+    vli.red_phi_list.append_tail(phi);
+    vli.red_stmt_list.append_tail(stmt);
+    return true;
+}
+
+
+bool Vectorization::analyzeHead(MOD VectLoopInfo & vli)
+{
+    IR * br = vli.head->getLastIR();
+    if (br == nullptr || !br->isConditionalBr() ||
+        !xoc::isBranchTargetOutSideLoop(vli.li, m_cfg, br)) {
+        m_am.dump("LOOP%u:head is not ended with exit branch", vli.li->id());
+        return false;
+    }
+    bool is_pred = false;
+    UINT pos = m_cfg->WhichPred(vli.body, vli.head, is_pred);
+    ASSERT0(is_pred);
+    BBIRListIter it;
+    for (IR * ir = vli.head->getIRList().get_head(&it);
+         ir != br; ir = vli.head->getIRList().get_next(&it)) {
+        if (!ir->is_phi()) {
+            m_am.dump("LOOP%u:head contains non-PHI stmt", vli.li->id());
+            return false;
+        }
+        IR const* opnd = ((CPhi*)ir)->getOpnd(pos);
+        IR * def = opnd != nullptr && opnd->is_pr() &&
+            opnd->getSSAInfo() != nullptr ?
+            opnd->getSSAInfo()->getDef() : nullptr;
+        if (vli.biv_phi == nullptr && def != nullptr &&
+            def->getBB() == vli.body && isBIVStep(def, ir)) {
+            vli.biv_phi = ir;
+            vli.biv_step = def;
+            continue;
+        }
+        if (!analyzeRed(ir, vli)) {
+            m_am.dump("LOOP%u:$%u is neither BIV nor reduction",
+                      vli.li->id(), PHI_prno(ir));
+            return false;
+        }
+    }
+    if (vli.biv_phi == nullptr) {
+        m_am.dump("LOOP%u:not find BIV", vli.li->id());
+        return false;
+    }
+    IV const* iv = nullptr;
+    if (m_ivr == nullptr || !m_ivr->is_valid() ||
+        !m_ivr->isBIV(vli.li, vli.biv_phi, &iv)) {
+        m_am.dump("LOOP%u:IVR does not confirm BIV $%u", vli.li->id(),
+                  PHI_prno(vli.biv_phi));
+        return false;
+    }
+    //IVR should agree on the step of BIV.
+    ASSERT0(iv);
+    if (!iv->isStepValInt() || iv->getStepValInt() != 1) {
+        m_am.dump("LOOP%u:step of BIV is not 1", vli.li->id());
+        return false;
+    }
+
+    //Normalize the exit condition to the comparison to stay in loop.
+    IR const* det = BR_det(br);
+    IR_CODE code = det->getCode();
+    if (br->is_truebr()) {
+        switch (code) {
+        case IR_GE: code = IR_LT; break;
+        case IR_GT: code = IR_LE; break;
+        default: code = IR_UNDEF;
+        }
+    }
+    if (code != IR_LT && code != IR_LE) {
+        m_am.dump("LOOP%u:unsupported exit condition", vli.li->id());
+        return false;
+    }
+    IR const* ivref = BIN_opnd0(det);
+    IR const* bound = BIN_opnd1(det);
+    if (!ivref->is_pr() || ivref->getSSAInfo() == nullptr ||
+        ivref->getSSAInfo()->getDef() != vli.biv_phi ||
+        !xoc::isLoopInvariant(bound, vli.li, m_rg, nullptr, true)) {
+        m_am.dump("LOOP%u:exit condition is not BIV bound", vli.li->id());
+        return false;
+    }
+    vli.cmp_code = code;
+    vli.bound = const_cast<IR*>(bound);
+    return true;
+}
+
+
+//Collect the memory operations of IR tree 'ir'.
+static void collectMemOp(IR * ir, OUT xcom::List<IR*> & memops)
+{
+    IRIter it;
+    for (IR * x = xoc::iterInit(ir, it, false);
+         x != nullptr; x = xoc::iterNext(it, true)) {
+        if (x->is_ild() || x->is_ist()) { memops.append_tail(x); }
+    }
+}
+
+
+bool Vectorization::analyzeStmt(
+    IR * ir, OUT xcom::List<IR*> & memops, MOD VectLoopInfo & vli)
+{
+    HOST_INT coef = 0;
+    switch (ir->getCode()) {
+    case IR_STPR: {
+        if (ir == vli.biv_step) { return true; }
+        IR * rhs = STPR_rhs(ir);
+        if (vli.isRedStmt(ir)) {
+            if (!isVectorizableType(ir->getType(), vli)) { return false; }
+            IR * opnd = BIN_opnd0(rhs);
+            if (opnd->is_pr() && opnd->getSSAInfo() != nullptr &&
+                vli.red_phi_list.find(opnd->getSSAInfo()->getDef())) {
+                opnd = BIN_opnd1(rhs);
+            }
+            VECT_KIND k = inferKind(opnd, vli, coef);
+            if (k != VECT_KIND_VEC && k != VECT_KIND_INV) { return false; }
+            collectMemOp(opnd, memops);
+            return true;
+        }
+        if (rhs->is_ild() && !isVectorizableType(rhs->getType(), vli)) {
+            return false;
+        }
+        VECT_KIND k = inferKind(rhs, vli, coef);
+        if (k == VECT_KIND_UNDEF) { return false; }
+        if (k == VECT_KIND_VEC &&
+            m_tm->getByteSize(ir->getType()) != vli.elem_size) {
+            return false;
+        }
+        vli.prno2kind.setAlways(STPR_no(ir), k);
+        if (k == VECT_KIND_AFF) {
+            vli.prno2coef.setAlways(STPR_no(ir), coef);
+        }
+        collectMemOp(rhs, memops);
+        return true;
+    }
+    case IR_IST: {
+        if (!isVectorizableType(ir->getType(), vli)) { return false; }
+        VECT_KIND k = inferKind(IST_base(ir), vli, coef);
+        if (k != VECT_KIND_AFF ||
+            coef != (HOST_INT)m_tm->getByteSize(ir->getType())) {
+            return false;
+        }
+        k = inferKind(IST_rhs(ir), vli, coef);
+        if (k != VECT_KIND_VEC && k != VECT_KIND_INV) { return false; }
+        collectMemOp(ir, memops);
+        return true;
+    }
+    default:;
+    }
+    return false;
+}
+
+
+//Return true if there may be dependence between 'ist' and 'mem' that is not
+//loop-independent.
+static bool needRuntimeCheck(
+    IR const* ist, IR const* mem, LoopDepAna * lda, LI<IRBB> const* li,
+    Region * rg)
+{
+    if (!xoc::isDependent(ist, mem, true, rg)) { return false; }
+    if (lda == nullptr) { return true; }
+    LoopDepInfoSet set;
+    LDACtx ctx(li);
+    lda->analyzeDepAndRefineDep(ist, mem, set, ctx);
+    return !set.isAtMostContainLoopIndep(ist, mem);
+}
+
+
+//Return true if 'a' and 'b' access the same address.
+static bool isSameAddr(IR const* a, IR const* b, IRMgr const* mgr)
+{
+    return a->getOffset() == b->getOffset() &&
+           a->getBase()->isIREqual(b->getBase(), mgr);
+}
+
+
+//Return true if the runtime checking of 'ist' and 'mem' is equivalent to
+//a recorded one. Since the checking is symmetric in the two accesses, the
+//pair is also matched in reverse order.
+static bool isCheckRecorded(IR const* ist, IR const* mem,
+                            VectLoopInfo const& vli, IRMgr const* mgr)
+{
+    xcom::List<IR*>::Iter it;
+    for (IR * p = vli.check_list.get_head(&it);
+         p != nullptr; p = vli.check_list.get_next(&it)) {
+        IR * q = vli.check_list.get_next(&it);
+        ASSERT0(q);
+        if ((isSameAddr(p, ist, mgr) && isSameAddr(q, mem, mgr)) ||
+            (isSameAddr(p, mem, mgr) && isSameAddr(q, ist, mgr))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+bool Vectorization::analyzeMemDep(
+    xcom::List<IR*> const& memops, MOD VectLoopInfo & vli)
+{
+    UINT num = 0;
+    xcom::List<IR*>::Iter it;
+    for (IR * ist = memops.get_head(&it);
+         ist != nullptr; ist = memops.get_next(&it)) {
+        if (!ist->is_ist()) { continue; }
+        xcom::List<IR*>::Iter it2;
+        bool after = false;
+        for (IR * mem = memops.get_head(&it2);
+             mem != nullptr; mem = memops.get_next(&it2)) {
+            if (mem == ist) { after = true; continue; }
+            if (mem->is_ist() && !after) {
+                //The pair has been handled.
+                continue;
+            }
+            if (!needRuntimeCheck(ist, mem, m_lda, vli.li, m_rg) ||
+                isCheckRecorded(ist, mem, vli, m_irmgr)) {
+                continue;
+            }
+            num++;
+            if (num > VECT_MAX_RUNTIME_CHECK) {
+                m_am.dump("LOOP%u:too many runtime checks", vli.li->id());
+                return false;
+            }
+            vli.check_list.append_tail(ist);
+            vli.check_list.append_tail(mem);
+        }
+    }
+    return true;
+}
+
+
+bool Vectorization::analyzeBody(MOD VectLoopInfo & vli)
+{
+    xcom::List<IR*> memops;
+    BBIRListIter it;
+    for (IR * ir = vli.body->getIRList().get_head(&it);
+         ir != nullptr; ir = vli.body->getIRList().get_next(&it)) {
+        if (ir->is_goto()) {
+            ASSERT0(ir == vli.body->getLastIR());
+            break;
+        }
+        if (!analyzeStmt(ir, memops, vli)) {
+            m_am.dump("LOOP%u:can not vectorize %s", vli.li->id(),
+                      DumpIRName().dump(ir));
+            return false;
+        }
+    }
+    if (memops.get_elem_count() == 0 || vli.elem_size == 0) {
+        m_am.dump("LOOP%u:no memory access to widen", vli.li->id());
+        return false;
+    }
+    vli.vf = getVectorByteSize() / vli.elem_size;
+    if (vli.vf < 2) { return false; }
+    return analyzeMemDep(memops, vli);
+}
+
+
+bool Vectorization::analyzeLoop(MOD VectLoopInfo & vli)
+{
+    LI<IRBB> const* li = vli.li;
+    IRBB * head = li->getLoopHead();
+    ASSERT0(head);
+    if (m_processed.find(head->id())) { return false; }
+    if (li->getBodyBBSet()->get_elem_count() != 2) {
+        m_am.dump("LOOP%u:body is not single BB", li->id());
+        return false;
+    }
+    IRBB * body = nullptr;
+    for (BSIdx i = li->getBodyBBSet()->get_first();
+         i != BS_UNDEF; i = li->getBodyBBSet()->get_next(i)) {
+        if ((UINT)i != head->id()) { body = m_cfg->getBB(i); }
+    }
+    ASSERT0(body);
+    //Exception-handling edge is excluded by the degree of BBs.
+    if (body->getVex()->getInDegree() != 1 ||
+        body->getVex()->getOutDegree() != 1 ||
+        head->getVex()->getInDegree() != 2 ||
+        head->getVex()->getOutDegree() != 2 ||
+        body->getLastIR() == nullptr || !body->getLastIR()->is_goto()) {
+        m_am.dump("LOOP%u:unsupported loop shape", li->id());
+        return false;
+    }
+    IRBB * preheader = nullptr;
+    for (xcom::EdgeC const* ec = head->getVex()->getInList();
+         ec != nullptr; ec = ec->get_next()) {
+        if (ec->getFromId() != body->id()) {
+            preheader = m_cfg->getBB(ec->getFromId());
+        }
+    }
+    if (preheader == nullptr || li->isInsideLoop(preheader->id()) ||
+        preheader->getVex()->getOutDegree() != 1 ||
+        m_cfg->getFallThroughBB(preheader) != head ||
+        (preheader->getLastIR() != nullptr &&
+         IRBB::isLowerBoundary(preheader->getLastIR()))) {
+        m_am.dump("LOOP%u:not find proper preheader", li->id());
+        return false;
+    }
+    if (isContainVectorOp(li)) { return false; }
+    vli.head = head;
+    vli.body = body;
+    vli.preheader = preheader;
+    return analyzeHead(vli) && analyzeBody(vli);
+}
+
+
+void Vectorization::collectLoop(
+    LI<IRBB> * li, OUT xcom::List<VectLoopInfo*> & lst)
+{
+    for (LI<IRBB> * x = li; x != nullptr; x = x->get_next()) {
+        if (!x->isInnerMost()) {
+            collectLoop(x->getInnerList(), lst);
+            continue;
+        }
+        VectLoopInfo * vli = new VectLoopInfo(x);
+        if (analyzeLoop(*vli)) {
+            lst.append_tail(vli);
+            continue;
+        }
+        delete vli;
+    }
+}
+
+
+void Vectorization::destroyLoopInfo(xcom::List<VectLoopInfo*> & lst)
+{
+    xcom::List<VectLoopInfo*>::Iter it;
+    for (VectLoopInfo * vli = lst.get_head(&it);
+         vli != nullptr; vli = lst.get_next(&it)) {
+        delete vli;
+    }
+    lst.clean();
+}
+
+
+//Duplicate expression that is outside of the vector loop, and maintain the
+//DU chain of PR.
+IR * Vectorization::dupExp(IR const* exp)
+{
+    IR * n = m_rg->dupIRTree(exp);
+    n->copyRefForTree(exp, m_rg);
+    xoc::addUseForTree(n, exp, m_rg);
+    return n;
+}
+
+
+IR * Vectorization::buildPR(PRNO prno, Type const* ty)
+{
+    IR * pr = m_irmgr->buildPRdedicated(prno, ty);
+    m_rg->getMDMgr()->allocMDForPROp(pr);
+    addOccForRename(pr);
+    return pr;
+}
+
+
+IR * Vectorization::buildStorePR(PRNO prno, Type const* ty, IR * rhs,
+                                 IRBB * bb)
+{
+    IR * stpr = m_irmgr->buildStorePR(prno, ty, rhs);
+    m_rg->getMDMgr()->allocMDForPROp(stpr);
+    addOccForRename(stpr);
+    bb->getIRList().append_tail_ex(stpr);
+    return stpr;
+}
+
+
+//Broadcast scalar 'val' to each element of vector, and return the PR that
+//holds the vector.
+IR * Vectorization::buildSplat(IR * val, Type const* vty, IRBB * bb)
+{
+    ASSERT0(vty->is_vector() && !val->getType()->is_vector());
+    Type const* ety = val->getType();
+    UINT es = m_tm->getDTypeByteSize(vty->getVectorElemDType());
+    UINT num = vty->getVectorElemNum(m_tm);
+    PRNO s = m_irmgr->buildPrno(ety);
+    buildStorePR(s, ety, val, bb);
+    PRNO v = m_irmgr->buildPrno(vty);
+    for (UINT i = 0; i < num; i++) {
+        //All elements will be overwritten, thus the first setelem starts
+        //from zero rather than reading the undefined vector PR.
+        IR * base = i == 0 ? m_irmgr->buildImmAny(0) : buildPR(v, vty);
+        IR * setelem = m_irmgr->buildSetElem(
+            v, vty, base, buildPR(s, ety),
+            m_irmgr->buildImmInt(i * es, m_tm->getU32()));
+        m_rg->getMDMgr()->allocMDForPROp(setelem);
+        addOccForRename(setelem);
+        bb->getIRList().append_tail_ex(setelem);
+    }
+    return buildPR(v, vty);
+}
+
+
+//The function sets the memory reference of vector operation 'vir' that
+//widened from 'org'. The vector access covers the successive elements, thus
+//the exact reference of 'org' is degraded to may-reference.
+void Vectorization::setVecRef(IR * vir, IR const* org)
+{
+    ASSERT0(vir->isIndirectMemOp());
+    MDSet tmp;
+    if (org->getMayRef() != nullptr) {
+        tmp.bunion(*org->getMayRef(), m_sbs_mgr);
+    }
+    if (org->getMustRef() != nullptr) {
+        tmp.bunion(org->getMustRef(), m_sbs_mgr);
+    }
+    vir->cleanRefMD();
+    vir->cleanRefMDSet();
+    if (!tmp.is_empty()) {
+        vir->setMayRef(m_rg->getMDSetHash()->append(tmp), m_rg);
+    }
+    tmp.clean(m_sbs_mgr);
+}
+
+
+PRNO Vectorization::getNewPrno(IR const* pr, VectLoopInfo const& vli)
+{
+    bool find = false;
+    PRNO prno = m_prno2new.get(pr->getPrno(), &find);
+    if (find) { return prno; }
+    Type const* ty = pr->getType();
+    if (vli.prno2kind.get(pr->getPrno()) == VECT_KIND_VEC) {
+        ty = getVecType(vli, ty);
+    }
+    prno = m_irmgr->buildPrno(ty);
+    m_prno2new.set(pr->getPrno(), prno);
+    return prno;
+}
+
+
+//Generate expression in the vector loop for 'exp' that is in loop body.
+//want_vec: true if the parent expects a vector value.
+IR * Vectorization::genExp(IR const* exp, bool want_vec,
+                           VectLoopInfo const& vli)
+{
+    HOST_INT coef = 0;
+    VECT_KIND k = inferKind(exp, vli, coef);
+    if (want_vec && k != VECT_KIND_VEC) {
+        //The invariant is broadcasted once in preheader rather than in
+        //each iteration of vector loop.
+        ASSERT0(k == VECT_KIND_INV);
+        return buildSplat(buildAtInit(exp, vli),
+                          getVecType(vli, exp->getType()), vli.preheader);
+    }
+    if (exp->is_pr()) {
+        IR const* def = exp->getSSAInfo() != nullptr ?
+            exp->getSSAInfo()->getDef() : nullptr;
+        if (def == nullptr || !vli.li->isInsideLoop(def->getBB()->id())) {
+            return dupExp(exp);
+        }
+        Type const* ty = k == VECT_KIND_VEC ?
+            getVecType(vli, exp->getType()) : exp->getType();
+        return buildPR(getNewPrno(exp, vli), ty);
+    }
+    IR * n = m_rg->dupIR(exp);
+    if (k == VECT_KIND_VEC) {
+        n->setType(getVecType(vli, exp->getType()));
+    }
+    for (UINT i = 0; i < exp->getKidNum(); i++) {
+        IR const* kid = exp->getKid(i);
+        if (kid == nullptr) { continue; }
+        //Base of memory operation is always scalar.
+        bool kid_vec = k == VECT_KIND_VEC && kid != exp->getBase();
+        n->setKid(i, genExp(kid, kid_vec, vli));
+    }
+    if (k == VECT_KIND_VEC && n->is_ild()) {
+        setVecRef(n, exp);
+    }
+    return n;
+}
+
+
+void Vectorization::genHead(VectLoopInfo const& vli, PRNO vi, PRNO lim,
+                            IRBB * vhead, LabelInfo const* exit_lab)
+{
+    //The vector loop continues if all the elements are in the iteration
+    //space, namely, $vi + VF - 1 < bound. The comparison is computed as
+    //$vi < $lim, where $lim is bound - (VF - 1), to avoid overflow.
+    Type const* ty = vli.biv_phi->getType();
+    Type const* bty = vli.bound->getType();
+    IR * det = m_irmgr->buildCmp(vli.cmp_code, buildPR(vi, ty),
+                                 buildPR(lim, bty));
+    IR * br = m_irmgr->buildBranch(false, det, exit_lab);
+    copyDbx(br, vli.head->getLastIR(), m_rg);
+    vhead->getIRList().append_tail(br);
+}
+
+
+void Vectorization::genBody(VectLoopInfo const& vli, IRBB * vbody)
+{
+    BBIRListIter it;
+    for (IR * ir = vli.body->getIRList().get_head(&it);
+         ir != nullptr; ir = vli.body->getIRList().get_next(&it)) {
+        IR * newir = nullptr;
+        if (ir->is_goto()) { break; }
+        if (ir == vli.biv_step) {
+            Type const* ty = ir->getType();
+            PRNO vi = m_prno2new.get(PHI_prno(vli.biv_phi));
+            IR * rhs = m_irmgr->buildBinaryOp(IR_ADD, ty, buildPR(vi, ty),
+                m_irmgr->buildImmInt(vli.vf, ty));
+            newir = buildStorePR(vi, ty, rhs, vbody);
+            copyDbx(newir, ir, m_rg);
+            continue;
+        }
+        if (vli.isRedStmt(ir)) {
+            IR * rhs = STPR_rhs(ir);
+            IR * opnd = BIN_opnd0(rhs);
+            if (opnd->is_pr() && opnd->getSSAInfo() != nullptr &&
+                vli.red_phi_list.find(opnd->getSSAInfo()->getDef())) {
+                opnd = BIN_opnd1(rhs);
+            }
+            IR * phi = nullptr;
+            xcom::List<IR*>::Iter pit;
+            for (phi = vli.red_phi_list.get_head(&pit); phi != nullptr;
+                 phi = vli.red_phi_list.get_next(&pit)) {
+                if (vli.getRedStmt(phi) == ir) { break; }
+            }
+            ASSERT0(phi);
+            Type const* vty = getVecType(vli, ir->getType());
+            PRNO acc = m_prno2new.get(PHI_prno(phi));
+            IR * vx = genExp(opnd, true, vli);
+            newir = buildStorePR(acc, vty, m_irmgr->buildBinaryOp(
+                rhs->getCode(), vty, buildPR(acc, vty), vx), vbody);
+            copyDbx(newir, ir, m_rg);
+            continue;
+        }
+        if (ir->is_stpr()) {
+            Type const* ty = ir->getType();
+            VECT_KIND k = vli.prno2kind.get(STPR_no(ir));
+            bool want_vec = k == VECT_KIND_VEC;
+            if (want_vec) { ty = getVecType(vli, ty); }
+            IR * rhs = genExp(STPR_rhs(ir), want_vec, vli);
+            newir = buildStorePR(getNewPrno(ir, vli), ty, rhs, vbody);
+            copyDbx(newir, ir, m_rg);
+            continue;
+        }
+        ASSERT0(ir->is_ist());
+        newir = m_rg->dupIR(ir);
+        newir->setType(getVecType(vli, ir->getType()));
+        newir->setBase(genExp(IST_base(ir), false, vli));
+        newir->setRHS(genExp(IST_rhs(ir), true, vli));
+        setVecRef(newir, ir);
+        vbody->getIRList().append_tail_ex(newir);
+    }
+}
+
+
+void Vectorization::genExit(VectLoopInfo const& vli, PRNO vi, IRBB * vexit)
+{
+    bool is_pred = false;
+    UINT pos = m_cfg->WhichPred(vexit, vli.head, is_pred);
+    ASSERT0(is_pred);
+
+    //Combine the elements of vector accumulator and the initial value.
+    xcom::List<IR*>::Iter it;
+    for (IR * phi = vli.red_phi_list.get_head(&it);
+         phi != nullptr; phi = vli.red_phi_list.get_next(&it)) {
+        Type const* ety = phi->getType();
+        Type const* vty = getVecType(vli, ety);
+        IR_CODE code = STPR_rhs(vli.getRedStmt(phi))->getCode();
+        PRNO acc = m_prno2new.get(PHI_prno(phi));
+        IR * res = dupExp(((CPhi*)phi)->getOpnd(pos));
+        for (UINT i = 0; i < vli.vf; i++) {
+            PRNO e = m_irmgr->buildPrno(ety);
+            IR * getelem = m_irmgr->buildGetElem(e, ety, buildPR(acc, vty),
+                m_irmgr->buildImmInt(i * vli.elem_size, m_tm->getU32()));
+            m_rg->getMDMgr()->allocMDForPROp(getelem);
+            addOccForRename(getelem);
+            vexit->getIRList().append_tail_ex(getelem);
+            res = m_irmgr->buildBinaryOp(code, ety, res, buildPR(e, ety));
+        }
+        PRNO fin = m_irmgr->buildPrno(ety);
+        buildStorePR(fin, ety, res, vexit);
+        replacePhiOpnd(phi, pos, fin);
+    }
+    replacePhiOpnd(vli.biv_phi, pos, vi);
+}
+
+
+void Vectorization::replacePhiOpnd(IR * phi, UINT pos, PRNO prno)
+{
+    IR * old = ((CPhi*)phi)->getOpnd(pos);
+    ASSERT0(old);
+    IR * n = buildPR(prno, phi->getType());
+    ((CPhi*)phi)->insertOpndBefore(old, n);
+    ((CPhi*)phi)->removeOpnd(old);
+    xoc::removeUseForTree(old, m_rg, *m_oc);
+    m_rg->freeIRTree(old);
+}
+
+
+//Evaluate 'exp' at the first iteration of loop, the function generates an
+//isomorphic expression that BIV is substituted by its initial value.
+IR * Vectorization::buildAtInit(IR const* exp, VectLoopInfo const& vli)
+{
+    if (exp->is_pr()) {
+        IR const* def = exp->getSSAInfo() != nullptr ?
+            exp->getSSAInfo()->getDef() : nullptr;
+        if (def == vli.biv_phi) {
+            bool is_pred = false;
+            UINT pos = m_cfg->WhichPred(vli.preheader, vli.head, is_pred);
+            ASSERT0(is_pred);
+            IR * init = dupExp(((CPhi*)def)->getOpnd(pos));
+            if (init->getType() != exp->getType()) {
+                init = m_irmgr->buildCvt(init, exp->getType());
+            }
+            return init;
+        }
+        if (def != nullptr && def->getBB() == vli.body) {
+            ASSERT0(def->is_stpr());
+            return buildAtInit(STPR_rhs(def), vli);
+        }
+        return dupExp(exp);
+    }
+    if (exp->is_leaf()) { return dupExp(exp); }
+    IR * n = m_rg->dupIR(exp);
+    for (UINT i = 0; i < exp->getKidNum(); i++) {
+        IR const* kid = exp->getKid(i);
+        if (kid == nullptr) { continue; }
+        n->setKid(i, buildAtInit(kid, vli));
+    }
+    return n;
+}
+
+
+//Build the condition that the accesses of 'ist' and 'mem' in one vector
+//iteration do not overlap. Let d be the byte distance of the two addresses,
+//and W be the byte size of vector. The vectorization is legal if d is zero,
+//or the absolute value of d is not less than W.
+IR * Vectorization::buildCheck(IR const* ist, IR const* mem,
+                               VectLoopInfo const& vli)
+{
+    Type const* uty = m_tm->getPointerSizeType();
+    IR * a = m_irmgr->buildCvt(buildAtInit(ist->getBase(), vli), uty);
+    IR * b = m_irmgr->buildCvt(buildAtInit(mem->getBase(), vli), uty);
+    IR * d = m_irmgr->buildBinaryOp(IR_SUB, uty, a, b);
+    HOST_INT ofst = (HOST_INT)ist->getOffset() - (HOST_INT)mem->getOffset();
+    if (ofst != 0) {
+        d = m_irmgr->buildBinaryOp(IR_ADD, uty, d,
+                                   m_irmgr->buildImmInt(ofst, uty));
+    }
+    PRNO dist = m_irmgr->buildPrno(uty);
+    buildStorePR(dist, uty, d, vli.preheader);
+    HOST_INT w = (HOST_INT)(vli.vf * vli.elem_size);
+    IR * eq = m_irmgr->buildCmp(IR_EQ, buildPR(dist, uty),
+                                m_irmgr->buildImmInt(0, uty));
+    IR * far = m_irmgr->buildCmp(IR_GT,
+        m_irmgr->buildBinaryOp(IR_ADD, uty, buildPR(dist, uty),
+                               m_irmgr->buildImmInt(w - 1, uty)),
+        m_irmgr->buildImmInt(2 * w - 2, uty));
+    return m_irmgr->buildBinaryOp(IR_LOR, m_tm->getBool(), eq, far);
+}
+
+
+//The function computes the limit of vector loop into 'lim', and returns the
+//determinate expression that is true if 'lim' does not overflow, namely,
+//bound >= VF - 1. Return nullptr if the guard is always true.
+IR * Vectorization::genLimit(VectLoopInfo const& vli, OUT PRNO & lim)
+{
+    Type const* bty = vli.bound->getType();
+    lim = m_irmgr->buildPrno(bty);
+    buildStorePR(lim, bty, m_irmgr->buildBinaryOp(IR_SUB, bty,
+        dupExp(vli.bound), m_irmgr->buildImmInt(vli.vf - 1, bty)),
+        vli.preheader);
+    if (vli.bound->is_const() && vli.bound->is_int() &&
+        CONST_int_val(vli.bound) >= (HOST_INT)(vli.vf - 1)) {
+        return nullptr;
+    }
+    return m_irmgr->buildCmp(IR_GE, dupExp(vli.bound),
+                             m_irmgr->buildImmInt(vli.vf - 1, bty));
+}
+
+
+//The function generates runtime overlap checking in preheader, and returns
+//the determinate expression that is true if vector loop is legal.
+IR * Vectorization::genCheck(VectLoopInfo const& vli)
+{
+    IR * det = nullptr;
+    xcom::List<IR*>::Iter it;
+    for (IR * ist = vli.check_list.get_head(&it);
+         ist != nullptr; ist = vli.check_list.get_next(&it)) {
+        IR * mem = vli.check_list.get_next(&it);
+        ASSERT0(mem);
+        IR * c = buildCheck(ist, mem, vli);
+        det = det == nullptr ? c :
+            m_irmgr->buildBinaryOp(IR_LAND, m_tm->getBool(), det, c);
+    }
+    return det;
+}
+
+
+bool Vectorization::transformLoop(VectLoopInfo const& vli)
+{
+    IRBB * preheader = vli.preheader;
+    Type const* bivty = vli.biv_phi->getType();
+    bool is_pred = false;
+    UINT pos = m_cfg->WhichPred(preheader, vli.head, is_pred);
+    ASSERT0(is_pred);
+
+    //Initialize BIV and accumulators of vector loop in preheader.
+    m_prno2new.clean();
+    PRNO vi = m_irmgr->buildPrno(bivty);
+    m_prno2new.set(PHI_prno(vli.biv_phi), vi);
+    buildStorePR(vi, bivty, dupExp(((CPhi*)vli.biv_phi)->getOpnd(pos)),
+                 preheader);
+    xcom::List<IR*>::Iter it;
+    for (IR * phi = vli.red_phi_list.get_head(&it);
+         phi != nullptr; phi = vli.red_phi_list.get_next(&it)) {
+        Type const* vty = getVecType(vli, phi->getType());
+        PRNO acc = m_irmgr->buildPrno(vty);
+        m_prno2new.set(PHI_prno(phi), acc);
+        IR_CODE code = STPR_rhs(vli.getRedStmt(phi))->getCode();
+        IR * id = m_irmgr->buildImmInt(getRedIdentity(code), phi->getType());
+        buildStorePR(acc, vty, buildSplat(id, vty, preheader), preheader);
+    }
+    PRNO lim = PRNO_UNDEF;
+    IR * check = genLimit(vli, lim);
+    IR * overlap = genCheck(vli);
+    if (overlap != nullptr) {
+        check = check == nullptr ? overlap :
+            m_irmgr->buildBinaryOp(IR_LAND, m_tm->getBool(), check, overlap);
+    }
+
+    //Build vector loop between preheader and loop head:
+    //  preheader -> vhead -> vbody -> vhead
+    //                     -> vexit -> head
+    IRBB * vhead = m_rg->allocBB();
+    IRBB * vbody = m_rg->allocBB();
+    IRBB * vexit = m_rg->allocBB();
+    LabelInfo const* vhead_lab = m_rg->genILabel();
+    LabelInfo const* vexit_lab = m_rg->genILabel();
+    m_cfg->addLabel(vhead, vhead_lab);
+    m_cfg->addLabel(vexit, vexit_lab);
+    m_cfg->insertFallThroughBBAfter(preheader, vexit, m_oc);
+    m_cfg->insertFallThroughBBAfter(preheader, vhead, m_oc);
+    m_cfg->addBB(vbody);
+    BBListIter bbit = nullptr;
+    m_rg->getBBList()->find(vhead, &bbit);
+    ASSERT0(bbit);
+    m_rg->getBBList()->insert_after(vbody, bbit);
+    m_cfg->xcom::DGraph::addEdge(vhead->id(), vbody->id());
+    m_cfg->xcom::DGraph::addEdge(vbody->id(), vhead->id());
+    genHead(vli, vi, lim, vhead, vexit_lab);
+    genBody(vli, vbody);
+    IR * gt = m_irmgr->buildGoto(vhead_lab);
+    vbody->getIRList().append_tail(gt);
+    genExit(vli, vi, vexit);
+    if (check != nullptr) {
+        //Skip the vector loop if the runtime checking failed or the limit
+        //of vector loop overflows.
+        m_cfg->xcom::DGraph::addEdge(preheader->id(), vexit->id());
+        preheader->getIRList().append_tail_ex(
+            m_irmgr->buildBranch(false, check, vexit_lab));
+    }
+
+    //The original loop becomes scalar epilogue, and neither it nor the
+    //vector loop should be vectorized again.
+    m_processed.append(vli.head->id());
+    m_processed.append(vhead->id());
+    m_am.dump("LOOP%u:vectorized with VF %u, vector loop head is BB%u",
+              vli.li->id(), vli.vf, vhead->id());
+    return true;
+}
+
+
+void Vectorization::reconstructSSA(OptCtx & oc)
+{
+    xcom::DomTree domtree;
+    m_cfg->genDomTree(domtree);
+    SSARegion ssarg(&m_sbs_mgr, domtree, m_rg, &oc, &m_am);
+    ssarg.setRootBB(m_cfg->getEntry());
+    ssarg.addAllBBUnderRoot();
+    xcom::List<IR*>::Iter it;
+    for (IR * ir = m_tmp_irs.get_head(&it);
+         ir != nullptr; ir = m_tmp_irs.get_next(&it)) {
+        ssarg.add(ir);
+    }
+    ssarg.inferAndAddRelatedBB();
+    oc.setInvalidLiveness();
+    m_prssamgr->constructDesignatedRegion(ssarg);
+    oc.setInvalidPRDU();
+    m_tmp_irs.clean();
+}
+
+
+bool Vectorization::initDepAna(OptCtx & oc)
+{
+    m_ivr = (IVR*)m_rg->getPassMgr()->registerPass(PASS_IVR);
+    ASSERT0(m_ivr);
+    if (!m_ivr->is_valid()) {
+        m_rg->getPassMgr()->performPass(m_ivr, oc);
+    }
+    m_lda = (LoopDepAna*)m_rg->getPassMgr()->registerPass(PASS_LOOP_DEP_ANA);
+    ASSERT0(m_lda);
+    if (!m_lda->is_valid()) {
+        m_rg->getLogMgr()->tryIncIndent(2);
+        m_rg->getPassMgr()->performPass(m_lda, oc);
+        m_rg->getLogMgr()->tryDecIndent(2);
+    }
+    if (!m_lda->is_valid()) {
+        //Without LoopDepAna, all memory dependences are checked at runtime.
+        m_am.dump("LoopDepAna is unavailable");
+        m_lda = nullptr;
+    }
+    return true;
+}
+
+
+bool Vectorization::dump() const
+{
+    if (!getRegion()->isLogMgrInit() || !g_dump_opt.isDumpVectorization()) {
+        return true;
+    }
+    if (!g_dump_opt.isDumpAfterPass()) { return true; }
+    note(getRegion(), "\n==---- DUMP %s '%s' ----==",
+         getPassName(), m_rg->getRegionName());
+    getRegion()->getLogMgr()->incIndent(2);
+    note(getRegion(), "\nVECTORIZED LOOP:%u", m_vect_loop_num);
+    m_am.dump();
+    bool succ = Pass::dump();
+    getRegion()->getLogMgr()->decIndent(2);
+    return succ;
+}
+
+
+bool Vectorization::perform(OptCtx & oc)
+{
+    BBList * bbl = m_rg->getBBList();
+    if (bbl == nullptr || bbl->get_elem_count() == 0) { return false; }
+    if (getVectorByteSize() == 0) {
+        //Target does not have vector unit.
+        return false;
+    }
+    if (!oc.is_ref_valid()) { return false; }
+    m_prssamgr = m_rg->getPRSSAMgr();
+    if (m_prssamgr == nullptr || !m_prssamgr->is_valid()) {
+        //The pass relies on SSA form to recognize BIV and reduction.
+        return false;
+    }
+    m_mdssamgr = m_rg->getMDSSAMgr();
+    m_oc = &oc;
+    START_TIMER(t, getPassName());
+    m_am.clean();
+    m_vect_loop_num = 0;
+    m_rg->getPassMgr()->checkValidAndRecompute(
+        &oc, PASS_DOM, PASS_RPO, PASS_LOOP_INFO, PASS_UNDEF);
+    if (m_cfg->getLoopInfo() == nullptr) {
+        END_TIMER(t, getPassName());
+        return false;
+    }
+    initDepAna(oc);
+    xcom::List<VectLoopInfo*> lst;
+    collectLoop(m_cfg->getLoopInfo(), lst);
+    if (lst.get_elem_count() == 0) {
+        END_TIMER(t, getPassName());
+        return false;
+    }
+    if (g_dump_opt.isDumpVectorization() && m_rg->isLogMgrInit()) {
+        xcom::List<VectLoopInfo*>::Iter it;
+        for (VectLoopInfo * vli = lst.get_head(&it);
+             vli != nullptr; vli = lst.get_next(&it)) {
+            vli->dump(m_rg);
+        }
+    }
+    bool use_mdssa = useMDSSADU();
+    if (use_mdssa) {
+        //The vector memory operations are inserted without MDSSA info,
+        //MDSSA will be rebuilt after the transformation.
+        m_mdssamgr->destruction(oc);
+    }
+    xcom::List<VectLoopInfo*>::Iter it;
+    for (VectLoopInfo * vli = lst.get_head(&it);
+         vli != nullptr; vli = lst.get_next(&it)) {
+        if (transformLoop(*vli)) { m_vect_loop_num++; }
+    }
+    destroyLoopInfo(lst);
+    oc.setInvalidIfCFGChanged();
+    m_rg->getPassMgr()->checkValidAndRecompute(
+        &oc, PASS_DOM, PASS_RPO, PASS_UNDEF);
+    reconstructSSA(oc);
+    if (use_mdssa) {
+        m_mdssamgr->construction(oc);
+        oc.setInvalidIfMDSSAReconstructed();
+    }
+    oc.setInvalidNonPRDU();
+    oc.setInvalidIfDUMgrLiveChanged();
+    oc.setInvalidPass(PASS_IVR);
+    oc.setInvalidPass(PASS_LOOP_DEP_ANA);
+    oc.setInvalidPass(PASS_GVN);
+    dump();
+    ASSERT0(m_cfg->verify());
+    ASSERT0(PRSSAMgr::verifyPRSSAInfo(m_rg, oc));
+    ASSERT0(!use_mdssa || MDSSAMgr::verifyMDSSAInfo(m_rg, oc));
+    ASSERT0(verifyIRandBB(m_rg->getBBList(), m_rg));
+    END_TIMER(t, getPassName());
+    return true;
+}
+//END Vectorization
+
+} //namespace xoc
@@ -0,0 +1,228 @@
+/*@
+XOC Release License
+
+Copyright (c) 2013-2014, Alibaba Group, All rights reserved.
+
+    compiler@aliexpress.com
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Su Zhenyu nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+author: Su Zhenyu
+@*/
+#ifndef _IR_VECT_H_
+#define _IR_VECT_H_
+
+namespace xoc {
+
+class LoopDepAna;
+class IVR;
+
+//The kind of value that computed in loop body.
+typedef enum {
+    VECT_KIND_UNDEF = 0,
+
+    //The value is loop invariant.
+    VECT_KIND_INV,
+
+    //The value is an affine function of BIV, the coefficient is recorded
+    //in VectLoopInfo.
+    VECT_KIND_AFF,
+
+    //The value varies in each iteration but is neither affine nor
+    //widened, e.g: computation that only feeds another scalar computation.
+    VECT_KIND_SCALAR,
+
+    //The value will be widened to vector type.
+    VECT_KIND_VEC,
+} VECT_KIND;
+
+
+//The class records the analysis result of a loop that can be vectorized.
+//The loop must be in the following shape:
+//  preheader:
+//    ...
+//  head:
+//    $i = phi($init, $inext); #BIV
+//    $r = phi($rinit, $rnext); #reduction, optional
+//    falsebr (lt $i, $bound), L_EXIT;
+//  body:
+//    ... #straight-line code
+//    $rnext = add $r, ...;
+//    $inext = add $i, 1;
+//    goto head;
+class VectLoopInfo {
+    COPY_CONSTRUCTOR(VectLoopInfo);
+public:
+    LI<IRBB> const* li;
+    IRBB * preheader;
+    IRBB * head;
+    IRBB * body;
+    IR * biv_phi; //the PHI of basic induction variable.
+    IR * biv_step; //the stmt that increases BIV by one.
+    IR * bound; //the loop invariant upper bound of BIV.
+    IR_CODE cmp_code; //IR_LT or IR_LE, the comparison to stay in loop.
+    UINT vf; //vectorization factor.
+    UINT elem_size; //byte size of vector element.
+    xcom::List<IR*> red_phi_list; //PHIs of reduction variables.
+    xcom::List<IR*> red_stmt_list; //reduction stmts, one for each PHI.
+
+    //Pairs of memory operations that need runtime overlap checking.
+    //The list is organized as [ist0, mem0, ist1, mem1, ...].
+    xcom::List<IR*> check_list;
+    xcom::TMap<PRNO, VECT_KIND> prno2kind;
+    xcom::TMap<PRNO, HOST_INT> prno2coef;
+public:
+    VectLoopInfo(LI<IRBB> const* l) :
+        li(l), preheader(nullptr), head(nullptr), body(nullptr),
+        biv_phi(nullptr), biv_step(nullptr), bound(nullptr),
+        cmp_code(IR_UNDEF), vf(0), elem_size(0) {}
+
+    void dump(Region const* rg) const;
+
+    //Return the reduction stmt that corresponds to 'phi'.
+    IR * getRedStmt(IR const* phi) const;
+
+    //Return true if 'ir' is one of the reduction stmts.
+    bool isRedStmt(IR const* ir) const
+    { return red_stmt_list.find(const_cast<IR*>(ir)); }
+};
+
+
+//This class represents loop vectorization.
+//The pass widens the straight-line body of innermost loop into vector
+//operations by TypeMgr's vector type. Memory dependence is determined by
+//LoopDepAna, and the dependence that can not be disproved at compile time is
+//checked at runtime in preheader. Reductions that LoopDepAna marked as
+//LOOP_DEP_REDUCE are accumulated in vector PR and combined after the
+//vector loop. The original loop is kept as scalar epilogue that executes the
+//remaining iterations.
+class Vectorization : public Pass {
+    COPY_CONSTRUCTOR(Vectorization);
+    bool m_is_aggressive;
+    UINT m_vect_loop_num; //the number of vectorized loops.
+    IRCFG * m_cfg;
+    TypeMgr * m_tm;
+    IRMgr * m_irmgr;
+    PRSSAMgr * m_prssamgr;
+    MDSSAMgr * m_mdssamgr;
+    IVR * m_ivr;
+    LoopDepAna * m_lda;
+    OptCtx * m_oc;
+    xcom::DefMiscBitSetMgr m_sbs_mgr;
+    ActMgr m_am;
+
+    //Record the id of loop head BB that has been vectorized or generated.
+    //The scalar epilogue and the vector loop should not be handled again.
+    xcom::TTab<UINT> m_processed;
+
+    //Record PR operations that need to be renamed after transformation.
+    xcom::List<IR*> m_tmp_irs;
+
+    //Map PRNO of loop body to the PRNO of vector loop body.
+    xcom::TMap<PRNO, PRNO> m_prno2new;
+protected:
+    void addOccForRename(IR * ir) { m_tmp_irs.append_tail(ir); }
+
+    bool analyzeBody(MOD VectLoopInfo & vli);
+    bool analyzeHead(MOD VectLoopInfo & vli);
+    bool analyzeLoop(MOD VectLoopInfo & vli);
+    bool analyzeMemDep(xcom::List<IR*> const& memops,
+                       MOD VectLoopInfo & vli);
+    bool analyzeRed(IR * phi, MOD VectLoopInfo & vli);
+    bool analyzeStmt(IR * ir, OUT xcom::List<IR*> & memops,
+                     MOD VectLoopInfo & vli);
+
+    IR * buildAtInit(IR const* exp, VectLoopInfo const& vli);
+    IR * buildCheck(IR const* ist, IR const* mem, VectLoopInfo const& vli);
+    IR * buildPR(PRNO prno, Type const* ty);
+    IR * buildSplat(IR * val, Type const* vty, IRBB * bb);
+    IR * buildStorePR(PRNO prno, Type const* ty, IR * rhs, IRBB * bb);
+
+    void collectLoop(LI<IRBB> * li, OUT xcom::List<VectLoopInfo*> & lst);
+
+    void destroyLoopInfo(xcom::List<VectLoopInfo*> & lst);
+    IR * dupExp(IR const* exp);
+
+    IR * genExp(IR const* exp, bool want_vec, VectLoopInfo const& vli);
+    void genBody(VectLoopInfo const& vli, IRBB * vbody);
+    IR * genCheck(VectLoopInfo const& vli);
+    void genHead(VectLoopInfo const& vli, PRNO vi, PRNO lim, IRBB * vhead,
+                 LabelInfo const* exit_lab);
+    IR * genLimit(VectLoopInfo const& vli, OUT PRNO & lim);
+    void genExit(VectLoopInfo const& vli, PRNO vi, IRBB * vexit);
+    Type const* getVecType(VectLoopInfo const& vli, Type const* ety) const;
+    PRNO getNewPrno(IR const* pr, VectLoopInfo const& vli);
+    HOST_INT getRedIdentity(IR_CODE code) const;
+
+    VECT_KIND inferKind(IR const* exp, VectLoopInfo const& vli,
+                        OUT HOST_INT & coef) const;
+    VECT_KIND inferBinKind(IR const* exp, VectLoopInfo const& vli,
+                           OUT HOST_INT & coef) const;
+    VECT_KIND inferPRKind(IR const* exp, VectLoopInfo const& vli,
+                          OUT HOST_INT & coef) const;
+    bool isBIVStep(IR const* stmt, IR const* phi) const;
+    bool isContainVectorOp(LI<IRBB> const* li) const;
+    bool isVectorizableOp(IR const* exp) const;
+    bool isVectorizableType(Type const* ty, MOD VectLoopInfo & vli) const;
+    bool isUsedOnlyBy(IR const* def, IR const* user) const;
+    bool isUsedOnceInLoop(IR const* def, IR const* user,
+                          LI<IRBB> const* li) const;
+    bool initDepAna(OptCtx & oc);
+
+    void replacePhiOpnd(IR * phi, UINT pos, PRNO prno);
+    void reconstructSSA(OptCtx & oc);
+    void setVecRef(IR * vir, IR const* org);
+
+    bool transformLoop(VectLoopInfo const& vli);
+    bool useMDSSADU() const
+    { return m_mdssamgr != nullptr && m_mdssamgr->is_valid(); }
+public:
+    explicit Vectorization(Region * rg);
+    virtual ~Vectorization() {}
+
+    virtual bool dump() const;
+
+    virtual CHAR const* getPassName() const { return "Vectorization"; }
+    PASS_TYPE getPassType() const { return PASS_VECT; }
+    ActMgr & getActMgr() { return m_am; }
+
+    //Target Dependent Code.
+    //Return the byte size of target vector register, which is
+    //g_vect_reg_byte_size by default.
+    //Return 0 if target does not have vector unit, and the pass does
+    //nothing in that case.
+    virtual UINT getVectorByteSize() const;
+
+    //Return true if user ask to perform aggressive optimization that without
+    //consideration of compilation time and memory.
+    bool is_aggressive() const { return m_is_aggressive; }
+
+    virtual bool perform(OptCtx & oc);
+
+    void setAggressive(bool doit) { m_is_aggressive = doit; }
+};
+
+} //namespace xoc
+#endif
@@ -0,0 +1,1149 @@
+/*@
+XOC Release License
+
+Copyright (c) 2013-2014, Alibaba Group, All rights reserved.
+
+    compiler@aliexpress.com
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Su Zhenyu nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+author: Su Zhenyu
+@*/
+#include "cominc.h"
+#include "comopt.h"
+
+namespace xoc {
+
+//The range of PR will be widened if it has been enlarged more than the
+//number of times.
+#define VRP_WIDEN_THRESHOLD 3
+
+//The maximum depth of dominator tree that VRP walks through to find the
+//branch conditions that narrow the range of PR.
+#define VRP_MAX_DOM_DEPTH 8
+
+//The number of narrowing iterations after the fixed point reached.
+#define VRP_NARROW_ITER_NUM 2
+
+#define VRP_HOST_INT_BIT_SIZE ((UINT)(sizeof(HOST_INT) * BIT_PER_BYTE))
+#define VRP_HOST_INT_MAX \
+    ((HOST_INT)((((ULONGLONG)1) << (VRP_HOST_INT_BIT_SIZE - 1)) - 1))
+#define VRP_HOST_INT_MIN (-VRP_HOST_INT_MAX - 1)
+
+//Return true if a+b overflowed HOST_INT, otherwise record the sum in 'res'.
+static bool addOverflow(HOST_INT a, HOST_INT b, OUT HOST_INT & res)
+{
+    if ((b > 0 && a > VRP_HOST_INT_MAX - b) ||
+        (b < 0 && a < VRP_HOST_INT_MIN - b)) {
+        return true;
+    }
+    res = a + b;
+    return false;
+}
+
+
+//Return true if a-b overflowed HOST_INT, otherwise record the difference in
+//'res'.
+static bool subOverflow(HOST_INT a, HOST_INT b, OUT HOST_INT & res)
+{
+    if ((b < 0 && a > VRP_HOST_INT_MAX + b) ||
+        (b > 0 && a < VRP_HOST_INT_MIN + b)) {
+        return true;
+    }
+    res = a - b;
+    return false;
+}
+
+
+//Return true if a*b overflowed HOST_INT, otherwise record the product in
+//'res'.
+static bool mulOverflow(HOST_INT a, HOST_INT b, OUT HOST_INT & res)
+{
+    if (a == 0 || b == 0) { res = 0; return false; }
+    if ((a == -1 && b == VRP_HOST_INT_MIN) ||
+        (b == -1 && a == VRP_HOST_INT_MIN)) {
+        return true;
+    }
+    HOST_INT r = (HOST_INT)((ULONGLONG)a * (ULONGLONG)b);
+    if (r / b != a) { return true; }
+    res = r;
+    return false;
+}
+
+
+//Return the smallest number that all bits are one and not less than 'v'.
+static HOST_INT getAllOnesCover(HOST_INT v)
+{
+    ASSERT0(v >= 0);
+    HOST_INT r = 0;
+    while (r < v) { r = (r << 1) | 1; }
+    return r;
+}
+
+
+static bool isMustZero(ValueRange const& vr)
+{
+    return vr.is_const() && vr.getLow() == 0;
+}
+
+
+static bool isMustNonZero(ValueRange const& vr)
+{
+    return vr.is_range() && (vr.getLow() > 0 || vr.getHigh() < 0);
+}
+
+
+//Return the comparison code after the operands are swapped.
+static IR_CODE swapCompareOpnd(IR_CODE code)
+{
+    switch (code) {
+    case IR_LT: return IR_GT;
+    case IR_LE: return IR_GE;
+    case IR_GT: return IR_LT;
+    case IR_GE: return IR_LE;
+    case IR_EQ:
+    case IR_NE: return code;
+    default: UNREACHABLE();
+    }
+    return IR_UNDEF;
+}
+
+
+static UINT64 genEdgeKey(UINT from, UINT to)
+{
+    return (((UINT64)from) << 32) | (UINT64)to;
+}
+
+
+//
+//START ValueRange
+//
+bool ValueRange::isContain(ValueRange const& src) const
+{
+    if (src.is_undef() || is_varying()) { return true; }
+    if (src.is_varying() || is_undef()) { return false; }
+    return m_low <= src.m_low && src.m_high <= m_high;
+}
+
+
+bool ValueRange::is_equal(ValueRange const& src) const
+{
+    if (m_kind != src.m_kind) { return false; }
+    if (!is_range()) { return true; }
+    return m_low == src.m_low && m_high == src.m_high;
+}
+
+
+void ValueRange::intersect(HOST_INT low, HOST_INT high)
+{
+    if (is_undef()) { return; }
+    if (is_varying()) {
+        if (low > high) { setUndef(); return; }
+        setRange(low, high);
+        return;
+    }
+    HOST_INT l = MAX(m_low, low);
+    HOST_INT h = MIN(m_high, high);
+    if (l > h) { setUndef(); return; }
+    setRange(l, h);
+}
+
+
+void ValueRange::intersect(ValueRange const& src)
+{
+    if (src.is_varying() || is_undef()) { return; }
+    if (src.is_undef()) { setUndef(); return; }
+    intersect(src.m_low, src.m_high);
+}
+
+
+void ValueRange::unionRange(ValueRange const& src)
+{
+    if (src.is_undef() || is_varying()) { return; }
+    if (src.is_varying() || is_undef()) { copy(src); return; }
+    setRange(MIN(m_low, src.m_low), MAX(m_high, src.m_high));
+}
+
+
+CHAR const* ValueRange::dumpBuf(OUT xcom::StrBuf & buf) const
+{
+    switch (m_kind) {
+    case VR_UNDEF: buf.strcat("undef"); break;
+    case VR_VARYING: buf.strcat("varying"); break;
+    case VR_RANGE:
+        buf.strcat("[%lld,%lld]", (LONGLONG)m_low, (LONGLONG)m_high);
+        break;
+    default: UNREACHABLE();
+    }
+    return buf.buf;
+}
+
+
+void ValueRange::dump(Region const* rg) const
+{
+    if (!rg->isLogMgrInit()) { return; }
+    xcom::StrBuf buf(16);
+    prt(rg, "%s", dumpBuf(buf));
+}
+//END ValueRange
+
+
+//
+//START VRP
+//
+VRP::VRP(Region * rg) : Pass(rg), m_am(rg)
+{
+    ASSERT0(rg);
+    m_cfg = rg->getCFG();
+    m_tm = rg->getTypeMgr();
+    m_prssamgr = nullptr;
+    m_ivr = nullptr;
+    m_oc = nullptr;
+    m_pool = nullptr;
+}
+
+
+void VRP::destroy()
+{
+    if (m_pool == nullptr) { return; }
+    smpoolDelete(m_pool);
+    m_pool = nullptr;
+}
+
+
+void VRP::reset()
+{
+    destroy();
+    m_pool = smpoolCreate(sizeof(ValueRange) * 8, MEM_CONST_SIZE);
+    m_prno2vr.clean();
+    m_prno2thres.clean();
+    m_exec_bb.clean();
+    m_exec_edge.clean();
+    m_in_stmt_wl.clean();
+    m_bb_wl.clean();
+    m_stmt_wl.clean();
+    m_am.clean();
+}
+
+
+ValueRange * VRP::genVR(PRNO prno)
+{
+    ValueRange * vr = m_prno2vr.get(prno);
+    if (vr != nullptr) { return vr; }
+    vr = (ValueRange*)smpoolMallocConstSize(sizeof(ValueRange), m_pool);
+    vr->clean();
+    m_prno2vr.set(prno, vr);
+    return vr;
+}
+
+
+bool VRP::getTypeRange(Type const* ty, OUT HOST_INT & low,
+                       OUT HOST_INT & high) const
+{
+    ASSERT0(ty);
+    if (ty->is_bool()) { low = 0; high = 1; return true; }
+    if (!ty->is_int()) { return false; }
+    UINT bitsize = m_tm->getByteSize(ty) * BIT_PER_BYTE;
+    if (bitsize == 0) { return false; }
+    if (ty->is_signed()) {
+        if (bitsize > VRP_HOST_INT_BIT_SIZE) { return false; }
+        if (bitsize == VRP_HOST_INT_BIT_SIZE) {
+            low = VRP_HOST_INT_MIN;
+            high = VRP_HOST_INT_MAX;
+            return true;
+        }
+        high = (HOST_INT)((((ULONGLONG)1) << (bitsize - 1)) - 1);
+        low = -high - 1;
+        return true;
+    }
+    //The unsigned integer that occupied all bits of HOST_INT can not be
+    //represented.
+    if (bitsize >= VRP_HOST_INT_BIT_SIZE) { return false; }
+    low = 0;
+    high = (HOST_INT)((((ULONGLONG)1) << bitsize) - 1);
+    return true;
+}
+
+
+void VRP::genTypeRange(Type const* ty, OUT ValueRange & vr) const
+{
+    HOST_INT low, high;
+    if (!getTypeRange(ty, low, high)) { vr.setVarying(); return; }
+    vr.setRange(low, high);
+}
+
+
+void VRP::limitToType(Type const* ty, MOD ValueRange & vr) const
+{
+    if (vr.is_undef()) { return; }
+    HOST_INT low, high;
+    if (!getTypeRange(ty, low, high)) { vr.setVarying(); return; }
+    if (vr.is_varying() || vr.getLow() < low || vr.getHigh() > high) {
+        //The value may be wrapped around.
+        vr.setRange(low, high);
+    }
+}
+
+
+bool VRP::isEdgeExec(UINT from, UINT to) const
+{
+    return m_exec_edge.find(genEdgeKey(from, to));
+}
+
+
+bool VRP::isComparable(IR const* op0, IR const* op1, ValueRange const& r0,
+                       ValueRange const& r1) const
+{
+    if (!r0.is_range() || !r1.is_range()) { return false; }
+    if (op0->getType()->is_signed() == op1->getType()->is_signed()) {
+        return true;
+    }
+    //The comparison of operands with different signedness is decidable
+    //only if both of them are non-negative.
+    return r0.isNonNeg() && r1.isNonNeg();
+}
+
+
+void VRP::applyEdgeCond(PRNO prno, IRBB const* from, IRBB const* to,
+                        MOD ValueRange & vr) const
+{
+    IR const* br = const_cast<IRBB*>(from)->getLastIR();
+    if (br == nullptr || !br->isConditionalBr()) { return; }
+    IRBB const* tgt = m_cfg->findBBbyLabel(BR_lab(br));
+    IRBB const* ft = m_cfg->getFallThroughBB(from);
+    if (tgt == ft) { return; }
+    bool taken = false;
+    if (to == tgt) {
+        taken = true;
+    } else if (to != ft) {
+        return;
+    }
+    bool is_true = br->is_truebr() ? taken : !taken;
+    narrowByCond(prno, BR_det(br), is_true, vr);
+}
+
+
+void VRP::narrowByCond(PRNO prno, IR const* det, bool is_true,
+                       MOD ValueRange & vr) const
+{
+    switch (det->getCode()) {
+    case IR_LAND:
+        if (is_true) {
+            narrowByCond(prno, BIN_opnd0(det), true, vr);
+            narrowByCond(prno, BIN_opnd1(det), true, vr);
+        }
+        return;
+    case IR_LOR:
+        if (!is_true) {
+            narrowByCond(prno, BIN_opnd0(det), false, vr);
+            narrowByCond(prno, BIN_opnd1(det), false, vr);
+        }
+        return;
+    case IR_LNOT:
+        narrowByCond(prno, UNA_opnd(det), !is_true, vr);
+        return;
+    SWITCH_CASE_COMPARE:
+        break;
+    default: return;
+    }
+    if (!vr.is_range()) { return; }
+    IR const* op0 = BIN_opnd0(det);
+    IR const* op1 = BIN_opnd1(det);
+    IR_CODE code = det->getCode();
+    IR const* bound = nullptr;
+    if (op0->is_pr() && op0->getPrno() == prno) {
+        bound = op1;
+    } else if (op1->is_pr() && op1->getPrno() == prno) {
+        bound = op0;
+        code = swapCompareOpnd(code);
+    } else {
+        return;
+    }
+    if (bound->is_pr() && bound->getPrno() == prno) { return; }
+    if (!is_true) { code = IR::invertIRCode(code); }
+    ValueRange bvr;
+    evalExp(bound, nullptr, nullptr, bvr);
+    if (!isComparable(op0, op1, vr, bvr)) { return; }
+    switch (code) {
+    case IR_LT:
+        if (bvr.getHigh() == VRP_HOST_INT_MIN) { vr.setUndef(); return; }
+        vr.intersect(VRP_HOST_INT_MIN, bvr.getHigh() - 1);
+        return;
+    case IR_LE:
+        vr.intersect(VRP_HOST_INT_MIN, bvr.getHigh());
+        return;
+    case IR_GT:
+        if (bvr.getLow() == VRP_HOST_INT_MAX) { vr.setUndef(); return; }
+        vr.intersect(bvr.getLow() + 1, VRP_HOST_INT_MAX);
+        return;
+    case IR_GE:
+        vr.intersect(bvr.getLow(), VRP_HOST_INT_MAX);
+        return;
+    case IR_EQ:
+        vr.intersect(bvr);
+        return;
+    case IR_NE: {
+        if (!bvr.is_const()) { return; }
+        HOST_INT c = bvr.getLow();
+        if (vr.is_const() && vr.getLow() == c) { vr.setUndef(); return; }
+        if (vr.getLow() == c) {
+            vr.setRange(c + 1, vr.getHigh());
+        } else if (vr.getHigh() == c) {
+            vr.setRange(vr.getLow(), c - 1);
+        }
+        return;
+    }
+    default: UNREACHABLE();
+    }
+}
+
+
+void VRP::narrowByDomCond(PRNO prno, IRBB const* bb, IRBB const* succ,
+                          MOD ValueRange & vr) const
+{
+    if (succ != nullptr) { applyEdgeCond(prno, bb, succ, vr); }
+    IRBB const* cur = bb;
+    for (UINT i = 0; i < VRP_MAX_DOM_DEPTH && vr.is_range(); i++) {
+        xcom::Vertex const* v = cur->getVex();
+        if (v->getInDegree() == 1) {
+            //The unique predecessor must be the idom of 'cur'.
+            IRBB const* pred = m_cfg->getBB(v->getInList()->getFromId());
+            ASSERT0(pred);
+            applyEdgeCond(prno, pred, cur, vr);
+        }
+        VexIdx idom = ((xcom::DGraph*)m_cfg)->get_idom(cur->id());
+        if (idom == VERTEX_UNDEF || idom == (VexIdx)cur->id()) { break; }
+        cur = m_cfg->getBB(idom);
+        if (cur == nullptr) { break; }
+    }
+}
+
+
+void VRP::evalPR(IR const* ir, IRBB const* bb, IRBB const* succ,
+                 OUT ValueRange & vr) const
+{
+    ASSERT0(ir->is_pr());
+    HOST_INT low, high;
+    if (!getTypeRange(ir->getType(), low, high)) { vr.setVarying(); return; }
+    ValueRange const* prvr = getRange(ir->getPrno());
+    if (prvr == nullptr || prvr->is_undef()) {
+        SSAInfo const* ssainfo = ir->getSSAInfo();
+        if (ssainfo == nullptr || ssainfo->getDef() == nullptr) {
+            //PR does not have definition, e.g: parameter PR.
+            vr.setRange(low, high);
+            return;
+        }
+        //The definition has not been evaluated or it is unreachable.
+        vr.setUndef();
+        return;
+    }
+    vr.copy(*prvr);
+    limitToType(ir->getType(), vr);
+    if (bb != nullptr) {
+        narrowByDomCond(ir->getPrno(), bb, succ, vr);
+    }
+}
+
+
+void VRP::evalUnary(IR const* ir, IRBB const* bb, OUT ValueRange & vr) const
+{
+    ValueRange r;
+    evalExp(UNA_opnd(ir), bb, nullptr, r);
+    if (r.is_undef()) { vr.setUndef(); return; }
+    genTypeRange(ir->getType(), vr);
+    if (!vr.is_range() || !r.is_range()) { return; }
+    HOST_INT l = 0;
+    HOST_INT h = 0;
+    switch (ir->getCode()) {
+    case IR_NEG:
+        if (r.getLow() == VRP_HOST_INT_MIN) { return; }
+        l = -r.getHigh();
+        h = -r.getLow();
+        break;
+    case IR_BNOT:
+        //~x is equal to -x-1.
+        l = ~r.getHigh();
+        h = ~r.getLow();
+        break;
+    default: return;
+    }
+    vr.setRange(l, h);
+    limitToType(ir->getType(), vr);
+}
+
+
+void VRP::evalBin(IR const* ir, IRBB const* bb, OUT ValueRange & vr) const
+{
+    ValueRange r0;
+    ValueRange r1;
+    evalExp(BIN_opnd0(ir), bb, nullptr, r0);
+    evalExp(BIN_opnd1(ir), bb, nullptr, r1);
+    if (r0.is_undef() || r1.is_undef()) { vr.setUndef(); return; }
+    genTypeRange(ir->getType(), vr);
+    if (!vr.is_range() || !r0.is_range() || !r1.is_range()) { return; }
+    HOST_INT l0 = r0.getLow();
+    HOST_INT h0 = r0.getHigh();
+    HOST_INT l1 = r1.getLow();
+    HOST_INT h1 = r1.getHigh();
+    HOST_INT l = 0;
+    HOST_INT h = 0;
+    switch (ir->getCode()) {
+    case IR_ADD:
+        if (addOverflow(l0, l1, l) || addOverflow(h0, h1, h)) { return; }
+        break;
+    case IR_SUB:
+        if (subOverflow(l0, h1, l) || subOverflow(h0, l1, h)) { return; }
+        break;
+    case IR_MUL: {
+        HOST_INT p0, p1, p2, p3;
+        if (mulOverflow(l0, l1, p0) || mulOverflow(l0, h1, p1) ||
+            mulOverflow(h0, l1, p2) || mulOverflow(h0, h1, p3)) {
+            return;
+        }
+        l = MIN(MIN(p0, p1), MIN(p2, p3));
+        h = MAX(MAX(p0, p1), MAX(p2, p3));
+        break;
+    }
+    case IR_DIV:
+        //Divisor may be zero or negative.
+        if (l1 <= 0) { return; }
+        l = MIN(l0 / l1, l0 / h1);
+        h = MAX(h0 / l1, h0 / h1);
+        break;
+    case IR_REM:
+        if (l1 <= 0) { return; }
+        //The sign of remainder is same as dividend.
+        l = l0 >= 0 ? 0 : MAX(l0, -(h1 - 1));
+        h = h0 <= 0 ? 0 : MIN(h0, h1 - 1);
+        break;
+    case IR_MOD:
+        if (l1 <= 0 || l0 < 0) { return; }
+        l = 0;
+        h = MIN(h0, h1 - 1);
+        break;
+    case IR_BAND:
+        if (l0 >= 0 && l1 >= 0) {
+            l = 0;
+            h = MIN(h0, h1);
+        } else if (l0 >= 0) {
+            l = 0;
+            h = h0;
+        } else if (l1 >= 0) {
+            l = 0;
+            h = h1;
+        } else {
+            return;
+        }
+        break;
+    case IR_BOR:
+    case IR_XOR:
+        if (l0 < 0 || l1 < 0) { return; }
+        l = ir->is_bor() ? MAX(l0, l1) : 0;
+        h = getAllOnesCover(MAX(h0, h1));
+        break;
+    case IR_LSL: {
+        if (!r1.is_const() || l1 < 0 ||
+            l1 >= (HOST_INT)VRP_HOST_INT_BIT_SIZE - 1) {
+            return;
+        }
+        HOST_INT f = ((HOST_INT)1) << l1;
+        if (mulOverflow(l0, f, l) || mulOverflow(h0, f, h)) { return; }
+        break;
+    }
+    case IR_ASR:
+    case IR_LSR:
+        if (l0 < 0 || l1 < 0 || h1 >= (HOST_INT)VRP_HOST_INT_BIT_SIZE) {
+            return;
+        }
+        l = l0 >> h1;
+        h = h0 >> l1;
+        break;
+    default: return;
+    }
+    vr.setRange(l, h);
+    limitToType(ir->getType(), vr);
+}
+
+
+void VRP::evalCompare(IR_CODE code, IR const* op0, IR const* op1,
+                      IRBB const* bb, OUT ValueRange & vr) const
+{
+    ValueRange r0;
+    ValueRange r1;
+    evalExp(op0, bb, nullptr, r0);
+    evalExp(op1, bb, nullptr, r1);
+    if (r0.is_undef() || r1.is_undef()) { vr.setUndef(); return; }
+    vr.setRange(0, 1);
+    if (!isComparable(op0, op1, r0, r1)) { return; }
+    HOST_INT l0 = r0.getLow();
+    HOST_INT h0 = r0.getHigh();
+    HOST_INT l1 = r1.getLow();
+    HOST_INT h1 = r1.getHigh();
+    bool must_true = false;
+    bool must_false = false;
+    switch (code) {
+    case IR_LT: must_true = h0 < l1; must_false = l0 >= h1; break;
+    case IR_LE: must_true = h0 <= l1; must_false = l0 > h1; break;
+    case IR_GT: must_true = l0 > h1; must_false = h0 <= l1; break;
+    case IR_GE: must_true = l0 >= h1; must_false = h0 < l1; break;
+    case IR_EQ:
+    case IR_NE: {
+        bool must_equal = r0.is_const() && r1.is_const() && l0 == l1;
+        bool must_unequal = h0 < l1 || h1 < l0;
+        must_true = code == IR_EQ ? must_equal : must_unequal;
+        must_false = code == IR_EQ ? must_unequal : must_equal;
+        break;
+    }
+    default: UNREACHABLE();
+    }
+    if (must_true) {
+        vr.setRange(1, 1);
+    } else if (must_false) {
+        vr.setRange(0, 0);
+    }
+}
+
+
+void VRP::evalLogic(IR const* ir, IRBB const* bb, OUT ValueRange & vr) const
+{
+    ValueRange r0;
+    evalExp(ir->is_lnot() ? UNA_opnd(ir) : BIN_opnd0(ir), bb, nullptr, r0);
+    if (r0.is_undef()) { vr.setUndef(); return; }
+    vr.setRange(0, 1);
+    if (ir->is_lnot()) {
+        if (isMustNonZero(r0)) {
+            vr.setRange(0, 0);
+        } else if (isMustZero(r0)) {
+            vr.setRange(1, 1);
+        }
+        limitToType(ir->getType(), vr);
+        return;
+    }
+    ValueRange r1;
+    evalExp(BIN_opnd1(ir), bb, nullptr, r1);
+    if (r1.is_undef()) { vr.setUndef(); return; }
+    if (ir->is_land()) {
+        if (isMustZero(r0) || isMustZero(r1)) {
+            vr.setRange(0, 0);
+        } else if (isMustNonZero(r0) && isMustNonZero(r1)) {
+            vr.setRange(1, 1);
+        }
+    } else {
+        ASSERT0(ir->is_lor());
+        if (isMustNonZero(r0) || isMustNonZero(r1)) {
+            vr.setRange(1, 1);
+        } else if (isMustZero(r0) && isMustZero(r1)) {
+            vr.setRange(0, 0);
+        }
+    }
+    limitToType(ir->getType(), vr);
+}
+
+
+void VRP::evalCvt(IR const* ir, IRBB const* bb, OUT ValueRange & vr) const
+{
+    evalExp(CVT_exp(ir), bb, nullptr, vr);
+    if (vr.is_undef()) { return; }
+    //The value is kept if it can be represented in target type, otherwise
+    //the result might be any value of target type.
+    limitToType(ir->getType(), vr);
+}
+
+
+void VRP::evalExp(IR const* ir, IRBB const* bb, IRBB const* succ,
+                  OUT ValueRange & vr) const
+{
+    ASSERT0(ir->is_exp());
+    switch (ir->getCode()) {
+    case IR_CONST: {
+        HOST_INT low, high;
+        if (!ir->is_int() || !getTypeRange(ir->getType(), low, high)) {
+            vr.setVarying();
+            return;
+        }
+        HOST_INT v = CONST_int_val(ir);
+        if (v < low || v > high) {
+            //The constant is not normalized to its type.
+            vr.setRange(low, high);
+            return;
+        }
+        vr.setRange(v, v);
+        return;
+    }
+    case IR_PR:
+        evalPR(ir, bb, succ, vr);
+        return;
+    case IR_ADD:
+    case IR_SUB:
+    case IR_MUL:
+    case IR_DIV:
+    case IR_REM:
+    case IR_MOD:
+    SWITCH_CASE_BITWISE_BIN:
+    SWITCH_CASE_SHIFT:
+        evalBin(ir, bb, vr);
+        return;
+    case IR_NEG:
+    case IR_BNOT:
+        evalUnary(ir, bb, vr);
+        return;
+    SWITCH_CASE_COMPARE:
+        evalCompare(ir->getCode(), BIN_opnd0(ir), BIN_opnd1(ir), bb, vr);
+        limitToType(ir->getType(), vr);
+        return;
+    SWITCH_CASE_LOGIC:
+        evalLogic(ir, bb, vr);
+        return;
+    case IR_CVT:
+        evalCvt(ir, bb, vr);
+        return;
+    case IR_SELECT: {
+        ValueRange det;
+        evalExp(SELECT_det(ir), bb, nullptr, det);
+        if (det.is_undef()) { vr.setUndef(); return; }
+        if (isMustNonZero(det)) {
+            evalExp(SELECT_trueexp(ir), bb, nullptr, vr);
+        } else if (isMustZero(det)) {
+            evalExp(SELECT_falseexp(ir), bb, nullptr, vr);
+        } else {
+            ValueRange f;
+            evalExp(SELECT_trueexp(ir), bb, nullptr, vr);
+            evalExp(SELECT_falseexp(ir), bb, nullptr, f);
+            vr.unionRange(f);
+        }
+        limitToType(ir->getType(), vr);
+        return;
+    }
+    default:
+        //Nothing is known about the value except its type.
+        genTypeRange(ir->getType(), vr);
+    }
+}
+
+
+void VRP::evalPhi(IR const* ir, OUT ValueRange & vr) const
+{
+    ASSERT0(ir->is_phi());
+    IRBB const* bb = ir->getBB();
+    vr.setUndef();
+    xcom::EdgeC const* ec = bb->getVex()->getInList();
+    for (IR const* opnd = PHI_opnd_list(ir);
+         opnd != nullptr; opnd = opnd->get_next(), ec = ec->get_next()) {
+        ASSERT0(ec);
+        UINT from = ec->getFromId();
+        if (!isEdgeExec(from, bb->id())) { continue; }
+        ValueRange r;
+        evalExp(opnd, m_cfg->getBB(from), bb, r);
+        vr.unionRange(r);
+        if (vr.is_varying()) { return; }
+    }
+}
+
+
+void VRP::evalStmt(IR const* ir, OUT ValueRange & vr) const
+{
+    ASSERT0(isDefPR(ir));
+    switch (ir->getCode()) {
+    case IR_STPR:
+        evalExp(STPR_rhs(ir), ir->getBB(), nullptr, vr);
+        break;
+    case IR_PHI:
+        evalPhi(ir, vr);
+        break;
+    default:
+        //Nothing is known about the value except its type, e.g: the
+        //return value of CALL.
+        genTypeRange(ir->getType(), vr);
+        return;
+    }
+    limitToType(ir->getType(), vr);
+}
+
+
+void VRP::widen(IR const* def, ValueRange const& oldvr,
+                MOD ValueRange & newvr) const
+{
+    if (VR_change_count(&oldvr) < VRP_WIDEN_THRESHOLD) { return; }
+    if (!oldvr.is_range() || !newvr.is_range()) { return; }
+    HOST_INT tylow, tyhigh;
+    if (!getTypeRange(def->getType(), tylow, tyhigh)) { return; }
+    ValueRange const* thres = m_prno2thres.get(def->getPrno());
+    HOST_INT low = newvr.getLow();
+    HOST_INT high = newvr.getHigh();
+    if (low < oldvr.getLow()) {
+        low = (thres != nullptr && thres->getLow() <= low &&
+               thres->getLow() >= tylow) ? thres->getLow() : tylow;
+    }
+    if (high > oldvr.getHigh()) {
+        high = (thres != nullptr && thres->getHigh() >= high &&
+                thres->getHigh() <= tyhigh) ? thres->getHigh() : tyhigh;
+    }
+    newvr.setRange(MIN(low, newvr.getLow()), MAX(high, newvr.getHigh()));
+}
+
+
+bool VRP::updateVR(IR const* def, ValueRange const& vr)
+{
+    ValueRange * old = genVR(def->getPrno());
+    ValueRange newvr;
+    newvr.copy(*old);
+    //Keep the range increasing monotonically to guarantee termination.
+    newvr.unionRange(vr);
+    if (newvr.is_equal(*old)) { return false; }
+    widen(def, *old, newvr);
+    old->copy(newvr);
+    VR_change_count(old)++;
+    return true;
+}
+
+
+void VRP::pushStmt(IR const* ir)
+{
+    if (m_in_stmt_wl.is_contain(ir->id())) { return; }
+    m_in_stmt_wl.bunion(ir->id());
+    m_stmt_wl.append_tail(ir);
+}
+
+
+void VRP::pushUseStmt(IR const* def)
+{
+    SSAInfo const* ssainfo = def->getSSAInfo();
+    if (ssainfo == nullptr) { return; }
+    SSAUseIter it;
+    for (BSIdx u = SSA_uses(ssainfo).get_first(&it);
+         u != BS_UNDEF; u = SSA_uses(ssainfo).get_next(u, &it)) {
+        IR const* use = m_rg->getIR(u);
+        ASSERT0(use);
+        IR const* stmt = use->getStmt();
+        ASSERT0(stmt);
+        IRBB const* bb = stmt->getBB();
+        if (bb == nullptr || !m_exec_bb.is_contain(bb->id())) { continue; }
+        pushStmt(stmt);
+    }
+}
+
+
+void VRP::markBBExec(IRBB * bb)
+{
+    if (m_exec_bb.is_contain(bb->id())) { return; }
+    m_exec_bb.bunion(bb->id());
+    m_bb_wl.append_tail(bb);
+}
+
+
+void VRP::markEdgeExec(IRBB const* from, IRBB * to)
+{
+    UINT64 key = genEdgeKey(from->id(), to->id());
+    if (m_exec_edge.find(key)) { return; }
+    m_exec_edge.append(key);
+    if (!m_exec_bb.is_contain(to->id())) {
+        markBBExec(to);
+        return;
+    }
+    //The new executable edge changes the PHIs of 'to'.
+    BBIRListIter it;
+    for (IR const* ir = to->getIRList().get_head(&it);
+         ir != nullptr; ir = to->getIRList().get_next(&it)) {
+        if (!ir->is_phi()) { break; }
+        pushStmt(ir);
+    }
+}
+
+
+void VRP::visitBBOut(IRBB * bb)
+{
+    IR const* last = bb->getLastIR();
+    if (last != nullptr && last->isConditionalBr() &&
+        bb->getVex()->getOutDegree() == 2) {
+        ValueRange det;
+        evalExp(BR_det(last), bb, nullptr, det);
+        if (det.is_undef()) {
+            //Optimistically regard the successors as unreachable until the
+            //determinant is known.
+            return;
+        }
+        IRBB * tgt = m_cfg->findBBbyLabel(BR_lab(last));
+        IRBB * ft = m_cfg->getFallThroughBB(bb);
+        bool must_true = isMustNonZero(det);
+        bool must_false = isMustZero(det);
+        if ((must_true || must_false) && tgt != nullptr && ft != nullptr &&
+            tgt != ft) {
+            bool taken = last->is_truebr() ? must_true : must_false;
+            markEdgeExec(bb, taken ? tgt : ft);
+            return;
+        }
+    }
+    for (xcom::EdgeC const* ec = bb->getVex()->getOutList();
+         ec != nullptr; ec = ec->get_next()) {
+        markEdgeExec(bb, m_cfg->getBB(ec->getToId()));
+    }
+}
+
+
+void VRP::visitStmt(IR const* ir)
+{
+    ASSERT0(ir->getBB() && m_exec_bb.is_contain(ir->getBB()->id()));
+    if (isDefPR(ir)) {
+        ValueRange vr;
+        evalStmt(ir, vr);
+        if (updateVR(ir, vr)) { pushUseStmt(ir); }
+    }
+    if (ir->isConditionalBr()) {
+        visitBBOut(ir->getBB());
+    }
+}
+
+
+void VRP::visitBB(IRBB * bb)
+{
+    BBIRListIter it;
+    for (IR const* ir = bb->getIRList().get_head(&it);
+         ir != nullptr; ir = bb->getIRList().get_next(&it)) {
+        visitStmt(ir);
+    }
+    visitBBOut(bb);
+}
+
+
+bool VRP::recheck()
+{
+    UINT edgenum = m_exec_edge.get_elem_count();
+    bool change = false;
+    BBListIter bbit;
+    BBList * bbl = m_rg->getBBList();
+    for (IRBB * bb = bbl->get_head(&bbit);
+         bb != nullptr; bb = bbl->get_next(&bbit)) {
+        if (!m_exec_bb.is_contain(bb->id())) { continue; }
+        BBIRListIter it;
+        for (IR const* ir = bb->getIRList().get_head(&it);
+             ir != nullptr; ir = bb->getIRList().get_next(&it)) {
+            if (!isDefPR(ir)) { continue; }
+            ValueRange vr;
+            evalStmt(ir, vr);
+            if (updateVR(ir, vr)) {
+                pushUseStmt(ir);
+                change = true;
+            }
+        }
+        visitBBOut(bb);
+    }
+    return change || edgenum != m_exec_edge.get_elem_count();
+}
+
+
+void VRP::solve()
+{
+    BBListIter bbit;
+    BBList * bbl = m_rg->getBBList();
+    for (IRBB * bb = bbl->get_head(&bbit);
+         bb != nullptr; bb = bbl->get_next(&bbit)) {
+        if (bb == m_cfg->getEntry() || bb->getVex()->getInDegree() == 0) {
+            markBBExec(bb);
+        }
+    }
+    do {
+        //The change of range might make the conditions that are not
+        //tracked by SSA use be narrowed, thus recheck the whole region
+        //until nothing changed.
+        while (m_stmt_wl.get_elem_count() != 0 ||
+               m_bb_wl.get_elem_count() != 0) {
+            if (m_stmt_wl.get_elem_count() != 0) {
+                IR const* ir = m_stmt_wl.remove_head();
+                m_in_stmt_wl.diff(ir->id());
+                visitStmt(ir);
+                continue;
+            }
+            visitBB(m_bb_wl.remove_head());
+        }
+    } while (recheck());
+}
+
+
+void VRP::narrow()
+{
+    RPOVexList const* vlst = m_cfg->getRPOVexList();
+    ASSERT0(vlst);
+    for (UINT i = 0; i < VRP_NARROW_ITER_NUM; i++) {
+        RPOVexListIter vit;
+        for (xcom::Vertex const* v = vlst->get_head(&vit);
+             v != nullptr; v = vlst->get_next(&vit)) {
+            if (!m_exec_bb.is_contain(v->id())) { continue; }
+            IRBB * bb = m_cfg->getBB(v->id());
+            ASSERT0(bb);
+            BBIRListIter it;
+            for (IR const* ir = bb->getIRList().get_head(&it);
+                 ir != nullptr; ir = bb->getIRList().get_next(&it)) {
+                if (!isDefPR(ir)) { continue; }
+                ValueRange * old = m_prno2vr.get(ir->getPrno());
+                if (old == nullptr || !old->is_range()) { continue; }
+                //The range computed from a post fixed point is still a post
+                //fixed point, thus it is safe to descend.
+                ValueRange vr;
+                evalStmt(ir, vr);
+                vr.intersect(*old);
+                old->copy(vr);
+            }
+        }
+    }
+}
+
+
+void VRP::setThreshold(PRNO prno, HOST_INT low, HOST_INT high)
+{
+    ValueRange * thres = (ValueRange*)smpoolMallocConstSize(
+        sizeof(ValueRange), m_pool);
+    thres->clean();
+    thres->setRange(low, high);
+    m_prno2thres.set(prno, thres);
+}
+
+
+void VRP::computeThresholdForLoop(LI<IRBB> const* li)
+{
+    IVBoundInfo bi;
+    IVRCtx ivrctx(m_rg, m_oc);
+    if (!m_ivr->computeConstIVBound(li, bi, ivrctx)) { return; }
+    BIV const* biv = bi.getBIV();
+    ASSERT0(biv && biv->isStepValInt());
+    HOST_INT step = (HOST_INT)biv->getStepValInt();
+    if (step == VRP_HOST_INT_MIN) { return; }
+    if (step < 0) { step = -step; }
+    HOST_INT init = IVBI_tc_init_val_imm(bi);
+    HOST_INT end = IVBI_tc_end_val_imm(bi);
+    //The BIV may exceed the end bound by one step when loop exits.
+    HOST_INT low = 0;
+    HOST_INT high = 0;
+    if (subOverflow(MIN(init, end), step, low) ||
+        addOverflow(MAX(init, end), step, high)) {
+        return;
+    }
+    IR const* redexp = biv->getRedExp();
+    if (redexp != nullptr && redexp->is_pr()) {
+        setThreshold(redexp->getPrno(), low, high);
+    }
+    IR const* redstmt = biv->getRedStmt();
+    if (redstmt != nullptr && redstmt->is_stpr()) {
+        setThreshold(redstmt->getPrno(), low, high);
+    }
+}
+
+
+void VRP::computeThreshold(LI<IRBB> const* li)
+{
+    for (LI<IRBB> const* x = li; x != nullptr; x = x->get_next()) {
+        computeThresholdForLoop(x);
+        computeThreshold(x->getInnerList());
+    }
+}
+
+
+bool VRP::computeRange(IR const* exp, IRBB const* bb, OUT ValueRange & vr,
+                       OptCtx const& oc) const
+{
+    ASSERT0(exp->is_exp());
+    if (!isAvail()) { return false; }
+    if (!oc.is_dom_valid()) { bb = nullptr; }
+    evalExp(exp, bb, nullptr, vr);
+    return vr.is_range();
+}
+
+
+bool VRP::calcCondMustVal(IR const* ir, IRBB const* bb, OUT bool & must_true,
+                          OUT bool & must_false, OptCtx const& oc) const
+{
+    must_true = false;
+    must_false = false;
+    ValueRange vr;
+    if (!computeRange(ir, bb, vr, oc)) { return false; }
+    if (isMustNonZero(vr)) {
+        must_true = true;
+        return true;
+    }
+    if (isMustZero(vr)) {
+        must_false = true;
+        return true;
+    }
+    return false;
+}
+
+
+bool VRP::dump() const
+{
+    if (!getRegion()->isLogMgrInit() || !g_dump_opt.isDumpVRP()) {
+        return true;
+    }
+    note(getRegion(), "\n==---- DUMP %s '%s' ----==",
+         getPassName(), m_rg->getRegionName());
+    getRegion()->getLogMgr()->incIndent(2);
+    note(getRegion(), "\nEXECUTABLE BB:");
+    for (BSIdx i = m_exec_bb.get_first(); i != BS_UNDEF;
+         i = m_exec_bb.get_next(i)) {
+        prt(getRegion(), "BB%u ", (UINT)i);
+    }
+    xcom::StrBuf buf(16);
+    for (VecIdx i = 0; i <= m_prno2vr.get_last_idx(); i++) {
+        ValueRange const* vr = m_prno2vr.get(i);
+        if (vr == nullptr) { continue; }
+        buf.clean();
+        note(getRegion(), "\n$%u:%s", (UINT)i, vr->dumpBuf(buf));
+    }
+    m_am.dump();
+    bool succ = Pass::dump();
+    getRegion()->getLogMgr()->decIndent(2);
+    return succ;
+}
+
+
+bool VRP::perform(OptCtx & oc)
+{
+    BBList * bbl = m_rg->getBBList();
+    if (bbl == nullptr || bbl->get_elem_count() == 0) { return false; }
+    if (!oc.is_ref_valid()) { return false; }
+    m_prssamgr = m_rg->getPRSSAMgr();
+    if (m_prssamgr == nullptr || !m_prssamgr->is_valid()) {
+        //The pass propagates ranges along SSA DefUse chain.
+        return false;
+    }
+    m_oc = &oc;
+    START_TIMER(t, getPassName());
+    m_rg->getPassMgr()->checkValidAndRecompute(
+        &oc, PASS_DOM, PASS_RPO, PASS_UNDEF);
+    reset();
+    m_ivr = (IVR*)m_rg->getPassMgr()->queryPass(PASS_IVR);
+    if (m_ivr != nullptr && m_ivr->is_valid() && oc.is_loopinfo_valid()) {
+        computeThreshold(m_cfg->getLoopInfo());
+    }
+    solve();
+    narrow();
+    set_valid(true);
+    END_TIMER(t, getPassName());
+    dump();
+
+    //VRP is an analysis pass, it does not change region.
+    return false;
+}
+//END VRP
+
+} //namespace xoc
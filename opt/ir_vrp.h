@@ -0,0 +1,286 @@
+/*@
+XOC Release License
+
+Copyright (c) 2013-2014, Alibaba Group, All rights reserved.
+
+    compiler@aliexpress.com
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Su Zhenyu nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+author: Su Zhenyu
+@*/
+#ifndef _IR_VRP_H_
+#define _IR_VRP_H_
+
+namespace xoc {
+
+//The class represents the value range of integer PR or expression, the range
+//is a closed interval [low, high].
+//The range forms the lattice of VRP:
+//  UNDEF: the value has not been evaluated or the definition is
+//         unreachable, it is the top of lattice.
+//  RANGE: the value is in [low, high].
+//  VARYING: nothing is known about the value, it is the bottom of lattice.
+//Note the value of data type that can not be represented by HOST_INT is
+//always VARYING, e.g: u64 if HOST_INT is 64bit.
+#define VR_kind(v) ((v)->m_kind)
+#define VR_low(v) ((v)->m_low)
+#define VR_high(v) ((v)->m_high)
+#define VR_change_count(v) ((v)->m_change_count)
+class ValueRange {
+    //The class permits copy-constructing.
+public:
+    typedef enum tagVR_KIND {
+        VR_UNDEF = 0,
+        VR_RANGE,
+        VR_VARYING,
+    } VR_KIND;
+public:
+    VR_KIND m_kind;
+
+    //Record the number of times that the range has been enlarged.
+    //The range will be widened if the number exceeds the threshold.
+    UINT m_change_count;
+    HOST_INT m_low;
+    HOST_INT m_high;
+public:
+    ValueRange() { clean(); }
+
+    void clean()
+    { m_kind = VR_UNDEF; m_change_count = 0; m_low = 0; m_high = 0; }
+    void copy(ValueRange const& src)
+    { m_kind = src.m_kind; m_low = src.m_low; m_high = src.m_high; }
+
+    void dump(Region const* rg) const;
+    CHAR const* dumpBuf(OUT xcom::StrBuf & buf) const;
+
+    HOST_INT getLow() const { ASSERT0(is_range()); return m_low; }
+    HOST_INT getHigh() const { ASSERT0(is_range()); return m_high; }
+
+    //Return true if current range contains 'v'.
+    bool isContain(HOST_INT v) const
+    { return is_varying() || (is_range() && m_low <= v && v <= m_high); }
+
+    //Return true if current range contains 'src'.
+    bool isContain(ValueRange const& src) const;
+    bool is_undef() const { return m_kind == VR_UNDEF; }
+    bool is_range() const { return m_kind == VR_RANGE; }
+    bool is_varying() const { return m_kind == VR_VARYING; }
+    bool is_const() const { return is_range() && m_low == m_high; }
+    bool is_equal(ValueRange const& src) const;
+
+    //Return true if all values in range are not less than zero.
+    bool isNonNeg() const { return is_range() && m_low >= 0; }
+
+    //Intersect current range with [low, high].
+    //The range becomes UNDEF if the intersection is empty.
+    void intersect(HOST_INT low, HOST_INT high);
+    void intersect(ValueRange const& src);
+
+    void setUndef() { m_kind = VR_UNDEF; }
+    void setVarying() { m_kind = VR_VARYING; }
+    void setRange(HOST_INT low, HOST_INT high)
+    {
+        ASSERT0(low <= high);
+        m_kind = VR_RANGE;
+        m_low = low;
+        m_high = high;
+    }
+
+    //Merge current range with 'src', the result is the smallest range that
+    //contains both of them.
+    void unionRange(ValueRange const& src);
+};
+
+
+//The class performs Value Range Propagation.
+//The pass computes the integer value range of each PR in PRSSA form by
+//propagating ranges through the sparse SSA graph while tracking executable
+//CFG edges, in the spirit of Sparse Conditional Constant Propagation:
+//the PHI only merges operands that come from executable edges, and the
+//edge is executable only if the branch condition may select it.
+//The use of PR is narrowed by the branch conditions that dominate it, e.g:
+//  BB1: $1 = phi(0, $2);
+//       falsebr (lt $1, 100), L1;
+//  BB2: $2 = add $1, 1;  #$1 is in [0,99] here, thus $2 is in [1,100].
+//       goto BB1;
+//The loop-carried range is accelerated by widening, and the widening
+//threshold is given by the constant bound of BIV that IVR computed via
+//IVBoundInfo. A narrowing iteration is applied after the fixed point
+//reached to recover the precision lost by widening.
+//The result is consumed by RCE, IRSimp and Refine through the query
+//interfaces, e.g: calcCondMustVal().
+//Ref: M.N.Wegman, F.K.Zadeck, Constant Propagation with Conditional
+//     Branches, TOPLAS 1991.
+//     J.R.C.Patterson, Accurate Static Branch Prediction by Value Range
+//     Propagation, PLDI 1995.
+//NOTE: the ranges are computed for the definitions of PR, they are still
+//sound after a transformation that preserves the value of PR. Any
+//transformation that moves definition of PR or changes CFG should
+//invalidate the pass.
+class VRP : public Pass {
+    COPY_CONSTRUCTOR(VRP);
+    IRCFG * m_cfg;
+    TypeMgr * m_tm;
+    PRSSAMgr * m_prssamgr;
+    IVR * m_ivr;
+    OptCtx * m_oc;
+    SMemPool * m_pool;
+    ActMgr m_am;
+    Vector<ValueRange*> m_prno2vr; //map PRNO to its range.
+
+    //Record the widening threshold of PR, which are computed by IVR.
+    xcom::TMap<PRNO, ValueRange*> m_prno2thres;
+    xcom::BitSet m_exec_bb; //record executable BBs.
+    xcom::TTab<UINT64> m_exec_edge; //record executable CFG edges.
+    xcom::BitSet m_in_stmt_wl; //record stmts that in the stmt worklist.
+    xcom::List<IRBB*> m_bb_wl; //worklist of BB that become executable.
+    xcom::List<IR const*> m_stmt_wl; //worklist of stmt to be reevaluated.
+protected:
+    //Narrow 'vr' of 'prno' by the branch condition of edge from->to.
+    void applyEdgeCond(PRNO prno, IRBB const* from, IRBB const* to,
+                       MOD ValueRange & vr) const;
+
+    void computeThreshold(LI<IRBB> const* li);
+    void computeThresholdForLoop(LI<IRBB> const* li);
+
+    void destroy();
+
+    //Evaluate the range of expression 'ir'.
+    //bb: the BB that 'ir' evaluated at, the branch conditions that dominate
+    //    'bb' are used to narrow the range of PR. It can be NULL.
+    //succ: optional, if it is not NULL, the edge bb->succ is regarded as
+    //      taken, e.g: evaluating the operand of PHI.
+    void evalExp(IR const* ir, IRBB const* bb, IRBB const* succ,
+                 OUT ValueRange & vr) const;
+    void evalBin(IR const* ir, IRBB const* bb, OUT ValueRange & vr) const;
+    void evalCompare(IR_CODE code, IR const* op0, IR const* op1,
+                     IRBB const* bb, OUT ValueRange & vr) const;
+    void evalCvt(IR const* ir, IRBB const* bb, OUT ValueRange & vr) const;
+    void evalLogic(IR const* ir, IRBB const* bb, OUT ValueRange & vr) const;
+    void evalPR(IR const* ir, IRBB const* bb, IRBB const* succ,
+                OUT ValueRange & vr) const;
+    void evalPhi(IR const* ir, OUT ValueRange & vr) const;
+    void evalStmt(IR const* ir, OUT ValueRange & vr) const;
+    void evalUnary(IR const* ir, IRBB const* bb, OUT ValueRange & vr) const;
+
+    //Set 'vr' to the full range of type 'ty'.
+    void genTypeRange(Type const* ty, OUT ValueRange & vr) const;
+    ValueRange * genVR(PRNO prno);
+
+    //Return true if the type of 'ir' can be represented in HOST_INT.
+    bool getTypeRange(Type const* ty, OUT HOST_INT & low,
+                      OUT HOST_INT & high) const;
+
+    //Return true if the edge from->to may be executed.
+    bool isEdgeExec(UINT from, UINT to) const;
+
+    //Return true if the PR that defined by 'ir' is tracked by VRP.
+    bool isDefPR(IR const* ir) const
+    { return ir->is_stmt() && (ir->isWritePR() || ir->isCallHasRetVal()); }
+
+    //Return true if the comparison of 'op0' and 'op1' can be decided by
+    //their ranges.
+    bool isComparable(IR const* op0, IR const* op1, ValueRange const& r0,
+                      ValueRange const& r1) const;
+
+    //Limit the range 'vr' by the value range of type 'ty'.
+    void limitToType(Type const* ty, MOD ValueRange & vr) const;
+
+    void markEdgeExec(IRBB const* from, IRBB * to);
+    void markBBExec(IRBB * bb);
+    void narrow();
+
+    //Narrow the range of 'prno' by the branch conditions that dominate 'bb'.
+    void narrowByDomCond(PRNO prno, IRBB const* bb, IRBB const* succ,
+                         MOD ValueRange & vr) const;
+
+    //Narrow the range of 'prno' by the condition 'det' which is known to
+    //be 'is_true'.
+    void narrowByCond(PRNO prno, IR const* det, bool is_true,
+                      MOD ValueRange & vr) const;
+    void pushUseStmt(IR const* def);
+    void pushStmt(IR const* ir);
+
+    //Reevaluate all stmts in executable BBs.
+    //Return true if any range or executable edge changed.
+    bool recheck();
+    void reset();
+    void setThreshold(PRNO prno, HOST_INT low, HOST_INT high);
+    void solve();
+
+    //Update the range of PR that defined by 'def' by 'vr'.
+    //Return true if the range changed.
+    bool updateVR(IR const* def, ValueRange const& vr);
+    void visitBB(IRBB * bb);
+    void visitBBOut(IRBB * bb);
+    void visitStmt(IR const* ir);
+
+    //Apply the widening to 'newvr' if the range of PR that defined by 'def'
+    //changed too many times.
+    void widen(IR const* def, ValueRange const& oldvr,
+               MOD ValueRange & newvr) const;
+public:
+    explicit VRP(Region * rg);
+    virtual ~VRP() { destroy(); }
+
+    //If 'ir' is always true, set 'must_true', or if it is always false,
+    //set 'must_false'.
+    //Return true if this function is able to determine the result of 'ir',
+    //otherwise return false that it does know nothing about ir.
+    //bb: the BB that 'ir' placed, it can be NULL. The branch conditions
+    //    that dominate 'bb' are used to narrow the range if DOM info is
+    //    valid.
+    bool calcCondMustVal(IR const* ir, IRBB const* bb, OUT bool & must_true,
+                         OUT bool & must_false, OptCtx const& oc) const;
+
+    //Compute the value range of expression 'exp' that placed in 'bb'.
+    //bb: it can be NULL, see calcCondMustVal().
+    //Return true if the range is known.
+    bool computeRange(IR const* exp, IRBB const* bb, OUT ValueRange & vr,
+                      OptCtx const& oc) const;
+
+    virtual bool dump() const;
+
+    virtual CHAR const* getPassName() const
+    { return "Value Range Propagation"; }
+    PASS_TYPE getPassType() const { return PASS_VRP; }
+    ActMgr & getActMgr() { return m_am; }
+
+    //Return the range of 'prno', or NULL if VRP knows nothing about it.
+    ValueRange const* getRange(PRNO prno) const { return m_prno2vr.get(prno); }
+
+    //Return true if the value ranges are available to query.
+    bool isAvail() const
+    {
+        return is_valid() && m_prssamgr != nullptr &&
+               m_prssamgr->is_valid();
+    }
+
+    virtual bool perform(OptCtx & oc);
+};
+
+} //namespace xoc
+#endif
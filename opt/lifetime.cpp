@@ -355,6 +355,12 @@ bool LifeTime::is_intersect(LifeTime const* lt) const
     UINT j = 0;
     UINT rv1n = lt1->getRangeNum();
     UINT rv2n = lt2->getRangeNum();
+    if (rv1n == 0 || rv2n == 0) { return false; }
+    if (lt1->getLastPos() < lt2->getFirstPos() ||
+        lt2->getLastPos() < lt1->getFirstPos()) {
+        //The two lifetimes are disjoint as a whole.
+        return false;
+    }
     Range r1 = rv1->get(i);
     Range r2 = rv2->get(j);
     for (;;) {
@@ -378,6 +384,7 @@ bool LifeTime::is_intersect(LifeTime const* lt) const
         if (r1.is_intersect(r2)) { return true; }
         ASSERT0(r1.is_great(r2));
         j++;
+        if (j >= rv2n) { return false; }
         r2 = rv2->get(j);
     }
     UNREACHABLE();
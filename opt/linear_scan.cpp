@@ -1169,6 +1169,150 @@ bool PRNOConstraintsTab::hasTwoOrMoreCommonElements(
 //END PRNOConstraintsTab
 
 
+//
+//START LTEventQueue
+//
+void LTEventQueue::clean()
+{
+    m_heap.clean();
+    m_lt2stamp.clean();
+    m_num = 0;
+    m_stamp = 0;
+}
+
+
+//The events with same position are ordered by the order of scheduling to
+//keep the allocation result deterministic.
+bool LTEventQueue::is_less(UINT i, UINT j) const
+{
+    LTEvent a = m_heap.get(i);
+    LTEvent b = m_heap.get(j);
+    return a.pos < b.pos || (a.pos == b.pos && a.stamp < b.stamp);
+}
+
+
+void LTEventQueue::swapEvent(UINT i, UINT j)
+{
+    LTEvent t = m_heap.get(i);
+    m_heap.set(i, m_heap.get(j));
+    m_heap.set(j, t);
+}
+
+
+void LTEventQueue::siftUp(UINT i)
+{
+    while (i > 0) {
+        UINT p = (i - 1) / 2;
+        if (!is_less(i, p)) { return; }
+        swapEvent(i, p);
+        i = p;
+    }
+}
+
+
+void LTEventQueue::siftDown(UINT i)
+{
+    for (;;) {
+        UINT l = 2 * i + 1;
+        if (l >= m_num) { return; }
+        UINT m = l;
+        UINT r = l + 1;
+        if (r < m_num && is_less(r, l)) { m = r; }
+        if (!is_less(m, i)) { return; }
+        swapEvent(i, m);
+        i = m;
+    }
+}
+
+
+LTEvent LTEventQueue::removeTop()
+{
+    ASSERT0(m_num > 0);
+    LTEvent top = m_heap.get(0);
+    m_num--;
+    if (m_num > 0) {
+        m_heap.set(0, m_heap.get(m_num));
+        siftDown(0);
+    }
+    return top;
+}
+
+
+void LTEventQueue::push(Pos pos, LifeTime * lt)
+{
+    ASSERT0(lt);
+    m_stamp++;
+    ASSERTN(m_stamp != 0, ("stamp overflow"));
+    m_lt2stamp.setAlways(lt, m_stamp);
+    m_heap.set(m_num, LTEvent(pos, m_stamp, lt));
+    m_num++;
+    siftUp(m_num - 1);
+}
+
+
+LifeTime * LTEventQueue::popUntil(Pos pos)
+{
+    while (m_num > 0 && m_heap.get(0).pos <= pos) {
+        LTEvent e = removeTop();
+        if (m_lt2stamp.get(e.lt) != e.stamp) {
+            //The lifetime has been rescheduled.
+            continue;
+        }
+        m_lt2stamp.setAlways(e.lt, 0);
+        return e.lt;
+    }
+    return nullptr;
+}
+//END LTEventQueue
+
+
+//
+//START RegIntervalTree
+//
+void RegIntervalTree::add(LifeTime * lt)
+{
+    ASSERT0(lt);
+    for (UINT i = 0; i < lt->getRangeNum(); i++) {
+        m_start2lt.setAlways(lt->getRange((VecIdx)i).start(), lt);
+    }
+}
+
+
+LifeTime * RegIntervalTree::findFloor(Pos pos, OUT Pos & start)
+{
+    RangeNode * floor = nullptr;
+    for (RangeNode * x = m_start2lt.get_root(); x != nullptr;) {
+        if (x->key <= pos) {
+            floor = x;
+            x = x->rchild;
+            continue;
+        }
+        x = x->lchild;
+    }
+    if (floor == nullptr) { return nullptr; }
+    start = floor->key;
+    return floor->mapped;
+}
+
+
+LifeTime * RegIntervalTree::findCeil(Pos pos, OUT Pos & start)
+{
+    RangeNode * ceil = nullptr;
+    for (RangeNode * x = m_start2lt.get_root(); x != nullptr;) {
+        if (x->key > pos) {
+            ceil = x;
+            x = x->lchild;
+            continue;
+        }
+        x = x->rchild;
+    }
+    if (ceil == nullptr) { return nullptr; }
+    start = ceil->key;
+    return ceil->mapped;
+}
+//END RegIntervalTree
+
+
 //
 //START RegSetImpl
 //
@@ -1785,6 +1929,10 @@ LinearScanRA::LinearScanRA(Region * rg) : Pass(rg), m_act_mgr(rg)
 LinearScanRA::~LinearScanRA()
 {
     delete m_lt_mgr;
+    for (VecIdx i = 0; i < (VecIdx)m_reg2itree.get_elem_count(); i++) {
+        RegIntervalTree * t = m_reg2itree.get(i);
+        if (t != nullptr) { delete t; }
+    }
     if (m_lt_constraints_mgr != nullptr) {
         delete m_lt_constraints_mgr;
         m_lt_constraints_mgr = nullptr;
@@ -1818,6 +1966,12 @@ void LinearScanRA::reset()
     m_handled.clean();
     m_active.clean();
     m_inactive.clean();
+    m_active_event.clean();
+    m_inactive_event.clean();
+    for (VecIdx i = 0; i < (VecIdx)m_reg2itree.get_elem_count(); i++) {
+        RegIntervalTree * t = m_reg2itree.get(i);
+        if (t != nullptr) { t->clean(); }
+    }
     m_spill_tab.clean();
     m_reload_tab.clean();
     m_remat_tab.clean();
@@ -2074,6 +2228,23 @@ bool LinearScanRA::verify4List() const
 }
 
 
+bool LinearScanRA::verify4Transfer(Pos curpos) const
+{
+    LTListIter it;
+    for (LifeTime const* lt = m_active.get_head(&it);
+         lt != nullptr; lt = m_active.get_next(&it)) {
+        ASSERTN(lt->is_contain(curpos),
+                ("lt in active should contain current position"));
+    }
+    for (LifeTime const* lt = m_inactive.get_head(&it);
+         lt != nullptr; lt = m_inactive.get_next(&it)) {
+        ASSERTN(lt->is_cover(curpos) && !lt->is_contain(curpos),
+                ("lt in inactive should be in hole at current position"));
+    }
+    return true;
+}
+
+
 //The function check whether 'lt' value is simple enough to rematerialize.
 //And return the information through rematctx.
 bool LinearScanRA::checkLTCanBeRematerialized(MOD LifeTime * lt,
@@ -2260,6 +2431,10 @@ void LinearScanRA::addActive(LifeTime * lt)
 {
     if (m_active.find(lt)) { return; }
     m_active.append_tail(lt);
+
+    //The current position is unknown here, revisit 'lt' at next transfer.
+    m_active_event.push(POS_UNDEF, lt);
+    addRegInterval(lt);
 }
 
 
@@ -2267,6 +2442,85 @@ void LinearScanRA::addInActive(LifeTime * lt)
 {
     if (m_inactive.find(lt)) { return; }
     m_inactive.append_tail(lt);
+
+    //The current position is unknown here, revisit 'lt' at next transfer.
+    m_inactive_event.push(POS_UNDEF, lt);
+    addRegInterval(lt);
+}
+
+
+void LinearScanRA::addRegInterval(LifeTime * lt)
+{
+    Reg r = getReg(lt);
+    ASSERT0(r != REG_UNDEF);
+    RegIntervalTree * t = m_reg2itree.get((VecIdx)r);
+    if (t == nullptr) {
+        t = new RegIntervalTree();
+        m_reg2itree.set((VecIdx)r, t);
+    }
+    t->add(lt);
+}
+
+
+void LinearScanRA::updateShrinkedLT(LifeTime * lt)
+{
+    //The event of 'lt' may be later than its new end, revisit 'lt' at next
+    //transfer. The new ranges replace the old ones in interval tree.
+    if (m_active.find(lt)) {
+        m_active_event.push(POS_UNDEF, lt);
+        addRegInterval(lt);
+        return;
+    }
+    if (m_inactive.find(lt)) {
+        m_inactive_event.push(POS_UNDEF, lt);
+        addRegInterval(lt);
+    }
+}
+
+
+//The range is stale if its lifetime has left active and inactive set,
+//has been assigned other register, or has been shrinked.
+bool LinearScanRA::isValidRegInterval(LifeTime const* lt, Reg r, Pos start,
+                                      OUT Range & range) const
+{
+    LifeTime * plt = const_cast<LifeTime*>(lt);
+    if (!m_active.find(plt) && !m_inactive.find(plt)) { return false; }
+    if (getReg(lt) != r) { return false; }
+    VecIdx ridx;
+    return lt->findRange(start, range, ridx) && range.start() == start;
+}
+
+
+Pos LinearScanRA::getRegFreeUntil(Reg r, Pos pos, LifeTime const* skip)
+{
+    RegIntervalTree * t = m_reg2itree.get((VecIdx)r);
+    if (t == nullptr) { return POS_UNDEF; }
+
+    //Only the valid range that starts nearest before 'pos' may contain
+    //'pos', because the valid ranges on one register do not overlap.
+    Pos start;
+    Range range(POS_UNDEF);
+    for (LifeTime * lt = t->findFloor(pos, start);
+         lt != nullptr; lt = t->findFloor(pos, start)) {
+        if (isValidRegInterval(lt, r, start, range)) {
+            if (lt != skip && range.is_contain(pos)) { return pos; }
+            break;
+        }
+        t->remove(start);
+    }
+    Pos cur = pos;
+    for (LifeTime * lt = t->findCeil(cur, start);
+         lt != nullptr; lt = t->findCeil(cur, start)) {
+        if (!isValidRegInterval(lt, r, start, range)) {
+            t->remove(start);
+            continue;
+        }
+        if (lt != skip) { return start; }
+
+        //Look for the range that follows the range of 'skip'.
+        cur = start;
+    }
+    return POS_UNDEF;
 }
 
 
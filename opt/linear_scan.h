@@ -505,6 +505,99 @@ public:
     LTSet() {}
 };
 
+
+//
+//START LTEventQueue
+//
+//The class is a binary min-heap that records the position at which the
+//lifetime in active or inactive set may change its state, namely the
+//position that lifetime leaves the range that contains current position,
+//or enters the next range after a hole. The allocator only revisits the
+//lifetimes whose event position has been reached, rather than walking the
+//whole set at every position.
+//NOTE: the queue is lazy. The lifetime may be removed from set or be
+//rescheduled without deleting its old event, the stale event will be
+//dropped when it is popped.
+class LTEvent {
+public:
+    Pos pos;
+    UINT stamp; //used to distinguish the stale event.
+    LifeTime * lt;
+public:
+    LTEvent() : pos(POS_UNDEF), stamp(0), lt(nullptr) {}
+    LTEvent(Pos p) : pos(p), stamp(0), lt(nullptr) {}
+    LTEvent(Pos p, UINT s, LifeTime * l) : pos(p), stamp(s), lt(l) {}
+};
+
+
+class LTEventQueue {
+    COPY_CONSTRUCTOR(LTEventQueue);
+    UINT m_stamp;
+    UINT m_num; //the number of event in heap, include the stale one.
+    Vector<LTEvent> m_heap;
+    TMap<LifeTime*, UINT> m_lt2stamp;
+protected:
+    bool is_less(UINT i, UINT j) const;
+    LTEvent removeTop();
+    void siftUp(UINT i);
+    void siftDown(UINT i);
+    void swapEvent(UINT i, UINT j);
+public:
+    LTEventQueue() : m_stamp(0), m_num(0) {}
+
+    void clean();
+
+    UINT get_elem_count() const { return m_num; }
+
+    //Pop the lifetime whose event position is not greater than 'pos'.
+    //Return nullptr if there is no such lifetime.
+    LifeTime * popUntil(Pos pos);
+
+    //Schedule 'lt' to be revisited at 'pos'. The event of 'lt' that has
+    //been scheduled before becomes stale.
+    void push(Pos pos, LifeTime * lt);
+};
+//END LTEventQueue
+
+
+//
+//START RegIntervalTree
+//
+//The class records the ranges of the lifetimes that are assigned the same
+//register and reside in active or inactive set. The ranges on one register
+//never overlap, thus the tree keyed by the start of range answers the
+//interval queries in logarithmic time, e.g: whether the register is
+//occupied at given position, or the position until which it is free.
+//NOTE: the tree is lazy. The lifetime may leave active and inactive set or
+//be shrinked without deleting its ranges, the caller drops the stale range
+//when it is visited.
+class RegIntervalTree {
+    COPY_CONSTRUCTOR(RegIntervalTree);
+    typedef xcom::RBTNode<Pos, LifeTime*> RangeNode;
+    TMap<Pos, LifeTime*> m_start2lt;
+public:
+    RegIntervalTree() {}
+
+    //Record all ranges of 'lt'.
+    void add(LifeTime * lt);
+
+    void clean() { m_start2lt.clean(); }
+
+    //Return the lifetime that has the range with the greatest start not
+    //greater than 'pos', or nullptr if there is no such range.
+    //start: record the start of the range.
+    LifeTime * findFloor(Pos pos, OUT Pos & start);
+
+    //Return the lifetime that has the range with the least start greater
+    //than 'pos', or nullptr if there is no such range.
+    //start: record the start of the range.
+    LifeTime * findCeil(Pos pos, OUT Pos & start);
+
+    //Drop the range that starts at 'start'.
+    void remove(Pos start) { m_start2lt.remove(start); }
+};
+//END RegIntervalTree
+
 typedef xcom::TTabIter<LifeTime*> LTTabIter;
 class LTTab : public xcom::TTab<LifeTime*> {
 };
@@ -977,6 +1070,9 @@ protected:
     LTSet m_handled;
     LTSet m_active;
     LTSet m_inactive;
+    LTEventQueue m_active_event;
+    LTEventQueue m_inactive_event;
+    Vector<RegIntervalTree*> m_reg2itree;
     Vector<Reg> m_prno2reg;
     IRTab m_spill_tab;
     IRTab m_reload_tab;
@@ -992,6 +1088,12 @@ protected:
     LTConstraintsMgr * m_lt_constraints_mgr;
     LTConstraintsStrategy * m_lt_constraints_strategy;
 protected:
+    //Return true if the range of 'lt' that starts at 'start' is still the
+    //interval of register 'r'.
+    //range: record the range.
+    bool isValidRegInterval(LifeTime const* lt, Reg r, Pos start,
+                            OUT Range & range) const;
+
     LifeTimeMgr * allocLifeTimeMgr(Region * rg)
     { ASSERT0(rg); return new LifeTimeMgr(rg); }
 
@@ -1016,6 +1118,13 @@ public:
     void addActive(LifeTime * lt);
     void addInActive(LifeTime * lt);
     void addHandled(LifeTime * lt);
+
+    //Record the ranges of 'lt' in the interval tree of its register.
+    void addRegInterval(LifeTime * lt);
+
+    //Update the transfer event and register intervals of 'lt' after the
+    //ranges of 'lt' are shrinked, e.g: by splitting.
+    void updateShrinkedLT(LifeTime * lt);
     void assignLexSeqIdForBB();
 
     virtual IR * buildRemat(PRNO prno, RematCtx const& rematctx,
@@ -1165,6 +1274,14 @@ public:
     Reg getReg(PRNO prno) const;
     REGFILE getRegFile(Reg r) const;
     Reg getReg(LifeTime const* lt) const;
+
+    //Return the position until which register 'r' is free from 'pos' on.
+    //It is 'pos' if 'r' is occupied at 'pos', or the start of the next
+    //range of the lifetime that holds 'r'. Return POS_UNDEF if 'r' will not
+    //be occupied after 'pos' by any active or inactive lifetime.
+    //skip: if it is not NULL, the ranges of the lifetime are ignored, e.g:
+    //      the lifetime that is going to be split.
+    Pos getRegFreeUntil(Reg r, Pos pos, LifeTime const* skip = nullptr);
     LifeTime * getLT(PRNO prno) const;
     CHAR const* getRegName(Reg r) const;
     CHAR const* getRegFileName(REGFILE rf) const;
@@ -1172,6 +1289,8 @@ public:
     LTSet & getActive() { return m_active; }
     LTSet & getInActive() { return m_inactive; }
     LTSet & getHandled() { return m_handled; }
+    LTEventQueue & getActiveEvent() { return m_active_event; }
+    LTEventQueue & getInActiveEvent() { return m_inactive_event; }
     IRTab & getSpillTab() { return m_spill_tab; }
     IRTab & getReloadTab() { return m_reload_tab; }
     IRTab & getRematTab() { return m_remat_tab; }
@@ -1490,6 +1609,13 @@ public:
     void tryComputeConstraints();
 
     bool verify4List() const;
+
+    //Check the result of transferring lifetimes at 'curpos'. Each lifetime
+    //in active set should contain 'curpos', and each lifetime in inactive
+    //set should cover 'curpos' in a hole. Since the transfer only revisits
+    //the lifetimes whose event position has been reached, the function
+    //walks the whole sets to make sure no state change is missed.
+    bool verify4Transfer(Pos curpos) const;
     bool verifyAfterRA() const;
 };
 
@@ -38,12 +38,15 @@ namespace xoc {
 
 //#define STATISTIC_LIVENESS
 #ifdef STATISTIC_LIVENESS
+//The variable is shared by all regions, it is guarded by the lock
+//of RegionMgr.
 static UINT g_max_times = 0;
 #endif
 
 static void statistic_liveness(Region const* rg)
 {
     #ifdef STATISTIC_LIVENESS
+    xcom::AutoLock lock(rg->getRegionMgr()->getLock());
     g_max_times = MAX(g_max_times, count);
     FileObj fo("liveness.sat.dump", false, false);
     fprintf(fo.getFileHandler(), "\n%s run %u times, maxtimes %u",
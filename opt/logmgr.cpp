@@ -308,76 +308,78 @@ void prtIndent(Region const* rg, UINT indent)
 //again. To dump to file, disable the option first.
 void LogMgr::dumpBuffer()
 {
-    if (isEnableBuffer() || m_ctx.buffer == nullptr) {
+    if (isEnableBuffer() || curCtx().buffer == nullptr) {
         //Buffer still enabled, the function will dump buffer into buffer
         //again. To dump to file, disable the LogMgr's option at first.
         return;
     }
-    note_helper(this, *m_ctx.buffer);
+    note_helper(this, *curCtx().buffer);
 }
 
 
 void LogMgr::startBuffer()
 {
-    m_ctx.enable_buffer = true;
-    if (m_ctx.buffer != nullptr) {
-        m_ctx.buffer->clean();
+    curCtx().enable_buffer = true;
+    if (curCtx().buffer != nullptr) {
+        curCtx().buffer->clean();
         return;
     }
-    m_ctx.buffer = new xcom::StrBuf(LOGCTX_DEFAULT_BUFFER_SIZE);
-    m_buftab.append(m_ctx.buffer);
+    curCtx().buffer = new xcom::StrBuf(LOGCTX_DEFAULT_BUFFER_SIZE);
+    xcom::AutoLock lock(&m_lock);
+    m_buftab.append(curCtx().buffer);
 }
 
 
 void LogMgr::endBuffer(bool is_flush_out_buffer)
 {
-    m_ctx.enable_buffer = false;
+    curCtx().enable_buffer = false;
     if (is_flush_out_buffer) {
         dumpBuffer();
     }
-    if (m_ctx.buffer != nullptr) {
-        m_buftab.remove(m_ctx.buffer);
-        delete m_ctx.buffer;
-        m_ctx.buffer = nullptr;
+    if (curCtx().buffer != nullptr) {
+        xcom::AutoLock lock(&m_lock);
+        m_buftab.remove(curCtx().buffer);
+        delete curCtx().buffer;
+        curCtx().buffer = nullptr;
     }
 }
 
 
 void LogMgr::pauseBuffer()
 {
-    if (m_ctx.paused_buffer) { return; }
+    if (curCtx().paused_buffer) { return; }
     LogCtx tmp(getCurrentCtx());
     push(tmp);
-    m_ctx.paused_buffer = true;
-    m_ctx.enable_buffer = false;
+    curCtx().paused_buffer = true;
+    curCtx().enable_buffer = false;
 }
 
 
 void LogMgr::resumeBuffer()
 {
-    if (!m_ctx.paused_buffer) { return; }
+    if (!curCtx().paused_buffer) { return; }
     pop();
 }
 
 
 void LogMgr::cleanBuffer()
 {
-    if (m_ctx.buffer != nullptr) {
-        m_ctx.buffer->clean();
+    if (curCtx().buffer != nullptr) {
+        curCtx().buffer->clean();
     }
 }
 
 
 void LogMgr::flushBuffer()
 {
-    if (!isEnableBuffer() || m_ctx.buffer == nullptr) {
+    if (!isEnableBuffer() || curCtx().buffer == nullptr) {
         //Buffer is not enabled.
         return;
     }
-    m_ctx.enable_buffer = false;
+    curCtx().enable_buffer = false;
     dumpBuffer();
     cleanBuffer();
-    m_ctx.enable_buffer = true;
+    curCtx().enable_buffer = true;
 }
 
 
@@ -438,26 +440,88 @@ void LogMgr::push(FILE * h, CHAR const* filename)
     LogCtx ctx;
     ctx.logfile = h;
     ctx.logfile_name = filename;
-    ctx.indent = m_ctx.indent;
-    ctx.indent_char = m_ctx.indent_char;
+    ctx.indent = curCtx().indent;
+    ctx.indent_char = curCtx().indent_char;
     push(ctx);
 }
 
 
 void LogMgr::push(LogCtx const& ctx)
 {
-    ASSERT0(&ctx != &m_ctx);
-    //Note m_ctx record the current LogCtx, the old ctx is placed into stack.
-    m_ctx_stack.push(m_ctx);
-    m_ctx = ctx;
+    ASSERT0(&ctx != &curCtx());
+    //Note curCtx() record the current LogCtx, the old ctx is placed into
+    //stack.
+    curCtxStack().push(curCtx());
+    curCtx() = ctx;
 }
 
 
 void LogMgr::pop()
 {
-    //Use the ctx in stack as the current LogCtx, meanwhile m_ctx
+    //Use the ctx in stack as the current LogCtx, meanwhile curCtx()
     //will be overlapped.
-    m_ctx = m_ctx_stack.pop();
+    curCtx() = curCtxStack().pop();
+}
+
+
+void LogMgr::beginConcurrentDump(UINT thread_num)
+{
+    ASSERT0(m_thread_log == nullptr && thread_num > 0);
+    m_thread_log = new ThreadLog[thread_num];
+    m_thread_num = thread_num;
+    for (UINT i = 0; i < thread_num; i++) {
+        LogCtx & ctx = m_thread_log[i].ctx;
+        ctx.copyWithOutBuffer(m_ctx);
+        if (m_ctx.logfile != nullptr) {
+            ctx.logfile = ::tmpfile();
+            ASSERT0(ctx.logfile);
+        }
+    }
+    m_lock.enable(true);
+}
+
+
+void LogMgr::flushThreadDump(UINT idx)
+{
+    ASSERT0(m_thread_log && idx < m_thread_num);
+    ThreadLog & tl = m_thread_log[idx];
+    ASSERTN(tl.ctx_stack.get_elem_count() == 0,
+            ("push and pop are unpaired"));
+    if (tl.ctx.logfile == nullptr || m_ctx.logfile == nullptr) { return; }
+    ::fflush(tl.ctx.logfile);
+    ::rewind(tl.ctx.logfile);
+    {
+        xcom::AutoLock lock(&m_lock);
+        CHAR buf[4096];
+        size_t n;
+        while ((n = ::fread(buf, 1, sizeof(buf), tl.ctx.logfile)) > 0) {
+            ::fwrite(buf, 1, n, m_ctx.logfile);
+        }
+        ::fflush(m_ctx.logfile);
+    }
+    //Discard the content that has been written out.
+    ::fclose(tl.ctx.logfile);
+    tl.ctx.logfile = ::tmpfile();
+    ASSERT0(tl.ctx.logfile);
+}
+
+
+void LogMgr::endConcurrentDump()
+{
+    ASSERT0(m_thread_log);
+    m_lock.enable(false);
+    for (UINT i = 0; i < m_thread_num; i++) {
+        flushThreadDump(i);
+        LogCtx & ctx = m_thread_log[i].ctx;
+        if (ctx.logfile != nullptr) { ::fclose(ctx.logfile); }
+        if (ctx.buffer != nullptr) {
+            m_buftab.remove(ctx.buffer);
+            delete ctx.buffer;
+        }
+    }
+    delete [] m_thread_log;
+    m_thread_log = nullptr;
+    m_thread_num = 0;
 }
 //END LogMgr
 
@@ -147,22 +147,74 @@ public:
 class LogMgr {
     COPY_CONSTRUCTOR(LogMgr);
 protected:
+    //The log state of a worker thread while regions are processed
+    //concurrently. Each thread dumps into its own temporary file, which is
+    //appended to the log file when the thread finishes a region.
+    class ThreadLog {
+    public:
+        LogCtx ctx;
+        Stack<LogCtx> ctx_stack;
+    };
     LogCtx m_ctx; //record the current LogCtx.
     Stack<LogCtx> m_ctx_stack;
     TTab<xcom::StrBuf*> m_buftab;
+
+    //Record the log state of each worker thread, it is NULL if regions are
+    //not processed concurrently.
+    ThreadLog * m_thread_log;
+    UINT m_thread_num;
+
+    //The lock guards the log file and dump buffer table while regions are
+    //processed concurrently.
+    xcom::Mutex m_lock;
+protected:
+    //Return the LogCtx of current thread.
+    LogCtx & curCtx()
+    {
+        return m_thread_log == nullptr ?
+            m_ctx : m_thread_log[xcom::getThreadIdx()].ctx;
+    }
+    LogCtx const& curCtx() const
+    { return const_cast<LogMgr*>(this)->curCtx(); }
+
+    //Return the LogCtx stack of current thread.
+    Stack<LogCtx> & curCtxStack()
+    {
+        return m_thread_log == nullptr ?
+            m_ctx_stack : m_thread_log[xcom::getThreadIdx()].ctx_stack;
+    }
+
+    //Append the dump of worker thread 'idx' into log file.
+    void flushThreadDump(UINT idx);
 public:
-    LogMgr() { init(nullptr, false); }
-    LogMgr(CHAR const* logfilename, bool is_del) { init(logfilename, is_del); }
+    LogMgr() : m_thread_log(nullptr), m_thread_num(0)
+    { init(nullptr, false); }
+    LogMgr(CHAR const* logfilename, bool is_del)
+        : m_thread_log(nullptr), m_thread_num(0)
+    { init(logfilename, is_del); }
     ~LogMgr() { fini(); }
 
     //Clean the dump buffer.
     void cleanBuffer();
 
+    //Prepare the log state for 'thread_num' worker threads. The dump of
+    //worker thread is buffered until flushThreadDump() is invoked.
+    void beginConcurrentDump(UINT thread_num);
+
+    //Append the buffered dump of all worker threads into log file, and
+    //restore the non-concurrent log state.
+    void endConcurrentDump();
+
+    //Append the buffered dump of current worker thread into log file.
+    //The function is invoked when the thread finished a region, thus the
+    //dump of different regions will not be interleaved.
+    void flushThreadDump() { flushThreadDump(xcom::getThreadIdx()); }
+
     //Decrease indent by value v.
     void decIndent(UINT v)
     {
-        m_ctx.indent -= (INT)v;
-        ASSERT0(m_ctx.indent >= 0);
+        curCtx().indent -= (INT)v;
+        ASSERT0(curCtx().indent >= 0);
     }
     void dumpBuffer();
 
@@ -180,16 +232,16 @@ public:
     //The function flush buffer content to file, whereas clean the buffer.
     void flushBuffer();
 
-    LogCtx & getCurrentCtx() { return m_ctx; }
-    FILE * getFileHandler() const { return m_ctx.logfile; }
-    CHAR const* getFileName() const { return m_ctx.logfile_name; }
-    INT getIndent() const { return m_ctx.indent; }
-    CHAR getIndentChar() const { return m_ctx.indent_char; }
-    xcom::StrBuf * getBuffer() { return m_ctx.buffer; }
+    LogCtx & getCurrentCtx() { return curCtx(); }
+    FILE * getFileHandler() const { return curCtx().logfile; }
+    CHAR const* getFileName() const { return curCtx().logfile_name; }
+    INT getIndent() const { return curCtx().indent; }
+    CHAR getIndentChar() const { return curCtx().indent_char; }
+    xcom::StrBuf * getBuffer() { return curCtx().buffer; }
 
     //Return true if replace 'newline' charactor with '\l' when
     //dumpping DOT file.
-    bool isReplaceNewline() const { return m_ctx.replace_newline; }
+    bool isReplaceNewline() const { return curCtx().replace_newline; }
 
     //Initialize a log file.
     //logfilename: the file name of log file.
@@ -197,16 +249,16 @@ public:
     void init(CHAR const* logfilename, bool is_del);
 
     //Increase indent by value v.
-    void incIndent(UINT v) { m_ctx.indent += (INT)v; }
+    void incIndent(UINT v) { curCtx().indent += (INT)v; }
 
     //Return true if LogMgr has initialized.
     bool is_init() const { return isInitLogFile(); }
 
     //Return true if LogMgr enables dump buffer.
-    bool isEnableBuffer() const { return m_ctx.enable_buffer; }
+    bool isEnableBuffer() const { return curCtx().enable_buffer; }
 
     //Return true if LogMgr enables dump file.
-    bool isInitLogFile() const { return m_ctx.logfile != nullptr; }
+    bool isInitLogFile() const { return curCtx().logfile != nullptr; }
 
     //Stop dump to buffer for temporary purpose. And when buffer paused, the
     //output content will write to file.
@@ -230,11 +282,11 @@ public:
     void pop();
 
     //Set indent by value v.
-    void setIndent(UINT v) { m_ctx.indent = (INT)v; }
+    void setIndent(UINT v) { curCtx().indent = (INT)v; }
 
     //Replace 'newline' charactor with '\l' when dumpping DOT file when
     //replace is true.
-    void setReplaceNewline(bool replace) { m_ctx.replace_newline = replace; }
+    void setReplaceNewline(bool replace) { curCtx().replace_newline = replace; }
 
     //Enable and clean the dump buffer.
     void startBuffer();
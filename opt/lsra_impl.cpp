@@ -199,19 +199,31 @@ static void dumpSelectSplitCand(LSRAImpl & lsra, LifeTime const* lt,
 }
 
 
-static LifeTime * pickFromSet(PRNO prno, MOD LTSet & set)
+//The lifetime of 'prno' is located by the holder map of 'set' rather than
+//walking the whole set.
+static LifeTime * pickFromSet(LinearScanRA const& ra, PRNO prno,
+                              MOD LTSet & set)
 {
-    LTSetIter it;
-    LTSetIter nit;
-    for (set.get_head(&it), nit = it; it != nullptr; it = nit) {
-        set.get_next(&nit);
-        LifeTime * lt = it->val();
-        if (lt->getPrno() == prno) {
-            set.remove(it);
-            return lt;
-        }
+    LifeTime * lt = ra.getLT(prno);
+    if (lt == nullptr || !set.find(lt)) { return nullptr; }
+    set.remove(lt);
+    return lt;
+}
+
+
+//Return the position at which the state of 'lt' that observed at 'curpos'
+//may change. If 'curpos' is in a range of 'lt', the position is the one
+//just after the range, otherwise it is the start of next range.
+static Pos computeNextEventPos(LifeTime const* lt, Pos curpos)
+{
+    Range r;
+    VecIdx ridx;
+    VecIdx great = VEC_UNDEF;
+    if (lt->findRange(curpos, r, ridx, nullptr, &great)) {
+        return r.end() + 1;
     }
-    return nullptr;
+    if (great == VEC_UNDEF) { return lt->getLastPos() + 1; }
+    return lt->getRange(great).start();
 }
 
 
@@ -1322,31 +1334,44 @@ SplitMgr::SplitMgr(LSRAImpl & impl) : m_impl(impl), m_ra(impl.getRA())
     m_cfg = m_ra.getCFG();
     m_oc = m_impl.getOptCtx();
     m_live_mgr = impl.getLiveMgr();
+    m_is_cand_computed = false;
+    m_cand_split_pos = POS_UNDEF;
+    m_cand_split_lt = nullptr;
 }
 
 
 LifeTime * SplitMgr::selectLTByPrioAndNextOcc(LTSet const& lst, Pos pos,
                                               Vector<SplitCtx> const& ctxvec,
+                                              Vector<bool> const& fitvec,
                                               OUT Occ & reload_occ)
 {
     VecIdx cnt = 0;
     ASSERT0(ctxvec.get_elem_count() == lst.get_elem_count());
     Occ next_occ;
+    bool selected_fit = false;
     LifeTime * selected_lt = nullptr;
     LTSetIter it;
     for (LifeTime * t = lst.get_head(&it);
          t != nullptr; t = lst.get_next(&it), cnt++) {
         SplitCtx l = ctxvec.get(cnt);
+        bool fit = fitvec.get(cnt);
         if (selected_lt == nullptr) {
             next_occ = l.reload_occ;
+            selected_fit = fit;
             selected_lt = t;
             continue;
         }
         if (t->getPriority() - selected_lt->getPriority() > EPSILON) {
             continue;
         }
-        if (next_occ.pos() > l.reload_pos) { continue; }
+        //The register that is free until the end of assigning lifetime
+        //avoids splitting the assigning lifetime again.
+        if (selected_fit && !fit) { continue; }
+        if (selected_fit == fit && next_occ.pos() > l.reload_pos) {
+            continue;
+        }
         next_occ = l.reload_occ;
+        selected_fit = fit;
         selected_lt = t;
     }
     if (selected_lt == nullptr) { return nullptr; }
@@ -1407,9 +1432,8 @@ LifeTime * SplitMgr::selectLTByFurthestNextRange(LTSet const& lst, Pos pos,
 }
 
 
-void SplitMgr::selectSplitCandFromSet(LTSet const& set, SplitCtx const& ctx,
-                                      OUT LTSet & candlst,
-                                      OUT Vector<SplitCtx> & candctxvec)
+void SplitMgr::collectSplitCandFromSet(LTSet const& set,
+                                       SplitCtx const& ctx)
 {
     LTSetIter it;
     LTSetIter nit;
@@ -1435,9 +1459,34 @@ void SplitMgr::selectSplitCandFromSet(LTSet const& set, SplitCtx const& ctx,
         bool canbe = checkIfCanBeSplitCand(t, ctx.split_pos, lctx.reload_pos,
                                            lctx.reload_occ);
         if (!canbe) { continue; }
-        candlst.append_tail(t);
-        candctxvec.append(lctx);
+
+        //The register is free until the first range of its holders that
+        //starts after split position. The ranges of 't' are not counted
+        //because 't' releases the register once it is split.
+        Pos free_until = m_ra.getRegFreeUntil(r, ctx.split_pos, t);
+        bool fit = free_until == POS_UNDEF ||
+                   free_until > ctx.split_lt->getLastPos();
+        m_cand_lst.append_tail(t);
+        m_cand_ctx.append(lctx);
+        m_cand_fit.append(fit);
+    }
+}
+
+
+void SplitMgr::computeSplitCand(SplitCtx const& ctx)
+{
+    if (m_is_cand_computed && m_cand_split_pos == ctx.split_pos &&
+        m_cand_split_lt == ctx.split_lt) {
+        return;
     }
+    m_cand_lst.clean();
+    m_cand_ctx.clean();
+    m_cand_fit.clean();
+    collectSplitCandFromSet(m_ra.getInActive(), ctx);
+    collectSplitCandFromSet(m_ra.getActive(), ctx);
+    m_cand_split_pos = ctx.split_pos;
+    m_cand_split_lt = ctx.split_lt;
+    m_is_cand_computed = true;
 }
 
 
@@ -1456,7 +1505,18 @@ LifeTime * SplitMgr::selectSplitCandImpl(LTSet & set, LifeTime * lt,
 {
     LTSet candlst;
     Vector<SplitCtx> candctxvec;
-    selectSplitCandFromSet(set, ctx, candlst, candctxvec);
+    Vector<bool> candfitvec;
+    computeSplitCand(ctx);
+    LTSetIter cit;
+    VecIdx cnt = 0;
+    for (LifeTime * t = m_cand_lst.get_head(&cit);
+         t != nullptr; t = m_cand_lst.get_next(&cit), cnt++) {
+        //Candidate may have been moved out of 'set' by former selection.
+        if (!set.find(t)) { continue; }
+        candlst.append_tail(t);
+        candctxvec.append(m_cand_ctx.get(cnt));
+        candfitvec.append(m_cand_fit.get(cnt));
+    }
     if (tryself) {
         OccListIter it;
         bool succ = lt->findOccAfter(ctx.split_pos, it);
@@ -1470,6 +1530,7 @@ LifeTime * SplitMgr::selectSplitCandImpl(LTSet & set, LifeTime * lt,
         }
         candlst.append_tail(lt);
         candctxvec.append(lctx);
+        candfitvec.append(false);
     }
     if (candlst.get_elem_count() == 0) {
         return nullptr;
@@ -1477,7 +1538,8 @@ LifeTime * SplitMgr::selectSplitCandImpl(LTSet & set, LifeTime * lt,
     //Attempt to select a lifetime with least priority and the biggest hole to
     //contain the entire given 'lt'.
     LifeTime * cand = selectLTByPrioAndNextOcc(candlst, ctx.split_pos,
-                                               candctxvec, ctx.reload_occ);
+                                               candctxvec, candfitvec,
+                                               ctx.reload_occ);
     ASSERT0(cand);
     ctx.reload_pos = ctx.reload_occ.pos();
     //candidate may not have reload_pos.
@@ -1582,6 +1644,7 @@ void SplitMgr::shrinkLTToSplitPos(LifeTime * lt, Pos split_pos,
     }
     lt->cleanRangeFrom(split_pos);
     ASSERT0(lt->getFirstRange().start() > POS_UNDEF);
+    m_ra.updateShrinkedLT(lt);
 }
 
 
@@ -1595,6 +1658,7 @@ void SplitMgr::cutoffLTFromSpillPos(LifeTime * lt, Pos split_pos)
     Pos nextpos = split_pos;
     UpdatePos::inc(nextpos);
     lt->cleanRangeFrom(nextpos);
+    m_ra.updateShrinkedLT(lt);
 }
 
 
@@ -1814,6 +1878,7 @@ LifeTime * SplitMgr::splitIntoTwoLT(LifeTime * lt, SplitCtx const& ctx)
     //    |                u
     // POS: 2              17
     lt->shrinkForwardToLastOccPos();
+    m_ra.updateShrinkedLT(lt);
     newlt->inheritAttrFlag(lt);
     m_ra.setReg(newlt->getPrno(), REG_UNDEF);
     if (newlt->isDedicated()) {
@@ -1947,7 +2012,7 @@ LifeTime * LSRAImpl::selectAssignDefCand(Pos curpos, IR const* curstmt)
 {
     IR const* res = const_cast<IR*>(curstmt)->getResultPR();
     if (res == nullptr) { return nullptr; }
-    return pickFromSet(res->getPrno(), m_ra.getUnhandled());
+    return pickFromSet(m_ra, res->getPrno(), m_ra.getUnhandled());
 }
 
 
@@ -1974,7 +2039,8 @@ LifeTime * LSRAImpl::selectAssignUseCand(Pos curpos, IR const* curstmt,
         break;
     }
     if (cand == nullptr) { return nullptr; }
-    LifeTime * candlt = pickFromSet(cand->getPrno(), m_ra.getUnhandled());
+    LifeTime * candlt = pickFromSet(m_ra, cand->getPrno(),
+                                      m_ra.getUnhandled());
     ASSERT0(candlt);
     *curir = cand;
     return candlt;
@@ -2098,61 +2164,79 @@ void LSRAImpl::tryAssignRegForIR(Pos pos, IR const* ir, LifeTime * lt)
 }
 
 
+//Only the lifetimes whose event position has been reached are revisited.
 void LSRAImpl::transferInActive(Pos curpos)
 {
-    LTSetIter it;
-    LTSetIter nit;
     LTSet & act = m_ra.getActive();
     LTSet & handled = m_ra.getHandled();
     LTSet & inact = m_ra.getInActive();
-    for (inact.get_head(&it), nit = it; it != nullptr; it = nit) {
-        inact.get_next(&nit);
-        LifeTime * lt = it->val();
+    LTEventQueue & event = m_ra.getInActiveEvent();
+    for (LifeTime * lt = event.popUntil(curpos);
+         lt != nullptr; lt = event.popUntil(curpos)) {
+        if (!inact.find(lt)) {
+            //lt has been removed from inactive, e.g: splitted.
+            continue;
+        }
         if (!lt->is_cover(curpos)) {
             //lt even not conver 'curpos', it has been handled.
             //Transfer lt to handled and free targ-machine resource.
-            inact.remove(it);
+            inact.remove(lt);
             handled.append_tail(lt);
             m_rsimpl.freeReg(lt);
             continue;
         }
+        Pos next = computeNextEventPos(lt, curpos);
+        ASSERT0(next > curpos);
         if (lt->is_contain(curpos)) {
             //lt is not only conver 'curpos' but also in a range.
             //Transfer lt to active.
-            inact.remove(it);
+            inact.remove(lt);
             act.append_tail(lt);
+            m_ra.getActiveEvent().push(next, lt);
             continue;
         }
+        //lt is still in a hole.
+        event.push(next, lt);
     }
 }
 
 
+//Only the lifetimes whose event position has been reached are revisited.
 void LSRAImpl::transferActive(Pos curpos)
 {
-    LTSetIter it;
-    LTSetIter nit;
     LTSet & act = m_ra.getActive();
     LTSet & handled = m_ra.getHandled();
     LTSet & inact = m_ra.getInActive();
-    for (act.get_head(&it), nit = it; it != nullptr; it = nit) {
-        act.get_next(&nit);
-        LifeTime * lt = it->val();
+    LTEventQueue & event = m_ra.getActiveEvent();
+    for (LifeTime * lt = event.popUntil(curpos);
+         lt != nullptr; lt = event.popUntil(curpos)) {
+        if (!act.find(lt)) {
+            //lt has been removed from active, e.g: splitted.
+            continue;
+        }
         if (!lt->is_cover(curpos)) {
             //lt even not conver 'curpos', it has been handled.
             //Transfer lt to handled and free targ-machine resource.
-            act.remove(it);
+            act.remove(lt);
             handled.append_tail(lt);
             m_rsimpl.freeReg(lt);
             continue;
         }
+        Pos next = computeNextEventPos(lt, curpos);
+        ASSERT0(next > curpos);
         if (!lt->is_contain(curpos)) {
             //lt convers 'curpos' but in a hole.
             //Transfer lt to inactive.
-            act.remove(it);
+            act.remove(lt);
             inact.append_tail(lt);
+            m_ra.getInActiveEvent().push(next, lt);
             continue;
         }
+        //lt is still in a range.
+        event.push(next, lt);
     }
+    //transferInActive() has been performed at 'curpos' before.
+    ASSERT0L3(m_ra.verify4Transfer(curpos));
 }
 
 
@@ -2533,6 +2617,7 @@ void LSRAImpl::checkAndDoForceReload(LifeTime * lt, Pos curpos,
     Range r = lt->getFirstRange();
     RG_start(r) = curpos;
     lt->setRange(0, r);
+    m_ra.updateShrinkedLT(lt);
 
     //Set force-reload flag.
     lt->setReloadForced();
@@ -569,6 +569,20 @@ class SplitMgr {
     OptCtx * m_oc;
     LivenessMgr * m_live_mgr;
     LTTab m_dont_split_tab;
+
+    //Record the splitting-candidates that hold registers at the position of
+    //conflict. The next-use and free-until of each register are computed
+    //in a single pass over active and inactive set, and are reused by each
+    //attempt to solve the conflict.
+    bool m_is_cand_computed;
+    Pos m_cand_split_pos; //the split position that candidates computed at.
+    LifeTime const* m_cand_split_lt; //the lifetime that candidates serve.
+    LTSet m_cand_lst;
+    Vector<SplitCtx> m_cand_ctx; //next-use of candidate.
+
+    //True if the register of candidate is free until the end of the
+    //lifetime that is being assigned.
+    Vector<bool> m_cand_fit;
 private:
     //The function shrinks lifetime to properly position.
     void cutoffLTFromSpillPos(LifeTime * lt, Pos pos);
@@ -599,9 +613,11 @@ private:
     //The function shrinks lifetime to properly position.
     void shrinkLTToSplitPos(LifeTime * lt, Pos split_pos,
                             IR const* split_pos_ir);
-    void selectSplitCandFromSet(LTSet const& set, SplitCtx const& ctx,
-                                OUT LTSet & candlst,
-                                OUT Vector<SplitCtx> & candctxvec);
+    void collectSplitCandFromSet(LTSet const& set, SplitCtx const& ctx);
+
+    //Compute the next-use and free-until of the register of each
+    //splitting-candidate in active and inactive set.
+    void computeSplitCand(SplitCtx const& ctx);
     LifeTime * selectSplitCandImpl(LTSet & set, LifeTime * lt, bool tryself,
                                    OUT SplitCtx & ctx);
     LifeTime * selectSplitCandByDensity(LTSet & set, LifeTime * lt,
@@ -624,7 +640,9 @@ private:
                                            OUT Occ & reload_occ);
 
     //The function selects a lifetime from 'lst' which has the least priority
-    //and the next-occ from given position is the furthest.
+    //and the next-occ from given position is the furthest. The lifetime
+    //whose register is free until the end of the assigning lifetime, see
+    //'fitvec', is preferred to the one with furthest next-occ.
     //e.g: given pos is 10, and two lifetimes with the same priority in 'lst'.
     //    lt1:  <5-40>, next-occ is in 20
     //    lt2:  <5-25>, next-occ is in 25
@@ -632,6 +650,7 @@ private:
     //Return nullptr if there is no lifetime has next-occ.
     LifeTime * selectLTByPrioAndNextOcc(LTSet const& lst, Pos pos,
                                         Vector<SplitCtx> const& ctxvec,
+                                        Vector<bool> const& fitvec,
                                         OUT Occ & reload_occ);
 
     //This function shrinks the split position to the last occ of the lifetime
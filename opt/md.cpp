@@ -502,10 +502,89 @@ MD * MDSet::get_unique_md(MDSystem const* ms) const
 //
 //START MDSetHash
 //
+MDSet const* MDSetHash::append(MD const* md)
+{
+    ASSERT0(md);
+    MDSet tmp;
+    tmp.bunion(md, *getBsMgr());
+    MDSet const* hashed = append(tmp);
+    tmp.clean(*getBsMgr());
+    return hashed;
+}
+
+
+//Perform 'op' on hashed sets and return the hashed result.
+MDSet const* MDSetHash::compute(MDSET_OP op, MDSet const* set1,
+                                MDSet const* set2)
+{
+    ASSERT0(set1 && set2);
+    ASSERT0(find(*set1) && find(*set2));
+    MDSetOpKey key(op, set1, set2);
+    bool memoized = false;
+    MDSet const* res = m_memo.get(key, &memoized);
+    if (memoized) {
+        m_num_memo_hit++;
+        return res;
+    }
+    m_num_memo_miss++;
+    MDSet tmp;
+    tmp.copy(*set1, *getBsMgr());
+    switch (op) {
+    case MDSET_OP_UNION:
+        tmp.bunion(*set2, *getBsMgr());
+        break;
+    case MDSET_OP_INTERSECT:
+        tmp.intersect(*set2, *getBsMgr());
+        break;
+    case MDSET_OP_DIFF:
+        //Plain bitset difference, MDSet::diff() complains about FULL_MEM.
+        ((DefSBitSetCore&)tmp).diff(*set2, *getBsMgr());
+        break;
+    default: UNREACHABLE();
+    }
+    res = append(tmp);
+    tmp.clean(*getBsMgr());
+    m_memo.set(key, res);
+    return res;
+}
+
+
+MDSet const* MDSetHash::bunion(MDSet const* set1, MDSet const* set2)
+{
+    if (set1 == nullptr || set1 == set2) { return set2; }
+    if (set2 == nullptr) { return set1; }
+
+    //Union is commutative, normalize the operands to share the memo.
+    if (set2 < set1) { xcom::swap(set1, set2); }
+    return compute(MDSET_OP_UNION, set1, set2);
+}
+
+
+MDSet const* MDSetHash::intersect(MDSet const* set1, MDSet const* set2)
+{
+    if (set1 == nullptr || set2 == nullptr) { return nullptr; }
+    if (set1 == set2) { return set1; }
+
+    //Intersection is commutative, normalize the operands to share the memo.
+    if (set2 < set1) { xcom::swap(set1, set2); }
+    return compute(MDSET_OP_INTERSECT, set1, set2);
+}
+
+
+MDSet const* MDSetHash::diff(MDSet const* set1, MDSet const* set2)
+{
+    if (set1 == nullptr || set1 == set2) { return nullptr; }
+    if (set2 == nullptr) { return set1; }
+    return compute(MDSET_OP_DIFF, set1, set2);
+}
+
+
 void MDSetHash::dump(Region * rg)
 {
     if (!rg->isLogMgrInit()) { return; }
     note(rg, "\n==-- DUMP MDSet Hash --==\n");
+    note(rg, "\nMEMO:%u, HIT:%u, MISS:%u", m_memo.get_elem_count(),
+         m_num_memo_hit, m_num_memo_miss);
     rg->getLogMgr()->incIndent(2);
     xcom::StrBuf buf(128);
     SBitSetCoreHash<MDSetHashAllocator>::dump_hashed_set(buf);
@@ -743,6 +822,7 @@ void MD2MDSet::dump(Region * rg)
 MD const* MDSystem::registerMD(MD const& m)
 {
     ASSERT0(MD_base(&m));
+    xcom::AutoWriteLock lock(&m_lock);
     if (MD_id(&m) > 0) {
         //Find the entry in MDTab according to m.
         MDTab * mdtab = getMDTab(MD_base(&m));
@@ -1037,6 +1117,7 @@ void MDSystem::computeOverlap(Region * current_rg, MD const* md,
                               DefMiscBitSetMgr & mbsmgr, bool strictly)
 {
     ASSERT0(md && current_rg);
+    xcom::AutoReadLock lock(&m_lock);
     if (strictly) {
         addDelegate(current_rg, md, output, mbsmgr);
     }
@@ -1081,6 +1162,7 @@ void MDSystem::computeOverlapExactMD(MD const* md, OUT MDSet * output,
                                      DefMiscBitSetMgr & mbsmgr)
 {
     ASSERT0(md && md->is_exact());
+    xcom::AutoReadLock lock(&m_lock);
     MDTab * mdt = getMDTab(MD_base(md));
     ASSERT0(mdt);
 
@@ -1112,6 +1194,7 @@ void MDSystem::computeOverlap(Region * current_rg, MOD MDSet & mds,
                               DefMiscBitSetMgr & mbsmgr, bool strictly)
 {
     ASSERT0(current_rg);
+    xcom::AutoReadLock lock(&m_lock);
     UINT count = 0;
     added.clean();
     bool set_global = false;
@@ -1224,6 +1307,7 @@ void MDSystem::computeOverlap(Region * current_rg, MDSet const& mds,
 {
     ASSERT0(&mds != &output);
     ASSERT0(current_rg);
+    xcom::AutoReadLock lock(&m_lock);
     bool has_global = false;
     bool has_import = false;
     bool has_local = false;
@@ -1287,6 +1371,7 @@ void MDSystem::computeOverlap(Region * current_rg, MDSet const& mds,
 
 void MDSystem::clean()
 {
+    xcom::AutoWriteLock lock(&m_lock);
     Var2MDTabIter iter;
     MDTab * mdtab;
     for (Var const* var = m_var2mdtab.get_first(iter, &mdtab);
@@ -1326,6 +1411,7 @@ void MDSystem::dump(VarMgr const* vm, bool only_dump_nonpr_md)
 void MDSystem::removeMDforVAR(Var const* v, ConstMDIter & iter)
 {
     ASSERT0(v);
+    xcom::AutoWriteLock lock(&m_lock);
     MDTab * mdtab = getMDTab(v);
     if (mdtab != nullptr) {
         MD const* x = mdtab->get_effect_md();
@@ -634,15 +634,92 @@ public:
 };
 
 
+typedef enum _MDSET_OP {
+    MDSET_OP_UNDEF = 0,
+    MDSET_OP_UNION,
+    MDSET_OP_INTERSECT,
+    MDSET_OP_DIFF,
+} MDSET_OP;
+
+
+//The key of the memoized operation on two hashed MDSets.
+//Since hashed MDSet is unique, its address is used as the identity.
+class MDSetOpKey {
+public:
+    MDSET_OP op;
+    MDSet const* set1;
+    MDSet const* set2;
+public:
+    MDSetOpKey(INT v = 0) : op((MDSET_OP)v), set1(nullptr), set2(nullptr) {}
+    MDSetOpKey(MDSET_OP o, MDSet const* s1, MDSet const* s2) :
+        op(o), set1(s1), set2(s2) {}
+};
+
+
+class CompareMDSetOpKey {
+public:
+    bool is_less(MDSetOpKey const& t1, MDSetOpKey const& t2) const
+    {
+        if (t1.op != t2.op) { return t1.op < t2.op; }
+        if (t1.set1 != t2.set1) { return t1.set1 < t2.set1; }
+        return t1.set2 < t2.set2;
+    }
+    bool is_equ(MDSetOpKey const& t1, MDSetOpKey const& t2) const
+    { return t1.op == t2.op && t1.set1 == t2.set1 && t1.set2 == t2.set2; }
+    MDSetOpKey createKey(MDSetOpKey const& t) { return t; }
+};
+
+
+typedef TMap<MDSetOpKey, MDSet const*, CompareMDSetOpKey> MDSetOpMemo;
+
+//The hash table of MDSet. Each MDSet appended is unique, thus two hashed
+//MDSets are equal if and only if their addresses are equal.
+//The class also supplies immutable set operations on hashed MDSets. The
+//result of operation is hashed as well and is memoized by the operation and
+//the operands, thus the repeated operation does not materialize and rehash
+//a new MDSet.
+//NOTE: empty set is represented by nullptr, as append() does.
 class MDSetHash : public SBitSetCoreHash<MDSetHashAllocator> {
+    COPY_CONSTRUCTOR(MDSetHash);
+protected:
+    UINT m_num_memo_hit;
+    UINT m_num_memo_miss;
+    MDSetOpMemo m_memo;
+protected:
+    MDSet const* compute(MDSET_OP op, MDSet const* set1, MDSet const* set2);
+    DefMiscBitSetMgr * getBsMgr() const { return m_allocator->getBsMgr(); }
 public:
     MDSetHash(MDSetHashAllocator * allocator) :
-        SBitSetCoreHash<MDSetHashAllocator>(allocator) {}
+        SBitSetCoreHash<MDSetHashAllocator>(allocator)
+    {
+        m_num_memo_hit = 0;
+        m_num_memo_miss = 0;
+    }
     virtual ~MDSetHash() {}
 
     MDSet const* append(SBitSetCore<> const& set)
     { return (MDSet const*)SBitSetCoreHash<MDSetHashAllocator>::append(set); }
 
+    //Return the hashed MDSet that only contains 'md'.
+    MDSet const* append(MD const* md);
+
+    //Return the hashed union of 'set1' and 'set2'.
+    //set1, set2: hashed MDSet, or nullptr that indicates empty set.
+    MDSet const* bunion(MDSet const* set1, MDSet const* set2);
+
+    //Return the hashed union of 'set' and 'md'.
+    //set: hashed MDSet, or nullptr that indicates empty set.
+    MDSet const* bunion(MDSet const* set, MD const* md)
+    { return bunion(set, append(md)); }
+
+    //Return the hashed intersection of 'set1' and 'set2'.
+    //set1, set2: hashed MDSet, or nullptr that indicates empty set.
+    MDSet const* intersect(MDSet const* set1, MDSet const* set2);
+
+    //Return the hashed set that is 'set1' minus 'set2'.
+    //set1, set2: hashed MDSet, or nullptr that indicates empty set.
+    MDSet const* diff(MDSet const* set1, MDSet const* set2);
+
     void dump(Region * rg);
 };
 
@@ -665,6 +742,11 @@ protected:
     SMemPool * m_pool;
     SMemPool * m_sc_mdptr_pool;
     TypeMgr * m_tm;
+
+    //The lock guards the MD tables when regions are processed
+    //concurrently. Lookups take the read lock, whereas registration and
+    //removal take the write lock.
+    mutable xcom::RWLock m_lock;
     MD const* m_full_mem;
     MD const * m_global_mem;
     MD const * m_import_mem;
@@ -771,11 +853,15 @@ public:
     MD const* getDelegate(Region const* rg, MD const* md) const;
     TypeMgr * getTypeMgr() const { return m_tm; }
 
+    //Return the lock that guards the MD tables.
+    xcom::RWLock * getLock() { return &m_lock; }
+
     //Get registered MD.
     //NOTICE: DO NOT free the return value, because it is the registered one.
     MD * getMD(MDIdx id) const
     {
         ASSERT0(id != MD_UNDEF);
+        xcom::AutoReadLock lock(&m_lock);
         MD * md = m_id2md_map.get(id);
         ASSERT0(md == nullptr || MD_id(md) == id);
         return md;
@@ -803,6 +889,7 @@ public:
     MD const* readMD(MDIdx id) const
     {
         ASSERT0(id != MD_UNDEF);
+        xcom::AutoReadLock lock(&m_lock);
         MD * md = m_id2md_map.get(id);
         ASSERT0(md == nullptr || MD_id(md) == id);
         return md;
@@ -812,6 +899,7 @@ public:
     MDTab * getMDTab(Var const* v)
     {
         ASSERT0(v);
+        xcom::AutoReadLock lock(&m_lock);
         return m_var2mdtab.get(v);
     }
     RegionMgr * getRegionMgr() const { return m_tm->getRegionMgr(); }
@@ -822,6 +910,7 @@ public:
     inline void freeMD(MD * md)
     {
         if (md == nullptr) { return; }
+        xcom::AutoWriteLock lock(&m_lock);
         m_id2md_map.remove(MD_id(md));
         MDIdx mdid = MD_id(md);
         ::memset((void*)md, 0, sizeof(MD));
@@ -843,7 +932,16 @@ public:
     { m_enable_local_var_delegate = enable; }
 };
 
+//MD2MDSet is the most frequently queried map of AA. Define USE_BTREE_MAP
+//to use B+-tree as its backend, which keeps sorted MD ids of a node in
+//cache line, otherwise red-black tree is used.
+#ifdef USE_BTREE_MAP
+typedef BTreeMap<MDIdx, MDSet const*> MD2MDSetBase;
+typedef BTreeMapIter<MDIdx, MDSet const*> MD2MDSetIter;
+#else
+typedef TMap<MDIdx, MDSet const*> MD2MDSetBase;
 typedef TMapIter<MDIdx, MDSet const*> MD2MDSetIter;
+#endif
 
 class CompareMDFunc {
 public:
@@ -863,7 +961,7 @@ public:
 //MD2MD_SET_MAP
 //Record MD->MDS relations.
 //Note MD may mapped to nullptr, means the MD does not point to anything.
-class MD2MDSet : public TMap<MDIdx, MDSet const*> {
+class MD2MDSet : public MD2MDSetBase {
     COPY_CONSTRUCTOR(MD2MDSet);
 public:
     MD2MDSet() {}
@@ -874,7 +972,7 @@ public:
     }
 
     //Clean each MD->MDSet, but do not free MDSet.
-    void clean() { TMap<MDIdx, MDSet const*>::clean(); }
+    void clean() { MD2MDSetBase::clean(); }
     //Compute the number of PtPair that recorded in current MD2MDSet.
     UINT computePtPairNum(MDSystem const& mdsys) const
     {
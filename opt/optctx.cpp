@@ -31,6 +31,25 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 namespace xoc {
 
+void OptCtx::addChangedBB(IRBB const* bb)
+{
+    ASSERT0(bb);
+    if (!is_loopinfo_valid()) {
+        //Be conservative.
+        addChangeKind(OC_CHANGE_STMT|OC_CHANGE_LOOP);
+        return;
+    }
+    for (LI<IRBB> const* li = m_rg->getCFG()->getLoopInfo();
+         li != nullptr; li = li->get_next()) {
+        if (li->isInsideLoop(bb->id())) {
+            addChangeKind(OC_CHANGE_LOOP);
+            return;
+        }
+    }
+    addChangeKind(OC_CHANGE_STMT);
+}
+
+
 void OptCtx::setValidPass(PASS_TYPE pt)
 {
     switch (pt) {
@@ -191,6 +210,7 @@ static void setInvalidIfCFGChangedExceptImpl(
 {
     ASSERTN(optlist.get_elem_count() < 1000,
             ("too many pass queried or miss ending placeholder"));
+    oc->addChangeKind(OC_CHANGE_CFG);
     if (optlist.get_elem_count() == 0) { return; }
     BitSet exclude;
     C<PASS_TYPE> * it;
@@ -207,6 +227,7 @@ static void setInvalidIfCFGChangedExceptImpl(
     if (!exclude.is_contain(PASS_PDOM)) { oc->setInvalidPDom(); }
     if (!exclude.is_contain(PASS_CDG)) { oc->setInvalidCDG(); }
     if (!exclude.is_contain(PASS_SCC)) { oc->setInvalidSCC(); }
+    if (!exclude.is_contain(PASS_VRP)) { oc->setInvalidPass(PASS_VRP); }
 }
 
 
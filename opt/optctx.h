@@ -32,8 +32,20 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 namespace xoc {
 
 class Region;
+class IRBB;
 typedef enum _PASS_TYPE PASS_TYPE; //forward declare PASS_TYPE
 
+//The kind of change that a pass made to region. Pass reports the kinds
+//through OptCtx, and the pass scheduler, e.g: ScalarOpt, reperforms a pass
+//only if the change kinds that it subscribed happened.
+typedef enum tagOC_CHANGE {
+    OC_CHANGE_UNDEF = 0x0,
+    OC_CHANGE_STMT = 0x1, //Stmt outside of any loop has been changed.
+    OC_CHANGE_LOOP = 0x2, //Stmt inside loop body has been changed.
+    OC_CHANGE_CFG = 0x4, //BB or edge of CFG has been changed.
+    OC_CHANGE_ALL = OC_CHANGE_STMT|OC_CHANGE_LOOP|OC_CHANGE_CFG,
+} OC_CHANGE;
+
 //Optimization Context
 //This class record and propagate auxiliary information to optimizations.
 //These options brief describe state of Passes following an optimization
@@ -55,6 +67,9 @@ typedef enum _PASS_TYPE PASS_TYPE; //forward declare PASS_TYPE
 #define OC_do_merge_label(o) ((o).u1.s1.do_merge_label)
 class OptCtx {
     Region * m_rg;
+
+    //Record the kinds of change that reported by passes, see OC_CHANGE.
+    UINT m_change_kind;
 private:
     void dumpFlag() const;
     void dumpPass() const;
@@ -94,23 +109,39 @@ public:
 public:
     OptCtx(Region * rg) { init(rg); }
 
+    //Report the change kinds that current pass made to region.
+    void addChangeKind(UINT kind) { m_change_kind |= kind; }
+
+    //Report that stmts in 'bb' have been changed. The change kind is
+    //figured out by LoopInfo, both STMT and LOOP are reported if LoopInfo
+    //is unavailable.
+    void addChangedBB(IRBB const* bb);
+
     void copy(OptCtx const& src) { *this = src; }
     void clean()
     {
+        cleanChangeKind();
         setInvalidAllFlags();
         //Expect label always can be merged.
         OC_do_merge_label(*this) = true;
     }
 
+    //Clean the change kinds that reported.
+    void cleanChangeKind() { m_change_kind = OC_CHANGE_UNDEF; }
+
     bool do_merge_label() const { return OC_do_merge_label(*this); }
     void dump() const;
 
+    //Return the change kinds that reported since last cleanChangeKind().
+    UINT getChangeKind() const { return m_change_kind; }
+
     Region * getRegion() const { return m_rg; }
 
     void init(Region * rg)
     {
         ASSERT0(rg);
         m_rg = rg;
+        m_change_kind = OC_CHANGE_UNDEF;
         u1.int1 = 0;
         //Expect label always can be merged.
         OC_do_merge_label(*this) = true;
@@ -173,7 +204,11 @@ public:
 
     //The function will invalidate flags which may be affected when PRSSA
     //reconstructed.
-    void setInvalidIfPRSSAReconstructed() {}
+    void setInvalidIfPRSSAReconstructed()
+    {
+        //VRP records value range for each PR.
+        setInvalidPass(PASS_VRP);
+    }
 
     //The function will invalidate flags which may be affected when data-flow
     //changed.
@@ -191,6 +226,7 @@ public:
     static void setInvalidIfCFGChangedExcept(OptCtx * oc, ...);
     void setInvalidIfCFGChanged()
     {
+        addChangeKind(OC_CHANGE_CFG);
         //OC_is_cfg_valid(*this) = false; CFG should always be maintained.
         setInvalidRPO();
         setInvalidLoopInfo();
@@ -198,6 +234,9 @@ public:
         setInvalidPDom();
         setInvalidCDG();
         setInvalidSCC();
+
+        //VRP narrows range by the conditions of dominators.
+        setInvalidPass(PASS_VRP);
     }
 
     //The function will invalidate flags which affected while DU chain
@@ -70,6 +70,10 @@ bool g_compute_nonpr_du_chain = false;
 bool g_compute_available_exp = false;
 bool g_compute_region_imported_defuse_md = false;
 bool g_compute_pr_du_chain_by_prssa = true;
+bool g_solve_du_set_by_worklist = true;
+bool g_compute_dom_by_semi_nca = true;
+UINT g_semi_nca_min_bb_num = 1000;
+bool g_schedule_scalar_opt_by_change = true;
 bool g_do_expr_tab = true;
 bool g_do_cp_aggressive = false;
 bool g_do_cp = false;
@@ -82,10 +86,18 @@ bool g_do_lftr = false;
 bool g_do_dse = false;
 bool g_do_gcse = true;
 bool g_do_ipa = false;
+bool g_do_ipa_modref = false;
 bool g_do_call_graph = false;
 bool g_show_time = false;
+bool g_do_prof = false;
+CHAR const* g_prof_trace_file = nullptr;
 bool g_do_inline = false;
 UINT g_inline_threshold = 10;
+UINT g_inline_size_threshold = 40;
+UINT g_inline_caller_growth = 100;
+UINT g_inline_program_growth = 50;
+UINT g_thread_num = 1;
+bool g_process_func_region_in_program = false;
 bool g_do_ivr = false;
 bool g_do_lcse = false;
 bool g_do_licm = false;
@@ -94,6 +106,7 @@ bool g_do_gvn = true;
 bool g_do_pre = false;
 bool g_do_rce = false;
 bool g_do_vect = true;
+UINT g_vect_reg_byte_size = VECTOR_REGISTER_BYTE_SIZE;
 bool g_do_multi_res_convert = true;
 bool g_do_targinfo_handler = true;
 bool g_do_alge_reasscociate = true;
@@ -101,10 +114,12 @@ bool g_do_loop_dep_ana = false;
 bool g_do_rp = false;
 bool g_do_prssa = false;
 bool g_do_mdssa = false;
+bool g_mdssa_build_on_demand = false;
 UINT g_thres_opt_bb_num = 100000;
 UINT g_thres_ptpair_num = 10000;
 UINT g_thres_opt_ir_num = 30000;
 UINT g_thres_opt_ir_num_in_bb = 10000;
+ULONGLONG g_thres_region_mem_size = 0;
 bool g_do_loop_convert = false;
 bool g_do_poly_tran = false;
 bool g_do_refine_duchain = true;
@@ -236,6 +251,9 @@ void DumpOption::setDumpNothing()
     is_dump_cp = false;
     is_dump_rp = false;
     is_dump_dce = false;
+    is_dump_dse = false;
+    is_dump_inliner = false;
+    is_dump_ipa = false;
     is_dump_vrp = false;
     is_dump_lftr = false;
     is_dump_vectorization = false;
@@ -244,6 +262,7 @@ void DumpOption::setDumpNothing()
     is_dump_loop_dep_ana = false;
     is_dump_gvn = false;
     is_dump_gcse = false;
+    is_dump_pre = false;
     is_dump_ivr = false;
     is_dump_licm = false;
     is_dump_exprtab = false;
@@ -269,6 +288,7 @@ void DumpOption::setDumpNothing()
     is_dump_gscc = false;
     is_dump_cdg = false;
     is_dump_lsra = false;
+    is_dump_scalar_opt = false;
 }
 
 
@@ -288,6 +308,9 @@ void DumpOption::setDumpAll()
     is_dump_cp = true;
     is_dump_rp = true;
     is_dump_dce = true;
+    is_dump_dse = true;
+    is_dump_inliner = true;
+    is_dump_ipa = true;
     is_dump_vrp = true;
     is_dump_lftr = true;
     is_dump_vectorization = true;
@@ -296,6 +319,7 @@ void DumpOption::setDumpAll()
     is_dump_loop_dep_ana = true;
     is_dump_gvn = true;
     is_dump_gcse = true;
+    is_dump_pre = true;
     is_dump_ivr = true;
     is_dump_licm = true;
     is_dump_exprtab = true;
@@ -320,6 +344,7 @@ void DumpOption::setDumpAll()
     is_dump_gscc = true;
     is_dump_cdg = true;
     is_dump_lsra = true;
+    is_dump_scalar_opt = true;
 }
 
 
@@ -399,6 +424,12 @@ bool DumpOption::isDumpCP() const
 }
 
 
+bool DumpOption::isDumpScalarOpt() const
+{
+    return is_dump_all || (!is_dump_nothing && is_dump_scalar_opt);
+}
+
+
 bool DumpOption::isDumpRP() const
 {
     return is_dump_all || (!is_dump_nothing && is_dump_rp);
@@ -429,6 +460,24 @@ bool DumpOption::isDumpDCE() const
 }
 
 
+bool DumpOption::isDumpDSE() const
+{
+    return is_dump_all || (!is_dump_nothing && is_dump_dse);
+}
+
+
+bool DumpOption::isDumpInliner() const
+{
+    return is_dump_all || (!is_dump_nothing && is_dump_inliner);
+}
+
+
+bool DumpOption::isDumpIPA() const
+{
+    return is_dump_all || (!is_dump_nothing && is_dump_ipa);
+}
+
+
 bool DumpOption::isDumpRCE() const
 {
     return is_dump_all || (!is_dump_nothing && is_dump_rce);
@@ -489,6 +538,12 @@ bool DumpOption::isDumpGCSE() const
 }
 
 
+bool DumpOption::isDumpPRE() const
+{
+    return is_dump_all || (!is_dump_nothing && is_dump_pre);
+}
+
+
 bool DumpOption::isDumpIVR() const
 {
     return is_dump_all || (!is_dump_nothing && is_dump_ivr);
@@ -712,6 +767,13 @@ void Option::dump(MOD LogMgr * lm)
          g_compute_region_imported_defuse_md ? "true":"false");
     note(lm, "\ng_compute_pr_du_chain_by_prssa = %s",
          g_compute_pr_du_chain_by_prssa ? "true":"false");
+    note(lm, "\ng_solve_du_set_by_worklist = %s",
+         g_solve_du_set_by_worklist ? "true":"false");
+    note(lm, "\ng_compute_dom_by_semi_nca = %s",
+         g_compute_dom_by_semi_nca ? "true":"false");
+    note(lm, "\ng_semi_nca_min_bb_num = %u", g_semi_nca_min_bb_num);
+    note(lm, "\ng_schedule_scalar_opt_by_change = %s",
+         g_schedule_scalar_opt_by_change ? "true":"false");
     note(lm, "\ng_do_expr_tab = %s", g_do_expr_tab ? "true":"false");
     note(lm, "\ng_do_cp_aggressive = %s", g_do_cp_aggressive ? "true":"false");
     note(lm, "\ng_do_cp = %s", g_do_cp ? "true":"false");
@@ -726,10 +788,20 @@ void Option::dump(MOD LogMgr * lm)
     note(lm, "\ng_do_dse = %s", g_do_dse ? "true":"false");
     note(lm, "\ng_do_gcse = %s", g_do_gcse ? "true":"false");
     note(lm, "\ng_do_ipa = %s", g_do_ipa ? "true":"false");
+    note(lm, "\ng_do_ipa_modref = %s", g_do_ipa_modref ? "true":"false");
     note(lm, "\ng_do_call_graph = %s", g_do_call_graph ? "true":"false");
     note(lm, "\ng_show_time = %s", g_show_time ? "true":"false");
+    note(lm, "\ng_do_prof = %s", g_do_prof ? "true":"false");
+    note(lm, "\ng_prof_trace_file = %s",
+         g_prof_trace_file != nullptr ? g_prof_trace_file : "");
     note(lm, "\ng_do_inline = %s", g_do_inline ? "true":"false");
     note(lm, "\ng_inline_threshold = %u", g_inline_threshold);
+    note(lm, "\ng_inline_size_threshold = %u", g_inline_size_threshold);
+    note(lm, "\ng_inline_caller_growth = %u", g_inline_caller_growth);
+    note(lm, "\ng_inline_program_growth = %u", g_inline_program_growth);
+    note(lm, "\ng_thread_num = %u", g_thread_num);
+    note(lm, "\ng_process_func_region_in_program = %s",
+         g_process_func_region_in_program ? "true":"false");
     note(lm, "\ng_do_ivr = %s", g_do_ivr ? "true":"false");
     note(lm, "\ng_do_lcse = %s", g_do_lcse ? "true":"false");
     note(lm, "\ng_do_licm = %s", g_do_licm ? "true":"false");
@@ -738,6 +810,7 @@ void Option::dump(MOD LogMgr * lm)
     note(lm, "\ng_do_pre = %s", g_do_pre ? "true":"false");
     note(lm, "\ng_do_rce = %s", g_do_rce ? "true":"false");
     note(lm, "\ng_do_vect = %s", g_do_vect ? "true":"false");
+    note(lm, "\ng_vect_reg_byte_size = %u", g_vect_reg_byte_size);
     note(lm, "\ng_do_multi_res_convert = %s",
          g_do_multi_res_convert ? "true":"false");
     note(lm, "\ng_do_targinfo_handler = %s",
@@ -748,10 +821,13 @@ void Option::dump(MOD LogMgr * lm)
     note(lm, "\ng_do_rp = %s", g_do_rp ? "true":"false");
     note(lm, "\ng_do_prssa = %s", g_do_prssa ? "true":"false");
     note(lm, "\ng_do_mdssa = %s", g_do_mdssa ? "true":"false");
+    note(lm, "\ng_mdssa_build_on_demand = %s",
+         g_mdssa_build_on_demand ? "true":"false");
     note(lm, "\ng_thres_opt_bb_num = %u", g_thres_opt_bb_num);
     note(lm, "\ng_thres_ptpair_num = %u", g_thres_ptpair_num);
     note(lm, "\ng_thres_opt_ir_num = %u", g_thres_opt_ir_num);
     note(lm, "\ng_thres_opt_ir_num_in_bb = %u", g_thres_opt_ir_num_in_bb);
+    note(lm, "\ng_thres_region_mem_size = %llu", g_thres_region_mem_size);
     note(lm, "\ng_do_loop_convert = %s", g_do_loop_convert ? "true":"false");
     note(lm, "\ng_do_poly_tran = %s", g_do_poly_tran ? "true":"false");
     note(lm, "\ng_do_refine_duchain = %s",
@@ -869,8 +945,11 @@ static PassSwitch g_pass_in_level3[] {
     { &xoc::g_do_cp_aggressive, },
     { &xoc::g_do_dce, },
     { &xoc::g_do_dce_aggressive, },
+    { &xoc::g_do_dse, },
     { &xoc::g_do_licm, },
     { &xoc::g_do_gcse, },
+    { &xoc::g_do_pre, },
+    { &xoc::g_do_vrp, },
     { &xoc::g_do_rce, },
     { &xoc::g_do_rp, },
     { &xoc::g_do_lftr, },
@@ -112,6 +112,9 @@ public:
     bool is_dump_rp; //Dump Register Promotion.
     bool is_dump_rce; //Dump light weight Redundant Code Elimination.
     bool is_dump_dce; //Dump Dead Code Elimination.
+    bool is_dump_dse; //Dump Dead Store Elimination.
+    bool is_dump_inliner; //Dump Inliner.
+    bool is_dump_ipa; //Dump IPA.
     bool is_dump_vrp; //Dump Value Range Propagation.
     bool is_dump_infertype; //Dump Infer Type.
     bool is_dump_invert_brtgt; //Dump Invert Branch Target.
@@ -123,6 +126,7 @@ public:
     bool is_dump_loop_dep_ana; //Dump Loop Dependence Analysis.
     bool is_dump_gvn; //Dump Global Value Numbering.
     bool is_dump_gcse; //Dump Global Common Subexpression Elimination.
+    bool is_dump_pre; //Dump Partial Redundancy Elimination.
     bool is_dump_ivr; //Dump Induction Variable Recognization.
     bool is_dump_licm; //Dump Loop Invariant Code Motion.
     bool is_dump_exprtab; //Dump Expr Tab.
@@ -142,6 +146,7 @@ public:
     bool is_dump_lsra; //Dump LinearScanRA
     bool is_dump_to_buffer; //Dump info to buffer
     bool is_dump_pelog; //Dump PrologueEpilogue
+    bool is_dump_scalar_opt; //Dump ScalarOpt scheduling.
 
     //The option determines whether IR dumper dumps the IR's id when dumpIR()
     //invoked. It should be set to false when the dump information is used in
@@ -176,10 +181,14 @@ public:
     bool isDumpCG() const;
     bool isDumpCP() const;
     bool isDumpDCE() const;
+    bool isDumpDSE() const;
+    bool isDumpInliner() const;
+    bool isDumpIPA() const;
     bool isDumpDOM() const;
     bool isDumpDUMgr() const;
     bool isDumpExprTab() const;
     bool isDumpGCSE() const;
+    bool isDumpPRE() const;
     bool isDumpGPAdjustment() const;
     bool isDumpGSCC() const;
     bool isDumpGVN() const;
@@ -214,6 +223,7 @@ public:
     bool isDumpRefineDUChain() const;
     bool isDumpRP() const;
     bool isDumpRPO() const;
+    bool isDumpScalarOpt() const;
     bool isDumpSimp() const;
     bool isDumpToBuffer() const;
     bool isDumpVectorization() const;
@@ -387,18 +397,55 @@ extern bool g_is_hoist_type;
 //Perform interprocedual analysis and optimization.
 extern bool g_do_ipa;
 
+//Compute interprocedural MOD/REF summary for each function region before
+//the function regions are optimized. The summary will be used by
+//AliasAnalysis, DUMgr and MDSSA at call site.
+extern bool g_do_ipa_modref;
+
 //Build call graph.
 extern bool g_do_call_graph;
 
 //If true to show compilation time.
 extern bool g_show_time;
 
+//If true to record hierarchical profile of region, pass and sub-phase,
+//include wall time, CPU time, IR count and memory high-water mark.
+//The aggregated table is dumped when RegionMgr is destroyed.
+extern bool g_do_prof;
+
+//Record the file name that profiler emits Chrome trace-event JSON to.
+//The trace is not emitted if the name is nullptr.
+extern CHAR const* g_prof_trace_file;
+
 //Perform function inline.
 extern bool g_do_inline;
 
-//Record the limit to inline.
+//Record the statement number limit to inline the region that is marked
+//as expect-inline. Such call site is always inlined if budget permits.
 extern UINT g_inline_threshold;
 
+//Record the IR size growth that is permitted to inline a call site that
+//executed once. The permitted growth is proportional to the estimated
+//execution frequency of call site.
+extern UINT g_inline_size_threshold;
+
+//Record the percentage of the size growth permitted for each caller.
+extern UINT g_inline_caller_growth;
+
+//Record the percentage of the size growth permitted for whole program.
+extern UINT g_inline_program_growth;
+
+//Record the number of threads that are used to process function regions
+//concurrently by RegionMgr::processAllFuncRegion().
+//1 means processing function regions sequentially.
+extern UINT g_thread_num;
+
+//Set to true to process the function regions of program region in
+//Region::process() of program region, after inlining and MOD/REF summary
+//computation, and before IPA. By default, the driver is responsible for
+//processing function regions.
+extern bool g_process_func_region_in_program;
+
 //Optimize float point operation.
 extern bool g_do_opt_float;
 
@@ -430,6 +477,11 @@ extern bool g_do_prssa;
 //Build Memory SSA and perform optimization based on Memory SSA.
 extern bool g_do_mdssa;
 
+//If it is true, MDSSAMgr only partitions MDs into alias classes during
+//construction, and builds the SSA form of a class when client first
+//queries the DU chain of it.
+extern bool g_mdssa_build_on_demand;
+
 //Build control flow graph.
 extern bool g_do_cfg;
 
@@ -521,6 +573,26 @@ extern bool g_compute_region_imported_defuse_md;
 //Computem PR-DU chain by PRSSA.
 extern bool g_compute_pr_du_chain_by_prssa;
 
+//Solve reach-def and available-expression by the worklist that is ordered
+//by RPO and propagates only the changed bits. Otherwise the sets are solved
+//by iterating all BBs in RPO until nothing changed.
+extern bool g_solve_du_set_by_worklist;
+
+//Compute idom by Semi-NCA algorithm and answer dominance query by the
+//interval numbers of dominator tree. The dominator-set of BB is generated
+//on demand. Otherwise idom is computed iteratively in RPO and the
+//dominator-set of each BB is computed eagerly.
+extern bool g_compute_dom_by_semi_nca;
+
+//The minimal number of BB in CFG that Semi-NCA algorithm will be applied.
+//The iterative algorithm is cheaper for small CFG.
+extern UINT g_semi_nca_min_bb_num;
+
+//Reperform the pass in ScalarOpt only if some pass made the change that it
+//subscribed, e.g: LICM only cares the change inside loop body. Otherwise
+//all passes are reperformed once any pass changed region.
+extern bool g_schedule_scalar_opt_by_change;
+
 //Build expression table to record lexicographic equally IR expression.
 extern bool g_do_expr_tab;
 
@@ -574,6 +646,12 @@ extern bool g_do_rce;
 //Perform auto vectorization.
 extern bool g_do_vect;
 
+//Record the byte size of vector register that auto vectorization widens
+//loop to. The default value is VECTOR_REGISTER_BYTE_SIZE, which is 16 if
+//target does not define it. 0 means target does not have vector unit and
+//auto vectorization does nothing.
+extern UINT g_vect_reg_byte_size;
+
 //Perform multiple result convert.
 extern bool g_do_multi_res_convert;
 
@@ -631,6 +709,15 @@ extern UINT g_thres_opt_ir_num_in_bb;
 //PtPair to perform flow sensitive analysis.
 extern UINT g_thres_ptpair_num;
 
+//Record the maximum limit of the byte size of memory that the processing
+//of a region may hold, which includes memory pools, BitSets and IRs that
+//allocated by the thread since the region began to be processed.
+//Once the limit is exceeded, expensive analyses degrade to their cheaper
+//conservative modes, e.g: MDSSA, Reach-Definition and classic DU chain
+//are not computed, and AA becomes flow insensitive.
+//0 means there is no limit.
+extern ULONGLONG g_thres_region_mem_size;
+
 //Convert while-do to do-while loop.
 extern bool g_do_loop_convert;
 
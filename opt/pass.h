@@ -84,6 +84,11 @@ public:
         return PASS_UNDEF;
     }
 
+    //Return true if the pass builds the MDSSA it needs via
+    //MDSSAMgr::buildOnDemand(), thus PassMgr does not need to build the
+    //whole MDSSA before performing the pass in demand-driven mode.
+    virtual bool isMDSSAOnDemandClient() const { return false; }
+
     virtual bool is_valid() const { return m_is_valid; }
 
     virtual void set_valid(bool valid) { m_is_valid = valid; }
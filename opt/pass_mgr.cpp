@@ -143,8 +143,7 @@ Pass * PassMgr::allocRP()
 
 Pass * PassMgr::allocPRE()
 {
-    //return new PRE(m_rg);
-    return nullptr;
+    return new PRE(m_rg);
 }
 
 
@@ -186,21 +185,13 @@ Pass * PassMgr::allocInvertBrTgt()
 
 Pass * PassMgr::allocVRP()
 {
-    #ifdef FOR_IP
     return new VRP(m_rg);
-    #else
-    return nullptr;
-    #endif
 }
 
 
 Pass * PassMgr::allocDSE()
 {
-    #ifdef FOR_IP
     return new DSE(m_rg);
-    #else
-    return nullptr;
-    #endif
 }
 
 
@@ -266,11 +257,7 @@ Pass * PassMgr::allocCallGraph()
 
 Pass * PassMgr::allocVectorization()
 {
-    #ifdef FOR_IP
     return new Vectorization(m_rg);
-    #else
-    return nullptr;
-    #endif
 }
 
 
@@ -731,6 +718,15 @@ void PassMgr::checkAndRecomputeDUChain(
 }
 
 
+void PassMgr::buildMDSSAForPass(Pass const* pass, OptCtx & oc)
+{
+    if (pass->isMDSSAOnDemandClient()) { return; }
+    MDSSAMgr * mdssamgr = (MDSSAMgr*)queryPass(PASS_MDSSA_MGR);
+    if (mdssamgr == nullptr || !mdssamgr->hasUnbuiltClass()) { return; }
+    mdssamgr->buildAllOnDemand(oc);
+}
+
+
 void PassMgr::checkAndRecomputeAA(
     OptCtx * oc, IRCFG * cfg, AliasAnalysis *& aa, BitSet const& opts)
 {
@@ -753,11 +749,12 @@ void PassMgr::checkAndRecomputeAA(
         max_numir_in_bb = MAX(max_numir_in_bb, bb->getNumOfIR());
     }
     if (numir > g_thres_opt_ir_num ||
-        max_numir_in_bb > g_thres_opt_ir_num_in_bb) {
+        max_numir_in_bb > g_thres_opt_ir_num_in_bb ||
+        m_rg->isMemBudgetExceeded()) {
         aa->set_flow_sensitive(false);
     }
     //NOTE: assignMD(false) must be called before AA.
-    aa->perform(*oc);
+    performPass(aa, *oc);
 }
 
 
@@ -794,12 +791,20 @@ void PassMgr::checkAndRecomputeAAandDU(
     if (opts.is_contain(PASS_MD_REF)) {
         f.set(DUOPT_COMPUTE_NONPR_DU|DUOPT_COMPUTE_PR_DU);
     }
+    ProfScope prof(dumgr->getPassName(), PROF_PASS, m_rg);
     dumgr->perform(*oc, f);
 
     //Do verifications.
     if (f.have(DUOPT_COMPUTE_PR_REF) || f.have(DUOPT_COMPUTE_NONPR_REF)) {
         ASSERT0(dumgr->verifyMDRef());
     }
+    if (f.have(DUOPT_COMPUTE_NONPR_REF)) {
+        MDSSAMgr * mdssamgr = (MDSSAMgr*)queryPass(PASS_MDSSA_MGR);
+        if (mdssamgr != nullptr && mdssamgr->isValidOnDemand()) {
+            //MD reference changed, the alias classes have to be recomputed.
+            mdssamgr->reclassifyOnDemand();
+        }
+    }
     if (f.have(DUOPT_SOL_AVAIL_EXPR)) {
         ASSERT0(dumgr->verifyLiveinExp());
     }
@@ -833,7 +838,7 @@ void PassMgr::checkValidAndRecomputePass(
         if (!cdg->is_valid()) {
             ASSERTN(cfg && oc->is_cfg_valid(),
                     ("You should make CFG available first."));
-            cdg->perform(*oc);
+            performPass(cdg, *oc);
         } else {
             ASSERT0(cdg->verify());
         }
@@ -858,7 +863,7 @@ void PassMgr::checkValidAndRecomputePass(
             m_rg->getBBList()->get_elem_count() != 0) {
             ExprTab * exprtab = (ExprTab*)registerPass(PASS_EXPR_TAB);
             ASSERT0(exprtab);
-            exprtab->perform(*oc);
+            performPass(exprtab, *oc);
         }
         break;
     case PASS_LOOP_INFO:
@@ -883,7 +888,7 @@ void PassMgr::checkValidAndRecomputePass(
                     ("You should make CFG available first."));
             GSCC * gscc = (GSCC*)registerPass(PASS_SCC);
             ASSERT0(gscc); //scc is not enable.
-            gscc->perform(*oc);
+            performPass(gscc, *oc);
         }
         break;
     case PASS_AA:
@@ -899,7 +904,7 @@ void PassMgr::checkValidAndRecomputePass(
     default: {
         Pass * pass = registerPass(pt);
         if (pass != nullptr || !pass->is_valid()) {
-            pass->perform(*oc);
+            performPass(pass, *oc);
         }
     }
     }
@@ -116,6 +116,9 @@ protected:
         return nullptr;
     }
 protected:
+    //Build the whole MDSSA in demand-driven mode if 'pass' is not aware of
+    //the mode.
+    void buildMDSSAForPass(Pass const* pass, OptCtx & oc);
     void checkAndRecomputeDUChain(
         OptCtx * oc, DUMgr * dumgr, BitSet const& opts);
     void checkAndRecomputeAA(
@@ -157,6 +160,21 @@ public:
 
     PassTab const& getPassTab() const { return m_registered_pass; }
 
+    //Perform given pass, and record the scope of pass in profile if
+    //g_do_prof is true. Return the result of Pass::perform().
+    bool performPass(Pass * pass, OptCtx & oc)
+    {
+        ASSERT0(pass);
+        buildMDSSAForPass(pass, oc);
+        if (!g_do_prof) { return pass->perform(oc); }
+        ProfScope prof(pass->getPassName(), PROF_PASS, m_rg);
+        return pass->perform(oc);
+    }
+
+    //Register and perform given pass.
+    bool performPass(PASS_TYPE passty, OptCtx & oc)
+    { return performPass(registerPass(passty), oc); }
+
     virtual Pass * registerPass(PASS_TYPE passty);
 
     //The function will re-construct given pass object and do registration
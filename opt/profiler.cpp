@@ -0,0 +1,561 @@
+/*@
+XOC Release License
+
+Copyright (c) 2013-2014, Alibaba Group, All rights reserved.
+
+    compiler@aliexpress.com
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Su Zhenyu nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+author: Su Zhenyu
+@*/
+//NOTE: Host library has to be included before cominc.h, because xcom may
+//redefine some C++11 keywords.
+#include <time.h>
+#include "cominc.h"
+
+namespace xoc {
+
+#define PROF_TOP_REGION_NUM 20
+#define PROF_UNKNOWN -1
+
+class ProfEvent {
+public:
+    PROF_KIND kind;
+    UINT parent; //handle of parent scope.
+    UINT name; //offset of name in ProfStrBuf.
+    UINT region_name; //offset of region name in ProfStrBuf.
+    double start; //wall time in microsecond.
+    double dur; //wall time in microsecond.
+    double cpu_start; //thread CPU time in microsecond.
+    double cpu; //thread CPU time in microsecond.
+    LONGLONG ir_before;
+    LONGLONG ir_after;
+    LONGLONG mem_start; //thread memory size when scope opened.
+    LONGLONG mem_saved_peak; //the peak before scope opened.
+    LONGLONG mem_hw; //high-water mark of thread memory during the scope.
+    LONGLONG mem_live; //thread memory that the scope left behind.
+    Region const* rg;
+};
+
+
+//The class holds strings of events in a contiguous buffer. The buffer
+//is not allocated from memory pool, thus it is not counted in the
+//thread memory that the profiler measures.
+class ProfStrBuf {
+    COPY_CONSTRUCTOR(ProfStrBuf);
+    UINT m_len;
+    xcom::Vector<CHAR> m_buf;
+public:
+    ProfStrBuf() : m_len(0) { add(""); }
+
+    //Append 's' into buffer, and return its offset.
+    UINT add(CHAR const* s)
+    {
+        UINT ofst = m_len;
+        if (s == nullptr) { s = ""; }
+        do {
+            m_buf.set(m_len++, *s);
+        } while (*s++ != 0);
+        return ofst;
+    }
+
+    CHAR const* get(UINT ofst) const
+    {
+        ASSERT0(ofst < m_len);
+        return m_buf.get_vec() + ofst;
+    }
+};
+
+
+class ProfThread {
+    COPY_CONSTRUCTOR(ProfThread);
+public:
+    UINT tid;
+    UINT event_num;
+    UINT stack_num;
+    xcom::Vector<ProfEvent> events;
+    xcom::Vector<UINT> stack; //handles of opened scopes.
+    ProfStrBuf strbuf;
+public:
+    ProfThread() : tid(0), event_num(0), stack_num(0) {}
+
+    ProfEvent & getEvent(UINT handle)
+    {
+        ASSERT0(handle != PROF_HANDLE_UNDEF && handle <= event_num);
+        return events[handle - 1];
+    }
+    ProfEvent const& getEvent(UINT handle) const
+    { return const_cast<ProfThread*>(this)->getEvent(handle); }
+    CHAR const* getName(ProfEvent const& e) const
+    { return strbuf.get(e.name); }
+    CHAR const* getRegionName(ProfEvent const& e) const
+    { return strbuf.get(e.region_name); }
+};
+
+
+//The lock guards the list of ProfThread, it is always enabled because
+//scopes can be opened by any thread.
+class ProfLock : public xcom::Mutex {
+public:
+    ProfLock() { enable(true); }
+};
+
+
+static ProfLock g_prof_lock;
+static xcom::Vector<ProfThread*> g_prof_threads;
+static UINT g_prof_generation = 1;
+static double g_prof_epoch = -1;
+static thread_local ProfThread * g_prof_thread = nullptr;
+
+//Generation of g_prof_thread. It is kept apart from ProfThread because
+//the buffer will be freed by clean().
+static thread_local UINT g_prof_thread_gen = 0;
+
+
+//Return monotonic time in microsecond.
+static double getMonotonicTime()
+{
+    #ifdef CLOCK_MONOTONIC
+    struct timespec ts;
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) == 0) {
+        return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+    }
+    #endif
+    return (double)clock() * 1e6 / CLOCKS_PER_SEC;
+}
+
+
+static double getWallTime()
+{
+    return getMonotonicTime() - g_prof_epoch;
+}
+
+
+static double getCPUTime()
+{
+    #ifdef CLOCK_THREAD_CPUTIME_ID
+    struct timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0) {
+        return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+    }
+    #endif
+    return (double)clock() * 1e6 / CLOCKS_PER_SEC;
+}
+
+
+static ProfThread * getProfThread()
+{
+    xcom::AutoLock lock(&g_prof_lock);
+    if (g_prof_thread != nullptr && g_prof_thread_gen == g_prof_generation) {
+        return g_prof_thread;
+    }
+    if (g_prof_epoch < 0) {
+        g_prof_epoch = getMonotonicTime();
+    }
+    //Buffer is owned by profiler, thus records survive the thread.
+    ProfThread * pt = new ProfThread();
+    pt->tid = g_prof_threads.get_elem_count();
+    g_prof_threads.append(pt);
+    g_prof_thread = pt;
+    g_prof_thread_gen = g_prof_generation;
+    return pt;
+}
+
+
+//Return the number of IR stmt in region.
+static LONGLONG countIR(Region const* rg)
+{
+    if (rg == nullptr || !rg->hasAnaInstrument()) { return PROF_UNKNOWN; }
+    LONGLONG n = 0;
+    if (rg->getIRList() != nullptr) {
+        for (IR const* ir = rg->getIRList(); ir != nullptr; ir = ir->get_next()) {
+            n++;
+        }
+        return n;
+    }
+    BBList * bbl = rg->getBBList();
+    if (bbl == nullptr) { return PROF_UNKNOWN; }
+    BBListIter it;
+    for (IRBB const* bb = bbl->get_head(&it);
+         bb != nullptr; bb = bbl->get_next(&it)) {
+        n += bb->getNumOfIR();
+    }
+    return n;
+}
+
+
+UINT Profiler::start(CHAR const* name, PROF_KIND kind, Region const* rg)
+{
+    ProfThread * pt = g_prof_thread;
+    if (pt == nullptr || g_prof_thread_gen != g_prof_generation) {
+        pt = getProfThread();
+    }
+    UINT parent = pt->stack_num == 0 ?
+        PROF_HANDLE_UNDEF : pt->stack[pt->stack_num - 1];
+    UINT name_ofst = pt->strbuf.add(name);
+    UINT region_name_ofst = 0;
+    if (rg == nullptr && parent != PROF_HANDLE_UNDEF) {
+        //Sub-phase inherits region from parent scope.
+        rg = pt->getEvent(parent).rg;
+        region_name_ofst = pt->getEvent(parent).region_name;
+    } else if (rg != nullptr && rg->getRegionName() != nullptr) {
+        region_name_ofst = pt->strbuf.add(rg->getRegionName());
+    }
+    pt->events.set(pt->event_num, ProfEvent());
+    UINT handle = ++pt->event_num;
+    ProfEvent & e = pt->getEvent(handle);
+    e.kind = kind;
+    e.parent = parent;
+    e.name = name_ofst;
+    e.region_name = region_name_ofst;
+    e.rg = rg;
+    e.ir_before = kind == PROF_PHASE ? PROF_UNKNOWN : countIR(rg);
+    e.ir_after = PROF_UNKNOWN;
+    e.mem_start = xcom::smpoolGetThreadMemSize();
+    e.mem_saved_peak = xcom::smpoolGetThreadMemPeak();
+    e.mem_hw = 0;
+    e.mem_live = 0;
+    xcom::smpoolSetThreadMemPeak(e.mem_start);
+    pt->stack.set(pt->stack_num++, handle);
+    e.cpu_start = getCPUTime();
+    e.cpu = 0;
+    e.start = getWallTime();
+    e.dur = 0;
+    return handle;
+}
+
+
+void Profiler::end(UINT handle)
+{
+    ASSERT0(handle != PROF_HANDLE_UNDEF);
+    double now = getWallTime();
+    double cpunow = getCPUTime();
+    ProfThread * pt = g_prof_thread;
+    if (pt == nullptr || g_prof_thread_gen != g_prof_generation ||
+        handle > pt->event_num) {
+        //Records have been cleaned.
+        return;
+    }
+    while (pt->stack_num != 0) {
+        UINT h = pt->stack[--pt->stack_num];
+        ProfEvent & e = pt->getEvent(h);
+        e.dur = now - e.start;
+        e.cpu = cpunow - e.cpu_start;
+        if (e.kind != PROF_PHASE) {
+            e.ir_after = countIR(e.rg);
+        }
+        LONGLONG peak = xcom::smpoolGetThreadMemPeak();
+        e.mem_hw = MAX(peak - e.mem_start, 0);
+        e.mem_live = xcom::smpoolGetThreadMemSize() - e.mem_start;
+        //Propagate the peak to enclosing scope.
+        xcom::smpoolSetThreadMemPeak(MAX(peak, e.mem_saved_peak));
+        if (h == handle) { break; }
+    }
+}
+
+
+bool Profiler::is_empty()
+{
+    xcom::AutoLock lock(&g_prof_lock);
+    for (UINT i = 0; i < g_prof_threads.get_elem_count(); i++) {
+        if (g_prof_threads[i]->event_num != 0) { return false; }
+    }
+    return true;
+}
+
+
+void Profiler::clean()
+{
+    xcom::AutoLock lock(&g_prof_lock);
+    for (UINT i = 0; i < g_prof_threads.get_elem_count(); i++) {
+        delete g_prof_threads[i];
+    }
+    g_prof_threads.clean();
+    g_prof_generation++;
+}
+
+
+class ProfAgg {
+public:
+    UINT count;
+    double wall;
+    double cpu;
+    LONGLONG ir_delta;
+    LONGLONG mem_hw;
+    LONGLONG mem_live;
+public:
+    ProfAgg() : count(0), wall(0), cpu(0), ir_delta(0), mem_hw(0),
+                mem_live(0) {}
+};
+
+
+//Compute the path of scope, region scope is excluded from path in order
+//to aggregate the same pass of different regions.
+static void computePath(ProfThread const* pt, ProfEvent const& e,
+                        OUT xcom::StrBuf & path)
+{
+    xcom::Vector<UINT> ancestors;
+    UINT num = 0;
+    for (UINT p = e.parent; p != PROF_HANDLE_UNDEF;
+         p = pt->getEvent(p).parent) {
+        if (pt->getEvent(p).kind == PROF_REGION) { continue; }
+        ancestors.set(num++, p);
+    }
+    path.clean();
+    for (UINT i = num; i > 0; i--) {
+        path.strcat("%s > ", pt->getName(pt->getEvent(ancestors[i - 1])));
+    }
+    path.strcat("%s", pt->getName(e));
+}
+
+
+//The class sorts paths in lexicographical order.
+class SortPathByName : public xcom::QuickSort<Sym const*> {
+protected:
+    virtual bool GreatThan(Sym const* a, Sym const* b) const
+    { return ::strcmp(a->getStr(), b->getStr()) > 0; }
+    virtual bool LessThan(Sym const* a, Sym const* b) const
+    { return ::strcmp(a->getStr(), b->getStr()) < 0; }
+};
+
+
+//The class sorts region scopes by wall time in descending order.
+class SortRegionByTime : public xcom::QuickSort<ProfEvent const*> {
+protected:
+    virtual bool GreatThan(ProfEvent const* a, ProfEvent const* b) const
+    { return a->dur < b->dur; }
+    virtual bool LessThan(ProfEvent const* a, ProfEvent const* b) const
+    { return a->dur > b->dur; }
+};
+
+
+void Profiler::dumpTable(FILE * h)
+{
+    if (h == nullptr) { return; }
+    xcom::AutoLock lock(&g_prof_lock);
+    SymTab path_tab;
+    xcom::TMap<Sym const*, ProfAgg*> path2agg;
+    xcom::Vector<Sym const*> paths;
+    UINT path_num = 0;
+    xcom::Vector<ProfEvent const*> regions;
+    xcom::TMap<ProfEvent const*, CHAR const*> region2name;
+    UINT region_num = 0;
+    UINT num = 0;
+    xcom::StrBuf path(64);
+    for (UINT i = 0; i < g_prof_threads.get_elem_count(); i++) {
+        ProfThread const* pt = g_prof_threads[i];
+        for (UINT j = 1; j <= pt->event_num; j++) {
+            ProfEvent const& e = pt->getEvent(j);
+            num++;
+            if (e.kind == PROF_REGION) {
+                regions.set(region_num++, &e);
+                region2name.set(&e, pt->getName(e));
+                continue;
+            }
+            computePath(pt, e, path);
+            Sym const* sym = path_tab.add(path.buf);
+            ProfAgg * agg = path2agg.get(sym);
+            if (agg == nullptr) {
+                agg = new ProfAgg();
+                path2agg.set(sym, agg);
+                paths.set(path_num++, sym);
+            }
+            agg->count++;
+            agg->wall += e.dur;
+            agg->cpu += e.cpu;
+            if (e.ir_before != PROF_UNKNOWN && e.ir_after != PROF_UNKNOWN) {
+                agg->ir_delta += e.ir_after - e.ir_before;
+            }
+            agg->mem_hw = MAX(agg->mem_hw, e.mem_hw);
+            agg->mem_live += e.mem_live;
+        }
+    }
+    fprintf(h, "\n==---- DUMP PROFILE: %u scopes, %u regions, %u threads ----==",
+            num, region_num, g_prof_threads.get_elem_count());
+    fprintf(h, "\n%-60s %8s %12s %12s %10s %12s %12s",
+            "PASS/PHASE", "COUNT", "WALL(ms)", "CPU(ms)", "IR+/-",
+            "MEMHW(KB)", "MEMLIVE(KB)");
+    SortPathByName path_sorter;
+    path_sorter.sort(paths);
+    for (UINT i = 0; i < path_num; i++) {
+        Sym const* sym = paths[i];
+        ProfAgg * agg = path2agg.get(sym);
+        ASSERT0(agg);
+        fprintf(h, "\n%-60s %8u %12.3f %12.3f %10lld %12.1f %12.1f",
+                sym->getStr(), agg->count, agg->wall / 1e3, agg->cpu / 1e3,
+                agg->ir_delta, agg->mem_hw / 1024.0, agg->mem_live / 1024.0);
+        delete agg;
+    }
+    if (region_num != 0) {
+        SortRegionByTime sorter;
+        sorter.sort(regions);
+        fprintf(h, "\n\n%-40s %12s %12s %10s %10s %12s %12s",
+                "REGION", "WALL(ms)", "CPU(ms)", "IR-BEFORE", "IR-AFTER",
+                "MEMHW(KB)", "MEMLIVE(KB)");
+        for (UINT i = 0; i < region_num && i < PROF_TOP_REGION_NUM; i++) {
+            ProfEvent const* e = regions[i];
+            fprintf(h, "\n%-40s %12.3f %12.3f %10lld %10lld %12.1f %12.1f",
+                    region2name.get(e), e->dur / 1e3, e->cpu / 1e3,
+                    e->ir_before, e->ir_after, e->mem_hw / 1024.0,
+                    e->mem_live / 1024.0);
+        }
+    }
+    fprintf(h, "\n");
+    fflush(h);
+}
+
+
+static void dumpJSONString(FILE * h, CHAR const* s)
+{
+    fprintf(h, "\"");
+    for (; *s != 0; s++) {
+        CHAR c = *s;
+        switch (c) {
+        case '"': fprintf(h, "\\\""); break;
+        case '\\': fprintf(h, "\\\\"); break;
+        case '\n': fprintf(h, "\\n"); break;
+        case '\t': fprintf(h, "\\t"); break;
+        default:
+            if ((BYTE)c < 0x20) {
+                fprintf(h, "\\u%04x", (UINT)(BYTE)c);
+            } else {
+                fputc(c, h);
+            }
+        }
+    }
+    fprintf(h, "\"");
+}
+
+
+bool Profiler::dumpChromeTrace(CHAR const* filename)
+{
+    ASSERT0(filename);
+    FILE * h = ::fopen(filename, "w");
+    if (h == nullptr) { return false; }
+    xcom::AutoLock lock(&g_prof_lock);
+    static CHAR const* kind2cat[] = { "undef", "region", "pass", "phase" };
+    fprintf(h, "{\"traceEvents\":[");
+    bool first = true;
+    for (UINT i = 0; i < g_prof_threads.get_elem_count(); i++) {
+        ProfThread const* pt = g_prof_threads[i];
+        for (UINT j = 1; j <= pt->event_num; j++) {
+            ProfEvent const& e = pt->getEvent(j);
+            fprintf(h, "%s\n{\"name\":", first ? "" : ",");
+            first = false;
+            dumpJSONString(h, pt->getName(e));
+            fprintf(h, ",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,"
+                    "\"dur\":%.3f,\"pid\":0,\"tid\":%u,\"args\":{",
+                    kind2cat[e.kind], e.start, e.dur, pt->tid);
+            fprintf(h, "\"region\":");
+            dumpJSONString(h, pt->getRegionName(e));
+            fprintf(h, ",\"cpu_us\":%.3f,\"mem_hw\":%lld,\"mem_live\":%lld",
+                    e.cpu, e.mem_hw, e.mem_live);
+            if (e.ir_before != PROF_UNKNOWN) {
+                fprintf(h, ",\"ir_before\":%lld", e.ir_before);
+            }
+            if (e.ir_after != PROF_UNKNOWN) {
+                fprintf(h, ",\"ir_after\":%lld", e.ir_after);
+            }
+            fprintf(h, "}}");
+        }
+    }
+    fprintf(h, "\n],\"displayTimeUnit\":\"ms\"}\n");
+    ::fclose(h);
+    return true;
+}
+
+
+void Profiler::dump(RegionMgr * rm)
+{
+    if (is_empty()) { return; }
+    if (rm != nullptr && rm->isLogMgrInit()) {
+        dumpTable(rm->getLogMgr()->getFileHandler());
+    } else {
+        dumpTable(stdout);
+    }
+    if (g_prof_trace_file != nullptr &&
+        !dumpChromeTrace(g_prof_trace_file)) {
+        prt2C("\nfailed to write profile trace to %s", g_prof_trace_file);
+    }
+}
+
+
+//
+//START PassTimer
+//
+void PassTimer::start(CHAR const* name)
+{
+    if (g_show_time) {
+        m_clock = getclockstart();
+        prt2C("\n==-- START %s", name);
+    }
+    if (g_do_prof) {
+        if (m_handle != PROF_HANDLE_UNDEF) { Profiler::end(m_handle); }
+        m_handle = Profiler::start(name, PROF_PHASE, nullptr);
+    }
+}
+
+
+void PassTimer::startFmt(CHAR const* format, ...)
+{
+    xcom::StrBuf buf(64);
+    va_list args;
+    va_start(args, format);
+    buf.vstrcat(format, args);
+    va_end(args);
+    start(buf.buf);
+}
+
+
+void PassTimer::end(CHAR const* name)
+{
+    if (g_show_time) {
+        prt2C("\n==-- END %s", name);
+        prt2C(" Time:%fsec", getclockend(m_clock));
+    }
+    if (m_handle != PROF_HANDLE_UNDEF) {
+        Profiler::end(m_handle);
+        m_handle = PROF_HANDLE_UNDEF;
+    }
+}
+
+
+void PassTimer::endFmt(CHAR const* format, ...)
+{
+    if (!g_show_time) {
+        end(nullptr);
+        return;
+    }
+    xcom::StrBuf buf(64);
+    va_list args;
+    va_start(args, format);
+    buf.vstrcat(format, args);
+    va_end(args);
+    end(buf.buf);
+}
+//END PassTimer
+
+} //namespace xoc
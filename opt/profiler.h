@@ -0,0 +1,143 @@
+/*@
+XOC Release License
+
+Copyright (c) 2013-2014, Alibaba Group, All rights reserved.
+
+    compiler@aliexpress.com
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Su Zhenyu nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+author: Su Zhenyu
+@*/
+#ifndef _PROFILER_H_
+#define _PROFILER_H_
+
+namespace xoc {
+
+class Region;
+class RegionMgr;
+
+#define PROF_HANDLE_UNDEF 0
+
+typedef enum _PROF_KIND {
+    PROF_UNDEF = 0,
+    PROF_REGION, //scope of region.
+    PROF_PASS, //scope of pass.
+    PROF_PHASE, //scope of sub-phase, e.g: START_TIMER and END_TIMER.
+} PROF_KIND;
+
+//Profiler
+//
+//The profiler records nested scopes, e.g: region -> pass -> sub-phase,
+//with wall time, CPU time, the number of IR before and after the scope,
+//the high-water mark of thread memory during the scope, and the live
+//memory that the scope left behind. Thread memory includes memory pools
+//and IRs, see smpoolGetThreadMemSize(). BitSets that allocated while a
+//region is processed are attributed to the region rather than the thread,
+//see Region::getLiveMemSize().
+//Each thread records its scopes into its own buffer, thus passes of
+//different regions can be profiled concurrently.
+//The records can be aggregated into tables by scope path, and can be
+//emitted as Chrome trace-event JSON file, which can be viewed in
+//chrome://tracing or Perfetto.
+//NOTE: scopes are only recorded when g_do_prof is true.
+class Profiler {
+public:
+    //Remove all records.
+    //Note the function should not be invoked if there are other threads
+    //recording scopes.
+    static void clean();
+
+    //Dump aggregated tables of profile to file handler 'h'.
+    static void dumpTable(FILE * h);
+
+    //Emit records in Chrome trace-event JSON format to 'filename'.
+    //Return true if the file is written successfully.
+    static bool dumpChromeTrace(CHAR const* filename);
+
+    //Dump tables to the log file of 'rm' if it is initialized, or to
+    //screen, and emit Chrome trace if g_prof_trace_file is given.
+    static void dump(RegionMgr * rm);
+
+    //Close the scope that 'handle' indicated. Scopes opened after the
+    //scope will be closed as well.
+    static void end(UINT handle);
+
+    //Return true if there is no record.
+    static bool is_empty();
+
+    //Open a scope, and return the handle of the scope.
+    //rg: region that the scope belongs to, the number of IR is only
+    //    recorded if rg is given.
+    static UINT start(CHAR const* name, PROF_KIND kind, Region const* rg);
+};
+
+
+//The class opens a scope when constructed, and closes the scope when
+//destructed. The object costs nothing more than a flag test if g_do_prof
+//is false.
+//e.g:
+//    ProfScope prof(getPassName(), PROF_PASS, m_rg);
+class ProfScope {
+    COPY_CONSTRUCTOR(ProfScope);
+    UINT m_handle;
+public:
+    ProfScope(CHAR const* name, PROF_KIND kind = PROF_PHASE,
+              Region const* rg = nullptr)
+    {
+        m_handle = g_do_prof ? Profiler::start(name, kind, rg) :
+                               PROF_HANDLE_UNDEF;
+    }
+    ~ProfScope()
+    {
+        if (m_handle != PROF_HANDLE_UNDEF) { Profiler::end(m_handle); }
+    }
+};
+
+
+//The timer is used by START_TIMER and END_TIMER. It prints time to screen
+//if g_show_time is true, and records sub-phase scope if g_do_prof is true.
+//The scope is closed when timer destructed, even if END_TIMER is not
+//reached, e.g: function returns early.
+class PassTimer {
+    COPY_CONSTRUCTOR(PassTimer);
+    LONG m_clock;
+    UINT m_handle;
+public:
+    PassTimer() : m_clock(0), m_handle(PROF_HANDLE_UNDEF) {}
+    ~PassTimer()
+    {
+        if (m_handle != PROF_HANDLE_UNDEF) { Profiler::end(m_handle); }
+    }
+
+    void end(CHAR const* name);
+    void endFmt(CHAR const* format, ...);
+
+    void start(CHAR const* name);
+    void startFmt(CHAR const* format, ...);
+};
+
+} //namespace xoc
+#endif
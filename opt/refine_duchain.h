@@ -78,7 +78,7 @@ public:
 
     virtual CHAR const* getPassName() const
     { return "Refine DefUse Chain"; }
-    PASS_TYPE getPassType() const { return PASS_PRE; }
+    PASS_TYPE getPassType() const { return PASS_REFINE_DUCHAIN; }
 
     //True to use GVN and classic DU chain to perform optimization.
     void setUseGvn(bool use_gvn) { m_is_use_gvn = use_gvn; }
@@ -147,6 +147,32 @@ size_t Region::count_mem() const
 }
 
 
+LONGLONG Region::getLiveMemSize() const
+{
+    AnalysisInstrument * ai = getAnalysisInstrument();
+    return xcom::smpoolGetThreadMemSize() - ANA_INS_mem_base(ai) +
+           ANA_INS_mem_account(ai)->getSize();
+}
+
+
+bool Region::isMemBudgetExceeded() const
+{
+    if (g_thres_region_mem_size == 0 || !hasAnaInstrument()) {
+        return false;
+    }
+    AnalysisInstrument * ai = getAnalysisInstrument();
+    if (ANA_INS_is_mem_budget_exceeded(ai)) { return true; }
+    if (getLiveMemSize() <= (LONGLONG)g_thres_region_mem_size) {
+        return false;
+    }
+    ANA_INS_is_mem_budget_exceeded(ai) = true;
+    interwarn("Region(%d) exceeded memory budget %llu bytes, "
+              "analyses turn to conservative mode.",
+              id(), g_thres_region_mem_size);
+    return true;
+}
+
+
 void Region::setCFG(IRCFG * newcfg) const
 {
     ASSERT0(newcfg);
@@ -1016,6 +1042,19 @@ void Region::dumpParameter() const
 }
 
 
+void ModRefSummary::dump(Region const* rg) const
+{
+    if (!rg->isLogMgrInit()) { return; }
+    note(rg, "\nModRefSummary:%s%s%s%s",
+         is_mod_worst ? " mod_worst" : "", is_ref_worst ? " ref_worst" : "",
+         is_mod_arg ? " mod_arg" : "", is_ref_arg ? " ref_arg" : "");
+    note(rg, "\n  MOD:");
+    mod_mds->dump(rg->getMDSystem(), rg->getVarMgr(), true);
+    note(rg, "\n  REF:");
+    ref_mds->dump(rg->getMDSystem(), rg->getVarMgr(), true);
+}
+
+
 void Region::dump(bool dump_inner_region) const
 {
     if (!isLogMgrInit()) { return; }
@@ -1041,6 +1080,11 @@ void Region::dump(bool dump_inner_region) const
         ru_mayuse->dump(getMDSystem(), getVarMgr(), true);
     }
 
+    ModRefSummary const* modref = getModRefSummary();
+    if (modref != nullptr) {
+        modref->dump(this);
+    }
+
     if (is_blackbox()) { return; }
 
     IR * irlst = getIRList();
@@ -1566,7 +1610,7 @@ static void post_process(Region * rg, OptCtx * oc)
 
     MDSSAMgr * mdssamgr = (MDSSAMgr*)rg->getPassMgr()->queryPass(
         PASS_MDSSA_MGR);
-    if (mdssamgr != nullptr && mdssamgr->is_valid()) {
+    if (mdssamgr != nullptr && mdssamgr->isValidOnDemand()) {
         mdssamgr->destruction(*oc);
         rg->getPassMgr()->destroyRegisteredPass(PASS_MDSSA_MGR);
     }
@@ -1592,13 +1636,12 @@ static void do_ipa(Region * rg, OptCtx * oc)
         //processFuncRegion has scanned and collected call-list.
         //Thus it does not need to scan call-list here.
         ASSERT0(rg->getPassMgr());
-        rg->getPassMgr()->registerPass(PASS_CALL_GRAPH);
-        rg->getCallGraph()->perform(*oc);
+        rg->getPassMgr()->performPass(PASS_CALL_GRAPH, *oc);
     }
 
     if (oc->is_callgraph_valid()) {
         IPA * ipa = (IPA*)rg->getPassMgr()->registerPass(PASS_IPA);
-        ipa->perform(*oc);
+        rg->getPassMgr()->performPass(ipa, *oc);
         rg->getPassMgr()->destroyRegisteredPass(PASS_IPA);
     }
 }
@@ -1609,12 +1652,11 @@ static void do_inline(Region * rg, OptCtx * oc)
     if (!oc->is_callgraph_valid()) {
         //Need to scan call-list.
         ASSERT0(rg->getPassMgr());
-        rg->getPassMgr()->registerPass(PASS_CALL_GRAPH);
-        rg->getCallGraph()->perform(*oc);
+        rg->getPassMgr()->performPass(PASS_CALL_GRAPH, *oc);
     }
     if (oc->is_callgraph_valid()) {
         Inliner * inl = (Inliner*)rg->getPassMgr()->registerPass(PASS_INLINER);
-        inl->perform(*oc);
+        rg->getPassMgr()->performPass(inl, *oc);
         rg->getPassMgr()->destroyRegisteredPass(PASS_INLINER);
     }
 }
@@ -1692,6 +1734,20 @@ bool Region::process(OptCtx * oc)
     if (getIRList() == nullptr && getBBList()->get_elem_count() == 0) {
         return true;
     }
+    ProfScope prof(getRegionName(), PROF_REGION, this);
+    ANA_INS_mem_base(getAnalysisInstrument()) =
+        xcom::smpoolGetThreadMemSize();
+    ANA_INS_is_mem_budget_exceeded(getAnalysisInstrument()) = false;
+
+    //BitSets allocated during processing are attributed to the region, even
+    //if they are freed by other thread. The account is only used to check
+    //memory budget, avoid the atomic accounting of BitSet if there is no
+    //budget, and the BitSets are accounted into thread memory size.
+    xcom::MemAccount * org_account = xcom::smpoolGetThreadMemAccount();
+    if (g_thres_region_mem_size != 0) {
+        xcom::smpoolSetThreadMemAccount(
+            ANA_INS_mem_account(getAnalysisInstrument()));
+    }
     initPassMgr();
     initDbxMgr();
     initAttachInfoMgr();
@@ -1700,10 +1756,18 @@ bool Region::process(OptCtx * oc)
     if (g_do_inline && is_program()) {
         do_inline(this, oc);
     }
-    getPassMgr()->registerPass(PASS_REFINE)->perform(*oc);
+    if (g_do_ipa_modref && is_program()) {
+        //Summaries have to be computed after inlining.
+        getRegionMgr()->computeModRefSummary(this, *oc);
+    }
+    if (g_process_func_region_in_program && is_program() &&
+        !getRegionMgr()->processAllFuncRegion(this)) {
+        goto ERR_RETURN;
+    }
+    getPassMgr()->performPass(PASS_REFINE, *oc);
     if (g_insert_cvt) {
         //Insert CVT if necessary.
-        getPassMgr()->registerPass(PASS_INSERT_CVT)->perform(*oc);
+        getPassMgr()->performPass(PASS_INSERT_CVT, *oc);
     }
     if (getIRList() != nullptr) {
         if (!processIRList(*oc)) { goto ERR_RETURN; }
@@ -1714,13 +1778,15 @@ bool Region::process(OptCtx * oc)
         do_ipa(this, oc);
     }
     if (g_infer_type) {
-        getPassMgr()->registerPass(PASS_INFER_TYPE)->perform(*oc);
+        getPassMgr()->performPass(PASS_INFER_TYPE, *oc);
     }
     post_process(this, oc);
+    xcom::smpoolSetThreadMemAccount(org_account);
     return true;
 ERR_RETURN:
     post_process(this, oc);
     oc->setInvalidAllFlags();
+    xcom::smpoolSetThreadMemAccount(org_account);
     return false;
 }
 //END Region
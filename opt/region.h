@@ -48,14 +48,66 @@ class IRSimp;
 class CDG;
 class CallGraph;
 
+//Interprocedural MOD/REF summary of function region.
+//The summary only describes the memory that is visible to caller, namely
+//global memory and the memory that pointed to by pointer arguments. The
+//local variables of region are excluded.
+#define MODREF_mod(s) ((s)->mod_mds)
+#define MODREF_ref(s) ((s)->ref_mds)
+#define MODREF_is_mod_worst(s) ((s)->is_mod_worst)
+#define MODREF_is_ref_worst(s) ((s)->is_ref_worst)
+#define MODREF_is_mod_arg(s) ((s)->is_mod_arg)
+#define MODREF_is_ref_arg(s) ((s)->is_ref_arg)
+class ModRefSummary {
+    COPY_CONSTRUCTOR(ModRefSummary);
+public:
+    MDSet * mod_mds; //Record the global MD that may be modified.
+    MDSet * ref_mds; //Record the global MD that may be referenced.
+
+    //True if region may modify unknown memory.
+    BYTE is_mod_worst:1;
+
+    //True if region may reference unknown memory.
+    BYTE is_ref_worst:1;
+
+    //True if region may modify the memory that pointed to by arguments.
+    BYTE is_mod_arg:1;
+
+    //True if region may reference the memory that pointed to by arguments.
+    BYTE is_ref_arg:1;
+public:
+    //Return true if the summary is able to substitute the worst case side
+    //effect of call.
+    bool isUsable() const { return !is_mod_worst && !is_ref_worst; }
+
+    //Return true if region does not modify memory that visible to caller.
+    bool isModNothing() const
+    { return isUsable() && !is_mod_arg && mod_mds->is_empty(); }
+
+    //Return true if region neither modify nor reference memory that
+    //visible to caller.
+    bool isNoMemEffect() const
+    { return isModNothing() && !is_ref_arg && ref_mds->is_empty(); }
+
+    //Return true if region only reads the memory that pointed to by
+    //arguments.
+    bool isReadArgOnly() const
+    { return isModNothing() && ref_mds->is_empty(); }
+
+    void dump(Region const* rg) const;
+};
+
+
 //Region MD referrence info.
 #define REF_INFO_maydef(ri) ((ri)->may_def_mds)
 #define REF_INFO_mayuse(ri) ((ri)->may_use_mds)
+#define REF_INFO_modref(ri) ((ri)->modref)
 class RefInfo {
     COPY_CONSTRUCTOR(RefInfo);
 public:
     MDSet * may_def_mds; //Record the MD set for Region usage
     MDSet * may_use_mds; //Record the MD set for Region usage
+    ModRefSummary * modref; //Record the interprocedural MOD/REF summary.
 public:
     //Count memory usage for current object.
     size_t count_mem()
@@ -615,6 +667,24 @@ public:
         return REF_INFO_mayuse(m_ref_info);
     }
 
+    //Get the interprocedural MOD/REF summary of Region.
+    ModRefSummary * getModRefSummary() const
+    { return m_ref_info != nullptr ? REF_INFO_modref(m_ref_info) : nullptr; }
+
+    //Generate the interprocedural MOD/REF summary of Region.
+    ModRefSummary * genModRefSummary()
+    {
+        initRefInfo();
+        if (REF_INFO_modref(m_ref_info) != nullptr) {
+            return REF_INFO_modref(m_ref_info);
+        }
+        ModRefSummary * s = (ModRefSummary*)xmalloc(sizeof(ModRefSummary));
+        MODREF_mod(s) = getMDSetMgr()->alloc();
+        MODREF_ref(s) = getMDSetMgr()->alloc();
+        REF_INFO_modref(m_ref_info) = s;
+        return s;
+    }
+
     //Get the top parent level region.
     Region * getTopRegion()
     {
@@ -628,6 +698,8 @@ public:
     //Allocate a internal LabelInfo that is not declared by compiler user.
     LabelInfo * genILabel()
     {
+        //Label id is allocated from RegionMgr, which is shared by regions.
+        xcom::AutoLock lock(getRegionMgr()->getLock());
         LabelInfo * li = genILabel(RM_label_count(getRegionMgr()));
         RM_label_count(getRegionMgr())++;
         return li;
@@ -684,6 +756,12 @@ public:
     LogMgr * getLogMgr() const
     { ASSERT0(getRegionMgr()); return getRegionMgr()->getLogMgr(); }
 
+    //Return the byte size of memory that the region holds since it began to
+    //be processed. Memory pools and IRs are accounted by current thread,
+    //whereas BitSets are attributed to the region that allocated them, even
+    //if they are freed by other thread.
+    LONGLONG getLiveMemSize() const;
+
     //Perform high level optmizations.
     //Return true if processing finish successful, otherwise return false.
     virtual bool HighProcess(OptCtx & oc);
@@ -692,6 +770,12 @@ public:
     bool hasAnaInstrument() const
     { return is_function() || is_program() || is_inner() || is_eh(); }
 
+    //Return true if the memory of region has exceeded the budget that
+    //g_thres_region_mem_size specified. Once exceeded, the region is kept
+    //in degraded state until it is processed completely, thus analyses
+    //will not flip between precise and conservative modes.
+    bool isMemBudgetExceeded() const;
+
     UINT id() const { return REGION_id(this); }
 
     //Initialze Region.
@@ -52,6 +52,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ai.h"
 #include "du.h"
 #include "status.h"
+#include "ir_arena.h"
 #include "ir.h"
 #include "ir_decl.h"
 #include "ir_decl_ext.h"
@@ -65,6 +65,10 @@ RegionMgr::RegionMgr() : m_type_mgr(this)
 
 RegionMgr::~RegionMgr()
 {
+    if (g_do_prof) {
+        Profiler::dump(this);
+        Profiler::clean();
+    }
     for (VecIdx id = 0; id <= m_id2rg.get_last_idx(); id++) {
         Region * rg = m_id2rg.get(id);
         if (rg == nullptr) { continue; }
@@ -91,6 +95,10 @@ RegionMgr::~RegionMgr()
     m_id2optctx.clean();
     smpoolDelete(m_pool);
     m_pool = nullptr;
+    for (VecIdx i = 0; i <= m_thread_pool.get_last_idx(); i++) {
+        smpoolDelete(m_thread_pool.get(i));
+    }
+    m_thread_pool.clean();
     delete m_logmgr;
     m_logmgr = nullptr;
     if(m_dm != nullptr) {
@@ -129,7 +137,13 @@ void RegionMgr::initIRDescFlagSet()
 void * RegionMgr::xmalloc(UINT size)
 {
     ASSERTN(m_pool != nullptr, ("pool not initialized"));
-    void * p = smpoolMalloc(size, m_pool);
+    SMemPool * pool = m_pool;
+    if (m_lock.is_enable()) {
+        //Each worker thread allocates memory from its own pool.
+        pool = m_thread_pool.get(xcom::getThreadIdx());
+        ASSERT0(pool);
+    }
+    void * p = smpoolMalloc(size, pool);
     ASSERT0(p != nullptr);
     ::memset((void*)p, 0, size);
     return p;
@@ -144,6 +158,7 @@ OptCtx * RegionMgr::allocOptCtx()
 
 OptCtx * RegionMgr::getAndGenOptCtx(Region * rg)
 {
+    xcom::AutoLock lock(getLock());
     OptCtx * oc = m_id2optctx.get(rg->id());
     if (oc == nullptr) {
         oc = allocOptCtx();
@@ -157,6 +172,7 @@ OptCtx * RegionMgr::getAndGenOptCtx(Region * rg)
 MD const* RegionMgr::genDedicateStrMD()
 {
     if (!m_is_regard_str_as_same_md) { return nullptr; }
+    xcom::AutoLock lock(getLock());
 
     //Regard all string variables as same unbound MD.
     if (m_str_md == nullptr) {
@@ -264,11 +280,11 @@ void RegionMgr::initTargInfoMgr()
 
 Region * RegionMgr::newRegion(REGION_TYPE rt)
 {
+    Region * rg = allocRegion(rt);
+    xcom::AutoLock lock(getLock());
     #ifdef _DEBUG_
     m_num_allocated++;
     #endif
-
-    Region * rg = allocRegion(rt);
     UINT free_id = m_free_rg_id.remove_head();
     if (free_id == REGION_ID_UNDEF) {
         REGION_id(rg) = m_rg_count++;
@@ -283,6 +299,7 @@ Region * RegionMgr::newRegion(REGION_TYPE rt)
 void RegionMgr::addToRegionTab(Region * rg)
 {
     ASSERTN(rg->id() > 0, ("should generate new region via newRegion()"));
+    xcom::AutoLock lock(getLock());
     ASSERT0(getRegion(rg->id()) == nullptr);
     ASSERT0(rg->id() < m_rg_count);
     UINT pad = xcom::getNearestPowerOf2(rg->id());
@@ -428,6 +445,7 @@ void RegionMgr::deleteRegion(Region * rg, bool collect_id)
     ASSERTN(getRegion(id), ("not registered region"));
     delete rg;
 
+    xcom::AutoLock lock(getLock());
     if (collect_id && id != REGION_ID_UNDEF) {
         m_id2rg.set(id, nullptr);
         m_free_rg_id.append_head(id);
@@ -458,6 +476,258 @@ bool RegionMgr::processProgramRegion(Region * program, OptCtx * oc)
     ASSERT0(program && program->is_program());
     return program->process(oc);
 }
+
+
+void RegionMgr::collectFuncRegion(Region * program,
+                                  OUT Vector<Region*> & funcs)
+{
+    ASSERT0(program && program->is_program());
+    if (program->getIRList() != nullptr) {
+        for (IR const* ir = program->getIRList();
+             ir != nullptr; ir = ir->get_next()) {
+            if (!ir->is_region() || !REGION_ru(ir)->is_function()) {
+                continue;
+            }
+            funcs.append(REGION_ru(ir));
+        }
+        return;
+    }
+    BBListIter bbit;
+    for (IRBB * bb = program->getBBList()->get_head(&bbit);
+         bb != nullptr; bb = program->getBBList()->get_next(&bbit)) {
+        BBIRListIter irit;
+        for (IR const* ir = bb->getIRList().get_head(&irit);
+             ir != nullptr; ir = bb->getIRList().get_next(&irit)) {
+            if (!ir->is_region() || !REGION_ru(ir)->is_function()) {
+                continue;
+            }
+            funcs.append(REGION_ru(ir));
+        }
+    }
+}
+
+
+//Return the vertex of 'rg' in call graph, or NULL if there is not.
+static xcom::Vertex const* getCallVertex(CallGraph const* callg,
+                                         Region const* rg)
+{
+    CallNode const* cn = callg->mapRegion2CallNode(rg);
+    if (cn == nullptr) { return nullptr; }
+    return callg->getVertex(cn->id());
+}
+
+
+//Return the region that 'v' represented.
+static Region * getCallVertexRegion(CallGraph const* callg,
+                                    xcom::Vertex const* v)
+{
+    CallNode const* cn = callg->mapVertex2CallNode(v);
+    return cn == nullptr ? nullptr : cn->region();
+}
+
+
+void RegionMgr::scheduleFuncRegion(Region * program,
+                                   Vector<Region*> const& funcs,
+                                   OUT Vector<Region*> & order,
+                                   OUT Vector<UINT> & wave_end)
+{
+    CallGraph const* callg = program->getCallGraph();
+    UINT num = funcs.get_elem_count();
+
+    //Map region id to the position in 'funcs' plus one.
+    Vector<UINT> rg2pos;
+    for (UINT i = 0; i < num; i++) {
+        rg2pos.set(funcs.get(i)->id(), i + 1);
+    }
+
+    //Count the callees in 'funcs' that have not been scheduled. Recursive
+    //call to region itself is ignored, because the region only reads the
+    //information of itself.
+    Vector<UINT> callee_num;
+    for (UINT i = 0; i < num; i++) {
+        Region const* rg = funcs.get(i);
+        UINT n = 0;
+        xcom::Vertex const* v = callg == nullptr ?
+            nullptr : getCallVertex(callg, rg);
+        for (xcom::EdgeC const* ec = v == nullptr ? nullptr : v->getOutList();
+             ec != nullptr; ec = EC_next(ec)) {
+            Region const* callee = getCallVertexRegion(callg, ec->getTo());
+            if (callee != nullptr && callee != rg &&
+                rg2pos.get(callee->id()) != 0) {
+                n++;
+            }
+        }
+        callee_num.set(i, n);
+    }
+
+    //Schedule the regions that all callees have been processed.
+    Vector<bool> scheduled;
+    for (UINT i = 0; i < num; i++) {
+        if (callee_num.get(i) == 0) {
+            order.append(funcs.get(i));
+            scheduled.set(i, true);
+        }
+    }
+    UINT start = 0;
+    while (start < order.get_elem_count()) {
+        UINT end = order.get_elem_count();
+        wave_end.append(end);
+        for (UINT j = start; j < end && callg != nullptr; j++) {
+            Region const* rg = order.get(j);
+            xcom::Vertex const* v = getCallVertex(callg, rg);
+            for (xcom::EdgeC const* ec = v == nullptr ?
+                     nullptr : v->getInList();
+                 ec != nullptr; ec = EC_next(ec)) {
+                Region * caller = getCallVertexRegion(callg, ec->getFrom());
+                if (caller == nullptr || caller == rg) { continue; }
+                UINT pos = rg2pos.get(caller->id());
+                if (pos == 0) { continue; }
+                ASSERT0(callee_num.get(pos - 1) > 0);
+                callee_num.set(pos - 1, callee_num.get(pos - 1) - 1);
+            }
+        }
+        //Keep program order in each wave.
+        for (UINT i = 0; i < num; i++) {
+            if (!scheduled.get(i) && callee_num.get(i) == 0) {
+                order.append(funcs.get(i));
+                scheduled.set(i, true);
+            }
+        }
+        start = end;
+    }
+
+    //The remaining regions are in or depend on recursive cycle.
+    for (UINT i = 0; i < num; i++) {
+        if (!scheduled.get(i)) { order.append(funcs.get(i)); }
+    }
+}
+
+
+void RegionMgr::computeModRefSummary(Region * program, OptCtx & oc)
+{
+    ASSERT0(program && program->is_program());
+    program->initPassMgr();
+    program->initDbxMgr();
+    program->initAttachInfoMgr();
+    program->initIRMgr();
+    program->initIRBBMgr();
+    if (!oc.is_callgraph_valid()) {
+        program->getPassMgr()->performPass(PASS_CALL_GRAPH, oc);
+    }
+    if (!oc.is_callgraph_valid()) { return; }
+    IPA * ipa = (IPA*)program->getPassMgr()->registerPass(PASS_IPA);
+    ASSERT0(ipa);
+    ipa->computeModRefSummary(oc);
+    program->getPassMgr()->destroyRegisteredPass(PASS_IPA);
+}
+
+
+Sym const* RegionMgr::addToSymbolTab(CHAR const* s)
+{
+    {
+        xcom::AutoReadLock lock(&m_sym_lock);
+        Sym const* sym = m_sym_tab.find(s);
+        if (sym != nullptr) { return sym; }
+    }
+    xcom::AutoWriteLock lock(&m_sym_lock);
+    return m_sym_tab.add(s);
+}
+
+
+void RegionMgr::beginConcurrentProcess(UINT thread_num)
+{
+    ASSERT0(thread_num > 1 && !m_lock.is_enable());
+    for (UINT i = m_thread_pool.get_elem_count(); i < thread_num; i++) {
+        m_thread_pool.set(i, smpoolCreate(64, MEM_COMM));
+    }
+    m_lock.enable(true);
+    m_sym_lock.enable(true);
+    m_type_mgr.getLock()->enable(true);
+    if (m_var_mgr != nullptr) { m_var_mgr->getLock()->enable(true); }
+    if (m_md_sys != nullptr) { m_md_sys->getLock()->enable(true); }
+    getLogMgr()->beginConcurrentDump(thread_num);
+}
+
+
+void RegionMgr::endConcurrentProcess()
+{
+    ASSERT0(m_lock.is_enable());
+    getLogMgr()->endConcurrentDump();
+    m_lock.enable(false);
+    m_sym_lock.enable(false);
+    m_type_mgr.getLock()->enable(false);
+    if (m_var_mgr != nullptr) { m_var_mgr->getLock()->enable(false); }
+    if (m_md_sys != nullptr) { m_md_sys->getLock()->enable(false); }
+}
+
+
+//Process all function regions that defined in program region.
+bool RegionMgr::processAllFuncRegion(Region * program)
+{
+    ASSERT0(program && program->is_program());
+    Vector<Region*> funcs;
+    collectFuncRegion(program, funcs);
+    Vector<Region*> order;
+    Vector<UINT> wave_end;
+    scheduleFuncRegion(program, funcs, order, wave_end);
+
+    //Generate OptCtx in advance to avoid contention of worker threads.
+    UINT num = order.get_elem_count();
+    for (UINT i = 0; i < num; i++) {
+        getAndGenOptCtx(order.get(i));
+    }
+
+    class ProcessFuncJob : public xcom::ParallelJob {
+    public:
+        RegionMgr * rm;
+        Vector<Region*> * funcs;
+        UINT start; //the position of the first region of current wave.
+        bool * results;
+        bool is_concurrent;
+    public:
+        virtual bool runTask(UINT task_idx, UINT thread_idx)
+        {
+            DUMMYUSE(thread_idx);
+            UINT pos = start + task_idx;
+            Region * rg = funcs->get(pos);
+            ASSERT0(rg);
+            //Keep processing other regions even if current one failed.
+            //Each task writes its own slot, thus no lock is needed.
+            results[pos] = rm->processFuncRegion(rg, rm->getAndGenOptCtx(rg));
+            if (is_concurrent) {
+                //Dump of the region is written out as a whole.
+                rm->getLogMgr()->flushThreadDump();
+            }
+            return true;
+        }
+    } job;
+    bool * results = num == 0 ? nullptr : new bool[num];
+    UINT thread_num = MAX(g_thread_num, 1);
+    job.rm = this;
+    job.funcs = &order;
+    job.results = results;
+    job.is_concurrent = thread_num > 1 && num > 1;
+    if (job.is_concurrent) { beginConcurrentProcess(thread_num); }
+    UINT start = 0;
+    for (UINT i = 0; i < wave_end.get_elem_count(); i++) {
+        job.start = start;
+        xcom::runParallelJob(thread_num, wave_end.get(i) - start, job);
+        start = wave_end.get(i);
+    }
+    if (job.is_concurrent) { endConcurrentProcess(); }
+
+    //Process the regions that in recursive cycle in program order.
+    for (UINT i = start; i < num; i++) {
+        Region * rg = order.get(i);
+        results[i] = processFuncRegion(rg, getAndGenOptCtx(rg));
+    }
+    bool succ = true;
+    for (UINT i = 0; i < num; i++) {
+        succ &= results[i];
+    }
+    delete [] results;
+    return succ;
+}
 //END RegionMgr
 
 } //namespace xoc
@@ -117,6 +117,21 @@ protected:
     xcom::BitSetMgr m_bs_mgr;
     xcom::DefMiscBitSetMgr m_sbs_mgr;
 
+    //The lock guards the tables of RegionMgr, such as region table, OptCtx
+    //table and label counter. TypeMgr, VarMgr and MDSystem have their own
+    //locks. All locks are only enabled while function regions are processed
+    //concurrently.
+    xcom::Mutex m_lock;
+
+    //The lock guards the symbol table.
+    xcom::RWLock m_sym_lock;
+
+    //Record the memory pool of each worker thread while function regions
+    //are processed concurrently. The OptCtx that allocated by worker thread
+    //is placed in the pool of the thread, thus xmalloc() does not need
+    //the lock.
+    xcom::Vector<xcom::SMemPool*> m_thread_pool;
+
     //ID is an important resource that should be recycled.
     //The region ID will be recycled if a region destroy.
     //The data structure records the ID of region that can be
@@ -126,12 +141,29 @@ protected:
     void estimateEV(OUT UINT & num_call, OUT UINT & num_ru,
                     bool scan_call, bool scan_inner_region);
 
+    //Compute the interprocedural MOD/REF summary of function regions that
+    //defined in 'program'. The summaries are readonly once computed, thus
+    //function regions can still be processed concurrently.
+    void computeModRefSummary(Region * program, OptCtx & oc);
+
+    //Collect function regions that defined in 'program' into 'funcs' in
+    //program order.
+    void collectFuncRegion(Region * program, OUT Vector<Region*> & funcs);
+
+    //Sort 'funcs' into 'order' by waves along the call graph of 'program'.
+    //The regions in wave i are order[wave_end[i-1], wave_end[i]), they only
+    //call the regions in earlier waves. The regions that are in or depend
+    //on a recursive cycle are placed after the last wave in program order.
+    void scheduleFuncRegion(Region * program, Vector<Region*> const& funcs,
+                            OUT Vector<Region*> & order,
+                            OUT Vector<UINT> & wave_end);
+
     void * xmalloc(UINT size);
 public:
     RegionMgr();
     virtual ~RegionMgr();
 
-    Sym const* addToSymbolTab(CHAR const* s) { return m_sym_tab.add(s); }
+    Sym const* addToSymbolTab(CHAR const* s);
 
     //This function will establish a map between region and its id.
     void addToRegionTab(Region * rg);
@@ -172,7 +204,19 @@ public:
     //Dump regions recorded via addToRegionTab().
     void dump(bool dump_inner_region);
 
+    //Enable the locks of the data structures shared by all regions, and
+    //prepare the LogMgr and memory pools for 'thread_num' worker threads.
+    //The function has to be invoked before function regions are processed
+    //concurrently.
+    void beginConcurrentProcess(UINT thread_num);
+
+    //Disable the locks and flush the dump of worker threads.
+    void endConcurrentProcess();
+
     xcom::BitSetMgr * getBitSetMgr() { return &m_bs_mgr; }
+
+    //Return the lock that guards the tables of RegionMgr.
+    xcom::Mutex * getLock() { return &m_lock; }
     xcom::DefMiscBitSetMgr * getSBSMgr() { return &m_sbs_mgr; }
     virtual Region * getRegion(UINT id) { return m_id2rg.get(id); }
     Region * getRegion(Var const* var) { return m_var2rg.get(var); }
@@ -275,10 +319,31 @@ public:
     //Process region in the form of function type.
     virtual bool processFuncRegion(IN Region * func, OptCtx * oc);
 
+    //Process all function regions that defined in 'program'.
+    //The function regions are scheduled in waves along the call graph: a
+    //callee is processed in an earlier wave than its callers, because
+    //callers read the MayDef and MayUse of processed callees. The regions
+    //in one wave are processed by g_thread_num worker threads. The regions
+    //in a recursive cycle are processed sequentially after all waves.
+    //The schedule does not depend on g_thread_num, thus the result is the
+    //same whatever the number of threads is.
+    //Return true if all function regions were processed successfully.
+    //NOTE: the dump of each region is buffered by worker thread, and
+    //written to log file after the region is processed.
+    virtual bool processAllFuncRegion(IN Region * program);
+
     //Process top-level region unit.
     //Top level region unit should be program unit.
     virtual bool processProgramRegion(IN Region * program, OptCtx * oc);
 
+    //Make sure the internal label allocated later does not reuse 'labid',
+    //e.g: the label number is given by a file.
+    void reserveLabel(UINT labid)
+    {
+        xcom::AutoLock lock(getLock());
+        if (labid >= m_label_count) { m_label_count = labid + 1; }
+    }
+
     void setProgramRegion(Region * rg) { m_program = rg; }
 
     //The function will demand all compilation process to regard all
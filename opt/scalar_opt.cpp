@@ -32,6 +32,11 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 namespace xoc {
 
 #define MAX_DCE_COUNT 4
+#define MAX_SCALAR_OPT_ROUND 20
+
+//
+//START ScalarOpt
+//
 
 bool ScalarOpt::isParticipateInOpt() const
 {
@@ -96,6 +101,122 @@ void ScalarOpt::updateCounter(
 }
 
 
+void ScalarOpt::dumpRound(UINT round, UINT run_num, UINT skip_num,
+                          UINT change_num) const
+{
+    if (!g_dump_opt.isDumpAfterPass() || !g_dump_opt.isDumpScalarOpt() ||
+        !m_rg->isLogMgrInit()) {
+        return;
+    }
+    note(getRegion(), "\nROUND%u:performed %u passes, skipped %u passes, "
+         "%u passes changed region", round, run_num, skip_num, change_num);
+}
+
+
+UINT ScalarOpt::getSubscribedChange(Pass const* pass) const
+{
+    switch (pass->getPassType()) {
+    case PASS_LICM:
+    case PASS_LOOP_CVT:
+    case PASS_VECT:
+        //The passes only transform stmts inside loop body.
+        return OC_CHANGE_LOOP|OC_CHANGE_CFG;
+    default:;
+    }
+    return OC_CHANGE_ALL;
+}
+
+
+bool ScalarOpt::performPassList(List<Pass*> & passlist, OptCtx & oc,
+                                OUT UINT & dce_count)
+{
+    if (g_dump_opt.isDumpAfterPass() && g_dump_opt.isDumpScalarOpt() &&
+        m_rg->isLogMgrInit()) {
+        note(getRegion(), "\n==---- DUMP %s '%s' ----==",
+             getPassName(), m_rg->getRegionName());
+    }
+    //Record the change kinds that happened after the pass at each position
+    //of 'passlist' performed last time. Note a pass may appear in
+    //'passlist' more than once.
+    Vector<UINT> pending;
+    UINT passnum = passlist.get_elem_count();
+    for (UINT i = 0; i < passnum; i++) {
+        pending.set(i, OC_CHANGE_ALL);
+    }
+    bool res = false;
+    bool change = true;
+    UINT count = 0;
+    UINT cp_count = 0;
+    UINT licm_count = 0;
+    UINT rp_count = 0;
+    UINT gcse_count = 0;
+    for (; count < MAX_SCALAR_OPT_ROUND; count++) {
+        if (!g_schedule_scalar_opt_by_change && change) {
+            //Reperform all passes if any pass changed region.
+            for (UINT i = 0; i < passnum; i++) {
+                pending.set(i, OC_CHANGE_ALL);
+            }
+        }
+        change = false;
+        UINT run_num = 0;
+        UINT skip_num = 0;
+        UINT change_num = 0;
+        UINT i = 0;
+        for (Pass * pass = passlist.get_head();
+             pass != nullptr; pass = passlist.get_next(), i++) {
+            ASSERT0(verifyIRandBB(m_rg->getBBList(), m_rg));
+            CHAR const* passname = pass->getPassName();
+            DUMMYUSE(passname);
+            if ((pending.get(i) & getSubscribedChange(pass)) == 0) {
+                skip_num++;
+                continue;
+            }
+            if (!worthToDo(pass, cp_count, licm_count, rp_count, gcse_count,
+                           dce_count)) {
+                //Keep the pending kinds, the pass may be worth to do
+                //in next round.
+                skip_num++;
+                continue;
+            }
+            pending.set(i, OC_CHANGE_UNDEF);
+            run_num++;
+            oc.cleanChangeKind();
+            bool doit = m_rg->getPassMgr()->performPass(pass, oc);
+            if (doit) {
+                change = true;
+                change_num++;
+                updateCounter(pass, cp_count, licm_count, rp_count, gcse_count,
+                              dce_count);
+                UINT kind = oc.getChangeKind();
+                if ((kind & (OC_CHANGE_STMT|OC_CHANGE_LOOP)) == 0) {
+                    //The pass did not classify the stmts it changed, be
+                    //conservative.
+                    kind |= OC_CHANGE_STMT|OC_CHANGE_LOOP;
+                }
+                for (UINT j = 0; j < passnum; j++) {
+                    pending.set(j, pending.get(j) | kind);
+                }
+            }
+            res |= doit;
+            ASSERT0(m_dumgr->verifyMDRef());
+            ASSERT0(xoc::verifyMDDUChain(m_rg, oc));
+            ASSERT0(verifyIRandBB(m_rg->getBBList(), m_rg));
+            ASSERT0(m_rg->getCFG()->verify());
+            ASSERT0(PRSSAMgr::verifyPRSSAInfo(m_rg, oc));
+            ASSERT0(MDSSAMgr::verifyMDSSAInfo(m_rg, oc));
+            ASSERT0(m_cfg->verifyRPO(oc));
+            ASSERT0(m_cfg->verifyLoopInfo(oc));
+            ASSERT0(m_cfg->verifyDomAndPdom(oc));
+            ASSERT0(!m_rg->getLogMgr()->isEnableBuffer());
+        }
+        dumpRound(count, run_num, skip_num, change_num);
+        if (!change) { break; }
+    }
+    ASSERT0(!change);
+    return res;
+}
+
+
 bool ScalarOpt::perform(OptCtx & oc)
 {
     if (!isParticipateInOpt()) { return false; }
@@ -105,12 +226,13 @@ bool ScalarOpt::perform(OptCtx & oc)
     if (g_do_gvn) {
         m_pass_mgr->registerPass(PASS_GVN);
     }
-    if (g_do_vrp) {
-        passlist.append_tail(m_pass_mgr->registerPass(PASS_VRP));
-    }
     if (g_do_ivr) {
         passlist.append_tail(m_pass_mgr->registerPass(PASS_IVR));
     }
+    if (g_do_vrp) {
+        //VRP uses the bound of induction variable as widening threshold.
+        passlist.append_tail(m_pass_mgr->registerPass(PASS_VRP));
+    }
     CopyProp * cp = nullptr;
     if (g_do_cp || g_do_cp_aggressive) {
         cp = (CopyProp*)m_pass_mgr->registerPass(PASS_CP);
@@ -135,6 +257,9 @@ bool ScalarOpt::perform(OptCtx & oc)
     if (g_do_gcse) {
         passlist.append_tail(m_pass_mgr->registerPass(PASS_GCSE));
     }
+    if (g_do_pre) {
+        passlist.append_tail(m_pass_mgr->registerPass(PASS_PRE));
+    }
     if (g_do_cp || g_do_cp_aggressive) {
         ASSERT0(cp);
         passlist.append_tail(cp);
@@ -148,7 +273,6 @@ bool ScalarOpt::perform(OptCtx & oc)
     if (g_do_dse) {
         passlist.append_tail(m_pass_mgr->registerPass(PASS_DSE));
     }
-    #ifdef FOR_IP
     if (g_do_vect) {
         //Vectorization expects that CP, DCE, LICM, RP and CfgOpt
         //have been performed.
@@ -157,6 +281,7 @@ bool ScalarOpt::perform(OptCtx & oc)
         if (g_opt_level >= OPT_LEVEL3) { pass->setAggressive(true); }
         passlist.append_tail(pass);
     }
+    #ifdef FOR_IP
     if (g_do_alge_reasscociate) {
         passlist.append_tail(m_pass_mgr->registerPass(PASS_ALGE_REASSCOCIATE));
     }
@@ -177,49 +302,11 @@ bool ScalarOpt::perform(OptCtx & oc)
     ASSERT0(m_cfg->verifyLoopInfo(oc));
     ASSERT0(m_cfg->verifyDomAndPdom(oc));
     ASSERT0(!m_rg->getLogMgr()->isEnableBuffer());
-    bool res = false;
-    bool change;
-    UINT count = 0;
-    UINT cp_count = 0;
-    UINT licm_count = 0;
-    UINT rp_count = 0;
-    UINT gcse_count = 0;
     UINT dce_count = 0;
-    do {
-        change = false;
-        for (Pass * pass = passlist.get_head();
-             pass != nullptr; pass = passlist.get_next()) {
-            ASSERT0(verifyIRandBB(m_rg->getBBList(), m_rg));
-            CHAR const* passname = pass->getPassName();
-            DUMMYUSE(passname);
-            bool doit = false;
-            if (worthToDo(pass, cp_count, licm_count, rp_count, gcse_count,
-                          dce_count)) {
-                doit = pass->perform(oc);
-            }
-            if (doit) {
-                change = true;
-                updateCounter(pass, cp_count, licm_count, rp_count, gcse_count,
-                              dce_count);
-            }
-            res |= doit;
-            ASSERT0(m_dumgr->verifyMDRef());
-            ASSERT0(xoc::verifyMDDUChain(m_rg, oc));
-            ASSERT0(verifyIRandBB(m_rg->getBBList(), m_rg));
-            ASSERT0(m_rg->getCFG()->verify());
-            ASSERT0(PRSSAMgr::verifyPRSSAInfo(m_rg, oc));
-            ASSERT0(MDSSAMgr::verifyMDSSAInfo(m_rg, oc));
-            ASSERT0(m_cfg->verifyRPO(oc));
-            ASSERT0(m_cfg->verifyLoopInfo(oc));
-            ASSERT0(m_cfg->verifyDomAndPdom(oc));
-            ASSERT0(!m_rg->getLogMgr()->isEnableBuffer());
-        }
-        count++;
-    } while (change && count < 20);
-    ASSERT0(!change);
+    bool res = performPassList(passlist, oc, dce_count);
     if (dce != nullptr && dce_count > MAX_DCE_COUNT) {
         //Only perform the last once.
-        res |= dce->perform(oc);
+        res |= m_rg->getPassMgr()->performPass(dce, oc);
         ASSERT0(m_dumgr->verifyMDRef());
         ASSERT0(xoc::verifyMDDUChain(m_rg, oc));
         ASSERT0(verifyIRandBB(m_rg->getBBList(), m_rg));
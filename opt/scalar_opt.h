@@ -42,6 +42,21 @@ protected:
     //optimizations.
     virtual bool isParticipateInOpt() const;
 
+    //The function dumps the statistics of each round of scheduling.
+    void dumpRound(UINT round, UINT run_num, UINT skip_num,
+                   UINT change_num) const;
+
+    //Return the change kinds that 'pass' subscribed, see OC_CHANGE.
+    //Each pass subscribes a set of change kinds, and it will be reperformed
+    //only if some pass made the subscribed change after it performed last
+    //time.
+    virtual UINT getSubscribedChange(Pass const* pass) const;
+
+    //Perform passes in 'passlist' iteratively until nothing changed.
+    //Return true if any pass changed region.
+    bool performPassList(List<Pass*> & passlist, OptCtx & oc,
+                         OUT UINT & dce_count);
+
     void updateCounter(
         Pass const* pass, UINT & cp_count, UINT & licm_count, UINT & rp_count,
         UINT & gcse_count, UINT & dce_count);
@@ -71,6 +86,10 @@ public:
     { return "Scalar Optimizations"; }
     virtual PASS_TYPE getPassType() const { return PASS_SCALAR_OPT; }
 
+    //The pass only dispatches passes, each of them decides whether the
+    //whole MDSSA is needed.
+    virtual bool isMDSSAOnDemandClient() const { return true; }
+
     virtual bool perform(OptCtx & oc);
 };
 
@@ -460,18 +460,25 @@ void SolveSetMgr::solveByRPO(RPOVexList const* rpovexlst, UFlag const flag,
         for (rpovexlst->get_head(&ct); ct != rpovexlst->end();
              ct = rpovexlst->get_next(ct)) {
             IRBB * bb = m_cfg->getBB(ct->val()->id());
+            bool lchange = false;
             if (flag.have(DUOPT_SOL_AVAIL_REACH_DEF)) {
-                change |= ForAvailReachDef(bb, nullptr, bsmgr);
+                lchange |= ForAvailReachDef(bb, nullptr, bsmgr);
+                m_stat.visit_num++;
             }
             if (flag.have(DUOPT_SOL_REACH_DEF)) {
-                change |= ForReachDef(bb, nullptr, bsmgr);
+                lchange |= ForReachDef(bb, nullptr, bsmgr);
+                m_stat.visit_num++;
             }
             if (flag.have(DUOPT_SOL_AVAIL_EXPR)) {
-                change |= ForAvailExpression(bb, nullptr, bsmgr);
+                lchange |= ForAvailExpression(bb, nullptr, bsmgr);
+                m_stat.visit_num++;
             }
+            if (lchange) { m_stat.change_num++; }
+            change |= lchange;
         }
         count++;
     } while (change && count < 20);
+    m_stat.round_num = count;
     //UINT i = count * tbbl->get_elem_count(); //time of bb accessed.
     ASSERT0(!change);
 }
@@ -506,6 +513,447 @@ void SolveSetMgr::solveByWorkList(List<IRBB*> * tbbl, UFlag const flag,
 }
 
 
+//The worklist pops the BB that has the smallest position, namely, it is a
+//priority queue ordered by RPO. The RPO here is computed in a way that the
+//BBs in loop body are contiguous, and precede the BBs after the loop.
+//Thus the IN set of BB is computed after all its forward predecessors, and
+//inner loop converges before its changes are propagated to the code after
+//the loop. The RPO of CFG does not guarantee the property, it may place
+//the code after loop before the loop body, then the change of each
+//iteration of loop will be propagated to the code after loop separately.
+class RPOWorkList {
+    COPY_CONSTRUCTOR(RPOWorkList);
+    //There is no element in the set whose position is less than m_lowest.
+    BSIdx m_lowest;
+    IRCFG const* m_cfg;
+    xcom::BitSet m_set; //the set of position.
+    xcom::Vector<UINT> m_bbid2pos;
+    xcom::Vector<IRBB*> m_pos2bb;
+private:
+    //Return true if 'bbid' is in the loop of 'head' or its inner loop.
+    static bool isInLoop(UINT bbid, UINT head, Vector<UINT> const& loop,
+                         Vector<UINT> const& outer)
+    {
+        for (UINT h = loop.get(bbid); h != BBID_UNDEF; h = outer.get(h)) {
+            if (h == head) { return true; }
+        }
+        return false;
+    }
+
+    //Compute the innermost loop head of each BB by natural loop of back
+    //edges, where back edge is recognized by the position of given RPO.
+    //loop: map BB to its innermost loop head.
+    //outer: map loop head to the head of outer loop.
+    void computeLoop(RPOVexList const* rpovexlst, OUT Vector<UINT> & loop,
+                     OUT Vector<UINT> & outer);
+    void computeOrder(RPOVexList const* rpovexlst);
+public:
+    RPOWorkList(RPOVexList const* rpovexlst, IRCFG const* cfg)
+    {
+        m_lowest = 0;
+        m_cfg = cfg;
+        computeOrder(rpovexlst);
+    }
+
+    void append(UINT bbid)
+    {
+        BSIdx pos = (BSIdx)m_bbid2pos.get(bbid);
+        ASSERT0(m_pos2bb.get(pos) && m_pos2bb.get(pos)->id() == bbid);
+        m_set.bunion(pos);
+        if (pos < m_lowest) { m_lowest = pos; }
+    }
+
+    //Append all BBs.
+    void appendAll()
+    {
+        for (VecIdx i = 0; i <= m_pos2bb.get_last_idx(); i++) {
+            m_set.bunion((BSIdx)i);
+        }
+        m_lowest = 0;
+    }
+
+    UINT getNumOfBB() const { return (UINT)m_pos2bb.get_elem_count(); }
+
+    //Return the BB in given position.
+    IRBB * getBB(UINT pos) const { return m_pos2bb.get(pos); }
+
+    //Return the position of given BB.
+    UINT getPos(UINT bbid) const { return m_bbid2pos.get(bbid); }
+
+    //Remove and return the BB that has the smallest position.
+    IRBB * remove()
+    {
+        BSIdx pos = m_lowest == 0 ? m_set.get_first() :
+                    m_set.get_next(m_lowest - 1);
+        if (pos == BS_UNDEF) { return nullptr; }
+        m_set.diff(pos);
+        m_lowest = pos + 1;
+        return m_pos2bb.get(pos);
+    }
+};
+
+
+void RPOWorkList::computeLoop(RPOVexList const* rpovexlst,
+                              OUT Vector<UINT> & loop,
+                              OUT Vector<UINT> & outer)
+{
+    Vector<UINT> rpo; //map BB id to the position in RPO of CFG.
+    UINT pos = 0;
+    RPOVexListIter ct;
+    for (rpovexlst->get_head(&ct); ct != rpovexlst->end();
+         ct = rpovexlst->get_next(ct), pos++) {
+        rpo.set(ct->val()->id(), pos);
+    }
+
+    //Visit loop head in RPO, thus the outer loop is visited before inner
+    //loop, and the BB in inner loop is finally mapped to the inner loop.
+    Vector<UINT> visited; //record the loop head that visited BB.
+    List<UINT> wl;
+    for (rpovexlst->get_head(&ct); ct != rpovexlst->end();
+         ct = rpovexlst->get_next(ct)) {
+        Vertex const* head = ct->val();
+        UINT headpos = rpo.get(head->id());
+        bool is_head = false;
+        for (xcom::EdgeC const* ecs = head->getInList();
+             ecs != nullptr; ecs = ecs->get_next()) {
+            UINT pred = ecs->getFromId();
+            if (rpo.get(pred) < headpos) { continue; }
+            //pred->head is back edge.
+            if (!is_head) {
+                is_head = true;
+                outer.set(head->id(), loop.get(head->id()));
+                loop.set(head->id(), head->id());
+                visited.set(head->id(), head->id());
+            }
+            if (visited.get(pred) != head->id()) {
+                visited.set(pred, head->id());
+                wl.append_tail(pred);
+            }
+        }
+        while (wl.get_elem_count() != 0) {
+            UINT v = wl.remove_head();
+            loop.set(v, head->id());
+            for (xcom::EdgeC const* ecs = m_cfg->getVertex(v)->getInList();
+                 ecs != nullptr; ecs = ecs->get_next()) {
+                UINT pred = ecs->getFromId();
+                //The BB in natural loop is not ahead of loop head in RPO.
+                //The constraint also avoids walking out of irreducible loop.
+                if (visited.get(pred) == head->id() ||
+                    rpo.get(pred) < headpos) {
+                    continue;
+                }
+                visited.set(pred, head->id());
+                wl.append_tail(pred);
+            }
+        }
+    }
+}
+
+
+void RPOWorkList::computeOrder(RPOVexList const* rpovexlst)
+{
+    Vector<UINT> loop;
+    Vector<UINT> outer;
+    computeLoop(rpovexlst, loop, outer);
+
+    //DFS visits the successors that exit the innermost loop of current BB
+    //at first. Thus these successors are finished earlier and placed after
+    //the loop body in RPO.
+    UINT bbnum = rpovexlst->get_elem_count();
+    Vector<IRBB*> postorder;
+    xcom::BitSet visited;
+    Vector<Vertex const*> stk;
+    Vector<UINT> phase; //0:visit exit successor, 1:visit others, 2:finish.
+    VecIdx top = 0;
+    RPOVexListIter ct;
+    rpovexlst->get_head(&ct);
+    Vertex const* entry = ct->val();
+    stk.set(top, entry);
+    phase.set(top, 0);
+    visited.bunion((BSIdx)entry->id());
+    while (top >= 0) {
+        Vertex const* v = stk.get(top);
+        UINT ph = phase.get(top);
+        if (ph == 2) {
+            top--;
+            postorder.append(m_cfg->getBB(v->id()));
+            continue;
+        }
+        UINT head = loop.get(v->id());
+        Vertex const* next = nullptr;
+        for (xcom::EdgeC const* ecs = v->getOutList();
+             ecs != nullptr; ecs = ecs->get_next()) {
+            UINT succ = ecs->getToId();
+            if (visited.is_contain((BSIdx)succ)) { continue; }
+            bool is_exit = head != BBID_UNDEF &&
+                           !isInLoop(succ, head, loop, outer);
+            if ((ph == 0) == is_exit) { next = ecs->getTo(); break; }
+        }
+        if (next == nullptr) {
+            phase.set(top, ph + 1);
+            continue;
+        }
+        visited.bunion((BSIdx)next->id());
+        top++;
+        stk.set(top, next);
+        phase.set(top, 0);
+    }
+    ASSERT0(postorder.get_elem_count() <= bbnum);
+    UINT pos = 0;
+    for (VecIdx i = postorder.get_last_idx(); i >= 0; i--, pos++) {
+        IRBB * bb = postorder.get(i);
+        m_bbid2pos.set(bb->id(), pos);
+        m_pos2bb.set(pos, bb);
+    }
+
+    //Append the BBs that are not reachable from the entry of RPO, if any.
+    for (rpovexlst->get_head(&ct); ct != rpovexlst->end();
+         ct = rpovexlst->get_next(ct)) {
+        if (visited.is_contain((BSIdx)ct->val()->id())) { continue; }
+        IRBB * bb = m_cfg->getBB(ct->val()->id());
+        m_bbid2pos.set(bb->id(), pos);
+        m_pos2bb.set(pos, bb);
+        pos++;
+    }
+    ASSERT0(pos == bbnum);
+}
+
+
+//Record the changed bits of OUT set of BB that have not been propagated to
+//the IN set of successors.
+class DeltaSetVec {
+    COPY_CONSTRUCTOR(DeltaSetVec);
+    Vector<SolveSet*> m_vec;
+    DefMiscBitSetMgr & m_bsmgr;
+public:
+    DeltaSetVec(DefMiscBitSetMgr & bsmgr) : m_bsmgr(bsmgr) {}
+    ~DeltaSetVec()
+    {
+        for (VecIdx i = 0; i <= m_vec.get_last_idx(); i++) {
+            SolveSet * s = m_vec.get(i);
+            if (s == nullptr) { continue; }
+            m_bsmgr.destroySEGandFreeDBitSetCore(s);
+        }
+    }
+
+    SolveSet * gen(UINT bbid)
+    {
+        SolveSet * s = m_vec.get(bbid);
+        if (s == nullptr) {
+            s = allocSet();
+            m_vec.set(bbid, s);
+        }
+        return s;
+    }
+
+    SolveSet * get(UINT bbid) const { return m_vec.get(bbid); }
+
+    //Return the pending set of 'bbid' and replace it with 'empty'.
+    //The function avoids copying the pending set.
+    SolveSet * exchange(UINT bbid, SolveSet * empty)
+    {
+        ASSERT0(empty && empty->is_empty());
+        SolveSet * s = m_vec.get(bbid);
+        ASSERT0(s);
+        m_vec.set(bbid, empty);
+        return s;
+    }
+
+    SolveSet * allocSet()
+    {
+        SolveSet * s = (SolveSet*)m_bsmgr.allocDBitSetCore();
+        s->set_sparse(SOL_SET_IS_SPARSE);
+        return s;
+    }
+
+    void freeSet(SolveSet * s) { m_bsmgr.destroySEGandFreeDBitSetCore(s); }
+
+    //Add 'delta' to the pending set of all successors of 'bb'.
+    void propagate(IRBB const* bb, SolveSet const& delta, RPOWorkList & wl)
+    {
+        for (xcom::EdgeC const* ecs = bb->getVex()->getOutList();
+             ecs != nullptr; ecs = ecs->get_next()) {
+            UINT succ = ecs->getToId();
+            gen(succ)->bunion(delta, m_bsmgr);
+            wl.append(succ);
+        }
+    }
+};
+
+
+void SolveSetMgr::solveReachDefByDelta(MOD RPOWorkList & wl,
+                                       MOD DefMiscBitSetMgr & bsmgr)
+{
+    //The first round evaluates the whole transfer function of each BB in
+    //RPO. Afterwards, the IN set of BB is up to date except the bits that
+    //come from the predecessors along back edges, because these
+    //predecessors were visited later. Since the OUT set was empty when it
+    //was read by the successor, the whole OUT set is the delta.
+    DeltaSetVec pending(bsmgr);
+    for (UINT i = 0; i < wl.getNumOfBB(); i++) {
+        ForReachDef(wl.getBB(i), nullptr, bsmgr);
+        m_stat.visit_num++;
+    }
+    for (UINT i = 0; i < wl.getNumOfBB(); i++) {
+        IRBB const* bb = wl.getBB(i);
+        SolveSet const* out = getReachDefOut(bb->id());
+        if (out->is_empty()) { continue; }
+        for (xcom::EdgeC const* ecs = bb->getVex()->getOutList();
+             ecs != nullptr; ecs = ecs->get_next()) {
+            UINT succ = ecs->getToId();
+            if (wl.getPos(succ) > i) { continue; }
+            pending.gen(succ)->bunion(*out, bsmgr);
+            wl.append(succ);
+        }
+    }
+    SolveSet * spare = pending.allocSet();
+    for (IRBB const* bb = wl.remove(); bb != nullptr; bb = wl.remove()) {
+        UINT bbid = bb->id();
+        SolveSet * delta = pending.exchange(bbid, spare);
+        spare = delta;
+
+        //IN = IN U delta
+        SolveSet * in = genReachDefIn(bbid);
+        delta->diff(*in, bsmgr);
+        if (delta->is_empty()) { continue; }
+        m_stat.visit_num++;
+        bunionReachDefIn(in, *delta);
+
+        //Only the new bits that survive from the killing contribute to OUT.
+        SolveSet const* killset = getMustKilledDef(bbid);
+        if (killset != nullptr) {
+            delta->diff(*killset, bsmgr);
+        }
+        SolveSet * out = genReachDefOut(bbid);
+        delta->diff(*out, bsmgr);
+        if (delta->is_empty()) { continue; }
+        bunionReachDefOut(out, *delta);
+        m_stat.change_num++;
+        pending.propagate(bb, *delta, wl);
+        delta->clean(bsmgr);
+    }
+    pending.freeSet(spare);
+}
+
+
+void SolveSetMgr::solveAvailExprByDelta(SolveSet const& expr_univers,
+                                        MOD RPOWorkList & wl,
+                                        MOD DefMiscBitSetMgr & bsmgr)
+{
+    //The available expressions decrease monotonically, the delta describes
+    //the bits that removed from OUT set. Because the IN set is the
+    //intersection of OUT sets of predecessors, a bit removed from the OUT
+    //set of any predecessor is also removed from IN set.
+    //The first round evaluates the whole transfer function of each BB in
+    //RPO. The successor along back edge has read the initial OUT set of
+    //predecessor, thus the delta is the bits removed from the initial OUT.
+    IRBB const* entry = m_cfg->getEntry();
+    DeltaSetVec pending(bsmgr);
+    for (UINT i = 0; i < wl.getNumOfBB(); i++) {
+        ForAvailExpression(wl.getBB(i), nullptr, bsmgr);
+        m_stat.visit_num++;
+    }
+    SolveSet delta(SOL_SET_IS_SPARSE);
+    for (UINT i = 0; i < wl.getNumOfBB(); i++) {
+        IRBB const* bb = wl.getBB(i);
+        bool computed = false;
+        for (xcom::EdgeC const* ecs = bb->getVex()->getOutList();
+             ecs != nullptr; ecs = ecs->get_next()) {
+            UINT succ = ecs->getToId();
+            if (wl.getPos(succ) > i) { continue; }
+            if (!computed) {
+                //Compute the initial OUT set, see solve().
+                computed = true;
+                ASSERT0(bb != entry);
+                delta.copy(expr_univers, bsmgr);
+                SolveSet const* set = getKilledIRExpr(bb->id());
+                if (set != nullptr) {
+                    delta.diff(*set, bsmgr);
+                }
+                delta.bunion(*genGenIRExpr(bb->id()), bsmgr);
+                delta.diff(*genAvailExprOut(bb->id()), bsmgr);
+            }
+            if (delta.is_empty()) { break; }
+            pending.gen(succ)->bunion(delta, bsmgr);
+            wl.append(succ);
+        }
+    }
+    DUMMYUSE(entry);
+    delta.clean(bsmgr);
+    SolveSet * spare = pending.allocSet();
+    for (IRBB const* bb = wl.remove(); bb != nullptr; bb = wl.remove()) {
+        UINT bbid = bb->id();
+        SolveSet * removed = pending.exchange(bbid, spare);
+        spare = removed;
+
+        //IN = IN - delta
+        SolveSet * in = genAvailExprIn(bbid);
+        removed->intersect(*in, bsmgr);
+        if (removed->is_empty()) { continue; }
+        m_stat.visit_num++;
+        diffAvailExprIn(in, *removed);
+
+        //The removed bits of IN are also removed from OUT unless they are
+        //generated by BB itself.
+        removed->diff(*genGenIRExpr(bbid), bsmgr);
+        SolveSet * out = genAvailExprOut(bbid);
+        removed->intersect(*out, bsmgr);
+        if (removed->is_empty()) { continue; }
+        diffAvailExprOut(out, *removed);
+        m_stat.change_num++;
+        pending.propagate(bb, *removed, wl);
+        removed->clean(bsmgr);
+    }
+    pending.freeSet(spare);
+}
+
+
+void SolveSetMgr::solveAvailReachDefByWorkList(MOD RPOWorkList & wl,
+                                               MOD DefMiscBitSetMgr & bsmgr)
+{
+    //The intersection of increasing OUT sets can not be computed by delta,
+    //thus the whole transfer function is evaluated. Only the successors
+    //of the BB whose OUT set changed are revisited.
+    wl.appendAll();
+    for (IRBB const* bb = wl.remove(); bb != nullptr; bb = wl.remove()) {
+        m_stat.visit_num++;
+        if (!ForAvailReachDef(bb, nullptr, bsmgr)) { continue; }
+        m_stat.change_num++;
+        for (xcom::EdgeC const* ecs = bb->getVex()->getOutList();
+             ecs != nullptr; ecs = ecs->get_next()) {
+            wl.append(ecs->getToId());
+        }
+    }
+}
+
+
+void SolveSetMgr::solveByPriorityWorkList(RPOVexList const* rpovexlst,
+                                          SolveSet const& expr_univers,
+                                          UFlag const flag,
+                                          MOD DefMiscBitSetMgr & bsmgr)
+{
+    IRBB const* entry = m_cfg->getEntry();
+    if (entry->getVex()->getInList() != nullptr) {
+        //The initial value of entry is not the boundary value of equations
+        //if entry has predecessor, use the iterative solver instead.
+        solveByRPO(rpovexlst, flag, bsmgr);
+        return;
+    }
+    m_stat.is_worklist = true;
+    RPOWorkList wl(rpovexlst, m_cfg);
+    if (flag.have(DUOPT_SOL_AVAIL_REACH_DEF)) {
+        solveAvailReachDefByWorkList(wl, bsmgr);
+    }
+    if (flag.have(DUOPT_SOL_REACH_DEF)) {
+        solveReachDefByDelta(wl, bsmgr);
+    }
+    if (flag.have(DUOPT_SOL_AVAIL_EXPR)) {
+        solveAvailExprByDelta(expr_univers, wl, bsmgr);
+    }
+}
+
+
+
 //Solve reaching definitions problem for IR STMT and
 //computing LIVE IN and LIVE OUT IR expressions.
 //expr_univers: the Universal SET for ExpRep.
@@ -553,10 +1001,16 @@ void SolveSetMgr::solve(SolveSet const& expr_univers, UFlag const flag,
     RPOVexList * vexlst = m_cfg->getRPOVexList();
     ASSERT0(vexlst);
     ASSERT0(vexlst->get_elem_count() == m_bblst->get_elem_count());
+    m_stat.clean();
+    m_stat.bb_num = vexlst->get_elem_count();
     #ifdef WORK_LIST_DRIVE
     solveByWorkList(vexlst, flag, bsmgr);
     #else
-    solveByRPO(vexlst, flag, bsmgr);
+    if (g_solve_du_set_by_worklist) {
+        solveByPriorityWorkList(vexlst, expr_univers, flag, bsmgr);
+    } else {
+        solveByRPO(vexlst, flag, bsmgr);
+    }
     #endif
     END_TIMER(t7, "Solve DU set");
 }
@@ -1388,6 +1842,7 @@ void SolveSetMgr::dump(bool is_dump_bs) const
     if (!m_rg->isLogMgrInit()) { return; }
     note(getRegion(), "\n\n==---- DUMP SolveSetMgr '%s' ----==\n",
          m_rg->getRegionName());
+    dumpStat();
     BBListIter cb;
     SolveSetMgr * pthis = const_cast<SolveSetMgr*>(this);
     UINT ind = 2;
@@ -1424,6 +1879,16 @@ void SolveSetMgr::dump(bool is_dump_bs) const
 }
 
 
+void SolveSetMgr::dumpStat() const
+{
+    if (!m_rg->isLogMgrInit()) { return; }
+    note(getRegion(), "\nSOLVER:%s BB:%u ROUND:%u VISIT:%u CHANGE:%u",
+         m_stat.is_worklist ? "priority-worklist" : "rpo",
+         m_stat.bb_num, m_stat.round_num, m_stat.visit_num,
+         m_stat.change_num);
+}
+
+
 static size_t dumpMemUsageImpl(Region const* rg, SolveSet const* set,
                                CHAR const* set_name)
 {
@@ -139,6 +139,22 @@ public:
     }
 };
 
+class RPOWorkList;
+
+//Record the cost of the last solving of dataflow equations.
+class SolveStat {
+public:
+    bool is_worklist; //true if the priority worklist solver is used.
+    UINT bb_num; //the number of BB in CFG.
+    UINT round_num; //the number of rounds of the RPO solver.
+    UINT visit_num; //the number of times that transfer function evaluated.
+    UINT change_num; //the number of times that OUT set of BB changed.
+public:
+    SolveStat() { clean(); }
+    void clean() { ::memset((void*)this, 0, sizeof(SolveStat)); }
+};
+
+
 class SolveSetMgr {
     COPY_CONSTRUCTOR(SolveSetMgr);
     Region * m_rg;
@@ -204,6 +220,7 @@ class SolveSetMgr {
     Vector<SolveSet*> m_may_killed_def; //may-killed def of STMT
     Vector<SolveSet*> m_livein_bb; //live-in BB
     BSVec<SolveSet*> m_killed_ir_exp; //killed EXPR
+    SolveStat m_stat; //statistics of the last solving.
 private:
     //The macro declares a series of functions to operate given SolveSet.
     //Note LocalSet will be destroy and reinialized after perform(), whereas
@@ -363,6 +380,21 @@ private:
     void solveByWorkList(List<IRBB*> * tbbl, UFlag const flag,
                          MOD DefMiscBitSetMgr & bsmgr);
 
+    //Solve dataflow equations by a worklist that is ordered by RPO. BB is
+    //revisited only if the OUT set of its predecessor changed, and only the
+    //changed bits of OUT set are propagated to successors.
+    void solveByPriorityWorkList(RPOVexList const* rpovexlst,
+                                 SolveSet const& expr_univers,
+                                 UFlag const flag,
+                                 MOD DefMiscBitSetMgr & bsmgr);
+    void solveReachDefByDelta(MOD RPOWorkList & wl,
+                              MOD DefMiscBitSetMgr & bsmgr);
+    void solveAvailExprByDelta(SolveSet const& expr_univers,
+                               MOD RPOWorkList & wl,
+                               MOD DefMiscBitSetMgr & bsmgr);
+    void solveAvailReachDefByWorkList(MOD RPOWorkList & wl,
+                                      MOD DefMiscBitSetMgr & bsmgr);
+
     //Solve reaching definitions problem for IR STMT and
     //computing LIVE IN and LIVE OUT IR expressions.
     //'expr_univers': the Universal SET for ExpRep.
@@ -435,10 +467,14 @@ public:
 
     //Dump mem usage for each internal set of bb.
     void dumpMemUsage() const;
+
+    //Dump the iteration count of the last solving.
+    void dumpStat() const;
     //is_bs: true to dump bitset info.
     void dump(bool is_dump_bs = false) const;
 
     Region * getRegion() const { return m_rg; }
+    SolveStat const& getStat() const { return m_stat; }
     xcom::DefMiscBitSetMgr * getLocalSBSMgr() { return &m_local_sbs_mgr; }
     xcom::DefMiscBitSetMgr * getGlobalSBSMgr() { return &m_global_sbs_mgr; }
 
@@ -364,7 +364,8 @@ SymType * SymTabBase<SymType, CompareFuncType>::find(CHAR const* s) const
 {
     ASSERT0(s);
     SymType sym;
-    SYM_name(&sym) = const_cast<CHAR*>(s);
+    sym.init();
+    sym.initByString(s, (UINT)::strlen(s));
     bool find = false;
     return xcom::TTab<SymType*, CompareFuncType>::get(&sym, &find);
 }
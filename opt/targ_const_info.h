@@ -53,4 +53,11 @@ author: Su Zhenyu
 #error "No target info"
 #endif
 
+//Define the byte size of vector register if target does not specify it.
+//128-bit vector unit is the most common one, e.g: SSE and NEON.
+//Target that does not have vector unit should define it as 0.
+#ifndef VECTOR_REGISTER_BYTE_SIZE
+#define VECTOR_REGISTER_BYTE_SIZE 16
+#endif
+
 #endif
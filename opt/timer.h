@@ -52,20 +52,19 @@ namespace xoc {
 
 
 //Timer, show const string before timer start and end.
+//The timer also records a sub-phase scope of profiler if g_do_prof is true.
 //e.g:
 //    START_TIMER(t, "My Pass");
 //    Run mypass();
 //    END_TIMER(t, "My Pass");
 #define START_TIMER(_timer_, s) \
-    LONG _timer_ = 0; \
-    if (g_show_time) { \
-        _timer_ = getclockstart(); \
-        prt2C("\n==-- START %s", (s)); \
+    xoc::PassTimer _timer_; \
+    if (g_show_time || g_do_prof) { \
+        _timer_.start(s); \
     }
 #define END_TIMER(_timer_, s) \
-    if (g_show_time) { \
-        prt2C("\n==-- END %s", s); \
-        prt2C(" Time:%fsec", getclockend(_timer_)); \
+    if (g_show_time || g_do_prof) { \
+        _timer_.end(s); \
     }
 
 
@@ -74,17 +73,13 @@ namespace xoc {
 //    Run mypass();
 //    END_TIMER(t, ("My Pass Name:%s", getPassName()));
 #define START_TIMER_FMT(_timer_, s) \
-    LONG _timer_ = 0; \
-    if (g_show_time) { \
-        _timer_ = getclockstart(); \
-        prt2C("\n==-- START "); \
-        prt2C s; \
+    xoc::PassTimer _timer_; \
+    if (g_show_time || g_do_prof) { \
+        _timer_.startFmt s; \
     }
 #define END_TIMER_FMT(_timer_, s) \
-    if (g_show_time) { \
-        prt2C("\n==-- END "); \
-        prt2C s; \
-        prt2C(" Time:%fsec", getclockend(_timer_)); \
+    if (g_show_time || g_do_prof) { \
+        _timer_.endFmt s; \
     }
 
 } //namespace xoc
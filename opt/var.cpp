@@ -124,6 +124,16 @@ VAR_FLAG VarFlagDesc::getFlag(UINT idx)
     ASSERT0(idx < g_varflag_num);
     return g_varflag_desc[idx].flag;
 }
+
+
+bool VarFlagDesc::isValidFlag(UINT flag)
+{
+    UINT all = VAR_UNDEF;
+    for (UINT i = 0; i < g_varflag_num; i++) {
+        all |= g_varflag_desc[i].flag;
+    }
+    return (flag & ~all) == 0;
+}
 //END VarFlagDesc
 
 
@@ -189,6 +199,16 @@ VAR_LINK_ATTR VarLinkAttrDesc::getAttr(UINT idx)
     ASSERT0(idx < g_var_link_attr_num);
     return g_var_link_attr_desc[idx].attr;
 }
+
+
+bool VarLinkAttrDesc::isValidAttr(UINT attr)
+{
+    UINT all = VAR_LINK_ATTR_UNDEF;
+    for (UINT i = 0; i < g_var_link_attr_num; i++) {
+        all |= g_var_link_attr_desc[i].attr;
+    }
+    return (attr & ~all) == 0;
+}
 //END VarLinkAttrDesc
 
 
@@ -438,6 +458,7 @@ CHAR const* Var::dump(OUT StrBuf & buf, VarMgr const* vm) const
 void VarMgr::destroyVar(Var * v)
 {
     ASSERT0(v->id() != VAR_ID_UNDEF);
+    xcom::AutoWriteLock lock(&m_lock);
     m_freelist_of_varid.bunion(v->id(), *m_rm->getSBSMgr());
     m_var_vec.set(v->id(), nullptr);
     if (v->is_string() && v->hasInitString()) {
@@ -469,6 +490,7 @@ bool VarMgr::isDedicatedStringVar(CHAR const* name) const
 
 void VarMgr::assignVarId(Var * v)
 {
+    xcom::AutoWriteLock lock(&m_lock);
     DefSBitSetIter iter = nullptr;
     BSIdx id = m_freelist_of_varid.get_first(&iter);
     ASSERT0(id != VAR_ID_UNDEF);
@@ -489,6 +511,8 @@ void VarMgr::assignVarId(Var * v)
 //the first.
 Var * VarMgr::findVarByName(Sym const* name)
 {
+    //Other threads may register Var into m_var_vec simultaneously.
+    xcom::AutoReadLock lock(&m_lock);
     for (VecIdx i = 0; i <= m_var_vec.get_last_idx(); i++) {
         Var * v = m_var_vec.get(i);
         if (v == nullptr) { continue; }
@@ -531,6 +555,7 @@ Var * VarMgr::registerVar(Sym const* var_name, Type const* type, UINT align,
 Var * VarMgr::registerStringVar(CHAR const* var_name, Sym const* s, UINT align)
 {
     ASSERT0(s);
+    xcom::AutoWriteLock lock(&m_lock);
     Var * v;
     if ((v = m_str_tab.get(s)) != nullptr) {
         return v;
@@ -156,6 +156,9 @@ public:
 
     //Get the flag by given index in enum definition.
     static VAR_FLAG getFlag(UINT idx);
+
+    //Return true if each bit of 'flag' is described in the Desc table.
+    static bool isValidFlag(UINT flag);
 };
 
 //Link-related attributes of variable.
@@ -195,6 +198,9 @@ public:
 
     //Get link attribute's name.
     static CHAR const* getName(VAR_LINK_ATTR attr);
+
+    //Return true if each bit of 'attr' is described in the Desc table.
+    static bool isValidAttr(UINT attr);
 };
 
 
@@ -693,6 +699,11 @@ protected:
     DefSBitSetCore m_freelist_of_varid;
     RegionMgr * m_rm;
     TypeMgr * m_tm;
+
+    //The lock guards the variable tables when regions are processed
+    //concurrently. Lookups take the read lock, whereas registration and
+    //destruction take the write lock.
+    mutable xcom::RWLock m_lock;
 protected:
     //Assign an unique ID to given variable.
     void assignVarId(Var * v);
@@ -711,14 +722,25 @@ public:
     TypeMgr * getTypeMgr() const { return m_tm; }
     RegionMgr * getRegionMgr() const { return m_rm; }
 
+    //Return the lock that guards the variable tables.
+    xcom::RWLock * getLock() { return &m_lock; }
+
     //Returnt the vector that holds all variables registered.
     VarVec * getVarVec() { return &m_var_vec; }
 
     //Get variable via var-id.
-    Var * get_var(size_t id) const { return m_var_vec.get((UINT)id); }
+    Var * get_var(size_t id) const
+    {
+        xcom::AutoReadLock lock(&m_lock);
+        return m_var_vec.get((UINT)id);
+    }
 
     //Find string-variable via specific string content.
-    Var * findStringVar(Sym const* str) { return m_str_tab.get(str); }
+    Var * findStringVar(Sym const* str)
+    {
+        xcom::AutoReadLock lock(&m_lock);
+        return m_str_tab.get(str);
+    }
 
     //Find variable by variable's name.
     //Note there may be multiple variable with same name, this function return
@@ -0,0 +1,1571 @@
+/*@
+Copyright (c) 2013-2021, Su Zhenyu steven.known@gmail.com
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Su Zhenyu nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+@*/
+#include "../com/xcominc.h"
+#include "../opt/cominc.h"
+#include "../opt/comopt.h"
+#include "grbin.h"
+
+namespace xoc {
+
+//
+//START GRBinBuf
+//
+size_t GRBinBuf::alloc(size_t size)
+{
+    size_t ofst = m_size;
+    if (size > m_capacity - m_size) {
+        size_t cap = MAX(m_capacity * 2, m_size + size);
+        cap = MAX(cap, 256);
+        BYTE * buf = (BYTE*)::realloc(m_buf, cap);
+        ASSERT0(buf);
+        m_buf = buf;
+        m_capacity = cap;
+    }
+    ::memset(m_buf + m_size, 0, size);
+    m_size += size;
+    return ofst;
+}
+
+
+void GRBinBuf::align(size_t align)
+{
+    ASSERT0(align != 0);
+    size_t rem = m_size % align;
+    if (rem != 0) {
+        alloc(align - rem);
+    }
+}
+
+
+void GRBinBuf::destroy()
+{
+    if (m_buf != nullptr) {
+        ::free(m_buf);
+    }
+    m_buf = nullptr;
+    m_size = 0;
+    m_capacity = 0;
+}
+//END GRBinBuf
+
+
+//
+//START GRBinWriter
+//
+void GRBinWriter::addRegion(Region const* rg)
+{
+    ASSERT0(rg);
+    if (m_rg2idx.find(rg)) { return; }
+    m_rg2idx.set(rg, m_rg_list.get_elem_count());
+    m_rg_list.append(rg);
+}
+
+
+//Allocate 'n' consecutive entries in index pool, each entry is initialized
+//to GRBIN_UNDEF. Return the position of the first entry.
+UINT32 GRBinWriter::addIdx(UINT32 n)
+{
+    UINT32 pos = getRecNum(GRBIN_SECT_IDX, sizeof(UINT32));
+    m_sect[GRBIN_SECT_IDX].alloc(n * sizeof(UINT32));
+    for (UINT32 i = 0; i < n; i++) {
+        *getIdx(pos + i) = GRBIN_UNDEF;
+    }
+    return pos;
+}
+
+
+void GRBinWriter::collectIR(IR const* ir, MOD xcom::Vector<Var const*> & vars)
+{
+    ASSERT0(ir);
+    if (ir->hasIdinfo() && ir->getIdinfo() != nullptr) {
+        vars.set(ir->getIdinfo()->id(), ir->getIdinfo());
+    }
+    if (ir->is_region()) {
+        addRegion(REGION_ru(ir));
+    }
+    for (UINT i = 0; i < IR_MAX_KID_NUM(ir); i++) {
+        for (IR const* k = ir->getKid(i); k != nullptr; k = k->get_next()) {
+            collectIR(k, vars);
+        }
+    }
+    if (IRDES_accreslistfunc(ir->getCode()) != nullptr) {
+        for (IR const* r = ir->getResList(); r != nullptr; r = r->get_next()) {
+            collectIR(r, vars);
+        }
+    }
+}
+
+
+void GRBinWriter::collectRegion(Region const* rg,
+                                MOD xcom::Vector<Var const*> & vars)
+{
+    if (rg->getRegionVar() != nullptr) {
+        vars.set(rg->getRegionVar()->id(), rg->getRegionVar());
+    }
+    VarTab * vt = const_cast<Region*>(rg)->getVarTab();
+    VarTabIter c;
+    for (Var * v = vt->get_first(c); v != nullptr; v = vt->get_next(c)) {
+        vars.set(v->id(), v);
+    }
+    if (rg->is_blackbox()) { return; }
+    if (rg->getIRList() != nullptr) {
+        for (IR const* ir = rg->getIRList(); ir != nullptr;
+             ir = ir->get_next()) {
+            collectIR(ir, vars);
+        }
+        return;
+    }
+    BBList * bbl = rg->getBBList();
+    if (bbl == nullptr) { return; }
+    BBListIter bbct = nullptr;
+    for (bbl->get_head(&bbct); bbct != bbl->end();
+         bbct = bbl->get_next(bbct)) {
+        IRBB * bb = bbct->val();
+        IRListIter irct = nullptr;
+        for (BB_irlist(bb).get_head(&irct);
+             irct != BB_irlist(bb).end(); irct = BB_irlist(bb).get_next(irct)) {
+            collectIR(irct->val(), vars);
+        }
+    }
+}
+
+
+//Return the offset in data section.
+UINT32 GRBinWriter::writeData(BYTE const* buf, size_t size)
+{
+    m_sect[GRBIN_SECT_DATA].align(sizeof(UINT64));
+    size_t ofst = m_sect[GRBIN_SECT_DATA].alloc(size);
+    if (size != 0) {
+        ::memcpy(m_sect[GRBIN_SECT_DATA].getBuf() + ofst, buf, size);
+    }
+    return (UINT32)ofst;
+}
+
+
+//Return the offset in string table.
+UINT32 GRBinWriter::writeSym(Sym const* sym)
+{
+    if (sym == nullptr) { return GRBIN_UNDEF; }
+    bool find = false;
+    UINT32 ofst = m_sym2ofst.get(sym, &find);
+    if (find) { return ofst; }
+    size_t len = ::strlen(sym->getStr()) + 1;
+    ofst = (UINT32)m_sect[GRBIN_SECT_STR].alloc(len);
+    ::memcpy(m_sect[GRBIN_SECT_STR].getBuf() + ofst, sym->getStr(), len);
+    m_sym2ofst.set(sym, ofst);
+    return ofst;
+}
+
+
+//Return the index in type table.
+UINT32 GRBinWriter::writeType(Type const* ty)
+{
+    if (ty == nullptr) { return GRBIN_UNDEF; }
+    bool find = false;
+    UINT32 idx = m_type2idx.get(ty, &find);
+    if (find) { return idx; }
+    UINT32 size = 0;
+    UINT32 ety = D_UNDEF;
+    UINT32 dim = GRBIN_UNDEF;
+    UINT32 dim_num = 0;
+    switch (ty->getDType()) {
+    case D_PTR: size = TY_ptr_base_size(ty); break;
+    case D_MC: size = TY_mc_size(ty); break;
+    case D_VEC:
+        size = TY_vec_size(ty);
+        ety = TY_vec_ety(ty);
+        break;
+    case D_STREAM: ety = TY_stream_ety(ty); break;
+    case D_TENSOR: {
+        TensorType const* tt = (TensorType const*)ty;
+        ety = TY_tensor_ety(ty);
+        dim_num = tt->getDim();
+        dim = addIdx(dim_num);
+        for (UINT32 i = 0; i < dim_num; i++) {
+            *getIdx(dim + i) = tt->getDegreeOfDim(i);
+        }
+        break;
+    }
+    default: ASSERT0(ty->is_simplex());
+    }
+    idx = getRecNum(GRBIN_SECT_TYPE, sizeof(GRBinType));
+    m_sect[GRBIN_SECT_TYPE].alloc(sizeof(GRBinType));
+    GRBinType * rec = getRec<GRBinType>(GRBIN_SECT_TYPE, idx);
+    rec->dtype = ty->getDType();
+    rec->size = size;
+    rec->ety = ety;
+    rec->dim = dim;
+    rec->dim_num = dim_num;
+    m_type2idx.set(ty, idx);
+    return idx;
+}
+
+
+void GRBinWriter::writeVar(Var const* v)
+{
+    ASSERT0(v && !m_var2idx.find(v));
+    UINT32 name = writeSym(v->get_name());
+    UINT32 type = writeType(v->getType());
+    UINT32 str = GRBIN_UNDEF;
+    UINT32 byte_val = GRBIN_UNDEF;
+    UINT32 byte_size = 0;
+    if (v->is_string()) {
+        str = writeSym(VAR_string(v));
+    } else if (v->hasInitVal() && VAR_byte_val(v) != nullptr) {
+        byte_size = BYTEBUF_size(VAR_byte_val(v));
+        byte_val = writeData(BYTEBUF_buffer(VAR_byte_val(v)), byte_size);
+    }
+    VarFlag flag(v->getFlag());
+    VarLinkAttr link_attr(VAR_link_attr(v));
+    UINT32 idx = getRecNum(GRBIN_SECT_VAR, sizeof(GRBinVar));
+    m_sect[GRBIN_SECT_VAR].alloc(sizeof(GRBinVar));
+    GRBinVar * rec = getRec<GRBinVar>(GRBIN_SECT_VAR, idx);
+    rec->name = name;
+    rec->type = type;
+    rec->flag = flag.getFlagSet();
+    rec->link_attr = link_attr.getFlagSet();
+    rec->align = VAR_align(v);
+    rec->formal_param_pos = VAR_formal_param_pos(v);
+    rec->prno = VAR_prno(v);
+    rec->storage_space = VAR_storage_space(v);
+    rec->str = str;
+    rec->byte_val = byte_val;
+    rec->byte_size = byte_size;
+    m_var2idx.set(v, idx);
+}
+
+
+//Return the index of label relative to the first label of current region.
+UINT32 GRBinWriter::writeLabel(LabelInfo const* li)
+{
+    if (li == nullptr) { return GRBIN_UNDEF; }
+    bool find = false;
+    UINT32 idx = m_lab2idx.get(li, &find);
+    if (find) { return idx; }
+    UINT32 val = 0;
+    switch (li->getType()) {
+    case L_ILABEL: val = li->getNum(); break;
+    case L_CLABEL: val = writeSym(li->getOrgName()); break;
+    case L_PRAGMA: val = writeSym(li->getPragma()); break;
+    default: UNREACHABLE();
+    }
+    UINT32 abs = getRecNum(GRBIN_SECT_LABEL, sizeof(GRBinLabel));
+    m_sect[GRBIN_SECT_LABEL].alloc(sizeof(GRBinLabel));
+    GRBinLabel * rec = getRec<GRBinLabel>(GRBIN_SECT_LABEL, abs);
+    rec->ltype = li->getType();
+    rec->val = val;
+    rec->flag = LABELINFO_b1(li);
+    idx = abs - m_lab_base;
+    m_lab2idx.set(li, idx);
+    return idx;
+}
+
+
+//Return the position in index pool of exception handler labels.
+UINT32 GRBinWriter::writeEHLabel(IR const* ir, OUT UINT32 & num)
+{
+    num = 0;
+    if (ir->getAI() == nullptr) { return GRBIN_UNDEF; }
+    EHLabelAttachInfo const* ehlab =
+        (EHLabelAttachInfo const*)ir->getAI()->get(AI_EH_LABEL);
+    if (ehlab == nullptr) { return GRBIN_UNDEF; }
+    xcom::SList<LabelInfo*> const& labs = ehlab->read_labels();
+    num = labs.get_elem_count();
+    UINT32 pos = addIdx(num);
+    UINT32 i = 0;
+    for (xcom::SC<LabelInfo*> * sc = labs.get_head();
+         sc != labs.end(); sc = labs.get_next(sc), i++) {
+        UINT32 l = writeLabel(sc->val());
+        *getIdx(pos + i) = l;
+    }
+    return pos;
+}
+
+
+//Return the index of IR record.
+UINT32 GRBinWriter::writeIR(IR const* ir)
+{
+    ASSERT0(ir);
+    if (ir->is_phi()) {
+        m_err = "PHI is not supported, destruct SSA before writing";
+        return GRBIN_UNDEF;
+    }
+    UINT32 idx = getRecNum(GRBIN_SECT_IR, sizeof(GRBinIR));
+    m_sect[GRBIN_SECT_IR].alloc(sizeof(GRBinIR));
+    IR_CODE code = ir->getCode();
+    UINT16 prop = 0;
+    if (IR_may_throw(ir)) { SET_FLAG(prop, GRBIN_PROP_THROW); }
+    if (IR_is_terminate(ir)) { SET_FLAG(prop, GRBIN_PROP_TERMINATE); }
+    if (IR_is_atomic(ir)) { SET_FLAG(prop, GRBIN_PROP_ATOMIC); }
+    if (IR_is_read_mod_write(ir)) { SET_FLAG(prop, GRBIN_PROP_RMW); }
+    if (IR_has_sideeffect(ir)) { SET_FLAG(prop, GRBIN_PROP_SIDEEFFECT); }
+    if (IR_no_move(ir)) { SET_FLAG(prop, GRBIN_PROP_NOMOVE); }
+    UINT32 type = writeType(ir->getType());
+    UINT32 kid = IR_MAX_KID_NUM(ir) == 0 ?
+        GRBIN_UNDEF : addIdx(IR_MAX_KID_NUM(ir));
+    UINT32 eh_num = 0;
+    UINT32 eh = writeEHLabel(ir, eh_num);
+    UINT32 label = writeLabel(ir->getLabel());
+    UINT32 var = GRBIN_UNDEF;
+    if (ir->hasIdinfo() && ir->getIdinfo() != nullptr) {
+        var = m_var2idx.get(ir->getIdinfo());
+    }
+    UINT32 prno = PRNO_UNDEF;
+    if (IRDES_accprnofunc(code) != nullptr) {
+        prno = (*IRDES_accprnofunc(code))(const_cast<IR*>(ir));
+    }
+    UINT32 ss = 0;
+    if (IRDES_accssfunc(code) != nullptr) {
+        ss = ir->getStorageSpace();
+    }
+    UINT32 aux = GRBIN_UNDEF;
+    UINT32 aux2 = 0;
+    UINT32 dim = GRBIN_UNDEF;
+    UINT32 dim_num = 0;
+    UINT64 val = 0;
+    switch (code) {
+    case IR_ARRAY:
+    case IR_STARRAY:
+        aux = writeType(ARR_elemtype(ir));
+        aux2 = ARR_align(ir);
+        if (ARR_is_aligned(ir)) { SET_FLAG(prop, GRBIN_PROP_ALIGNED); }
+        if (ARR_elem_num_buf(ir) != nullptr) {
+            dim_num = xcom::cnt_list(ARR_sub_list(ir));
+            xcom::Vector<UINT64> buf;
+            for (UINT32 i = 0; i < dim_num; i++) {
+                buf.set(i, ARR_elem_num_buf(ir)[i]);
+            }
+            dim = writeData((BYTE const*)buf.get_vec(),
+                            dim_num * sizeof(UINT64));
+        }
+        break;
+    case IR_REGION:
+        aux = m_rg2idx.get(REGION_ru(ir));
+        break;
+    SWITCH_CASE_CALL:
+        aux = CALL_intrinsic_op(ir);
+        if (CALL_is_intrinsic(ir)) { SET_FLAG(aux2, GRBIN_CALL_INTRINSIC); }
+        if (CALL_is_alloc_heap(ir)) { SET_FLAG(aux2, GRBIN_CALL_ALLOC_HEAP); }
+        if (CALL_is_not_bb_bound(ir)) {
+            SET_FLAG(aux2, GRBIN_CALL_NOT_BB_BOUND);
+        }
+        if (ir->is_icall() && ICALL_is_readonly(ir)) {
+            SET_FLAG(aux2, GRBIN_CALL_READONLY);
+        }
+        break;
+    case IR_ALLOCA:
+        aux2 = ALLOCA_align(ir);
+        break;
+    case IR_CONST:
+        if (ir->is_tensor()) {
+            m_err = "tensor constant is not supported";
+            return GRBIN_UNDEF;
+        }
+        if (ir->is_str()) {
+            val = writeSym(CONST_str_val(ir));
+        } else if (ir->is_fp()) {
+            ::memcpy(&val, &CONST_fp_val(ir), sizeof(HOST_FP));
+            aux2 = CONST_fp_mant(ir);
+        } else {
+            val = (UINT64)CONST_int_val(ir);
+        }
+        break;
+    default:;
+    }
+    GRBinIR * rec = getRec<GRBinIR>(GRBIN_SECT_IR, idx);
+    rec->code = (UINT16)code;
+    rec->prop = prop;
+    rec->type = type;
+    rec->next = GRBIN_UNDEF;
+    rec->kid = kid;
+    rec->res = GRBIN_UNDEF;
+    rec->var = var;
+    rec->prno = prno;
+    rec->label = label;
+    rec->ss = ss;
+    rec->aux = aux;
+    rec->aux2 = aux2;
+    rec->eh = eh;
+    rec->eh_num = eh_num;
+    rec->dim = dim;
+    rec->dim_num = dim_num;
+    rec->ofst = ir->getOffset();
+    rec->val = val;
+    for (UINT i = 0; i < IR_MAX_KID_NUM(ir); i++) {
+        UINT32 k = writeIRList(ir->getKid(i));
+        *getIdx(kid + i) = k;
+    }
+    if (IRDES_accreslistfunc(code) != nullptr && ir->getResList() != nullptr) {
+        UINT32 res = writeIRList(ir->getResList());
+        getRec<GRBinIR>(GRBIN_SECT_IR, idx)->res = res;
+    }
+    return idx;
+}
+
+
+//Return the index of the first IR record.
+UINT32 GRBinWriter::writeIRList(IR const* irlist)
+{
+    UINT32 head = GRBIN_UNDEF;
+    UINT32 prev = GRBIN_UNDEF;
+    for (IR const* ir = irlist; ir != nullptr && m_err == nullptr;
+         ir = ir->get_next()) {
+        UINT32 idx = writeIR(ir);
+        if (prev == GRBIN_UNDEF) {
+            head = idx;
+        } else {
+            getRec<GRBinIR>(GRBIN_SECT_IR, prev)->next = idx;
+        }
+        prev = idx;
+    }
+    return head;
+}
+
+
+//Return the index of the first BB record.
+UINT32 GRBinWriter::writeBBList(Region const* rg, OUT UINT32 & bb_num)
+{
+    UINT32 first = getRecNum(GRBIN_SECT_BB, sizeof(GRBinBB));
+    bb_num = 0;
+    BBList * bbl = rg->getBBList();
+    if (bbl == nullptr) { return first; }
+    BBListIter bbct = nullptr;
+    for (bbl->get_head(&bbct); bbct != bbl->end() && m_err == nullptr;
+         bbct = bbl->get_next(bbct)) {
+        IRBB * bb = bbct->val();
+        UINT32 idx = first + bb_num;
+        m_sect[GRBIN_SECT_BB].alloc(sizeof(GRBinBB));
+        bb_num++;
+        LabelInfoList const& labs = bb->getLabelListConst();
+        UINT32 label_num = labs.get_elem_count();
+        UINT32 label = addIdx(label_num);
+        UINT32 i = 0;
+        xcom::C<LabelInfo const*> * labct;
+        for (labs.get_head(&labct); labct != labs.end();
+             labct = labs.get_next(labct), i++) {
+            UINT32 l = writeLabel(labct->val());
+            *getIdx(label + i) = l;
+        }
+        UINT32 head = GRBIN_UNDEF;
+        UINT32 prev = GRBIN_UNDEF;
+        IRListIter irct = nullptr;
+        for (BB_irlist(bb).get_head(&irct);
+             irct != BB_irlist(bb).end() && m_err == nullptr;
+             irct = BB_irlist(bb).get_next(irct)) {
+            UINT32 ir = writeIR(irct->val());
+            if (prev == GRBIN_UNDEF) {
+                head = ir;
+            } else {
+                getRec<GRBinIR>(GRBIN_SECT_IR, prev)->next = ir;
+            }
+            prev = ir;
+        }
+        GRBinBB * rec = getRec<GRBinBB>(GRBIN_SECT_BB, idx);
+        rec->label = label;
+        rec->label_num = label_num;
+        rec->ir = head;
+        rec->flag = bb->u1.u1b1;
+    }
+    return first;
+}
+
+
+void GRBinWriter::writeRegion(UINT32 idx)
+{
+    Region const* rg = m_rg_list.get(idx);
+    ASSERT0(rg);
+    if (rg->getRegionVar() == nullptr) {
+        m_err = "region does not have variable";
+        return;
+    }
+    m_lab2idx.clean();
+    m_lab_base = getRecNum(GRBIN_SECT_LABEL, sizeof(GRBinLabel));
+    UINT32 parent = GRBIN_UNDEF;
+    if (rg->getParent() != nullptr) {
+        bool find = false;
+        UINT32 p = m_rg2idx.get(rg->getParent(), &find);
+        if (find) { parent = p; }
+    }
+    UINT32 flag = 0;
+    if (REGION_is_readonly(rg)) { SET_FLAG(flag, GRBIN_RG_READONLY); }
+    if (REGION_is_expect_inline(rg)) {
+        SET_FLAG(flag, GRBIN_RG_EXPECT_INLINE);
+    }
+    if (REGION_is_inlinable(rg)) { SET_FLAG(flag, GRBIN_RG_INLINABLE); }
+
+    VarTab * vt = const_cast<Region*>(rg)->getVarTab();
+    UINT32 var_num = vt->get_elem_count();
+    UINT32 var_list = addIdx(var_num);
+    UINT32 i = 0;
+    VarTabIter c;
+    for (Var * v = vt->get_first(c); v != nullptr; v = vt->get_next(c), i++) {
+        *getIdx(var_list + i) = m_var2idx.get(v);
+    }
+
+    UINT32 pr_count = 0;
+    UINT32 ir = GRBIN_UNDEF;
+    UINT32 bb = GRBIN_UNDEF;
+    UINT32 bb_num = 0;
+    if (!rg->is_blackbox()) {
+        pr_count = rg->getPRCount();
+        if (rg->getIRList() != nullptr) {
+            ir = writeIRList(rg->getIRList());
+        } else {
+            SET_FLAG(flag, GRBIN_RG_HAS_BB_LIST);
+            bb = writeBBList(rg, bb_num);
+        }
+    }
+    GRBinRegion * rec = getRec<GRBinRegion>(GRBIN_SECT_REGION, idx);
+    rec->type = rg->getRegionType();
+    rec->var = m_var2idx.get(rg->getRegionVar());
+    rec->parent = parent;
+    rec->flag = flag;
+    rec->pr_count = pr_count;
+    rec->var_list = var_list;
+    rec->var_num = var_num;
+    rec->label = m_lab_base;
+    rec->label_num = getRecNum(GRBIN_SECT_LABEL, sizeof(GRBinLabel)) -
+                     m_lab_base;
+    rec->ir = ir;
+    rec->bb = bb;
+    rec->bb_num = bb_num;
+}
+
+
+bool GRBinWriter::writeFile(CHAR const* filename)
+{
+    GRBinHdr hdr;
+    ::memset(&hdr, 0, sizeof(GRBinHdr));
+    ::memcpy(hdr.magic, GRBIN_MAGIC, GRBIN_MAGIC_LEN);
+    hdr.version = GRBIN_VERSION;
+    hdr.host_int_size = sizeof(HOST_INT);
+    hdr.host_fp_size = sizeof(HOST_FP);
+    UINT64 ofst = sizeof(GRBinHdr);
+    for (UINT s = 0; s < GRBIN_SECT_NUM; s++) {
+        //Record index and offset are 32bit.
+        if (m_sect[s].getSize() >= (size_t)GRBIN_UNDEF) {
+            m_err = "region is too large";
+            return false;
+        }
+        hdr.sect[s].ofst = ofst;
+        hdr.sect[s].size = m_sect[s].getSize();
+        m_sect[s].align(sizeof(UINT64));
+        ofst += m_sect[s].getSize();
+    }
+
+    //FileObj does not permit writing beyond the end of file, thus each
+    //section is padded and written in order.
+    FO_STATUS st;
+    xcom::FileObj fo(filename, true, false, &st);
+    if (st != xcom::FO_SUCC) {
+        m_err = "can not create file";
+        return false;
+    }
+    size_t wr = 0;
+    if (fo.write((BYTE const*)&hdr, 0, sizeof(GRBinHdr), &wr) !=
+        xcom::FO_SUCC || wr != sizeof(GRBinHdr)) {
+        m_err = "write file failed";
+        return false;
+    }
+    for (UINT s = 0; s < GRBIN_SECT_NUM; s++) {
+        size_t size = m_sect[s].getSize();
+        if (size == 0) { continue; }
+        if (fo.write(m_sect[s].getBuf(), (size_t)hdr.sect[s].ofst, size,
+                     &wr) != xcom::FO_SUCC || wr != size) {
+            m_err = "write file failed";
+            return false;
+        }
+    }
+    return true;
+}
+
+
+bool GRBinWriter::write(Region const* rg, CHAR const* filename)
+{
+    ASSERT0(rg && filename);
+    if (sizeof(HOST_FP) > sizeof(UINT64)) {
+        m_err = "float point of host is too large";
+        return false;
+    }
+    //Collect regions in breadth-first order, the list grows during the
+    //iteration.
+    xcom::Vector<Var const*> vars;
+    addRegion(rg);
+    for (UINT i = 0; i < m_rg_list.get_elem_count(); i++) {
+        collectRegion(m_rg_list.get(i), vars);
+    }
+
+    //Write variables in the order of id to keep the relative order of
+    //variables identical after reading.
+    for (VecIdx i = 0; i <= vars.get_last_idx(); i++) {
+        Var const* v = vars.get(i);
+        if (v != nullptr) { writeVar(v); }
+    }
+    m_sect[GRBIN_SECT_REGION].alloc(
+        sizeof(GRBinRegion) * m_rg_list.get_elem_count());
+    for (UINT i = 0; i < m_rg_list.get_elem_count() && m_err == nullptr;
+         i++) {
+        writeRegion(i);
+    }
+    if (m_err != nullptr) { return false; }
+    return writeFile(filename);
+}
+//END GRBinWriter
+
+
+//
+//START GRBinReader
+//
+GRBinReader::GRBinReader(RegionMgr * rm)
+{
+    ASSERT0(rm);
+    m_rm = rm;
+    m_err = nullptr;
+    m_file = nullptr;
+    m_buf = nullptr;
+    m_content = nullptr;
+    m_size = 0;
+    m_hdr = nullptr;
+    m_str = nullptr;
+    m_data = nullptr;
+    m_idx = nullptr;
+    m_type = nullptr;
+    m_var = nullptr;
+    m_region = nullptr;
+    m_label = nullptr;
+    m_bb = nullptr;
+    m_ir = nullptr;
+    ::memset(m_num, 0, sizeof(m_num));
+    m_ir_count = 0;
+}
+
+
+void GRBinReader::destroy()
+{
+    if (m_file != nullptr) {
+        //Release the file mapping as well.
+        delete m_file;
+        m_file = nullptr;
+    }
+    if (m_buf != nullptr) {
+        ::free(m_buf);
+        m_buf = nullptr;
+    }
+    m_content = nullptr;
+    m_size = 0;
+    m_hdr = nullptr;
+    ::memset(m_num, 0, sizeof(m_num));
+    m_ir_count = 0;
+    m_types.clean();
+    m_vars.clean();
+    m_regions.clean();
+    m_labels.clean();
+}
+
+
+bool GRBinReader::isValidData(UINT32 ofst, UINT64 size) const
+{
+    UINT64 total = m_hdr->sect[GRBIN_SECT_DATA].size;
+    return ofst <= total && size <= total - ofst;
+}
+
+
+Sym const* GRBinReader::getSym(UINT32 ofst)
+{
+    if (ofst == GRBIN_UNDEF || !isValidStr(ofst)) { return nullptr; }
+    return m_rm->addToSymbolTab(m_str + ofst);
+}
+
+
+//Verify the header and sections, and set the start address of each
+//section. Return false if the content is malformed.
+bool GRBinReader::setContent(BYTE const* buf, size_t size)
+{
+    static UINT const recsz[GRBIN_SECT_NUM] = {
+        sizeof(CHAR), //GRBIN_SECT_STR
+        sizeof(BYTE), //GRBIN_SECT_DATA
+        sizeof(UINT32), //GRBIN_SECT_IDX
+        sizeof(GRBinType), //GRBIN_SECT_TYPE
+        sizeof(GRBinVar), //GRBIN_SECT_VAR
+        sizeof(GRBinRegion), //GRBIN_SECT_REGION
+        sizeof(GRBinLabel), //GRBIN_SECT_LABEL
+        sizeof(GRBinBB), //GRBIN_SECT_BB
+        sizeof(GRBinIR), //GRBIN_SECT_IR
+    };
+    if (size < sizeof(GRBinHdr)) { return error("file is too small"); }
+    GRBinHdr const* hdr = (GRBinHdr const*)buf;
+    if (::memcmp(hdr->magic, GRBIN_MAGIC, GRBIN_MAGIC_LEN) != 0) {
+        return error("not a binary GR file");
+    }
+    if (hdr->version != GRBIN_VERSION) {
+        return error("unsupported version");
+    }
+    if (hdr->host_int_size != sizeof(HOST_INT) ||
+        hdr->host_fp_size != sizeof(HOST_FP)) {
+        return error("file is written by incompatible host");
+    }
+    for (UINT s = 0; s < GRBIN_SECT_NUM; s++) {
+        GRBinSect const& sect = hdr->sect[s];
+        if (sect.ofst % sizeof(UINT64) != 0 || sect.ofst > size ||
+            sect.size > size - sect.ofst || sect.size % recsz[s] != 0 ||
+            sect.size / recsz[s] >= GRBIN_UNDEF) {
+            return error("malformed section");
+        }
+        m_num[s] = (UINT32)(sect.size / recsz[s]);
+    }
+    if (m_num[GRBIN_SECT_REGION] == 0) { return error("there is no region"); }
+    m_content = buf;
+    m_size = size;
+    m_hdr = hdr;
+    m_str = (CHAR const*)(buf + hdr->sect[GRBIN_SECT_STR].ofst);
+    m_data = buf + hdr->sect[GRBIN_SECT_DATA].ofst;
+    m_idx = (UINT32 const*)(buf + hdr->sect[GRBIN_SECT_IDX].ofst);
+    m_type = (GRBinType const*)(buf + hdr->sect[GRBIN_SECT_TYPE].ofst);
+    m_var = (GRBinVar const*)(buf + hdr->sect[GRBIN_SECT_VAR].ofst);
+    m_region = (GRBinRegion const*)(buf + hdr->sect[GRBIN_SECT_REGION].ofst);
+    m_label = (GRBinLabel const*)(buf + hdr->sect[GRBIN_SECT_LABEL].ofst);
+    m_bb = (GRBinBB const*)(buf + hdr->sect[GRBIN_SECT_BB].ofst);
+    m_ir = (GRBinIR const*)(buf + hdr->sect[GRBIN_SECT_IR].ofst);
+    if (m_num[GRBIN_SECT_STR] != 0 && m_str[m_num[GRBIN_SECT_STR] - 1] != 0) {
+        return error("string table is not terminated");
+    }
+    return true;
+}
+
+
+static bool isValidElemDType(UINT32 dt)
+{
+    return IS_INT(dt) || IS_FP(dt) || IS_BOOL(dt);
+}
+
+
+bool GRBinReader::verifyTypeRec(GRBinType const& rec)
+{
+    TypeMgr * tm = m_rm->getTypeMgr();
+    switch (rec.dtype) {
+    case D_PTR: return true;
+    case D_MC:
+        if (rec.size == 0) { return error("invalid size of memory chunk"); }
+        return true;
+    case D_VEC: {
+        if (!isValidElemDType(rec.ety)) {
+            return error("invalid element type of vector");
+        }
+        UINT elemsz = tm->getDTypeByteSize((DATA_TYPE)rec.ety);
+        if (elemsz == 0 || rec.size == 0 || rec.size % elemsz != 0) {
+            return error("invalid size of vector");
+        }
+        return true;
+    }
+    case D_STREAM:
+        if (!isValidElemDType(rec.ety)) {
+            return error("invalid element type of stream");
+        }
+        return true;
+    case D_TENSOR:
+        if (!isValidElemDType(rec.ety)) {
+            return error("invalid element type of tensor");
+        }
+        if (rec.dim_num == 0 ||
+            rec.dim_num > TensorType::g_default_max_tensor_dim ||
+            !isValidIdxList(rec.dim, rec.dim_num)) {
+            return error("invalid dimension of tensor");
+        }
+        return true;
+    default:
+        if (rec.dtype >= D_LAST || !IS_SIMPLEX(rec.dtype)) {
+            return error("invalid data type");
+        }
+    }
+    return true;
+}
+
+
+bool GRBinReader::verifyVarRec(GRBinVar const& rec)
+{
+    if (rec.name == GRBIN_UNDEF || !isValidStr(rec.name)) {
+        return error("invalid variable name");
+    }
+    if (rec.type >= m_num[GRBIN_SECT_TYPE]) {
+        return error("invalid variable type");
+    }
+    if (!VarFlagDesc::isValidFlag(rec.flag)) {
+        return error("invalid variable flag");
+    }
+    if (!VarLinkAttrDesc::isValidAttr(rec.link_attr)) {
+        return error("invalid link attribute of variable");
+    }
+    //Only the PR variable is mapped to PR.
+    if (HAVE_FLAG(rec.flag, VAR_IS_PR) != (rec.prno != PRNO_UNDEF)) {
+        return error("invalid PR number of variable");
+    }
+    if (HAVE_FLAG(rec.flag, VAR_IS_FORMAL_PARAM) &&
+        HAVE_FLAG(rec.flag, VAR_IS_PR)) {
+        return error("invalid formal parameter");
+    }
+    if (rec.storage_space > SS_ANY) {
+        return error("invalid storage space of variable");
+    }
+    if (rec.str != GRBIN_UNDEF) {
+        if (!isValidStr(rec.str) || m_type[rec.type].dtype != D_STR) {
+            return error("invalid string variable");
+        }
+    } else if (rec.byte_val != GRBIN_UNDEF &&
+               !isValidData(rec.byte_val, rec.byte_size)) {
+        return error("invalid initial value of variable");
+    } else if (HAVE_FLAG(rec.flag, VAR_HAS_INIT_VAL) &&
+               (rec.byte_val == GRBIN_UNDEF ||
+                m_type[rec.type].dtype == D_STR)) {
+        //The initial value of string variable is recorded in 'str'.
+        return error("invalid initial value of variable");
+    }
+    return true;
+}
+
+
+bool GRBinReader::verifyRegionRec(UINT32 idx)
+{
+    GRBinRegion const& rec = m_region[idx];
+    switch (rec.type) {
+    case REGION_PROGRAM:
+        //Program region can only be the root.
+        if (idx != 0) { return error("invalid program region"); }
+        if (m_rm->getProgramRegion() != nullptr) {
+            return error("duplicated program region");
+        }
+        break;
+    case REGION_FUNC:
+    case REGION_INNER:
+    case REGION_BLACKBOX: break;
+    default: return error("invalid region type");
+    }
+    if (rec.var >= m_num[GRBIN_SECT_VAR]) {
+        return error("invalid region variable");
+    }
+    //Parent is always ahead of inner region.
+    if (rec.parent != GRBIN_UNDEF && rec.parent >= idx) {
+        return error("invalid parent region");
+    }
+    if (!isValidIdxList(rec.var_list, rec.var_num)) {
+        return error("invalid variable table of region");
+    }
+    for (UINT32 i = 0; i < rec.var_num; i++) {
+        UINT32 vi = m_idx[rec.var_list + i];
+        if (vi >= m_num[GRBIN_SECT_VAR]) {
+            return error("invalid variable table of region");
+        }
+        //PR variable is mapped by the PR number allocated in region.
+        GRBinVar const& vr = m_var[vi];
+        if (vr.prno != PRNO_UNDEF && vr.prno >= rec.pr_count) {
+            return error("invalid PR number of variable");
+        }
+        //Formal parameters are declared in the variable table of region.
+        if (HAVE_FLAG(vr.flag, VAR_IS_FORMAL_PARAM) &&
+            vr.formal_param_pos >= rec.var_num) {
+            return error("invalid formal parameter");
+        }
+    }
+    return true;
+}
+
+
+bool GRBinReader::verifyIRRec(GRBinIR const& rec)
+{
+    if (rec.code <= IR_UNDEF || rec.code >= IR_CODE_NUM ||
+        rec.code == IR_PHI || IRDES_code(rec.code) != rec.code) {
+        return error("invalid IR code");
+    }
+    switch (rec.code) {
+    SWITCH_CASE_EXT_PLACEHOLDER: return error("invalid IR code");
+    default:;
+    }
+    IR_CODE code = (IR_CODE)rec.code;
+
+    //Each IR has data type, even if it is statement.
+    if (rec.type >= m_num[GRBIN_SECT_TYPE]) {
+        return error("invalid IR type");
+    }
+    GRBinType const& ty = m_type[rec.type];
+    if (code == IR_LDA && ty.dtype != D_PTR) {
+        return error("invalid IR type");
+    }
+    //The result of judgement is boolean or vector of boolean.
+    if ((IR::is_judge(code) || code == IR_LNOT) &&
+        (ty.dtype == D_VEC ? ty.ety : ty.dtype) != D_B) {
+        return error("invalid IR type");
+    }
+    if (IRDES_has_idinfo(code) != (rec.var != GRBIN_UNDEF) ||
+        (rec.var != GRBIN_UNDEF && rec.var >= m_num[GRBIN_SECT_VAR])) {
+        return error("invalid IR variable");
+    }
+    //PR variable can not be accessed as memory.
+    if ((code == IR_LD || code == IR_ST) && m_var[rec.var].prno != PRNO_UNDEF) {
+        return error("invalid IR variable");
+    }
+    if (IRDES_acclabfunc(code) == nullptr && rec.label != GRBIN_UNDEF) {
+        return error("invalid IR label");
+    }
+    //Only the result of CALL may be absent.
+    if (IRDES_accprnofunc(code) == nullptr ?
+        rec.prno != PRNO_UNDEF :
+        (rec.prno == PRNO_UNDEF && code != IR_CALL && code != IR_ICALL)) {
+        return error("invalid PR number of IR");
+    }
+    if (IRDES_accssfunc(code) != nullptr && rec.ss > SS_ANY) {
+        return error("invalid storage space of IR");
+    }
+    if (IRDES_kid_num(code) != 0 &&
+        !isValidIdxList(rec.kid, IRDES_kid_num(code))) {
+        return error("invalid IR kid");
+    }
+    if (rec.res != GRBIN_UNDEF && IRDES_accreslistfunc(code) == nullptr) {
+        return error("invalid IR result list");
+    }
+    if (rec.next != GRBIN_UNDEF && rec.next >= m_num[GRBIN_SECT_IR]) {
+        return error("invalid IR");
+    }
+    return true;
+}
+
+
+bool GRBinReader::verifyRecord()
+{
+    for (UINT32 i = 0; i < m_num[GRBIN_SECT_TYPE]; i++) {
+        if (!verifyTypeRec(m_type[i])) { return false; }
+    }
+    for (UINT32 i = 0; i < m_num[GRBIN_SECT_VAR]; i++) {
+        if (!verifyVarRec(m_var[i])) { return false; }
+    }
+    for (UINT32 i = 0; i < m_num[GRBIN_SECT_REGION]; i++) {
+        if (!verifyRegionRec(i)) { return false; }
+    }
+    for (UINT32 i = 0; i < m_num[GRBIN_SECT_IR]; i++) {
+        if (!verifyIRRec(m_ir[i])) { return false; }
+    }
+    return true;
+}
+
+
+//Return true if the kid at 'idx' of 'code' is statement list, e.g: the body
+//of IF, SWITCH and loop.
+static bool isStmtKid(IR_CODE code, UINT idx)
+{
+    switch (code) {
+    case IR_IF: return idx == 1 || idx == 2;
+    case IR_DO_WHILE:
+    case IR_WHILE_DO:
+    case IR_DO_LOOP:
+    case IR_SWITCH: return idx == 1;
+    default:;
+    }
+    return false;
+}
+
+
+//Return true if the kid at 'idx' of 'code' may be a list, e.g: the argument
+//list of CALL and the subscript list of ARRAY.
+static bool isListKid(IR_CODE code, UINT idx)
+{
+    if (isStmtKid(code, idx)) { return true; }
+    switch (code) {
+    case IR_CALL:
+    case IR_ICALL: return idx == 0 || idx == 1;
+    case IR_ARRAY:
+    case IR_STARRAY:
+    case IR_IGOTO: return idx == 1;
+    case IR_SWITCH: return idx == 2;
+    default:;
+    }
+    return false;
+}
+
+
+//Return true if 'ir' is the pointer that can be dereferenced.
+static bool isDerefPtr(IR const* ir, TypeMgr const* tm)
+{
+    return ir->is_any() ||
+           (ir->is_ptr() && tm->getPointerBaseByteSize(ir->getType()) > 0);
+}
+
+
+//Return true if 'memory' is the memory that atomic operation accesses, and
+//the result list 'res' is the same memory.
+static bool isValidAtomMem(IR const* memory, IR const* res)
+{
+    if (res != nullptr && (!res->is_single() ||
+                           res->getCode() != memory->getCode())) {
+        return false;
+    }
+    if (memory->is_ld()) {
+        Var const* v = LD_idinfo(memory);
+        return v->getStorageSpace() == SS_GLOBAL &&
+               (res == nullptr || LD_idinfo(res) == v);
+    }
+    if (memory->is_ild()) {
+        IR const* base = ILD_base(memory);
+        return base->is_pr() &&
+               (res == nullptr || (ILD_base(res)->is_pr() &&
+                                   ILD_base(res)->getPrno() ==
+                                   base->getPrno()));
+    }
+    return memory->is_pr() &&
+           (res == nullptr || res->getPrno() == memory->getPrno());
+}
+
+
+//Return true if the atomic operation 'ir' is well-formed, the constraints
+//come from the verifier of atomic operations.
+static bool isValidAtomOp(IR const* ir)
+{
+    if (ir->is_atominc()) {
+        return ir->getType()->is_i64() &&
+               isValidAtomMem(ATOMINC_memory(ir), ATOMINC_multires(ir));
+    }
+    ASSERT0(ir->is_atomcas());
+    IR const* oldval = ATOMCAS_oldval(ir);
+    IR const* newval = ATOMCAS_newval(ir);
+    return (ir->getType()->is_i32() || ir->getType()->is_i64()) &&
+           (oldval->is_pr() || oldval->is_const()) &&
+           (newval->is_pr() || newval->is_const()) &&
+           isValidAtomMem(ATOMCAS_memory(ir), ATOMCAS_multires(ir));
+}
+
+
+//Verify the kid at 'idx' of 'ir' before it is set, the constraints come
+//from the verifier of each IR code.
+bool GRBinReader::verifyKid(IR const* ir, UINT idx, IR const* kid)
+{
+    IR_CODE code = ir->getCode();
+    if (kid == nullptr) {
+        if (IRDesc::mustExist(code, idx)) { return error("IR kid is missing"); }
+        return true;
+    }
+    if (!kid->is_single() && !isListKid(code, idx)) {
+        return error("invalid IR kid");
+    }
+    TypeMgr const* tm = m_rm->getTypeMgr();
+    bool valid = true;
+    switch (code) {
+    case IR_IF:
+    case IR_DO_WHILE:
+    case IR_WHILE_DO:
+    case IR_DO_LOOP:
+    case IR_TRUEBR:
+    case IR_FALSEBR: valid = idx != 0 || kid->is_judge(); break;
+    case IR_SELECT: valid = idx != 0 || kid->is_bool(); break;
+    case IR_CASE: valid = idx != 0 || kid->is_const(); break;
+    case IR_ILD:
+    case IR_IST: valid = idx != 0 || isDerefPtr(kid, tm); break;
+    case IR_ARRAY:
+    case IR_STARRAY: valid = idx != 0 || kid->isPtr(); break;
+    case IR_ICALL: valid = idx != 2 || kid->isPtr(); break;
+    case IR_ASR:
+    case IR_LSR:
+    case IR_LSL: valid = idx != 1 || kid->is_int(); break;
+    default:;
+    }
+    if (!valid) { return error("invalid type of IR kid"); }
+    return true;
+}
+
+
+//The records have been verified by verifyTypeRec().
+bool GRBinReader::constructType()
+{
+    TypeMgr * tm = m_rm->getTypeMgr();
+    for (UINT32 i = 0; i < m_num[GRBIN_SECT_TYPE]; i++) {
+        GRBinType const& rec = m_type[i];
+        Type const* ty = nullptr;
+        switch (rec.dtype) {
+        case D_PTR: ty = tm->getPointerType(rec.size); break;
+        case D_MC: ty = tm->getMCType(rec.size); break;
+        case D_VEC: {
+            UINT elemsz = tm->getDTypeByteSize((DATA_TYPE)rec.ety);
+            ty = tm->getVectorType(rec.size / elemsz, (DATA_TYPE)rec.ety);
+            break;
+        }
+        case D_STREAM:
+            ty = tm->getStreamType((DATA_TYPE)rec.ety);
+            break;
+        case D_TENSOR: {
+            TensorType d;
+            TY_dtype(&d) = D_TENSOR;
+            TY_tensor_ety(&d) = (DATA_TYPE)rec.ety;
+            for (UINT32 j = 0; j < rec.dim_num; j++) {
+                d.setDegreeOfDim(j, m_idx[rec.dim + j], tm);
+            }
+            ty = TC_type(tm->registerTensor(&d));
+            break;
+        }
+        default:
+            ty = tm->getSimplexTypeEx((DATA_TYPE)rec.dtype);
+        }
+        ASSERT0(ty);
+        m_types.set(i, ty);
+    }
+    return true;
+}
+
+
+bool GRBinReader::constructVar()
+{
+    VarMgr * vm = m_rm->getVarMgr();
+    for (UINT32 i = 0; i < m_num[GRBIN_SECT_VAR]; i++) {
+        GRBinVar const& rec = m_var[i];
+        Sym const* name = getSym(rec.name);
+        ASSERT0(name);
+        if (vm->isDedicatedStringVar(name->getStr())) {
+            //Keep the dedicated string variable unique.
+            m_rm->setRegardAllStringAsSameMD(true);
+            MD const* md = m_rm->genDedicateStrMD();
+            ASSERT0(md);
+            m_vars.set(i, md->get_base());
+            continue;
+        }
+        Var * v = vm->registerVar(name, m_types.get(rec.type), rec.align,
+                                  VarFlag(rec.flag));
+        VAR_link_attr(v) = VarLinkAttr(rec.link_attr);
+        VAR_formal_param_pos(v) = rec.formal_param_pos;
+        VAR_prno(v) = rec.prno;
+        VAR_storage_space(v) = (StorageSpace)rec.storage_space;
+        if (rec.str != GRBIN_UNDEF) {
+            ASSERT0(v->is_string());
+            VAR_string(v) = getSym(rec.str);
+        }
+        m_vars.set(i, v);
+    }
+    return true;
+}
+
+
+//The initial value is allocated in the region that declares the variable.
+bool GRBinReader::constructVarInitVal(Var * v, GRBinVar const& rec,
+                                      Region * rg)
+{
+    if (rec.str != GRBIN_UNDEF || rec.byte_val == GRBIN_UNDEF ||
+        VAR_byte_val(v) != nullptr) {
+        return true;
+    }
+    ByteBuf * buf = rg->allocByteBuf(rec.byte_size);
+    if (rec.byte_size != 0) {
+        ::memcpy(BYTEBUF_buffer(buf), m_data + rec.byte_val, rec.byte_size);
+    }
+    VAR_byte_val(v) = buf;
+    return true;
+}
+
+
+bool GRBinReader::constructRegion(UINT32 idx)
+{
+    GRBinRegion const& rec = m_region[idx];
+    Region * parent = nullptr;
+    if (rec.parent != GRBIN_UNDEF) {
+        parent = m_regions.get(rec.parent);
+    }
+    Region * rg = m_rm->newRegion((REGION_TYPE)rec.type);
+    if (!rg->is_blackbox()) {
+        rg->initPassMgr();
+        rg->initDbxMgr();
+        rg->initIRMgr();
+        rg->initIRBBMgr();
+        rg->initAttachInfoMgr();
+    }
+    m_rm->addToRegionTab(rg);
+    m_regions.set(idx, rg);
+    rg->setRegionVar(m_vars.get(rec.var));
+    REGION_parent(rg) = parent;
+    if (rg->is_program()) {
+        ASSERT0(m_rm->getProgramRegion() == nullptr);
+        m_rm->setProgramRegion(rg);
+    }
+    REGION_is_readonly(rg) = HAVE_FLAG(rec.flag, GRBIN_RG_READONLY);
+    REGION_is_expect_inline(rg) = HAVE_FLAG(rec.flag, GRBIN_RG_EXPECT_INLINE);
+    REGION_is_inlinable(rg) = HAVE_FLAG(rec.flag, GRBIN_RG_INLINABLE);
+    for (UINT32 i = 0; i < rec.var_num; i++) {
+        UINT32 vi = m_idx[rec.var_list + i];
+        Var * v = m_vars.get(vi);
+        rg->addToVarTab(v);
+        if (!rg->is_blackbox() && v->is_pr()) {
+            rg->setMapPRNO2Var(VAR_prno(v), v);
+        }
+        if (!constructVarInitVal(v, m_var[vi], rg)) { return false; }
+    }
+    if (!rg->is_blackbox()) {
+        rg->setPRCount(rec.pr_count);
+    }
+    return true;
+}
+
+
+bool GRBinReader::constructLabel(Region * rg, GRBinRegion const& rec)
+{
+    m_labels.clean();
+    if (rec.label > m_num[GRBIN_SECT_LABEL] ||
+        rec.label_num > m_num[GRBIN_SECT_LABEL] - rec.label) {
+        return error("invalid label table of region");
+    }
+    for (UINT32 i = 0; i < rec.label_num; i++) {
+        GRBinLabel const& lr = m_label[rec.label + i];
+        LabelInfo * li = nullptr;
+        switch (lr.ltype) {
+        case L_ILABEL:
+            if (lr.val == GRBIN_UNDEF) { return error("invalid label"); }
+            m_rm->reserveLabel(lr.val);
+            li = rg->genILabel(lr.val);
+            break;
+        case L_CLABEL:
+        case L_PRAGMA: {
+            Sym const* sym = getSym(lr.val);
+            if (sym == nullptr) { return error("invalid label"); }
+            li = lr.ltype == L_CLABEL ?
+                rg->genCustomLabel(sym) : rg->genPragmaLabel(sym);
+            break;
+        }
+        default: return error("invalid label");
+        }
+        LABELINFO_b1(li) = (BYTE)lr.flag;
+        m_labels.set(i, li);
+    }
+    return true;
+}
+
+
+bool GRBinReader::readEHLabel(Region * rg, GRBinIR const& rec, IR * ir)
+{
+    if (rec.eh_num == 0) { return true; }
+    if (!isValidIdxList(rec.eh, rec.eh_num)) {
+        return error("invalid exception label");
+    }
+    AIContainer * ai = IR_ai(ir);
+    if (ai == nullptr) {
+        ai = rg->allocAIContainer();
+        IR_ai(ir) = ai;
+    }
+    EHLabelAttachInfo * ehai = (EHLabelAttachInfo*)ai->get(AI_EH_LABEL);
+    if (ehai == nullptr) {
+        ehai = (EHLabelAttachInfo*)rg->xmalloc(sizeof(EHLabelAttachInfo));
+        ehai->init(rg->getSCPool());
+        ai->set(ehai, rg);
+    }
+    for (UINT32 i = rec.eh_num; i > 0; i--) {
+        LabelInfo * li = m_labels.get(m_idx[rec.eh + i - 1]);
+        if (li == nullptr) { return error("invalid exception label"); }
+        ehai->get_labels().append_head(li);
+    }
+    return true;
+}
+
+
+bool GRBinReader::readCodeField(Region * rg, GRBinIR const& rec, IR * ir)
+{
+    switch (ir->getCode()) {
+    case IR_ARRAY:
+    case IR_STARRAY: {
+        if (rec.aux >= m_num[GRBIN_SECT_TYPE]) {
+            return error("invalid element type of array");
+        }
+        ARR_elemtype(ir) = m_types.get(rec.aux);
+        ARR_align(ir) = rec.aux2;
+        ARR_is_aligned(ir) = HAVE_FLAG(rec.prop, GRBIN_PROP_ALIGNED);
+        if (rec.dim_num == 0) { break; }
+        if (rec.dim_num != xcom::cnt_list(ARR_sub_list(ir)) ||
+            rec.dim % sizeof(UINT64) != 0 ||
+            !isValidData(rec.dim, (UINT64)rec.dim_num * sizeof(UINT64))) {
+            return error("invalid dimension of array");
+        }
+        UINT64 const* dim = (UINT64 const*)(m_data + rec.dim);
+        TMWORD * buf = (TMWORD*)rg->xmalloc(sizeof(TMWORD) * rec.dim_num);
+        for (UINT32 i = 0; i < rec.dim_num; i++) {
+            buf[i] = (TMWORD)dim[i];
+        }
+        ARR_elem_num_buf(ir) = buf;
+        break;
+    }
+    case IR_REGION: {
+        if (rec.aux >= m_num[GRBIN_SECT_REGION]) {
+            return error("invalid inner region");
+        }
+        Region * inner = m_regions.get(rec.aux);
+        ASSERT0(inner);
+        if (inner == rg || inner->is_program()) {
+            return error("invalid inner region");
+        }
+        REGION_ru(ir) = inner;
+        REGION_parent(inner) = rg;
+        break;
+    }
+    SWITCH_CASE_CALL:
+        CALL_is_intrinsic(ir) = HAVE_FLAG(rec.aux2, GRBIN_CALL_INTRINSIC);
+        CALL_intrinsic_op(ir) = rec.aux;
+        CALL_is_alloc_heap(ir) = HAVE_FLAG(rec.aux2, GRBIN_CALL_ALLOC_HEAP);
+        CALL_is_not_bb_bound(ir) = HAVE_FLAG(rec.aux2,
+                                             GRBIN_CALL_NOT_BB_BOUND);
+        if (ir->is_icall()) {
+            ICALL_is_readonly(ir) = HAVE_FLAG(rec.aux2, GRBIN_CALL_READONLY);
+        }
+        break;
+    case IR_ALLOCA:
+        ALLOCA_align(ir) = rec.aux2;
+        break;
+    case IR_CONST:
+        if (ir->getType() == nullptr || ir->is_tensor()) {
+            return error("invalid constant");
+        }
+        if (ir->is_str()) {
+            Sym const* sym = rec.val < GRBIN_UNDEF ?
+                getSym((UINT32)rec.val) : nullptr;
+            if (sym == nullptr) { return error("invalid string constant"); }
+            CONST_str_val(ir) = sym;
+        } else if (ir->is_fp()) {
+            ::memcpy(&CONST_fp_val(ir), &rec.val, sizeof(HOST_FP));
+            CONST_fp_mant(ir) = (BYTE)rec.aux2;
+        } else {
+            CONST_int_val(ir) = (HOST_INT)rec.val;
+        }
+        break;
+    default:;
+    }
+    return true;
+}
+
+
+IR * GRBinReader::readIR(Region * rg, UINT32 idx)
+{
+    if (idx >= m_num[GRBIN_SECT_IR]) {
+        error("invalid IR");
+        return nullptr;
+    }
+    //A well-formed file never constructs more IR than it records.
+    m_ir_count++;
+    if (m_ir_count > m_num[GRBIN_SECT_IR]) {
+        error("IR list is cyclic");
+        return nullptr;
+    }
+    //The record has been verified by verifyIRRec().
+    GRBinIR const& rec = m_ir[idx];
+    if (rec.prno != PRNO_UNDEF && rec.prno >= rg->getPRCount()) {
+        error("invalid PR number of IR");
+        return nullptr;
+    }
+    IR_CODE code = (IR_CODE)rec.code;
+    IR * ir = rg->getIRMgr()->allocIR(code);
+    IR_dt(ir) = m_types.get(rec.type);
+    IR_may_throw(ir) = HAVE_FLAG(rec.prop, GRBIN_PROP_THROW);
+    IR_is_terminate(ir) = HAVE_FLAG(rec.prop, GRBIN_PROP_TERMINATE);
+    IR_is_atomic(ir) = HAVE_FLAG(rec.prop, GRBIN_PROP_ATOMIC);
+    IR_is_read_mod_write(ir) = HAVE_FLAG(rec.prop, GRBIN_PROP_RMW);
+    IR_has_sideeffect(ir) = HAVE_FLAG(rec.prop, GRBIN_PROP_SIDEEFFECT);
+    IR_no_move(ir) = HAVE_FLAG(rec.prop, GRBIN_PROP_NOMOVE);
+    if (rec.var != GRBIN_UNDEF) {
+        ir->setIdinfo(m_vars.get(rec.var));
+    }
+    if (rec.label != GRBIN_UNDEF) {
+        LabelInfo * li = m_labels.get(rec.label);
+        if (li == nullptr) {
+            error("invalid IR label");
+            return nullptr;
+        }
+        ir->setLabel(li);
+    }
+    if (ir->hasOffset()) {
+        ir->setOffset((TMWORD)rec.ofst);
+    }
+    if (IRDES_accprnofunc(code) != nullptr) {
+        //Access the field directly because CALL may not have result.
+        (*IRDES_accprnofunc(code))(ir) = (PRNO)rec.prno;
+    }
+    if (IRDES_accssfunc(code) != nullptr) {
+        ir->setStorageSpace((StorageSpace)rec.ss);
+    }
+    for (UINT i = 0; i < IR_MAX_KID_NUM(ir); i++) {
+        IR * kid = readIRList(rg, m_idx[rec.kid + i], isStmtKid(code, i));
+        if (m_err != nullptr || !verifyKid(ir, i, kid)) { return nullptr; }
+        ir->setKid(i, kid);
+    }
+    if (rec.res != GRBIN_UNDEF) {
+        IR * res = readIRList(rg, rec.res, false);
+        if (m_err != nullptr) { return nullptr; }
+        ir->setResList(res);
+    }
+    if (!readCodeField(rg, rec, ir) || !readEHLabel(rg, rec, ir)) {
+        return nullptr;
+    }
+    if ((ir->is_atomcas() || ir->is_atominc()) && !isValidAtomOp(ir)) {
+        error("invalid atomic operation");
+        return nullptr;
+    }
+    return ir;
+}
+
+
+//Return the IR list that begins with 'first', or nullptr if 'first' is
+//GRBIN_UNDEF. Caller should check m_err to determine if error occurred.
+//is_stmt: true if the list should be statement list, otherwise it should be
+//expression list.
+IR * GRBinReader::readIRList(Region * rg, UINT32 first, bool is_stmt)
+{
+    IR * head = nullptr;
+    IR * last = nullptr;
+    for (UINT32 i = first; i != GRBIN_UNDEF; i = m_ir[i].next) {
+        if (i < m_num[GRBIN_SECT_IR] &&
+            IRDES_is_stmt(m_ir[i].code) != is_stmt) {
+            error("statement and expression are mixed");
+            return nullptr;
+        }
+        IR * ir = readIR(rg, i);
+        if (ir == nullptr) { return nullptr; }
+        xcom::add_next(&head, &last, ir);
+    }
+    return head;
+}
+
+
+bool GRBinReader::readBBList(Region * rg, GRBinRegion const& rec)
+{
+    if (rec.bb_num == 0) { return true; }
+    if (rec.bb > m_num[GRBIN_SECT_BB] ||
+        rec.bb_num > m_num[GRBIN_SECT_BB] - rec.bb) {
+        return error("invalid BB list of region");
+    }
+    BBList * bbl = rg->getBBList();
+    ASSERT0(bbl);
+    for (UINT32 i = 0; i < rec.bb_num; i++) {
+        GRBinBB const& br = m_bb[rec.bb + i];
+        if (!isValidIdxList(br.label, br.label_num)) {
+            return error("invalid label of BB");
+        }
+        IRBB * bb = rg->allocBB();
+        for (UINT32 j = 0; j < br.label_num; j++) {
+            LabelInfo * li = m_labels.get(m_idx[br.label + j]);
+            if (li == nullptr || bb->getLabelList().find(li)) {
+                return error("invalid label of BB");
+            }
+            bb->addLabel(li);
+        }
+        IR * irs = readIRList(rg, br.ir, true);
+        if (m_err != nullptr) { return false; }
+        while (irs != nullptr) {
+            IR * ir = xcom::removehead(&irs);
+            BB_irlist(bb).append_tail(ir);
+        }
+        bb->u1.u1b1 = (IRBB::BitUnion)br.flag;
+        bbl->append_tail(bb);
+    }
+    return true;
+}
+
+
+bool GRBinReader::constructRegionBody(UINT32 idx)
+{
+    Region * rg = m_regions.get(idx);
+    ASSERT0(rg);
+    if (rg->is_blackbox()) { return true; }
+    GRBinRegion const& rec = m_region[idx];
+    if (!constructLabel(rg, rec)) { return false; }
+    if (HAVE_FLAG(rec.flag, GRBIN_RG_HAS_BB_LIST)) {
+        //CFG will be rebuilt from BB list and labels on demand.
+        return readBBList(rg, rec);
+    }
+    IR * irs = readIRList(rg, rec.ir, true);
+    if (m_err != nullptr) { return false; }
+    rg->setIRList(irs);
+    ASSERT0(verifyIRList(irs, nullptr, rg));
+    return true;
+}
+
+
+bool GRBinReader::read(CHAR const* filename)
+{
+    ASSERT0(filename);
+    destroy();
+    m_err = nullptr;
+    FO_STATUS st;
+    m_file = new xcom::FileObj(filename, false, true, &st);
+    ASSERT0(m_file);
+    if (st != xcom::FO_SUCC) { return error("can not open file"); }
+    BYTE const* buf = m_file->map();
+    size_t size = m_file->getMapSize();
+    if (buf == nullptr) {
+        //Read the content into memory if the mapping is unavailable.
+        size = m_file->getFileSize();
+        m_buf = (BYTE*)::malloc(size == 0 ? 1 : size);
+        ASSERT0(m_buf);
+        size_t rd = 0;
+        if (m_file->read(m_buf, 0, size, &rd) != xcom::FO_SUCC ||
+            rd != size) {
+            return error("read file failed");
+        }
+        buf = m_buf;
+    }
+    //The mapping is still accessible after the handler closed.
+    m_file->closeHandler();
+    if (!setContent(buf, size) || !verifyRecord() || !constructType() ||
+        !constructVar()) {
+        return false;
+    }
+    for (UINT32 i = 0; i < m_num[GRBIN_SECT_REGION]; i++) {
+        if (!constructRegion(i)) { return false; }
+    }
+    for (UINT32 i = 0; i < m_num[GRBIN_SECT_REGION]; i++) {
+        if (!constructRegionBody(i)) { return false; }
+    }
+    //The variable that is not declared in any region, e.g: the variable
+    //only referenced by IR, allocates initial value in the root region.
+    for (UINT32 i = 0; i < m_num[GRBIN_SECT_VAR]; i++) {
+        constructVarInitVal(m_vars.get(i), m_var[i], m_regions.get(0));
+    }
+    return true;
+}
+//END GRBinReader
+
+
+//Write 'rg' and its inner regions into binary GR file.
+//Return true if no error occur.
+bool writeGRBin(Region const* rg, CHAR const* grbinfile)
+{
+    START_TIMER(t, "writeGRBin");
+    GRBinWriter writer;
+    bool succ = writer.write(rg, grbinfile);
+    END_TIMER(t, "writeGRBin");
+    return succ;
+}
+
+
+//Read IR from binary GR file.
+//Return true if no error occur.
+bool readGRBinAndConstructRegion(RegionMgr * rm, CHAR const* grbinfile)
+{
+    START_TIMER(t, "readGRBinAndConstructRegion");
+    GRBinReader reader(rm);
+    bool succ = reader.read(grbinfile);
+    END_TIMER(t, "readGRBinAndConstructRegion");
+    return succ;
+}
+
+} //namespace xoc
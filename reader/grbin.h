@@ -0,0 +1,425 @@
+/*@
+Copyright (c) 2013-2021, Su Zhenyu steven.known@gmail.com
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Su Zhenyu nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+@*/
+#ifndef _GRBIN_H_
+#define _GRBIN_H_
+
+namespace xoc {
+
+//The binary GR format is an alternative of the GR text that records a
+//region and its inner regions in fixed size records, so that a file can be
+//mapped into memory and the regions can be constructed by walking the
+//records in place, without lexing and parsing.
+//The format of binary GR file is:
+// ----------------
+//  GRBinHdr
+// ----------------
+//  sections
+//                  Each section begins at 8-byte aligned offset that is
+//                  recorded in GRBinHdr::sect.
+// ----------------
+//All cross references are the index of record in related section, and
+//GRBIN_UNDEF indicates there is no reference.
+//NOTE: The content is host dependent: integer is in host byte order, and
+//HOST_INT and HOST_FP must have the same byte size as the writer.
+#define GRBIN_MAGIC "XOCGRBIN"
+#define GRBIN_MAGIC_LEN 8
+#define GRBIN_VERSION 1
+#define GRBIN_UNDEF ((UINT32)-1)
+#define GRBIN_FILE_SUFFIX ".grb"
+
+typedef enum {
+    //String table: str1\0str2\0..., referenced by byte offset.
+    GRBIN_SECT_STR = 0,
+
+    //Raw data, e.g: initial value of variable and the number of element in
+    //each dimension of array operation. Each data begins at 8-byte aligned
+    //offset and is referenced by byte offset.
+    GRBIN_SECT_DATA,
+
+    //UINT32 index pool that records variable-length lists of index, e.g:
+    //kid lists of IR, variable table of region, labels of BB.
+    GRBIN_SECT_IDX,
+    GRBIN_SECT_TYPE, //GRBinType table.
+    GRBIN_SECT_VAR, //GRBinVar table.
+    GRBIN_SECT_REGION, //GRBinRegion table, the first one is the root.
+    GRBIN_SECT_LABEL, //GRBinLabel table.
+    GRBIN_SECT_BB, //GRBinBB table.
+    GRBIN_SECT_IR, //GRBinIR table.
+    GRBIN_SECT_NUM,
+} GRBIN_SECT;
+
+//Properties of IR.
+typedef enum {
+    GRBIN_PROP_THROW = 0x1,
+    GRBIN_PROP_TERMINATE = 0x2,
+    GRBIN_PROP_ATOMIC = 0x4,
+    GRBIN_PROP_RMW = 0x8,
+    GRBIN_PROP_SIDEEFFECT = 0x10,
+    GRBIN_PROP_NOMOVE = 0x20,
+    GRBIN_PROP_ALIGNED = 0x40, //array operation is aligned.
+} GRBIN_PROP;
+
+//Properties of CALL and ICALL.
+typedef enum {
+    GRBIN_CALL_INTRINSIC = 0x1,
+    GRBIN_CALL_ALLOC_HEAP = 0x2,
+    GRBIN_CALL_NOT_BB_BOUND = 0x4,
+    GRBIN_CALL_READONLY = 0x8, //ICALL is readonly.
+} GRBIN_CALL;
+
+//Properties of region.
+typedef enum {
+    GRBIN_RG_READONLY = 0x1,
+    GRBIN_RG_EXPECT_INLINE = 0x2,
+    GRBIN_RG_INLINABLE = 0x4,
+
+    //Region body is recorded in BB list rather than IR list.
+    GRBIN_RG_HAS_BB_LIST = 0x8,
+} GRBIN_RG;
+
+class GRBinSect {
+public:
+    UINT64 ofst; //byte offset from the begin of file.
+    UINT64 size; //byte size.
+};
+
+
+class GRBinHdr {
+public:
+    CHAR magic[GRBIN_MAGIC_LEN];
+    UINT32 version;
+    UINT32 host_int_size;
+    UINT32 host_fp_size;
+    UINT32 reserved;
+    GRBinSect sect[GRBIN_SECT_NUM];
+};
+
+
+class GRBinType {
+public:
+    UINT32 dtype;
+
+    //Byte size of pointer base, memory chunk, or the total byte size of
+    //vector.
+    UINT32 size;
+
+    //Element data type of vector, stream and tensor.
+    UINT32 ety;
+
+    //Position in index pool of the degree of each dimension of tensor.
+    UINT32 dim;
+    UINT32 dim_num;
+    UINT32 reserved;
+};
+
+
+class GRBinVar {
+public:
+    UINT32 name; //offset in string table.
+    UINT32 type;
+    UINT32 flag;
+    UINT32 link_attr;
+    UINT32 align;
+    UINT32 formal_param_pos;
+    UINT32 prno;
+    UINT32 storage_space;
+
+    //Offset in string table of the content of string variable.
+    UINT32 str;
+
+    //Offset in data section and byte size of initial value.
+    UINT32 byte_val;
+    UINT32 byte_size;
+    UINT32 reserved;
+};
+
+
+class GRBinLabel {
+public:
+    UINT32 ltype;
+
+    //Label number of ILABEL, or offset in string table of the name of
+    //CLABEL and PRAGMA.
+    UINT32 val;
+    UINT32 flag; //LABELINFO_b1.
+    UINT32 reserved;
+};
+
+
+class GRBinBB {
+public:
+    //Position in index pool of labels that attached on BB. Each label is
+    //the index of label relative to the first label of region.
+    UINT32 label;
+    UINT32 label_num;
+    UINT32 ir; //the first stmt of BB.
+    UINT32 flag; //attributes of IRBB.
+};
+
+
+class GRBinRegion {
+public:
+    UINT32 type; //REGION_TYPE.
+    UINT32 var; //region variable.
+    UINT32 parent;
+    UINT32 flag; //GRBIN_RG.
+    UINT32 pr_count;
+
+    //Position in index pool of the variable table.
+    UINT32 var_list;
+    UINT32 var_num;
+
+    //The range of labels in label table.
+    UINT32 label;
+    UINT32 label_num;
+
+    //The first stmt if region body is IR list.
+    UINT32 ir;
+
+    //The range of BBs in BB table if region body is BB list.
+    UINT32 bb;
+    UINT32 bb_num;
+};
+
+
+class GRBinIR {
+public:
+    UINT16 code;
+    UINT16 prop; //GRBIN_PROP.
+    UINT32 type;
+    UINT32 next; //the next IR in the same list.
+
+    //Position in index pool of the head of each kid list, the number of
+    //kid lists is IR_MAX_KID_NUM.
+    UINT32 kid;
+    UINT32 res; //the head of result list.
+    UINT32 var;
+    UINT32 prno;
+    UINT32 label; //relative to the first label of region.
+    UINT32 ss; //storage space.
+
+    //Code dependent fields.
+    //ARRAY, STARRAY: aux is the element type, aux2 is the alignment.
+    //REGION: aux is the inner region.
+    //CALL, ICALL: aux is the intrinsic operator, aux2 is GRBIN_CALL.
+    //ALLOCA: aux2 is the alignment.
+    //CONST: aux2 is the number of mantissa of float point.
+    UINT32 aux;
+    UINT32 aux2;
+
+    //Position in index pool of exception handler labels.
+    UINT32 eh;
+    UINT32 eh_num;
+
+    //Offset in data section of the number of element in each dimension of
+    //array operation, each one is UINT64.
+    UINT32 dim;
+    UINT32 dim_num;
+    UINT32 reserved;
+    UINT64 ofst;
+
+    //Value of CONST: integer, bits of float point, or offset in string
+    //table of string.
+    UINT64 val;
+};
+
+
+//The class represents a growable buffer that records a section.
+class GRBinBuf {
+    COPY_CONSTRUCTOR(GRBinBuf);
+    BYTE * m_buf;
+    size_t m_size;
+    size_t m_capacity;
+public:
+    GRBinBuf() { m_buf = nullptr; m_size = 0; m_capacity = 0; }
+    ~GRBinBuf() { destroy(); }
+
+    //Allocate 'size' bytes at the tail of buffer, the content is zero.
+    //Return the offset of allocated bytes.
+    size_t alloc(size_t size);
+
+    //Align the size of buffer to 'align' by padding zero.
+    void align(size_t align);
+
+    void destroy();
+
+    BYTE * getBuf() const { return m_buf; }
+    size_t getSize() const { return m_size; }
+};
+
+
+//The class writes region and its inner regions into binary GR file.
+class GRBinWriter {
+    COPY_CONSTRUCTOR(GRBinWriter);
+    CHAR const* m_err;
+    GRBinBuf m_sect[GRBIN_SECT_NUM];
+
+    //Record the regions to be written in pre-order, the parent is always
+    //ahead of inner region.
+    xcom::Vector<Region const*> m_rg_list;
+    xcom::TMap<Region const*, UINT32> m_rg2idx;
+    xcom::TMap<Sym const*, UINT32> m_sym2ofst;
+    xcom::TMap<Type const*, UINT32> m_type2idx;
+    xcom::TMap<Var const*, UINT32> m_var2idx;
+
+    //Label index relative to the first label of current region.
+    xcom::TMap<LabelInfo const*, UINT32> m_lab2idx;
+    UINT32 m_lab_base;
+protected:
+    void addRegion(Region const* rg);
+    UINT32 addIdx(UINT32 n);
+
+    //Collect the regions and variables that are referenced in 'rg'.
+    void collectRegion(Region const* rg, MOD xcom::Vector<Var const*> & vars);
+    void collectIR(IR const* ir, MOD xcom::Vector<Var const*> & vars);
+
+    template <class T> T * getRec(GRBIN_SECT s, UINT32 idx)
+    { return ((T*)m_sect[s].getBuf()) + idx; }
+    UINT32 * getIdx(UINT32 pos)
+    { return ((UINT32*)m_sect[GRBIN_SECT_IDX].getBuf()) + pos; }
+    UINT32 getRecNum(GRBIN_SECT s, size_t recsz) const
+    { return (UINT32)(m_sect[s].getSize() / recsz); }
+
+    UINT32 writeBBList(Region const* rg, OUT UINT32 & bb_num);
+    UINT32 writeData(BYTE const* buf, size_t size);
+    UINT32 writeEHLabel(IR const* ir, OUT UINT32 & num);
+    UINT32 writeIR(IR const* ir);
+    UINT32 writeIRList(IR const* irlist);
+    UINT32 writeLabel(LabelInfo const* li);
+    void writeRegion(UINT32 idx);
+    UINT32 writeSym(Sym const* sym);
+    UINT32 writeType(Type const* ty);
+    void writeVar(Var const* v);
+    bool writeFile(CHAR const* filename);
+public:
+    GRBinWriter() { m_err = nullptr; m_lab_base = 0; }
+    ~GRBinWriter() {}
+
+    //Return the reason if writing failed.
+    CHAR const* getErrMsg() const { return m_err; }
+
+    //Write 'rg' and its inner regions to 'filename'.
+    //Return false if there is IR that the format can not describe, e.g:
+    //PHI, the SSA form should be destructed before writing.
+    bool write(Region const* rg, CHAR const* filename);
+};
+
+
+//The class constructs regions from binary GR file.
+class GRBinReader {
+    COPY_CONSTRUCTOR(GRBinReader);
+    RegionMgr * m_rm;
+    CHAR const* m_err;
+
+    //Record the file if the content is mapped from file.
+    xcom::FileObj * m_file;
+
+    //Record the buffer if the content is read into memory.
+    BYTE * m_buf;
+    BYTE const* m_content;
+    size_t m_size;
+    GRBinHdr const* m_hdr;
+    CHAR const* m_str;
+    BYTE const* m_data;
+    UINT32 const* m_idx;
+    GRBinType const* m_type;
+    GRBinVar const* m_var;
+    GRBinRegion const* m_region;
+    GRBinLabel const* m_label;
+    GRBinBB const* m_bb;
+    GRBinIR const* m_ir;
+    UINT32 m_num[GRBIN_SECT_NUM]; //the number of record of each section.
+
+    //The number of IR that have been constructed, it is used to detect
+    //cyclic IR list in malformed file.
+    UINT32 m_ir_count;
+    xcom::Vector<Type const*> m_types;
+    xcom::Vector<Var*> m_vars;
+    xcom::Vector<Region*> m_regions;
+    xcom::Vector<LabelInfo*> m_labels; //labels of current region.
+protected:
+    bool constructLabel(Region * rg, GRBinRegion const& rec);
+    bool constructRegion(UINT32 idx);
+    bool constructRegionBody(UINT32 idx);
+    bool constructType();
+    bool constructVar();
+    bool constructVarInitVal(Var * v, GRBinVar const& rec, Region * rg);
+    bool error(CHAR const* msg) { m_err = msg; return false; }
+
+    //Return true if the list [pos, pos + num) is in index pool.
+    bool isValidIdxList(UINT32 pos, UINT32 num) const
+    { return pos <= m_num[GRBIN_SECT_IDX] &&
+             num <= m_num[GRBIN_SECT_IDX] - pos; }
+    bool isValidData(UINT32 ofst, UINT64 size) const;
+    bool isValidStr(UINT32 ofst) const
+    { return ofst < m_hdr->sect[GRBIN_SECT_STR].size; }
+    Sym const* getSym(UINT32 ofst);
+
+    IR * readIR(Region * rg, UINT32 idx);
+    IR * readIRList(Region * rg, UINT32 first, bool is_stmt);
+    bool readBBList(Region * rg, GRBinRegion const& rec);
+    bool readCodeField(Region * rg, GRBinIR const& rec, IR * ir);
+    bool readEHLabel(Region * rg, GRBinIR const& rec, IR * ir);
+    bool setContent(BYTE const* buf, size_t size);
+
+    //Verify the records before constructing any object, the construction
+    //assumes the verified records are well-formed, e.g: the data type,
+    //variable flags, the PR number and IR code.
+    //Return false if there is malformed record.
+    bool verifyRecord();
+    bool verifyIRRec(GRBinIR const& rec);
+    bool verifyKid(IR const* ir, UINT idx, IR const* kid);
+    bool verifyRegionRec(UINT32 idx);
+    bool verifyTypeRec(GRBinType const& rec);
+    bool verifyVarRec(GRBinVar const& rec);
+public:
+    GRBinReader(RegionMgr * rm);
+    ~GRBinReader() { destroy(); }
+
+    void destroy();
+
+    //Return the reason if reading failed.
+    CHAR const* getErrMsg() const { return m_err; }
+
+    //Construct regions that recorded in 'filename'.
+    //Return false if the file is not a valid binary GR file.
+    bool read(CHAR const* filename);
+};
+
+
+//Write 'rg' and its inner regions into binary GR file.
+//Return true if no error occur.
+bool writeGRBin(Region const* rg, CHAR const* grbinfile);
+
+//Read IR from binary GR file.
+//Return true if no error occur.
+bool readGRBinAndConstructRegion(RegionMgr * rm, CHAR const* grbinfile);
+
+} //namespace xoc
+#endif